@@ -360,6 +360,16 @@ reps_for(u64 bits) noexcept
   return r;
 }
 
+// a batched call reported per job
+[[nodiscard]] sample
+per_job(sample s, u64 jobs) noexcept
+{
+  s.cyc_per_op /= static_cast<f64>(jobs);
+  s.ns_per_op /= static_cast<f64>(jobs);
+  s.mops *= static_cast<f64>(jobs);
+  return s;
+}
+
 }      // namespace
 
 int
@@ -507,6 +517,62 @@ main()
     }
   }
 
+  // 64 independent full-width powm jobs a call, one modulus; rows are per job. powm_fb_batch shares one base and a
+  // table of 5-bit windows built once outside the timed loop
+  tput_header("powm_batch / powm_fb_batch, 64 jobs a call, per job");
+  {
+    constexpr u64 JOBS = 64;
+    constexpr u64 PB_BITS[] = { 256, 512, 1024, 2048 };
+    const char *const isa_name[] = { "batch scalar", "batch avx2", "batch ifma" };
+    const char *const fb_name[] = { "fb scalar", "fb avx2", "fb ifma" };
+    const mpn::powm_isa host = mpn::active_powm_isa();
+    using buf = micron::vector<mpn::limb_t>;
+    for ( const u64 bits : PB_BITS ) {
+      const usize n = bits / mpn::limb_bits;
+      buf b(JOBS * n, 0), e(JOBS * n, 0), r(JOBS * n, 0), m(n, 0);
+      u64 s = 0x5EED0000ull + bits;
+      for ( usize i = 0; i < JOBS * n; ++i ) {
+        b[i] = lcg(s);
+        e[i] = lcg(s);
+      }
+      for ( usize i = 0; i < n; ++i ) m[i] = lcg(s);
+      m[0] |= 1u;
+      m[n - 1u] |= mpn::limb_msb;
+
+      mpn::powm_job jobs[JOBS];
+      mpn::powm_fb_job fjobs[JOBS];
+      for ( usize i = 0; i < JOBS; ++i ) {
+        jobs[i] = mpn::powm_job{ r.data() + i * n, b.data() + i * n, n, e.data() + i * n, n, m.data() };
+        fjobs[i] = mpn::powm_fb_job{ r.data() + i * n, e.data() + i * n, n };
+      }
+      buf ps(mpn::powm_itch(n, n, bits), 0);
+      const sample one = throughput(1, [&] {
+        for ( usize i = 0; i < JOBS; ++i ) mpn::powm(r.data() + i * n, b.data() + i * n, n, e.data() + i * n, n, m.data(), n, ps.data());
+        clobber(r.data());
+      });
+      tput_row("powm", bits, n, per_job(one, JOBS));
+
+      for ( u32 k = 0; k <= static_cast<u32>(host); ++k ) {
+        mpn::set_powm_isa(static_cast<mpn::powm_isa>(k));
+        buf bs(mpn::powm_batch_itch(n, n, bits), 0);
+        const sample batch = throughput(1, [&] {
+          mpn::powm_batch(jobs, JOBS, n, bs.data());
+          clobber(r.data());
+        });
+        tput_row(isa_name[k], bits, n, per_job(batch, JOBS));
+
+        buf tbl(mpn::powm_fb_table_limbs(n, bits, 5), 0), ms(mpn::powm_fb_make_itch(n, n), 0), fs(mpn::powm_fb_itch(n), 0);
+        const mpn::powm_fb_ctx c = mpn::powm_fb_make(tbl.data(), b.data(), n, m.data(), n, bits, 5, ms.data());
+        const sample fb = throughput(1, [&] {
+          mpn::powm_fb_batch(c, fjobs, JOBS, fs.data());
+          clobber(r.data());
+        });
+        tput_row(fb_name[k], bits, n, per_job(fb, JOBS));
+      }
+      mpn::set_powm_isa(host);
+    }
+  }
+
   micron::io::println("");
   return 0;
 }
@@ -7,6 +7,8 @@
 // build:  duck build benches/arbint_crossover_bench.cpp --perf --fp --no-ssp --no-lto -o bin/b
 // run  :  taskset -c 2 ./bin/b/arbint_crossover_bench
 // csv  :  taskset -c 2 ./bin/b/arbint_crossover_bench --csv > benches/results/arbint_crossover.csv
+// tune :  taskset -c 2 ./bin/b/arbint_crossover_bench --emit > arbint_tuning.hpp
+//         then build with -DMICRON_ARBINT_TUNING_HEADER='"arbint_tuning.hpp"', or paste the values into a tuning.hpp table
 
 #if defined(ARBINT_BENCH_PERF)
 #include "../external/bbench/bench.hpp"
@@ -292,14 +294,179 @@ header(const char *title)
   micron::io::println("  ----------------------------------------------------------------------");
 }
 
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+// --emit: sweep each pair of neighbouring tiers, write the crossovers out as a MICRON_ARBINT_* header
+
+constexpr usize TUNE_MAX = 16384;
+constexpr usize TUNE_NEVER = ~usize{ 0 };
+
+struct tune_bufs {
+  micron::vector<mpn::limb_t> a, b, r, d, n, w, q, sc;
+};
+
+tune_bufs *g_t = nullptr;
+
+// the first grid size from which hi beats lo twice running, TUNE_NEVER if it never settles
+template<typename Lo, typename Hi>
+usize
+crossover(const usize *grid, usize gn, Lo &&lo, Hi &&hi) noexcept
+{
+  bool prev = false;
+  for ( usize i = 0; i < gn; ++i ) {
+    const usize n = grid[i];
+    const u64 reps = reps_for(n);
+    const f64 a = measure(n, reps, [&] { lo(n); }).cyc_per_op;
+    const f64 b = measure(n, reps, [&] { hi(n); }).cyc_per_op;
+    const bool wins = b < a;
+    if ( wins && prev ) return grid[i - 1u];
+    prev = wins;
+  }
+  return prev ? grid[gn - 1u] : TUNE_NEVER;
+}
+
+[[nodiscard]] usize
+at_least(usize v, usize floor, usize fallback) noexcept
+{
+  if ( v == TUNE_NEVER ) v = fallback;
+  return v < floor ? floor : v;
+}
+
+[[gnu::cold]] void
+put(const char *name, usize v)
+{
+  micron::io::println("#define MICRON_ARBINT_", name, " ", static_cast<u64>(v));
+}
+
+template<mpn::algo K>
+void
+tmul(usize n) noexcept
+{
+  mpn::mul_with<K>(g_t->r.data(), g_t->a.data(), n, g_t->b.data(), n, g_t->sc.data());
+  clobber(g_t->r.data());
+}
+
+template<mpn::algo K>
+void
+tsqr(usize n) noexcept
+{
+  mpn::sqr_with<K>(g_t->r.data(), g_t->a.data(), n, g_t->sc.data());
+  clobber(g_t->r.data());
+}
+
+// K dn limbs by dn
+template<mpn::divalgo A, usize K>
+void
+tdiv(usize dn) noexcept
+{
+  const usize nn = K * dn;
+  mpn::limb_t *const d = g_t->d.data();
+  d[dn - 1u] |= mpn::limb_msb;
+  mpn::copyi(g_t->w.data(), g_t->n.data(), nn);
+  if constexpr ( A == mpn::divalgo::mu )
+    (void)mpn::mu_div_qr(g_t->q.data(), g_t->w.data(), nn, d, dn, g_t->sc.data());
+  else {
+    const mpn::limb_t dinv = mpn::invert_pi1(d[dn - 1u], d[dn - 2u]);
+    if constexpr ( A == mpn::divalgo::dc )
+      (void)mpn::dc_div_qr(g_t->q.data(), g_t->w.data(), nn, d, dn, dinv, g_t->sc.data());
+    else
+      (void)mpn::sbpi1_div_qr(g_t->q.data(), g_t->w.data(), nn, d, dn, dinv);
+  }
+  clobber(g_t->q.data());
+}
+
+[[gnu::cold]] void
+emit_tuning()
+{
+  usize need = mpn::mul_itch_forced(TUNE_MAX, TUNE_MAX);
+  auto grow = [&need](usize v) {
+    if ( v > need ) need = v;
+  };
+  grow(mpn::mul_itch_with<mpn::algo::toom4>(TUNE_MAX, TUNE_MAX));
+  grow(mpn::sqr_itch_with<mpn::algo::toom4>(TUNE_MAX));
+  grow(mpn::mul_itch_with<mpn::tiers_built>(TUNE_MAX, TUNE_MAX));
+  grow(mpn::sqr_itch_with<mpn::tiers_built>(TUNE_MAX));
+  grow(mpn::dc_div_itch(TUNE_MAX / 4u));
+  grow(mpn::mu_div_qr_itch(TUNE_MAX, TUNE_MAX / 4u));
+
+  using buf = micron::vector<mpn::limb_t>;
+  tune_bufs t{ buf(TUNE_MAX, 0),      buf(TUNE_MAX, 0),      buf(2u * TUNE_MAX + 4u, 0), buf(TUNE_MAX, 0),
+               buf(TUNE_MAX + 4u, 0), buf(TUNE_MAX + 4u, 0), buf(TUNE_MAX + 4u, 0),      buf(need + 16u, 0) };
+  g_t = &t;
+  fill(t.a.data(), TUNE_MAX, 0x1234567ull);
+  fill(t.b.data(), TUNE_MAX, 0x89ABCDEFull);
+  fill(t.d.data(), TUNE_MAX, 0x2468ACEull);
+  fill(t.n.data(), TUNE_MAX, 0x13579BDull);
+
+  using mpn::algo;
+  constexpr usize small[] = { 4, 6, 8, 10, 12, 14, 16, 18, 20, 22, 24, 26, 28, 32, 36, 40, 48, 56, 64, 80, 96 };
+  constexpr usize mid[] = { 48, 64, 80, 96, 112, 128, 160, 192, 224, 256, 320, 384, 448, 512, 640, 768, 1024, 1280 };
+  constexpr usize big[] = { 1024, 1536, 2048, 3072, 4096, 6144, 8192, 12288, 16384 };
+  constexpr usize div2[] = { 8, 12, 16, 24, 32, 48, 64, 96, 128, 160, 192, 256, 320, 384, 512, 768, 1024 };
+  constexpr usize div4[] = { 256, 384, 512, 768, 1024, 1536, 2048, 3072, 4096 };
+  constexpr usize ns = sizeof(small) / sizeof(small[0]), nm = sizeof(mid) / sizeof(mid[0]), nb = sizeof(big) / sizeof(big[0]);
+
+  // mul: comba and each toom band may never win, the band then closes onto the tier above
+  const usize mk = at_least(crossover(small, ns, tmul<algo::comba>, tmul<algo::karatsuba>), 2u, mpn::threshold::mul_karatsuba);
+  usize mc = crossover(small, ns, tmul<algo::basecase>, tmul<algo::comba>);
+  mc = (mc == TUNE_NEVER || mc > mk) ? mk : mc;
+  const usize m4 = at_least(crossover(mid, nm, tmul<algo::toom3>, tmul<algo::toom4>), mk, mpn::threshold::mul_toom4);
+  usize m3 = crossover(mid, nm, tmul<algo::karatsuba>, tmul<algo::toom3>);
+  m3 = (m3 == TUNE_NEVER || m3 > m4) ? m4 : (m3 < mk ? mk : m3);
+  usize mf = mpn::threshold::mul_nussbaumer;
+#if defined(__micron_arch_width_64)
+  mf = at_least(crossover(big, nb, tmul<algo::toom4>, tmul<algo::nussbaumer>), m4, mpn::threshold::mul_nussbaumer);
+#endif
+
+  const usize sk = at_least(crossover(small, ns, tsqr<algo::comba>, tsqr<algo::karatsuba>), 2u, mpn::threshold::sqr_karatsuba);
+  usize sc = crossover(small, ns, tsqr<algo::basecase>, tsqr<algo::comba>);
+  sc = (sc == TUNE_NEVER || sc > sk) ? sk : sc;
+  const usize s3 = at_least(crossover(mid, nm, tsqr<algo::karatsuba>, tsqr<algo::toom3>), sk, mpn::threshold::sqr_toom3);
+  usize sf = mpn::threshold::sqr_nussbaumer;
+#if defined(__micron_arch_width_64)
+  sf = at_least(crossover(big, nb, tsqr<algo::toom3>, tsqr<algo::nussbaumer>), s3, mpn::threshold::sqr_nussbaumer);
+#endif
+  usize s4 = crossover(big, nb, tsqr<algo::toom3>, tsqr<algo::toom4>);
+  s4 = (s4 == TUNE_NEVER || s4 > sf) ? sf : (s4 < s3 ? s3 : s4);
+
+  constexpr usize nd2 = sizeof(div2) / sizeof(div2[0]), nd4 = sizeof(div4) / sizeof(div4[0]);
+  const usize dd = at_least(crossover(div2, nd2, tdiv<mpn::divalgo::sbpi1, 2>, tdiv<mpn::divalgo::dc, 2>), 6u, mpn::threshold::div_dc);
+  const usize dm = at_least(crossover(div4, nd4, tdiv<mpn::divalgo::dc, 4>, tdiv<mpn::divalgo::mu, 4>), dd, mpn::threshold::div_mu);
+
+  const mpn::tuning_cpu cpu = mpn::tuning_probe();
+  micron::io::println("// arbint tier crossovers, written by benches/arbint_crossover_bench.cpp --emit");
+  micron::io::println("// cpu family ", static_cast<u64>(cpu.family), " model ", static_cast<u64>(cpu.model), ", runtime table ",
+                      mpn::tuning_arch_name(mpn::tuning_arch_of(cpu)), ", limb width ", static_cast<u64>(mpn::limb_bits));
+  micron::io::println("// pinning any of these turns the runtime tables off (MICRON_ARBINT_RUNTIME_TUNING)");
+  micron::io::println("#pragma once");
+  put("MUL_COMBA_THRESHOLD", mc);
+  put("MUL_KARATSUBA_THRESHOLD", mk);
+  put("MUL_TOOM3_THRESHOLD", m3);
+  put("MUL_TOOM4_THRESHOLD", m4);
+  put("MUL_NUSSBAUMER_THRESHOLD", mf);
+  put("SQR_COMBA_THRESHOLD", sc);
+  put("SQR_KARATSUBA_THRESHOLD", sk);
+  put("SQR_TOOM3_THRESHOLD", s3);
+  put("SQR_TOOM4_THRESHOLD", s4);
+  put("SQR_NUSSBAUMER_THRESHOLD", sf);
+  put("DIV_DC_THRESHOLD", dd);
+  put("DIV_MU_THRESHOLD", dm);
+  g_t = nullptr;
+}
+
 }      // namespace
 
 int
 main(int argc, char **argv)
 {
+  bool tune = false;
   for ( int i = 1; i < argc; ++i ) {
     const char *a = argv[i];
     if ( a[0] == '-' && a[1] == '-' && a[2] == 'c' ) g_csv = true;
+    if ( a[0] == '-' && a[1] == '-' && a[2] == 'e' ) tune = true;
+  }
+  if ( tune ) {
+    emit_tuning();
+    return 0;
   }
 
   fill(g_a, MAX_N, 0x1234567ull);
@@ -317,6 +484,7 @@ main(int argc, char **argv)
                         static_cast<u64>(mpn::threshold::mul_karatsuba), ", toom3 ", static_cast<u64>(mpn::threshold::mul_toom3),
                         ", toom4 ", static_cast<u64>(mpn::threshold::mul_toom4), ", nussbaumer ",
                         static_cast<u64>(mpn::threshold::mul_nussbaumer));
+    micron::io::println("runtime tuning table: ", mpn::tuning_arch_name(mpn::active_tuning_arch()), " (dispatch rows run on it)");
   }
 
   header("kernel, cycles per limb (cyc/op column is per-limb here)");
@@ -9,13 +9,19 @@
 //   L1: dot, axpy, scal, asum, nrm2, iamax, copy   (linear time)
 //   L2: gemv (no-trans, trans), ger                (quadratic)
 //   L3: gemm (NN/NT/TN/TT), syrk, symm             (cubic)
+//   L3 mt: gemm_mt scaling over 1..ncpu engine workers (wall clock GFLOP/s)
 //   linalg: trace, frobenius_norm, det<N>, inv<N>, solve<N>, kron
 
+#define MICRON_ABC_MT 1      // the gemm_mt sweep runs the coroutine engine; abcmalloc's -k gate must be MT (bits/__abc_mt.hpp)
+
 #include "../external/bbench/bench.hpp"
 
+#include "../src/chrono/clock.hpp"
 #include "../src/io/console.hpp"
 #include "../src/linux/sys/sched.hpp"
 #include "../src/math/blas/blas.hpp"
+#include "../src/math/blas/gemm_mt.hpp"
+#include "../src/thread/cpu.hpp"
 #include "../src/math/linalg.hpp"
 #include "../src/math/matrix/dynmat.hpp"
 #include "../src/math/matrix/matrices.hpp"
@@ -498,6 +504,56 @@ sweep_level3_f32()
   }
 }
 
+// wall clock, the work is spread over the engine's workers so the per-thread perf group would only see the caller
+template<typename T>
+void
+sweep_level3_mt_scaling(const char *title, u64 d)
+{
+  micron::io::println("");
+  micron::io::println("[", title, "]    d = ", d, "    isa: ",
+                      mc::math::blas::active_gemm_isa() == mc::math::blas::gemm_isa::avx512 ? "avx512"
+                      : mc::math::blas::active_gemm_isa() == mc::math::blas::gemm_isa::neon ? "neon"
+                                                                                              : "native");
+  line h;
+  h.s("workers");
+  h.s_at("ms", 24);
+  h.s_at("GFLOP/s", 40);
+  h.s_at("speedup", 52);
+  micron::io::println(h.str());
+  micron::io::println("----------------------------------------------------");
+
+  aligned_buf<T> A(d * d), B(d * d), C(d * d);
+  fill_pattern<T>(A.data(), d * d, 0x7777);
+  fill_pattern<T>(B.data(), d * d, 0x8888);
+  fill_pattern<T>(C.data(), d * d, 0x9999);
+  const f64 flops = 2.0 * static_cast<f64>(d) * static_cast<f64>(d) * static_cast<f64>(d);
+
+  const u32 ncpu = micron::cpu_count();
+  f64 base = 0;
+  for ( u32 w = 1;; w = (w * 2 > ncpu && w != ncpu) ? ncpu : w * 2 ) {
+    micron::coro::start_coroutine_runtime(w);
+    mc::math::blas::level3::gemm_row_mt<T>(false, false, d, d, d, T(1), A.data(), d, B.data(), d, T(0), C.data(), d);
+    f64 ms[K_MEASUREMENTS];
+    for ( u32 m = 0; m < K_MEASUREMENTS; ++m ) {
+      const i64 t0 = micron::chrono::mono_ns();
+      mc::math::blas::level3::gemm_row_mt<T>(false, false, d, d, d, T(1), A.data(), d, B.data(), d, T(0), C.data(), d);
+      clobber(C.data());
+      ms[m] = static_cast<f64>(micron::chrono::mono_ns() - t0) * 1e-6;
+    }
+    micron::coro::stop_coroutine_runtime();
+    const f64 t = median_f64(ms, K_MEASUREMENTS);
+    const f64 gf = flops / (t * 1e6);
+    if ( w == 1 ) base = gf;
+    line ln;
+    ln.u_at(w, 7);
+    ln.f2_at(to_fmt2(t), 24);
+    ln.f2_at(to_fmt2(gf), 40);
+    ln.f2_at(to_fmt2(base > 0 ? gf / base : 0), 52);
+    micron::io::println(ln.str());
+    if ( w == ncpu ) break;
+  }
+}
+
 template<u64 N>
 void
 sweep_linalg_static()
@@ -550,6 +606,7 @@ main(void)
   micron::io::println("L2 dims:  32, 128, 512, 1024 (square)");
   micron::io::println("L3 dims:  32, 128, 512 (square)");
   micron::io::println("perf events: cycles + instructions + branches + branch-misses");
+  micron::io::println("L3 mt:    2048 (square), 1..ncpu workers");
 
   sweep_level1_f64();
   sweep_level1_f32();
@@ -558,6 +615,14 @@ main(void)
   sweep_level3_f64_aligned();
   sweep_level3_f32();
 
+  // the scaling sweep needs every core back; workers inherit the caller's mask
+  micron::posix::cpu_set_t all;
+  all.cpu_zero();
+  for ( u32 c = 0; c < micron::cpu_count(); ++c ) all.cpu_set(c);
+  micron::posix::sched_setaffinity(0, sizeof(all), all);
+  sweep_level3_mt_scaling<f64>("BLAS L3 dgemm_mt scaling", 2048);
+  sweep_level3_mt_scaling<f32>("BLAS L3 sgemm_mt scaling", 2048);
+
   sweep_linalg_static<2>();
   sweep_linalg_static<3>();
   sweep_linalg_static<4>();
@@ -21,6 +21,7 @@
 #include "../src/chrono.hpp"
 #include "../src/chrono/calibrate.hpp"
 #include "../src/chrono/measure.hpp"
+#include "../src/chrono/profile.hpp"
 #include "../src/chrono/vdso.hpp"
 #include "../src/io/console.hpp"
 #include "../src/std.hpp"
@@ -136,6 +137,10 @@ bench_counter(void)
         const u64 b = ch::tick_end<>();
         ch::sink(b - a);
       }));
+  static micron::profile::region r_bench("bench");
+  row("profile::scope (empty region)", measure_ps(1000000, [] { micron::profile::scope s(r_bench); }));
+  mc::console("  profile counters      = ", micron::profile::available(micron::profile::metric::cycles) ? "perf" : "ticks only",
+              micron::profile::rdpmc_enabled() ? " (rdpmc)" : "");
 
   mc::console("");
   const auto ov = ch::timer_overhead<>();
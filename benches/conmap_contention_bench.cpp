@@ -0,0 +1,193 @@
+//  Copyright (c) 2024- David Lucius Severus
+//
+//  Distributed under the Boost Software License, Version 1.0.
+//  See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt
+
+#define MICRON_ABC_MT 1      // spawns threads/coroutines; abcmalloc's -k gate must be MT (bits/__abc_mt.hpp)
+
+#include "../src/io/console.hpp"
+#include "../src/linux/sys/time.hpp"
+#include "../src/std.hpp"
+
+#include "../src/thread/thread.hpp"
+
+#include "../src/maps/conmap.hpp"
+#include "../src/maps/seq_conmap.hpp"
+
+// conmap (striped robin_map, readers lock) vs seq_conmap (seqlock reads, incremental resize)
+// same key space, same op mix, 4 threads; read ratio varied
+
+namespace
+{
+
+constexpr u32 K_MEASUREMENTS = 5;
+constexpr u64 WARMUP = 2;
+constexpr u64 KEYS = 1u << 18;
+
+f64 g_tsc_ghz = 1.0;
+
+[[gnu::always_inline]] inline u64
+rdtsc() noexcept
+{
+  u32 lo, hi;
+  asm volatile("lfence; rdtsc" : "=a"(lo), "=d"(hi));
+  return (static_cast<u64>(hi) << 32) | lo;
+}
+
+[[gnu::always_inline]] inline u64
+wall_ns() noexcept
+{
+  micron::timespec_t ts{};
+  micron::clock_gettime(micron::clock_monotonic, ts);
+  return static_cast<u64>(ts.tv_sec) * 1000000000ULL + static_cast<u64>(ts.tv_nsec);
+}
+
+void
+calibrate_tsc() noexcept
+{
+  const u64 n0 = wall_ns();
+  const u64 c0 = rdtsc();
+  while ( wall_ns() - n0 < 50000000ULL ) {
+  }
+  const u64 c1 = rdtsc();
+  const u64 n1 = wall_ns();
+  g_tsc_ghz = static_cast<f64>(c1 - c0) / static_cast<f64>(n1 - n0);
+}
+
+[[gnu::always_inline]] inline f64
+cyc_to_ns(u64 cyc) noexcept
+{
+  return static_cast<f64>(cyc) / g_tsc_ghz;
+}
+
+[[gnu::always_inline]] inline void
+clobber(u64 v) noexcept
+{
+  asm volatile("" : : "r"(v) : "memory");
+}
+
+f64
+median(f64 *xs, u32 n) noexcept
+{
+  for ( u32 i = 1; i < n; ++i ) {
+    f64 k = xs[i];
+    u32 j = i;
+    while ( j > 0 && xs[j - 1] > k ) {
+      xs[j] = xs[j - 1];
+      --j;
+    }
+    xs[j] = k;
+  }
+  return xs[n / 2];
+}
+
+void
+report(const char *name, f64 nsop) noexcept
+{
+  if ( nsop < 0 ) nsop = 0;
+  u64 centi = static_cast<u64>(nsop * 100.0 + 0.5);
+  micron::io::print("  ", name, "  ", centi / 100, ".", (centi % 100 < 10 ? "0" : ""), centi % 100, " ns/op\n");
+}
+
+[[gnu::always_inline]] inline u64
+mix(u64 x) noexcept
+{
+  x ^= x >> 33;
+  x *= 0xff51afd7ed558ccdULL;
+  x ^= x >> 33;
+  return x;
+}
+
+// read_pct of every 100 ops are lookups, the rest insert_or_assign; keys uniform over KEYS
+template<class M>
+f64
+bench_mix(M &m, u64 n_per_thread, u32 read_pct) noexcept
+{
+  f64 samples[K_MEASUREMENTS];
+  for ( u32 r = 0; r < K_MEASUREMENTS + WARMUP; ++r ) {
+    u64 sinks[4] = { 0, 0, 0, 0 };
+    auto work = [&](u64 t) {
+      u64 s = 0;
+      u64 x = mix(t + 1 + r * 4);
+      for ( u64 i = 0; i < n_per_thread; ++i ) {
+        x = mix(x + i);
+        const u64 k = x & (KEYS - 1);
+        if ( (x >> 40) % 100 < read_pct ) {
+          u64 v = 0;
+          s += m.find(k, v) ? v : 1;
+        } else {
+          m.insert_or_assign(k, i);
+        }
+      }
+      sinks[t] = s;
+    };
+    const u64 c0 = rdtsc();
+    {
+      micron::auto_thread<> t0(work, 0);
+      micron::auto_thread<> t1(work, 1);
+      micron::auto_thread<> t2(work, 2);
+      micron::auto_thread<> t3(work, 3);
+    }
+    const u64 c1 = rdtsc();
+    clobber(sinks[0] + sinks[1] + sinks[2] + sinks[3]);
+    if ( r >= WARMUP ) samples[r - WARMUP] = cyc_to_ns(c1 - c0) / static_cast<f64>(n_per_thread * 4);
+  }
+  return median(samples, K_MEASUREMENTS);
+}
+
+// 4 threads inserting fresh keys into a map that starts tiny; conmap can't grow so it's sized up front
+f64
+bench_seq_growth(u64 n_per_thread) noexcept
+{
+  f64 samples[K_MEASUREMENTS];
+  for ( u32 r = 0; r < K_MEASUREMENTS + WARMUP; ++r ) {
+    micron::seq_conmap<u64, u64> m(0);
+    auto work = [&](u64 t) {
+      for ( u64 i = 0; i < n_per_thread; ++i ) m.insert_or_assign(t * n_per_thread + i, i);
+    };
+    const u64 c0 = rdtsc();
+    {
+      micron::auto_thread<> t0(work, 0);
+      micron::auto_thread<> t1(work, 1);
+      micron::auto_thread<> t2(work, 2);
+      micron::auto_thread<> t3(work, 3);
+    }
+    const u64 c1 = rdtsc();
+    clobber(m.size());
+    if ( r >= WARMUP ) samples[r - WARMUP] = cyc_to_ns(c1 - c0) / static_cast<f64>(n_per_thread * 4);
+  }
+  return median(samples, K_MEASUREMENTS);
+}
+
+}      // namespace
+
+int
+main(void)
+{
+  calibrate_tsc();
+  micron::io::print("=== conmap contention bench (TSC ", static_cast<u64>(g_tsc_ghz * 1000.0), " MHz) ===\n");
+
+  micron::conmap<u64, u64> cm(KEYS * 2);
+  micron::seq_conmap<u64, u64> sm(KEYS);
+  for ( u64 k = 0; k < KEYS; k += 2 ) {
+    cm.insert_or_assign(k, k);
+    sm.insert_or_assign(k, k);
+  }
+
+  const u32 mixes[3] = { 50, 95, 100 };
+  for ( u32 pct : mixes ) {
+    micron::io::print("\n-- ", pct, "% reads, 4 threads --\n");
+    const f64 c = bench_mix(cm, 1000000ULL, pct);
+    const f64 s = bench_mix(sm, 1000000ULL, pct);
+    report("conmap     ", c);
+    report("seq_conmap ", s);
+    if ( s > 0.0 ) micron::io::print("  -> seq_conmap ", static_cast<u64>((c / s) * 100.0 + 0.5), "% of conmap throughput\n");
+  }
+
+  micron::io::print("\n-- growth from empty, 4 threads inserting --\n");
+  report("seq_conmap insert", bench_seq_growth(250000ULL));
+
+  micron::io::print("\n=== done ===\n");
+  return 0;
+}
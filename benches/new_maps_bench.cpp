@@ -10,6 +10,7 @@
 #include "../src/maps/heap_swiss.hpp"
 #include "../src/maps/pmap.hpp"
 #include "../src/maps/rb_map.hpp"
+#include "../src/maps/swiss.hpp"
 #include "../src/std.hpp"
 #include "../src/trees/art.hpp"
 
@@ -66,6 +67,55 @@ print_row(const char *impl, const char *op, usize n, double ns_per_op)
 
 constexpr usize K_N = 50000;
 
+// probe-group width at high load: the table is filled to just under its 7/8 growth point so probe chains are long,
+// then queried with all hits and all misses (a miss walks the chain until an empty slot turns up)
+template<usize G>
+void
+bench_group_heap(const char *name)
+{
+  constexpr usize CAP = 1u << 17;
+  constexpr usize FILL = CAP * 7 / 8 - 1;
+  micron::heap_swiss_map<u64, u64, micron::allocator_serial<>, false, G> m(CAP);
+  for ( usize i = 0; i < FILL; ++i ) m.insert(key_u64(i), i);
+  double hit = time_ns_per_op(FILL, [&]() {
+    for ( usize i = 0; i < FILL; ++i ) {
+      auto *p = m.find(key_u64(i));
+      if ( p ) sink += *p;
+    }
+  });
+  double miss = time_ns_per_op(FILL, [&]() {
+    for ( usize i = 0; i < FILL; ++i ) sink += m.contains(key_u64(i + FILL));
+  });
+  print_row(name, "find-hit", FILL, hit);
+  print_row(name, "find-miss", FILL, miss);
+}
+
+// stack map has no growth limit, 95% full
+template<usize G>
+void
+bench_group_stack(const char *name)
+{
+  constexpr usize N = 4096;
+  constexpr usize FILL = N * 95 / 100;
+  static micron::stack_swiss_map<u64, u64, N, N, G> m;
+  m.clear();
+  for ( usize i = 0; i < FILL; ++i ) m.insert(key_u64(i), i);
+  constexpr usize REPS = 32;
+  double hit = time_ns_per_op(FILL * REPS, [&]() {
+    for ( usize r = 0; r < REPS; ++r )
+      for ( usize i = 0; i < FILL; ++i ) {
+        auto *p = m.find(key_u64(i));
+        if ( p ) sink += *p;
+      }
+  });
+  double miss = time_ns_per_op(FILL * REPS, [&]() {
+    for ( usize r = 0; r < REPS; ++r )
+      for ( usize i = 0; i < FILL; ++i ) sink += m.contains(key_u64(i + FILL));
+  });
+  print_row(name, "find-hit", FILL, hit);
+  print_row(name, "find-miss", FILL, miss);
+}
+
 }      // namespace
 
 int
@@ -165,6 +215,14 @@ main()
     print_row("art", "erase", K_N, era);
   }
 
+  micron::io::println("--- swiss group width, high load (native group ", micron::__swiss_native_group, ") ---");
+  bench_group_heap<16>("hswiss G=16");
+  bench_group_heap<32>("hswiss G=32");
+  bench_group_heap<64>("hswiss G=64");
+  bench_group_stack<16>("sswiss G=16");
+  bench_group_stack<32>("sswiss G=32");
+  bench_group_stack<64>("sswiss G=64");
+
   micron::io::println("sink=", sink);
   return 0;
 }
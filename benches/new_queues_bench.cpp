@@ -8,6 +8,8 @@
 #include "../src/io/stdout.hpp"
 #include "../src/queue/crossbeam.hpp"
 #include "../src/queue/disruptor.hpp"
+#include "../src/queue/mp_disruptor.hpp"
+#include "../src/queue/seg_mpmc.hpp"
 #include "../src/queue/static_mpmc.hpp"
 #include "../src/std.hpp"
 
@@ -233,6 +235,79 @@ main()
     print_row("static_mpmc", "segpool-64", total, ns);
   }
 
+  {
+    // 4 producers into a two-stage pipeline (transform, then sum) on one ring, no queue between the stages
+    constexpr int P = 4;
+    constexpr usize PER = 250000;
+    constexpr usize TOTAL = P * PER;
+    micron::mp_disruptor<u64, 4096> d;
+    auto xform = d.add_stage();
+    auto total = d.add_stage(xform);
+    std::atomic<bool> ready{ false };
+    std::vector<std::thread> ts;
+    for ( int p = 0; p < P; ++p ) {
+      ts.emplace_back([&, p]() {
+        while ( !ready.load(std::memory_order_acquire) );
+        for ( usize i = 0; i < PER; i += 8 ) {
+          const usize s = d.claim(8);
+          for ( usize k = 0; k < 8; ++k ) d[s + k] = static_cast<u64>(p) * PER + i + k;
+          d.publish(s, 8);
+        }
+      });
+    }
+    ts.emplace_back([&]() {
+      while ( !ready.load(std::memory_order_acquire) );
+      for ( usize n = 0; n < TOTAL; ) n += xform.process([](u64 &v, usize, bool) { v = v * 3 + 1; });
+    });
+    ts.emplace_back([&]() {
+      while ( !ready.load(std::memory_order_acquire) );
+      u64 acc = 0;
+      for ( usize n = 0; n < TOTAL; ) n += total.process([&acc](u64 &v, usize, bool) { acc += v; });
+      sink += acc;
+    });
+    u64 t0 = now_ns();
+    ready.store(true, std::memory_order_release);
+    for ( auto &t : ts ) t.join();
+    u64 t1 = now_ns();
+    double ns = static_cast<double>(t1 - t0) / static_cast<double>(TOTAL);
+    print_row("mp_disruptor", "4p-2stage", TOTAL, ns);
+  }
+
+  {
+    // unbounded fan-in: same 4x4 shape as crossbeam above, producers never see a full queue
+    constexpr int P = 4;
+    constexpr int C = 4;
+    constexpr usize PER = 250000;
+    micron::seg_mpmc<u64> q;
+    std::atomic<usize> consumed{ 0 };
+    std::atomic<bool> ready{ false };
+    std::vector<std::thread> ts;
+    for ( int p = 0; p < P; ++p ) {
+      ts.emplace_back([&, p]() {
+        while ( !ready.load(std::memory_order_acquire) );
+        for ( usize i = 0; i < PER; ++i ) q.push(static_cast<u64>(p) * PER + i);
+      });
+    }
+    for ( int c = 0; c < C; ++c ) {
+      ts.emplace_back([&]() {
+        while ( !ready.load(std::memory_order_acquire) );
+        u64 buf[32];
+        while ( consumed.load(std::memory_order_relaxed) < P * PER ) {
+          const usize n = q.pop_n(buf, 32);
+          for ( usize k = 0; k < n; ++k ) sink += buf[k];
+          if ( n ) consumed.fetch_add(n, std::memory_order_relaxed);
+        }
+      });
+    }
+    u64 t0 = now_ns();
+    ready.store(true, std::memory_order_release);
+    for ( auto &t : ts ) t.join();
+    u64 t1 = now_ns();
+    usize total = P * PER;
+    double ns = static_cast<double>(t1 - t0) / static_cast<double>(total);
+    print_row("seg_mpmc", "4p4c-unbound", total, ns);
+  }
+
   micron::io::println("sink=", sink);
   return 0;
 }
@@ -0,0 +1,212 @@
+//  Copyright (c) 2024- David Lucius Severus
+//
+//  Distributed under the Boost Software License, Version 1.0.
+//  See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt
+
+#define MICRON_ABC_MT 1      // spawns threads/coroutines; abcmalloc's -k gate must be MT (bits/__abc_mt.hpp)
+
+#include "../src/io/console.hpp"
+#include "../src/linux/sys/time.hpp"
+#include "../src/std.hpp"
+
+#include "../src/mutex/locks.hpp"
+#include "../src/thread/thread.hpp"
+
+#include "../src/trees/b.hpp"
+#include "../src/trees/olc_b.hpp"
+
+// olc_b_tree (optimistic lock coupling) vs b_tree behind one spin_lock
+// same key space, same op mix, 1/2/4 threads; read ratio varied, plus short range scans
+
+namespace
+{
+
+constexpr u32 K_MEASUREMENTS = 5;
+constexpr u64 WARMUP = 2;
+constexpr u64 KEYS = 1u << 18;
+constexpr u32 K_MAX_THREADS = 4;
+
+f64 g_tsc_ghz = 1.0;
+
+[[gnu::always_inline]] inline u64
+rdtsc() noexcept
+{
+  u32 lo, hi;
+  asm volatile("lfence; rdtsc" : "=a"(lo), "=d"(hi));
+  return (static_cast<u64>(hi) << 32) | lo;
+}
+
+[[gnu::always_inline]] inline u64
+wall_ns() noexcept
+{
+  micron::timespec_t ts{};
+  micron::clock_gettime(micron::clock_monotonic, ts);
+  return static_cast<u64>(ts.tv_sec) * 1000000000ULL + static_cast<u64>(ts.tv_nsec);
+}
+
+void
+calibrate_tsc() noexcept
+{
+  const u64 n0 = wall_ns();
+  const u64 c0 = rdtsc();
+  while ( wall_ns() - n0 < 50000000ULL ) {
+  }
+  const u64 c1 = rdtsc();
+  const u64 n1 = wall_ns();
+  g_tsc_ghz = static_cast<f64>(c1 - c0) / static_cast<f64>(n1 - n0);
+}
+
+[[gnu::always_inline]] inline f64
+cyc_to_ns(u64 cyc) noexcept
+{
+  return static_cast<f64>(cyc) / g_tsc_ghz;
+}
+
+[[gnu::always_inline]] inline void
+clobber(u64 v) noexcept
+{
+  asm volatile("" : : "r"(v) : "memory");
+}
+
+f64
+median(f64 *xs, u32 n) noexcept
+{
+  for ( u32 i = 1; i < n; ++i ) {
+    f64 k = xs[i];
+    u32 j = i;
+    while ( j > 0 && xs[j - 1] > k ) {
+      xs[j] = xs[j - 1];
+      --j;
+    }
+    xs[j] = k;
+  }
+  return xs[n / 2];
+}
+
+void
+report(const char *name, f64 nsop) noexcept
+{
+  if ( nsop < 0 ) nsop = 0;
+  u64 centi = static_cast<u64>(nsop * 100.0 + 0.5);
+  micron::io::print("  ", name, "  ", centi / 100, ".", (centi % 100 < 10 ? "0" : ""), centi % 100, " ns/op\n");
+}
+
+[[gnu::always_inline]] inline u64
+mix(u64 x) noexcept
+{
+  x ^= x >> 33;
+  x *= 0xff51afd7ed558ccdULL;
+  x ^= x >> 33;
+  return x;
+}
+
+// b_tree with the whole structure behind one lock, the baseline the concurrent tree replaces
+struct locked_b_tree {
+  micron::spin_lock lock;
+  micron::b_tree<u64, u64> t;
+
+  bool
+  find(u64 k, u64 &out)
+  {
+    micron::lock_guard<micron::spin_lock> __g(lock);
+    const u64 *p = t.find(k);
+    if ( p ) out = *p;
+    return p != nullptr;
+  }
+
+  void
+  insert_or_assign(u64 k, u64 v)
+  {
+    micron::lock_guard<micron::spin_lock> __g(lock);
+    t.insert_or_assign(k, v);
+  }
+
+  template<typename Fn>
+  void
+  scan(u64 lo, usize n, Fn &&fn)
+  {
+    micron::lock_guard<micron::spin_lock> __g(lock);
+    usize i = 0;
+    for ( auto it = t.lower_bound(lo); it != t.end() and i < n; ++it, ++i ) {
+      auto kv = *it;
+      fn(kv.key, kv.value);
+    }
+  }
+};
+
+// per 100 ops: read_pct point lookups, scan_pct 16-key range scans, the rest insert_or_assign
+template<class M>
+f64
+bench_mix(M &m, u32 threads, u64 n_per_thread, u32 read_pct, u32 scan_pct) noexcept
+{
+  f64 samples[K_MEASUREMENTS];
+  for ( u32 r = 0; r < K_MEASUREMENTS + WARMUP; ++r ) {
+    u64 sinks[K_MAX_THREADS] = {};
+    micron::__thread_pointer<micron::auto_thread<>> ts[K_MAX_THREADS];
+    const u64 c0 = rdtsc();
+    for ( u32 t = 0; t < threads; ++t )
+      ts[t] = micron::solo::spawn<micron::auto_thread<>>([&, t]() {
+        u64 s = 0;
+        u64 x = mix(t + 1 + r * K_MAX_THREADS);
+        for ( u64 i = 0; i < n_per_thread; ++i ) {
+          x = mix(x + i);
+          const u64 k = x & (KEYS - 1);
+          const u32 dice = static_cast<u32>((x >> 40) % 100);
+          if ( dice < read_pct ) {
+            u64 v = 0;
+            s += m.find(k, v) ? v : 1;
+          } else if ( dice < read_pct + scan_pct ) {
+            m.scan(k, 16, [&s](const u64 &, const u64 &v) { s += v; });
+          } else {
+            m.insert_or_assign(k, i);
+          }
+        }
+        sinks[t] = s;
+      });
+    for ( u32 t = 0; t < threads; ++t ) micron::solo::join(ts[t]);
+    const u64 c1 = rdtsc();
+    u64 s = 0;
+    for ( u32 t = 0; t < threads; ++t ) s += sinks[t];
+    clobber(s);
+    if ( r >= WARMUP ) samples[r - WARMUP] = cyc_to_ns(c1 - c0) / static_cast<f64>(n_per_thread * threads);
+  }
+  return median(samples, K_MEASUREMENTS);
+}
+
+}      // namespace
+
+int
+main(void)
+{
+  calibrate_tsc();
+  micron::io::print("=== olc_b_tree bench (TSC ", static_cast<u64>(g_tsc_ghz * 1000.0), " MHz) ===\n");
+
+  locked_b_tree lb;
+  micron::olc_b_tree<u64, u64> ob;
+  for ( u64 k = 0; k < KEYS; k += 2 ) {
+    lb.t.insert_or_assign(k, k);
+    ob.insert_or_assign(k, k);
+  }
+
+  struct mix_t {
+    u32 read;
+    u32 scan;
+  };
+
+  const mix_t mixes[3] = { { 50, 0 }, { 95, 0 }, { 80, 15 } };
+  const u32 threads[3] = { 1, 2, 4 };
+  for ( const mix_t &mx : mixes ) {
+    for ( u32 th : threads ) {
+      micron::io::print("\n-- ", mx.read, "% reads, ", mx.scan, "% scans, ", th, " threads --\n");
+      const f64 l = bench_mix(lb, th, 500000ULL, mx.read, mx.scan);
+      const f64 o = bench_mix(ob, th, 500000ULL, mx.read, mx.scan);
+      report("b_tree+spin ", l);
+      report("olc_b_tree  ", o);
+      if ( o > 0.0 ) micron::io::print("  -> olc_b_tree ", static_cast<u64>((l / o) * 100.0 + 0.5), "% of locked b_tree throughput\n");
+    }
+  }
+
+  micron::io::print("\n=== done ===\n");
+  return 0;
+}
@@ -25,3 +25,5 @@
 #include "weave.hpp"
 #include "window.hpp"
 #include "zip.hpp"
+
+// par.hpp (lz::par) is deliberately not pulled in here, it drags in the coroutine engine; include it directly
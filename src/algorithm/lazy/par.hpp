@@ -0,0 +1,456 @@
+//  Copyright (c) 2026- David Lucius Severus
+//
+//  Distributed under the Boost Software License, Version 1.0.
+//  See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt
+#pragma once
+
+#include "../../bits/__abc_mt.hpp"      // autofires MICRON_ABC_MT; must precede abcmalloc
+
+#include "../../parallel/engine.hpp"
+#include "../../vector.hpp"
+
+#include "collect.hpp"
+#include "filter.hpp"
+#include "reduce.hpp"
+#include "source.hpp"
+#include "transform.hpp"
+#include "window.hpp"
+#include "zip.hpp"
+
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+// lz::par -- run a fused lz chain over grains of an exact, contiguous source on the coroutine engine
+//
+//   v | lz::par(lz::fmap(f), lz::filter(p)) | lz::par_reduce(0, plus)
+//   v | lz::par(lz::zip(w), lz::fmap(g))     | lz::par_collect<vec>()
+//   v | lz::par(lz::sliding(4), lz::fmap(h)) | lz::par_scan(0, plus)
+//
+// the source is split into __grain_for(n) sized blocks; every block rebuilds the SAME chain over a
+// ptr_view of its slice, so each worker runs one fused serial pipeline and nothing is materialized
+// in between. terminals return micron::task<R>, like everything else in parallel::
+//
+// only stages whose output over a slice is the slice of their output may sit inside par():
+//   fmap / transform / add / multiply / ...   elementwise, anywhere
+//   filter / reject                           drops elements, anywhere
+//   zip / zip_with (flat exact other side)    sliced at the same offsets; only before a filter/window
+//   sliding(n)                                each block reads n-1 elements past its end
+//   chunk(n)                                  blocks are rounded up to a multiple of n
+// take / scan / unique / group / enumerate all need the whole sequence -- apply them after the terminal
+//
+// NOTE: the source is borrowed, it must outlive the returned task
+// WARNING: par_reduce's and par_scan's op must be associative, and par_reduce's seed its identity;
+// fp sums reorder across blocks exactly like parallel::reduce
+
+namespace micron
+{
+namespace lz
+{
+
+enum class __par_shape : u8 { serial = 0, elementwise = 1, sparse = 2, offset = 3, window = 4 };
+
+// where the indices of the stream stand, relative to the source, after a prefix of the chain
+enum class __par_at : u8 { aligned = 0, windowed = 1, sparse = 2 };
+
+template<typename S> struct __par_stage {
+  static constexpr __par_shape shape = __par_shape::serial;
+};
+
+template<typename F> struct __par_stage<__fmap_fn<F>> {
+  static constexpr __par_shape shape = __par_shape::elementwise;
+};
+
+template<typename P> struct __par_stage<__filter_fn<P>> {
+  static constexpr __par_shape shape = __par_shape::sparse;
+};
+
+template<typename U, typename F> struct __par_stage<__zip_with_fn<ptr_view<U>, F>> {
+  static constexpr __par_shape shape = __par_shape::offset;
+
+  static constexpr __zip_with_fn<ptr_view<U>, F>
+  __slice(const __zip_with_fn<ptr_view<U>, F> &__s, usize __lo, usize __hi) noexcept
+  {
+    const usize __m = __s.__w.__size_exact();
+    const U *__b = __s.__w.begin();
+    return { ptr_view<U>{ __b + (__lo < __m ? __lo : __m), __b + (__hi < __m ? __hi : __m) }, __s.__f };
+  }
+};
+
+template<> struct __par_stage<__sliding_fn> {
+  static constexpr __par_shape shape = __par_shape::window;
+
+  static constexpr usize
+  __halo(const __sliding_fn &__s) noexcept
+  {
+    return __s.__n ? __s.__n - 1u : 0u;
+  }
+};
+
+template<> struct __par_stage<__chunk_fn> {
+  static constexpr __par_shape shape = __par_shape::window;
+
+  static constexpr usize
+  __align(const __chunk_fn &__s) noexcept
+  {
+    return __s.__n ? __s.__n : 1u;
+  }
+};
+
+template<__par_at At>
+consteval __par_at
+__par_walk()
+{
+  return At;
+}
+
+template<__par_at At, typename S, typename... R>
+consteval __par_at
+__par_walk()
+{
+  constexpr __par_shape __k = __par_stage<S>::shape;
+  static_assert(__k != __par_shape::serial, "micron::lz::par: this stage needs the whole sequence (take/scan/unique/group/enumerate/...) "
+                                            "and cannot run per block -- apply it to the terminal's result instead");
+  static_assert(__k != __par_shape::offset || At == __par_at::aligned,
+                "micron::lz::par: zip slices its other side at the source offsets -- put it before any filter or window");
+  static_assert(__k != __par_shape::window || At == __par_at::aligned,
+                "micron::lz::par: sliding/chunk need source-aligned blocks -- put them before any filter, and use at most one");
+  constexpr __par_at __next = (__k == __par_shape::sparse) ? __par_at::sparse : (__k == __par_shape::window ? __par_at::windowed : At);
+  return __par_walk<__next, R...>();
+}
+
+template<typename... S> struct __par_chain;
+
+template<> struct __par_chain<> {
+  template<typename V>
+  constexpr V
+  __apply(V __v, usize, usize) const
+  {
+    return __v;
+  }
+
+  constexpr usize
+  __halo() const noexcept
+  {
+    return 0u;
+  }
+
+  constexpr usize
+  __align() const noexcept
+  {
+    return 1u;
+  }
+};
+
+template<typename S, typename... R> struct __par_chain<S, R...> {
+  [[no_unique_address]] S __s;
+  [[no_unique_address]] __par_chain<R...> __r;
+
+  template<typename V>
+  constexpr auto
+  __apply(V __v, usize __lo, usize __hi) const
+  {
+    if constexpr ( __par_stage<S>::shape == __par_shape::offset )
+      return __r.__apply(__par_stage<S>::__slice(__s, __lo, __hi)(micron::move(__v)), __lo, __hi);
+    else
+      return __r.__apply(__s(micron::move(__v)), __lo, __hi);
+  }
+
+  constexpr usize
+  __halo() const noexcept
+  {
+    if constexpr ( requires { __par_stage<S>::__halo(__s); } )
+      return __par_stage<S>::__halo(__s) + __r.__halo();
+    else
+      return __r.__halo();
+  }
+
+  constexpr usize
+  __align() const noexcept
+  {
+    if constexpr ( requires { __par_stage<S>::__align(__s); } )
+      return __par_stage<S>::__align(__s);
+    else
+      return __r.__align();
+  }
+};
+
+constexpr __par_chain<>
+__par_make() noexcept
+{
+  return {};
+}
+
+template<typename S, typename... R>
+constexpr __par_chain<micron::decay_t<S>, micron::decay_t<R>...>
+__par_make(S &&__s, R &&...__r)
+{
+  return { micron::forward<S>(__s), __par_make(micron::forward<R>(__r)...) };
+}
+
+template<typename T, typename... S> class par_view
+{
+  const T *__p = nullptr;
+  usize __n = 0;
+  usize __g = 1;
+  __par_chain<S...> __c;
+
+public:
+  using __par_view_tag = void;
+  using __block_view = decltype(micron::declval<const __par_chain<S...> &>().__apply(ptr_view<T>{}, 0u, 0u));
+  using value_type = micron::ranges::range_value_t<__block_view>;
+
+  static constexpr size_kind __kind = kind_of<__block_view>;
+
+  par_view(const T *__b, usize __nn, __par_chain<S...> __cc) : __p(__b), __n(__nn), __c(micron::move(__cc))
+  {
+    const usize __a = __c.__align();
+    const usize __gg = __n ? micron::parallel::__grain_for(__n) : 1u;
+    __g = ((__gg + __a - 1u) / __a) * __a;
+  }
+
+  constexpr usize
+  size() const noexcept
+  {
+    return __n;
+  }
+
+  constexpr usize
+  blocks() const noexcept
+  {
+    return (__n + __g - 1u) / __g;
+  }
+
+  // block __b over [lo, hi + halo), clipped to the source; the chain sees source offsets for zip
+  constexpr __block_view
+  block(usize __b) const
+  {
+    const usize __lo = __b * __g;
+    const usize __hi = (__lo + __g < __n) ? __lo + __g : __n;
+    const usize __he = (__hi + __c.__halo() < __n) ? __hi + __c.__halo() : __n;
+    return __c.__apply(ptr_view<T>{ __p + __lo, __p + __he }, __lo, __he);
+  }
+};
+
+template<typename... S> struct __par_fn {
+  __par_chain<S...> __c;
+
+  template<typename R>
+  constexpr auto
+  operator()(R &&__r) const
+  {
+    static_assert(micron::is_lvalue_reference_v<R> || requires { typename micron::remove_cvref_t<R>::__borrowed_tag; },
+                  "micron::lz::par: the source is borrowed by the task -- pass an lvalue that outlives it");
+    auto __v = __as_view(micron::forward<R>(__r));
+    using B = micron::remove_cvref_t<decltype(__v)>;
+    static_assert(flat_exact<B>, "micron::lz::par: the source must be exact and contiguous (a contiguous container or a ptr_view)");
+    using T = micron::ranges::range_value_t<B>;
+    const usize __n = static_cast<usize>(__v.__size_exact());
+    const T *__b = __n ? micron::addressof(*micron::ranges::begin(__v)) : nullptr;
+    return par_view<T, S...>{ __b, __n, __c };
+  }
+};
+
+template<typename... S>
+[[nodiscard]] constexpr auto
+par(S &&...__s)
+{
+  static_cast<void>(__par_walk<__par_at::aligned, micron::decay_t<S>...>());
+  return __par_fn<micron::decay_t<S>...>{ __par_make(micron::forward<S>(__s)...) };
+}
+
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+// terminals
+
+namespace __impl
+{
+
+template<typename Out, typename PV>
+micron::task<Out>
+__par_collect(PV __pv)
+{
+  const usize __nb = __pv.blocks();
+  if ( __nb == 0 ) co_return Out{};
+  const PV *__v = &__pv;
+
+  micron::vector<usize> __cnt(__nb);
+  usize *__counts = &__cnt[0];
+  if constexpr ( PV::__kind == size_kind::exact ) {      // O(1) per block, not worth a fork
+    for ( usize __b = 0; __b < __nb; ++__b ) __counts[__b] = count_into(__v->block(__b));
+  } else {
+    auto __body = [__v, __counts](usize __b) { __counts[__b] = count_into(__v->block(__b)); };
+    co_await micron::parallel::__pblocks<decltype(__body)>(0, __nb, __body, 1);
+  }
+
+  micron::vector<usize> __off(__nb);
+  usize *__offsets = &__off[0];
+  usize __total = 0;
+  for ( usize __b = 0; __b < __nb; ++__b ) {
+    __offsets[__b] = __total;
+    __total += __counts[__b];
+  }
+
+  Out __out = __sized<Out>(__total);
+  auto *__dst = __out.begin();
+  {
+    auto __body = [__v, __offsets, __dst](usize __b) {
+      auto *__restrict __d = __dst + __offsets[__b];
+      __each(__v->block(__b), [&](auto &&__x) { *__d++ = micron::forward<decltype(__x)>(__x); });
+    };
+    co_await micron::parallel::__pblocks<decltype(__body)>(0, __nb, __body, 1);
+  }
+  co_return __out;
+}
+
+template<typename A, typename PV, typename F>
+micron::task<A>
+__par_reduce(PV __pv, A __id, F __op)
+{
+  const usize __nb = __pv.blocks();
+  if ( __nb == 0 ) co_return __id;
+  const PV *__v = &__pv;
+  auto __leaf = [__v, __id, __op](usize __lo, usize __hi) -> A {
+    A __acc = __id;
+    for ( usize __b = __lo; __b < __hi; ++__b ) __each(__v->block(__b), [&](auto &&__x) { __acc = __op(__acc, __x); });
+    return __acc;
+  };
+  auto __comb = [__op](A __l, A __r) -> A { return __op(__l, __r); };
+  co_return co_await micron::parallel::__pmapreduce<usize, decltype(__leaf), decltype(__comb), A>(0, __nb, __leaf, __comb, 1);
+}
+
+// out[0] = init, out[1 + i] = op(init, x0, ..., xi); the same sequence lz::scanl yields
+template<typename Out, typename A, typename PV, typename F>
+micron::task<Out>
+__par_scan(PV __pv, A __init, F __op)
+{
+  const usize __nb = __pv.blocks();
+  const PV *__v = &__pv;
+
+  micron::vector<usize> __cnt(__nb ? __nb : 1u);
+  micron::vector<A> __tot(__nb ? __nb : 1u);
+  usize *__counts = &__cnt[0];
+  A *__totals = &__tot[0];
+  {
+    auto __body = [__v, __counts, __totals, __op](usize __b) {
+      usize __c = 0;
+      A __acc{};
+      __each(__v->block(__b), [&](auto &&__x) {
+        __acc = __c ? __op(__acc, static_cast<A>(__x)) : static_cast<A>(__x);
+        ++__c;
+      });
+      __counts[__b] = __c;
+      __totals[__b] = __acc;
+    };
+    co_await micron::parallel::__pblocks<decltype(__body)>(0, __nb, __body, 1);
+  }
+
+  // exclusive carries, seeded with init; empty blocks contribute nothing
+  micron::vector<usize> __off(__nb ? __nb : 1u);
+  micron::vector<A> __cr(__nb ? __nb : 1u);
+  usize *__offsets = &__off[0];
+  A *__carry = &__cr[0];
+  usize __total = 1u;
+  A __acc = __init;
+  for ( usize __b = 0; __b < __nb; ++__b ) {
+    __offsets[__b] = __total;
+    __carry[__b] = __acc;
+    if ( __counts[__b] ) __acc = __op(__acc, __totals[__b]);
+    __total += __counts[__b];
+  }
+
+  Out __out = __sized<Out>(__total);
+  auto *__dst = __out.begin();
+  __dst[0] = __init;
+  {
+    auto __body = [__v, __offsets, __carry, __dst, __op](usize __b) {
+      auto *__restrict __d = __dst + __offsets[__b];
+      A __a = __carry[__b];
+      __each(__v->block(__b), [&](auto &&__x) {
+        __a = __op(__a, static_cast<A>(__x));
+        *__d++ = __a;
+      });
+    };
+    co_await micron::parallel::__pblocks<decltype(__body)>(0, __nb, __body, 1);
+  }
+  co_return __out;
+}
+
+};      // namespace __impl
+
+template<typename Out> struct __par_collect_fn {
+  template<typename T, typename... S>
+  micron::task<Out>
+  operator()(par_view<T, S...> __pv) const
+  {
+    static_assert(sizable<Out>, "micron::lz::par_collect: Out needs resize() -- every block writes at its own offset");
+    return __impl::__par_collect<Out, par_view<T, S...>>(micron::move(__pv));
+  }
+};
+
+template<typename A, typename F> struct __par_reduce_fn {
+  A __id;
+  [[no_unique_address]] F __op;
+
+  template<typename T, typename... S>
+  micron::task<A>
+  operator()(par_view<T, S...> __pv) const
+  {
+    return __impl::__par_reduce<A, par_view<T, S...>, F>(micron::move(__pv), __id, __op);
+  }
+};
+
+template<typename Out, typename A, typename F> struct __par_scan_fn {
+  A __init;
+  [[no_unique_address]] F __op;
+
+  template<typename T, typename... S>
+  micron::task<Out>
+  operator()(par_view<T, S...> __pv) const
+  {
+    static_assert(sizable<Out>, "micron::lz::par_scan: Out needs resize() -- every block writes at its own offset");
+    return __impl::__par_scan<Out, A, par_view<T, S...>, F>(micron::move(__pv), __init, __op);
+  }
+};
+
+template<typename Out>
+[[nodiscard]] constexpr auto
+par_collect() noexcept
+{
+  return __par_collect_fn<Out>{};
+}
+
+template<typename A, typename F>
+[[nodiscard]] constexpr auto
+par_reduce(A __id, F &&__op)
+{
+  return __par_reduce_fn<A, micron::decay_t<F>>{ micron::move(__id), micron::forward<F>(__op) };
+}
+
+template<typename A, typename F, typename Out = micron::vector<A>>
+[[nodiscard]] constexpr auto
+par_scan(A __init, F &&__op)
+{
+  return __par_scan_fn<Out, A, micron::decay_t<F>>{ micron::move(__init), micron::forward<F>(__op) };
+}
+
+template<typename T> struct __is_par_terminal : micron::false_type {
+};
+
+template<typename Out> struct __is_par_terminal<__par_collect_fn<Out>> : micron::true_type {
+};
+
+template<typename A, typename F> struct __is_par_terminal<__par_reduce_fn<A, F>> : micron::true_type {
+};
+
+template<typename Out, typename A, typename F> struct __is_par_terminal<__par_scan_fn<Out, A, F>> : micron::true_type {
+};
+
+// par_view is not a range, so nothing drags micron:: into ADL here; the terminals are piped explicitly
+template<typename T, typename... S, typename Term>
+  requires __is_par_terminal<micron::remove_cvref_t<Term>>::value
+[[nodiscard]] auto
+operator|(par_view<T, S...> __pv, Term &&__t)
+{
+  return __t(micron::move(__pv));
+}
+
+};      // namespace lz
+};      // namespace micron
@@ -0,0 +1,556 @@
+//  Copyright (c) 2026- David Lucius Severus
+//
+//  Distributed under the Boost Software License, Version 1.0.
+//  See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt
+#pragma once
+
+#include "../atomic/intrin.hpp"
+#include "../bits/__arch.hpp"
+#include "../linux/sys/sysinfo.hpp"
+#include "../memory/mman.hpp"
+#include "../new.hpp"
+#include "../syscall.hpp"
+#include "../types.hpp"
+
+#include "cycles.hpp"
+
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+// in-process profiling
+//
+// named regions, timed by scopes. every scope records TSC ticks plus, where perf_event_open is allowed, cycles, instructions, cache
+// misses and branch misses for the calling thread (one counter group per thread, user space only). counters are read with rdpmc
+// through the event's mmap page when the kernel exposes it (cap_user_rdpmc), with a group read() otherwise
+//
+// samples land in per-thread log2 histograms: one writer (the owning thread), relaxed atomics throughout, so snapshot() can merge them
+// from any thread at any time without stopping anybody. thread records outlive their threads, so short lived workers still show up;
+// an exited thread's record is taken over by the next thread to open a scope, so there are only ever as many as threads profiling at once
+//
+// cost per scope is two counter reads and one histogram update per metric; with rdpmc and only ticks + cycles enabled that is well
+// under 30ns, all four hardware counters roughly double it. configure() picks the set, MICRON_PROFILE_OFF compiles scopes away
+//
+// NOTE: hardware counters are routinely unavailable (perf_event_paranoid > 2, most VMs, containers without CAP_PERFMON); everything
+// still works, the hardware metrics just stay empty. available() says which ones are live on the calling thread
+
+#ifndef MICRON_PROFILE_MAX_REGIONS
+#define MICRON_PROFILE_MAX_REGIONS 256
+#endif
+
+namespace micron
+{
+namespace profile
+{
+
+enum class metric : u32 { ticks = 0, cycles, instructions, cache_misses, branch_misses, __count };
+
+inline constexpr usize metric_count = static_cast<usize>(metric::__count);
+inline constexpr usize hist_buckets = 48;      // bucket b holds [2^(b-1), 2^b), 0 goes to bucket 0, the last one is open ended
+inline constexpr u32 max_regions = MICRON_PROFILE_MAX_REGIONS;
+
+inline constexpr u32
+bit(metric m) noexcept
+{
+  return 1u << static_cast<u32>(m);
+}
+
+inline constexpr u32 all_metrics = (1u << metric_count) - 1u;
+
+namespace __impl
+{
+
+// perf_event_attr at ABI version 5 (112 bytes), the kernel accepts any published size
+struct __pe_attr {
+  u32 type;
+  u32 size;
+  u64 config;
+  u64 sample_period;
+  u64 sample_type;
+  u64 read_format;
+  u64 flags;
+  u32 wakeup_events;
+  u32 bp_type;
+  u64 config1;
+  u64 config2;
+  u64 branch_sample_type;
+  u64 sample_regs_user;
+  u32 sample_stack_user;
+  i32 clockid;
+  u64 sample_regs_intr;
+  u32 aux_watermark;
+  u16 sample_max_stack;
+  u16 __reserved;
+};
+
+static_assert(sizeof(__pe_attr) == 112, "micron::profile: perf_event_attr layout");
+
+// head of perf_event_mmap_page, the seqlock'd part rdpmc needs
+struct __pe_page {
+  u32 version;
+  u32 compat_version;
+  u32 lock;
+  u32 index;
+  i64 offset;
+  u64 time_enabled;
+  u64 time_running;
+  u64 capabilities;
+  u16 pmc_width;
+};
+
+inline constexpr u32 __pe_type_hardware = 0;
+inline constexpr u64 __pe_format_group = 1ull << 3;
+inline constexpr u64 __pe_exclude_kernel = 1ull << 5;
+inline constexpr u64 __pe_exclude_hv = 1ull << 6;
+inline constexpr u64 __pe_cap_user_rdpmc = 1ull << 2;
+
+// PERF_COUNT_HW_* per hardware metric, in metric order after ticks
+inline constexpr u64 __pe_config[4] = { 0 /* cycles */, 1 /* instructions */, 3 /* cache misses */, 5 /* branch misses */ };
+
+struct __hist {
+  u64 count;
+  u64 sum;
+  u64 min;
+  u64 max;
+  u64 b[hist_buckets];
+};
+
+struct __record {
+  __hist m[metric_count];
+};
+
+struct __thread_state {
+  __record *recs[max_regions];
+  __thread_state *next;
+  i32 fd[4];                 // per hardware metric, -1 when not open
+  __pe_page *page[4];        // mmap'd event pages, rdpmc source
+  u32 slot[4];               // position of each metric in a group read
+  u32 n_open;
+  u32 mask;                  // metrics recorded on this thread
+  u32 live;                  // owned by a running thread; 0 once it exited, free to take over
+  bool rdpmc;
+};
+
+inline const char *__names[max_regions] = {};
+inline u32 __n_regions = 0;
+inline __thread_state *__threads = nullptr;      // push-only list, never freed, entries recycled through live
+inline u32 __config = all_metrics;
+
+inline thread_local __thread_state *__tls = nullptr;
+
+[[gnu::always_inline]] inline u32
+__bucket(u64 v) noexcept
+{
+  if ( v == 0 ) return 0;
+  const u32 b = 64u - static_cast<u32>(__builtin_clzll(v));
+  return b < hist_buckets ? b : static_cast<u32>(hist_buckets - 1);
+}
+
+inline void
+__close(__thread_state &t) noexcept
+{
+  const usize ps = micron::getpagesizelive();
+  for ( u32 k = 0; k < 4; ++k ) {
+    if ( t.page[k] != nullptr ) micron::munmap(reinterpret_cast<addr_t *>(t.page[k]), ps);
+    if ( t.fd[k] >= 0 ) micron::syscall(SYS_close, t.fd[k]);
+    t.page[k] = nullptr;
+    t.fd[k] = -1;
+  }
+  t.n_open = 0;
+  t.rdpmc = false;
+  atom::store(&t.mask, t.mask & bit(metric::ticks), __ATOMIC_RELAXED);
+}
+
+// closes the thread's counters on exit and hands its state back; the records stay on the list
+struct __tls_closer {
+  __thread_state *s = nullptr;
+
+  ~__tls_closer()
+  {
+    if ( s != nullptr ) {
+      __close(*s);
+      atom::store(&s->live, 0u, __ATOMIC_RELEASE);
+    }
+    __tls = nullptr;
+  }
+};
+
+inline thread_local __tls_closer __tls_owner;
+
+inline void
+__open(__thread_state &t) noexcept
+{
+  i32 leader = -1;
+  for ( u32 k = 0; k < 4; ++k ) {
+    if ( !(t.mask & (2u << k)) ) continue;
+    __pe_attr a{};
+    a.type = __pe_type_hardware;
+    a.size = sizeof(__pe_attr);
+    a.config = __pe_config[k];
+    a.read_format = __pe_format_group;
+    a.flags = __pe_exclude_kernel | __pe_exclude_hv;
+    const long fd = micron::syscall(SYS_perf_event_open, &a, 0, -1, leader, 0);
+    if ( fd < 0 ) {
+      t.mask &= ~(2u << k);
+      continue;
+    }
+    t.fd[k] = static_cast<i32>(fd);
+    t.slot[k] = t.n_open++;
+    if ( leader < 0 ) leader = static_cast<i32>(fd);
+  }
+  if ( t.n_open == 0 ) return;
+#if defined(__micron_arch_x86_any)
+  const usize ps = micron::getpagesizelive();
+  t.rdpmc = true;
+  for ( u32 k = 0; k < 4; ++k ) {
+    if ( t.fd[k] < 0 ) continue;
+    addr_t *p = micron::mmap(nullptr, ps, prot_read, map_shared, t.fd[k], 0);
+    if ( micron::mmap_failed(p) ) {
+      t.rdpmc = false;
+      continue;
+    }
+    t.page[k] = reinterpret_cast<__pe_page *>(p);
+    if ( !(t.page[k]->capabilities & __pe_cap_user_rdpmc) ) t.rdpmc = false;
+  }
+#endif
+}
+
+// a dead thread's state if there is one, its histograms keep accumulating under the new owner
+inline __thread_state *
+__adopt() noexcept
+{
+  for ( __thread_state *t = atom::load(&__threads, __ATOMIC_ACQUIRE); t != nullptr; t = t->next ) {
+    u32 dead = 0;
+    if ( atom::load(&t->live, __ATOMIC_RELAXED) == 0
+         and atom::compare_exchange(&t->live, &dead, 1u, false, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED) )
+      return t;
+  }
+  return nullptr;
+}
+
+[[gnu::noinline]] inline __thread_state *
+__init_thread() noexcept
+{
+  __thread_state *t = __adopt();
+  const bool fresh = t == nullptr;
+  if ( fresh ) {
+    t = new __thread_state{};
+    t->live = 1;
+    for ( u32 k = 0; k < 4; ++k ) t->fd[k] = -1;
+  }
+  t->mask = atom::load(&__config, __ATOMIC_RELAXED) | bit(metric::ticks);
+  __open(*t);
+  if ( fresh ) {
+    __thread_state *h = atom::load(&__threads, __ATOMIC_RELAXED);
+    do {
+      t->next = h;
+    } while ( !atom::compare_exchange(&__threads, &h, t, true, __ATOMIC_RELEASE, __ATOMIC_RELAXED) );
+  }
+  __tls = t;
+  __tls_owner.s = t;
+  return t;
+}
+
+[[gnu::always_inline]] inline __thread_state *
+__state() noexcept
+{
+  __thread_state *t = __tls;
+  return t != nullptr ? t : __init_thread();
+}
+
+// rdpmc on every open counter, false if any of them isn't on a pmu right now (then the caller falls back to read())
+[[gnu::always_inline]] inline bool
+__read_rdpmc([[maybe_unused]] const __thread_state &t, [[maybe_unused]] u64 *v) noexcept
+{
+#if defined(__micron_arch_x86_any)
+  for ( u32 k = 0; k < 4; ++k ) {
+    const volatile __pe_page *p = t.page[k];
+    if ( p == nullptr ) continue;
+    u32 seq;
+    u64 c;
+    do {
+      seq = p->lock;
+      chrono::fence_compiler();
+      const u32 idx = p->index;
+      if ( idx == 0 ) return false;
+      const u32 w = p->pmc_width;
+      i64 pmc = static_cast<i64>(chrono::rdpmc(idx - 1u) << (64u - w)) >> (64u - w);
+      c = static_cast<u64>(p->offset + pmc);
+      chrono::fence_compiler();
+    } while ( p->lock != seq );
+    v[k] = c;
+  }
+  return true;
+#else
+  return false;
+#endif
+}
+
+inline void
+__read_group(const __thread_state &t, u64 *v) noexcept
+{
+  u64 buf[5] = {};
+  i32 leader = -1;
+  for ( u32 k = 0; k < 4 and leader < 0; ++k ) leader = t.fd[k];
+  if ( micron::syscall(SYS_read, leader, buf, sizeof(buf)) < static_cast<long>(sizeof(u64)) ) return;
+  for ( u32 k = 0; k < 4; ++k )
+    if ( t.fd[k] >= 0 and t.slot[k] < buf[0] ) v[k] = buf[1 + t.slot[k]];
+}
+
+[[gnu::always_inline]] inline void
+__read(const __thread_state &t, u64 *v) noexcept
+{
+  if ( t.n_open == 0 ) return;
+  if ( t.rdpmc and __read_rdpmc(t, v) ) return;
+  __read_group(t, v);
+}
+
+[[gnu::always_inline]] inline void
+__put(__hist &h, u64 x) noexcept
+{
+  // single writer: plain read-modify-write through relaxed atomics, readers only ever see whole words
+  atom::store(&h.count, atom::load(&h.count, __ATOMIC_RELAXED) + 1, __ATOMIC_RELAXED);
+  atom::store(&h.sum, atom::load(&h.sum, __ATOMIC_RELAXED) + x, __ATOMIC_RELAXED);
+  if ( x < atom::load(&h.min, __ATOMIC_RELAXED) ) atom::store(&h.min, x, __ATOMIC_RELAXED);
+  if ( x > atom::load(&h.max, __ATOMIC_RELAXED) ) atom::store(&h.max, x, __ATOMIC_RELAXED);
+  u64 *b = &h.b[__bucket(x)];
+  atom::store(b, atom::load(b, __ATOMIC_RELAXED) + 1, __ATOMIC_RELAXED);
+}
+
+[[gnu::noinline]] inline __record *
+__new_record(__thread_state &t, u32 id) noexcept
+{
+  __record *r = new __record{};
+  for ( usize m = 0; m < metric_count; ++m ) r->m[m].min = ~u64{ 0 };
+  atom::store(&t.recs[id], r, __ATOMIC_RELEASE);
+  return r;
+}
+
+};      // namespace __impl
+
+// a named region; give it static storage, ids are handed out once and never reused
+// regions past max_regions are accepted and silently not recorded
+class region
+{
+  u32 __id;
+
+public:
+  explicit region(const char *name) noexcept : __id(atom::fetch_add(&__impl::__n_regions, u32{ 1 }, __ATOMIC_ACQ_REL))
+  {
+    if ( __id < max_regions )
+      atom::store(&__impl::__names[__id], name, __ATOMIC_RELEASE);
+    else
+      __id = max_regions;
+  }
+
+  region(const region &) = delete;
+  region &operator=(const region &) = delete;
+
+  inline u32
+  id() const noexcept
+  {
+    return __id;
+  }
+};
+
+// times the enclosing block against a region on the calling thread
+class scope
+{
+#if !defined(MICRON_PROFILE_OFF)
+  __impl::__thread_state *__t;
+  u32 __id;
+  u64 __c[4];
+  u64 __t0;
+#endif
+
+public:
+#if !defined(MICRON_PROFILE_OFF)
+  [[gnu::always_inline]] explicit scope(const region &r) noexcept : __t(__impl::__state()), __id(r.id()), __c{ 0, 0, 0, 0 }, __t0(0)
+  {
+    __impl::__read(*__t, __c);
+    __t0 = chrono::tick_start();
+  }
+
+  [[gnu::always_inline]] ~scope()
+  {
+    const u64 t1 = chrono::tick_end();
+    u64 c1[4] = { 0, 0, 0, 0 };
+    __impl::__read(*__t, c1);
+    if ( __id >= max_regions ) return;
+    __impl::__record *r = __t->recs[__id];
+    if ( r == nullptr ) [[unlikely]]
+      r = __impl::__new_record(*__t, __id);
+    __impl::__put(r->m[0], t1 - __t0);
+    const u32 mask = __t->mask;
+    for ( u32 k = 0; k < 4; ++k )
+      if ( mask & (2u << k) ) __impl::__put(r->m[1 + k], c1[k] - __c[k]);
+  }
+#else
+  explicit scope(const region &) noexcept { }
+#endif
+
+  scope(const scope &) = delete;
+  scope &operator=(const scope &) = delete;
+};
+
+// metrics recorded by threads that open their first scope from now on (ticks are always on); fewer counters, cheaper scopes
+inline void
+configure(u32 metrics) noexcept
+{
+  atom::store(&__impl::__config, metrics | bit(metric::ticks), __ATOMIC_RELAXED);
+}
+
+// whether m is being recorded on the calling thread
+inline bool
+available(metric m) noexcept
+{
+  return (__impl::__state()->mask & bit(m)) != 0;
+}
+
+// whether the calling thread reads its counters with rdpmc rather than read()
+inline bool
+rdpmc_enabled() noexcept
+{
+  return __impl::__state()->rdpmc;
+}
+
+struct stats {
+  u64 count;
+  u64 sum;
+  u64 min;
+  u64 max;
+  u64 buckets[hist_buckets];
+
+  f64
+  mean() const noexcept
+  {
+    return count ? static_cast<f64>(sum) / static_cast<f64>(count) : 0.0;
+  }
+
+  // upper edge of the bucket holding the q-th quantile, q in [0, 1]; exact to within a factor of two
+  u64
+  quantile(f64 q) const noexcept
+  {
+    if ( count == 0 ) return 0;
+    const u64 rank = static_cast<u64>(q * static_cast<f64>(count - 1)) + 1;
+    u64 seen = 0;
+    for ( usize b = 0; b < hist_buckets; ++b ) {
+      seen += buckets[b];
+      if ( seen >= rank ) {
+        const u64 edge = b == 0 ? 0 : (b >= 64 ? ~u64{ 0 } : (u64{ 1 } << b) - 1u);
+        return edge < max ? edge : max;
+      }
+    }
+    return max;
+  }
+};
+
+struct region_stats {
+  const char *name;
+  u32 id;
+  stats m[metric_count];
+
+  const stats &
+  operator[](metric x) const noexcept
+  {
+    return m[static_cast<u32>(x)];
+  }
+};
+
+// merges every thread's samples for the first cap regions into out, returns how many it filled
+// lock-free against running scopes, so a snapshot taken under load can be a few samples out between fields
+inline usize
+snapshot(region_stats *out, usize cap) noexcept
+{
+  u32 n = atom::load(&__impl::__n_regions, __ATOMIC_ACQUIRE);
+  if ( n > max_regions ) n = max_regions;
+  if ( n > cap ) n = static_cast<u32>(cap);
+  for ( u32 i = 0; i < n; ++i ) {
+    region_stats &rs = out[i];
+    rs.name = atom::load(&__impl::__names[i], __ATOMIC_ACQUIRE);
+    rs.id = i;
+    for ( usize m = 0; m < metric_count; ++m ) {
+      stats &s = rs.m[m];
+      s.count = s.sum = s.max = 0;
+      s.min = ~u64{ 0 };
+      for ( usize b = 0; b < hist_buckets; ++b ) s.buckets[b] = 0;
+    }
+  }
+  for ( __impl::__thread_state *t = atom::load(&__impl::__threads, __ATOMIC_ACQUIRE); t != nullptr; t = t->next ) {
+    for ( u32 i = 0; i < n; ++i ) {
+      const __impl::__record *r = atom::load(&t->recs[i], __ATOMIC_ACQUIRE);
+      if ( r == nullptr ) continue;
+      for ( usize m = 0; m < metric_count; ++m ) {
+        const __impl::__hist &h = r->m[m];
+        stats &s = out[i].m[m];
+        s.count += atom::load(&h.count, __ATOMIC_RELAXED);
+        s.sum += atom::load(&h.sum, __ATOMIC_RELAXED);
+        const u64 lo = atom::load(&h.min, __ATOMIC_RELAXED), hi = atom::load(&h.max, __ATOMIC_RELAXED);
+        if ( lo < s.min ) s.min = lo;
+        if ( hi > s.max ) s.max = hi;
+        for ( usize b = 0; b < hist_buckets; ++b ) s.buckets[b] += atom::load(&h.b[b], __ATOMIC_RELAXED);
+      }
+    }
+  }
+  for ( u32 i = 0; i < n; ++i )
+    for ( usize m = 0; m < metric_count; ++m )
+      if ( out[i].m[m].count == 0 ) out[i].m[m].min = 0;
+  return n;
+}
+
+inline const char *
+name(metric m) noexcept
+{
+  constexpr const char *__n[metric_count] = { "ticks", "cycles", "instructions", "cache_misses", "branch_misses" };
+  return __n[static_cast<u32>(m)];
+}
+
+// one csv line per (region, metric) with samples: region,metric,count,sum,min,max,p50,p99
+// emit(const char *, usize) gets each line, newline included
+template<typename Emit>
+void
+export_csv(const region_stats *rs, usize n, Emit &&emit)
+{
+  char line[256];
+  auto put = [&line](usize at, const char *s) {
+    while ( *s and at < sizeof(line) - 1 ) line[at++] = *s++;
+    return at;
+  };
+  auto num = [&line](usize at, u64 v) {
+    char d[20];
+    usize k = 0;
+    do {
+      d[k++] = static_cast<char>('0' + v % 10);
+      v /= 10;
+    } while ( v );
+    while ( k and at < sizeof(line) - 1 ) line[at++] = d[--k];
+    return at;
+  };
+  usize at = put(0, "region,metric,count,sum,min,max,p50,p99\n");
+  emit(line, at);
+  for ( usize i = 0; i < n; ++i ) {
+    for ( usize m = 0; m < metric_count; ++m ) {
+      const stats &s = rs[i].m[m];
+      if ( s.count == 0 ) continue;
+      at = put(0, rs[i].name != nullptr ? rs[i].name : "?");
+      at = put(at, ",");
+      at = put(at, name(static_cast<metric>(m)));
+      const u64 cols[6] = { s.count, s.sum, s.min, s.max, s.quantile(0.5), s.quantile(0.99) };
+      for ( u64 c : cols ) {
+        at = put(at, ",");
+        at = num(at, c);
+      }
+      at = put(at, "\n");
+      emit(line, at);
+    }
+  }
+}
+
+};      // namespace profile
+};      // namespace micron
+
+#define __micron_profile_cat2(a, b) a##b
+#define __micron_profile_cat(a, b) __micron_profile_cat2(a, b)
+
+// times the rest of the enclosing block as region `name` (a string literal)
+#define MICRON_PROFILE_SCOPE(name)                                                                                                         \
+  static micron::profile::region __micron_profile_cat(__micron_prof_r, __LINE__)(name);                                                    \
+  micron::profile::scope __micron_profile_cat(__micron_prof_s, __LINE__)(__micron_profile_cat(__micron_prof_r, __LINE__))
@@ -0,0 +1,293 @@
+//  Copyright (c) 2024- David Lucius Severus
+//
+//  Distributed under the Boost Software License, Version 1.0.
+//  See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt
+#pragma once
+
+#include "../bits/__arch.hpp"
+#include "../type_traits.hpp"
+#include "../types.hpp"
+#include "hash.hpp"
+#include "rapidhash.hpp"
+#include "zzz_stream.hpp"
+
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+// batch hashing of short fixed-width keys
+//
+//   hash_batch(keys, n, out)                 out[i] == hash<hash64_t>(keys[i])
+//   hash_batch(keys, n, out, seed)           out[i] == hash64(&keys[i], sizeof(K), seed)
+//   hash_batch(bytes, width, n, out, seed)   out[i] == hash64(bytes + i * width, width, seed)
+//
+// zzz: a key of at most 32 bytes is one zero-padded block, so every 64-bit word past the key is zero and its four
+// state lanes mix to a constant of the seed. those fold into one word up front, and only the words the key covers
+// (one for an 8-byte key, two for 16) go through the four mixes, keys across the vector lanes:
+//
+//   avx-512   8 lanes, 16 keys a step
+//   avx2      4 lanes,  8 keys a step
+//   neon      2 lanes,  4 keys a step
+//
+// rapidhash: the 64x64->128 multiply has no vector form, the keys stay scalar and only the seed setup is shared by
+// the batch. every other default hash, and keys wider than 32 bytes, go key by key through hash64
+//
+// arithmetic keys take the batch path as they are. string keys do too under zzz: a group of them is bucketed by length,
+// the keys of each length up to 32 packed back to back and hashed as one fixed-width batch, so the kernel only pays off
+// when lengths repeat (fixed-format ids, codes, short tokens). longer strings, strings under rapidhash (no vector kernel
+// to feed) and every other key type fall back to hash<hash64_t> one key at a time
+
+namespace micron
+{
+
+#if defined(__micron_x86_avx512f)
+constexpr usize hash_batch_lanes = 8;
+#elif defined(__micron_x86_avx2)
+constexpr usize hash_batch_lanes = 4;
+#else
+constexpr usize hash_batch_lanes = 2;
+#endif
+
+// keys the zzz kernel hashes per step, two vectors
+constexpr usize hash_batch_step = 2 * hash_batch_lanes;
+
+template<typename K>
+constexpr bool hash_batchable = micron::is_arithmetic_v<K> && sizeof(K) <= 32
+                                && (default_hash_64 == hash_types::rapidhash
+#if defined(__micron_hash_zzz)
+                                    || default_hash_64 == hash_types::zzz
+#endif
+                                );
+
+// string keys hash_batch / hash_each bucket by length, see above
+template<typename K>
+constexpr bool hash_batchable_string =
+#if defined(__micron_hash_zzz)
+    micron::is_string<K> && default_hash_64 == hash_types::zzz;
+#else
+    false;
+#endif
+
+namespace __hbatch
+{
+
+typedef u64 __vu __attribute__((vector_size(8 * hash_batch_lanes)));
+
+inline __attribute__((always_inline)) __vu
+__splat(u64 x) noexcept
+{
+  __vu v;
+  for ( usize j = 0; j < hash_batch_lanes; ++j ) v[j] = x;
+  return v;
+}
+
+// word l of hash_batch_lanes keys width bytes apart, zero past the key
+inline __attribute__((always_inline)) __vu
+__word(const byte *p, usize width, usize l) noexcept
+{
+  __vu v;
+  const usize lo = 8 * l;
+  if ( width >= lo + 8 ) {
+    for ( usize j = 0; j < hash_batch_lanes; ++j ) v[j] = hashes::__load64(p + j * width + lo);
+  } else {
+    for ( usize j = 0; j < hash_batch_lanes; ++j ) {
+      u64 w = 0;
+      for ( usize b = lo; b < width; ++b ) w |= static_cast<u64>(p[j * width + b]) << (8 * (b - lo));
+      v[j] = w;
+    }
+  }
+  return v;
+}
+
+// zzz64 of one key, the words past words already folded into c
+inline u64
+__zzz_one(const u64 (&s)[4][4], u64 c, const byte *p, usize width, usize words) noexcept
+{
+  u64 h = c;
+  for ( usize l = 0; l < words; ++l ) {
+    u64 w = 0;
+    for ( usize b = 8 * l; b < width && b < 8 * l + 8; ++b ) w |= static_cast<u64>(p[b]) << (8 * (b - 8 * l));
+    h ^= hashes::__zzzs::__mix<0>(s[0][l] ^ w) ^ hashes::__zzzs::__mix<1>(s[1][l] ^ w) ^ hashes::__zzzs::__mix<2>(s[2][l] ^ w)
+         ^ hashes::__zzzs::__mix<3>(s[3][l] ^ w);
+  }
+  return h;
+}
+
+template<usize Words>
+inline void
+__zzz_run(const u64 (&s)[4][4], u64 c, const byte *p, usize width, usize n, hash64_t *__restrict out) noexcept
+{
+  usize i = 0;
+  for ( ; i + hash_batch_step <= n; i += hash_batch_step ) {
+    __vu h0 = __splat(c), h1 = h0;
+    for ( usize l = 0; l < Words; ++l ) {
+      const __vu w0 = __word(p + i * width, width, l);
+      const __vu w1 = __word(p + (i + hash_batch_lanes) * width, width, l);
+      const __vu s0 = __splat(s[0][l]), s1 = __splat(s[1][l]), s2 = __splat(s[2][l]), s3 = __splat(s[3][l]);
+      h0 ^= hashes::__zzzs::__mix<0>(s0 ^ w0) ^ hashes::__zzzs::__mix<1>(s1 ^ w0) ^ hashes::__zzzs::__mix<2>(s2 ^ w0)
+            ^ hashes::__zzzs::__mix<3>(s3 ^ w0);
+      h1 ^= hashes::__zzzs::__mix<0>(s0 ^ w1) ^ hashes::__zzzs::__mix<1>(s1 ^ w1) ^ hashes::__zzzs::__mix<2>(s2 ^ w1)
+            ^ hashes::__zzzs::__mix<3>(s3 ^ w1);
+    }
+    for ( usize j = 0; j < hash_batch_lanes; ++j ) {
+      out[i + j] = h0[j];
+      out[i + hash_batch_lanes + j] = h1[j];
+    }
+  }
+  for ( ; i < n; ++i ) out[i] = __zzz_one(s, c, p + i * width, width, Words);
+}
+
+inline void
+__zzz(const byte *p, usize width, usize n, hash64_t *__restrict out, u64 seed) noexcept
+{
+  const hashes::zzz_state st = hashes::zzz_init(static_cast<i64>(seed));
+  const usize words = (width + 7) / 8;
+  u64 c = 0;
+  if ( width == 0 ) {
+    // no block at all, the digest is the seeded iv
+    for ( u32 k = 0; k < 4; ++k )
+      for ( u32 l = 0; l < 4; ++l ) c ^= st.s[k][l];
+    for ( usize i = 0; i < n; ++i ) out[i] = c;
+    return;
+  }
+  for ( usize l = words; l < 4; ++l )
+    c ^= hashes::__zzzs::__mix<0>(st.s[0][l]) ^ hashes::__zzzs::__mix<1>(st.s[1][l]) ^ hashes::__zzzs::__mix<2>(st.s[2][l])
+         ^ hashes::__zzzs::__mix<3>(st.s[3][l]);
+  switch ( words ) {
+  case 1:
+    return __zzz_run<1>(st.s, c, p, width, n, out);
+  case 2:
+    return __zzz_run<2>(st.s, c, p, width, n, out);
+  case 3:
+    return __zzz_run<3>(st.s, c, p, width, n, out);
+  default:
+    return __zzz_run<4>(st.s, c, p, width, n, out);
+  }
+}
+
+// string keys bucketed per call
+constexpr usize __str_group = 64;
+
+// hash<hash64_t> of key_at(0) .. key_at(n - 1) into out, n <= __str_group. keys of up to 32 bytes are counted per length,
+// packed group by group into buf and each group hashed as one batch; longer keys go through hash<hash64_t> on their own
+template<typename K, typename At>
+inline void
+__strings(usize n, At &key_at, hash64_t *__restrict out)
+{
+  u16 cnt[34] = {};
+  u8 len[__str_group];
+  for ( usize j = 0; j < n; ++j ) {
+    const usize l = micron::string_len(key_at(j));
+    len[j] = static_cast<u8>(l > 32 ? 33 : l);
+    ++cnt[len[j]];
+  }
+  // group w starts at key koff[w] and byte boff[w]
+  u16 koff[33], boff[33], fill[33] = {};
+  for ( u16 w = 0, k = 0, b = 0; w <= 32; ++w ) {
+    koff[w] = k;
+    boff[w] = b;
+    k = static_cast<u16>(k + cnt[w]);
+    b = static_cast<u16>(b + cnt[w] * w);
+  }
+  byte buf[__str_group * 32];
+  u16 slot[__str_group];
+  for ( usize j = 0; j < n; ++j ) {
+    if ( len[j] > 32 ) {
+      out[j] = hash<hash64_t>(key_at(j));
+      continue;
+    }
+    const usize w = len[j];
+    const u16 s = fill[w]++;
+    slot[j] = static_cast<u16>(koff[w] + s);
+    const auto &key = key_at(j);
+    const byte *src = reinterpret_cast<const byte *>(key.cbegin());
+    for ( usize c = 0; c < w; ++c ) buf[boff[w] + s * w + c] = src[c];
+  }
+  hash64_t hs[__str_group];
+  for ( usize w = 0; w <= 32; ++w )
+    if ( cnt[w] ) __zzz(buf + boff[w], w, cnt[w], hs + koff[w], default_seed);
+  for ( usize j = 0; j < n; ++j )
+    if ( len[j] <= 32 ) out[j] = hs[slot[j]];
+}
+
+inline void
+__rapid(const byte *p, usize width, usize n, hash64_t *__restrict out, u64 seed) noexcept
+{
+  if ( width > 16 ) {
+    for ( usize i = 0; i < n; ++i ) out[i] = hashes::rapidhash(p + i * width, seed, width);
+    return;
+  }
+  // rapidhash_internal's seed setup, once for the batch
+  const u64 sd = seed ^ hashes::rapid_mix(seed ^ hashes::rapid_secret[2], hashes::rapid_secret[1]);
+  for ( usize i = 0; i < n; ++i ) {
+    u64 s = sd, a = 0, b = 0;
+    hashes::rapid_short(p + i * width, width, s, a, b);
+    out[i] = hashes::rapid_finalize(a, b, s, width, hashes::rapid_secret);
+  }
+}
+
+};      // namespace __hbatch
+
+inline void
+hash_batch(const byte *keys, usize width, usize n, hash64_t *__restrict out, u64 seed = default_seed) noexcept
+{
+#if defined(__micron_hash_zzz)
+  if constexpr ( default_hash_64 == hash_types::zzz ) {
+    if ( width <= 32 ) return __hbatch::__zzz(keys, width, n, out, seed);
+  }
+#endif
+  if constexpr ( default_hash_64 == hash_types::rapidhash ) {
+    return __hbatch::__rapid(keys, width, n, out, seed);
+  }
+  for ( usize i = 0; i < n; ++i ) out[i] = hash64(keys + i * width, width, seed);
+}
+
+template<typename K>
+inline void
+hash_batch(const K *keys, usize n, hash64_t *__restrict out, u64 seed) noexcept
+{
+  hash_batch(reinterpret_cast<const byte *>(keys), sizeof(K), n, out, seed);
+}
+
+template<typename K>
+inline void
+hash_batch(const K *keys, usize n, hash64_t *__restrict out)
+{
+  if constexpr ( hash_batchable<K> )
+    hash_batch(reinterpret_cast<const byte *>(keys), sizeof(K), n, out, default_seed);
+  else if constexpr ( hash_batchable_string<K> )
+    for ( usize base = 0; base < n; base += __hbatch::__str_group ) {
+      auto at = [&](usize j) -> const K & { return keys[base + j]; };
+      __hbatch::__strings<K>((n - base) < __hbatch::__str_group ? (n - base) : __hbatch::__str_group, at, out + base);
+    }
+  else
+    for ( usize i = 0; i < n; ++i ) out[i] = hash<hash64_t>(keys[i]);
+}
+
+// hash<hash64_t> of key_at(0) .. key_at(n - 1), put(i, h) in order; strided keys (pairs, sparse tables) are gathered
+// hash_batch_step at a time into the batch kernel, string keys __str_group at a time
+template<typename K, typename At, typename Put>
+inline void
+hash_each(usize n, At &&key_at, Put &&put)
+{
+  if constexpr ( hash_batchable<K> ) {
+    K ks[hash_batch_step];
+    hash64_t hs[hash_batch_step];
+    for ( usize base = 0; base < n; base += hash_batch_step ) {
+      const usize m = (n - base) < hash_batch_step ? (n - base) : hash_batch_step;
+      for ( usize j = 0; j < m; ++j ) ks[j] = key_at(base + j);
+      hash_batch(ks, m, hs);
+      for ( usize j = 0; j < m; ++j ) put(base + j, hs[j]);
+    }
+  } else if constexpr ( hash_batchable_string<K> ) {
+    hash64_t hs[__hbatch::__str_group];
+    for ( usize base = 0; base < n; base += __hbatch::__str_group ) {
+      const usize m = (n - base) < __hbatch::__str_group ? (n - base) : __hbatch::__str_group;
+      auto at = [&](usize j) -> decltype(auto) { return key_at(base + j); };
+      __hbatch::__strings<K>(m, at, hs);
+      for ( usize j = 0; j < m; ++j ) put(base + j, hs[j]);
+    }
+  } else {
+    for ( usize i = 0; i < n; ++i ) put(i, hash<hash64_t>(key_at(i)));
+  }
+}
+
+};      // namespace micron
@@ -74,6 +74,17 @@ constexpr auto crc32_iscsi_lut = []() {
   return t;
 }();
 
+// slice-by-8 extension of crc32_iscsi_lut
+constexpr auto crc32_iscsi_slice8_lut = []() {
+  struct __table {
+    u32 data[8][256]{};
+  } t;
+  for ( u32 i = 0; i < 256u; ++i ) t.data[0][i] = crc32_iscsi_lut.data[i];
+  for ( u32 k = 1; k < 8u; ++k )
+    for ( u32 i = 0; i < 256u; ++i ) t.data[k][i] = (t.data[k - 1][i] >> 8) ^ t.data[0][t.data[k - 1][i] & 0xFFu];
+  return t;
+}();
+
 constexpr auto crc64_ecma_norm_lut = []() {
   struct __table {
     u64 data[256]{};
@@ -179,10 +190,10 @@ __crc32_refl_bytewise(const u8 *p, usize len, u32 r) noexcept
   return r;
 }
 
+// t[0] is the bytewise table
 constexpr u32
-__crc32_refl_slice8(const u8 *p, usize len, u32 r) noexcept
+__refl32_slice8(const u8 *p, usize len, u32 r, const u32 (&t)[8][256]) noexcept
 {
-  const auto &t = crc32_gzip_refl_slice8_lut.data;
   while ( len >= 8 ) {
     const u32 a = hashes::__load32(p) ^ r;
     const u32 b = hashes::__load32(p + 4);
@@ -191,10 +202,86 @@ __crc32_refl_slice8(const u8 *p, usize len, u32 r) noexcept
     p += 8;
     len -= 8;
   }
-  while ( len-- ) r = (r >> 8) ^ crc32_gzip_refl_lut.data[(r ^ *p++) & 0xFFu];
+  while ( len-- ) r = (r >> 8) ^ t[0][(r ^ *p++) & 0xFFu];
+  return r;
+}
+
+constexpr u32
+__crc32_refl_slice8(const u8 *p, usize len, u32 r) noexcept
+{
+  return __refl32_slice8(p, len, r, crc32_gzip_refl_slice8_lut.data);
+}
+
+constexpr u32
+__crc32c_bytewise(const u8 *p, usize len, u32 r) noexcept
+{
+  for ( usize i = 0; i < len; ++i ) r = (r >> 8) ^ crc32_iscsi_lut.data[(r ^ p[i]) & 0xFFu];
+  return r;
+}
+
+constexpr u32
+__crc32c_slice8(const u8 *p, usize len, u32 r) noexcept
+{
+  return __refl32_slice8(p, len, r, crc32_iscsi_slice8_lut.data);
+}
+
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+// GF(2) arithmetic mod P, for shifting a crc register past zero bytes
+//
+// feeding n zero bytes through a crc register multiplies it by x^(8n) mod P. reflected registers hold x^0 in the top
+// bit, normal ones in bit 0; Poly is the constant the matching lut was built with
+
+template<typename T, T Poly, bool Refl>
+constexpr T
+__mulmod(T a, T b) noexcept
+{
+  constexpr u32 w = sizeof(T) * 8;
+  T p = 0;
+  if constexpr ( Refl ) {
+    for ( u32 i = 0; i < w; ++i ) {
+      p ^= static_cast<T>(b & static_cast<T>(0 - static_cast<T>((a >> (w - 1 - i)) & 1u)));
+      b = static_cast<T>((b >> 1) ^ (Poly & static_cast<T>(0 - static_cast<T>(b & 1u))));
+    }
+  } else {
+    for ( u32 i = w; i-- > 0; ) {
+      p = static_cast<T>((p << 1) ^ (Poly & static_cast<T>(0 - static_cast<T>(p >> (w - 1)))));
+      p ^= static_cast<T>(b & static_cast<T>(0 - static_cast<T>((a >> i) & 1u)));
+    }
+  }
+  return p;
+}
+
+// x^(8 * 2^k) mod P
+template<typename T, T Poly, bool Refl>
+constexpr auto __x8_pow2 = []() {
+  constexpr u32 w = sizeof(T) * 8;
+  struct __table {
+    T data[64]{};
+  } t;
+  t.data[0] = Refl ? static_cast<T>(T(1) << (w - 9)) : static_cast<T>(T(1) << 8);
+  for ( u32 k = 1; k < 64u; ++k ) t.data[k] = __mulmod<T, Poly, Refl>(t.data[k - 1], t.data[k - 1]);
+  return t;
+}();
+
+// x^(8n) mod P
+template<typename T, T Poly, bool Refl>
+constexpr T
+__x8n(u64 n) noexcept
+{
+  T r = Refl ? static_cast<T>(T(1) << (sizeof(T) * 8 - 1)) : T(1);
+  for ( u32 k = 0; n; ++k, n >>= 1 )
+    if ( n & 1u ) r = __mulmod<T, Poly, Refl>(r, __x8_pow2<T, Poly, Refl>.data[k]);
   return r;
 }
 
+// the register after n more zero bytes
+template<typename T, T Poly, bool Refl>
+constexpr T
+__shift(T r, u64 n) noexcept
+{
+  return __mulmod<T, Poly, Refl>(r, __x8n<T, Poly, Refl>(n));
+}
+
 };      // namespace crc
 
 };      // namespace micron
@@ -202,7 +289,8 @@ __crc32_refl_slice8(const u8 *p, usize len, u32 r) noexcept
 // we're pulling this in like this because i don't want to refactor and pull crc out to crc_scalar|crc_lut right now
 // TODO: make crc a master include header and split the above and below code into separate headers to resolve the include spaghetti
 
-// crc_simd depends on the tables above
+// crc_simd and crc_hw depend on the tables above
+#include "crc_hw.hpp"
 #include "crc_simd.hpp"
 
 namespace micron
@@ -280,9 +368,12 @@ crc32_gzip_refl(u32 init_crc, const T &obj) noexcept
 constexpr u32
 crc32_iscsi(u32 init_crc, const u8 *buf, usize len) noexcept
 {
-  u32 crc = init_crc ^ 0xFFFFFFFFu;
-  for ( usize i = 0; i < len; ++i ) crc = (crc >> 8) ^ crc::crc32_iscsi_lut.data[(crc ^ buf[i]) & 0xFFu];
-  return crc ^ 0xFFFFFFFFu;
+#if defined(__micron_crc32c_hw)
+  if !consteval {
+    if ( crc::__hw::__have() ) return crc::__hw::__crc32c(init_crc ^ 0xFFFFFFFFu, buf, len) ^ 0xFFFFFFFFu;
+  }
+#endif
+  return crc::__crc32c_slice8(buf, len, init_crc ^ 0xFFFFFFFFu) ^ 0xFFFFFFFFu;
 }
 
 template<is_iterable C>
@@ -299,6 +390,33 @@ crc32_iscsi(u32 init_crc, const T &obj) noexcept
   return crc32_iscsi(init_crc, reinterpret_cast<const u8 *>(&obj), sizeof(T));
 }
 
+// out[i] = crc32_iscsi(0, bufs[i], lens[i]); with the crc32 instruction three buffers run interleaved, so a batch of
+// small blocks doesn't pay its latency block by block
+inline void
+crc32_iscsi_multi(const u8 *const *bufs, const usize *lens, usize n, u32 *out) noexcept
+{
+#if defined(__micron_crc32c_hw)
+  if ( crc::__hw::__have() ) {
+    crc::__hw::__multi(n, [&](usize i) { return bufs[i]; }, [&](usize i) { return lens[i]; }, out);
+    return;
+  }
+#endif
+  for ( usize i = 0; i < n; ++i ) out[i] = crc32_iscsi(0, bufs[i], lens[i]);
+}
+
+// n contiguous blocks of block bytes each, out[i] = crc32_iscsi(0, base + i * block, block)
+inline void
+crc32_iscsi_blocks(const u8 *base, usize block, usize n, u32 *out) noexcept
+{
+#if defined(__micron_crc32c_hw)
+  if ( crc::__hw::__have() ) {
+    crc::__hw::__multi(n, [&](usize i) { return base + i * block; }, [&](usize) { return block; }, out);
+    return;
+  }
+#endif
+  for ( usize i = 0; i < n; ++i ) out[i] = crc32_iscsi(0, base + i * block, block);
+}
+
 constexpr u64
 crc64_ecma_norm(u64 init_crc, const u8 *buf, usize len) noexcept
 {
@@ -499,6 +617,86 @@ crc64_rocksoft_refl(u64 init_crc, const T &obj) noexcept
   return crc64_rocksoft_refl(init_crc, reinterpret_cast<const u8 *>(&obj), sizeof(T));
 }
 
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+// crc of a concatenation
+//
+//   crc_combine<K>(crcK(0, A), crcK(0, B), |B|) == crcK(0, A || B)
+//
+// without touching A or B again; crc_a may also have started from any init, the result is then crcK(init, A || B). the
+// pre/post inversions of gzip and iscsi cancel out, every polynomial combines the same way
+
+enum class crc_types {
+  crc16_t10dif,
+  crc32_ieee,
+  crc32_gzip_refl,
+  crc32_iscsi,
+  crc64_ecma_norm,
+  crc64_ecma_refl,
+  crc64_iso_norm,
+  crc64_iso_refl,
+  crc64_jones_norm,
+  crc64_jones_refl,
+  crc64_rocksoft_norm,
+  crc64_rocksoft_refl
+};
+
+namespace crc
+{
+
+template<typename T, T Poly, bool Refl> struct __poly_of {
+  using type = T;
+  static constexpr T poly = Poly;
+  static constexpr bool refl = Refl;
+};
+
+template<crc_types K> struct __traits;
+
+template<> struct __traits<crc_types::crc16_t10dif> : __poly_of<u16, 0x8BB7u, false> {
+};
+
+template<> struct __traits<crc_types::crc32_ieee> : __poly_of<u32, 0x04C11DB7u, false> {
+};
+
+template<> struct __traits<crc_types::crc32_gzip_refl> : __poly_of<u32, 0xEDB88320u, true> {
+};
+
+template<> struct __traits<crc_types::crc32_iscsi> : __poly_of<u32, 0x82F63B78u, true> {
+};
+
+template<> struct __traits<crc_types::crc64_ecma_norm> : __poly_of<u64, 0x42F0E1EBA9EA3693ull, false> {
+};
+
+template<> struct __traits<crc_types::crc64_ecma_refl> : __poly_of<u64, 0xC96C5795D7870F42ull, true> {
+};
+
+template<> struct __traits<crc_types::crc64_iso_norm> : __poly_of<u64, 0x000000000000001Bull, false> {
+};
+
+template<> struct __traits<crc_types::crc64_iso_refl> : __poly_of<u64, 0xD800000000000000ull, true> {
+};
+
+template<> struct __traits<crc_types::crc64_jones_norm> : __poly_of<u64, 0x95AC9329AC4BC9B5ull, false> {
+};
+
+template<> struct __traits<crc_types::crc64_jones_refl> : __poly_of<u64, 0xAD93D23594C935A9ull, true> {
+};
+
+template<> struct __traits<crc_types::crc64_rocksoft_norm> : __poly_of<u64, 0x6B2B957C8AF67BE0ull, false> {
+};
+
+template<> struct __traits<crc_types::crc64_rocksoft_refl> : __poly_of<u64, 0x07D5B24186574BDBull, true> {
+};
+
+};      // namespace crc
+
+template<crc_types K>
+constexpr typename crc::__traits<K>::type
+crc_combine(typename crc::__traits<K>::type crc_a, typename crc::__traits<K>::type crc_b, u64 len_b) noexcept
+{
+  using __t = crc::__traits<K>;
+  return static_cast<typename __t::type>(crc::__shift<typename __t::type, __t::poly, __t::refl>(crc_a, len_b) ^ crc_b);
+}
+
 using crc_t = u64;
 
 };      // namespace micron
@@ -0,0 +1,168 @@
+//  Copyright (c) 2024- David Lucius Severus
+//
+//  Distributed under the Boost Software License, Version 1.0.
+//  See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt
+#pragma once
+
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+// crc32 instruction CRC32C (castagnoli, crc32_iscsi)
+//
+// WARNING: crc_hw depends on crc.hpps tables and shift math, it will not compile without them
+
+#include "../bits/__arch.hpp"
+#include "../types.hpp"
+
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+// crc_hw code
+//  .. __micron_crc32c_hw     sse4.2 crc32 on x86, the crc extension on armv8
+//  .. __micron_crc32c_hw_rt  x86 build without sse4.2, the kernels are gated by __have()
+//
+// the instruction retires one 8-byte step a cycle but has three cycles of latency, so one running register is latency
+// bound at a third of that. a long buffer is cut into three equal streams crc'd interleaved, the first two registers
+// are shifted past the streams after them (multiplied by x^(8n) mod P) and xored together. independent buffers need no
+// shift at all and simply run three at a time
+//
+// on x86 the kernels carry target("sse4.2") and are always built; unless the build itself has sse4.2 (no check then),
+// __have() picks them at runtime off cpuid leaf 1, probed once. on arm the crc extension stays a compile-time choice
+#if defined(__micron_arch_x86_any)
+#define __micron_crc32c_hw 1
+#if !defined(__micron_x86_sse4_2)
+#define __micron_crc32c_hw_rt 1
+#include "../atomic/intrin.hpp"
+#include "../bits/__cpuid.hpp"
+#endif
+#include "../simd/__bits/__sse4_2.hpp"
+#define __crc_hw_fn [[gnu::target("sse4.2")]] static inline
+#define __crc_hw_ai [[gnu::always_inline, gnu::target("sse4.2")]] static inline
+#elif (defined(__micron_arch_arm64) || defined(__micron_arch_arm32)) && defined(__micron_arm_crc32)
+#define __micron_crc32c_hw 1
+#include "../simd/__bits/__neon_crc32.hpp"
+#define __crc_hw_fn static inline
+#define __crc_hw_ai [[gnu::always_inline]] static inline
+#endif
+
+namespace micron
+{
+namespace crc
+{
+namespace __hw
+{
+
+#if defined(__micron_crc32c_hw)
+
+constexpr u32 __poly = 0x82F63B78u;
+
+// stream lengths of one interleaved round; 3 x 1344 = 4032, a 4 KiB block is one long round and 64 bytes
+constexpr usize __long = 1344;
+constexpr usize __short = 128;
+
+template<usize N> constexpr u32 __k = __x8n<u32, __poly, true>(N);
+
+__crc_hw_ai u32
+__c8(u32 r, u64 w) noexcept
+{
+#if defined(__micron_arch_x86_any) && defined(__micron_arch_width_64)
+  return static_cast<u32>(simd::__bits::_mm_crc32_u64(r, w));
+#elif defined(__micron_arch_x86_any)
+  return simd::__bits::_mm_crc32_u32(simd::__bits::_mm_crc32_u32(r, static_cast<u32>(w)), static_cast<u32>(w >> 32));
+#else
+  return simd::__bits::__crc32cd(r, w);
+#endif
+}
+
+__crc_hw_ai u32
+__c1(u32 r, u8 b) noexcept
+{
+#if defined(__micron_arch_x86_any)
+  return simd::__bits::_mm_crc32_u8(r, b);
+#else
+  return simd::__bits::__crc32cb(r, b);
+#endif
+}
+
+// one register, no interleave
+__crc_hw_fn u32
+__run(u32 r, const u8 *p, usize len) noexcept
+{
+  for ( ; len >= 8; p += 8, len -= 8 ) r = __c8(r, hashes::__load64(p));
+  while ( len-- ) r = __c1(r, *p++);
+  return r;
+}
+
+// 3 * L bytes as three interleaved streams, recombined
+template<usize L>
+__crc_hw_ai u32
+__round3(u32 r, const u8 *p) noexcept
+{
+  u32 b = 0, c = 0;
+  for ( usize i = 0; i < L; i += 8 ) {
+    r = __c8(r, hashes::__load64(p + i));
+    b = __c8(b, hashes::__load64(p + L + i));
+    c = __c8(c, hashes::__load64(p + 2 * L + i));
+  }
+  return __mulmod<u32, __poly, true>(r, __k<2 * L>) ^ __mulmod<u32, __poly, true>(b, __k<L>) ^ c;
+}
+
+// raw register in, raw register out; the caller does the inversions
+__crc_hw_fn u32
+__crc32c(u32 r, const u8 *p, usize len) noexcept
+{
+  for ( ; len >= 3 * __long; p += 3 * __long, len -= 3 * __long ) r = __round3<__long>(r, p);
+  for ( ; len >= 3 * __short; p += 3 * __short, len -= 3 * __short ) r = __round3<__short>(r, p);
+  return __run(r, p, len);
+}
+
+// crc32_iscsi(0, ...) of n buffers, three at a time in lockstep over their common 8-byte prefix; ptr(i) and len(i)
+// describe buffer i
+template<typename Ptr, typename Len>
+__crc_hw_fn void
+__multi(usize n, Ptr &&ptr, Len &&len, u32 *out) noexcept
+{
+  usize i = 0;
+  for ( ; i + 3 <= n; i += 3 ) {
+    const u8 *pa = ptr(i), *pb = ptr(i + 1), *pc = ptr(i + 2);
+    const usize la = len(i), lb = len(i + 1), lc = len(i + 2);
+    usize m = la < lb ? la : lb;
+    m = (m < lc ? m : lc) & ~usize{ 7 };
+    u32 a = 0xFFFFFFFFu, b = 0xFFFFFFFFu, c = 0xFFFFFFFFu;
+    for ( usize k = 0; k < m; k += 8 ) {
+      a = __c8(a, hashes::__load64(pa + k));
+      b = __c8(b, hashes::__load64(pb + k));
+      c = __c8(c, hashes::__load64(pc + k));
+    }
+    out[i] = __crc32c(a, pa + m, la - m) ^ 0xFFFFFFFFu;
+    out[i + 1] = __crc32c(b, pb + m, lb - m) ^ 0xFFFFFFFFu;
+    out[i + 2] = __crc32c(c, pc + m, lc - m) ^ 0xFFFFFFFFu;
+  }
+  for ( ; i < n; ++i ) out[i] = __crc32c(0xFFFFFFFFu, ptr(i), len(i)) ^ 0xFFFFFFFFu;
+}
+
+#if defined(__micron_crc32c_hw_rt)
+inline u32 __state = 0;      // 0 unprobed, 1 no sse4.2, 2 sse4.2
+#endif
+
+// the crc32 instruction is there to run
+[[gnu::always_inline]] inline bool
+__have(void) noexcept
+{
+#if defined(__micron_crc32c_hw_rt)
+  u32 v = atom::load(&__state, __ATOMIC_RELAXED);
+  if ( v == 0 ) [[unlikely]] {
+    v = ((__cpuid_read(1u).ecx >> 20) & 1u) ? 2u : 1u;
+    atom::store(&__state, v, __ATOMIC_RELAXED);
+  }
+  return v == 2u;
+#else
+  return true;
+#endif
+}
+
+#undef __crc_hw_fn
+#undef __crc_hw_ai
+
+#endif
+
+};      // namespace __hw
+};      // namespace crc
+};      // namespace micron
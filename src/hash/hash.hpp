@@ -16,6 +16,7 @@
 #include "murmur.hpp"
 #include "rapidhash.hpp"
 #include "xx.hpp"
+#include "zzz_stream.hpp"
 
 // NOTE: zzz using intrinsics directly, so we need a direct port
 #if defined(__micron_arch_x86_any)
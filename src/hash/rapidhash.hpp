@@ -295,5 +295,117 @@ rapidhash_nano(const byte *key, u64 seed, usize len) noexcept
   return rapidhash_nano_internal(key, len, seed, rapid_secret);
 }
 
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+// streaming rapidhash
+//
+// rapidhash_init / update / digest, equal to rapidhash(key, seed, len) over the concatenation of every update. the
+// one-shot loop eats 112-byte blocks while more than 112 bytes are left and its tail reads up to 16 bytes back into
+// the last block, so the state holds back a whole block until more input shows up and keeps the 16 bytes before the
+// pending ones at the front of buf. a plain value, copy it to fork a prefix
+
+struct rapidhash_state {
+  u64 seed;
+  u64 see[6];
+  u64 total;
+  u32 pend;           // bytes at buf + 16
+  u32 blocks;         // a 112-byte block ran, the see lanes fold in at digest
+  u8 buf[16 + 112];
+};
+
+inline rapidhash_state
+rapidhash_init(u64 seed) noexcept
+{
+  rapidhash_state s{};
+  s.seed = seed ^ rapid_mix(seed ^ rapid_secret[2], rapid_secret[1]);
+  for ( u32 k = 0; k < 6; ++k ) s.see[k] = s.seed;
+  return s;
+}
+
+inline __attribute__((always_inline)) void
+__rapid_block(rapidhash_state &s, const u8 *p) noexcept
+{
+  const u64 *secret = rapid_secret;
+  s.seed = rapid_mix(rapid_read64(p) ^ secret[0], rapid_read64(p + 8) ^ s.seed);
+  s.see[0] = rapid_mix(rapid_read64(p + 16) ^ secret[1], rapid_read64(p + 24) ^ s.see[0]);
+  s.see[1] = rapid_mix(rapid_read64(p + 32) ^ secret[2], rapid_read64(p + 40) ^ s.see[1]);
+  s.see[2] = rapid_mix(rapid_read64(p + 48) ^ secret[3], rapid_read64(p + 56) ^ s.see[2]);
+  s.see[3] = rapid_mix(rapid_read64(p + 64) ^ secret[4], rapid_read64(p + 72) ^ s.see[3]);
+  s.see[4] = rapid_mix(rapid_read64(p + 80) ^ secret[5], rapid_read64(p + 88) ^ s.see[4]);
+  s.see[5] = rapid_mix(rapid_read64(p + 96) ^ secret[6], rapid_read64(p + 104) ^ s.see[5]);
+  s.blocks = 1;
+}
+
+inline void
+rapidhash_update(rapidhash_state &s, const byte *key, usize len) noexcept
+{
+  const u8 *p = key;
+  s.total += len;
+  if ( s.pend ) {
+    const usize take = 112u - s.pend < len ? 112u - s.pend : len;
+    micron::bytecpy(s.buf + 16 + s.pend, p, take);
+    s.pend += static_cast<u32>(take);
+    p += take;
+    len -= take;
+    // a full block only runs once a byte past it exists
+    if ( len == 0 ) return;
+    __rapid_block(s, s.buf + 16);
+    micron::bytecpy(s.buf, s.buf + 112, 16);
+    s.pend = 0;
+  }
+  if ( len > 112 ) {
+    do {
+      __rapid_block(s, p);
+      p += 112;
+      len -= 112;
+    } while ( len > 112 );
+    micron::bytecpy(s.buf, p - 16, 16);
+  }
+  micron::bytecpy(s.buf + 16, p, len);
+  s.pend = static_cast<u32>(len);
+}
+
+// leaves the state untouched, more input may follow
+inline u64
+rapidhash_digest(const rapidhash_state &s) noexcept
+{
+  const u64 *secret = rapid_secret;
+  const u8 *p = s.buf + 16;
+  u64 seed = s.seed, a = 0, b = 0;
+  usize i = s.pend;
+  if ( s.total <= 16 ) {
+    rapid_short(p, i, seed, a, b);
+    return rapid_finalize(a, b, seed, i, secret);
+  }
+  if ( s.blocks ) {
+    u64 see2 = s.see[1], see4 = s.see[3];
+    seed ^= s.see[0];
+    see2 ^= s.see[2];
+    see4 ^= s.see[4];
+    seed ^= s.see[5];
+    see2 ^= see4;
+    seed ^= see2;
+  }
+  if ( i > 16 ) {
+    seed = rapid_mix(rapid_read64(p) ^ secret[2], rapid_read64(p + 8) ^ seed);
+    if ( i > 32 ) {
+      seed = rapid_mix(rapid_read64(p + 16) ^ secret[2], rapid_read64(p + 24) ^ seed);
+      if ( i > 48 ) {
+        seed = rapid_mix(rapid_read64(p + 32) ^ secret[1], rapid_read64(p + 40) ^ seed);
+        if ( i > 64 ) {
+          seed = rapid_mix(rapid_read64(p + 48) ^ secret[1], rapid_read64(p + 56) ^ seed);
+          if ( i > 80 ) {
+            seed = rapid_mix(rapid_read64(p + 64) ^ secret[2], rapid_read64(p + 72) ^ seed);
+            if ( i > 96 ) seed = rapid_mix(rapid_read64(p + 80) ^ secret[1], rapid_read64(p + 88) ^ seed);
+          }
+        }
+      }
+    }
+  }
+  // after a block the tail may be shorter than 16, the bytes before it sit in buf[0, 16)
+  a = rapid_read64(p + i - 16) ^ i;
+  b = rapid_read64(p + i - 8);
+  return rapid_finalize(a, b, seed, i, secret);
+}
+
 };      // namespace hashes
 };      // namespace micron
@@ -0,0 +1,145 @@
+//  Copyright (c) 2024- David Lucius Severus
+//
+//  Distributed under the Boost Software License, Version 1.0.
+//  See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt
+#pragma once
+
+#include "../types.hpp"
+#include "hash.hpp"
+
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+// tree hashing of large buffers
+//
+// the input is cut into fixed chunks (hash_tree_chunk bytes unless the caller says otherwise), every chunk is a leaf
+// hashed one-shot at the seed, and the root is the same hash streamed over the leaf digests (8 little-endian bytes
+// each) at seed ^ len. the leaves are independent, tree_mt.hpp runs them on the coroutine engine and folds the same
+// root, so the digest depends on the chunk size only, never on the worker count
+//
+// an input of at most one chunk is its plain hash: tree_hash<H>(p, n, seed) == H(p, n, seed) for n <= chunk. past
+// that it is a different function from the flat hash, checksums written with one must be verified with the same chunk
+//
+//   xxhash64, rapidhash   everywhere
+//   zzz                   where the one-shot zzz exists (__micron_hash_zzz)
+
+namespace micron
+{
+
+constexpr usize hash_tree_chunk = 1u << 20;
+
+template<hash_types H>
+constexpr bool tree_hashable = H == hash_types::xxhash64 || H == hash_types::rapidhash
+#if defined(__micron_hash_zzz)
+                               || H == hash_types::zzz
+#endif
+    ;
+
+namespace __tree
+{
+
+template<hash_types H>
+inline u64
+__leaf(const byte *p, usize n, u64 seed) noexcept
+{
+  if constexpr ( H == hash_types::xxhash64 ) return hashes::xxhash64_rtseed(p, seed, n);
+  if constexpr ( H == hash_types::rapidhash ) return hashes::rapidhash(p, seed, n);
+#if defined(__micron_hash_zzz)
+  if constexpr ( H == hash_types::zzz ) return hashes::zzz64(p, static_cast<i64>(seed), n);
+#endif
+  return 0;
+}
+
+// the root, fed one leaf digest at a time
+template<hash_types H> struct __root;
+
+template<> struct __root<hash_types::xxhash64> {
+  hashes::xstate s;
+
+  explicit __root(u64 seed) noexcept : s(hashes::xxhash64_init(seed)) {}
+
+  void
+  update(const byte *p, usize n) noexcept
+  {
+    hashes::xxhash64_update(s, p, n);
+  }
+
+  u64
+  digest() const noexcept
+  {
+    return hashes::xxhash64_digest(s);
+  }
+};
+
+template<> struct __root<hash_types::rapidhash> {
+  hashes::rapidhash_state s;
+
+  explicit __root(u64 seed) noexcept : s(hashes::rapidhash_init(seed)) {}
+
+  void
+  update(const byte *p, usize n) noexcept
+  {
+    hashes::rapidhash_update(s, p, n);
+  }
+
+  u64
+  digest() const noexcept
+  {
+    return hashes::rapidhash_digest(s);
+  }
+};
+
+#if defined(__micron_hash_zzz)
+template<> struct __root<hash_types::zzz> {
+  hashes::zzz_state s;
+
+  explicit __root(u64 seed) noexcept : s(hashes::zzz_init(static_cast<i64>(seed))) {}
+
+  void
+  update(const byte *p, usize n) noexcept
+  {
+    hashes::zzz_update(s, p, n);
+  }
+
+  u64
+  digest() const noexcept
+  {
+    return hashes::zzz64_digest(s);
+  }
+};
+#endif
+
+template<hash_types H>
+inline void
+__push(__root<H> &r, u64 d) noexcept
+{
+  byte b[8];
+  for ( u32 i = 0; i < 8; ++i ) b[i] = static_cast<byte>(d >> (8 * i));
+  r.update(b, 8);
+}
+
+};      // namespace __tree
+
+// leaves of a len-byte input, 0 when it is hashed flat
+[[nodiscard]] constexpr usize
+tree_hash_leaves(usize len, usize chunk = hash_tree_chunk) noexcept
+{
+  if ( chunk == 0 ) chunk = hash_tree_chunk;
+  return len <= chunk ? 0 : (len + chunk - 1) / chunk;
+}
+
+template<hash_types H = default_hash_64>
+  requires(tree_hashable<H>)
+inline u64
+tree_hash(const byte *src, usize len, u64 seed = default_seed, usize chunk = hash_tree_chunk) noexcept
+{
+  if ( chunk == 0 ) chunk = hash_tree_chunk;
+  if ( len <= chunk ) return __tree::__leaf<H>(src, len, seed);
+  __tree::__root<H> r(seed ^ static_cast<u64>(len));
+  for ( usize off = 0; off < len; off += chunk ) {
+    const usize n = len - off < chunk ? len - off : chunk;
+    __tree::__push<H>(r, __tree::__leaf<H>(src + off, n, seed));
+  }
+  return r.digest();
+}
+
+};      // namespace micron
@@ -0,0 +1,58 @@
+//  Copyright (c) 2024- David Lucius Severus
+//
+//  Distributed under the Boost Software License, Version 1.0.
+//  See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt
+#pragma once
+
+#include "../bits/__abc_mt.hpp"      // autofires MICRON_ABC_MT; must precede abcmalloc
+
+#include "../parallel/engine.hpp"
+#include "../types.hpp"
+#include "../vector/vector.hpp"
+#include "tree.hpp"
+
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+// tree_hash on the coroutine engine
+//
+// every leaf is one task writing its digest to its own slot, the root is then folded on the calling thread in leaf
+// order, exactly as tree_hash does it, so tree_hash_mt == tree_hash for any worker count
+//
+// NOTE: tree_hash_mt sync_waits on the engine, never call it from inside a task; co_await tree_hash_task there
+
+namespace micron
+{
+
+template<hash_types H = default_hash_64>
+  requires(tree_hashable<H>)
+inline micron::task<u64>
+tree_hash_task(const byte *src, usize len, u64 seed = default_seed, usize chunk = hash_tree_chunk)
+{
+  if ( chunk == 0 ) chunk = hash_tree_chunk;
+  const usize k = tree_hash_leaves(len, chunk);
+  if ( k == 0 ) co_return __tree::__leaf<H>(src, len, seed);
+
+  micron::vector<u64> dig(k, 0);
+  u64 *dp = dig.data();
+  auto body = [=](usize i) {
+    const usize off = i * chunk;
+    const usize n = len - off < chunk ? len - off : chunk;
+    dp[i] = __tree::__leaf<H>(src + off, n, seed);
+  };
+  co_await parallel::__pblocks<decltype(body)>(0, k, body, 1);
+
+  __tree::__root<H> r(seed ^ static_cast<u64>(len));
+  for ( usize i = 0; i < k; ++i ) __tree::__push<H>(r, dp[i]);
+  co_return r.digest();
+}
+
+// multithreaded tree_hash; blocks until done, call from outside the engine
+template<hash_types H = default_hash_64>
+  requires(tree_hashable<H>)
+inline u64
+tree_hash_mt(const byte *src, usize len, u64 seed = default_seed, usize chunk = hash_tree_chunk)
+{
+  return micron::coro::sync_wait(tree_hash_task<H>(src, len, seed, chunk));
+}
+
+};      // namespace micron
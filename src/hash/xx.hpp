@@ -46,7 +46,7 @@ template<u64 seed>
 inline xstate
 init_seed()
 {
-  struct xxhash64_state s;
+  struct xxhash64_state s{};
   s.v[0] = seed + xxprime64a + xxprime64b;
   s.v[1] = seed + xxprime64b;
   s.v[2] = seed;
@@ -232,6 +232,72 @@ xxhash64_rtseed(const byte *src, u64 seed, usize len)
   xxhash += len;
   return xxhash_final(xxhash, src, len);
 }
+
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+// streaming xxhash64
+//
+// init / update / digest over an xstate, the input fed in any number of pieces of any size; digest equals
+// xxhash64_rtseed over the concatenation. the state is a plain value: no locks, no allocation, copy it to fork a
+// prefix. update buffers at most one 32-byte stripe in mem64, every whole stripe runs straight off the caller's bytes
+
+inline xstate
+xxhash64_init(u64 seed) noexcept
+{
+  xstate s{};
+  s.v[0] = seed + xxprime64a + xxprime64b;
+  s.v[1] = seed + xxprime64b;
+  s.v[2] = seed;
+  s.v[3] = seed - xxprime64a;
+  return s;
+}
+
+inline __attribute__((always_inline)) void
+__xxstripe(u64 (&v)[4], const byte *p) noexcept
+{
+  v[0] = xxround(v[0], __load64(p));
+  v[1] = xxround(v[1], __load64(p + 8));
+  v[2] = xxround(v[2], __load64(p + 16));
+  v[3] = xxround(v[3], __load64(p + 24));
+}
+
+inline void
+xxhash64_update(xstate &s, const byte *src, usize len) noexcept
+{
+  s.len += len;
+  byte *mem = reinterpret_cast<byte *>(s.mem64);
+  if ( s.memsize + len < 32 ) {
+    micron::bytecpy(mem + s.memsize, src, len);
+    s.memsize += static_cast<u32>(len);
+    return;
+  }
+  if ( s.memsize ) {
+    const usize take = 32 - s.memsize;
+    micron::bytecpy(mem + s.memsize, src, take);
+    __xxstripe(s.v, mem);
+    src += take;
+    len -= take;
+    s.memsize = 0;
+  }
+  for ( ; len >= 32; src += 32, len -= 32 ) __xxstripe(s.v, src);
+  micron::bytecpy(mem, src, len);
+  s.memsize = static_cast<u32>(len);
+}
+
+// leaves the state untouched, more input may follow
+inline u64
+xxhash64_digest(const xstate &s) noexcept
+{
+  u64 xxhash = 0;
+  if ( s.len >= 32 ) {
+    u64 v[4] = { s.v[0], s.v[1], s.v[2], s.v[3] };
+    xxhash = xxmergeround(v);
+  } else {
+    // v[2] still holds the seed
+    xxhash = s.v[2] + xxprime64e;
+  }
+  xxhash += s.len;
+  return xxhash_final(xxhash, reinterpret_cast<const byte *>(s.mem64), s.memsize);
+}
 };      // namespace hashes
 
 };      // namespace micron
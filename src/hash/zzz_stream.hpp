@@ -0,0 +1,146 @@
+//  Copyright (c) 2024- David Lucius Severus
+//
+//  Distributed under the Boost Software License, Version 1.0.
+//  See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt
+#pragma once
+
+#include "../types.hpp"
+#include "../tuple.hpp"
+#include "__load.hpp"
+
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+// streaming zzz
+//
+// zzz_init / zzz_update / zzz_digest, equal to zzz(data, seed, sz, out) over the concatenation of every update, and
+// zzz64_digest / zzz128_digest to zzz64 / zzz128. zzz has no length word and no cross-lane step past the IV, every
+// 32-byte block goes through the same four lane mixes, so a whole block runs as soon as it is complete and only the
+// last partial one waits in buf to be zero padded at digest
+//
+// written on plain u64 lanes, the compiler packs them back into ymm / q registers; the avx2 and neon zzz agree with
+// it bit for bit, so one state works on both. a plain value, copy it to fork a prefix
+//
+// NOTE: only zzz, the one-shot zz / z / zzzf have no streaming form
+
+namespace micron
+{
+namespace hashes
+{
+
+struct zzz_state {
+  u64 s[4][4];
+  u8 buf[32];
+  u64 len;
+  u32 pend;
+  u32 pad32;
+};
+
+namespace __zzzs
+{
+
+// iv64_0 .. iv64_3 of zzz.hpp / zzz_arm.hpp, which only exist where the one-shot zzz does
+constexpr u64 __iv[4] = { 0xf915d937b85e8f7full, 0xfd0be32fbf539b76ull, 0xf718d63ab65b9378ull, 0xff09e52cc1509e73ull };
+
+// the four state mixes, on one u64 lane or on a vector of them (batch.hpp)
+template<u32 K, typename T>
+inline __attribute__((always_inline)) T
+__mix(T n) noexcept
+{
+  if constexpr ( K < 2 ) {
+    n -= n << 3;
+    n -= n >> 2;
+    n += n << 5;
+    n -= n >> 4;
+  } else if constexpr ( K == 2 ) {
+    n -= n << 2;
+    n -= n >> 3;
+    n += n << 4;
+    n -= n >> 5;
+  } else {
+    n -= n << 3;
+    n -= n >> 1;
+    n += n << 6;
+    n -= n >> 3;
+  }
+  return n;
+}
+
+inline __attribute__((always_inline)) void
+__block(u64 (&s)[4][4], const u8 *p) noexcept
+{
+  u64 b[4];
+  for ( u32 l = 0; l < 4; ++l ) b[l] = __load64(p + 8 * l);
+  for ( u32 l = 0; l < 4; ++l ) s[0][l] = __mix<0>(s[0][l] ^ b[l]);
+  for ( u32 l = 0; l < 4; ++l ) s[1][l] = __mix<1>(s[1][l] ^ b[l]);
+  for ( u32 l = 0; l < 4; ++l ) s[2][l] = __mix<2>(s[2][l] ^ b[l]);
+  for ( u32 l = 0; l < 4; ++l ) s[3][l] = __mix<3>(s[3][l] ^ b[l]);
+}
+
+};      // namespace __zzzs
+
+inline zzz_state
+zzz_init(i64 seed) noexcept
+{
+  zzz_state st{};
+  const u64 sd = static_cast<u64>(seed);
+  for ( u32 l = 0; l < 4; ++l ) {
+    st.s[0][l] = __zzzs::__iv[l] ^ sd;
+    st.s[1][l] = __zzzs::__iv[l ^ 2u] ^ sd;      // the 128-bit halves swapped
+    st.s[2][l] = (__zzzs::__iv[l] << 1) ^ sd;
+    st.s[3][l] = (__zzzs::__iv[l] >> 1) ^ sd;
+  }
+  return st;
+}
+
+inline void
+zzz_update(zzz_state &st, const u8 *data, usize sz) noexcept
+{
+  st.len += sz;
+  if ( st.pend ) {
+    const usize take = 32u - st.pend < sz ? 32u - st.pend : sz;
+    for ( usize i = 0; i < take; ++i ) st.buf[st.pend + i] = data[i];
+    st.pend += static_cast<u32>(take);
+    data += take;
+    sz -= take;
+    if ( st.pend < 32u ) return;
+    __zzzs::__block(st.s, st.buf);
+    st.pend = 0;
+  }
+  for ( ; sz >= 32; data += 32, sz -= 32 ) __zzzs::__block(st.s, data);
+  for ( usize i = 0; i < sz; ++i ) st.buf[i] = data[i];
+  st.pend = static_cast<u32>(sz);
+}
+
+// leaves the state untouched, more input may follow
+inline void
+zzz_digest(const zzz_state &st, u64 *__restrict out) noexcept
+{
+  u64 s[4][4];
+  for ( u32 k = 0; k < 4; ++k )
+    for ( u32 l = 0; l < 4; ++l ) s[k][l] = st.s[k][l];
+  if ( st.pend ) {
+    u8 tmp[32] = {};
+    for ( u32 i = 0; i < st.pend; ++i ) tmp[i] = st.buf[i];
+    __zzzs::__block(s, tmp);
+  }
+  for ( u32 l = 0; l < 4; ++l ) out[l] = s[0][l] ^ s[1][l] ^ s[2][l] ^ s[3][l];
+}
+
+inline u64
+zzz64_digest(const zzz_state &st) noexcept
+{
+  u64 out[4];
+  zzz_digest(st, out);
+  return out[0] ^ out[1] ^ out[2] ^ out[3];
+}
+
+inline micron::pair<u64, u64>
+zzz128_digest(const zzz_state &st) noexcept
+{
+  u64 out[4];
+  zzz_digest(st, out);
+  return { out[0] ^ out[1], out[2] ^ out[3] };
+}
+
+};      // namespace hashes
+};      // namespace micron
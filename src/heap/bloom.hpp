@@ -12,6 +12,7 @@
 #include "../slice.hpp"
 
 #include "../bitfield.hpp"
+#include "../hash/batch.hpp"
 #include "../hash/hash.hpp"
 #include "../type_traits.hpp"
 
@@ -40,6 +41,9 @@ class bloom_filter
 
   bitfield<N> bits;
 
+  // keys per hash_batch call in the bulk paths
+  static constexpr usize __batch = 64;
+
   hash64_t
   hash_round(const T &key, const usize rnd) const
   {
@@ -82,6 +86,38 @@ public:
     for ( usize i = 0; i < L; i++ ) f = f && bits[hash_round(key, i)];
     return f;
   }
+
+  // bulk forms of insert / contains: the keys go a group at a time, each round hashing the whole group in one hash_batch
+  void
+  insert_batch(const T *keys, usize n)
+  {
+    hash64_t hs[__batch];
+    for ( usize base = 0; base < n; base += __batch ) {
+      const usize m = (n - base) < __batch ? (n - base) : __batch;
+      for ( usize i = 0; i < L; i++ ) {
+        hash_batch(keys + base, m, hs, fib_32(static_cast<u32>(i)));
+        for ( usize j = 0; j < m; ++j ) bits.set(hs[j] % N);
+      }
+    }
+  }
+
+  // out[i] = contains(keys[i]); returns the number of keys that may be present
+  usize
+  contains_batch(const T *keys, usize n, bool *out) const
+  {
+    hash64_t hs[__batch];
+    usize hits = 0;
+    for ( usize base = 0; base < n; base += __batch ) {
+      const usize m = (n - base) < __batch ? (n - base) : __batch;
+      for ( usize j = 0; j < m; ++j ) out[base + j] = true;
+      for ( usize i = 0; i < L; i++ ) {
+        hash_batch(keys + base, m, hs, fib_32(static_cast<u32>(i)));
+        for ( usize j = 0; j < m; ++j ) out[base + j] = out[base + j] && bits[hs[j] % N];
+      }
+      for ( usize j = 0; j < m; ++j ) hits += out[base + j];
+    }
+    return hits;
+  }
 };
 
 };      // namespace micron
@@ -7,8 +7,10 @@
 
 #include "algorithm/algorithm.hpp"
 #include "algorithm/memory.hpp"
+#include "allocator.hpp"
 #include "except.hpp"
 #include "memory/addr.hpp"
+#include "memory/new.hpp"
 #include "tags.hpp"
 #include "type_traits.hpp"
 #include "types.hpp"
@@ -21,21 +23,43 @@ template<typename T> struct list_node {
 };
 
 // singly-linked list; traversal is node-pointer based
-template<typename T> class list
+// Alloc = void keeps nodes on the global heap, otherwise each node is one Alloc::create (pool_allocator, monotonic_allocator)
+template<typename T, class Alloc = void> class list
 {
   using list_node_t = list_node<T>;
   list_node_t *root;      // first node, or nullptr when empty
 
+  template<typename... Args>
+  static inline list_node_t *
+  __node_new(Args &&...args)
+  {
+    if constexpr ( micron::is_void_v<Alloc> )
+      return new list_node_t(micron::forward<Args>(args)...);
+    else
+      return new (Alloc::create(sizeof(list_node_t)).ptr) list_node_t(micron::forward<Args>(args)...);
+  }
+
+  static inline void
+  __node_delete(list_node_t *p)
+  {
+    if constexpr ( micron::is_void_v<Alloc> )
+      delete p;
+    else {
+      p->~list_node_t();
+      Alloc::destroy(chunk<byte>{ reinterpret_cast<byte *>(p), sizeof(list_node_t) });
+    }
+  }
+
   inline void
   __impl_heap(T &&t, list_node_t **ptr)
   {
-    *ptr = new list_node_t(micron::move(t), nullptr);
+    *ptr = __node_new(micron::move(t), nullptr);
   }
 
   inline void
   __impl_heap(const T &t, list_node_t **ptr)
   {
-    *ptr = new list_node_t(t, nullptr);
+    *ptr = __node_new(t, nullptr);
   }
 
   inline void
@@ -44,7 +68,7 @@ template<typename T> class list
     list_node_t *ptr = root;
     while ( ptr != nullptr ) {
       list_node_t *nx = ptr->next;
-      delete ptr;
+      __node_delete(ptr);
       ptr = nx;
     }
     root = nullptr;
@@ -324,14 +348,14 @@ public:
     if ( itr == nullptr ) exc<except::runtime_error>("micron::erase invalid iterator.");
     if ( itr == root ) {
       root = root->next;
-      delete const_cast<pointer>(itr);
+      __node_delete(const_cast<pointer>(itr));
       return;
     }
     list_node_t *ptr = root;
     while ( ptr != nullptr and ptr->next != itr ) ptr = ptr->next;
     if ( ptr == nullptr ) return;
     ptr->next = itr->next;
-    delete const_cast<pointer>(itr);
+    __node_delete(const_cast<pointer>(itr));
   }
 
   void
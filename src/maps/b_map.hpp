@@ -11,6 +11,7 @@
 #include "../bits/__container.hpp"
 #include "../concepts.hpp"
 #include "../except.hpp"
+#include "../hash/batch.hpp"
 #include "../hash/hash.hpp"
 #include "../memory/actions.hpp"
 #include "../memory/addr.hpp"
@@ -19,6 +20,7 @@
 #include "../simd/aliases.hpp"
 #include "../simd/types.hpp"
 #include "../tags.hpp"
+#include "../trees/__tree_store.hpp"
 #include "../tuple.hpp"
 #include "../types.hpp"
 
@@ -1431,6 +1433,148 @@ private:
     free_slot(ni);
   }
 
+  // ── bulk loading ─────────────────────────────────────────────────────────
+
+  struct bulk_ref {
+    hash64_t hash;
+    usize pos;      // index into the input, the later of two equal keys wins
+  };
+
+  // smallest bucket count the load check accepts for n entries
+  static usize
+  bulk_buckets(usize n) noexcept
+  {
+    return round_pow2(n * __load_denom / (__leaf_fanout * __load_num) + 1);
+  }
+
+  node_idx
+  bulk_leaf(node_idx &tail)
+  {
+    const node_idx li = alloc_leaf();
+    if ( tail == __k_empty )
+      leaf_list_push_front(li);
+    else
+      leaf_list_insert_after(tail, li);
+    tail = li;
+    return li;
+  }
+
+  template<typename It>
+  void
+  bulk_put(node_idx li, It first, const bulk_ref &r)
+  {
+    leaf_node &L = lnode(li);
+    L.hashes[L.nkeys] = r.hash;
+    new (L.keys() + L.nkeys) K(first[r.pos].a);
+    new (L.values() + L.nkeys) V(first[r.pos].b);
+    ++L.nkeys;
+  }
+
+  node_idx
+  bulk_leftmost(node_idx ni) const noexcept
+  {
+    while ( !slot_is_leaf(ni) ) ni = inode(ni).children[0];
+    return ni;
+  }
+
+  // one bucket's tree from its hash-ordered refs; a hash class never straddles two leaves, one wider than a leaf gets its own primary
+  // plus an overflow chain (the shape chain_insert_same_hash grows). lv is scratch for at least cnt node indices
+  template<typename It>
+  node_idx
+  bulk_bucket(It first, const bulk_ref *rs, usize cnt, usize per, f32 fill, node_idx *lv, node_idx &tail)
+  {
+    usize np = 0;
+    node_idx cur = __k_empty;
+    for ( usize r = 0; r < cnt; ) {
+      usize e = r + 1;
+      while ( e < cnt and rs[e].hash == rs[r].hash ) ++e;
+      const usize cls = e - r;
+      if ( cls > __leaf_fanout ) {
+        node_idx prev = __k_empty;
+        for ( usize a = r; a < e; ) {
+          const node_idx li = bulk_leaf(tail);
+          if ( prev == __k_empty )
+            lv[np++] = li;
+          else
+            lnode(prev).overflow_next = li;
+          prev = li;
+          for ( ; a < e and lnode(li).nkeys < __leaf_fanout; ++a ) bulk_put(li, first, rs[a]);
+        }
+        cur = __k_empty;
+      } else {
+        if ( cur == __k_empty or lnode(cur).nkeys + cls > per ) {
+          cur = bulk_leaf(tail);
+          lv[np++] = cur;
+        }
+        for ( usize a = r; a < e; ++a ) bulk_put(cur, first, rs[a]);
+      }
+      r = e;
+    }
+
+    const usize tgt = __tree_store::bulk_target(fill, __int_fanout, 2);
+    usize count = np;
+    while ( count > 1 ) {
+      const __tree_store::bulk_plan ip(count, tgt, 2);
+      usize k = 0;
+      for ( usize j = 0; j < ip.nodes; ++j ) {
+        const node_idx ni = alloc_internal();
+        const usize c = ip.size(j);
+        internal_node &N = inode(ni);
+        for ( usize x = 0; x < c; ++x, ++k ) {
+          N.children[x] = lv[k];
+          if ( x > 0 ) N.pivots[x - 1] = lnode(bulk_leftmost(lv[k])).hashes[0];
+        }
+        N.nkeys = static_cast<u8>(c - 1);
+        lv[j] = ni;      // every node consumes at least one child, so slot j has already been read
+      }
+      count = ip.nodes;
+    }
+    return lv[0];
+  }
+
+  template<typename It, typename Sort>
+  void
+  bulk_build(It first, usize n, f32 fill, Sort &sort)
+  {
+    if ( n == 0 ) return;
+    bulk_ref *refs = new bulk_ref[n];
+    hash_each<K>(n, [&](usize i) -> const K & { return first[i].a; }, [&](usize i, hash64_t h) { refs[i] = bulk_ref{ h, i }; });
+    const usize mk = mask_;
+    sort(refs, refs + n, [mk](const bulk_ref &x, const bulk_ref &y) {
+      if ( (x.hash & mk) != (y.hash & mk) ) return (x.hash & mk) < (y.hash & mk);
+      if ( x.hash != y.hash ) return x.hash < y.hash;
+      return x.pos < y.pos;
+    });
+
+    // equal keys share a hash, so duplicates sit inside one run of equal hashes
+    usize m = 0;
+    for ( usize r = 0; r < n; ) {
+      usize e = r + 1;
+      while ( e < n and refs[e].hash == refs[r].hash ) ++e;
+      for ( usize a = r; a < e; ++a ) {
+        bool dup = false;
+        for ( usize b = a + 1; b < e and !dup; ++b ) dup = first[refs[b].pos].a == first[refs[a].pos].a;
+        if ( !dup ) refs[m++] = refs[a];
+      }
+      r = e;
+    }
+
+    node_idx *lv = new node_idx[m];
+    const usize per = __tree_store::bulk_target(fill, __leaf_fanout, 1);
+    node_idx tail = __k_empty;
+    for ( usize r = 0; r < m; ) {
+      const usize b = refs[r].hash & mask_;
+      usize e = r + 1;
+      while ( e < m and (refs[e].hash & mask_) == b ) ++e;
+      buckets_[b].root = bulk_bucket(first, refs + r, e - r, per, fill, lv, tail);
+      buckets_[b].size = static_cast<u32>(e - r);
+      r = e;
+    }
+    total_size_ = m;
+    delete[] lv;
+    delete[] refs;
+  }
+
 public:
   using category_type = map_tag;
   using mutability_type = mutable_tag;
@@ -1556,6 +1700,31 @@ public:
     alloc_buckets(n_buckets_);
   }
 
+  // bulk load from a random-access run of entries in any order, anything exposing .a (key) and .b (value) such as micron::pair<K, V>
+  // the bucket array is sized for the final count once, entries are sorted by (bucket, hash) and every bucket's tree is built bottom-up
+  // from packed leaves: no rehash, no per-key descent, no splits. fill in (0, 1] sets leaf and inner occupancy, later entries win on
+  // equal keys. sort is any callable sort(first, last, cmp) over a pointer range, parallel::bulk_sort runs it on the coroutine engine
+  template<typename It, typename Sort = __tree_store::serial_sort>
+  static btree_map
+  from_range(It first, It last, f32 fill = 1.0f, Sort sort = Sort{})
+  {
+    const usize n = static_cast<usize>(last - first);
+    btree_map m(bulk_buckets(n));
+    m.bulk_build(first, n, fill, sort);
+    return m;
+  }
+
+  template<typename R, typename Sort = __tree_store::serial_sort>
+    requires requires(const R &r) {
+      r.begin();
+      r.end();
+    }
+  static btree_map
+  from_range(const R &r, f32 fill = 1.0f, Sort sort = Sort{})
+  {
+    return from_range(r.begin(), r.end(), fill, sort);
+  }
+
   btree_map(const btree_map &) = delete;
 
   btree_map(btree_map &&o) noexcept
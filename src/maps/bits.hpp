@@ -11,4 +11,28 @@
 
 namespace micron
 {
-};
+namespace __impl
+{
+
+// keys resolved per group by the batched lookups (find_batch/contains_batch)
+static constexpr usize __batch_group = 16;
+
+// group prefetching: hash a whole group and touch every home location first, then resolve the group in order. by the time the
+// first probe runs its lines are in flight, so a group of independent lookups overlaps its misses instead of paying them serially
+// the group is hashed in one call, short keys go through hash_batch (hash/batch.hpp) across the vector lanes
+// hash_group(base, m, u64 *hs), prefetch(u64), resolve(i, u64)
+template<typename Hs, typename Pf, typename Rs>
+inline void
+__batch_probe(usize n, Hs &&hash_group, Pf &&prefetch, Rs &&resolve)
+{
+  u64 hs[__batch_group];
+  for ( usize base = 0; base < n; base += __batch_group ) {
+    const usize m = (n - base) < __batch_group ? (n - base) : __batch_group;
+    hash_group(base, m, hs);
+    for ( usize j = 0; j < m; ++j ) prefetch(hs[j]);
+    for ( usize j = 0; j < m; ++j ) resolve(base + j, hs[j]);
+  }
+}
+
+};      // namespace __impl
+};      // namespace micron
@@ -6,6 +6,7 @@
 #pragma once
 #include "../bits.hpp"
 #include "../bits/__arch.hpp"
+#include "../hash/batch.hpp"
 #include "../hash/hash.hpp"
 #include "../simd/aliases.hpp"
 #include "../simd/types.hpp"
@@ -18,16 +19,27 @@
 #include "../memory/new.hpp"
 #include "../tuple.hpp"
 
+#include "bits.hpp"
 #include "swiss.hpp"
 
 namespace micron
 {
 
 // growable heap-backed swiss table, other same as swiss_map
-template<typename K, typename V, class Alloc = micron::allocator_serial<>>
+//
+// Incremental = true amortizes growth: the doubled table is installed next to the old one, every insert moves
+// __inc_groups groups across, and lookups probe both until the old table drains. bounds the worst-case insert to the
+// allocation plus a few dozen moves instead of a full rehash. lookups never move entries, so pointers from find() stay
+// valid until the next insert/emplace, same as the default mode
+//
+// Group = control bytes compared per probe step (16, 32 or 64), see __swiss_group; hswiss_wide picks the build's widest
+template<typename K, typename V, class Alloc = micron::allocator_serial<>, bool Incremental = false, usize Group = 16>
   requires micron::is_copy_constructible_v<V> and micron::is_move_constructible_v<V>
 class heap_swiss_map
 {
+  using __grp = __swiss_group<Group>;
+  using __gmask = typename __grp::mask_type;
+
   struct __hs_entry {
     K key;
     V value;
@@ -51,10 +63,26 @@ class heap_swiss_map
   usize __size = 0;
   usize __growth_left = 0;      // slots remaining before resize
 
-  static constexpr usize __min_cap = 16;
-  static constexpr usize __group = 16;
+  // the table being drained into __ctrl/__entries, null ctrl when no migration is pending
+  struct __hs_old {
+    u8 *ctrl = nullptr;
+    __hs_entry *entries = nullptr;
+    usize n_slots = 0;
+    usize pos = 0;      // old slots below this have been moved
+  };
+
+  struct __hs_no_old {
+  };
+
+  // Incremental only, takes no space otherwise; every use sits behind if constexpr ( Incremental )
+  [[no_unique_address]] micron::conditional_t<Incremental, __hs_old, __hs_no_old> __old;
+
+  static constexpr usize __group = Group;
+  static constexpr usize __min_cap = Group > 16 ? Group : 16;      // a group never wraps onto itself
   static constexpr usize __load_num = 7;
   static constexpr usize __load_denom = 8;
+  // old groups moved per insert; a doubled table has room for 7/8 n fresh inserts, the drain needs n / (__group * this)
+  static constexpr usize __inc_groups = 2;
 
   static usize
   round_pow2(usize n) noexcept
@@ -83,65 +111,22 @@ class heap_swiss_map
     return static_cast<usize>(h);
   }
 
-  ::micron::__mask
-  __match_h2(u8 hash_val, usize ind) const noexcept
-  {
-#if defined(__micron_arch_x86_any)
-    simd::i128 m = simd::sse::splat_i8(static_cast<char>(hash_val));
-    simd::i128 c = simd::sse::loadu_i128(reinterpret_cast<const __m128i_u *>(&__ctrl[ind]));
-    return ::micron::__mask(simd::sse::movemask_i8(simd::sse::eq_i8(m, c)));
-#elif defined(__micron_arm_neon)
-    uint8x16_t m = simd::neon::splat_u8(hash_val);
-    uint8x16_t c = simd::neon::load_u8(&__ctrl[ind]);
-    return ::micron::__mask(static_cast<i32>(simd::neon::movemask_u8(simd::neon::eq(c, m))));
-#else
-    i32 r = 0;
-    for ( usize i = 0; i < 16; ++i )
-      if ( __ctrl[ind + i] == hash_val ) r |= (1 << i);
-    return ::micron::__mask(r);
-#endif
+  static __gmask
+  __match_h2(const u8 *ctrl, u8 hash_val, usize ind) noexcept
+  {
+    return __grp::match(&ctrl[ind], hash_val);
   }
 
-  ::micron::__mask
-  __match_empty_slots(usize ind) const noexcept
-  {
-#if defined(__micron_arch_x86_any)
-    simd::i128 e = simd::sse::splat_i8(static_cast<char>(__empty));
-    simd::i128 c = simd::sse::loadu_i128(reinterpret_cast<const __m128i_u *>(&__ctrl[ind]));
-    return ::micron::__mask(simd::sse::movemask_i8(simd::sse::eq_i8(e, c)));
-#elif defined(__micron_arm_neon)
-    uint8x16_t e = simd::neon::splat_u8(__empty);
-    uint8x16_t c = simd::neon::load_u8(&__ctrl[ind]);
-    return ::micron::__mask(static_cast<i32>(simd::neon::movemask_u8(simd::neon::eq(c, e))));
-#else
-    i32 r = 0;
-    for ( usize i = 0; i < 16; ++i )
-      if ( __ctrl[ind + i] == __empty ) r |= (1 << i);
-    return ::micron::__mask(r);
-#endif
+  static __gmask
+  __match_empty_slots(const u8 *ctrl, usize ind) noexcept
+  {
+    return __grp::match_empty(&ctrl[ind]);
   }
 
-  ::micron::__mask
-  __match_empty_or_del(usize ind) const noexcept
-  {
-#if defined(__micron_arch_x86_any)
-    simd::i128 c = simd::sse::loadu_i128(reinterpret_cast<const __m128i_u *>(&__ctrl[ind]));
-    simd::i128 e = simd::sse::splat_i8(static_cast<char>(__empty));
-    simd::i128 d = simd::sse::splat_i8(static_cast<char>(__deleted));
-    return ::micron::__mask(simd::sse::movemask_i8(simd::sse::or_i128(simd::sse::eq_i8(c, e), simd::sse::eq_i8(c, d))));
-#elif defined(__micron_arm_neon)
-    uint8x16_t c = simd::neon::load_u8(&__ctrl[ind]);
-    uint8x16_t e = simd::neon::splat_u8(__empty);
-    uint8x16_t d = simd::neon::splat_u8(__deleted);
-    return ::micron::__mask(static_cast<i32>(simd::neon::movemask_u8(simd::neon::or_(simd::neon::eq(c, e), simd::neon::eq(c, d)))));
-#else
-    i32 r = 0;
-    for ( usize i = 0; i < 16; ++i ) {
-      u8 cc = __ctrl[ind + i];
-      if ( cc == __empty || cc == __deleted ) r |= (1 << i);
-    }
-    return ::micron::__mask(r);
-#endif
+  static __gmask
+  __match_empty_or_del(const u8 *ctrl, usize ind) noexcept
+  {
+    return __grp::match_empty_or_deleted(&ctrl[ind]);
   }
 
   void
@@ -192,51 +177,118 @@ class heap_swiss_map
     }
   }
 
+  static void
+  __mirror(u8 *ctrl, usize n_slots, usize probe, u8 v) noexcept
+  {
+    ctrl[probe] = v;
+    if ( probe < __group ) ctrl[n_slots + probe] = v;
+  }
+
   void
   __mirror_ctrl(usize probe, u8 v) noexcept
   {
-    __ctrl[probe] = v;
-    if ( probe < __group ) __ctrl[__n_slots + probe] = v;
+    __mirror(__ctrl, __n_slots, probe, v);
+  }
+
+  // first empty or deleted slot on the probe sequence from start, __n_slots if the table is full
+  usize
+  __free_slot(usize start) const noexcept
+  {
+    usize i = 0;
+    while ( i < __n_slots ) {
+      usize g = (start + i) & __cap_mask;
+      __gmask em = __match_empty_or_del(__ctrl, g);
+      if ( em.any() ) return (g + em.lowest()) & __cap_mask;
+      i += __group;
+    }
+    return __n_slots;
   }
 
   template<typename KK, typename VV>
   V *
   __probe_insert(KK &&key, VV &&value, u8 h2, usize start)
   {
+    const usize probe = __free_slot(start);
+    if ( probe == __n_slots ) return nullptr;
+    new (micron::addr(__entries[probe])) __hs_entry{ micron::forward<KK>(key), micron::forward<VV>(value) };
+    __mirror_ctrl(probe, h2);
+    ++__size;
+    --__growth_left;
+    return micron::addr(__entries[probe].value);
+  }
+
+  // first ctrl group and the home entry, what __probe_find touches first
+  __attribute__((always_inline)) void
+  __prefetch_home(hash64_t kh) const noexcept
+  {
+    if ( __builtin_expect(!__ctrl, 0) ) return;
+    const usize start = __h1(kh) & __cap_mask;
+    __builtin_prefetch(&__ctrl[start], 0, 3);
+    __builtin_prefetch(&__entries[start], 0, 3);
+    if constexpr ( Incremental ) {
+      if ( __old.ctrl ) __builtin_prefetch(&__old.ctrl[__h1(kh) & (__old.n_slots - 1u)], 0, 3);
+    }
+  }
+
+  static V *
+  __probe_table(const u8 *ctrl, const __hs_entry *entries, usize n_slots, const K &key, u8 h2, usize start) noexcept
+  {
+    const usize mask = n_slots - 1u;
     usize i = 0;
-    while ( i < __n_slots ) {
-      usize g = (start + i) & __cap_mask;
-      ::micron::__mask em = __match_empty_or_del(g);
-      if ( em.any() ) {
-        usize probe = (g + em.lowest()) & __cap_mask;
-        new (micron::addr(__entries[probe])) __hs_entry{ micron::forward<KK>(key), micron::forward<VV>(value) };
-        __mirror_ctrl(probe, h2);
-        ++__size;
-        --__growth_left;
-        return micron::addr(__entries[probe].value);
+    while ( i < n_slots ) {
+      usize g = (start + i) & mask;
+      __gmask m = __match_h2(ctrl, h2, g);
+      while ( m.any() ) {
+        usize probe = (g + m.lowest()) & mask;
+        if ( entries[probe].key == key ) return const_cast<V *>(micron::addr(entries[probe].value));
+        m.clear_lowest();
       }
+      if ( __match_empty_slots(ctrl, g).any() ) return nullptr;
       i += __group;
     }
     return nullptr;
   }
 
-  V *
-  __probe_find(const K &key, u8 h2, usize start) const noexcept
+  static bool
+  __erase_table(u8 *ctrl, __hs_entry *entries, usize n_slots, const K &key, u8 h2, usize start) noexcept
   {
-    if ( !__ctrl ) return nullptr;
+    const usize mask = n_slots - 1u;
     usize i = 0;
-    while ( i < __n_slots ) {
-      usize g = (start + i) & __cap_mask;
-      ::micron::__mask m = __match_h2(h2, g);
+    while ( i < n_slots ) {
+      usize g = (start + i) & mask;
+      __gmask m = __match_h2(ctrl, h2, g);
       while ( m.any() ) {
-        usize probe = (g + m.lowest()) & __cap_mask;
-        if ( __entries[probe].key == key ) return const_cast<V *>(micron::addr(__entries[probe].value));
+        usize probe = (g + m.lowest()) & mask;
+        if ( entries[probe].key == key ) {
+          if constexpr ( !micron::is_trivially_destructible_v<__hs_entry> ) entries[probe].~__hs_entry();
+          __mirror(ctrl, n_slots, probe, __deleted);
+          return true;
+        }
         m.clear_lowest();
       }
-      if ( __match_empty_slots(g).any() ) return nullptr;
+      if ( __match_empty_slots(ctrl, g).any() ) return false;
       i += __group;
     }
-    return nullptr;
+    return false;
+  }
+
+  V *
+  __probe_find(const K &key, u8 h2, usize start) const noexcept
+  {
+    if ( !__ctrl ) return nullptr;
+    return __probe_table(__ctrl, __entries, __n_slots, key, h2, start);
+  }
+
+  // current table, then the draining one
+  V *
+  __lookup(const K &key, hash64_t kh) const noexcept
+  {
+    const u8 h2 = __h2(kh);
+    V *v = __probe_find(key, h2, __h1(kh) & __cap_mask);
+    if constexpr ( Incremental ) {
+      if ( !v && __old.ctrl ) v = __probe_table(__old.ctrl, __old.entries, __old.n_slots, key, h2, __h1(kh) & (__old.n_slots - 1u));
+    }
+    return v;
   }
 
   void
@@ -271,13 +323,19 @@ class heap_swiss_map
     }
 #endif
     if ( old_entries && old_ctrl ) {
-      for ( usize i = 0; i < old_n; ++i ) {
-        u8 c = old_ctrl[i];
-        if ( c != __empty && c != __deleted ) {
-          hash64_t kh = hash<hash64_t>(old_entries[i].key);
-          __probe_insert(micron::move(old_entries[i].key), micron::move(old_entries[i].value), __h2(kh), __h1(kh) & __cap_mask);
-          if constexpr ( !micron::is_trivially_destructible_v<__hs_entry> ) old_entries[i].~__hs_entry();
-        }
+      // live slots a group at a time, each group's keys hashed in one batch and reinserted in slot order
+      usize idx[__impl::__batch_group];
+      for ( usize i = 0; i < old_n; ) {
+        usize m = 0;
+        for ( ; i < old_n && m < __impl::__batch_group; ++i )
+          if ( old_ctrl[i] != __empty && old_ctrl[i] != __deleted ) idx[m++] = i;
+        hash_each<K>(
+            m, [&](usize j) -> const K & { return old_entries[idx[j]].key; },
+            [&](usize j, hash64_t kh) {
+              __hs_entry &e = old_entries[idx[j]];
+              __probe_insert(micron::move(e.key), micron::move(e.value), __h2(kh), __h1(kh) & __cap_mask);
+              if constexpr ( !micron::is_trivially_destructible_v<__hs_entry> ) e.~__hs_entry();
+            });
       }
     }
     if ( old_ctrl ) delete[] old_ctrl;
@@ -287,6 +345,141 @@ class heap_swiss_map
     }
   }
 
+  void
+  __free_old() noexcept
+  {
+    if ( __old.ctrl ) delete[] __old.ctrl;
+    if ( __old.entries ) {
+      chunk<byte> ch{ reinterpret_cast<byte *>(__old.entries), __old.n_slots * sizeof(__hs_entry) };
+      Alloc::destroy(ch);
+    }
+    __old.ctrl = nullptr;
+    __old.entries = nullptr;
+    __old.n_slots = 0;
+    __old.pos = 0;
+  }
+
+  // destroys whatever has not been migrated yet and releases the old table
+  void
+  __drop_old() noexcept
+  {
+    if constexpr ( Incremental ) {
+      if ( !__old.ctrl ) return;
+      if constexpr ( !micron::is_trivially_destructible_v<__hs_entry> ) {
+        for ( usize i = __old.pos; i < __old.n_slots; ++i ) {
+          u8 c = __old.ctrl[i];
+          if ( c != __empty && c != __deleted ) __old.entries[i].~__hs_entry();
+        }
+      }
+      __free_old();
+    }
+  }
+
+  // moves the next n old slots into the current table, releasing the old table once the cursor reaches its end
+  // the current table always has room: it was sized at twice the old one and __growth_left is charged per move
+  // moved slots become __deleted, not __empty, so probe chains of keys still waiting in the old table stay intact
+  void
+  __migrate(usize n)
+  {
+    const usize end = __old.n_slots - __old.pos < n ? __old.n_slots : __old.pos + n;
+    for ( ; __old.pos < end; ++__old.pos ) {
+      const usize i = __old.pos;
+      const u8 c = __old.ctrl[i];
+      if ( c == __empty || c == __deleted ) continue;
+      const usize probe = __free_slot(__h1(hash<hash64_t>(__old.entries[i].key)) & __cap_mask);
+      new (micron::addr(__entries[probe])) __hs_entry(micron::move(__old.entries[i]));
+      __mirror_ctrl(probe, c);      // h2 does not depend on the table size
+      --__growth_left;
+      if constexpr ( !micron::is_trivially_destructible_v<__hs_entry> ) __old.entries[i].~__hs_entry();
+      __mirror(__old.ctrl, __old.n_slots, i, __deleted);
+    }
+    if ( __old.pos == __old.n_slots ) __free_old();
+  }
+
+  // incremental growth: install the bigger table and keep the current one as the migration source
+  void
+  __begin_migration(usize new_n_slots)
+  {
+    u8 *prev_ctrl = __ctrl;
+    __hs_entry *prev_entries = __entries;
+    const usize prev_n = __n_slots;
+    __alloc_storage(new_n_slots);      // commits only on success, a throw leaves both tables as they were
+    // a drain that has not finished by now goes straight into the fresh table
+    if ( __old.ctrl ) __migrate(__old.n_slots);
+    __old.ctrl = prev_ctrl;
+    __old.entries = prev_entries;
+    __old.n_slots = prev_n;
+    __old.pos = 0;
+  }
+
+  // called before every insert: advance a pending migration, then grow if the table is out of room
+  void
+  __make_room()
+  {
+    if constexpr ( Incremental ) {
+      if ( __old.ctrl ) __migrate(__inc_groups * __group);
+      if ( __growth_left == 0 ) __begin_migration(__n_slots * 2);
+    } else {
+      if ( __growth_left == 0 ) __rehash(__n_slots * 2);
+    }
+  }
+
+  // same slot layout as o for its current table, o's undrained entries are rehashed in so the copy starts settled
+  void
+  __copy_from(const heap_swiss_map &o)
+  {
+    __alloc_storage(o.__n_slots);
+    for ( usize i = 0; i < o.__n_slots; ++i ) {
+      u8 c = o.__ctrl[i];
+      if ( c != __empty && c != __deleted ) {
+        new (micron::addr(__entries[i])) __hs_entry(o.__entries[i]);
+        __mirror_ctrl(i, c);
+      }
+    }
+    __size = o.__size;
+    __growth_left = o.__growth_left;
+    if constexpr ( Incremental ) {
+      for ( usize i = o.__old.pos; i < o.__old.n_slots; ++i ) {
+        u8 c = o.__old.ctrl[i];
+        if ( c == __empty || c == __deleted ) continue;
+        const usize probe = __free_slot(__h1(hash<hash64_t>(o.__old.entries[i].key)) & __cap_mask);
+        new (micron::addr(__entries[probe])) __hs_entry(o.__old.entries[i]);
+        __mirror_ctrl(probe, c);
+        --__growth_left;
+      }
+    }
+  }
+
+  // iteration spans both tables: [0, __n_slots) is the current one, the draining table follows
+  usize
+  __slot_end() const noexcept
+  {
+    if constexpr ( Incremental )
+      return __n_slots + __old.n_slots;
+    else
+      return __n_slots;
+  }
+
+  bool
+  __live(usize i) const noexcept
+  {
+    u8 c;
+    if constexpr ( Incremental )
+      c = i < __n_slots ? __ctrl[i] : __old.ctrl[i - __n_slots];
+    else
+      c = __ctrl[i];
+    return c != __empty && c != __deleted;
+  }
+
+  __hs_entry &
+  __entry(usize i) const noexcept
+  {
+    if constexpr ( Incremental )
+      return i < __n_slots ? __entries[i] : __old.entries[i - __n_slots];
+    else
+      return __entries[i];
+  }
+
 public:
   using category_type = map_tag;
   using mutability_type = mutable_tag;
@@ -304,29 +497,18 @@ public:
   {
     __destroy_occupied();
     __free_storage();
+    __drop_old();
   }
 
   heap_swiss_map() { __alloc_storage(__min_cap); }
 
   explicit heap_swiss_map(usize n) { __alloc_storage(round_pow2(n)); }
 
-  heap_swiss_map(const heap_swiss_map &o)
-  {
-    __alloc_storage(o.__n_slots);
-    for ( usize i = 0; i < o.__n_slots; ++i ) {
-      u8 c = o.__ctrl[i];
-      if ( c != __empty && c != __deleted ) {
-        new (micron::addr(__entries[i])) __hs_entry(o.__entries[i]);
-        __mirror_ctrl(i, c);
-      }
-    }
-    __size = o.__size;
-    __growth_left = o.__growth_left;
-  }
+  heap_swiss_map(const heap_swiss_map &o) { __copy_from(o); }
 
   heap_swiss_map(heap_swiss_map &&o) noexcept
       : __ctrl(o.__ctrl), __entries(o.__entries), __n_slots(o.__n_slots), __cap_mask(o.__cap_mask), __size(o.__size),
-        __growth_left(o.__growth_left)
+        __growth_left(o.__growth_left), __old(o.__old)
   {
     o.__ctrl = nullptr;
     o.__entries = nullptr;
@@ -334,6 +516,7 @@ public:
     o.__cap_mask = 0;
     o.__size = 0;
     o.__growth_left = 0;
+    o.__old = {};
   }
 
   heap_swiss_map &
@@ -342,16 +525,8 @@ public:
     if ( this == &o ) return *this;
     __destroy_occupied();
     __free_storage();
-    __alloc_storage(o.__n_slots);
-    for ( usize i = 0; i < o.__n_slots; ++i ) {
-      u8 c = o.__ctrl[i];
-      if ( c != __empty && c != __deleted ) {
-        new (micron::addr(__entries[i])) __hs_entry(o.__entries[i]);
-        __mirror_ctrl(i, c);
-      }
-    }
-    __size = o.__size;
-    __growth_left = o.__growth_left;
+    __drop_old();
+    __copy_from(o);
     return *this;
   }
 
@@ -361,18 +536,21 @@ public:
     if ( this == &o ) return *this;
     __destroy_occupied();
     __free_storage();
+    __drop_old();
     __ctrl = o.__ctrl;
     __entries = o.__entries;
     __n_slots = o.__n_slots;
     __cap_mask = o.__cap_mask;
     __size = o.__size;
     __growth_left = o.__growth_left;
+    __old = o.__old;
     o.__ctrl = nullptr;
     o.__entries = nullptr;
     o.__n_slots = 0;
     o.__cap_mask = 0;
     o.__size = 0;
     o.__growth_left = 0;
+    o.__old = {};
     return *this;
   }
 
@@ -406,10 +584,21 @@ public:
     return __n_slots > 0u ? static_cast<float>(__size) / static_cast<float>(__n_slots) : 0.0f;
   }
 
+  // true while an incremental grow still has entries in the old table
+  bool
+  migrating() const noexcept
+  {
+    if constexpr ( Incremental )
+      return __old.ctrl != nullptr;
+    else
+      return false;
+  }
+
   void
   clear() noexcept
   {
     __destroy_occupied();
+    __drop_old();
     if ( __ctrl ) micron::memset(__ctrl, __empty, __n_slots + __group);
     __size = 0;
     __growth_left = __n_slots * __load_num / __load_denom;
@@ -419,18 +608,22 @@ public:
   reserve(usize n)
   {
     usize need = round_pow2(n);
-    if ( need > __n_slots ) __rehash(need);
+    if ( need <= __n_slots ) return;
+    if constexpr ( Incremental ) {
+      if ( __old.ctrl ) __migrate(__old.n_slots);
+    }
+    __rehash(need);
   }
 
   template<typename KK, typename VV>
   micron::pair<bool, V *>
   insert_or_assign(KK &&key, VV &&value)
   {
-    if ( __growth_left == 0 ) __rehash(__n_slots * 2);
+    __make_room();
     hash64_t kh = hash<hash64_t>(key);
     u8 h2 = __h2(kh);
     usize start = __h1(kh) & __cap_mask;
-    V *ex = __probe_find(key, h2, start);
+    V *ex = __lookup(key, kh);
     if ( ex ) {
       *ex = micron::forward<VV>(value);
       return { false, ex };
@@ -441,11 +634,11 @@ public:
   micron::pair<bool, V *>
   insert(const K &key, const V &value)
   {
-    if ( __growth_left == 0 ) __rehash(__n_slots * 2);
+    __make_room();
     hash64_t kh = hash<hash64_t>(key);
     u8 h2 = __h2(kh);
     usize start = __h1(kh) & __cap_mask;
-    V *ex = __probe_find(key, h2, start);
+    V *ex = __lookup(key, kh);
     if ( ex ) return { false, ex };
     return { true, __probe_insert(key, value, h2, start) };
   }
@@ -453,11 +646,11 @@ public:
   micron::pair<bool, V *>
   insert(K &&key, V &&value)
   {
-    if ( __growth_left == 0 ) __rehash(__n_slots * 2);
+    __make_room();
     hash64_t kh = hash<hash64_t>(key);
     u8 h2 = __h2(kh);
     usize start = __h1(kh) & __cap_mask;
-    V *ex = __probe_find(key, h2, start);
+    V *ex = __lookup(key, kh);
     if ( ex ) return { false, ex };
     return { true, __probe_insert(micron::move(key), micron::move(value), h2, start) };
   }
@@ -472,11 +665,11 @@ public:
   micron::pair<bool, V *>
   emplace(const K &key, Args &&...args)
   {
-    if ( __growth_left == 0 ) __rehash(__n_slots * 2);
+    __make_room();
     hash64_t kh = hash<hash64_t>(key);
     u8 h2 = __h2(kh);
     usize start = __h1(kh) & __cap_mask;
-    V *ex = __probe_find(key, h2, start);
+    V *ex = __lookup(key, kh);
     if ( ex ) return { false, ex };
     return { true, __probe_insert(K(key), V(micron::forward<Args>(args)...), h2, start) };
   }
@@ -484,15 +677,13 @@ public:
   V *
   find(const K &key) noexcept
   {
-    hash64_t kh = hash<hash64_t>(key);
-    return __probe_find(key, __h2(kh), __h1(kh) & __cap_mask);
+    return __lookup(key, hash<hash64_t>(key));
   }
 
   const V *
   find(const K &key) const noexcept
   {
-    hash64_t kh = hash<hash64_t>(key);
-    return __probe_find(key, __h2(kh), __h1(kh) & __cap_mask);
+    return __lookup(key, hash<hash64_t>(key));
   }
 
   bool
@@ -501,6 +692,47 @@ public:
     return find(key) != nullptr;
   }
 
+  // batched lookups, out[i] = find(keys[i]); returns the number of hits
+  // keys are hashed and their first groups prefetched a group at a time, see __impl::__batch_probe
+  usize
+  find_batch(const K *keys, usize n, V **out) noexcept
+  {
+    usize hits = 0;
+    __impl::__batch_probe(
+        n, [&](usize b, usize m, hash64_t *hs) { hash_batch(keys + b, m, hs); }, [&](hash64_t kh) { __prefetch_home(kh); },
+        [&](usize i, hash64_t kh) {
+          out[i] = __lookup(keys[i], kh);
+          hits += out[i] != nullptr;
+        });
+    return hits;
+  }
+
+  usize
+  find_batch(const K *keys, usize n, const V **out) const noexcept
+  {
+    usize hits = 0;
+    __impl::__batch_probe(
+        n, [&](usize b, usize m, hash64_t *hs) { hash_batch(keys + b, m, hs); }, [&](hash64_t kh) { __prefetch_home(kh); },
+        [&](usize i, hash64_t kh) {
+          out[i] = __lookup(keys[i], kh);
+          hits += out[i] != nullptr;
+        });
+    return hits;
+  }
+
+  usize
+  contains_batch(const K *keys, usize n, bool *out) const noexcept
+  {
+    usize hits = 0;
+    __impl::__batch_probe(
+        n, [&](usize b, usize m, hash64_t *hs) { hash_batch(keys + b, m, hs); }, [&](hash64_t kh) { __prefetch_home(kh); },
+        [&](usize i, hash64_t kh) {
+          out[i] = __lookup(keys[i], kh) != nullptr;
+          hits += out[i];
+        });
+    return hits;
+  }
+
   usize
   count(const K &key) const noexcept
   {
@@ -545,6 +777,7 @@ public:
     micron::swap(__cap_mask, o.__cap_mask);
     micron::swap(__size, o.__size);
     micron::swap(__growth_left, o.__growth_left);
+    micron::swap(__old, o.__old);
   }
 
   template<typename Fn>
@@ -552,10 +785,8 @@ public:
   for_each(Fn &&fn)
   {
     if ( !__ctrl ) return;
-    for ( usize i = 0; i < __n_slots; ++i ) {
-      u8 c = __ctrl[i];
-      if ( c != __empty && c != __deleted ) fn(__entries[i].key, __entries[i].value);
-    }
+    for ( usize i = 0; i < __slot_end(); ++i )
+      if ( __live(i) ) fn(__entry(i).key, __entry(i).value);
   }
 
   template<typename Fn>
@@ -563,10 +794,8 @@ public:
   for_each(Fn &&fn) const
   {
     if ( !__ctrl ) return;
-    for ( usize i = 0; i < __n_slots; ++i ) {
-      u8 c = __ctrl[i];
-      if ( c != __empty && c != __deleted ) fn(__entries[i].key, __entries[i].value);
-    }
+    for ( usize i = 0; i < __slot_end(); ++i )
+      if ( __live(i) ) fn(__entry(i).key, __entry(i).value);
   }
 
   bool
@@ -575,25 +804,12 @@ public:
     if ( !__ctrl ) return false;
     hash64_t kh = hash<hash64_t>(key);
     u8 h2 = __h2(kh);
-    usize start = __h1(kh) & __cap_mask;
-    usize i = 0;
-    while ( i < __n_slots ) {
-      usize g = (start + i) & __cap_mask;
-      ::micron::__mask m = __match_h2(h2, g);
-      while ( m.any() ) {
-        usize probe = (g + m.lowest()) & __cap_mask;
-        if ( __entries[probe].key == key ) {
-          if constexpr ( !micron::is_trivially_destructible_v<__hs_entry> ) __entries[probe].~__hs_entry();
-          __mirror_ctrl(probe, __deleted);
-          --__size;
-          return true;
-        }
-        m.clear_lowest();
-      }
-      if ( __match_empty_slots(g).any() ) return false;
-      i += __group;
+    bool hit = __erase_table(__ctrl, __entries, __n_slots, key, h2, __h1(kh) & __cap_mask);
+    if constexpr ( Incremental ) {
+      if ( !hit && __old.ctrl ) hit = __erase_table(__old.ctrl, __old.entries, __old.n_slots, key, h2, __h1(kh) & (__old.n_slots - 1u));
     }
-    return false;
+    __size -= hit;
+    return hit;
   }
 
   class iterator
@@ -604,7 +820,7 @@ public:
     void
     advance()
     {
-      while ( __i < __m->__n_slots && (__m->__ctrl[__i] == __empty || __m->__ctrl[__i] == __deleted) ) ++__i;
+      while ( __i < __m->__slot_end() && !__m->__live(__i) ) ++__i;
     }
 
   public:
@@ -618,13 +834,13 @@ public:
     reference
     operator*()
     {
-      return { __m->__entries[__i].key, __m->__entries[__i].value };
+      return { __m->__entry(__i).key, __m->__entry(__i).value };
     }
 
     pointer
     operator->()
     {
-      return { micron::addr(__m->__entries[__i].key), micron::addr(__m->__entries[__i].value) };
+      return { micron::addr(__m->__entry(__i).key), micron::addr(__m->__entry(__i).value) };
     }
 
     iterator &
@@ -664,7 +880,7 @@ public:
     void
     advance()
     {
-      while ( __i < __m->__n_slots && (__m->__ctrl[__i] == __empty || __m->__ctrl[__i] == __deleted) ) ++__i;
+      while ( __i < __m->__slot_end() && !__m->__live(__i) ) ++__i;
     }
 
   public:
@@ -678,13 +894,13 @@ public:
     reference
     operator*() const
     {
-      return { __m->__entries[__i].key, __m->__entries[__i].value };
+      return { __m->__entry(__i).key, __m->__entry(__i).value };
     }
 
     pointer
     operator->() const
     {
-      return { micron::addr(__m->__entries[__i].key), micron::addr(__m->__entries[__i].value) };
+      return { micron::addr(__m->__entry(__i).key), micron::addr(__m->__entry(__i).value) };
     }
 
     const_iterator &
@@ -725,7 +941,7 @@ public:
   iterator
   end()
   {
-    return iterator(this, __n_slots);
+    return iterator(this, __slot_end());
   }
 
   const_iterator
@@ -737,7 +953,7 @@ public:
   const_iterator
   end() const
   {
-    return const_iterator(this, __n_slots);
+    return const_iterator(this, __slot_end());
   }
 
   const_iterator
@@ -749,10 +965,13 @@ public:
   const_iterator
   cend() const
   {
-    return const_iterator(this, __n_slots);
+    return const_iterator(this, __slot_end());
   }
 };
 
 template<typename K, typename V, class Alloc = micron::allocator_serial<>> using hswiss = heap_swiss_map<K, V, Alloc>;
+template<typename K, typename V, class Alloc = micron::allocator_serial<>> using hswiss_inc = heap_swiss_map<K, V, Alloc, true>;
+template<typename K, typename V, class Alloc = micron::allocator_serial<>>
+using hswiss_wide = heap_swiss_map<K, V, Alloc, false, __swiss_native_group>;
 
 };      // namespace micron
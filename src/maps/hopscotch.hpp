@@ -5,6 +5,7 @@
 //  http://www.boost.org/LICENSE_1_0.txt
 #pragma once
 
+#include "../hash/batch.hpp"
 #include "../hash/hash.hpp"
 #include "../memory/actions.hpp"
 #include "../memory/addr.hpp"
@@ -295,6 +296,58 @@ template<typename K, typename V, usize MH = 32, typename Nd = hopscotch_node<K,
     return false;
   }
 
+  V *
+  __find_hash(hash64_t hsh)
+  {
+    if ( hsh == 0 ) {
+      return nullptr;
+    }
+
+    if ( __bmask == 0 ) {
+      return nullptr;
+    }
+
+    usize home = __hop_impl::mix(hsh) & __bmask;
+
+    // unrolled 4x probe
+    __builtin_prefetch(&entries[home], 0, 1);
+    constexpr usize __slots = MH + 1;               // 33 slots
+    constexpr usize __tail = __slots & 3u;          // 1 trailing slot
+    constexpr usize __head = __slots - __tail;      // 32 covered by groups
+    for ( usize i = 0; i < __head; i += 4 ) {
+      const usize p0 = (home + i + 0) & __bmask;
+      const usize p1 = (home + i + 1) & __bmask;
+      const usize p2 = (home + i + 2) & __bmask;
+      const usize p3 = (home + i + 3) & __bmask;
+      const hash64_t k0 = entries[p0].key;
+      const hash64_t k1 = entries[p1].key;
+      const hash64_t k2 = entries[p2].key;
+      const hash64_t k3 = entries[p3].key;
+      u32 hits = (u32(k0 == hsh) << 0) | (u32(k1 == hsh) << 1) | (u32(k2 == hsh) << 2) | (u32(k3 == hsh) << 3);
+      if ( hits ) {
+        u32 b = static_cast<u32>(__builtin_ctz(hits));
+        const usize probe = (home + i + b) & __bmask;
+        return micron::addressof(entries[probe].value);
+      }
+    }
+    // scalar tail
+    for ( usize i = __head; i < __slots; ++i ) {
+      usize probe = (home + i) & __bmask;
+      if ( entries[probe].key == hsh ) return micron::addressof(entries[probe].value);
+    }
+    return nullptr;
+  }
+
+  // first and last line of the neighbourhood, the probe covers everything in between
+  __attribute__((always_inline)) void
+  __prefetch_home(hash64_t hsh)
+  {
+    if ( hsh == 0 or __bmask == 0 ) return;
+    const usize home = __hop_impl::mix(hsh) & __bmask;
+    __builtin_prefetch(&entries[home], 0, 3);
+    __builtin_prefetch(&entries[(home + MH) & __bmask], 0, 3);
+  }
+
 public:
   using category_type = map_tag;
   using mutability_type = mutable_tag;
@@ -625,44 +678,7 @@ public:
   V *
   find(const K &k)
   {
-    hash64_t hsh = hash<hash64_t>(k);
-    if ( hsh == 0 ) {
-      return nullptr;
-    }
-
-    if ( __bmask == 0 ) {
-      return nullptr;
-    }
-
-    usize home = __hop_impl::mix(hsh) & __bmask;
-
-    // unrolled 4x probe
-    __builtin_prefetch(&entries[home], 0, 1);
-    constexpr usize __slots = MH + 1;               // 33 slots
-    constexpr usize __tail = __slots & 3u;          // 1 trailing slot
-    constexpr usize __head = __slots - __tail;      // 32 covered by groups
-    for ( usize i = 0; i < __head; i += 4 ) {
-      const usize p0 = (home + i + 0) & __bmask;
-      const usize p1 = (home + i + 1) & __bmask;
-      const usize p2 = (home + i + 2) & __bmask;
-      const usize p3 = (home + i + 3) & __bmask;
-      const hash64_t k0 = entries[p0].key;
-      const hash64_t k1 = entries[p1].key;
-      const hash64_t k2 = entries[p2].key;
-      const hash64_t k3 = entries[p3].key;
-      u32 hits = (u32(k0 == hsh) << 0) | (u32(k1 == hsh) << 1) | (u32(k2 == hsh) << 2) | (u32(k3 == hsh) << 3);
-      if ( hits ) {
-        u32 b = static_cast<u32>(__builtin_ctz(hits));
-        const usize probe = (home + i + b) & __bmask;
-        return micron::addressof(entries[probe].value);
-      }
-    }
-    // scalar tail
-    for ( usize i = __head; i < __slots; ++i ) {
-      usize probe = (home + i) & __bmask;
-      if ( entries[probe].key == hsh ) return micron::addressof(entries[probe].value);
-    }
-    return nullptr;
+    return __find_hash(hash<hash64_t>(k));
   }
 
   const V *
@@ -677,6 +693,41 @@ public:
     return find(k) != nullptr;
   }
 
+  // batched lookups, out[i] = find(keys[i]); returns the number of hits
+  // keys are hashed and both ends of their neighbourhoods prefetched a group at a time, see __impl::__batch_probe
+  usize
+  find_batch(const K *keys, usize n, V **out)
+  {
+    usize hits = 0;
+    __impl::__batch_probe(
+        n, [&](usize b, usize m, hash64_t *hs) { hash_batch(keys + b, m, hs); }, [&](hash64_t hsh) { __prefetch_home(hsh); },
+        [&](usize i, hash64_t hsh) {
+          out[i] = __find_hash(hsh);
+          hits += out[i] != nullptr;
+        });
+    return hits;
+  }
+
+  usize
+  find_batch(const K *keys, usize n, const V **out) const
+  {
+    return const_cast<hopscotch_map *>(this)->find_batch(keys, n, const_cast<V **>(out));
+  }
+
+  usize
+  contains_batch(const K *keys, usize n, bool *out) const
+  {
+    usize hits = 0;
+    auto *self = const_cast<hopscotch_map *>(this);
+    __impl::__batch_probe(
+        n, [&](usize b, usize m, hash64_t *hs) { hash_batch(keys + b, m, hs); }, [&](hash64_t hsh) { self->__prefetch_home(hsh); },
+        [&](usize i, hash64_t hsh) {
+          out[i] = self->__find_hash(hsh) != nullptr;
+          hits += out[i];
+        });
+    return hits;
+  }
+
   bool
   erase(const K &k)
   {
@@ -30,8 +30,10 @@ namespace micron
 //     length exceeds __treeify_threshold
 //
 // the SoA layout means _hashes[] is contiguous and has no key/value padding so it stays cache-resident for repeated lookups
+//
+// NodeAlloc is handed to the per-bin rb_tree for its nodes, see rb_tree; void keeps them on the global heap
 
-template<typename K, typename V, class Alloc = micron::allocator_serial<>>
+template<typename K, typename V, class Alloc = micron::allocator_serial<>, class NodeAlloc = void>
   requires micron::is_copy_constructible_v<V> and micron::is_move_constructible_v<V>
 class rb_map
 {
@@ -67,7 +69,7 @@ class rb_map
     }
   };
 
-  using __tree_t = rb_tree<__tree_entry>;
+  using __tree_t = rb_tree<__tree_entry, default_less<__tree_entry>, NodeAlloc>;
 
   struct __bin_t {
     i32 list_head;       // -1 = empty when tree == nullptr; ignored otherwise
@@ -853,6 +855,7 @@ public:
   }
 };
 
-template<typename K, typename V, class Alloc = micron::allocator_serial<>> using rmap = rb_map<K, V, Alloc>;
+template<typename K, typename V, class Alloc = micron::allocator_serial<>, class NodeAlloc = void>
+using rmap = rb_map<K, V, Alloc, NodeAlloc>;
 
 };      // namespace micron
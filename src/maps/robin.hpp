@@ -10,6 +10,7 @@
 #include "../simd/intrin.hpp"
 #include "../simd/types.hpp"
 
+#include "../hash/batch.hpp"
 #include "../hash/hash.hpp"
 #include "../memory/actions.hpp"
 #include "../memory/addr.hpp"
@@ -23,6 +24,8 @@
 #include "../type_traits.hpp"
 #include "../types.hpp"
 
+#include "bits.hpp"
+
 namespace micron
 {
 
@@ -380,6 +383,16 @@ class robin_map: public __immutable_memory_resource<Nd, Alloc>
     }
   }
 
+  // home ctrl byte and home node, what probe_find touches first
+  __attribute__((always_inline)) void
+  prefetch_home(hash64_t kh) const noexcept
+  {
+    if ( __builtin_expect(!ctrl_, 0) ) return;
+    const usize index = static_cast<usize>(kh) & mask_;
+    __builtin_prefetch(&ctrl_[index], 0, 3);
+    __builtin_prefetch(node_ptr(index), 0, 3);
+  }
+
   V *
   probe_find(hash64_t kh, const K &orig_key) noexcept
   {
@@ -712,6 +725,47 @@ public:
     return probe_find(hash<hash64_t>(k), k) != nullptr;
   }
 
+  // batched lookups, out[i] = find(keys[i]); returns the number of hits
+  // keys are hashed and their home slots prefetched a group at a time, see __impl::__batch_probe
+  usize
+  find_batch(const K *keys, usize n, V **out)
+  {
+    usize hits = 0;
+    __impl::__batch_probe(
+        n, [&](usize b, usize m, hash64_t *hs) { hash_batch(keys + b, m, hs); }, [&](hash64_t kh) { prefetch_home(kh); },
+        [&](usize i, hash64_t kh) {
+          out[i] = probe_find(kh, keys[i]);
+          hits += out[i] != nullptr;
+        });
+    return hits;
+  }
+
+  usize
+  find_batch(const K *keys, usize n, const V **out) const
+  {
+    usize hits = 0;
+    __impl::__batch_probe(
+        n, [&](usize b, usize m, hash64_t *hs) { hash_batch(keys + b, m, hs); }, [&](hash64_t kh) { prefetch_home(kh); },
+        [&](usize i, hash64_t kh) {
+          out[i] = probe_find(kh, keys[i]);
+          hits += out[i] != nullptr;
+        });
+    return hits;
+  }
+
+  usize
+  contains_batch(const K *keys, usize n, bool *out) const
+  {
+    usize hits = 0;
+    __impl::__batch_probe(
+        n, [&](usize b, usize m, hash64_t *hs) { hash_batch(keys + b, m, hs); }, [&](hash64_t kh) { prefetch_home(kh); },
+        [&](usize i, hash64_t kh) {
+          out[i] = probe_find(kh, keys[i]) != nullptr;
+          hits += out[i];
+        });
+    return hits;
+  }
+
   V &
   at(const K &k)
   {
@@ -0,0 +1,598 @@
+//  Copyright (c) 2024- David Lucius Severus
+//
+//  Distributed under the Boost Software License, Version 1.0.
+//  See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt
+#pragma once
+#include "../bits.hpp"
+#include "../bits/__pause.hpp"
+#include "../hash/hash.hpp"
+#include "../types.hpp"
+
+#include "../atomic/atomic.hpp"
+#include "../except.hpp"
+#include "../memory/cache.hpp"
+#include "../memory/memory.hpp"
+#include "../memory/new.hpp"
+#include "../mutex/epoch.hpp"
+#include "../mutex/locks/guard_lock.hpp"
+#include "../mutex/locks/spin_lock.hpp"
+#include "../type_traits.hpp"
+
+namespace micron
+{
+
+// reclamation policies for seq_conmap
+//
+// a policy provides guard (constructed from the policy, held by a reader for the whole optimistic probe), retire() and quiesce()
+// retire() is called under some segment's writer lock, several segments may retire at once; quiesce() only from
+// seq_conmap::reclaim() and the destructor. tables only grow, a resize driven by tombstones rehashes in place, so the tables
+// retired over a map's life at least halve going backwards and never outweigh the live ones
+
+// default: retired tables go to an epoch_domain, freed once every reader pinned at the time of the retire has left
+template<usize Slots = 128> class seq_epoch_reclaim
+{
+  epoch_domain<Slots> __domain;
+
+public:
+  class guard
+  {
+    typename epoch_domain<Slots>::guard __g;
+
+  public:
+    explicit guard(seq_epoch_reclaim &r) noexcept : __g(r.__domain) { }
+  };
+
+  void
+  retire(void *p, void (*fn)(void *))
+  {
+    __domain.retire(p, fn);
+  }
+
+  // two advances free everything retired before the call, once the readers pinned now have left
+  void
+  quiesce(void)
+  {
+    __domain.collect();
+    __domain.collect();
+  }
+};
+
+// readers never pin, retired tables are parked until quiesce() (or destruction)
+// WARNING: quiesce() frees tables a reader may still be probing, seq_conmap::reclaim() must then only run at a quiescent point
+struct seq_deferred_reclaim {
+  struct guard {
+    explicit guard(seq_deferred_reclaim &) noexcept { }
+  };
+
+  struct __node {
+    __node *next;
+    void *ptr;
+    void (*fn)(void *);
+  };
+
+  spin_lock __lock;
+  __node *__head = nullptr;
+
+  ~seq_deferred_reclaim() { quiesce(); }
+
+  void
+  retire(void *p, void (*fn)(void *))
+  {
+    __node *n = new __node{ nullptr, p, fn };
+    lock_guard<spin_lock> __g(__lock);
+    n->next = __head;
+    __head = n;
+  }
+
+  void
+  quiesce(void)
+  {
+    __node *n = nullptr;
+    {
+      lock_guard<spin_lock> __g(__lock);
+      n = __head;
+      __head = nullptr;
+    }
+    while ( n != nullptr ) {
+      __node *next = n->next;
+      n->fn(n->ptr);
+      delete n;
+      n = next;
+    }
+  }
+};
+
+// seq_conmap
+//
+// resizable concurrent hash map for read-mostly workloads
+// segments are routed like conmap (splitmix64 over the hash), each segment owns an open addressed table, a spin_lock for writers and
+// a seqlock for readers. readers never lock: they pin the Reclaim policy, snapshot the sequence, probe, copy the value out and retry
+// if a writer got in between
+//
+// resizing is incremental and per segment: when a table passes 3/4 load a fresh one is installed, the old one stays readable, and
+// every subsequent write to that segment migrates __migrate_batch slots before doing its own work. lookups consult the new table and
+// then the old one until migration drains it, after which the old table is handed to Reclaim. a table full of tombstones is
+// rehashed in place instead, readers of it simply retry
+//
+// NOTE: K and V must be trivially copyable, readers copy them optimistically and a torn copy is simply discarded
+// THREAD SAFETY: every public op is thread-safe except move and destruction, and reclaim() under seq_deferred_reclaim
+template<typename K, typename V, usize Segments = 64, class Reclaim = seq_epoch_reclaim<>>
+  requires(Segments >= 1 and (Segments & (Segments - 1)) == 0 and micron::is_trivially_copyable_v<K>
+           and micron::is_trivially_copyable_v<V>)
+class seq_conmap
+{
+  static constexpr usize __seg_mask = Segments - 1u;
+  static constexpr usize __cache_line = cache_line_size();
+  static constexpr usize __min_slots = 16;
+  static constexpr usize __migrate_batch = 32;
+  static constexpr u64 __empty = 0;
+  static constexpr u64 __tomb = 1;
+
+  struct __slot {
+    u64 tag;      // __empty, __tomb or the (remapped) full hash
+    K key;
+    V value;
+  };
+
+  struct __table {
+    usize mask;
+    usize used;      // live + tombstones, drives the load check
+    __slot *slots;
+  };
+
+  struct alignas(__cache_line) __segment {
+    atomic_token<u64> seq;      // odd while a writer is inside
+    spin_lock lock;
+    __table *cur;
+    __table *old;      // non-null while migrating
+    usize migrate_pos;
+    usize live;
+
+    __segment() : seq(0), lock(), cur(nullptr), old(nullptr), migrate_pos(0), live(0) { }
+  };
+
+  // raw storage, the read path never needs K/V to be default constructible
+  template<typename T> union __raw {
+    T v;
+
+    __raw() { }
+  };
+
+  __segment __segs[Segments];
+  mutable Reclaim __reclaim;      // readers pin it from const members
+
+  static usize
+  __sid(hash64_t h) noexcept
+  {
+    u64 x = static_cast<u64>(h);
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    x = x ^ (x >> 31);
+    return static_cast<usize>(x) & __seg_mask;
+  }
+
+  [[gnu::always_inline]] static inline u64
+  __tag(hash64_t h) noexcept
+  {
+    return h < 2 ? h + 2 : h;
+  }
+
+  static usize
+  __round_pow2(usize n) noexcept
+  {
+    usize p = __min_slots;
+    while ( p < n ) p <<= 1;
+    return p;
+  }
+
+  static __table *
+  __new_table(usize n_slots)
+  {
+    __table *t = new __table{ n_slots - 1, 0, static_cast<__slot *>(::operator new(sizeof(__slot) * n_slots)) };
+    micron::memset(reinterpret_cast<byte *>(t->slots), 0x0, sizeof(__slot) * n_slots);
+    return t;
+  }
+
+  static void
+  __free_table(void *p)
+  {
+    __table *t = static_cast<__table *>(p);
+    ::operator delete(t->slots);
+    delete t;
+  }
+
+  // seqlock bracket, writers only, under s.lock
+  [[gnu::always_inline]] static inline void
+  __write_begin(__segment &s) noexcept
+  {
+    s.seq.store(s.seq.get(memory_order_relaxed) + 1, memory_order_relaxed);
+    atom::thread_fence(__ATOMIC_RELEASE);
+  }
+
+  [[gnu::always_inline]] static inline void
+  __write_end(__segment &s) noexcept
+  {
+    s.seq.store(s.seq.get(memory_order_relaxed) + 1, memory_order_release);
+  }
+
+  // optimistic probe, may observe a half written slot; the caller validates the sequence
+  static bool
+  __read_probe(const __table *t, u64 tg, const K &k, __raw<V> &out) noexcept
+  {
+    const usize mask = atom::load(&t->mask, __ATOMIC_RELAXED);
+    usize i = static_cast<usize>(tg) & mask;
+    for ( usize n = 0; n <= mask; ++n, i = (i + 1) & mask ) {
+      const __slot &sl = t->slots[i];
+      const u64 st = atom::load(&sl.tag, __ATOMIC_RELAXED);
+      if ( st == __empty ) return false;
+      if ( st != tg ) continue;
+      __raw<K> kc;
+      micron::bytecpy(reinterpret_cast<byte *>(&kc.v), reinterpret_cast<const byte *>(&sl.key), sizeof(K));
+      if ( kc.v == k ) {
+        micron::bytecpy(reinterpret_cast<byte *>(&out.v), reinterpret_cast<const byte *>(&sl.value), sizeof(V));
+        return true;
+      }
+    }
+    return false;
+  }
+
+  // exact probe, writers only
+  static __slot *
+  __find_slot(__table *t, u64 tg, const K &k) noexcept
+  {
+    usize i = static_cast<usize>(tg) & t->mask;
+    for ( usize n = 0; n <= t->mask; ++n, i = (i + 1) & t->mask ) {
+      __slot &sl = t->slots[i];
+      if ( sl.tag == __empty ) return nullptr;
+      if ( sl.tag == tg and sl.key == k ) return &sl;
+    }
+    return nullptr;
+  }
+
+  // precondition: k not present in t, t below 3/4 load
+  static void
+  __place(__table *t, u64 tg, const K &k, const V &v) noexcept
+  {
+    usize i = static_cast<usize>(tg) & t->mask;
+    while ( t->slots[i].tag > __tomb ) i = (i + 1) & t->mask;
+    __slot &sl = t->slots[i];
+    if ( sl.tag == __empty ) ++t->used;
+    micron::bytecpy(reinterpret_cast<byte *>(&sl.key), reinterpret_cast<const byte *>(&k), sizeof(K));
+    micron::bytecpy(reinterpret_cast<byte *>(&sl.value), reinterpret_cast<const byte *>(&v), sizeof(V));
+    atom::store(&sl.tag, tg, __ATOMIC_RELAXED);
+  }
+
+  // moves up to `budget` old slots into cur, retires the old table once drained
+  void
+  __migrate(__segment &s, usize budget)
+  {
+    __table *o = s.old;
+    if ( o == nullptr ) return;
+    const usize n_slots = o->mask + 1;
+    for ( ; budget > 0 and s.migrate_pos < n_slots; --budget, ++s.migrate_pos ) {
+      __slot &sl = o->slots[s.migrate_pos];
+      if ( sl.tag <= __tomb ) continue;
+      __place(s.cur, sl.tag, sl.key, sl.value);
+      atom::store(&sl.tag, __tomb, __ATOMIC_RELAXED);      // a later erase from cur must not resurrect this copy
+    }
+    if ( s.migrate_pos == n_slots ) {
+      atom::store(&s.old, static_cast<__table *>(nullptr), __ATOMIC_RELAXED);
+      __reclaim.retire(o, &__free_table);
+    }
+  }
+
+  // cur without its tombstones, an unfinished migration's leftovers folded in; the caller knows everything fits at half load
+  void
+  __rehash(__segment &s)
+  {
+    __table *t = s.cur;
+    __table *o = s.old;
+    usize n = 0;
+    for ( usize i = 0; i <= t->mask; ++i ) n += t->slots[i].tag > __tomb;
+    if ( o != nullptr )
+      for ( usize i = s.migrate_pos; i <= o->mask; ++i ) n += o->slots[i].tag > __tomb;
+
+    // private copy, no reader ever sees it
+    __slot *keep = static_cast<__slot *>(::operator new(sizeof(__slot) * (n ? n : 1u)));
+    usize m = 0;
+    auto take = [&](const __table *x, usize from) {
+      for ( usize i = from; i <= x->mask; ++i )
+        if ( x->slots[i].tag > __tomb )
+          micron::bytecpy(reinterpret_cast<byte *>(&keep[m++]), reinterpret_cast<const byte *>(&x->slots[i]), sizeof(__slot));
+    };
+    take(t, 0);
+    if ( o != nullptr ) {
+      take(o, s.migrate_pos);
+      atom::store(&s.old, static_cast<__table *>(nullptr), __ATOMIC_RELAXED);
+      __reclaim.retire(o, &__free_table);
+    }
+    s.migrate_pos = 0;
+    for ( usize i = 0; i <= t->mask; ++i ) atom::store(&t->slots[i].tag, __empty, __ATOMIC_RELAXED);
+    t->used = 0;
+    for ( usize i = 0; i < m; ++i ) __place(t, keep[i].tag, keep[i].key, keep[i].value);
+    ::operator delete(keep);
+  }
+
+  // called before an insert; once cur passes 3/4 it either grows (and starts a migration) or, when tombstones are what filled
+  // it, is rehashed in place. a table is never replaced by one of its own size or smaller
+  void
+  __reserve_one(__segment &s)
+  {
+    const usize n_slots = s.cur->mask + 1;
+    if ( (s.cur->used + 1) * 4 <= n_slots * 3 ) return;
+    const usize want = __round_pow2((s.live + 1) * 2);
+    if ( want <= n_slots ) {
+      __rehash(s);
+      return;
+    }
+    __table *fresh = __new_table(want);
+    __table *o = s.old;
+    if ( o != nullptr ) {
+      // previous resize never drained, its leftovers go straight into the new table (cur may not have room for them)
+      for ( ; s.migrate_pos <= o->mask; ++s.migrate_pos ) {
+        const __slot &sl = o->slots[s.migrate_pos];
+        if ( sl.tag > __tomb ) __place(fresh, sl.tag, sl.key, sl.value);
+      }
+    }
+    s.migrate_pos = 0;
+    atom::store(&s.old, s.cur, __ATOMIC_RELAXED);
+    atom::store(&s.cur, fresh, __ATOMIC_RELAXED);
+    // only once unlinked, a reader that pins from here on can no longer reach it
+    if ( o != nullptr ) __reclaim.retire(o, &__free_table);
+  }
+
+  template<typename Fn>
+  [[gnu::always_inline]] inline auto
+  __read(hash64_t h, Fn &&fn) const noexcept
+  {
+    const __segment &s = __segs[__sid(h)];
+    const typename Reclaim::guard __g(__reclaim);      // pins every table the probe can still reach
+    for ( ;; ) {
+      const u64 s1 = s.seq.get(memory_order_acquire);
+      if ( s1 & 1 ) [[unlikely]] {
+        __cpu_pause();
+        continue;
+      }
+      auto r = fn(atom::load(&s.cur, __ATOMIC_RELAXED), atom::load(&s.old, __ATOMIC_RELAXED));
+      atom::thread_fence(__ATOMIC_ACQUIRE);
+      if ( s.seq.get(memory_order_relaxed) == s1 ) [[likely]]
+        return r;
+    }
+  }
+
+public:
+  using category_type = map_tag;
+  using mutability_type = mutable_tag;
+  using memory_type = heap_tag;
+  using size_type = usize;
+  using key_type = K;
+  using mapped_type = V;
+
+  ~seq_conmap()
+  {
+    for ( usize i = 0; i < Segments; ++i ) {
+      if ( __segs[i].cur ) __free_table(__segs[i].cur);
+      if ( __segs[i].old ) __free_table(__segs[i].old);
+      __segs[i].cur = __segs[i].old = nullptr;
+    }
+  }
+
+  seq_conmap(const seq_conmap &) = delete;
+  seq_conmap(seq_conmap &&) = delete;
+  seq_conmap &operator=(const seq_conmap &) = delete;
+  seq_conmap &operator=(seq_conmap &&) = delete;
+
+  explicit seq_conmap(usize initial_capacity = Segments * 16u)
+  {
+    const usize per = __round_pow2((initial_capacity / Segments) * 4 / 3 + 1);
+    for ( usize i = 0; i < Segments; ++i ) __segs[i].cur = __new_table(per);
+  }
+
+  static constexpr usize
+  segment_count() noexcept
+  {
+    return Segments;
+  }
+
+  // approximate under concurrent mutation
+  usize
+  size() const noexcept
+  {
+    usize total = 0;
+    for ( usize i = 0; i < Segments; ++i ) total += atom::load(&__segs[i].live, __ATOMIC_RELAXED);
+    return total;
+  }
+
+  bool
+  empty() const noexcept
+  {
+    return size() == 0;
+  }
+
+  // lock-free, out is only written on a hit
+  bool
+  find(const K &k, V &out) const noexcept
+  {
+    const hash64_t h = hash<hash64_t>(k);
+    const u64 tg = __tag(h);
+    __raw<V> tmp;
+    const bool hit = __read(h, [&](const __table *cur, const __table *old) {
+      return __read_probe(cur, tg, k, tmp) or (old != nullptr and __read_probe(old, tg, k, tmp));
+    });
+    if ( hit ) out = tmp.v;
+    return hit;
+  }
+
+  bool
+  contains(const K &k) const noexcept
+  {
+    const hash64_t h = hash<hash64_t>(k);
+    const u64 tg = __tag(h);
+    __raw<V> tmp;
+    return __read(h, [&](const __table *cur, const __table *old) {
+      return __read_probe(cur, tg, k, tmp) or (old != nullptr and __read_probe(old, tg, k, tmp));
+    });
+  }
+
+  usize
+  count(const K &k) const noexcept
+  {
+    return contains(k) ? 1u : 0u;
+  }
+
+  V
+  at(const K &k) const
+  {
+    const hash64_t h = hash<hash64_t>(k);
+    const u64 tg = __tag(h);
+    __raw<V> tmp;
+    const bool hit = __read(h, [&](const __table *cur, const __table *old) {
+      return __read_probe(cur, tg, k, tmp) or (old != nullptr and __read_probe(old, tg, k, tmp));
+    });
+    if ( !hit ) [[unlikely]]
+      exc<except::library_error>("micron::seq_conmap at() key not found");
+    return tmp.v;
+  }
+
+  // returns true if k was newly inserted
+  bool
+  insert_or_assign(const K &k, const V &v)
+  {
+    const hash64_t h = hash<hash64_t>(k);
+    const u64 tg = __tag(h);
+    __segment &s = __segs[__sid(h)];
+    lock_guard<spin_lock> __g(s.lock);
+    __write_begin(s);
+    __migrate(s, __migrate_batch);
+    if ( __slot *p = __find_slot(s.cur, tg, k) ) {
+      micron::bytecpy(reinterpret_cast<byte *>(&p->value), reinterpret_cast<const byte *>(&v), sizeof(V));
+      __write_end(s);
+      return false;
+    }
+    bool newly = true;
+    if ( s.old != nullptr ) {
+      if ( __slot *q = __find_slot(s.old, tg, k) ) {
+        atom::store(&q->tag, __tomb, __ATOMIC_RELAXED);
+        newly = false;
+      }
+    }
+    __reserve_one(s);
+    __place(s.cur, tg, k, v);
+    if ( newly ) atom::store(&s.live, s.live + 1, __ATOMIC_RELAXED);
+    __write_end(s);
+    return newly;
+  }
+
+  // inserts only if absent, returns true if it did
+  bool
+  insert(const K &k, const V &v)
+  {
+    const hash64_t h = hash<hash64_t>(k);
+    const u64 tg = __tag(h);
+    __segment &s = __segs[__sid(h)];
+    lock_guard<spin_lock> __g(s.lock);
+    __write_begin(s);
+    __migrate(s, __migrate_batch);
+    if ( __find_slot(s.cur, tg, k) != nullptr or (s.old != nullptr and __find_slot(s.old, tg, k) != nullptr) ) {
+      __write_end(s);
+      return false;
+    }
+    __reserve_one(s);
+    __place(s.cur, tg, k, v);
+    atom::store(&s.live, s.live + 1, __ATOMIC_RELAXED);
+    __write_end(s);
+    return true;
+  }
+
+  bool
+  erase(const K &k)
+  {
+    const hash64_t h = hash<hash64_t>(k);
+    const u64 tg = __tag(h);
+    __segment &s = __segs[__sid(h)];
+    lock_guard<spin_lock> __g(s.lock);
+    __write_begin(s);
+    __migrate(s, __migrate_batch);
+    __slot *p = __find_slot(s.cur, tg, k);
+    if ( p == nullptr and s.old != nullptr ) p = __find_slot(s.old, tg, k);
+    if ( p != nullptr ) {
+      atom::store(&p->tag, __tomb, __ATOMIC_RELAXED);
+      atom::store(&s.live, s.live - 1, __ATOMIC_RELAXED);
+    }
+    __write_end(s);
+    return p != nullptr;
+  }
+
+  // fn(V&) under the segment's writer lock
+  template<typename Fn>
+  bool
+  update(const K &k, Fn &&fn)
+  {
+    const hash64_t h = hash<hash64_t>(k);
+    const u64 tg = __tag(h);
+    __segment &s = __segs[__sid(h)];
+    lock_guard<spin_lock> __g(s.lock);
+    __write_begin(s);
+    __slot *p = __find_slot(s.cur, tg, k);
+    if ( p == nullptr and s.old != nullptr ) p = __find_slot(s.old, tg, k);
+    if ( p != nullptr ) fn(p->value);
+    __write_end(s);
+    return p != nullptr;
+  }
+
+  void
+  clear()
+  {
+    for ( usize i = 0; i < Segments; ++i ) {
+      __segment &s = __segs[i];
+      lock_guard<spin_lock> __g(s.lock);
+      __write_begin(s);
+      if ( __table *o = s.old ) {
+        atom::store(&s.old, static_cast<__table *>(nullptr), __ATOMIC_RELAXED);
+        __reclaim.retire(o, &__free_table);
+      }
+      for ( usize j = 0; j <= s.cur->mask; ++j ) atom::store(&s.cur->slots[j].tag, __empty, __ATOMIC_RELAXED);
+      s.cur->used = 0;
+      atom::store(&s.live, usize{ 0 }, __ATOMIC_RELAXED);
+      __write_end(s);
+    }
+  }
+
+  // fn(const K&, const V&), one segment locked at a time
+  template<typename Fn>
+  void
+  for_each(Fn &&fn) const
+  {
+    for ( usize i = 0; i < Segments; ++i ) {
+      __segment &s = const_cast<__segment &>(__segs[i]);
+      lock_guard<spin_lock> __g(s.lock);
+      const __table *tables[2] = { s.cur, s.old };
+      for ( const __table *t : tables ) {
+        if ( t == nullptr ) continue;
+        for ( usize j = 0; j <= t->mask; ++j )
+          if ( t->slots[j].tag > __tomb ) fn(static_cast<const K &>(t->slots[j].key), static_cast<const V &>(t->slots[j].value));
+      }
+    }
+  }
+
+  // slots currently allocated across all live tables
+  usize
+  capacity() const noexcept
+  {
+    const typename Reclaim::guard __g(__reclaim);
+    usize total = 0;
+    for ( usize i = 0; i < Segments; ++i ) total += atom::load(&__segs[i].cur, __ATOMIC_RELAXED)->mask + 1;
+    return total;
+  }
+
+  // hands every retired table to Reclaim::quiesce()
+  // WARNING: with seq_deferred_reclaim only at a quiescent point, no reader may be inside the map
+  void
+  reclaim()
+  {
+    __reclaim.quiesce();
+  }
+};
+
+};      // namespace micron
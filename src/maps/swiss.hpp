@@ -48,11 +48,114 @@ struct __mask {
   }
 };
 
+// match bits for one control group, one bit per slot; 64-bit storage once the group outgrows 32 slots
+template<typename B> struct __group_mask {
+  B bits;
+
+  explicit __group_mask(B b) : bits(b) { }
+
+  bool
+  any() const
+  {
+    return bits != 0;
+  }
+
+  int
+  lowest() const
+  {
+    return countr_zero(bits);
+  }
+
+  void
+  clear_lowest()
+  {
+    bits &= bits - 1;
+  }
+
+  explicit
+  operator bool() const
+  {
+    return any();
+  }
+};
+
+// widest group the build's ISA compares in one instruction
+#if defined(__micron_x86_avx512bw)
+constexpr usize __swiss_native_group = 64;
+#elif defined(__micron_x86_avx2)
+constexpr usize __swiss_native_group = 32;
+#else
+constexpr usize __swiss_native_group = 16;
+#endif
+
+// control-byte group compare, G slots per probe step
+// 16 is SSE2/NEON/scalar, 32 one AVX2 compare + movemask, 64 one AVX-512BW compare into a mask register
+// widths the ISA lacks are stitched from narrower compares so every width works on every build
+template<usize G>
+  requires(G == 16 or G == 32 or G == 64)
+struct __swiss_group {
+  using bits_type = micron::conditional_t<(G > 32), u64, u32>;
+  using mask_type = __group_mask<bits_type>;
+
+  static bits_type
+  eq(const u8 *p, u8 v) noexcept
+  {
+    if constexpr ( G == 64 ) {
+#if defined(__micron_x86_avx512bw)
+      return static_cast<u64>(simd::avx512::eq_mask_i8(simd::avx512::loadu_i512(p), simd::avx512::splat_i8(static_cast<char>(v))));
+#else
+      return static_cast<u64>(__swiss_group<32>::eq(p, v)) | (static_cast<u64>(__swiss_group<32>::eq(p + 32, v)) << 32);
+#endif
+    } else if constexpr ( G == 32 ) {
+#if defined(__micron_x86_avx2)
+      __m256i c = simd::avx::loadu_i256(reinterpret_cast<const __m256i_u *>(p));
+      return static_cast<u32>(simd::avx2::movemask_i8(simd::avx2::eq_i8(c, simd::avx::splat_i8(static_cast<char>(v)))));
+#else
+      return __swiss_group<16>::eq(p, v) | (__swiss_group<16>::eq(p + 16, v) << 16);
+#endif
+    } else {
+#if defined(__micron_arch_x86_any)
+      simd::i128 c = simd::sse::loadu_i128(reinterpret_cast<const __m128i_u *>(p));
+      return static_cast<u32>(static_cast<u16>(simd::sse::movemask_i8(simd::sse::eq_i8(c, simd::sse::splat_i8(static_cast<char>(v))))));
+#elif defined(__micron_arm_neon)
+      return static_cast<u32>(simd::neon::movemask_u8(simd::neon::eq(simd::neon::load_u8(p), simd::neon::splat_u8(v))));
+#else
+      u32 r = 0;
+      for ( usize i = 0; i < 16; ++i )
+        if ( p[i] == v ) r |= (1u << i);
+      return r;
+#endif
+    }
+  }
+
+  static mask_type
+  match(const u8 *p, u8 h2) noexcept
+  {
+    return mask_type(eq(p, h2));
+  }
+
+  static mask_type
+  match_empty(const u8 *p) noexcept
+  {
+    return mask_type(eq(p, __empty));
+  }
+
+  static mask_type
+  match_empty_or_deleted(const u8 *p) noexcept
+  {
+    return mask_type(eq(p, __empty) | eq(p, __deleted));
+  }
+};
+
 // NH = probe-window cap (number of slots scanned from a key's home)
-template<typename K, typename V, usize N, usize NH = N>
-  requires(N >= 16 and (N % 16) == 0 and NH <= N)
+// G = control bytes compared per probe step, see __swiss_group
+template<typename K, typename V, usize N, usize NH = N, usize G = 16>
+  requires(N >= G and (N % G) == 0 and NH <= N)
 class stack_swiss_map
 {
+  using __grp = __swiss_group<G>;
+  using __gmask = typename __grp::mask_type;
+
   static constexpr u8
   __h2(hash64_t h)
   {
@@ -87,70 +190,23 @@ class stack_swiss_map
     return __h1(k) % N;
   }
 
-  __mask
+  __gmask
   __match(u8 hash_val, usize ind) const
   {
-    // NOTE: must be unaligned load, no guarantee ind will always be aligned
-#if defined(__micron_arch_x86_any)
-    simd::i128 match = simd::sse::splat_i8(static_cast<char>(hash_val));
-    simd::i128 meta = simd::sse::loadu_i128(reinterpret_cast<const __m128i_u *>(&__control_bytes[ind]));
-    int mask = simd::sse::movemask_i8(simd::sse::eq_i8(match, meta));
-    return __mask(mask);
-#elif defined(__micron_arm_neon)
-    uint8x16_t match = simd::neon::splat_u8(hash_val);
-    uint8x16_t meta = simd::neon::load_u8(&__control_bytes[ind]);
-    return __mask(static_cast<i32>(simd::neon::movemask_u8(simd::neon::eq(meta, match))));
-#else
-    i32 mask = 0;
-    for ( usize i = 0; i < 16; ++i )
-      if ( __control_bytes[ind + i] == hash_val ) mask |= (1 << i);
-    return __mask(mask);
-#endif
+    // NOTE: unaligned load, no guarantee ind will always be aligned
+    return __grp::match(&__control_bytes[ind], hash_val);
   }
 
-  __mask
+  __gmask
   __match_empty(usize ind) const
   {
-#if defined(__micron_arch_x86_any)
-    simd::i128 empty = simd::sse::splat_i8(static_cast<char>(__empty));
-    simd::i128 meta = simd::sse::loadu_i128(reinterpret_cast<const __m128i_u *>(&__control_bytes[ind]));
-    int mask = simd::sse::movemask_i8(simd::sse::eq_i8(empty, meta));
-    return __mask(mask);
-#elif defined(__micron_arm_neon)
-    uint8x16_t empty = simd::neon::splat_u8(__empty);
-    uint8x16_t meta = simd::neon::load_u8(&__control_bytes[ind]);
-    return __mask(static_cast<i32>(simd::neon::movemask_u8(simd::neon::eq(empty, meta))));
-#else
-    i32 mask = 0;
-    for ( usize i = 0; i < 16; ++i )
-      if ( __control_bytes[ind + i] == __empty ) mask |= (1 << i);
-    return __mask(mask);
-#endif
+    return __grp::match_empty(&__control_bytes[ind]);
   }
 
-  __mask
+  __gmask
   __match_empty_or_deleted(usize ind) const
   {
-#if defined(__micron_arch_x86_any)
-    simd::i128 meta = simd::sse::loadu_i128(reinterpret_cast<const __m128i_u *>(&__control_bytes[ind]));
-    simd::i128 empty = simd::sse::splat_i8(static_cast<char>(__empty));
-    simd::i128 deleted = simd::sse::splat_i8(static_cast<char>(__deleted));
-    int mask = simd::sse::movemask_i8(simd::sse::or_i128(simd::sse::eq_i8(meta, empty), simd::sse::eq_i8(meta, deleted)));
-    return __mask(mask);
-#elif defined(__micron_arm_neon)
-    uint8x16_t meta = simd::neon::load_u8(&__control_bytes[ind]);
-    uint8x16_t empty = simd::neon::splat_u8(__empty);
-    uint8x16_t deleted = simd::neon::splat_u8(__deleted);
-    uint8x16_t combined = simd::neon::or_(simd::neon::eq(meta, empty), simd::neon::eq(meta, deleted));
-    return __mask(static_cast<i32>(simd::neon::movemask_u8(combined)));
-#else
-    i32 mask = 0;
-    for ( usize i = 0; i < 16; ++i ) {
-      u8 c = __control_bytes[ind + i];
-      if ( c == __empty || c == __deleted ) mask |= (1 << i);
-    }
-    return __mask(mask);
-#endif
+    return __grp::match_empty_or_deleted(&__control_bytes[ind]);
   }
 
   template<typename KK, typename VV>
@@ -169,11 +225,11 @@ class stack_swiss_map
     u8 h2 = __hash(key);
     usize start = __b_index(key);
 
-    for ( usize i = 0; i < NH; i += 16 ) {
+    for ( usize i = 0; i < NH; i += G ) {
       usize group_start = (start + i) % N;
 
-      if ( group_start + 16 <= N ) {
-        __mask m = __match_empty_or_deleted(group_start);
+      if ( group_start + G <= N ) {
+        __gmask m = __match_empty_or_deleted(group_start);
         if ( m.any() ) {
           usize probe = group_start + m.lowest();
           __control_bytes[probe] = h2;
@@ -182,7 +238,7 @@ class stack_swiss_map
           return { true, micron::addressof(__entries[probe].value) };
         }
       } else {
-        for ( usize j = 0; j < 16 && i + j < NH; ++j ) {
+        for ( usize j = 0; j < G && i + j < NH; ++j ) {
           usize probe = (start + i + j) % N;
           if ( __control_bytes[probe] == __empty || __control_bytes[probe] == __deleted ) {
             __control_bytes[probe] = h2;
@@ -214,11 +270,11 @@ class stack_swiss_map
     u8 h2 = __h2(key);
     usize start = __b_index_key(key);
 
-    for ( usize i = 0; i < NH; i += 16 ) {
+    for ( usize i = 0; i < NH; i += G ) {
       usize group_start = (start + i) % N;
 
-      if ( group_start + 16 <= N ) {
-        __mask m = __match_empty_or_deleted(group_start);
+      if ( group_start + G <= N ) {
+        __gmask m = __match_empty_or_deleted(group_start);
         if ( m.any() ) {
           usize probe = group_start + m.lowest();
           __control_bytes[probe] = h2;
@@ -228,7 +284,7 @@ class stack_swiss_map
           return { true, micron::addressof(__entries[probe].value) };
         }
       } else {
-        for ( usize j = 0; j < 16 && i + j < NH; ++j ) {
+        for ( usize j = 0; j < G && i + j < NH; ++j ) {
           usize probe = (start + i + j) % N;
           if ( __control_bytes[probe] == __empty || __control_bytes[probe] == __deleted ) {
             __control_bytes[probe] = h2;
@@ -262,7 +318,7 @@ public:
     __swiss_entry(K &&k, V &&v) : key(micron::move(k)), value(micron::move(v)) { }
   };
 
-  alignas(16) u8 __control_bytes[N];
+  alignas(G) u8 __control_bytes[N];
   __swiss_entry __entries[N];
   usize __size = 0;
 
@@ -423,11 +479,11 @@ public:
     usize start = __b_index(key);
 
     // first pass: check for existing key and overwrite
-    for ( usize i = 0; i < NH; i += 16 ) {
+    for ( usize i = 0; i < NH; i += G ) {
       usize group_start = (start + i) % N;
 
-      if ( group_start + 16 <= N ) {
-        __mask m = __match(h2, group_start);
+      if ( group_start + G <= N ) {
+        __gmask m = __match(h2, group_start);
         while ( m.any() ) {
           usize probe = group_start + m.lowest();
           if ( __entries[probe].key == key ) {
@@ -438,7 +494,7 @@ public:
         }
         if ( __match_empty(group_start).any() ) break;
       } else {
-        for ( usize j = 0; j < 16 && i + j < NH; ++j ) {
+        for ( usize j = 0; j < G && i + j < NH; ++j ) {
           usize probe = (start + i + j) % N;
           if ( __control_bytes[probe] == h2 && __entries[probe].key == key ) {
             __entries[probe].value = micron::forward<VV>(value);
@@ -453,11 +509,11 @@ public:
     if ( __size >= N ) return { false, nullptr };
 
     // second pass: find first empty or deleted slot
-    for ( usize i = 0; i < NH; i += 16 ) {
+    for ( usize i = 0; i < NH; i += G ) {
       usize group_start = (start + i) % N;
 
-      if ( group_start + 16 <= N ) {
-        __mask m = __match_empty_or_deleted(group_start);
+      if ( group_start + G <= N ) {
+        __gmask m = __match_empty_or_deleted(group_start);
         if ( m.any() ) {
           usize probe = group_start + m.lowest();
           __control_bytes[probe] = h2;
@@ -466,7 +522,7 @@ public:
           return { true, micron::addressof(__entries[probe].value) };
         }
       } else {
-        for ( usize j = 0; j < 16 && i + j < NH; ++j ) {
+        for ( usize j = 0; j < G && i + j < NH; ++j ) {
           usize probe = (start + i + j) % N;
           if ( __control_bytes[probe] == __empty || __control_bytes[probe] == __deleted ) {
             __control_bytes[probe] = h2;
@@ -497,11 +553,11 @@ public:
     u8 h2 = __hash(key);
     usize start = __b_index(key);
 
-    for ( usize i = 0; i < NH; i += 16 ) {
+    for ( usize i = 0; i < NH; i += G ) {
       usize group_start = (start + i) % N;
 
-      if ( group_start + 16 <= N ) {
-        __mask m = __match_empty_or_deleted(group_start);
+      if ( group_start + G <= N ) {
+        __gmask m = __match_empty_or_deleted(group_start);
         if ( m.any() ) {
           usize probe = group_start + m.lowest();
           __control_bytes[probe] = h2;
@@ -511,7 +567,7 @@ public:
           return { true, micron::addressof(__entries[probe].value) };
         }
       } else {
-        for ( usize j = 0; j < 16 && i + j < NH; ++j ) {
+        for ( usize j = 0; j < G && i + j < NH; ++j ) {
           usize probe = (start + i + j) % N;
           if ( __control_bytes[probe] == __empty || __control_bytes[probe] == __deleted ) {
             __control_bytes[probe] = h2;
@@ -533,11 +589,11 @@ public:
     u8 h2 = __hash(key);
     usize start = __b_index(key);
 
-    for ( usize i = 0; i < NH; i += 16 ) {
+    for ( usize i = 0; i < NH; i += G ) {
       usize group_start = (start + i) % N;
 
-      if ( group_start + 16 <= N ) {
-        __mask m = __match(h2, group_start);
+      if ( group_start + G <= N ) {
+        __gmask m = __match(h2, group_start);
         while ( m.any() ) {
           usize probe = group_start + m.lowest();
           if ( __entries[probe].key == key ) {
@@ -549,7 +605,7 @@ public:
         }
         if ( __match_empty(group_start).any() ) return false;      // first empty -> key absent (see find)
       } else {
-        for ( usize j = 0; j < 16 && i + j < NH; ++j ) {
+        for ( usize j = 0; j < G && i + j < NH; ++j ) {
           usize probe = (start + i + j) % N;
           if ( __control_bytes[probe] == h2 && __entries[probe].key == key ) {
             __control_bytes[probe] = __deleted;
@@ -570,11 +626,11 @@ public:
     u8 h2 = __hash(key);
     usize start = __b_index(key);
 
-    for ( usize i = 0; i < NH; i += 16 ) {
+    for ( usize i = 0; i < NH; i += G ) {
       usize group_start = (start + i) % N;
 
-      if ( group_start + 16 <= N ) {
-        __mask m = __match(h2, group_start);
+      if ( group_start + G <= N ) {
+        __gmask m = __match(h2, group_start);
         while ( m.any() ) {
           usize probe = group_start + m.lowest();
           if ( __entries[probe].key == key ) {
@@ -586,7 +642,7 @@ public:
         // probe sequence, so an empty group means the key is absent -> stop here
         if ( __match_empty(group_start).any() ) return nullptr;
       } else {
-        for ( usize j = 0; j < 16 && i + j < NH; ++j ) {
+        for ( usize j = 0; j < G && i + j < NH; ++j ) {
           usize probe = (start + i + j) % N;
           if ( __control_bytes[probe] == h2 && __entries[probe].key == key ) {
             return micron::addressof(__entries[probe].value);
@@ -613,11 +669,11 @@ public:
     u8 h2 = __h2(key);
     usize start = __b_index_key(key);
 
-    for ( usize i = 0; i < NH; i += 16 ) {
+    for ( usize i = 0; i < NH; i += G ) {
       usize group_start = (start + i) % N;
 
-      if ( group_start + 16 <= N ) {
-        __mask m = __match(h2, group_start);
+      if ( group_start + G <= N ) {
+        __gmask m = __match(h2, group_start);
         while ( m.any() ) {
           usize probe = group_start + m.lowest();
           if ( __entries[probe].key == key ) {
@@ -629,7 +685,7 @@ public:
         // probe sequence, so an empty group means the key is absent -> stop here
         if ( __match_empty(group_start).any() ) return nullptr;
       } else {
-        for ( usize j = 0; j < 16 && i + j < NH; ++j ) {
+        for ( usize j = 0; j < G && i + j < NH; ++j ) {
           usize probe = (start + i + j) % N;
           if ( __control_bytes[probe] == h2 && __entries[probe].key == key ) {
             return micron::addressof(__entries[probe].value);
@@ -875,4 +931,7 @@ public:
 };
 
 template<typename K, typename V, usize N, usize NH = 16> using swiss = stack_swiss_map<K, V, N, NH>;
+// same 16-slot probe window as swiss, only the group compare widens; a window under one group still scans that whole
+// group from the home slot (the wrapped tail stops at NH)
+template<typename K, typename V, usize N, usize NH = 16> using swiss_wide = stack_swiss_map<K, V, N, NH, __swiss_native_group>;
 }      // namespace micron
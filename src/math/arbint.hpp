@@ -38,6 +38,7 @@
 #include "arbint/mul_toom.hpp"
 #include "arbint/number.hpp"
 #include "arbint/powm.hpp"
+#include "arbint/powm_batch.hpp"
 #include "arbint/signed.hpp"
 #include "arbint/storage.hpp"
 #include "arbint/tags.hpp"
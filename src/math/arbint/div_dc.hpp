@@ -91,6 +91,13 @@ div_wants_dc(usize nn, usize dn) noexcept
   return static_cast<u8>(clamp_to(pick_div(nn, dn), div_tier_cap)) >= static_cast<u8>(divalgo::dc) && dn >= 6u && nn > dn;
 }
 
+// whether any tuning table could run dc here; scratch is sized by this, never by the active table
+[[nodiscard, gnu::always_inline]] inline constexpr bool
+div_may_dc(usize nn, usize dn) noexcept
+{
+  return static_cast<u8>(div_tier_cap) >= static_cast<u8>(divalgo::dc) && dn >= threshold::lowest.div_dc && dn >= 6u && nn > dn;
+}
+
 };      // namespace mpn
 };      // namespace math
 };      // namespace micron
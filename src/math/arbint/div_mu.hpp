@@ -284,7 +284,7 @@ mu_div_qr_itch(usize nn, usize dn) noexcept
   if ( m > w ) w = m;
   const usize e = mul_itch(in, in);
   if ( e > w ) w = e;
-  if ( (qn % in) != 0 && div_wants_dc(qn % in + dn, dn) ) {
+  if ( (qn % in) != 0 && div_may_dc(qn % in + dn, dn) ) {
     const usize t = dc_div_itch(dn);
     if ( t > w ) w = t;
   }
@@ -297,6 +297,13 @@ div_wants_mu(usize nn, usize dn) noexcept
   return static_cast<u8>(clamp_to(pick_div(nn, dn), div_tier_cap)) >= static_cast<u8>(divalgo::mu) && dn >= 2u && nn > dn;
 }
 
+[[nodiscard, gnu::always_inline]] inline constexpr bool
+div_may_mu(usize nn, usize dn) noexcept
+{
+  return static_cast<u8>(div_tier_cap) >= static_cast<u8>(divalgo::mu) && dn >= threshold::lowest.div_mu && (nn - dn) >= dn && dn >= 2u
+         && nn > dn;
+}
+
 inline constexpr divalgo div_tiers_built = divalgo::mu;
 
 static_assert(static_cast<u8>(div_tier_cap) <= static_cast<u8>(div_tiers_built),
@@ -306,12 +313,13 @@ static_assert(static_cast<u8>(div_tier_cap) <= static_cast<u8>(div_tiers_built),
 divrem_itch(usize nn, usize dn) noexcept
 {
   if ( dn <= 1 ) return 0;
-  usize t = nn + 1u + dn;
-  if ( div_wants_mu(nn + 1u, dn) )
-    t += mu_div_qr_itch(nn + 1u, dn);
-  else if ( div_wants_dc(nn + 1u, dn) )
-    t += dc_div_itch(dn);
-  return t;
+  // the active table picks at run time, cover every tier one could pick
+  usize w = div_may_mu(nn + 1u, dn) ? mu_div_qr_itch(nn + 1u, dn) : 0u;
+  if ( div_may_dc(nn + 1u, dn) ) {
+    const usize d = dc_div_itch(dn);
+    if ( d > w ) w = d;
+  }
+  return nn + 1u + dn + w;
 }
 
 // qp: nn - dn + 1 limbs, rp: dn limbs, scratch: divrem_itch(nn, dn) limbs
@@ -10,6 +10,7 @@
 #include "mpn_core.hpp"
 #include "mul_basecase.hpp"
 #include "mul_karatsuba.hpp"
+#include "mul_ntt.hpp"
 #include "mul_toom.hpp"
 #include "mul_toom4.hpp"
 #include "tags.hpp"
@@ -18,7 +19,11 @@
 // ^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^
 // multiplication ladder
 //
-// TODO: toom/nussbaumer still not implemented (in part/full)
+// basecase -> comba -> karatsuba -> toom-3 -> toom-4 -> FFT; the FFT tier keeps its algo::nussbaumer slot but is
+// filled by the three-prime NTT of mul_ntt.hpp, on 64-bit limbs only
+//
+// mul() / sqr() pick the tier and the karatsuba cutoff off the active tuning table (tuning.hpp); the toom recursions
+// keep the compiled cutoffs. the itch functions size for threshold::lowest, so any table fits the same scratch
 
 namespace micron
 {
@@ -27,7 +32,11 @@ namespace math
 namespace mpn
 {
 
+#if defined(__micron_arch_width_64)
+inline constexpr algo tiers_built = algo::nussbaumer;
+#else
 inline constexpr algo tiers_built = algo::toom4;
+#endif
 
 inline constexpr algo mul_tier_cap = static_cast<algo>(MICRON_ARBINT_MUL_TIER_CAP);
 inline constexpr algo sqr_tier_cap = static_cast<algo>(MICRON_ARBINT_SQR_TIER_CAP);
@@ -47,34 +56,49 @@ clamp_algo(algo k) noexcept
 // scratch requirement
 
 [[nodiscard, gnu::flatten]] inline constexpr usize
-mul_itch(usize an, usize bn, usize cutoff = threshold::mul_karatsuba) noexcept
+mul_itch(usize an, usize bn, usize cutoff = threshold::lowest.mul_karatsuba) noexcept
 {
   const usize n = an < bn ? an : bn;
   if ( n < cutoff ) return 0;
   usize base = karatsuba_itch(n, cutoff);
-  if ( an == bn && n >= threshold::mul_toom3 ) {
-    const usize t3 = toom3_itch(n);
+  // forced tops: a table may start a toom tier below its compiled threshold
+  if ( an == bn && n >= threshold::lowest.mul_toom3 ) {
+    const usize t3 = toom3_itch(n, true);
     if ( t3 > base ) base = t3;
   }
-  if ( an == bn && n >= threshold::mul_toom4 ) {
-    const usize t4 = toom4_itch(n);
+  if ( an == bn && n >= threshold::lowest.mul_toom4 ) {
+    const usize t4 = toom4_itch(n, true);
     if ( t4 > base ) base = t4;
   }
+#if defined(__micron_arch_width_64)
+  // the NTT takes unbalanced operands whole, no unbalanced stage on top
+  if ( static_cast<u8>(mul_tier_cap) >= static_cast<u8>(algo::nussbaumer) && n >= threshold::lowest.mul_nussbaumer
+       && ntt_applies(an, bn) ) {
+    const usize f = mul_ntt_itch(an, bn);
+    if ( f > base ) base = f;
+  }
+#endif
   return (an == bn) ? base : (unbalanced_stage_itch(an, bn, cutoff) + base);
 }
 
 [[nodiscard, gnu::flatten]] inline constexpr usize
-sqr_itch(usize n, usize cutoff = threshold::sqr_karatsuba) noexcept
+sqr_itch(usize n, usize cutoff = threshold::lowest.sqr_karatsuba) noexcept
 {
   usize base = sqr_karatsuba_itch(n, cutoff);
-  if ( n >= threshold::sqr_toom3 ) {
-    const usize t3 = sqr_toom3_itch(n);
+  if ( n >= threshold::lowest.sqr_toom3 ) {
+    const usize t3 = sqr_toom3_itch(n, true);
     if ( t3 > base ) base = t3;
   }
-  if ( n >= threshold::sqr_toom4 ) {
-    const usize t4 = sqr_toom4_itch(n);
+  if ( n >= threshold::lowest.sqr_toom4 ) {
+    const usize t4 = sqr_toom4_itch(n, true);
     if ( t4 > base ) base = t4;
   }
+#if defined(__micron_arch_width_64)
+  if ( static_cast<u8>(sqr_tier_cap) >= static_cast<u8>(algo::nussbaumer) && n >= threshold::lowest.sqr_nussbaumer && ntt_applies(n, n) ) {
+    const usize f = sqr_ntt_itch(n);
+    if ( f > base ) base = f;
+  }
+#endif
   return base;
 }
 
@@ -107,6 +131,10 @@ mul_itch_with(usize an, usize bn) noexcept
 {
   if constexpr ( K == algo::toom4 )
     return (an == bn) ? toom4_itch(an, true) : mul_itch_forced(an, bn);
+#if defined(__micron_arch_width_64)
+  else if constexpr ( K == algo::nussbaumer )
+    return ntt_applies(an, bn) ? mul_ntt_itch(an, bn) : mul_itch_forced(an, bn);
+#endif
   else
     return mul_itch_forced(an, bn);
 }
@@ -117,6 +145,10 @@ sqr_itch_with(usize n) noexcept
 {
   if constexpr ( K == algo::toom4 )
     return sqr_toom4_itch(n, true);
+#if defined(__micron_arch_width_64)
+  else if constexpr ( K == algo::nussbaumer )
+    return ntt_applies(n, n) ? sqr_ntt_itch(n) : sqr_itch_forced(n);
+#endif
   else
     return sqr_itch_forced(n);
 }
@@ -141,7 +173,16 @@ mul_with(limb_t *__restrict__ rp, const limb_t *__restrict__ ap, usize an, const
       mul_toom3(rp, ap, bp, an, scratch, threshold::mul_karatsuba);
     else
       mul_karatsuba_top(rp, ap, an, bp, bn, scratch);
-  } else {
+  }
+#if defined(__micron_arch_width_64)
+  else if constexpr ( K == algo::nussbaumer ) {
+    if ( ntt_applies(an, bn) )
+      mul_ntt(rp, ap, an, bp, bn, scratch);
+    else
+      mul_karatsuba_top(rp, ap, an, bp, bn, scratch);
+  }
+#endif
+  else {
     if ( toom4_applies(an, bn) )
       mul_toom4(rp, ap, bp, an, scratch, threshold::mul_karatsuba);
     else if ( toom3_applies(an, bn) )
@@ -168,7 +209,16 @@ sqr_with(limb_t *__restrict__ rp, const limb_t *__restrict__ ap, usize n, limb_t
       sqr_toom3(rp, ap, n, scratch, threshold::sqr_karatsuba);
     else
       sqr_karatsuba_top(rp, ap, n, scratch);
-  } else {
+  }
+#if defined(__micron_arch_width_64)
+  else if constexpr ( K == algo::nussbaumer ) {
+    if ( ntt_applies(n, n) )
+      sqr_ntt(rp, ap, n, scratch);
+    else
+      sqr_karatsuba_top(rp, ap, n, scratch);
+  }
+#endif
+  else {
     if ( sqr_toom4_applies(n) )
       sqr_toom4(rp, ap, n, scratch, threshold::sqr_karatsuba);
     else if ( sqr_toom3_applies(n) )
@@ -188,7 +238,8 @@ mul(limb_t *__restrict__ rp, const limb_t *__restrict__ ap, usize an, const limb
     rp[an] = mul_1(rp, ap, an, bp[0]);
     return;
   }
-  switch ( clamp_algo(pick_mul(an, bn)) ) {
+  const tuning &t = current_tuning();
+  switch ( clamp_algo(pick_mul(t, an, bn)) ) {
   case algo::basecase:
     mul_basecase(rp, ap, an, bp, bn);
     return;
@@ -196,21 +247,29 @@ mul(limb_t *__restrict__ rp, const limb_t *__restrict__ ap, usize an, const limb
     mul_comba(rp, ap, an, bp, bn);
     return;
   case algo::karatsuba:
-    mul_karatsuba(rp, ap, an, bp, bn, scratch);
+    mul_karatsuba(rp, ap, an, bp, bn, scratch, t.mul_karatsuba);
     return;
   case algo::toom3:
     if ( toom3_applies(an, bn) )
-      mul_toom3(rp, ap, bp, an, scratch, threshold::mul_karatsuba);
+      mul_toom3(rp, ap, bp, an, scratch, t.mul_karatsuba);
     else
-      mul_karatsuba(rp, ap, an, bp, bn, scratch);
+      mul_karatsuba(rp, ap, an, bp, bn, scratch, t.mul_karatsuba);
     return;
+#if defined(__micron_arch_width_64)
+  case algo::nussbaumer:
+    if ( ntt_applies(an, bn) ) {
+      mul_ntt(rp, ap, an, bp, bn, scratch);
+      return;
+    }
+    [[fallthrough]];
+#endif
   default:
     if ( toom4_applies(an, bn) )
-      mul_toom4(rp, ap, bp, an, scratch, threshold::mul_karatsuba);
+      mul_toom4(rp, ap, bp, an, scratch, t.mul_karatsuba);
     else if ( toom3_applies(an, bn) )
-      mul_toom3(rp, ap, bp, an, scratch, threshold::mul_karatsuba);
+      mul_toom3(rp, ap, bp, an, scratch, t.mul_karatsuba);
     else
-      mul_karatsuba(rp, ap, an, bp, bn, scratch);
+      mul_karatsuba(rp, ap, an, bp, bn, scratch, t.mul_karatsuba);
     return;
   }
 }
@@ -222,7 +281,8 @@ sqr(limb_t *__restrict__ rp, const limb_t *__restrict__ ap, usize n, limb_t *scr
     mul_wide(ap[0], ap[0], rp[0], rp[1]);
     return;
   }
-  switch ( clamp_to(pick_sqr(n), sqr_tier_cap) ) {
+  const tuning &t = current_tuning();
+  switch ( clamp_to(pick_sqr(t, n), sqr_tier_cap) ) {
   case algo::basecase:
     sqr_basecase(rp, ap, n);
     return;
@@ -230,21 +290,29 @@ sqr(limb_t *__restrict__ rp, const limb_t *__restrict__ ap, usize n, limb_t *scr
     sqr_comba(rp, ap, n);
     return;
   case algo::karatsuba:
-    sqr_karatsuba(rp, ap, n, scratch);
+    sqr_karatsuba(rp, ap, n, scratch, t.sqr_karatsuba);
     return;
   case algo::toom3:
     if ( sqr_toom3_applies(n) )
-      sqr_toom3(rp, ap, n, scratch, threshold::sqr_karatsuba);
+      sqr_toom3(rp, ap, n, scratch, t.sqr_karatsuba);
     else
-      sqr_karatsuba(rp, ap, n, scratch);
+      sqr_karatsuba(rp, ap, n, scratch, t.sqr_karatsuba);
     return;
+#if defined(__micron_arch_width_64)
+  case algo::nussbaumer:
+    if ( ntt_applies(n, n) ) {
+      sqr_ntt(rp, ap, n, scratch);
+      return;
+    }
+    [[fallthrough]];
+#endif
   default:
     if ( sqr_toom4_applies(n) )
-      sqr_toom4(rp, ap, n, scratch, threshold::sqr_karatsuba);
+      sqr_toom4(rp, ap, n, scratch, t.sqr_karatsuba);
     else if ( sqr_toom3_applies(n) )
-      sqr_toom3(rp, ap, n, scratch, threshold::sqr_karatsuba);
+      sqr_toom3(rp, ap, n, scratch, t.sqr_karatsuba);
     else
-      sqr_karatsuba(rp, ap, n, scratch);
+      sqr_karatsuba(rp, ap, n, scratch, t.sqr_karatsuba);
     return;
   }
 }
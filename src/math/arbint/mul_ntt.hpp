@@ -0,0 +1,336 @@
+//  Copyright (c) 2024- David Lucius Severus
+//
+//  Distributed under the Boost Software License, Version 1.0.
+//  See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt
+#pragma once
+
+#include "../../types.hpp"
+#include "limb.hpp"
+#include "mpn_core.hpp"
+#include "thresholds.hpp"
+
+// ^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^
+// three-prime NTT
+// fills the FFT tier (algo::nussbaumer), O(n log n)
+//
+// every limb is one coefficient; the cyclic convolution of length N = 2^k >= an + bn is taken modulo three 62-bit
+// primes c * 2^44 + 1, and the exact coefficients (< N * 2^128 < p0 p1 p2 ~ 2^186) are rebuilt by Garner's CRT and
+// carried into rp
+//
+//   forward   = decimation in frequency, natural order in, bit-reversed out
+//   pointwise = in bit-reversed order, no permutation anywhere
+//   inverse   = decimation in time, bit-reversed in, natural out, then one pass scaling by N^-1 back to normal form
+//
+// residues are kept in Montgomery form (R = 2^64); one table of N/2 roots per prime serves both directions through
+// w^-k = -w^(N/2 - k)
+//
+// scratch, in limbs: mul 3N (residues) + N (second operand) + N/2 (roots); sqr 3N + N/2
+//
+// NOTE: rp distinct from ap and bp, holds an + bn limbs; any an >= bn >= 1, unbalanced is fine
+// 64-bit limbs only, the 32-bit ladder stops at toom-4
+
+#if defined(__micron_arch_width_64)
+
+namespace micron
+{
+namespace math
+{
+namespace mpn
+{
+
+struct ntt_prime {
+  u64 p;
+  u64 pinv;      // -p^-1 mod 2^64
+  u64 r2;        // 2^128 mod p
+  u64 g;         // generator of (Z/p)^*
+};
+
+[[nodiscard]] inline consteval ntt_prime
+make_ntt_prime(u64 p, u64 g) noexcept
+{
+  u64 inv = p;      // p * p == 1 mod 8, five Newton steps reach 64 bits
+  for ( usize i = 0; i < 5u; ++i ) inv *= 2u - p * inv;
+  const dlimb_t r = (static_cast<dlimb_t>(1) << 64) % p;
+  return ntt_prime{ p, static_cast<u64>(0u - inv), static_cast<u64>((r * r) % p), g };
+}
+
+inline constexpr usize ntt_log2_max = 44u;
+inline constexpr ntt_prime ntt_primes[3] = { make_ntt_prime(0x3fffc00000000001ull, 11u), make_ntt_prime(0x3ffdf00000000001ull, 3u),
+                                             make_ntt_prime(0x3ffd900000000001ull, 3u) };
+
+static_assert(static_cast<u64>(ntt_primes[0].p * (0u - ntt_primes[0].pinv)) == 1u, "arbint: NTT Montgomery inverse is wrong");
+static_assert(static_cast<u64>(ntt_primes[1].p * (0u - ntt_primes[1].pinv)) == 1u, "arbint: NTT Montgomery inverse is wrong");
+static_assert(static_cast<u64>(ntt_primes[2].p * (0u - ntt_primes[2].pinv)) == 1u, "arbint: NTT Montgomery inverse is wrong");
+
+// a b R^-1 mod p, a b < 2^64 p
+[[nodiscard, gnu::always_inline]] inline constexpr u64
+ntt_mont(u64 a, u64 b, const ntt_prime &P) noexcept
+{
+  const dlimb_t t = static_cast<dlimb_t>(a) * b;
+  const u64 m = static_cast<u64>(static_cast<u64>(t) * P.pinv);
+  const u64 r = static_cast<u64>((t + static_cast<dlimb_t>(m) * P.p) >> 64);
+  return r >= P.p ? r - P.p : r;
+}
+
+[[nodiscard, gnu::always_inline]] inline constexpr u64
+ntt_add(u64 a, u64 b, u64 p) noexcept
+{
+  const u64 s = a + b;
+  return s >= p ? s - p : s;
+}
+
+[[nodiscard, gnu::always_inline]] inline constexpr u64
+ntt_sub(u64 a, u64 b, u64 p) noexcept
+{
+  return a >= b ? a - b : a + p - b;
+}
+
+// x R mod p (Montgomery form); reduces any 64-bit x
+[[nodiscard, gnu::always_inline]] inline constexpr u64
+ntt_to_mont(u64 x, const ntt_prime &P) noexcept
+{
+  return ntt_mont(x, P.r2, P);
+}
+
+[[nodiscard]] inline constexpr u64
+ntt_pow(u64 b, u64 e, const ntt_prime &P) noexcept
+{
+  u64 r = ntt_to_mont(1u, P);
+  b = ntt_to_mont(b, P);
+  for ( ; e; e >>= 1 ) {
+    if ( e & 1u ) r = ntt_mont(r, b, P);
+    b = ntt_mont(b, b, P);
+  }
+  return r;
+}
+
+// smallest transform length for an + bn coefficients
+[[nodiscard, gnu::always_inline]] inline constexpr usize
+ntt_size(usize an, usize bn) noexcept
+{
+  usize n = 1;
+  while ( n < an + bn ) n <<= 1;
+  return n;
+}
+
+[[nodiscard, gnu::always_inline]] inline constexpr bool
+ntt_applies(usize an, usize bn) noexcept
+{
+  return an >= 1u && bn >= 1u && ntt_size(an, bn) <= (usize(1) << ntt_log2_max);
+}
+
+[[nodiscard, gnu::always_inline]] inline constexpr usize
+mul_ntt_itch(usize an, usize bn) noexcept
+{
+  const usize n = ntt_size(an, bn);
+  return 4u * n + n / 2u;
+}
+
+[[nodiscard, gnu::always_inline]] inline constexpr usize
+sqr_ntt_itch(usize n) noexcept
+{
+  const usize m = ntt_size(n, n);
+  return 3u * m + m / 2u;
+}
+
+// w[k] = w_N^k R, k < N/2
+inline constexpr void
+ntt_roots(u64 *w, usize n, const ntt_prime &P) noexcept
+{
+  const usize h = n / 2u;
+  if ( h == 0 ) return;
+  const u64 wn = ntt_pow(P.g, (P.p - 1u) / n, P);
+  w[0] = ntt_to_mont(1u, P);
+  for ( usize k = 1; k < h; ++k ) w[k] = ntt_mont(w[k - 1u], wn, P);
+}
+
+// x[0, an) as Montgomery residues, zero padded to n
+inline constexpr void
+ntt_load(u64 *x, const limb_t *ap, usize an, usize n, const ntt_prime &P) noexcept
+{
+  for ( usize i = 0; i < an; ++i ) x[i] = ntt_to_mont(ap[i], P);
+  for ( usize i = an; i < n; ++i ) x[i] = 0;
+}
+
+// decimation in frequency; len = n/2 .. 1, bit-reversed output
+inline constexpr void
+ntt_fwd(u64 *x, usize n, const u64 *w, const ntt_prime &P) noexcept
+{
+  const u64 p = P.p;
+  for ( usize len = n / 2u, stride = 1; len >= 1u; len >>= 1, stride <<= 1 ) {
+    for ( usize i = 0; i < n; i += 2u * len ) {
+      u64 *a = x + i;
+      u64 *b = x + i + len;
+      for ( usize j = 0; j < len; ++j ) {
+        const u64 u = a[j], v = b[j];
+        a[j] = ntt_add(u, v, p);
+        b[j] = ntt_mont(ntt_sub(u, v, p), w[j * stride], P);
+      }
+    }
+  }
+}
+
+// decimation in time with w^-k = -w^(N/2 - k); len = 1 .. n/2, natural output, unscaled
+inline constexpr void
+ntt_inv(u64 *x, usize n, const u64 *w, const ntt_prime &P) noexcept
+{
+  const u64 p = P.p;
+  const usize h = n / 2u;
+  for ( usize len = 1, stride = h; len < n; len <<= 1, stride >>= 1 ) {
+    for ( usize i = 0; i < n; i += 2u * len ) {
+      u64 *a = x + i;
+      u64 *b = x + i + len;
+      {
+        const u64 u = a[0], v = b[0];
+        a[0] = ntt_add(u, v, p);
+        b[0] = ntt_sub(u, v, p);
+      }
+      for ( usize j = 1; j < len; ++j ) {
+        const u64 u = a[j], s = ntt_mont(b[j], w[h - j * stride], P);
+        a[j] = ntt_sub(u, s, p);
+        b[j] = ntt_add(u, s, p);
+      }
+    }
+  }
+}
+
+// x := x * y pointwise, then back; leaves N * x * y in Montgomery form
+inline constexpr void
+ntt_pointwise_inv(u64 *x, const u64 *y, usize n, const u64 *w, const ntt_prime &P) noexcept
+{
+  for ( usize i = 0; i < n; ++i ) x[i] = ntt_mont(x[i], y[i], P);
+  ntt_inv(x, n, w, P);
+}
+
+// one prime of a b: x ends as the normal-form residues of the product coefficients
+inline constexpr void
+ntt_mul_prime(u64 *x, u64 *y, u64 *w, const limb_t *ap, usize an, const limb_t *bp, usize bn, usize n, const ntt_prime &P) noexcept
+{
+  ntt_roots(w, n, P);
+  ntt_load(x, ap, an, n, P);
+  ntt_fwd(x, n, w, P);
+  if ( y ) {
+    ntt_load(y, bp, bn, n, P);
+    ntt_fwd(y, n, w, P);
+    ntt_pointwise_inv(x, y, n, w, P);
+  } else {
+    ntt_pointwise_inv(x, x, n, w, P);
+  }
+  // mont(N x R, N^-1) = x, and N^-1 = p - (p - 1) / N since N divides p - 1
+  const u64 ninv = P.p - (P.p - 1u) / n;
+  for ( usize i = 0; i < n; ++i ) x[i] = ntt_mont(x[i], ninv, P);
+}
+
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+// Garner recombination
+
+struct ntt_crt {
+  u64 c12;        // p0^-1 mod p1, Montgomery form
+  u64 c13;        // p0 mod p2, Montgomery form
+  u64 c123;       // (p0 p1)^-1 mod p2, Montgomery form
+  dlimb_t p01;    // p0 p1
+};
+
+[[nodiscard]] inline consteval u64
+ntt_inv_mod(u64 a, u64 m) noexcept
+{
+  // a^(m - 2) mod m, m prime
+  dlimb_t r = 1, b = a % m;
+  for ( u64 e = m - 2u; e; e >>= 1 ) {
+    if ( e & 1u ) r = (r * b) % m;
+    b = (b * b) % m;
+  }
+  return static_cast<u64>(r);
+}
+
+[[nodiscard]] inline consteval u64
+ntt_mont_const(u64 a, u64 m) noexcept
+{
+  return static_cast<u64>((static_cast<dlimb_t>(a % m) << 64) % m);
+}
+
+inline constexpr ntt_crt ntt_crt_consts = {
+  ntt_mont_const(ntt_inv_mod(ntt_primes[0].p, ntt_primes[1].p), ntt_primes[1].p),
+  ntt_mont_const(ntt_primes[0].p, ntt_primes[2].p),
+  ntt_mont_const(
+      ntt_inv_mod(static_cast<u64>((static_cast<dlimb_t>(ntt_primes[0].p) * ntt_primes[1].p) % ntt_primes[2].p), ntt_primes[2].p),
+      ntt_primes[2].p),
+  static_cast<dlimb_t>(ntt_primes[0].p) * ntt_primes[1].p,
+};
+
+// rp[i0, i1) := coefficients i0 .. i1 - 1 rebuilt from the three residue arrays (zero past cn), carried from c0 c1; leaves
+// the two limb carry out in c0 c1
+inline constexpr void
+ntt_recombine_range(limb_t *rp, usize i0, usize i1, const u64 *x0, const u64 *x1, const u64 *x2, usize cn, limb_t &c0,
+                    limb_t &c1) noexcept
+{
+  const ntt_prime &P1 = ntt_primes[1];
+  const ntt_prime &P2 = ntt_primes[2];
+  const ntt_crt &K = ntt_crt_consts;
+  const u64 p0 = ntt_primes[0].p;
+  const u64 q0 = static_cast<u64>(K.p01), q1 = static_cast<u64>(K.p01 >> 64);
+  for ( usize i = i0; i < i1; ++i ) {
+    limb_t v0 = 0, v1 = 0, v2 = 0;
+    if ( i < cn ) {
+      const u64 r0 = x0[i];
+      // v = r0 + p0 t1 + p0 p1 t2
+      const u64 r0_1 = r0 >= P1.p ? r0 - P1.p : r0;
+      const u64 t1 = ntt_mont(ntt_sub(x1[i], r0_1, P1.p), K.c12, P1);
+      const u64 r0_2 = r0 >= P2.p ? r0 - P2.p : r0;
+      const u64 s = ntt_add(r0_2, ntt_mont(t1, K.c13, P2), P2.p);
+      const u64 t2 = ntt_mont(ntt_sub(x2[i], s, P2.p), K.c123, P2);
+      const dlimb_t a = static_cast<dlimb_t>(t1) * p0 + r0;
+      const dlimb_t lo = static_cast<dlimb_t>(t2) * q0;
+      const dlimb_t hi = static_cast<dlimb_t>(t2) * q1;
+      dlimb_t acc = static_cast<dlimb_t>(static_cast<u64>(a)) + static_cast<u64>(lo);
+      v0 = static_cast<u64>(acc);
+      acc = (acc >> 64) + static_cast<u64>(a >> 64) + static_cast<u64>(lo >> 64) + static_cast<u64>(hi);
+      v1 = static_cast<u64>(acc);
+      v2 = static_cast<u64>((acc >> 64) + static_cast<u64>(hi >> 64));
+    }
+    dlimb_t t = static_cast<dlimb_t>(v0) + c0;
+    rp[i] = static_cast<limb_t>(t);
+    t = static_cast<dlimb_t>(v1) + c1 + static_cast<limb_t>(t >> 64);
+    c0 = static_cast<limb_t>(t);
+    c1 = static_cast<limb_t>(v2 + static_cast<limb_t>(t >> 64));
+  }
+}
+
+inline constexpr void
+ntt_recombine(limb_t *rp, usize rn, const u64 *x0, const u64 *x1, const u64 *x2, usize cn) noexcept
+{
+  limb_t c0 = 0, c1 = 0;
+  ntt_recombine_range(rp, 0, rn, x0, x1, x2, cn, c0, c1);
+}
+
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+// entry points
+
+inline constexpr void
+mul_ntt(limb_t *__restrict__ rp, const limb_t *__restrict__ ap, usize an, const limb_t *__restrict__ bp, usize bn,
+        limb_t *scratch) noexcept
+{
+  const usize n = ntt_size(an, bn);
+  u64 *x = scratch;
+  u64 *y = x + 3u * n;
+  u64 *w = y + n;
+  for ( usize k = 0; k < 3u; ++k ) ntt_mul_prime(x + k * n, y, w, ap, an, bp, bn, n, ntt_primes[k]);
+  ntt_recombine(rp, an + bn, x, x + n, x + 2u * n, an + bn - 1u);
+}
+
+inline constexpr void
+sqr_ntt(limb_t *__restrict__ rp, const limb_t *__restrict__ ap, usize an, limb_t *scratch) noexcept
+{
+  const usize n = ntt_size(an, an);
+  u64 *x = scratch;
+  u64 *w = x + 3u * n;
+  for ( usize k = 0; k < 3u; ++k ) ntt_mul_prime(x + k * n, nullptr, w, ap, an, ap, an, n, ntt_primes[k]);
+  ntt_recombine(rp, 2u * an, x, x + n, x + 2u * n, 2u * an - 1u);
+}
+
+};      // namespace mpn
+};      // namespace math
+};      // namespace micron
+
+#endif
@@ -0,0 +1,169 @@
+//  Copyright (c) 2024- David Lucius Severus
+//
+//  Distributed under the Boost Software License, Version 1.0.
+//  See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt
+#pragma once
+
+#include "../../bits/__abc_mt.hpp"      // autofires MICRON_ABC_MT; must precede abcmalloc
+
+#include "../../parallel/engine.hpp"
+#include "../../types.hpp"
+#include "limb.hpp"
+#include "mul_ntt.hpp"
+
+// ^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^
+// three-prime NTT on the coroutine engine
+//
+//   roots      3 blocks, one per prime
+//   forward    6 blocks, prime x operand (3 for a square)
+//   pointwise  3 blocks, product + inverse transform + N^-1 scaling
+//   recombine  blocks of ntt_mt_chunk coefficients, each carried from zero; the two-limb carry out of every block is
+//              added in afterwards, serially, and rarely ripples past a limb or two
+//
+// the result is the serial mul_ntt's, limb for limb. worth it only far above the FFT threshold, where the transforms
+// dominate: the ladder's mul() stays serial, callers that hold huge operands pick this explicitly
+//
+// scratch, in limbs: 3N residues + 3N second operands (none for sqr) + 3 N/2 roots + 2 per recombine block
+//
+// NOTE: rp distinct from ap and bp, holds an + bn limbs
+// *_mt entry points sync_wait on the engine, never call them from inside a task; co_await the *_task versions there
+
+#if defined(__micron_arch_width_64)
+
+namespace micron
+{
+namespace math
+{
+namespace mpn
+{
+
+inline constexpr usize ntt_mt_chunk = 65536;
+
+[[nodiscard, gnu::always_inline]] inline constexpr usize
+ntt_mt_blocks(usize rn) noexcept
+{
+  return (rn + ntt_mt_chunk - 1u) / ntt_mt_chunk;
+}
+
+[[nodiscard, gnu::always_inline]] inline constexpr usize
+mul_ntt_mt_itch(usize an, usize bn) noexcept
+{
+  const usize n = ntt_size(an, bn);
+  return 6u * n + 3u * (n / 2u) + 2u * ntt_mt_blocks(an + bn);
+}
+
+[[nodiscard, gnu::always_inline]] inline constexpr usize
+sqr_ntt_mt_itch(usize n) noexcept
+{
+  const usize m = ntt_size(n, n);
+  return 3u * m + 3u * (m / 2u) + 2u * ntt_mt_blocks(2u * n);
+}
+
+// adds c1 B + c0 into rp from limb i on
+inline void
+ntt_carry_in(limb_t *rp, usize i, usize rn, limb_t c0, limb_t c1) noexcept
+{
+  dlimb_t t = static_cast<dlimb_t>(rp[i]) + c0;
+  rp[i++] = lo_half(t);
+  limb_t cy = hi_half(t);
+  if ( i < rn ) {
+    t = static_cast<dlimb_t>(rp[i]) + c1 + cy;
+    rp[i++] = lo_half(t);
+    cy = hi_half(t);
+  }
+  for ( ; cy && i < rn; ++i ) {
+    rp[i] = static_cast<limb_t>(rp[i] + 1u);
+    cy = rp[i] == 0 ? 1u : 0u;
+  }
+}
+
+// bp == nullptr squares ap
+inline micron::task<void>
+ntt_mt_run(limb_t *rp, const limb_t *ap, usize an, const limb_t *bp, usize bn, limb_t *scratch)
+{
+  const bool sq = bp == nullptr;
+  const usize n = sq ? ntt_size(an, an) : ntt_size(an, bn);
+  const usize h = n / 2u;
+  const usize rn = sq ? 2u * an : an + bn;
+  u64 *x = scratch;
+  u64 *y = sq ? x : x + 3u * n;
+  u64 *w = sq ? x + 3u * n : y + 3u * n;
+  limb_t *carry = w + 3u * h;
+  if ( sq ) {
+    bp = ap;
+    bn = an;
+  }
+
+  auto roots = [=](usize k) { ntt_roots(w + k * h, n, ntt_primes[k]); };
+  co_await parallel::__pblocks<decltype(roots)>(0, 3, roots, 1);
+
+  auto fwd = [=](usize b) {
+    const usize k = b >> 1;
+    u64 *t = (b & 1u) ? y + k * n : x + k * n;
+    ntt_load(t, (b & 1u) ? bp : ap, (b & 1u) ? bn : an, n, ntt_primes[k]);
+    ntt_fwd(t, n, w + k * h, ntt_primes[k]);
+  };
+  // a square has no second operand: even blocks only
+  if ( sq ) {
+    auto fwd_sq = [=](usize k) { fwd(2u * k); };
+    co_await parallel::__pblocks<decltype(fwd_sq)>(0, 3, fwd_sq, 1);
+  } else {
+    co_await parallel::__pblocks<decltype(fwd)>(0, 6, fwd, 1);
+  }
+
+  auto back = [=](usize k) {
+    const ntt_prime &P = ntt_primes[k];
+    u64 *t = x + k * n;
+    ntt_pointwise_inv(t, y + k * n, n, w + k * h, P);
+    const u64 ninv = P.p - (P.p - 1u) / n;
+    for ( usize i = 0; i < n; ++i ) t[i] = ntt_mont(t[i], ninv, P);
+  };
+  co_await parallel::__pblocks<decltype(back)>(0, 3, back, 1);
+
+  const usize nc = ntt_mt_blocks(rn);
+  auto crt = [=](usize c) {
+    const usize i0 = c * ntt_mt_chunk;
+    const usize i1 = (i0 + ntt_mt_chunk < rn) ? i0 + ntt_mt_chunk : rn;
+    limb_t c0 = 0, c1 = 0;
+    ntt_recombine_range(rp, i0, i1, x, x + n, x + 2u * n, rn - 1u, c0, c1);
+    carry[2u * c] = c0;
+    carry[2u * c + 1u] = c1;
+  };
+  co_await parallel::__pblocks<decltype(crt)>(0, nc, crt, 1);
+  for ( usize c = 0; c + 1u < nc; ++c ) ntt_carry_in(rp, (c + 1u) * ntt_mt_chunk, rn, carry[2u * c], carry[2u * c + 1u]);
+}
+
+// rp := a b; co_await it from inside a task
+inline micron::task<void>
+mul_ntt_task(limb_t *rp, const limb_t *ap, usize an, const limb_t *bp, usize bn, limb_t *scratch)
+{
+  co_await ntt_mt_run(rp, ap, an, bp, bn, scratch);
+}
+
+// rp := a^2
+inline micron::task<void>
+sqr_ntt_task(limb_t *rp, const limb_t *ap, usize an, limb_t *scratch)
+{
+  co_await ntt_mt_run(rp, ap, an, nullptr, 0, scratch);
+}
+
+// multithreaded mul_ntt; blocks until done, call from outside the engine. scratch holds mul_ntt_mt_itch(an, bn) limbs
+inline void
+mul_ntt_mt(limb_t *rp, const limb_t *ap, usize an, const limb_t *bp, usize bn, limb_t *scratch)
+{
+  micron::coro::sync_wait(mul_ntt_task(rp, ap, an, bp, bn, scratch));
+}
+
+// multithreaded sqr_ntt; scratch holds sqr_ntt_mt_itch(an) limbs
+inline void
+sqr_ntt_mt(limb_t *rp, const limb_t *ap, usize an, limb_t *scratch)
+{
+  micron::coro::sync_wait(sqr_ntt_task(rp, ap, an, scratch));
+}
+
+};      // namespace mpn
+};      // namespace math
+};      // namespace micron
+
+#endif
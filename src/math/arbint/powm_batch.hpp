@@ -0,0 +1,796 @@
+//  Copyright (c) 2024- David Lucius Severus
+//
+//  Distributed under the Boost Software License, Version 1.0.
+//  See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt
+#pragma once
+
+#include "../../atomic/intrin.hpp"
+#include "../../bits/__arch.hpp"
+#include "../../bits/__cpuid.hpp"
+#include "../../types.hpp"
+#include "div.hpp"
+#include "div_mu.hpp"
+#include "limb.hpp"
+#include "mont.hpp"
+#include "mpn_core.hpp"
+#include "powm.hpp"
+#include "thresholds.hpp"
+
+// ^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^
+// batched modular exponentiation
+// many independent a^e mod m at once, one per SIMD lane
+//
+// every lane of a group runs its own modulus, base and exponent through the same instruction stream: the residues are
+// cut into D-bit digits stored digit-major ([digit][lane]), so one vector op advances digit j of every lane. the
+// multiply is almost-Montgomery (operands and result < 2m, R = 2^(D nd) > 4m) and never branches on a lane
+//
+//   ifma    8 lanes of 52-bit digits, vpmadd52luq / vpmadd52huq, avx512f + avx512ifma
+//   avx2    4 lanes of 27-bit digits, vpmuludq, the whole product in 64 bits and no high half
+//   scalar  one mpn::powm per job
+//
+// picked on first use from cpuid and XCR0, whatever the build flags, as gemm_mt does. a lane group runs a fixed k-bit
+// window over the longest exponent in it (shorter ones see leading zero windows), the table gathered per lane
+//
+// fixed base: powm_fb_make lays out b^(d 2^(k i)) for every window i and digit d, after which an exponent costs one
+// multiply per window and no squarings at all (Brickell-Gordon-McCurley-Wilson). the table is in the form the active
+// lanes read, so the same context serves one exponent or a batch
+//
+// jobs with an even modulus, or moduli past powm_batch_max_limbs, drop to the scalar path one at a time; so does a
+// last group of a single job
+//
+// WARNING: NOT CONSTANT TIME, the window gathers index the table by exponent bits
+// NOTE: every modulus in a batch holds exactly n limbs with the top one nonzero; rp takes n limbs
+
+namespace micron
+{
+namespace math
+{
+namespace mpn
+{
+
+enum class powm_isa : u32 { scalar = 0, avx2, ifma };
+
+// the lanes run a fixed window of at most this many bits; 2^k table rows of nd digits per lane stay in L2
+inline constexpr usize powm_batch_window = 5;
+// 27-bit digits keep nd 2^55 under 2^64 up to nd = 511, 52-bit ones nd 2^54 to 1023; this is below both
+inline constexpr usize powm_batch_max_limbs = 128;
+
+[[nodiscard, gnu::always_inline]] inline constexpr usize
+powm_batch_lanes(powm_isa i) noexcept
+{
+  return i == powm_isa::ifma ? 8u : i == powm_isa::avx2 ? 4u : 1u;
+}
+
+[[nodiscard, gnu::always_inline]] inline constexpr u32
+powm_batch_digit_bits(powm_isa i) noexcept
+{
+  return i == powm_isa::ifma ? 52u : i == powm_isa::avx2 ? 27u : 0u;
+}
+
+namespace __pb
+{
+
+inline constexpr u32 __unset = ~u32{ 0 };
+inline u32 __isa = __unset;
+
+// digits of a lane: R = 2^(D nd) >= 2^(64 n + 2) > 4m
+[[nodiscard, gnu::always_inline]] inline constexpr usize
+__digits(usize n, u32 d) noexcept
+{
+  return (64u * n + 2u + d - 1u) / d;
+}
+
+#if defined(__micron_arch_x86_any)
+inline u64
+__xgetbv0() noexcept
+{
+  u32 lo, hi;
+  __asm__ __volatile__("xgetbv" : "=a"(lo), "=d"(hi) : "c"(0u));
+  return (static_cast<u64>(hi) << 32) | lo;
+}
+#endif
+
+inline powm_isa
+__probe() noexcept
+{
+#if defined(__micron_arch_amd64)
+  if ( !__cpuid_has_leaf(7u) ) return powm_isa::scalar;
+  if ( !((__cpuid_read(1u).ecx >> 27) & 1u) ) return powm_isa::scalar;      // osxsave
+  const u64 xcr0 = __xgetbv0();
+  const cpuid_regs l7 = __cpuid_read(7u, 0u);
+  // opmask + both zmm halves saved, avx512f, avx512ifma
+  if ( (xcr0 & 0xe6u) == 0xe6u && ((l7.ebx >> 16) & 1u) && ((l7.ebx >> 21) & 1u) ) return powm_isa::ifma;
+  if ( (xcr0 & 0x6u) == 0x6u && ((l7.ebx >> 5) & 1u) ) return powm_isa::avx2;
+#endif
+  return powm_isa::scalar;
+}
+
+};      // namespace __pb
+
+// the lanes powm_batch runs, probed on first use
+inline powm_isa
+active_powm_isa() noexcept
+{
+  u32 v = atom::load(&__pb::__isa, __ATOMIC_RELAXED);
+  if ( v == __pb::__unset ) [[unlikely]] {
+    v = static_cast<u32>(__pb::__probe());
+    atom::store(&__pb::__isa, v, __ATOMIC_RELAXED);
+  }
+  return static_cast<powm_isa>(v);
+}
+
+// pins the lanes (benchmarks, tests); asking for more than the machine has gets the best it does have
+inline void
+set_powm_isa(powm_isa i) noexcept
+{
+  const powm_isa hw = __pb::__probe();
+  if ( static_cast<u32>(i) > static_cast<u32>(hw) ) i = hw;
+  atom::store(&__pb::__isa, static_cast<u32>(i), __ATOMIC_RELAXED);
+}
+
+// one exponentiation: rp = b^e mod m, n limbs
+struct powm_job {
+  limb_t *rp;
+  const limb_t *bp;
+  usize bn;
+  const limb_t *ep;
+  usize en;
+  const limb_t *mp;
+};
+
+// one exponent against a fixed base context
+struct powm_fb_job {
+  limb_t *rp;
+  const limb_t *ep;
+  usize en;
+};
+
+// b^(d 2^(k i)) for windows i and digits d < 2^k, in the Montgomery form of the lanes it was built for, then b mod m
+// plain for exponents past the table
+struct powm_fb_ctx {
+  const limb_t *tp;      // windows * 2^k entries of w limbs and n more, borrowed
+  const limb_t *mp;      // n limbs, borrowed
+  usize n;
+  usize k;
+  usize windows;      // exponents up to k * windows bits
+  usize w;            // entry stride: n limbs (scalar) or nd digits
+  powm_isa isa;
+};
+
+namespace __pb
+{
+
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+// lane kernels
+
+#if defined(__micron_arch_amd64)
+
+typedef unsigned long long __v4u __attribute__((vector_size(32)));
+typedef unsigned long long __v8u __attribute__((vector_size(64)));
+typedef int __v8i __attribute__((vector_size(32)));
+
+[[gnu::target("avx2"), gnu::always_inline]] inline __v4u
+__ld4(const limb_t *p) noexcept
+{
+  __v4u v;
+  __builtin_memcpy(&v, p, sizeof(v));
+  return v;
+}
+
+[[gnu::target("avx2"), gnu::always_inline]] inline void
+__st4(limb_t *p, __v4u v) noexcept
+{
+  __builtin_memcpy(p, &v, sizeof(v));
+}
+
+// vpmuludq, the low 32 bits of each lane
+[[gnu::target("avx2"), gnu::always_inline]] inline __v4u
+__mul32(__v4u x, __v4u y) noexcept
+{
+  return (__v4u)__builtin_ia32_pmuludq256((__v8i)x, (__v8i)y);
+}
+
+// rp = a b R^-1 mod m, < 2m, for a, b < 2m; t holds nd * 4 words. rp may alias ap or bp
+//
+// 27-bit digits: a digit product is < 2^54 and a column takes two per row, nd 2^55 in all, so every column is summed
+// whole in 64 bits and only the final pass carries
+[[gnu::target("avx2")]] inline void
+__amm_avx2(limb_t *rp, const limb_t *ap, const limb_t *bp, const limb_t *mp, const limb_t *mi, usize nd, limb_t *t) noexcept
+{
+  constexpr usize L = 4;
+  constexpr u32 D = 27;
+  const __v4u mask = __v4u{} + ((u64{ 1 } << D) - 1u);
+  const __v4u m0i = __ld4(mi);
+  for ( usize j = 0; j < nd; ++j ) __st4(t + j * L, __v4u{});
+  for ( usize i = 0; i < nd; ++i ) {
+    const __v4u ai = __ld4(ap + i * L);
+    __v4u x = __ld4(t) + __mul32(ai, __ld4(bp));
+    const __v4u q = __mul32(x, m0i) & mask;
+    x += __mul32(q, __ld4(mp));
+    // x is 0 mod 2^D now: its carry moves up with the shift
+    __st4(t + L, __ld4(t + L) + (x >> D));
+    for ( usize j = 1; j < nd; ++j ) {
+      x = __ld4(t + j * L) + __mul32(ai, __ld4(bp + j * L)) + __mul32(q, __ld4(mp + j * L));
+      __st4(t + (j - 1u) * L, x);
+    }
+    __st4(t + (nd - 1u) * L, __v4u{});
+  }
+  __v4u c{};
+  for ( usize j = 0; j < nd; ++j ) {
+    const __v4u x = __ld4(t + j * L) + c;
+    __st4(rp + j * L, x & mask);
+    c = x >> D;
+  }
+}
+
+[[gnu::target("avx512f"), gnu::always_inline]] inline __v8u
+__ld8(const limb_t *p) noexcept
+{
+  __v8u v;
+  __builtin_memcpy(&v, p, sizeof(v));
+  return v;
+}
+
+[[gnu::target("avx512f"), gnu::always_inline]] inline void
+__st8(limb_t *p, __v8u v) noexcept
+{
+  __builtin_memcpy(p, &v, sizeof(v));
+}
+
+// acc + lo52(x y), acc + hi52(x y); asm since gcc and clang spell the builtins differently
+[[gnu::target("avx512f,avx512ifma"), gnu::always_inline]] inline __v8u
+__madd52lo(__v8u acc, __v8u x, __v8u y) noexcept
+{
+  __asm__("vpmadd52luq %2, %1, %0" : "+v"(acc) : "v"(x), "v"(y));
+  return acc;
+}
+
+[[gnu::target("avx512f,avx512ifma"), gnu::always_inline]] inline __v8u
+__madd52hi(__v8u acc, __v8u x, __v8u y) noexcept
+{
+  __asm__("vpmadd52huq %2, %1, %0" : "+v"(acc) : "v"(x), "v"(y));
+  return acc;
+}
+
+// the avx2 kernel's contract, t holds nd * 8 words
+//
+// 52-bit digits: the low half of a digit product stays in its column, the high half goes one up. four 52-bit terms a
+// row, nd 2^54 in all
+[[gnu::target("avx512f,avx512ifma")]] inline void
+__amm_ifma(limb_t *rp, const limb_t *ap, const limb_t *bp, const limb_t *mp, const limb_t *mi, usize nd, limb_t *t) noexcept
+{
+  constexpr usize L = 8;
+  constexpr u32 D = 52;
+  const __v8u mask = __v8u{} + ((u64{ 1 } << D) - 1u);
+  const __v8u m0i = __ld8(mi);
+  for ( usize j = 0; j < nd; ++j ) __st8(t + j * L, __v8u{});
+  for ( usize i = 0; i < nd; ++i ) {
+    const __v8u ai = __ld8(ap + i * L);
+    __v8u bl = __ld8(bp), ml = __ld8(mp);
+    __v8u x = __madd52lo(__ld8(t), ai, bl);
+    const __v8u q = __madd52lo(__v8u{}, x, m0i);
+    x = __madd52lo(x, q, ml);
+    __st8(t + L, __ld8(t + L) + (x >> D));
+    for ( usize j = 1; j < nd; ++j ) {
+      const __v8u bj = __ld8(bp + j * L), mj = __ld8(mp + j * L);
+      x = __madd52lo(__madd52lo(__ld8(t + j * L), ai, bj), q, mj);
+      x = __madd52hi(__madd52hi(x, ai, bl), q, ml);
+      __st8(t + (j - 1u) * L, x);
+      bl = bj;
+      ml = mj;
+    }
+    __st8(t + (nd - 1u) * L, __madd52hi(__madd52hi(__v8u{}, ai, bl), q, ml));
+  }
+  __v8u c{};
+  for ( usize j = 0; j < nd; ++j ) {
+    const __v8u x = __ld8(t + j * L) + c;
+    __st8(rp + j * L, x & mask);
+    c = x >> D;
+  }
+}
+
+struct __avx2 {
+  static constexpr usize L = 4;
+  static constexpr u32 D = 27;
+
+  static void
+  amm(limb_t *rp, const limb_t *ap, const limb_t *bp, const limb_t *mp, const limb_t *mi, usize nd, limb_t *t) noexcept
+  {
+    __amm_avx2(rp, ap, bp, mp, mi, nd, t);
+  }
+};
+
+struct __ifma {
+  static constexpr usize L = 8;
+  static constexpr u32 D = 52;
+
+  static void
+  amm(limb_t *rp, const limb_t *ap, const limb_t *bp, const limb_t *mp, const limb_t *mi, usize nd, limb_t *t) noexcept
+  {
+    __amm_ifma(rp, ap, bp, mp, mi, nd, t);
+  }
+};
+
+#endif
+
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+// digits
+
+// {sp, sn} into nd D-bit digits, dp[j * stride]
+inline void
+__to_digits(limb_t *dp, usize stride, const limb_t *sp, usize sn, usize nd, u32 d) noexcept
+{
+  const limb_t mask = (limb_t{ 1 } << d) - 1u;
+  for ( usize j = 0; j < nd; ++j ) {
+    const usize bit = j * d, w = bit / limb_bits, s = bit % limb_bits;
+    limb_t v = w < sn ? sp[w] >> s : 0;
+    if ( s + d > limb_bits && w + 1u < sn ) v |= sp[w + 1u] << (limb_bits - s);
+    dp[j * stride] = v & mask;
+  }
+}
+
+// the inverse, into rn limbs; bits past rn limbs are dropped
+inline void
+__from_digits(limb_t *rp, usize rn, const limb_t *dp, usize stride, usize nd, u32 d) noexcept
+{
+  zero(rp, rn);
+  for ( usize j = 0; j < nd; ++j ) {
+    const usize bit = j * d, w = bit / limb_bits, s = bit % limb_bits;
+    const limb_t v = dp[j * stride];
+    if ( w < rn ) rp[w] |= v << s;
+    if ( s + d > limb_bits && w + 1u < rn ) rp[w + 1u] |= v >> (limb_bits - s);
+  }
+}
+
+// the k bits of e from bit lo up, zero past its end
+[[nodiscard, gnu::always_inline]] inline usize
+__window(const limb_t *ep, usize en, usize lo, usize k) noexcept
+{
+  const usize w = lo / limb_bits, s = lo % limb_bits;
+  if ( w >= en ) return 0;
+  limb_t v = ep[w] >> s;
+  if ( s + k > limb_bits && w + 1u < en ) v |= ep[w + 1u] << (limb_bits - s);
+  return static_cast<usize>(v & ((limb_t{ 1 } << k) - 1u));
+}
+
+[[nodiscard, gnu::always_inline]] inline constexpr usize
+__rmod_itch(usize n, usize an, usize s) noexcept
+{
+  if ( an == 0 ) an = 1;
+  const usize nn = an + s / limb_bits + 1u;
+  return nn + (nn - n + 1u) + divrem_itch(nn, n);
+}
+
+// rp = a 2^s mod m, n limbs; s >= 64 n
+inline void
+__rmod(limb_t *rp, const limb_t *ap, usize an, usize s, const limb_t *mp, usize n, limb_t *scratch) noexcept
+{
+  an = normalize(ap, an);
+  if ( an == 0 ) {
+    zero(rp, n);
+    return;
+  }
+  const usize w = s / limb_bits, b = s % limb_bits;
+  const usize nn = an + w + 1u;
+  limb_t *const np = scratch;                  // nn
+  limb_t *const qp = np + nn;                  // nn - n + 1
+  limb_t *const work = qp + (nn - n + 1u);      // divrem_itch(nn, n)
+  zero(np, w);
+  if ( b != 0 ) {
+    np[w + an] = lshift(np + w, ap, an, b);
+  } else {
+    copyi(np + w, ap, an);
+    np[w + an] = 0;
+  }
+  divrem(qp, rp, np, nn, mp, n, work);
+}
+
+// {xp, n + 1} < 2m down to rp = x mod m
+inline void
+__reduce_once(limb_t *rp, limb_t *xp, const limb_t *mp, usize n) noexcept
+{
+  if ( xp[n] != 0 || cmp(xp, mp, n) >= 0 ) (void)sub_n(xp, xp, mp, n);
+  copyi(rp, xp, n);
+}
+
+// words of one lane group: modulus, m', table, acc, gather, column sums, then the limb side
+[[nodiscard, gnu::always_inline]] inline constexpr usize
+__group_itch(usize n, usize bn, u32 d, usize lanes) noexcept
+{
+  const usize nd = __digits(n, d);
+  const usize v = nd * lanes;
+  return v * ((usize{ 1 } << powm_batch_window) + 4u) + lanes + (n + 1u) + __rmod_itch(n, bn, nd * d);
+}
+
+[[nodiscard, gnu::always_inline]] inline constexpr usize
+__fb_group_itch(usize n, u32 d, usize lanes) noexcept
+{
+  const usize v = __digits(n, d) * lanes;
+  return 4u * v + lanes + (n + 1u);
+}
+
+// b mod m, stored after the table
+[[nodiscard, gnu::always_inline]] inline const limb_t *
+__fb_base(const powm_fb_ctx &c) noexcept
+{
+  return c.tp + c.windows * (usize{ 1 } << c.k) * c.w;
+}
+
+// e has more bits than the table covers
+[[nodiscard, gnu::always_inline]] inline bool
+__fb_long(const powm_fb_ctx &c, const limb_t *ep, usize en) noexcept
+{
+  return bitlen(ep, normalize(ep, en)) > c.k * c.windows;
+}
+
+#if defined(__micron_arch_amd64)
+
+// the lanes' m and m' = -m^-1 mod 2^D, from job j of lane l
+template<class K>
+inline void
+__lane_modulus(limb_t *m, limb_t *mi, usize l, const limb_t *mp, usize n, usize nd) noexcept
+{
+  __to_digits(m + l, K::L, mp, n, nd, K::D);
+  mi[l] = static_cast<limb_t>(0u - binv_odd(mp[0])) & ((limb_t{ 1 } << K::D) - 1u);
+}
+
+// jobs[ix[0 .. lanes)] through one lane group; the spare lanes rerun the first job and are dropped
+template<class K>
+inline void
+__group(const powm_job *jobs, const usize *ix, usize lanes, usize n, limb_t *scratch) noexcept
+{
+  constexpr usize L = K::L;
+  const usize nd = __digits(n, K::D);
+  const usize v = nd * L;
+
+  usize ebits = 0;
+  for ( usize l = 0; l < lanes; ++l ) {
+    const powm_job &j = jobs[ix[l]];
+    const usize b = bitlen(j.ep, normalize(j.ep, j.en));
+    if ( b > ebits ) ebits = b;
+  }
+  usize k = powm_window(ebits);
+  if ( k > powm_batch_window ) k = powm_batch_window;
+  const usize entries = usize{ 1 } << k;
+
+  limb_t *const m = scratch;                   // v
+  limb_t *const mi = m + v;                    // L
+  limb_t *const tbl = mi + L;                  // entries * v
+  limb_t *const acc = tbl + entries * v;       // v
+  limb_t *const g = acc + v;                   // v
+  limb_t *const t = g + v;                     // v
+  limb_t *const x = t + v;                     // n + 1
+  limb_t *const work = x + n + 1u;             // __rmod_itch
+
+  // T[0] = R mod m, T[1] = b R mod m, straight from the limbs
+  const limb_t one = 1;
+  for ( usize l = 0; l < L; ++l ) {
+    const powm_job &j = jobs[ix[l < lanes ? l : 0]];
+    __lane_modulus<K>(m, mi, l, j.mp, n, nd);
+    __rmod(x, &one, 1, nd * K::D, j.mp, n, work);
+    __to_digits(tbl + l, L, x, n, nd, K::D);
+    __rmod(x, j.bp, j.bn, nd * K::D, j.mp, n, work);
+    __to_digits(tbl + v + l, L, x, n, nd, K::D);
+  }
+  for ( usize e = 2; e < entries; ++e ) K::amm(tbl + e * v, tbl + (e - 1u) * v, tbl + v, m, mi, nd, t);
+
+  const limb_t *src[L];
+  auto gather = [&](limb_t *dst, usize lo) {
+    for ( usize l = 0; l < L; ++l ) {
+      const powm_job &j = jobs[ix[l < lanes ? l : 0]];
+      src[l] = tbl + __window(j.ep, j.en, lo, k) * v + l;
+    }
+    for ( usize i = 0; i < nd; ++i )
+      for ( usize l = 0; l < L; ++l ) dst[i * L + l] = src[l][i * L];
+  };
+
+  const usize nw = (ebits + k - 1u) / k;
+  if ( nw == 0 ) {
+    copyi(acc, tbl, v);
+  } else {
+    gather(acc, (nw - 1u) * k);
+    for ( usize i = nw - 1u; i-- > 0; ) {
+      for ( usize s = 0; s < k; ++s ) K::amm(acc, acc, acc, m, mi, nd, t);
+      gather(g, i * k);
+      K::amm(acc, acc, g, m, mi, nd, t);
+    }
+  }
+
+  // out of Montgomery form: acc * 1 R^-1 <= m
+  zero(g, v);
+  for ( usize l = 0; l < L; ++l ) g[l] = 1;
+  K::amm(acc, acc, g, m, mi, nd, t);
+  for ( usize l = 0; l < lanes; ++l ) {
+    const powm_job &j = jobs[ix[l]];
+    __from_digits(x, n + 1u, acc + l, L, nd, K::D);
+    __reduce_once(j.rp, x, j.mp, n);
+  }
+}
+
+// jobs[ix[0 .. lanes)] against a fixed base. the accumulator starts at a plain 1 and every entry carries one factor
+// of R, so each multiply leaves it plain: no conversion on either end
+template<class K>
+inline void
+__fb_group(const powm_fb_ctx &c, const powm_fb_job *jobs, const usize *ix, usize lanes, limb_t *scratch) noexcept
+{
+  constexpr usize L = K::L;
+  const usize n = c.n, nd = c.w, v = nd * L;
+  const usize entries = usize{ 1 } << c.k;
+
+  limb_t *const m = scratch;        // v
+  limb_t *const mi = m + v;         // L
+  limb_t *const acc = mi + L;       // v
+  limb_t *const g = acc + v;        // v
+  limb_t *const t = g + v;          // v
+  limb_t *const x = t + v;          // n + 1
+
+  for ( usize l = 0; l < L; ++l ) __lane_modulus<K>(m, mi, l, c.mp, n, nd);
+
+  usize ebits = 0;
+  for ( usize l = 0; l < lanes; ++l ) {
+    const powm_fb_job &j = jobs[ix[l]];
+    const usize b = bitlen(j.ep, normalize(j.ep, j.en));
+    if ( b > ebits ) ebits = b;
+  }
+  // exponents past the table never get here, powm_fb and powm_fb_batch hand them to powm
+  const usize nw = (ebits + c.k - 1u) / c.k;
+
+  zero(acc, v);
+  for ( usize l = 0; l < L; ++l ) acc[l] = 1;
+  const limb_t *src[L];
+  for ( usize i = 0; i < nw; ++i ) {
+    usize any = 0;
+    for ( usize l = 0; l < L; ++l ) {
+      const powm_fb_job &j = jobs[ix[l < lanes ? l : 0]];
+      const usize d = __window(j.ep, j.en, i * c.k, c.k);
+      any |= d;
+      src[l] = c.tp + (i * entries + d) * nd;
+    }
+    // every lane on digit 0 would multiply by R / R
+    if ( any == 0 ) continue;
+    for ( usize q = 0; q < nd; ++q )
+      for ( usize l = 0; l < L; ++l ) g[q * L + l] = src[l][q];
+    K::amm(acc, acc, g, m, mi, nd, t);
+  }
+
+  for ( usize l = 0; l < lanes; ++l ) {
+    __from_digits(x, n + 1u, acc + l, L, nd, K::D);
+    __reduce_once(jobs[ix[l]].rp, x, c.mp, n);
+  }
+}
+
+#endif
+
+// one job on mpn::powm; a modulus with zero top limbs still fills all n
+inline void
+__scalar(const powm_job &j, usize n, limb_t *scratch) noexcept
+{
+  const usize nm = normalize(j.mp, n);
+  powm(j.rp, j.bp, j.bn, j.ep, j.en, j.mp, n, scratch);
+  if ( nm < n ) zero(j.rp + nm, n - nm);
+}
+
+};      // namespace __pb
+
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+// batch
+
+// scratch for powm_batch over bases of at most bn limbs and exponents of at most ebits bits
+[[nodiscard]] inline constexpr usize
+powm_batch_itch(usize n, usize bn, usize ebits) noexcept
+{
+  if ( n == 0 ) return 0;
+  usize w = powm_itch(n, bn, ebits);
+  const usize a = __pb::__group_itch(n, bn, powm_batch_digit_bits(powm_isa::avx2), powm_batch_lanes(powm_isa::avx2));
+  if ( a > w ) w = a;
+  const usize f = __pb::__group_itch(n, bn, powm_batch_digit_bits(powm_isa::ifma), powm_batch_lanes(powm_isa::ifma));
+  if ( f > w ) w = f;
+  return w;
+}
+
+// jobs[i].rp = b_i^e_i mod m_i for i < count, every modulus n limbs; scratch holds powm_batch_itch(n, bn, ebits)
+inline void
+powm_batch(const powm_job *jobs, usize count, usize n, limb_t *scratch) noexcept
+{
+  if ( n == 0 ) return;
+  const powm_isa isa = n <= powm_batch_max_limbs ? active_powm_isa() : powm_isa::scalar;
+  const usize lanes = powm_batch_lanes(isa);
+
+  auto run = [&](const usize *ix, usize cnt) {
+    if ( cnt == 1u ) {
+      __pb::__scalar(jobs[ix[0]], n, scratch);
+      return;
+    }
+#if defined(__micron_arch_amd64)
+    if ( isa == powm_isa::ifma )
+      __pb::__group<__pb::__ifma>(jobs, ix, cnt, n, scratch);
+    else
+      __pb::__group<__pb::__avx2>(jobs, ix, cnt, n, scratch);
+#endif
+  };
+
+  usize ix[8];
+  usize cnt = 0;
+  for ( usize i = 0; i < count; ++i ) {
+    const powm_job &j = jobs[i];
+    if ( lanes == 1u || (j.mp[0] & 1u) == 0 || j.mp[n - 1u] == 0 ) {
+      __pb::__scalar(j, n, scratch);
+      continue;
+    }
+    ix[cnt++] = i;
+    if ( cnt == lanes ) {
+      run(ix, cnt);
+      cnt = 0;
+    }
+  }
+  if ( cnt != 0 ) run(ix, cnt);
+}
+
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+// fixed base
+
+// limbs of the table for exponents up to ebits bits, whichever lanes build it
+[[nodiscard]] inline constexpr usize
+powm_fb_table_limbs(usize n, usize ebits, usize k) noexcept
+{
+  const usize windows = ebits == 0 ? 1u : (ebits + k - 1u) / k;
+  usize w = __pb::__digits(n, powm_batch_digit_bits(powm_isa::avx2));
+  if ( n > w ) w = n;
+  return windows * (usize{ 1 } << k) * w + n;
+}
+
+[[nodiscard]] inline constexpr usize
+powm_fb_make_itch(usize n, usize bn) noexcept
+{
+  usize w = mont_op_itch(n);
+  const usize t = to_mont_itch(bn, n);
+  if ( t > w ) w = t;
+  const u32 d = powm_batch_digit_bits(powm_isa::avx2);
+  const usize r = __pb::__rmod_itch(n, 1, __pb::__digits(n, d) * d);
+  if ( r > w ) w = r;
+  return 5u * n + w;
+}
+
+// scratch for powm_fb / powm_fb_batch
+[[nodiscard]] inline constexpr usize
+powm_fb_itch(usize n) noexcept
+{
+  usize w = n + mont_mul_itch(n);
+  const usize a = __pb::__fb_group_itch(n, powm_batch_digit_bits(powm_isa::avx2), powm_batch_lanes(powm_isa::avx2));
+  if ( a > w ) w = a;
+  const usize f = __pb::__fb_group_itch(n, powm_batch_digit_bits(powm_isa::ifma), powm_batch_lanes(powm_isa::ifma));
+  if ( f > w ) w = f;
+  const usize p = powm_itch_max(n);
+  if ( p > w ) w = p;
+  return w;
+}
+
+// builds the table for base b, modulus m (odd, n limbs, top one nonzero) and exponents of up to ebits bits in k-bit
+// windows, 1 <= k <= 8, into tp (powm_fb_table_limbs(n, ebits, k) limbs); both tp and mp must outlive the context
+//
+// windows * 2^k entries at k squarings + 2^k - 2 multiplies a window: worth it past a few dozen exponents per base
+inline powm_fb_ctx
+powm_fb_make(limb_t *tp, const limb_t *bp, usize bn, const limb_t *mp, usize n, usize ebits, usize k, limb_t *scratch) noexcept
+{
+  const powm_isa isa = n <= powm_batch_max_limbs ? active_powm_isa() : powm_isa::scalar;
+  const u32 d = powm_batch_digit_bits(isa);
+  const usize nd = isa == powm_isa::scalar ? n : __pb::__digits(n, d);
+  const usize windows = ebits == 0 ? 1u : (ebits + k - 1u) / k;
+  const usize entries = usize{ 1 } << k;
+  const powm_fb_ctx ctx{ tp, mp, n, k, windows, nd, isa };
+
+  const mont_ctx c = mont_make(mp, n);
+  limb_t *const sq = scratch;      // b^(2^(k i)) R
+  limb_t *const cur = sq + n;
+  limb_t *const one = cur + n;      // R mod m
+  limb_t *const rr = one + n;       // the lanes' R mod m
+  limb_t *const y = rr + n;
+  limb_t *const work = y + n;
+
+  // the lanes want x R_lanes, not x R: one more multiply by R_lanes on the way in
+  if ( isa != powm_isa::scalar ) {
+    const limb_t u = 1;
+    __pb::__rmod(rr, &u, 1, nd * d, mp, n, work);
+  }
+  auto store = [&](limb_t *dst, const limb_t *x) {
+    if ( isa == powm_isa::scalar ) {
+      copyi(dst, x, n);
+      return;
+    }
+    mont_mul(y, x, rr, c, work);
+    __pb::__to_digits(dst, 1, y, n, nd, d);
+  };
+
+  mont_one(one, c, work);
+  to_mont(sq, bp, bn, c, work);
+  from_mont(tp + windows * entries * nd, sq, c, work);
+  for ( usize i = 0; i < windows; ++i ) {
+    limb_t *const row = tp + i * entries * nd;
+    store(row, one);
+    store(row + nd, sq);
+    copyi(cur, sq, n);
+    for ( usize e = 2; e < entries; ++e ) {
+      mont_mul(cur, cur, sq, c, work);
+      store(row + e * nd, cur);
+    }
+    if ( i + 1u < windows )
+      for ( usize s = 0; s < k; ++s ) mont_sqr(sq, sq, c, work);
+  }
+  return ctx;
+}
+
+// rp = b^e mod m for the context's base and modulus; scratch holds powm_fb_itch(n). e of at most k * windows bits
+// reads the table, a longer one is a plain powm of the stored base
+inline void
+powm_fb(const powm_fb_ctx &c, limb_t *rp, const limb_t *ep, usize en, limb_t *scratch) noexcept
+{
+  const usize n = c.n;
+  if ( __pb::__fb_long(c, ep, en) ) {
+    powm(rp, __pb::__fb_base(c), n, ep, en, c.mp, n, scratch);
+    return;
+  }
+  if ( c.isa == powm_isa::scalar ) {
+    if ( n == 1 && c.mp[0] == 1 ) {
+      rp[0] = 0;
+      return;
+    }
+    const mont_ctx mc = mont_make(c.mp, n);
+    const usize entries = usize{ 1 } << c.k;
+    limb_t *const acc = scratch;
+    limb_t *const work = acc + n;
+    // plain times x R, REDC'd: plain again
+    zero(acc, n);
+    acc[0] = 1;
+    for ( usize i = 0; i < c.windows; ++i ) {
+      const usize d = __pb::__window(ep, en, i * c.k, c.k);
+      if ( d != 0 ) mont_mul(acc, acc, c.tp + (i * entries + d) * n, mc, work);
+    }
+    copyi(rp, acc, n);
+    return;
+  }
+  const powm_fb_job j{ rp, ep, en };
+  const usize ix[8] = {};
+#if defined(__micron_arch_amd64)
+  if ( c.isa == powm_isa::ifma )
+    __pb::__fb_group<__pb::__ifma>(c, &j, ix, 1, scratch);
+  else
+    __pb::__fb_group<__pb::__avx2>(c, &j, ix, 1, scratch);
+#endif
+}
+
+// jobs[i].rp = b^e_i mod m for i < count; scratch holds powm_fb_itch(n)
+inline void
+powm_fb_batch(const powm_fb_ctx &c, const powm_fb_job *jobs, usize count, limb_t *scratch) noexcept
+{
+  if ( c.isa == powm_isa::scalar ) {
+    for ( usize i = 0; i < count; ++i ) powm_fb(c, jobs[i].rp, jobs[i].ep, jobs[i].en, scratch);
+    return;
+  }
+#if defined(__micron_arch_amd64)
+  const usize lanes = powm_batch_lanes(c.isa);
+  usize ix[8];
+  usize cnt = 0;
+  auto flush = [&]() {
+    if ( c.isa == powm_isa::ifma )
+      __pb::__fb_group<__pb::__ifma>(c, jobs, ix, cnt, scratch);
+    else
+      __pb::__fb_group<__pb::__avx2>(c, jobs, ix, cnt, scratch);
+    cnt = 0;
+  };
+  for ( usize i = 0; i < count; ++i ) {
+    const powm_fb_job &j = jobs[i];
+    if ( __pb::__fb_long(c, j.ep, j.en) ) {
+      powm(j.rp, __pb::__fb_base(c), c.n, j.ep, j.en, c.mp, c.n, scratch);
+      continue;
+    }
+    ix[cnt++] = i;
+    if ( cnt == lanes ) flush();
+  }
+  if ( cnt != 0 ) flush();
+#endif
+}
+
+};      // namespace mpn
+};      // namespace math
+};      // namespace micron
@@ -0,0 +1,122 @@
+//  Copyright (c) 2024- David Lucius Severus
+//
+//  Distributed under the Boost Software License, Version 1.0.
+//  See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt
+#pragma once
+
+#include "../../bits/__abc_mt.hpp"      // autofires MICRON_ABC_MT; must precede abcmalloc
+
+#include "../../parallel/engine.hpp"
+#include "../../types.hpp"
+#include "limb.hpp"
+#include "mpn_core.hpp"
+#include "powm_batch.hpp"
+
+// ^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^
+// batched modular exponentiation on the coroutine engine
+//
+// the jobs are cut into at most powm_batch_mt_max_blocks blocks, each a whole number of lane groups, and every block
+// runs the serial powm_batch / powm_fb_batch on its own slice of scratch. the jobs are independent: no carries, no join work
+//
+// scratch, in limbs: blocks x the serial itch. the block count depends on the batch alone, never on the engine, so the
+// itch and the task agree whether or not the runtime has started; __pblocks spreads the blocks over whatever workers
+// there are
+//
+// NOTE: *_mt entry points sync_wait on the engine, never call them from inside a task; co_await the *_task versions there
+
+namespace micron
+{
+namespace math
+{
+namespace mpn
+{
+
+inline constexpr usize powm_batch_mt_max_blocks = 64;
+
+// blocks a batch of count jobs is cut into, lanes jobs to a group
+[[nodiscard]] inline constexpr usize
+powm_batch_mt_blocks(usize count, usize lanes) noexcept
+{
+  const usize groups = (count + lanes - 1u) / lanes;
+  return groups < powm_batch_mt_max_blocks ? groups : powm_batch_mt_max_blocks;
+}
+
+[[nodiscard]] inline usize
+powm_batch_mt_itch(usize count, usize n, usize bn, usize ebits) noexcept
+{
+  const powm_isa isa = n <= powm_batch_max_limbs ? active_powm_isa() : powm_isa::scalar;
+  return powm_batch_mt_blocks(count, powm_batch_lanes(isa)) * powm_batch_itch(n, bn, ebits);
+}
+
+[[nodiscard]] inline usize
+powm_fb_batch_mt_itch(const powm_fb_ctx &c, usize count) noexcept
+{
+  return powm_batch_mt_blocks(count, powm_batch_lanes(c.isa)) * powm_fb_itch(c.n);
+}
+
+// powm_batch on the engine; co_await it from inside a task
+inline micron::task<void>
+powm_batch_task(const powm_job *jobs, usize count, usize n, limb_t *scratch)
+{
+  if ( count == 0 || n == 0 ) co_return;
+  const powm_isa isa = n <= powm_batch_max_limbs ? active_powm_isa() : powm_isa::scalar;
+  const usize lanes = powm_batch_lanes(isa);
+  const usize nb = powm_batch_mt_blocks(count, lanes);
+
+  // the widest base and exponent actually present; the caller's bounds are at least these
+  usize bn = 1, ebits = 0;
+  for ( usize i = 0; i < count; ++i ) {
+    if ( jobs[i].bn > bn ) bn = jobs[i].bn;
+    const usize e = bitlen(jobs[i].ep, normalize(jobs[i].ep, jobs[i].en));
+    if ( e > ebits ) ebits = e;
+  }
+  const usize stride = powm_batch_itch(n, bn, ebits);
+  const usize per = ((count + lanes - 1u) / lanes + nb - 1u) / nb * lanes;
+
+  auto body = [=](usize b) {
+    const usize lo = b * per;
+    if ( lo >= count ) return;
+    const usize hi = lo + per < count ? lo + per : count;
+    powm_batch(jobs + lo, hi - lo, n, scratch + b * stride);
+  };
+  co_await parallel::__pblocks<decltype(body)>(0, nb, body, 1);
+}
+
+// powm_fb_batch on the engine
+inline micron::task<void>
+powm_fb_batch_task(const powm_fb_ctx &c, const powm_fb_job *jobs, usize count, limb_t *scratch)
+{
+  if ( count == 0 ) co_return;
+  const usize lanes = powm_batch_lanes(c.isa);
+  const usize nb = powm_batch_mt_blocks(count, lanes);
+  const usize stride = powm_fb_itch(c.n);
+  const usize per = ((count + lanes - 1u) / lanes + nb - 1u) / nb * lanes;
+  const powm_fb_ctx *cp = &c;
+
+  auto body = [=](usize b) {
+    const usize lo = b * per;
+    if ( lo >= count ) return;
+    const usize hi = lo + per < count ? lo + per : count;
+    powm_fb_batch(*cp, jobs + lo, hi - lo, scratch + b * stride);
+  };
+  co_await parallel::__pblocks<decltype(body)>(0, nb, body, 1);
+}
+
+// multithreaded powm_batch; blocks until done, call from outside the engine. scratch holds powm_batch_mt_itch limbs
+inline void
+powm_batch_mt(const powm_job *jobs, usize count, usize n, limb_t *scratch)
+{
+  micron::coro::sync_wait(powm_batch_task(jobs, count, n, scratch));
+}
+
+// multithreaded powm_fb_batch; scratch holds powm_fb_batch_mt_itch(c, count) limbs
+inline void
+powm_fb_batch_mt(const powm_fb_ctx &c, const powm_fb_job *jobs, usize count, limb_t *scratch)
+{
+  micron::coro::sync_wait(powm_fb_batch_task(c, jobs, count, scratch));
+}
+
+};      // namespace mpn
+};      // namespace math
+};      // namespace micron
@@ -8,6 +8,12 @@
 #include "../../types.hpp"
 #include "limb.hpp"
 #include "tags.hpp"
+#include "tuning.hpp"
+
+// a header of measured crossovers, as benches/arbint_crossover_bench.cpp --emit writes it
+#if defined(MICRON_ARBINT_TUNING_HEADER)
+#include MICRON_ARBINT_TUNING_HEADER
+#endif
 
 // ^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^
 // tier crossovers
@@ -27,9 +33,14 @@
 //                       bits, 1.7x at 8192, breaks even around 32768, and wins 2.4x at 65536 bits
 //                       (534k vs 1263k cycles)
 //   *_COMBA             UNSELECTED
+//   MUL_NUSSBAUMER 8192 the FFT tier is the three-prime NTT. not swept on this box yet: set from the
+//   SQR_NUSSBAUMER 6144 FFT references below, padded up for a power-of-two-only transform. squaring
+//                       saves one of three transforms, so it crosses lower
+//   SQR_TOOM4           UNSELECTED. toom-4 squaring was never enabled (the sqr cap sat at toom-3),
+//                       its band defaults to empty so the ladder goes toom-3 -> NTT
 //
-// TODO: we eventually want to dispatch tiers according to arch, rough references below
-// relative refs per arch
+// the mul / sqr / div crossovers are picked per cpu at runtime (tuning.hpp) unless the build pins any of them, the
+// per-arch tables there are scaled from these references. rough references per arch
 //  karatsuba    12 .. 28      (haswell 20, skylake 26, zen 16, zen3 20)
 //  toom-3       53 .. 125     (skylake 73, zen 107, zen3 89)
 //  toom-4       93 .. 324     (skylake 208, zen3 130)
@@ -37,6 +48,23 @@
 //  DC_DIV       19 .. 76      (skylake 55)
 //  MU_DIV      855 .. 1899    (skylake 1528)
 
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+// runtime tables, on unless a ladder threshold is pinned
+#ifndef MICRON_ARBINT_RUNTIME_TUNING
+#if defined(MICRON_ARBINT_MUL_COMBA_THRESHOLD) || defined(MICRON_ARBINT_MUL_KARATSUBA_THRESHOLD)                                    \
+    || defined(MICRON_ARBINT_MUL_TOOM3_THRESHOLD) || defined(MICRON_ARBINT_MUL_TOOM4_THRESHOLD)                                      \
+    || defined(MICRON_ARBINT_MUL_NUSSBAUMER_THRESHOLD) || defined(MICRON_ARBINT_SQR_COMBA_THRESHOLD)                                 \
+    || defined(MICRON_ARBINT_SQR_KARATSUBA_THRESHOLD) || defined(MICRON_ARBINT_SQR_TOOM3_THRESHOLD)                                  \
+    || defined(MICRON_ARBINT_SQR_TOOM4_THRESHOLD) || defined(MICRON_ARBINT_SQR_NUSSBAUMER_THRESHOLD)                                 \
+    || defined(MICRON_ARBINT_DIV_DC_THRESHOLD) || defined(MICRON_ARBINT_DIV_MU_THRESHOLD)
+#define MICRON_ARBINT_RUNTIME_TUNING 0
+#elif defined(__micron_arch_x86_any) && defined(__micron_arch_width_64)
+#define MICRON_ARBINT_RUNTIME_TUNING 1
+#else
+#define MICRON_ARBINT_RUNTIME_TUNING 0
+#endif
+#endif
+
 // %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
 // mul
 #if defined(__micron_arch_width_64)
@@ -54,7 +82,7 @@
 #define MICRON_ARBINT_MUL_TOOM4_THRESHOLD 320
 #endif
 #ifndef MICRON_ARBINT_MUL_NUSSBAUMER_THRESHOLD
-#define MICRON_ARBINT_MUL_NUSSBAUMER_THRESHOLD 50000
+#define MICRON_ARBINT_MUL_NUSSBAUMER_THRESHOLD 8192
 #endif
 
 #ifndef MICRON_ARBINT_SQR_COMBA_THRESHOLD
@@ -67,10 +95,10 @@
 #define MICRON_ARBINT_SQR_TOOM3_THRESHOLD 512
 #endif
 #ifndef MICRON_ARBINT_SQR_TOOM4_THRESHOLD
-#define MICRON_ARBINT_SQR_TOOM4_THRESHOLD 2048
+#define MICRON_ARBINT_SQR_TOOM4_THRESHOLD MICRON_ARBINT_SQR_NUSSBAUMER_THRESHOLD
 #endif
 #ifndef MICRON_ARBINT_SQR_NUSSBAUMER_THRESHOLD
-#define MICRON_ARBINT_SQR_NUSSBAUMER_THRESHOLD 40000
+#define MICRON_ARBINT_SQR_NUSSBAUMER_THRESHOLD 6144
 #endif
 
 #ifndef MICRON_ARBINT_DIV_DC_THRESHOLD
@@ -171,12 +199,22 @@
 
 #endif
 
+// the NTT tier (mul_ntt.hpp) needs the 128-bit double limb, 32-bit targets stop at toom-4
+#if defined(__micron_arch_width_64)
+#ifndef MICRON_ARBINT_MUL_TIER_CAP
+#define MICRON_ARBINT_MUL_TIER_CAP 5
+#endif
+#ifndef MICRON_ARBINT_SQR_TIER_CAP
+#define MICRON_ARBINT_SQR_TIER_CAP 5
+#endif
+#else
 #ifndef MICRON_ARBINT_MUL_TIER_CAP
 #define MICRON_ARBINT_MUL_TIER_CAP 4
 #endif
 #ifndef MICRON_ARBINT_SQR_TIER_CAP
 #define MICRON_ARBINT_SQR_TIER_CAP 3
 #endif
+#endif
 
 #ifndef MICRON_ARBINT_DIV_TIER_CAP
 #define MICRON_ARBINT_DIV_TIER_CAP 1
@@ -266,45 +304,128 @@ static_assert(powm_engine <= 2, "arbint: MICRON_ARBINT_POWM_ENGINE is 0 auto, 1
 static_assert(hgcd2_window == 1u || hgcd2_window == 2u,
               "arbint: MICRON_ARBINT_HGCD2_WINDOW is 1 (Knuth, one limb) or 2 (Jebelean, two limbs)");
 
+inline constexpr bool runtime_tuning = MICRON_ARBINT_RUNTIME_TUNING != 0;
+
+inline constexpr tuning compiled = { mul_comba, mul_karatsuba, mul_toom3, mul_toom4, mul_nussbaumer, sqr_comba,
+                                     sqr_karatsuba, sqr_toom3, sqr_toom4, sqr_nussbaumer, div_dc, div_mu };
+
+// the lowest crossover any table can put in force; *_itch sizes against this, never against the active table
+inline constexpr tuning lowest
+    = runtime_tuning ? tuning_min(tuning_min(tuning_min(compiled, tuning_zen), tuning_min(tuning_zen3, tuning_haswell)), tuning_skylake)
+                     : compiled;
+
+static_assert(tuning_ascends(lowest), "arbint: tuning table thresholds must ascend");
+
 };      // namespace threshold
 
+// %%%%%%%%%%%%%%%%%%%
+// tuning tables
+
+[[nodiscard]] inline constexpr const tuning &
+tuning_table(tuning_arch a) noexcept
+{
+  if constexpr ( !threshold::runtime_tuning ) return threshold::compiled;
+  switch ( a ) {
+  case tuning_arch::zen:
+    return tuning_zen;
+  case tuning_arch::zen3:
+    return tuning_zen3;
+  case tuning_arch::haswell:
+    return tuning_haswell;
+  case tuning_arch::skylake:
+    return tuning_skylake;
+  default:
+    return threshold::compiled;
+  }
+}
+
+// the table the ladders run on, probed on first use
+[[nodiscard]] inline tuning_arch
+active_tuning_arch() noexcept
+{
+  if constexpr ( !threshold::runtime_tuning ) return tuning_arch::compiled;
+  u32 v = atom::load(&__tuning::__arch, __ATOMIC_RELAXED);
+  if ( v == __tuning::__unset ) [[unlikely]] {
+    v = static_cast<u32>(tuning_arch_of(tuning_probe()));
+    atom::store(&__tuning::__arch, v, __ATOMIC_RELAXED);
+  }
+  return static_cast<tuning_arch>(v);
+}
+
+// pins a table (benchmarks, tests); a build without runtime tuning ignores it
+inline void
+set_tuning_arch(tuning_arch a) noexcept
+{
+  if ( static_cast<u32>(a) >= tuning_arch_count ) a = tuning_arch::compiled;
+  atom::store(&__tuning::__arch, static_cast<u32>(a), __ATOMIC_RELAXED);
+}
+
+// compiled under constant evaluation, the active table otherwise
+[[nodiscard, gnu::always_inline]] inline constexpr const tuning &
+current_tuning() noexcept
+{
+  if consteval {
+    return threshold::compiled;
+  } else {
+    return tuning_table(active_tuning_arch());
+  }
+}
+
 // %%%%%%%%%%%%%%%%%%%
 // ladders
 
 // mul ladder
 [[nodiscard, gnu::always_inline]] inline constexpr algo
-pick_mul(usize an, usize bn) noexcept
+pick_mul(const tuning &t, usize an, usize bn) noexcept
 {
   const usize n = an < bn ? an : bn;
-  if ( n < threshold::mul_comba ) return algo::basecase;
-  if ( n < threshold::mul_karatsuba ) return algo::comba;
-  if ( n < threshold::mul_toom3 ) return algo::karatsuba;
-  if ( n < threshold::mul_toom4 ) return algo::toom3;
-  if ( n < threshold::mul_nussbaumer ) return algo::toom4;
+  if ( n < t.mul_comba ) return algo::basecase;
+  if ( n < t.mul_karatsuba ) return algo::comba;
+  if ( n < t.mul_toom3 ) return algo::karatsuba;
+  if ( n < t.mul_toom4 ) return algo::toom3;
+  if ( n < t.mul_nussbaumer ) return algo::toom4;
   return algo::nussbaumer;
 }
 
+[[nodiscard, gnu::always_inline]] inline constexpr algo
+pick_mul(usize an, usize bn) noexcept
+{
+  return pick_mul(current_tuning(), an, bn);
+}
+
 // sqr ladder
 [[nodiscard, gnu::always_inline]] inline constexpr algo
-pick_sqr(usize n) noexcept
+pick_sqr(const tuning &t, usize n) noexcept
 {
-  if ( n < threshold::sqr_comba ) return algo::basecase;
-  if ( n < threshold::sqr_karatsuba ) return algo::comba;
-  if ( n < threshold::sqr_toom3 ) return algo::karatsuba;
-  if ( n < threshold::sqr_toom4 ) return algo::toom3;
-  if ( n < threshold::sqr_nussbaumer ) return algo::toom4;
+  if ( n < t.sqr_comba ) return algo::basecase;
+  if ( n < t.sqr_karatsuba ) return algo::comba;
+  if ( n < t.sqr_toom3 ) return algo::karatsuba;
+  if ( n < t.sqr_toom4 ) return algo::toom3;
+  if ( n < t.sqr_nussbaumer ) return algo::toom4;
   return algo::nussbaumer;
 }
 
+[[nodiscard, gnu::always_inline]] inline constexpr algo
+pick_sqr(usize n) noexcept
+{
+  return pick_sqr(current_tuning(), n);
+}
+
 // divison ladder
 [[nodiscard, gnu::always_inline]] inline constexpr divalgo
-pick_div(usize nn, usize dn) noexcept
+pick_div(const tuning &t, usize nn, usize dn) noexcept
 {
-  if ( dn < threshold::div_dc ) return divalgo::sbpi1;
-  if ( dn < threshold::div_mu ) return divalgo::dc;
+  if ( dn < t.div_dc ) return divalgo::sbpi1;
+  if ( dn < t.div_mu ) return divalgo::dc;
   return (nn >= dn && (nn - dn) >= dn) ? divalgo::mu : divalgo::dc;
 }
 
+[[nodiscard, gnu::always_inline]] inline constexpr divalgo
+pick_div(usize nn, usize dn) noexcept
+{
+  return pick_div(current_tuning(), nn, dn);
+}
+
 inline constexpr divalgo div_tier_cap = static_cast<divalgo>(MICRON_ARBINT_DIV_TIER_CAP);
 
 // gcd ladder
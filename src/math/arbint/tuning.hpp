@@ -0,0 +1,184 @@
+//  Copyright (c) 2024- David Lucius Severus
+//
+//  Distributed under the Boost Software License, Version 1.0.
+//  See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt
+#pragma once
+
+#include "../../atomic/intrin.hpp"
+#include "../../bits/__arch.hpp"
+#include "../../bits/__cpuid.hpp"
+#include "../../types.hpp"
+
+// ^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^
+// runtime tier crossovers
+//
+// one binary runs on every machine of a fleet: the mul / sqr / div ladders read their crossovers from a table picked
+// on first use from the cpuid vendor / family / model, everything else in thresholds.hpp stays compiled
+//
+//   compiled   the MICRON_ARBINT_* values (thresholds.hpp), what constant evaluation always sees
+//   zen        amd 17h (and hygon 18h). the zen+ box the compiled defaults were swept on
+//   zen3       amd 19h, 1ah
+//   haswell    intel 6/3c 3f 45 46, broadwell with it
+//   skylake    intel 6/4e 5e 55 (skylake, skylake-sp / cascade / cooper lake), 8e 9e a5 a6 (kaby .. comet lake), 66
+//              (cannon lake); the skylake core and its refreshes only. every other intel model (atom, xeon phi, ice
+//              lake on) takes compiled until it gets its own sweep
+//
+// only zen is measured. the others move the rows the references in thresholds.hpp cover on both sides, scaled by
+// (their ref / zen ref) from the zen+ sweep; rows with no zen reference keep the zen+ value
+//
+// a build that pins any of these thresholds (-D, or a header from benches/arbint_crossover_bench.cpp --emit) turns
+// this off and keeps the compiled table
+//
+// NOTE: cpuid is x86 only, every other target runs the compiled table
+
+namespace micron
+{
+namespace math
+{
+namespace mpn
+{
+
+struct tuning {
+  usize mul_comba;
+  usize mul_karatsuba;
+  usize mul_toom3;
+  usize mul_toom4;
+  usize mul_nussbaumer;
+  usize sqr_comba;
+  usize sqr_karatsuba;
+  usize sqr_toom3;
+  usize sqr_toom4;
+  usize sqr_nussbaumer;
+  usize div_dc;
+  usize div_mu;
+};
+
+enum class tuning_arch : u32 { compiled = 0, zen, zen3, haswell, skylake };
+
+inline constexpr usize tuning_arch_count = 5;
+
+// comba stays unselected (== karatsuba) and the toom-3 mul / toom-4 sqr bands stay empty, as in the compiled defaults
+inline constexpr tuning tuning_zen = { 20, 20, 320, 320, 8192, 32, 32, 512, 6144, 6144, 320, 1536 };
+inline constexpr tuning tuning_zen3 = { 25, 25, 320, 320, 8192, 40, 40, 426, 6144, 6144, 320, 1536 };
+inline constexpr tuning tuning_haswell = { 25, 25, 320, 320, 8192, 40, 40, 512, 6144, 6144, 320, 1536 };
+inline constexpr tuning tuning_skylake = { 32, 32, 320, 320, 8192, 52, 52, 349, 6144, 6144, 320, 1536 };
+
+[[nodiscard]] inline constexpr bool
+tuning_ascends(const tuning &t) noexcept
+{
+  return t.mul_comba >= 1 && t.mul_comba <= t.mul_karatsuba && t.mul_karatsuba <= t.mul_toom3 && t.mul_toom3 <= t.mul_toom4
+         && t.mul_toom4 <= t.mul_nussbaumer && t.sqr_comba >= 1 && t.sqr_comba <= t.sqr_karatsuba && t.sqr_karatsuba <= t.sqr_toom3
+         && t.sqr_toom3 <= t.sqr_toom4 && t.sqr_toom4 <= t.sqr_nussbaumer && t.mul_karatsuba >= 2 && t.sqr_karatsuba >= 2
+         && t.div_dc <= t.div_mu;
+}
+
+static_assert(tuning_ascends(tuning_zen) && tuning_ascends(tuning_zen3) && tuning_ascends(tuning_haswell) && tuning_ascends(tuning_skylake),
+              "arbint: tuning table thresholds must ascend");
+
+// elementwise min, the scratch side sizes against it
+[[nodiscard]] inline constexpr tuning
+tuning_min(const tuning &a, const tuning &b) noexcept
+{
+  auto m = [](usize x, usize y) { return x < y ? x : y; };
+  return { m(a.mul_comba, b.mul_comba),         m(a.mul_karatsuba, b.mul_karatsuba), m(a.mul_toom3, b.mul_toom3),
+           m(a.mul_toom4, b.mul_toom4),         m(a.mul_nussbaumer, b.mul_nussbaumer), m(a.sqr_comba, b.sqr_comba),
+           m(a.sqr_karatsuba, b.sqr_karatsuba), m(a.sqr_toom3, b.sqr_toom3),         m(a.sqr_toom4, b.sqr_toom4),
+           m(a.sqr_nussbaumer, b.sqr_nussbaumer), m(a.div_dc, b.div_dc),             m(a.div_mu, b.div_mu) };
+}
+
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+// cpu signature
+
+enum class tuning_vendor : u32 { unknown = 0, intel, amd };
+
+struct tuning_cpu {
+  tuning_vendor vendor;
+  u32 family;      // display family, base + extended
+  u32 model;       // display model, extended model folded in
+};
+
+[[nodiscard]] inline tuning_cpu
+tuning_probe() noexcept
+{
+  tuning_cpu c{ tuning_vendor::unknown, 0, 0 };
+#if defined(__micron_arch_x86_any)
+  const cpuid_regs l0 = __cpuid_read(0u);
+  // "GenuineIntel", "AuthenticAMD", "HygonGenuine" by their ebx word
+  if ( l0.ebx == 0x756e6547u )
+    c.vendor = tuning_vendor::intel;
+  else if ( l0.ebx == 0x68747541u || l0.ebx == 0x6f677948u )
+    c.vendor = tuning_vendor::amd;
+  if ( l0.eax < 1u ) return c;
+  const u32 a = __cpuid_read(1u).eax;
+  const u32 base = (a >> 8) & 0xfu;
+  c.family = base == 0xfu ? base + ((a >> 20) & 0xffu) : base;
+  c.model = (a >> 4) & 0xfu;
+  if ( base == 0x6u || base == 0xfu ) c.model |= ((a >> 16) & 0xfu) << 4;
+#endif
+  return c;
+}
+
+[[nodiscard]] inline constexpr tuning_arch
+tuning_arch_of(const tuning_cpu &c) noexcept
+{
+  if ( c.vendor == tuning_vendor::amd ) {
+    if ( c.family == 0x17u || c.family == 0x18u ) return tuning_arch::zen;
+    if ( c.family == 0x19u || c.family == 0x1au ) return tuning_arch::zen3;
+    return tuning_arch::compiled;
+  }
+  if ( c.vendor == tuning_vendor::intel && c.family == 6u ) {
+    switch ( c.model ) {
+    case 0x3cu:
+    case 0x3fu:
+    case 0x45u:
+    case 0x46u:
+    case 0x3du:
+    case 0x47u:
+    case 0x4fu:
+    case 0x56u:
+      return tuning_arch::haswell;
+    case 0x4eu:
+    case 0x5eu:
+    case 0x55u:
+    case 0x8eu:
+    case 0x9eu:
+    case 0xa5u:
+    case 0xa6u:
+    case 0x66u:
+      return tuning_arch::skylake;
+    default:
+      break;
+    }
+  }
+  return tuning_arch::compiled;
+}
+
+[[nodiscard]] inline constexpr const char *
+tuning_arch_name(tuning_arch a) noexcept
+{
+  switch ( a ) {
+  case tuning_arch::zen:
+    return "zen";
+  case tuning_arch::zen3:
+    return "zen3";
+  case tuning_arch::haswell:
+    return "haswell";
+  case tuning_arch::skylake:
+    return "skylake";
+  default:
+    return "compiled";
+  }
+}
+
+namespace __tuning
+{
+
+inline constexpr u32 __unset = ~u32{ 0 };
+inline u32 __arch = __unset;
+
+};      // namespace __tuning
+
+};      // namespace mpn
+};      // namespace math
+};      // namespace micron
@@ -0,0 +1,504 @@
+//  Copyright (c) 2024- David Lucius Severus
+//
+//  Distributed under the Boost Software License, Version 1.0.
+//  See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt
+#pragma once
+
+#include "../../bits/__abc_mt.hpp"      // autofires MICRON_ABC_MT; must precede abcmalloc
+
+#include "../../bits/__arch.hpp"
+#include "../../bits/__cpuid.hpp"
+#include "../../concepts.hpp"
+#include "../../types.hpp"
+
+#include "../../atomic/intrin.hpp"
+#include "../../parallel/engine.hpp"
+#include "../../simd/intrin.hpp"
+#include "../../vector/vector.hpp"
+
+#include "../matrix/pack.hpp"
+#include "level3.hpp"
+
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+// multithreaded packed gemm
+//
+// GotoBLAS loop order on the coroutine engine. the jc (NC) and pc (KC) loops stay serial; for every (jc, pc) step the workers first
+// pack the KC x NC panel of B together into one shared buffer (sized to sit in L3, all workers stream it), then split the ic (MC) loop,
+// and the jr loop too when M alone gives too few blocks to go round. each block packs its own MC x KC slice of A into the worker's
+// thread local buffer (pack::__tls_pack_a, L2 sized) and runs the microkernel over it. both phases are __pblocks fork/joins
+//
+// microkernels are picked at runtime, once:
+//  avx512   12x16 f64 / 12x32 f32, gnu::target("avx512f"), used when cpuid and XCR0 both say zmm is live, whatever the build flags;
+//           f32 only from __zmm_f32_min_flops up
+//  neon     8x4 f64 / 8x8 f32 on arm64 (NEON is baseline there, so this is the build's choice)
+//  native   pack.hpp's compile time kernel (6x8 / 8x8 AVX2+FMA, 4x4 / 4x8 NEON, scalar otherwise)
+//
+// level3::gemm stays single threaded and light on includes; this header is opt in since it pulls the coroutine runtime. the blocking
+// gemm_mt entry points sync_wait on the engine, never call them from inside a task; co_await gemm_task there instead
+//
+// NOTE: one shared B panel per step, not one per L3 domain; on a multi socket box the far socket streams it across the interconnect
+
+namespace micron
+{
+namespace math
+{
+namespace blas
+{
+
+enum class gemm_isa : u32 { native = 0, avx512, neon };
+
+namespace __gemm_mt
+{
+
+inline constexpr u32 __isa_unset = ~u32{ 0 };
+inline u32 __isa = __isa_unset;
+
+#if defined(__micron_arch_x86_any)
+inline u64
+__xgetbv0() noexcept
+{
+  u32 __lo, __hi;
+  __asm__ __volatile__("xgetbv" : "=a"(__lo), "=d"(__hi) : "c"(0u));
+  return (static_cast<u64>(__hi) << 32) | __lo;
+}
+#endif
+
+inline gemm_isa
+__probe() noexcept
+{
+#if defined(__micron_arch_x86_any)
+  if ( !__cpuid_has_leaf(7u) ) return gemm_isa::native;
+  const cpuid_regs __l1 = __cpuid_read(1u);
+  const bool __osxsave = (__l1.ecx >> 27) & 1u;
+  const bool __fma = (__l1.ecx >> 12) & 1u;
+  if ( !__osxsave or !__fma ) return gemm_isa::native;
+  // the OS has to save opmask + both zmm halves, not just ymm
+  if ( (__xgetbv0() & 0xe6u) != 0xe6u ) return gemm_isa::native;
+  const cpuid_regs __l7 = __cpuid_read(7u, 0u);
+  if ( (__l7.ebx >> 16) & 1u ) return gemm_isa::avx512;
+  return gemm_isa::native;
+#elif defined(__micron_arch_arm64) && defined(__micron_arm_neon)
+  return gemm_isa::neon;
+#else
+  return gemm_isa::native;
+#endif
+}
+
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+// microkernels, same contract as pack::micro_kernel: C[MR x NR] = alpha * Ap * Bp + beta * C over packed panels
+
+#if defined(__micron_arch_x86_any)
+
+template<typename T, usize NR>
+[[gnu::target("avx512f")]] inline void
+__store_rows_avx512(T *C, ssize_t rs_C, ssize_t cs_C, const T *acc, usize rows, T alpha, T beta) noexcept
+{
+  for ( usize i = 0; i < rows; ++i )
+    for ( usize j = 0; j < NR; ++j ) {
+      T &c = C[ssize_t(i) * rs_C + ssize_t(j) * cs_C];
+      c = (beta == T(0)) ? alpha * acc[i * NR + j] : alpha * acc[i * NR + j] + beta * c;
+    }
+}
+
+[[gnu::target("avx512f"), gnu::flatten]] inline void
+__ukr_12x16_avx512_f64(const double *Ap, const double *Bp, usize k, double alpha, double beta, double *C, ssize_t rs_C,
+                       ssize_t cs_C) noexcept
+{
+  __m512d c0[12], c1[12];
+#pragma GCC unroll 12
+  for ( usize i = 0; i < 12; ++i ) c0[i] = c1[i] = _mm512_setzero_pd();
+  for ( usize p = 0; p < k; ++p ) {
+    const __m512d b0 = _mm512_loadu_pd(Bp + p * 16 + 0);
+    const __m512d b1 = _mm512_loadu_pd(Bp + p * 16 + 8);
+    const double *a = Ap + p * 12;
+#pragma GCC unroll 12
+    for ( usize i = 0; i < 12; ++i ) {
+      const __m512d ai = _mm512_set1_pd(a[i]);
+      c0[i] = _mm512_fmadd_pd(ai, b0, c0[i]);
+      c1[i] = _mm512_fmadd_pd(ai, b1, c1[i]);
+    }
+  }
+  const __m512d va = _mm512_set1_pd(alpha);
+  if ( cs_C != 1 ) {
+    alignas(64) double t[12 * 16];
+    for ( usize i = 0; i < 12; ++i ) {
+      _mm512_storeu_pd(t + i * 16 + 0, c0[i]);
+      _mm512_storeu_pd(t + i * 16 + 8, c1[i]);
+    }
+    __store_rows_avx512<double, 16>(C, rs_C, cs_C, t, 12, alpha, beta);
+    return;
+  }
+  const __m512d vb = _mm512_set1_pd(beta);
+#pragma GCC unroll 12
+  for ( usize i = 0; i < 12; ++i ) {
+    double *r = C + ssize_t(i) * rs_C;
+    if ( beta == 0.0 ) {
+      _mm512_storeu_pd(r + 0, _mm512_mul_pd(va, c0[i]));
+      _mm512_storeu_pd(r + 8, _mm512_mul_pd(va, c1[i]));
+    } else if ( beta == 1.0 ) {
+      _mm512_storeu_pd(r + 0, _mm512_fmadd_pd(va, c0[i], _mm512_loadu_pd(r + 0)));
+      _mm512_storeu_pd(r + 8, _mm512_fmadd_pd(va, c1[i], _mm512_loadu_pd(r + 8)));
+    } else {
+      _mm512_storeu_pd(r + 0, _mm512_fmadd_pd(va, c0[i], _mm512_mul_pd(vb, _mm512_loadu_pd(r + 0))));
+      _mm512_storeu_pd(r + 8, _mm512_fmadd_pd(va, c1[i], _mm512_mul_pd(vb, _mm512_loadu_pd(r + 8))));
+    }
+  }
+}
+
+[[gnu::target("avx512f"), gnu::flatten]] inline void
+__ukr_12x32_avx512_f32(const float *Ap, const float *Bp, usize k, float alpha, float beta, float *C, ssize_t rs_C, ssize_t cs_C) noexcept
+{
+  __m512 c0[12], c1[12];
+#pragma GCC unroll 12
+  for ( usize i = 0; i < 12; ++i ) c0[i] = c1[i] = _mm512_setzero_ps();
+  for ( usize p = 0; p < k; ++p ) {
+    const __m512 b0 = _mm512_loadu_ps(Bp + p * 32 + 0);
+    const __m512 b1 = _mm512_loadu_ps(Bp + p * 32 + 16);
+    const float *a = Ap + p * 12;
+#pragma GCC unroll 12
+    for ( usize i = 0; i < 12; ++i ) {
+      const __m512 ai = _mm512_set1_ps(a[i]);
+      c0[i] = _mm512_fmadd_ps(ai, b0, c0[i]);
+      c1[i] = _mm512_fmadd_ps(ai, b1, c1[i]);
+    }
+  }
+  const __m512 va = _mm512_set1_ps(alpha);
+  if ( cs_C != 1 ) {
+    alignas(64) float t[12 * 32];
+    for ( usize i = 0; i < 12; ++i ) {
+      _mm512_storeu_ps(t + i * 32 + 0, c0[i]);
+      _mm512_storeu_ps(t + i * 32 + 16, c1[i]);
+    }
+    __store_rows_avx512<float, 32>(C, rs_C, cs_C, t, 12, alpha, beta);
+    return;
+  }
+  const __m512 vb = _mm512_set1_ps(beta);
+#pragma GCC unroll 12
+  for ( usize i = 0; i < 12; ++i ) {
+    float *r = C + ssize_t(i) * rs_C;
+    if ( beta == 0.0f ) {
+      _mm512_storeu_ps(r + 0, _mm512_mul_ps(va, c0[i]));
+      _mm512_storeu_ps(r + 16, _mm512_mul_ps(va, c1[i]));
+    } else if ( beta == 1.0f ) {
+      _mm512_storeu_ps(r + 0, _mm512_fmadd_ps(va, c0[i], _mm512_loadu_ps(r + 0)));
+      _mm512_storeu_ps(r + 16, _mm512_fmadd_ps(va, c1[i], _mm512_loadu_ps(r + 16)));
+    } else {
+      _mm512_storeu_ps(r + 0, _mm512_fmadd_ps(va, c0[i], _mm512_mul_ps(vb, _mm512_loadu_ps(r + 0))));
+      _mm512_storeu_ps(r + 16, _mm512_fmadd_ps(va, c1[i], _mm512_mul_ps(vb, _mm512_loadu_ps(r + 16))));
+    }
+  }
+}
+
+#endif      // x86
+
+#if defined(__micron_arch_arm64) && defined(__micron_arm_neon)
+
+// 8 rows x 2 q registers, 16 accumulators out of 32
+[[gnu::flatten]] inline void
+__ukr_8x4_neon_f64(const double *Ap, const double *Bp, usize k, double alpha, double beta, double *C, ssize_t rs_C, ssize_t cs_C) noexcept
+{
+  if ( cs_C != 1 ) {
+    matrix::pack::micro_kernel_scalar<8, 4, double>(Ap, Bp, k, alpha, beta, C, rs_C, cs_C);
+    return;
+  }
+  float64x2_t c0[8], c1[8];
+#pragma GCC unroll 8
+  for ( usize i = 0; i < 8; ++i ) c0[i] = c1[i] = micron::simd::neon::splat_f64(0.0);
+  for ( usize p = 0; p < k; ++p ) {
+    const float64x2_t b0 = micron::simd::neon::load_f64(Bp + p * 4 + 0);
+    const float64x2_t b1 = micron::simd::neon::load_f64(Bp + p * 4 + 2);
+    const double *a = Ap + p * 8;
+#pragma GCC unroll 8
+    for ( usize i = 0; i < 8; ++i ) {
+      const float64x2_t ai = micron::simd::neon::splat_f64(a[i]);
+      c0[i] = micron::simd::neon::fma_f64(c0[i], ai, b0);
+      c1[i] = micron::simd::neon::fma_f64(c1[i], ai, b1);
+    }
+  }
+  const float64x2_t va = micron::simd::neon::splat_f64(alpha);
+  const float64x2_t vb = micron::simd::neon::splat_f64(beta);
+#pragma GCC unroll 8
+  for ( usize i = 0; i < 8; ++i ) {
+    double *r = C + ssize_t(i) * rs_C;
+    if ( beta == 0.0 ) {
+      micron::simd::neon::store_f64(r + 0, micron::simd::neon::mul(va, c0[i]));
+      micron::simd::neon::store_f64(r + 2, micron::simd::neon::mul(va, c1[i]));
+    } else {
+      micron::simd::neon::store_f64(r + 0,
+                                    micron::simd::neon::fma_f64(micron::simd::neon::mul(vb, micron::simd::neon::load_f64(r + 0)), va, c0[i]));
+      micron::simd::neon::store_f64(r + 2,
+                                    micron::simd::neon::fma_f64(micron::simd::neon::mul(vb, micron::simd::neon::load_f64(r + 2)), va, c1[i]));
+    }
+  }
+}
+
+[[gnu::flatten]] inline void
+__ukr_8x8_neon_f32(const float *Ap, const float *Bp, usize k, float alpha, float beta, float *C, ssize_t rs_C, ssize_t cs_C) noexcept
+{
+  if ( cs_C != 1 ) {
+    matrix::pack::micro_kernel_scalar<8, 8, float>(Ap, Bp, k, alpha, beta, C, rs_C, cs_C);
+    return;
+  }
+  float32x4_t c0[8], c1[8];
+#pragma GCC unroll 8
+  for ( usize i = 0; i < 8; ++i ) c0[i] = c1[i] = micron::simd::neon::splat_f32(0.0f);
+  for ( usize p = 0; p < k; ++p ) {
+    const float32x4_t b0 = micron::simd::neon::load_f32(Bp + p * 8 + 0);
+    const float32x4_t b1 = micron::simd::neon::load_f32(Bp + p * 8 + 4);
+    const float *a = Ap + p * 8;
+#pragma GCC unroll 8
+    for ( usize i = 0; i < 8; ++i ) {
+      const float32x4_t ai = micron::simd::neon::splat_f32(a[i]);
+      c0[i] = micron::simd::neon::fma_f32(c0[i], ai, b0);
+      c1[i] = micron::simd::neon::fma_f32(c1[i], ai, b1);
+    }
+  }
+  const float32x4_t va = micron::simd::neon::splat_f32(alpha);
+  const float32x4_t vb = micron::simd::neon::splat_f32(beta);
+#pragma GCC unroll 8
+  for ( usize i = 0; i < 8; ++i ) {
+    float *r = C + ssize_t(i) * rs_C;
+    if ( beta == 0.0f ) {
+      micron::simd::neon::store_f32(r + 0, micron::simd::neon::mul(va, c0[i]));
+      micron::simd::neon::store_f32(r + 4, micron::simd::neon::mul(va, c1[i]));
+    } else {
+      micron::simd::neon::store_f32(r + 0,
+                                    micron::simd::neon::fma_f32(micron::simd::neon::mul(vb, micron::simd::neon::load_f32(r + 0)), va, c0[i]));
+      micron::simd::neon::store_f32(r + 4,
+                                    micron::simd::neon::fma_f32(micron::simd::neon::mul(vb, micron::simd::neon::load_f32(r + 4)), va, c1[i]));
+    }
+  }
+}
+
+#endif      // arm64 NEON
+
+// pack.hpp's build time kernel for MR x NR, the same dispatch gemm_blocked does
+template<typename T, usize MR, usize NR>
+[[gnu::flatten]] inline void
+__ukr_native(const T *Ap, const T *Bp, usize k, T alpha, T beta, T *C, ssize_t rs_C, ssize_t cs_C) noexcept
+{
+#if defined(__AVX2__) && defined(__FMA__)
+  if constexpr ( MR == 6 && NR == 8 && sizeof(T) == 8 && ieee754_floating<T> ) {
+    matrix::pack::micro_kernel_6x8_avx2_f64_asm_unr4_sp(reinterpret_cast<const double *>(Ap), reinterpret_cast<const double *>(Bp), k,
+                                                        double(alpha), double(beta), reinterpret_cast<double *>(C), rs_C, cs_C);
+    return;
+  } else if constexpr ( MR == 8 && NR == 8 && sizeof(T) == 4 && ieee754_floating<T> ) {
+    matrix::pack::micro_kernel_8x8_avx2_f32(reinterpret_cast<const float *>(Ap), reinterpret_cast<const float *>(Bp), k, float(alpha),
+                                            float(beta), reinterpret_cast<float *>(C), rs_C, cs_C);
+    return;
+  }
+#endif
+  matrix::pack::micro_kernel<MR, NR, T>(Ap, Bp, k, alpha, beta, C, rs_C, cs_C);
+}
+
+template<typename T>
+using __ukr_fn = void (*)(const T *, const T *, usize, T, T, T *, ssize_t, ssize_t) noexcept;
+
+// blocking per kernel shape; MC * KC stays within pack::__tls_pack_a (72 * 256 doubles), KC * NC is the shared B panel (4 MiB)
+template<typename T, usize MR, usize NR> struct __shape {
+  static constexpr usize mr = MR;
+  static constexpr usize nr = NR;
+  static constexpr usize kc = 256;
+  static constexpr usize mc = ((matrix::pack::__pack_a_max_doubles * sizeof(double) / sizeof(T) / kc) / MR) * MR;
+  static constexpr usize nc = ((4096u * 1024u / sizeof(T) / kc) / NR) * NR;
+  static_assert(mc >= MR, "micron::blas::gemm_mt: MR too tall for the packed A buffer");
+};
+
+template<typename T, class S>
+micron::task<void>
+__run(usize m, usize n, usize k, T alpha, const T *A, ssize_t a_rs, ssize_t a_cs, const T *B, ssize_t b_rs, ssize_t b_cs, T beta, T *C,
+      ssize_t rs_C, ssize_t cs_C, __ukr_fn<T> ukr)
+{
+  constexpr usize MR = S::mr, NR = S::nr, KC = S::kc, MC = S::mc, NC = S::nc;
+  const usize Nc = n < NC ? ((n + NR - 1) / NR) * NR : NC;
+  const usize Kc = k < KC ? k : KC;
+  const usize W = (micron::coro::__global_engine != nullptr) ? micron::coro::__global_engine->n : 1u;
+
+  micron::vector<T, micron::allocator_serial<>, false> b_pack(Kc * Nc);
+  T *Bp = b_pack.data();
+
+  for ( usize jc = 0; jc < n; jc += NC ) {
+    const usize nc = (n - jc) < NC ? (n - jc) : NC;
+    const usize nsl = (nc + NR - 1) / NR;      // NR wide slivers in this panel
+    for ( usize pc = 0; pc < k; pc += KC ) {
+      const usize kc = (k - pc) < KC ? (k - pc) : KC;
+      const T beta_eff = (pc == 0) ? beta : T(1);
+
+      // every worker packs a run of slivers into the shared panel
+      {
+        const usize per = (nsl + 2 * W - 1) / (2 * W);
+        const usize nb = (nsl + per - 1) / per;
+        auto pack = [=](usize b) {
+          const usize s0 = b * per, s1 = (s0 + per < nsl) ? s0 + per : nsl;
+          const usize cols = ((s1 * NR < nc) ? s1 * NR : nc) - s0 * NR;
+          matrix::pack::pack_b_panel<NR, T>(B + ssize_t(pc) * b_rs + ssize_t(jc + s0 * NR) * b_cs, b_rs, b_cs, kc, cols, Bp + s0 * NR * kc);
+        };
+        co_await parallel::__pblocks<decltype(pack)>(0, nb, pack, 1);
+      }
+
+      // MC row blocks, each cut into jsplit sliver runs when there aren't enough of them to keep every worker busy
+      const usize nic = (m + MC - 1) / MC;
+      usize jsplit = 1;
+      while ( nic * jsplit < 2 * W and jsplit * 2 <= nsl ) jsplit *= 2;
+      const usize sper = (nsl + jsplit - 1) / jsplit;
+      auto body = [=](usize t) {
+        const usize ic = (t / jsplit) * MC;
+        const usize mc = (m - ic) < MC ? (m - ic) : MC;
+        const usize s0 = (t % jsplit) * sper, s1 = (s0 + sper < nsl) ? s0 + sper : nsl;
+        if ( s0 >= s1 ) return;
+        T *Ap = matrix::pack::__tls_pack_a<T>();
+        matrix::pack::pack_a_panel<MR, T>(A + ssize_t(ic) * a_rs + ssize_t(pc) * a_cs, a_rs, a_cs, mc, kc, Ap);
+        for ( usize s = s0; s < s1; ++s ) {
+          const usize jr = s * NR;
+          const usize nr_eff = (nc - jr) < NR ? (nc - jr) : NR;
+          const T *Bp_tile = Bp + s * NR * kc;
+          for ( usize ir = 0; ir < mc; ir += MR ) {
+            const usize mr_eff = (mc - ir) < MR ? (mc - ir) : MR;
+            const T *Ap_tile = Ap + (ir / MR) * MR * kc;
+            T *C_tile = C + ssize_t(ic + ir) * rs_C + ssize_t(jc + jr) * cs_C;
+            if ( mr_eff == MR && nr_eff == NR )
+              ukr(Ap_tile, Bp_tile, kc, alpha, beta_eff, C_tile, rs_C, cs_C);
+            else
+              matrix::pack::micro_kernel_partial<MR, NR, T>(mr_eff, nr_eff, Ap_tile, Bp_tile, kc, alpha, beta_eff, C_tile, rs_C, cs_C);
+          }
+        }
+      };
+      co_await parallel::__pblocks<decltype(body)>(0, nic * jsplit, body, 1);
+    }
+  }
+}
+
+// below this the fork/joins cost more than they save, the serial kernel takes it
+inline constexpr u64 __mt_min_flops = 96ull * 96ull * 96ull;
+
+// the 12x32 f32 zmm tile only wins reliably once the problem is large (benches/results/blas_gemm_mt.txt: anywhere from
+// 0.65x to 1.76x below 640^3, 1.4x+ from 640^3 up), and never when m or n is short of one tile; native takes the rest
+inline constexpr u64 __zmm_f32_min_flops = 640ull * 640ull * 640ull;
+
+[[gnu::always_inline]] inline constexpr bool
+__zmm_f32_pays(usize m, usize n, usize k) noexcept
+{
+  return m >= 12 and n >= 32 and u64(m) * u64(n) * u64(k) >= __zmm_f32_min_flops;
+}
+
+};      // namespace __gemm_mt
+
+// the kernel family gemm_mt runs, probed on first use
+inline gemm_isa
+active_gemm_isa() noexcept
+{
+  u32 __v = atom::load(&__gemm_mt::__isa, __ATOMIC_RELAXED);
+  if ( __v == __gemm_mt::__isa_unset ) {
+    __v = static_cast<u32>(__gemm_mt::__probe());
+    atom::store(&__gemm_mt::__isa, __v, __ATOMIC_RELAXED);
+  }
+  return static_cast<gemm_isa>(__v);
+}
+
+// pins the kernel family (benchmarks, tests); asking for one the machine lacks falls back to native
+inline void
+set_gemm_isa(gemm_isa __i) noexcept
+{
+  const gemm_isa __hw = __gemm_mt::__probe();
+  if ( __i != gemm_isa::native and __i != __hw ) __i = gemm_isa::native;
+  atom::store(&__gemm_mt::__isa, static_cast<u32>(__i), __ATOMIC_RELAXED);
+}
+
+namespace level3
+{
+
+// C = alpha * op(A) * op(B) + beta * C on the engine, raw strides; co_await it from inside a task
+template<blas_scalar T>
+micron::task<void>
+gemm_task(bool trA, bool trB, usize m, usize n, usize k, T alpha, const T *A, ssize_t rs_A, ssize_t cs_A, const T *B, ssize_t rs_B,
+          ssize_t cs_B, T beta, T *C, ssize_t rs_C, ssize_t cs_C)
+{
+  const ssize_t a_rs = trA ? cs_A : rs_A;
+  const ssize_t a_cs = trA ? rs_A : cs_A;
+  const ssize_t b_rs = trB ? cs_B : rs_B;
+  const ssize_t b_cs = trB ? rs_B : cs_B;
+  if constexpr ( ieee754_floating<T> ) {
+    if ( m != 0 and n != 0 and k != 0 and u64(m) * u64(n) * u64(k) >= __gemm_mt::__mt_min_flops ) {
+      const gemm_isa isa = active_gemm_isa();
+#if defined(__micron_arch_x86_any)
+      if ( isa == gemm_isa::avx512 ) {
+        if constexpr ( sizeof(T) == 8 ) {
+          co_await __gemm_mt::__run<T, __gemm_mt::__shape<T, 12, 16>>(
+              m, n, k, alpha, A, a_rs, a_cs, B, b_rs, b_cs, beta, C, rs_C, cs_C,
+              &__gemm_mt::__ukr_12x16_avx512_f64);
+          co_return;
+        } else if constexpr ( sizeof(T) == 4 ) {
+          if ( __gemm_mt::__zmm_f32_pays(m, n, k) ) {
+            co_await __gemm_mt::__run<T, __gemm_mt::__shape<T, 12, 32>>(
+                m, n, k, alpha, A, a_rs, a_cs, B, b_rs, b_cs, beta, C, rs_C, cs_C,
+                &__gemm_mt::__ukr_12x32_avx512_f32);
+            co_return;
+          }
+        }
+      }
+#endif
+#if defined(__micron_arch_arm64) && defined(__micron_arm_neon)
+      if ( isa == gemm_isa::neon ) {
+        if constexpr ( sizeof(T) == 8 ) {
+          co_await __gemm_mt::__run<T, __gemm_mt::__shape<T, 8, 4>>(m, n, k, alpha, A, a_rs, a_cs, B, b_rs, b_cs, beta, C, rs_C, cs_C,
+                                                                    &__gemm_mt::__ukr_8x4_neon_f64);
+          co_return;
+        } else if constexpr ( sizeof(T) == 4 ) {
+          co_await __gemm_mt::__run<T, __gemm_mt::__shape<T, 8, 8>>(m, n, k, alpha, A, a_rs, a_cs, B, b_rs, b_cs, beta, C, rs_C, cs_C,
+                                                                    &__gemm_mt::__ukr_8x8_neon_f32);
+          co_return;
+        }
+      }
+#endif
+      (void)isa;
+      constexpr usize MR = matrix::pack::gemm_mr_v<T>, NR = matrix::pack::gemm_nr_v<T>;
+      co_await __gemm_mt::__run<T, __gemm_mt::__shape<T, MR, NR>>(m, n, k, alpha, A, a_rs, a_cs, B, b_rs, b_cs, beta, C, rs_C, cs_C,
+                                                                  &__gemm_mt::__ukr_native<T, MR, NR>);
+      co_return;
+    }
+  }
+  bits::gemm_kernel<T>(trA, trB, m, n, k, alpha, A, rs_A, cs_A, B, rs_B, cs_B, beta, C, rs_C, cs_C);
+  co_return;
+}
+
+// multithreaded level3::gemm; blocks until done, call from outside the engine
+template<op::op_tag OpA = op::none, op::op_tag OpB = op::none, blas_scalar T, typename VA, typename VB, typename VC>
+  requires(mat_view_like<VA> and mat_view_like<VB> and mat_view_like<VC> and micron::same_as<typename VA::value_type, T>
+           and micron::same_as<typename VB::value_type, T> and micron::same_as<typename VC::value_type, T>)
+inline void
+gemm_mt(T alpha, const VA &A, const VB &B, T beta, VC C)
+{
+  constexpr bool trA = micron::same_as<OpA, op::trans> or micron::same_as<OpA, op::conj_trans>;
+  constexpr bool trB = micron::same_as<OpB, op::trans> or micron::same_as<OpB, op::conj_trans>;
+  // C overlapping an input would be read after other workers wrote it; the serial path stages through a temporary
+  if ( __impl_level3::view_overlaps(C, A) || __impl_level3::view_overlaps(C, B) ) {
+    gemm<OpA, OpB, T>(alpha, A, B, beta, C);
+    return;
+  }
+  const usize m = trA ? A.cols : A.rows;
+  const usize k = trA ? A.rows : A.cols;
+  const usize n = trB ? B.rows : B.cols;
+  micron::coro::sync_wait(gemm_task<T>(trA, trB, m, n, k, alpha, A.data, __impl_level3::rs_of(A), __impl_level3::cs_of(A), B.data,
+                                       __impl_level3::rs_of(B), __impl_level3::cs_of(B), beta, C.data, __impl_level3::rs_of(C),
+                                       __impl_level3::cs_of(C)));
+}
+
+template<blas_scalar T>
+inline void
+gemm_row_mt(bool trA, bool trB, usize m, usize n, usize k, T alpha, const T *A, usize lda, const T *B, usize ldb, T beta, T *C, usize ldc)
+{
+  micron::coro::sync_wait(gemm_task<T>(trA, trB, m, n, k, alpha, A, ssize_t(lda), 1, B, ssize_t(ldb), 1, beta, C, ssize_t(ldc), 1));
+}
+
+template<blas_scalar T>
+inline void
+gemm_col_mt(bool trA, bool trB, usize m, usize n, usize k, T alpha, const T *A, usize lda, const T *B, usize ldb, T beta, T *C, usize ldc)
+{
+  micron::coro::sync_wait(gemm_task<T>(trA, trB, m, n, k, alpha, A, 1, ssize_t(lda), B, 1, ssize_t(ldb), beta, C, 1, ssize_t(ldc)));
+}
+
+};      // namespace level3
+};      // namespace blas
+};      // namespace math
+};      // namespace micron
@@ -0,0 +1,547 @@
+//  Copyright (c) 2024- David Lucius Severus
+//
+//  Distributed under the Boost Software License, Version 1.0.
+//  See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt
+#pragma once
+
+#include "../../bits/__abc_mt.hpp"      // autofires MICRON_ABC_MT; must precede abcmalloc
+
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+// blocked, multithreaded dense factorizations (dynmat)
+//  -> lu_pivot_blocked (right-looking, partial pivoting)
+//  -> chol_blocked (lower, right-looking)
+//  -> qr_blocked / qr_householder_blocked (Householder, compact WY)
+//
+// step k factors an nb wide panel, then updates the trailing matrix with level-3 kernels on the coroutine engine. the
+// trailing update is split in two: the columns of the next panel, and the rest. the next panel is factored as soon as its
+// own columns are updated, while the rest of the update is still running (lookahead of one panel), so the serial panel
+// work comes off the critical path
+//
+// LU pivots on the largest magnitude in the column, no row scaling, so perm can differ from lu_pivot's. a matrix no wider
+// than one panel is factored serially, without the engine
+//
+// the entry points sync_wait on the engine, never call them from inside a task
+
+#include "../../concepts.hpp"
+#include "../../types.hpp"
+#include "../../vector/vector.hpp"
+
+#include "../../parallel/engine.hpp"
+#include "../blas/gemm_mt.hpp"
+#include "../sqrt.hpp"
+#include "decomp.hpp"
+#include "householder_seq.hpp"
+#include "spd.hpp"
+
+namespace micron
+{
+namespace math
+{
+namespace linalg
+{
+namespace __impl_blocked
+{
+
+// panel width
+inline constexpr usize __nb = 96;
+// columns (rows for the Cholesky trsm) per leaf of the swap / trsm / reflector sweeps
+inline constexpr usize __cw = 128;
+
+inline constexpr usize
+__min(usize a, usize b) noexcept
+{
+  return a < b ? a : b;
+}
+
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+// LU
+
+// interchanges ipiv[r0, r1) (row indices into A) on columns [c0, c1)
+template<typename F>
+inline void
+__swap_rows(F *A, usize ld, usize c0, usize c1, usize r0, usize r1, const usize *ipiv) noexcept
+{
+  for ( usize i = r0; i < r1; ++i ) {
+    const usize p = ipiv[i];
+    if ( p == i ) continue;
+    F *a = A + i * ld;
+    F *b = A + p * ld;
+    for ( usize j = c0; j < c1; ++j ) {
+      const F t = a[j];
+      a[j] = b[j];
+      b[j] = t;
+    }
+  }
+}
+
+// m x n panel (m >= n), recursive halving so the bulk of the panel work is gemm too; ipiv is relative to the panel top.
+// true if some column had no nonzero pivot
+template<typename F>
+inline bool
+__lu_panel(F *A, usize ld, usize m, usize n, usize *ipiv) noexcept
+{
+  if ( n == 1 ) {
+    usize p = 0;
+    F best = math::fabs(A[0]);
+    for ( usize i = 1; i < m; ++i ) {
+      const F a = math::fabs(A[i * ld]);
+      if ( a > best ) {
+        best = a;
+        p = i;
+      }
+    }
+    ipiv[0] = p;
+    if ( best == F(0) ) return true;
+    if ( p != 0 ) {
+      const F t = A[0];
+      A[0] = A[p * ld];
+      A[p * ld] = t;
+    }
+    const F inv = F(1) / A[0];
+    for ( usize i = 1; i < m; ++i ) A[i * ld] *= inv;
+    return false;
+  }
+  const usize n1 = n / 2;
+  const usize n2 = n - n1;
+  const ssize_t s = static_cast<ssize_t>(ld);
+  bool sing = __lu_panel<F>(A, ld, m, n1, ipiv);
+  __swap_rows<F>(A, ld, n1, n, 0, n1, ipiv);
+  blas::bits::trsm_left_kernel<F>(false, false, true, n1, n2, F(1), A, s, 1, A + n1, s, 1);
+  blas::bits::gemm_kernel<F>(false, false, m - n1, n2, n1, F(-1), A + n1 * ld, s, 1, A + n1, s, 1, F(1), A + n1 * ld + n1, s, 1);
+  sing |= __lu_panel<F>(A + n1 * ld + n1, ld, m - n1, n2, ipiv + n1);
+  for ( usize i = n1; i < n; ++i ) ipiv[i] += n1;
+  __swap_rows<F>(A, ld, 0, n1, n1, n, ipiv);
+  return sing;
+}
+
+template<typename F> struct __lu_ctx {
+  F *A;
+  usize n;
+  usize ld;
+  usize nb;
+  usize *ipiv;      // global row interchanges, LAPACK style
+  bool singular;
+};
+
+template<typename F>
+inline void
+__lu_factor(__lu_ctx<F> *c, usize k) noexcept
+{
+  const usize kb = __min(c->nb, c->n - k);
+  if ( __lu_panel<F>(c->A + k * c->ld + k, c->ld, c->n - k, kb, c->ipiv + k) ) c->singular = true;
+  for ( usize i = k; i < k + kb; ++i ) c->ipiv[i] += k;
+}
+
+// A[r0:, c0:c1] -= L21 * U12[:, c0:c1], r0 = k + kb
+template<typename F>
+micron::task<void>
+__lu_update(__lu_ctx<F> *c, usize k, usize kb, usize c0, usize c1)
+{
+  const usize r0 = k + kb;
+  const ssize_t s = static_cast<ssize_t>(c->ld);
+  F *A = c->A;
+  co_await blas::level3::gemm_task<F>(false, false, c->n - r0, c1 - c0, kb, F(-1), A + r0 * c->ld + k, s, 1, A + k * c->ld + c0, s, 1, F(1),
+                                      A + r0 * c->ld + c0, s, 1);
+}
+
+template<typename F>
+micron::task<void>
+__lu_next(__lu_ctx<F> *c, usize k, usize kb, usize c0, usize c1)
+{
+  co_await __lu_update<F>(c, k, kb, c0, c1);
+  __lu_factor<F>(c, c0);
+}
+
+template<typename F>
+micron::task<void>
+__lu_run(__lu_ctx<F> *c)
+{
+  F *A = c->A;
+  const usize n = c->n;
+  const usize ld = c->ld;
+  const usize nb = c->nb;
+  const usize *ipiv = c->ipiv;
+  __lu_factor<F>(c, 0);
+  for ( usize k = 0; k < n; k += nb ) {
+    const usize kb = __min(nb, n - k);
+    const usize r0 = k + kb;
+    // the panel's interchanges on every other column, then U12 = L11^-1 A12; column chunks are independent
+    auto sweep = [=](usize b) {
+      const usize c0 = b * __cw;
+      const usize c1 = __min(n, c0 + __cw);
+      if ( c0 < k ) __swap_rows<F>(A, ld, c0, __min(c1, k), k, r0, ipiv);
+      const usize s0 = c0 > r0 ? c0 : r0;
+      if ( s0 < c1 ) {
+        __swap_rows<F>(A, ld, s0, c1, k, r0, ipiv);
+        blas::bits::trsm_left_kernel<F>(false, false, true, kb, c1 - s0, F(1), A + k * ld + k, static_cast<ssize_t>(ld), 1, A + k * ld + s0,
+                                        static_cast<ssize_t>(ld), 1);
+      }
+    };
+    co_await parallel::__pblocks<decltype(sweep)>(0, (n + __cw - 1) / __cw, sweep, 1);
+    if ( r0 >= n ) break;
+    const usize nx = __min(nb, n - r0);
+    if ( r0 + nx < n ) {
+      co_await micron::coro::fork(micron::coro::discard, __lu_update<F>)(c, k, kb, r0 + nx, n);
+      co_await micron::coro::call(__lu_next<F>, c, k, kb, r0, r0 + nx);
+      co_await micron::coro::join;
+    } else
+      co_await __lu_next<F>(c, k, kb, r0, n);
+  }
+}
+
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+// Cholesky
+
+// unblocked lower Cholesky of the m x m diagonal block, reads the lower triangle only
+template<typename F>
+inline bool
+__chol_diag(F *A, usize ld, usize m) noexcept
+{
+  for ( usize i = 0; i < m; ++i ) {
+    F *ri = A + i * ld;
+    for ( usize j = 0; j <= i; ++j ) {
+      const F *rj = A + j * ld;
+      F s = ri[j];
+      for ( usize p = 0; p < j; ++p ) s = math::fma<F>(-ri[p], rj[p], s);
+      if ( i == j ) {
+        if ( s <= F(0) ) return false;
+        ri[j] = math::fsqrt(s);
+      } else
+        ri[j] = s / rj[j];
+    }
+  }
+  return true;
+}
+
+template<typename F> struct __chol_ctx {
+  F *A;
+  usize n;
+  usize ld;
+  usize nb;
+  bool spd;
+};
+
+// L11 = chol(A11), L21 = A21 L11^-T
+template<typename F>
+micron::task<void>
+__chol_factor(__chol_ctx<F> *c, usize k)
+{
+  F *A = c->A;
+  const usize n = c->n;
+  const usize ld = c->ld;
+  const usize kb = __min(c->nb, n - k);
+  if ( !__chol_diag<F>(A + k * ld + k, ld, kb) ) {
+    c->spd = false;
+    co_return;
+  }
+  const usize r0 = k + kb;
+  if ( r0 >= n ) co_return;
+  auto body = [=](usize b) {
+    const usize i0 = r0 + b * __cw;
+    blas::bits::trsm_right_kernel<F>(false, true, false, __min(__cw, n - i0), kb, F(1), A + k * ld + k, static_cast<ssize_t>(ld), 1,
+                                     A + i0 * ld + k, static_cast<ssize_t>(ld), 1);
+  };
+  co_await parallel::__pblocks<decltype(body)>(0, (n - r0 + __cw - 1) / __cw, body, 1);
+}
+
+// A[c0:, c0:c1] -= L[c0:, k:r0] L[c0:c1, k:r0]^T, lower nb x nb tiles only
+template<typename F>
+micron::task<void>
+__chol_update(__chol_ctx<F> *c, usize k, usize kb, usize c0, usize c1)
+{
+  F *A = c->A;
+  const usize n = c->n;
+  const usize ld = c->ld;
+  const usize nb = c->nb;
+  const usize tr = (n - c0 + nb - 1) / nb;
+  const usize tc = (c1 - c0 + nb - 1) / nb;
+  auto body = [=](usize b) {
+    usize jj = 0;
+    while ( b >= tr - jj ) {
+      b -= tr - jj;
+      ++jj;
+    }
+    const usize j0 = c0 + jj * nb;
+    const usize i0 = j0 + b * nb;
+    blas::bits::gemm_kernel<F>(false, true, __min(nb, n - i0), __min(nb, c1 - j0), kb, F(-1), A + i0 * ld + k, static_cast<ssize_t>(ld), 1,
+                               A + j0 * ld + k, static_cast<ssize_t>(ld), 1, F(1), A + i0 * ld + j0, static_cast<ssize_t>(ld), 1);
+  };
+  co_await parallel::__pblocks<decltype(body)>(0, tc * tr - tc * (tc - 1) / 2, body, 1);
+}
+
+template<typename F>
+micron::task<void>
+__chol_next(__chol_ctx<F> *c, usize k, usize kb, usize c0, usize c1)
+{
+  co_await __chol_update<F>(c, k, kb, c0, c1);
+  co_await __chol_factor<F>(c, c0);
+}
+
+template<typename F>
+micron::task<void>
+__chol_run(__chol_ctx<F> *c)
+{
+  const usize n = c->n;
+  const usize nb = c->nb;
+  co_await __chol_factor<F>(c, 0);
+  for ( usize k = 0; k < n and c->spd; k += nb ) {
+    const usize kb = __min(nb, n - k);
+    const usize r0 = k + kb;
+    if ( r0 >= n ) break;
+    const usize nx = __min(nb, n - r0);
+    if ( r0 + nx < n ) {
+      co_await micron::coro::fork(micron::coro::discard, __chol_update<F>)(c, k, kb, r0 + nx, n);
+      co_await micron::coro::call(__chol_next<F>, c, k, kb, r0, r0 + nx);
+      co_await micron::coro::join;
+    } else
+      co_await __chol_next<F>(c, k, kb, r0, n);
+  }
+}
+
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+// QR, compact WY: the panel's reflectors H_k ... H_k+kb-1 = I - V T V^T, T upper triangular
+
+template<typename F> struct __qr_ctx {
+  F *A;
+  usize m;
+  usize n;
+  usize ld;
+  usize nb;
+  usize K;
+  F *V;          // m x K, ld K
+  F *betas;      // K
+  F *T;          // one nb x nb block per panel
+};
+
+// unblocked Householder on columns [k, k + kb), then T for the panel
+template<typename F>
+inline void
+__qr_factor(__qr_ctx<F> *c, usize k) noexcept
+{
+  F *A = c->A;
+  F *V = c->V;
+  const usize m = c->m;
+  const usize ld = c->ld;
+  const usize K = c->K;
+  const usize nb = c->nb;
+  const usize kb = __min(nb, K - k);
+  micron::vector<F, micron::allocator_serial<>, false> x(m);
+  micron::vector<F, micron::allocator_serial<>, false> v(m);
+  for ( usize j = k; j < k + kb; ++j ) {
+    for ( usize i = j; i < m; ++i ) x.data()[i] = A[i * ld + j];
+    const F beta = decomp::__impl_decomp::householder_reflector_dyn<F>(x.data(), m, j, v.data());
+    c->betas[j] = beta;
+    for ( usize i = j; i < m; ++i ) V[i * K + j] = v.data()[i];
+    if ( beta == F(0) ) continue;
+    decomp::__impl_decomp::apply_householder_left_dyn<F>(A + j, m, k + kb - j, ld, v.data(), beta, j);
+    for ( usize i = j + 1; i < m; ++i ) A[i * ld + j] = F(0);
+  }
+  // T[0:j, j] = -beta_j T[0:j, 0:j] V[:, 0:j]^T v_j
+  F *T = c->T + (k / nb) * nb * nb;
+  for ( usize j = 0; j < kb; ++j ) {
+    const F bj = c->betas[k + j];
+    for ( usize i = 0; i < j; ++i ) {
+      F s = F(0);
+      for ( usize r = k + j; r < m; ++r ) s = math::fma<F>(V[r * K + k + i], V[r * K + k + j], s);
+      T[i * nb + j] = s;
+    }
+    for ( usize i = 0; i < j; ++i ) {
+      F s = F(0);
+      for ( usize p = i; p < j; ++p ) s = math::fma<F>(T[i * nb + p], T[p * nb + j], s);
+      T[i * nb + j] = -bj * s;
+    }
+    T[j * nb + j] = bj;
+  }
+}
+
+// B[k:, c0:c1] = (I - V T^(T) V^T) B[k:, c0:c1]; tr applies the panel's Q^T, else its Q
+template<typename F>
+micron::task<void>
+__qr_apply(__qr_ctx<F> *c, usize k, F *B, usize ldb, usize c0, usize c1, bool tr)
+{
+  const usize m = c->m;
+  const usize K = c->K;
+  const usize nb = c->nb;
+  const usize kb = __min(nb, K - k);
+  const F *Vp = c->V + k * K + k;
+  const F *T = c->T + (k / nb) * nb * nb;
+  auto body = [=](usize b) {
+    const usize j0 = c0 + b * __cw;
+    const usize w = __min(__cw, c1 - j0);
+    F *Bp = B + k * ldb + j0;
+    micron::vector<F, micron::allocator_serial<>, false> W(kb * w);
+    blas::bits::gemm_kernel<F>(true, false, kb, w, m - k, F(1), Vp, static_cast<ssize_t>(K), 1, Bp, static_cast<ssize_t>(ldb), 1, F(0),
+                               W.data(), static_cast<ssize_t>(w), 1);
+    blas::bits::trmm_left_kernel<F>(true, tr, false, kb, w, F(1), T, static_cast<ssize_t>(nb), 1, W.data(), static_cast<ssize_t>(w), 1);
+    blas::bits::gemm_kernel<F>(false, false, m - k, w, kb, F(-1), Vp, static_cast<ssize_t>(K), 1, W.data(), static_cast<ssize_t>(w), 1, F(1),
+                               Bp, static_cast<ssize_t>(ldb), 1);
+  };
+  co_await parallel::__pblocks<decltype(body)>(0, (c1 - c0 + __cw - 1) / __cw, body, 1);
+}
+
+template<typename F>
+micron::task<void>
+__qr_next(__qr_ctx<F> *c, usize k, usize c0, usize c1)
+{
+  co_await __qr_apply<F>(c, k, c->A, c->ld, c0, c1, true);
+  __qr_factor<F>(c, c0);
+}
+
+template<typename F>
+micron::task<void>
+__qr_run(__qr_ctx<F> *c)
+{
+  const usize n = c->n;
+  const usize K = c->K;
+  const usize nb = c->nb;
+  __qr_factor<F>(c, 0);
+  for ( usize k = 0; k < K; k += nb ) {
+    const usize r0 = k + __min(nb, K - k);
+    if ( r0 >= n ) break;
+    if ( r0 >= K ) {
+      // wide matrix, no panel left to look ahead to
+      co_await __qr_apply<F>(c, k, c->A, c->ld, r0, n, true);
+      break;
+    }
+    const usize nx = __min(nb, K - r0);
+    if ( r0 + nx < n ) {
+      co_await micron::coro::fork(micron::coro::discard, __qr_apply<F>)(c, k, c->A, c->ld, r0 + nx, n, true);
+      co_await micron::coro::call(__qr_next<F>, c, k, r0, r0 + nx);
+      co_await micron::coro::join;
+    } else
+      co_await __qr_next<F>(c, k, r0, n);
+  }
+}
+
+// Q = (I - V1 T1 V1^T) ... (I - Vp Tp Vp^T), backwards onto the identity; panel k only touches Q[k:, k:]
+template<typename F>
+micron::task<void>
+__qr_form_q(__qr_ctx<F> *c, F *Q, usize ldq)
+{
+  const usize K = c->K;
+  const usize nb = c->nb;
+  if ( K == 0 ) co_return;
+  for ( usize k = ((K - 1) / nb) * nb;; k -= nb ) {
+    co_await __qr_apply<F>(c, k, Q, ldq, k, c->m, false);
+    if ( k == 0 ) break;
+  }
+}
+
+template<typename F>
+micron::task<void>
+__qr_run_form_q(__qr_ctx<F> *c, F *Q, usize ldq)
+{
+  co_await __qr_run<F>(c);
+  co_await __qr_form_q<F>(c, Q, ldq);
+}
+
+};      // namespace __impl_blocked
+
+namespace decomp
+{
+
+template<ieee754_floating F>
+[[nodiscard]] inline lu_pivot_result_dyn<F>
+lu_pivot_blocked(const dynmat<F> &A, usize nb = __impl_blocked::__nb)
+{
+  const usize N = A.rows;
+  lu_pivot_result_dyn<F> r{ A, micron::vector<usize, micron::allocator_serial<>, false>(N), 1, false };
+  micron::vector<usize, micron::allocator_serial<>, false> ipiv(N);
+  if ( nb == 0 ) nb = __impl_blocked::__nb;
+  __impl_blocked::__lu_ctx<F> c{ r.LU.data(), N, r.LU.ld, nb, ipiv.data(), false };
+  if ( N <= nb ) {
+    if ( N != 0 and __impl_blocked::__lu_panel<F>(c.A, c.ld, N, N, c.ipiv) ) c.singular = true;
+  } else
+    micron::coro::sync_wait(__impl_blocked::__lu_run<F>(&c));
+  usize *perm = r.perm.data();
+  for ( usize i = 0; i < N; ++i ) perm[i] = i;
+  for ( usize i = 0; i < N; ++i ) {
+    const usize p = ipiv.data()[i];
+    if ( p == i ) continue;
+    const usize t = perm[i];
+    perm[i] = perm[p];
+    perm[p] = t;
+    r.sign = -r.sign;
+  }
+  r.singular = c.singular;
+  return r;
+}
+
+template<ieee754_floating F> struct qr_blocked_result_dyn {
+  householder_sequence_dyn<F> Q;
+  dynmat<F> R;
+};
+
+// Q stays in factored form, one reflector per column like qr_householder_colpiv
+template<ieee754_floating F>
+[[nodiscard]] inline qr_blocked_result_dyn<F>
+qr_blocked(const dynmat<F> &A, usize nb = __impl_blocked::__nb)
+{
+  const usize R = A.rows;
+  const usize C = A.cols;
+  const usize K = (R < C) ? R : C;
+  if ( nb == 0 ) nb = __impl_blocked::__nb;
+  qr_blocked_result_dyn<F> r{};
+  r.R = A;
+  r.Q.R = R;
+  r.Q.K = K;
+  r.Q.V = dynmat<F>::zero(R, K);
+  r.Q.betas = micron::vector<F, micron::allocator_serial<>, false>(K, F(0));
+  micron::vector<F, micron::allocator_serial<>, false> T(((K + nb - 1) / nb) * nb * nb, F(0));
+  __impl_blocked::__qr_ctx<F> c{ r.R.data(), R, C, r.R.ld, nb, K, r.Q.V.data(), r.Q.betas.data(), T.data() };
+  if ( K == 0 ) return r;
+  if ( K == C and C <= nb )
+    __impl_blocked::__qr_factor<F>(&c, 0);
+  else
+    micron::coro::sync_wait(__impl_blocked::__qr_run<F>(&c));
+  return r;
+}
+
+// drop-in for qr_householder, Q formed explicitly with the same blocked reflectors
+template<ieee754_floating F>
+[[nodiscard]] inline qr_householder_result_dyn<F>
+qr_householder_blocked(const dynmat<F> &A, usize nb = __impl_blocked::__nb)
+{
+  const usize R = A.rows;
+  const usize C = A.cols;
+  const usize K = (R < C) ? R : C;
+  if ( nb == 0 ) nb = __impl_blocked::__nb;
+  qr_householder_result_dyn<F> r{ dynmat<F>::identity(R), A };
+  dynmat<F> V = dynmat<F>::zero(R, K);
+  micron::vector<F, micron::allocator_serial<>, false> betas(K, F(0));
+  micron::vector<F, micron::allocator_serial<>, false> T(((K + nb - 1) / nb) * nb * nb, F(0));
+  __impl_blocked::__qr_ctx<F> c{ r.R.data(), R, C, r.R.ld, nb, K, V.data(), betas.data(), T.data() };
+  if ( K == 0 ) return r;
+  micron::coro::sync_wait(__impl_blocked::__qr_run_form_q<F>(&c, r.Q.data(), r.Q.ld));
+  return r;
+}
+
+};      // namespace decomp
+
+namespace spd
+{
+
+template<ieee754_floating F>
+[[nodiscard]] inline chol_result_dyn<F>
+chol_blocked(const dynmat<F> &A, usize nb = __impl_blocked::__nb)
+{
+  const usize N = A.rows;
+  if ( nb == 0 ) nb = __impl_blocked::__nb;
+  chol_result_dyn<F> r{ A, true };
+  __impl_blocked::__chol_ctx<F> c{ r.L.data(), N, r.L.ld, nb, true };
+  if ( N <= nb )
+    c.spd = __impl_blocked::__chol_diag<F>(c.A, c.ld, N);
+  else
+    micron::coro::sync_wait(__impl_blocked::__chol_run<F>(&c));
+  r.spd = c.spd;
+  F *L = r.L.data();
+  for ( usize i = 0; i < N; ++i )
+    for ( usize j = i + 1; j < N; ++j ) L[i * r.L.ld + j] = F(0);
+  return r;
+}
+
+};      // namespace spd
+};      // namespace linalg
+};      // namespace math
+};      // namespace micron
@@ -9,6 +9,7 @@
 #include "sparse/csr.hpp"
 #include "sparse/ops.hpp"
 #include "sparse/product.hpp"
+#include "sparse/sell.hpp"
 #include "sparse/simd_kernels.hpp"
 #include "sparse/sparse_vec.hpp"
 #include "sparse/triangular.hpp"
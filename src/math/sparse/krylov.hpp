@@ -0,0 +1,390 @@
+//  Copyright (c) 2024- David Lucius Severus
+//
+//  Distributed under the Boost Software License, Version 1.0.
+//  See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt
+#pragma once
+
+#include "../../bits/__abc_mt.hpp"      // autofires MICRON_ABC_MT; must precede abcmalloc
+
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+// preconditioned Krylov solvers for A x = b (csr, square)
+//   cg        = conjugate gradients, A and M symmetric positive definite
+//   bicgstab  = BiCGSTAB, right preconditioned
+//   gmres     = restarted GMRES(m), right preconditioned, modified Gram-Schmidt + Givens
+//
+// x carries the initial guess in and the solution out. every solver stops once ||b - A x|| / ||b|| <= tol as tracked by its
+// recurrence, or after max_iter iterations (0 = A.rows). spmv, dots and vector updates are chunked fork/joins on the engine
+// (sparse/parallel.hpp); any preconditioner from sparse/precond.hpp, or anything else with apply_task(r, z), plugs in
+//
+// gmres keeps restart + 1 basis vectors of A.rows each
+//
+// the entry points sync_wait on the engine, never call them from inside a task; co_await the *_task versions there
+
+#include "../../concepts.hpp"
+#include "../../types.hpp"
+#include "../../vector/vector.hpp"
+
+#include "../../parallel/engine.hpp"
+#include "../ieee.hpp"
+#include "../quants/dynvec.hpp"
+#include "../sqrt.hpp"
+#include "csr.hpp"
+#include "parallel.hpp"
+#include "precond.hpp"
+
+namespace micron
+{
+namespace math
+{
+namespace sparse
+{
+
+template<ieee754_floating T> struct solve_result {
+  usize iterations{ 0 };
+  T residual{ 0 };      // ||b - A x|| / ||b||
+  bool converged{ false };
+  bool breakdown{ false };      // a zero denominator ended the recurrence early
+};
+
+namespace __impl_krylov
+{
+
+using namespace __impl_sparse_mt;
+
+template<typename T> using __buf = micron::vector<T, micron::allocator_serial<>, false>;
+
+// r = b - A x
+template<typename T, typename I>
+micron::task<void>
+__residual(const csr<T, I> *A, const T *b, const T *x, T *r)
+{
+  const usize n = A->rows;
+  co_await __pchunks(n, [=](usize lo, usize hi) {
+    for ( usize i = lo; i < hi; ++i ) r[i] = b[i];
+  });
+  co_await spmv_task<T, I>(T(-1), *A, x, T(1), r);
+}
+
+template<typename T>
+inline T
+__abs(T v) noexcept
+{
+  return v < T(0) ? -v : v;
+}
+
+};      // namespace __impl_krylov
+
+template<ieee754_floating T, micron::integral I, class P>
+micron::task<void>
+cg_task(const csr<T, I> &A, const T *b, T *x, const P &M, T tol, usize max_iter, solve_result<T> *out)
+{
+  using namespace __impl_krylov;
+  const usize n = A.rows;
+  if ( max_iter == 0 ) max_iter = n;
+  __buf<T> rb(n), zb(n), pb(n), qb(n), part(__nchunks(n) + 1);
+  T *r = rb.data(), *z = zb.data(), *p = pb.data(), *q = qb.data(), *pt = part.data();
+  solve_result<T> res;
+
+  const T bn = math::fsqrt(co_await __pnorm_sq<T>(b, n, pt));
+  if ( bn == T(0) ) {
+    co_await __pchunks(n, [=](usize lo, usize hi) {
+      for ( usize i = lo; i < hi; ++i ) x[i] = T(0);
+    });
+    res.converged = true;
+    *out = res;
+    co_return;
+  }
+  co_await __residual<T, I>(&A, b, x, r);
+  res.residual = math::fsqrt(co_await __pnorm_sq<T>(r, n, pt)) / bn;
+  if ( res.residual <= tol ) {
+    res.converged = true;
+    *out = res;
+    co_return;
+  }
+  co_await M.apply_task(r, z);
+  co_await __pchunks(n, [=](usize lo, usize hi) {
+    for ( usize i = lo; i < hi; ++i ) p[i] = z[i];
+  });
+  T rz = co_await __pdot<T>(r, z, n, pt);
+
+  while ( res.iterations < max_iter ) {
+    co_await spmv_task<T, I>(T(1), A, p, T(0), q);
+    const T pq = co_await __pdot<T>(p, q, n, pt);
+    if ( pq == T(0) or rz == T(0) ) {
+      res.breakdown = true;
+      break;
+    }
+    const T alpha = rz / pq;
+    // x += alpha p, r -= alpha q, ||r||^2 in the same pass
+    co_await __pchunks(n, [=](usize lo, usize hi) {
+      for ( usize i = lo; i < hi; ++i ) {
+        x[i] = math::fma<T>(alpha, p[i], x[i]);
+        r[i] = math::fma<T>(-alpha, q[i], r[i]);
+      }
+      pt[lo / __chunk] = norm_sq_values<T>(r + lo, hi - lo);
+    });
+    T rr = T(0);
+    for ( usize c = 0, nc = __nchunks(n); c < nc; ++c ) rr += pt[c];
+    ++res.iterations;
+    res.residual = math::fsqrt(rr) / bn;
+    if ( res.residual <= tol ) {
+      res.converged = true;
+      break;
+    }
+    co_await M.apply_task(r, z);
+    const T rz_new = co_await __pdot<T>(r, z, n, pt);
+    const T beta = rz_new / rz;
+    rz = rz_new;
+    co_await __pchunks(n, [=](usize lo, usize hi) {
+      for ( usize i = lo; i < hi; ++i ) p[i] = math::fma<T>(beta, p[i], z[i]);
+    });
+  }
+  *out = res;
+}
+
+template<ieee754_floating T, micron::integral I, class P>
+micron::task<void>
+bicgstab_task(const csr<T, I> &A, const T *b, T *x, const P &M, T tol, usize max_iter, solve_result<T> *out)
+{
+  using namespace __impl_krylov;
+  const usize n = A.rows;
+  if ( max_iter == 0 ) max_iter = n;
+  __buf<T> rb(n), rhb(n), pb(n, T(0)), vb(n, T(0)), phb(n), sv(n), shb(n), tb(n), part(__nchunks(n) + 1);
+  T *r = rb.data(), *rh = rhb.data(), *p = pb.data(), *v = vb.data(), *ph = phb.data(), *s = sv.data(), *sh = shb.data(), *t = tb.data();
+  T *pt = part.data();
+  solve_result<T> res;
+
+  const T bn = math::fsqrt(co_await __pnorm_sq<T>(b, n, pt));
+  if ( bn == T(0) ) {
+    co_await __pchunks(n, [=](usize lo, usize hi) {
+      for ( usize i = lo; i < hi; ++i ) x[i] = T(0);
+    });
+    res.converged = true;
+    *out = res;
+    co_return;
+  }
+  co_await __residual<T, I>(&A, b, x, r);
+  res.residual = math::fsqrt(co_await __pnorm_sq<T>(r, n, pt)) / bn;
+  if ( res.residual <= tol ) {
+    res.converged = true;
+    *out = res;
+    co_return;
+  }
+  co_await __pchunks(n, [=](usize lo, usize hi) {
+    for ( usize i = lo; i < hi; ++i ) rh[i] = r[i];
+  });
+  T rho = T(1), alpha = T(1), omega = T(1);
+
+  while ( res.iterations < max_iter ) {
+    const T rho_new = co_await __pdot<T>(rh, r, n, pt);
+    if ( rho_new == T(0) ) {
+      res.breakdown = true;
+      break;
+    }
+    const T beta = (rho_new / rho) * (alpha / omega);
+    rho = rho_new;
+    co_await __pchunks(n, [=](usize lo, usize hi) {
+      for ( usize i = lo; i < hi; ++i ) p[i] = math::fma<T>(beta, math::fma<T>(-omega, v[i], p[i]), r[i]);
+    });
+    co_await M.apply_task(p, ph);
+    co_await spmv_task<T, I>(T(1), A, ph, T(0), v);
+    const T rv = co_await __pdot<T>(rh, v, n, pt);
+    if ( rv == T(0) ) {
+      res.breakdown = true;
+      break;
+    }
+    alpha = rho / rv;
+    const T a = alpha;
+    co_await __pchunks(n, [=](usize lo, usize hi) {
+      for ( usize i = lo; i < hi; ++i ) s[i] = math::fma<T>(-a, v[i], r[i]);
+      pt[lo / __chunk] = norm_sq_values<T>(s + lo, hi - lo);
+    });
+    T ss = T(0);
+    for ( usize c = 0, nc = __nchunks(n); c < nc; ++c ) ss += pt[c];
+    ++res.iterations;
+    if ( math::fsqrt(ss) / bn <= tol ) {
+      co_await __pchunks(n, [=](usize lo, usize hi) { axpy_values<T>(a, ph + lo, x + lo, hi - lo); });
+      res.residual = math::fsqrt(ss) / bn;
+      res.converged = true;
+      break;
+    }
+    co_await M.apply_task(s, sh);
+    co_await spmv_task<T, I>(T(1), A, sh, T(0), t);
+    const T ts = co_await __pdot<T>(t, s, n, pt);
+    const T tt = co_await __pnorm_sq<T>(t, n, pt);
+    omega = (tt == T(0)) ? T(0) : ts / tt;
+    const T w = omega;
+    co_await __pchunks(n, [=](usize lo, usize hi) {
+      for ( usize i = lo; i < hi; ++i ) {
+        x[i] = math::fma<T>(a, ph[i], math::fma<T>(w, sh[i], x[i]));
+        r[i] = math::fma<T>(-w, t[i], s[i]);
+      }
+      pt[lo / __chunk] = norm_sq_values<T>(r + lo, hi - lo);
+    });
+    T rr = T(0);
+    for ( usize c = 0, nc = __nchunks(n); c < nc; ++c ) rr += pt[c];
+    res.residual = math::fsqrt(rr) / bn;
+    if ( res.residual <= tol ) {
+      res.converged = true;
+      break;
+    }
+    if ( omega == T(0) ) {
+      res.breakdown = true;
+      break;
+    }
+  }
+  *out = res;
+}
+
+template<ieee754_floating T, micron::integral I, class P>
+micron::task<void>
+gmres_task(const csr<T, I> &A, const T *b, T *x, const P &M, T tol, usize max_iter, usize restart, solve_result<T> *out)
+{
+  using namespace __impl_krylov;
+  const usize n = A.rows;
+  if ( max_iter == 0 ) max_iter = n;
+  if ( restart == 0 ) restart = 30;
+  if ( restart > n ) restart = n;
+  const usize m = restart;
+  __buf<T> Vb((m + 1) * n), wb(n), part(__nchunks(n) + 1);
+  __buf<T> Hb((m + 1) * m, T(0)), cs(m), sn(m), g(m + 1), y(m);
+  T *V = Vb.data(), *w = wb.data(), *pt = part.data(), *H = Hb.data();
+  solve_result<T> res;
+
+  const T bn = math::fsqrt(co_await __pnorm_sq<T>(b, n, pt));
+  if ( bn == T(0) ) {
+    co_await __pchunks(n, [=](usize lo, usize hi) {
+      for ( usize i = lo; i < hi; ++i ) x[i] = T(0);
+    });
+    res.converged = true;
+    *out = res;
+    co_return;
+  }
+
+  for ( ;; ) {
+    co_await __residual<T, I>(&A, b, x, V);
+    const T beta = math::fsqrt(co_await __pnorm_sq<T>(V, n, pt));
+    res.residual = beta / bn;
+    if ( res.residual <= tol ) {
+      res.converged = true;
+      break;
+    }
+    if ( res.iterations >= max_iter or res.breakdown ) break;
+    const T ib = T(1) / beta;
+    co_await __pchunks(n, [=](usize lo, usize hi) { scal_values<T>(ib, V + lo, hi - lo); });
+    for ( usize i = 0; i <= m; ++i ) g.data()[i] = T(0);
+    g.data()[0] = beta;
+
+    usize j = 0;
+    while ( j < m and res.iterations < max_iter ) {
+      T *vj = V + j * n;
+      T *vn = V + (j + 1) * n;
+      co_await M.apply_task(vj, w);
+      co_await spmv_task<T, I>(T(1), A, w, T(0), vn);
+      // modified Gram-Schmidt against v_0 .. v_j
+      for ( usize i = 0; i <= j; ++i ) {
+        const T *vi = V + i * n;
+        const T h = co_await __pdot<T>(vn, vi, n, pt);
+        H[i * m + j] = h;
+        co_await __pchunks(n, [=](usize lo, usize hi) { axpy_values<T>(-h, vi + lo, vn + lo, hi - lo); });
+      }
+      const T hn = math::fsqrt(co_await __pnorm_sq<T>(vn, n, pt));
+      H[(j + 1) * m + j] = hn;
+      if ( hn != T(0) ) {
+        const T ih = T(1) / hn;
+        co_await __pchunks(n, [=](usize lo, usize hi) { scal_values<T>(ih, vn + lo, hi - lo); });
+      }
+      // previous rotations onto column j, then the one that zeroes H[j + 1][j]
+      for ( usize i = 0; i < j; ++i ) {
+        const T h0 = H[i * m + j];
+        const T h1 = H[(i + 1) * m + j];
+        H[i * m + j] = cs.data()[i] * h0 + sn.data()[i] * h1;
+        H[(i + 1) * m + j] = -sn.data()[i] * h0 + cs.data()[i] * h1;
+      }
+      const T h0 = H[j * m + j];
+      const T h1 = H[(j + 1) * m + j];
+      const T rho = math::fsqrt(h0 * h0 + h1 * h1);
+      if ( rho == T(0) ) {
+        res.breakdown = true;
+        break;
+      }
+      cs.data()[j] = h0 / rho;
+      sn.data()[j] = h1 / rho;
+      H[j * m + j] = rho;
+      H[(j + 1) * m + j] = T(0);
+      g.data()[j + 1] = -sn.data()[j] * g.data()[j];
+      g.data()[j] = cs.data()[j] * g.data()[j];
+      ++j;
+      ++res.iterations;
+      // lucky breakdown: the Krylov space holds the solution
+      if ( hn == T(0) or __abs(g.data()[j]) / bn <= tol ) break;
+    }
+    if ( j == 0 ) break;
+    // H y = g, then x += M (V y)
+    for ( usize ii = j; ii-- > 0; ) {
+      T s = g.data()[ii];
+      for ( usize k = ii + 1; k < j; ++k ) s = math::fma<T>(-H[ii * m + k], y.data()[k], s);
+      y.data()[ii] = s / H[ii * m + ii];
+    }
+    const T *yp = y.data();
+    co_await __pchunks(n, [=](usize lo, usize hi) {
+      for ( usize i = lo; i < hi; ++i ) {
+        T s = T(0);
+        for ( usize k = 0; k < j; ++k ) s = math::fma<T>(yp[k], V[k * n + i], s);
+        w[i] = s;
+      }
+    });
+    // V[m] is free scratch here
+    T *u = V + m * n;
+    co_await M.apply_task(w, u);
+    co_await __pchunks(n, [=](usize lo, usize hi) { axpy_values<T>(T(1), u + lo, x + lo, hi - lo); });
+  }
+  *out = res;
+}
+
+// blocking entry points
+
+template<ieee754_floating T, micron::integral I, class P = identity_pre<T>>
+inline solve_result<T>
+cg(const csr<T, I> &A, const dynvec<T> &b, dynvec<T> &x, const P &M = P{}, T tol = T(1e-8), usize max_iter = 0)
+{
+  solve_result<T> r;
+  if constexpr ( micron::is_same_v<P, identity_pre<T>> ) {
+    const identity_pre<T> id{ true, A.rows };
+    micron::coro::sync_wait(cg_task<T, I, P>(A, b.data(), x.data(), id, tol, max_iter, &r));
+  } else
+    micron::coro::sync_wait(cg_task<T, I, P>(A, b.data(), x.data(), M, tol, max_iter, &r));
+  return r;
+}
+
+template<ieee754_floating T, micron::integral I, class P = identity_pre<T>>
+inline solve_result<T>
+bicgstab(const csr<T, I> &A, const dynvec<T> &b, dynvec<T> &x, const P &M = P{}, T tol = T(1e-8), usize max_iter = 0)
+{
+  solve_result<T> r;
+  if constexpr ( micron::is_same_v<P, identity_pre<T>> ) {
+    const identity_pre<T> id{ true, A.rows };
+    micron::coro::sync_wait(bicgstab_task<T, I, P>(A, b.data(), x.data(), id, tol, max_iter, &r));
+  } else
+    micron::coro::sync_wait(bicgstab_task<T, I, P>(A, b.data(), x.data(), M, tol, max_iter, &r));
+  return r;
+}
+
+template<ieee754_floating T, micron::integral I, class P = identity_pre<T>>
+inline solve_result<T>
+gmres(const csr<T, I> &A, const dynvec<T> &b, dynvec<T> &x, const P &M = P{}, T tol = T(1e-8), usize max_iter = 0,
+      usize restart = 30)
+{
+  solve_result<T> r;
+  if constexpr ( micron::is_same_v<P, identity_pre<T>> ) {
+    const identity_pre<T> id{ true, A.rows };
+    micron::coro::sync_wait(gmres_task<T, I, P>(A, b.data(), x.data(), id, tol, max_iter, restart, &r));
+  } else
+    micron::coro::sync_wait(gmres_task<T, I, P>(A, b.data(), x.data(), M, tol, max_iter, restart, &r));
+  return r;
+}
+
+};      // namespace sparse
+};      // namespace math
+};      // namespace micron
@@ -0,0 +1,234 @@
+//  Copyright (c) 2024- David Lucius Severus
+//
+//  Distributed under the Boost Software License, Version 1.0.
+//  See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt
+#pragma once
+
+#include "../../bits/__abc_mt.hpp"      // autofires MICRON_ABC_MT; must precede abcmalloc
+
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+// sparse kernels on the coroutine engine
+//   spmv_task / spmv_mt  = csr or sell * dense-vec, row (slice) blocks in parallel
+//   spmm_task / spmm_mt  = csr * dense-mat, row blocks in parallel
+//   __pdot, __pnorm_sq   = chunked reductions, partials summed in chunk order
+//   __pchunks            = fixed-size chunks of [0, n) as leaves
+//
+// spmv/spmm blocks are cut by nonzeros, not rows: block b starts at the first row whose prefix count outer[i] + i passes
+// b/nb of the total (the + i charges each row for its y update), so a few dense rows don't leave one worker with most of
+// the matrix. each row is still summed by one worker in storage order, results match the serial kernels bit for bit
+//
+// chunks are a fixed size, not a fraction of the worker count, so every reduction adds the same partials in the same order
+// whatever the engine width and the results are bitwise reproducible
+//
+// *_mt entry points sync_wait on the engine, never call them from inside a task; co_await the *_task versions there
+
+#include "../../concepts.hpp"
+#include "../../types.hpp"
+#include "../../vector/vector.hpp"
+
+#include "../../parallel/engine.hpp"
+#include "../ieee.hpp"
+#include "../quants/dynvec.hpp"
+#include "../matrix/dynmat.hpp"
+#include "csr.hpp"
+#include "sell.hpp"
+#include "simd_kernels.hpp"
+
+namespace micron
+{
+namespace math
+{
+namespace sparse
+{
+namespace __impl_sparse_mt
+{
+
+// vector elements per leaf
+inline constexpr usize __chunk = 16384;
+// nonzeros per spmv leaf
+inline constexpr usize __spmv_nnz = 32768;
+
+inline constexpr usize
+__nchunks(usize n) noexcept
+{
+  return (n + __chunk - 1) / __chunk;
+}
+
+template<class Leaf>
+micron::task<void>
+__pchunks(usize n, Leaf leaf)
+{
+  if ( n <= __chunk ) {
+    leaf(usize(0), n);
+    co_return;
+  }
+  auto body = [=](usize b) {
+    const usize lo = b * __chunk;
+    const usize hi = (lo + __chunk < n) ? lo + __chunk : n;
+    leaf(lo, hi);
+  };
+  co_await parallel::__pblocks<decltype(body)>(0, __nchunks(n), body, 1);
+}
+
+// part needs __nchunks(n) slots
+template<ieee754_floating T>
+micron::task<T>
+__pdot(const T *a, const T *b, usize n, T *part)
+{
+  co_await __pchunks(n, [=](usize lo, usize hi) { part[lo / __chunk] = dot_values<T>(a + lo, b + lo, hi - lo); });
+  T s = T(0);
+  for ( usize c = 0, nc = __nchunks(n); c < nc; ++c ) s += part[c];
+  co_return s;
+}
+
+template<ieee754_floating T>
+micron::task<T>
+__pnorm_sq(const T *a, usize n, T *part)
+{
+  co_await __pchunks(n, [=](usize lo, usize hi) { part[lo / __chunk] = norm_sq_values<T>(a + lo, hi - lo); });
+  T s = T(0);
+  for ( usize c = 0, nc = __nchunks(n); c < nc; ++c ) s += part[c];
+  co_return s;
+}
+
+// first i in [0, n] with w(i) >= target; w non-decreasing, w(n) is the total
+template<class W>
+inline usize
+__lower(usize n, u64 target, W w) noexcept
+{
+  usize lo = 0, hi = n;
+  while ( lo < hi ) {
+    const usize mid = lo + (hi - lo) / 2;
+    if ( w(mid) < target )
+      lo = mid + 1;
+    else
+      hi = mid;
+  }
+  return lo;
+}
+
+// leaves needed to give each about per units of a total weight
+inline usize
+__nleaves(u64 total, u64 per) noexcept
+{
+  if ( per == 0 ) per = 1;
+  const u64 nb = (total + per - 1) / per;
+  return nb == 0 ? 1 : static_cast<usize>(nb);
+}
+
+// runs leaf(r0, r1) over [0, n) cut into nb pieces of equal weight w
+template<class W, class Leaf>
+micron::task<void>
+__pbalanced(usize n, usize nb, W w, Leaf leaf)
+{
+  if ( nb <= 1 ) {
+    if ( n ) leaf(usize(0), n);
+    co_return;
+  }
+  const u64 total = w(n);
+  auto body = [=](usize b) {
+    const usize r0 = __lower(n, (total * b) / nb, w);
+    const usize r1 = __lower(n, (total * (b + 1)) / nb, w);
+    if ( r0 < r1 ) leaf(r0, r1);
+  };
+  co_await parallel::__pblocks<decltype(body)>(0, nb, body, 1);
+}
+
+// rows [r0, r1) of Y := alpha * A * X + beta * Y, k right-hand sides
+template<ieee754_floating T, micron::integral I>
+inline void
+__spmm_rows(T alpha, const csr<T, I> &A, const T *X, usize ldx, T beta, T *Y, usize ldy, usize k, usize r0, usize r1) noexcept
+{
+  const I *outer = A.outer.data();
+  const I *inner = A.inner.data();
+  const T *vals = A.values.data();
+  for ( usize i = r0; i < r1; ++i ) {
+    T *yi = Y + i * ldy;
+    if ( beta == T(0) )
+      for ( usize c = 0; c < k; ++c ) yi[c] = T(0);
+    else if ( beta != T(1) )
+      scal_values<T>(beta, yi, k);
+    for ( usize p = static_cast<usize>(outer[i]), e = static_cast<usize>(outer[i + 1]); p < e; ++p )
+      axpy_values<T>(alpha * vals[p], X + static_cast<usize>(inner[p]) * ldx, yi, k);
+  }
+}
+
+};      // namespace __impl_sparse_mt
+
+// y := alpha * A * x + beta * y, raw pointers; co_await it from inside a task
+template<ieee754_floating T, micron::integral I>
+micron::task<void>
+spmv_task(T alpha, const csr<T, I> &A, const T *x, T beta, T *y)
+{
+  const I *outer = A.outer.data();
+  const I *inner = A.inner.data();
+  const T *vals = A.values.data();
+  auto w = [=](usize i) -> u64 { return static_cast<u64>(outer[i]) + i; };
+  auto leaf = [=](usize r0, usize r1) {
+    for ( usize i = r0; i < r1; ++i ) {
+      const usize a = static_cast<usize>(outer[i]);
+      const usize e = static_cast<usize>(outer[i + 1]);
+      T s = T(0);
+      for ( usize k = a; k < e; ++k ) s = math::fma<T>(vals[k], x[inner[k]], s);
+      y[i] = (beta == T(0)) ? alpha * s : math::fma<T>(alpha, s, beta * y[i]);
+    }
+  };
+  const usize nb = __impl_sparse_mt::__nleaves(A.nnz() + A.rows, __impl_sparse_mt::__spmv_nnz);
+  co_await __impl_sparse_mt::__pbalanced(A.rows, nb, w, leaf);
+}
+
+// sell: slice blocks weighted by stored entries, padding included
+template<ieee754_floating T, micron::integral I, usize C>
+micron::task<void>
+spmv_task(T alpha, const sell<T, I, C> &A, const T *x, T beta, T *y)
+{
+  const usize *sp = A.slice_ptr.data();
+  const sell<T, I, C> *a = &A;
+  auto w = [=](usize s) -> u64 { return static_cast<u64>(sp[s]) + s * C; };
+  auto leaf = [=](usize s0, usize s1) { __impl_sell::__spmv_slices<T, I, C>(alpha, *a, x, beta, y, s0, s1); };
+  const usize nb = __impl_sparse_mt::__nleaves(A.stored() + A.nslices * C, __impl_sparse_mt::__spmv_nnz);
+  co_await __impl_sparse_mt::__pbalanced(A.nslices, nb, w, leaf);
+}
+
+// Y := alpha * A * X + beta * Y, row-major X (A.cols x k, stride ldx) and Y (A.rows x k, stride ldy)
+template<ieee754_floating T, micron::integral I>
+micron::task<void>
+spmm_task(T alpha, const csr<T, I> &A, const T *X, usize ldx, T beta, T *Y, usize ldy, usize k)
+{
+  const I *outer = A.outer.data();
+  const csr<T, I> *a = &A;
+  auto w = [=](usize i) -> u64 { return static_cast<u64>(outer[i]) + i; };
+  auto leaf = [=](usize r0, usize r1) { __impl_sparse_mt::__spmm_rows<T, I>(alpha, *a, X, ldx, beta, Y, ldy, k, r0, r1); };
+  const usize per = k ? __impl_sparse_mt::__spmv_nnz / k : __impl_sparse_mt::__spmv_nnz;
+  const usize nb = __impl_sparse_mt::__nleaves(A.nnz() + A.rows, per);
+  co_await __impl_sparse_mt::__pbalanced(A.rows, nb, w, leaf);
+}
+
+// multithreaded spmv (csr); blocks until done, call from outside the engine
+template<ieee754_floating T, micron::integral I>
+inline void
+spmv_mt(T alpha, const csr<T, I> &A, const dynvec<T> &x, T beta, dynvec<T> &y)
+{
+  micron::coro::sync_wait(spmv_task<T, I>(alpha, A, x.data(), beta, y.data()));
+}
+
+// multithreaded spmv (sell); blocks until done, call from outside the engine
+template<ieee754_floating T, micron::integral I, usize C>
+inline void
+spmv_mt(T alpha, const sell<T, I, C> &A, const dynvec<T> &x, T beta, dynvec<T> &y)
+{
+  micron::coro::sync_wait(spmv_task<T, I, C>(alpha, A, x.data(), beta, y.data()));
+}
+
+// multithreaded spmm (csr); X is A.cols x k, Y is A.rows x k
+template<ieee754_floating T, micron::integral I>
+inline void
+spmm_mt(T alpha, const csr<T, I> &A, const dynmat<T> &X, T beta, dynmat<T> &Y)
+{
+  micron::coro::sync_wait(spmm_task<T, I>(alpha, A, X.data(), X.ld, beta, Y.data(), Y.ld, X.cols));
+}
+
+};      // namespace sparse
+};      // namespace math
+};      // namespace micron
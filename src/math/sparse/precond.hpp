@@ -0,0 +1,429 @@
+//  Copyright (c) 2024- David Lucius Severus
+//
+//  Distributed under the Boost Software License, Version 1.0.
+//  See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt
+#pragma once
+
+#include "../../bits/__abc_mt.hpp"      // autofires MICRON_ABC_MT; must precede abcmalloc
+
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+// preconditioners for the Krylov solvers (csr, square)
+//   identity_pre       = z := r
+//   jacobi  (make_jacobi)  = z := D^-1 r
+//   ilu0    (make_ilu0)    = incomplete LU on A's own pattern, unit L
+//   ic0     (make_ic0)     = incomplete Cholesky on the lower pattern of an SPD A
+//
+// both the factorizations and the triangular solves are level scheduled: a row's level is one past the deepest row it
+// depends on, so all rows of a level are independent and run as one fork/join on the engine. levels too thin to be worth
+// a fork run inline. results do not depend on the worker count
+//
+// every preconditioner exposes apply_task(r, z) (co_await from inside a task; z may alias r) and a blocking apply().
+// ok is false when the factorization hit a missing or non-positive pivot, the factors are not usable then
+
+#include "../../concepts.hpp"
+#include "../../types.hpp"
+#include "../../vector/vector.hpp"
+
+#include "../../parallel/engine.hpp"
+#include "../ieee.hpp"
+#include "../quants/dynvec.hpp"
+#include "../sqrt.hpp"
+#include "csc.hpp"
+#include "csr.hpp"
+#include "parallel.hpp"
+
+namespace micron
+{
+namespace math
+{
+namespace sparse
+{
+
+// rows grouped so each only depends on rows of earlier levels
+struct level_schedule {
+  micron::vector<usize, micron::allocator_serial<>, false> order;      // rows, level by level, ascending inside a level
+  micron::vector<usize, micron::allocator_serial<>, false> ptr;        // level l = order[ptr[l], ptr[l + 1])
+  usize levels{ 0 };
+};
+
+namespace __impl_precond
+{
+
+// below this a level runs inline
+inline constexpr usize __level_min = 512;
+// rows per leaf inside a level
+inline constexpr usize __level_rows = 256;
+
+using __vec_u = micron::vector<usize, micron::allocator_serial<>, false>;
+
+// dependencies of row i are the entries left of diag[i] (lower) or right of it (upper)
+template<typename T, typename I>
+inline level_schedule
+__build_schedule(const csr<T, I> &M, const usize *diag, bool lower)
+{
+  const usize n = M.rows;
+  const I *outer = M.outer.data();
+  const I *inner = M.inner.data();
+  level_schedule s;
+  __vec_u lvl(n, usize(0));
+  usize nl = 0;
+  for ( usize ii = 0; ii < n; ++ii ) {
+    const usize i = lower ? ii : n - 1 - ii;
+    const usize a = lower ? static_cast<usize>(outer[i]) : diag[i] + 1;
+    const usize e = lower ? diag[i] : static_cast<usize>(outer[i + 1]);
+    usize l = 0;
+    for ( usize k = a; k < e; ++k ) {
+      const usize d = lvl.data()[inner[k]] + 1;
+      if ( d > l ) l = d;
+    }
+    lvl.data()[i] = l;
+    if ( l + 1 > nl ) nl = l + 1;
+  }
+  s.levels = nl;
+  s.ptr = __vec_u(nl + 1, usize(0));
+  for ( usize i = 0; i < n; ++i ) s.ptr.data()[lvl.data()[i] + 1] += 1;
+  for ( usize l = 0; l < nl; ++l ) s.ptr.data()[l + 1] += s.ptr.data()[l];
+  s.order = __vec_u(n, usize(0));
+  __vec_u pos(nl, usize(0));
+  for ( usize l = 0; l < nl; ++l ) pos.data()[l] = s.ptr.data()[l];
+  for ( usize i = 0; i < n; ++i ) s.order.data()[pos.data()[lvl.data()[i]]++] = i;
+  return s;
+}
+
+// row(i) for every row, level by level
+template<class Row>
+micron::task<void>
+__level_for(const level_schedule *s, Row row)
+{
+  const usize *order = s->order.data();
+  for ( usize l = 0; l < s->levels; ++l ) {
+    const usize lo = s->ptr.data()[l];
+    const usize hi = s->ptr.data()[l + 1];
+    if ( hi - lo < __level_min ) {
+      for ( usize k = lo; k < hi; ++k ) row(order[k]);
+      continue;
+    }
+    auto body = [=](usize b) {
+      const usize k0 = lo + b * __level_rows;
+      const usize k1 = (k0 + __level_rows < hi) ? k0 + __level_rows : hi;
+      for ( usize k = k0; k < k1; ++k ) row(order[k]);
+    };
+    co_await parallel::__pblocks<decltype(body)>(0, (hi - lo + __level_rows - 1) / __level_rows, body, 1);
+  }
+}
+
+// x = M^-1 b with M's lower (unit) or upper (non-unit) triangle; x may alias b
+template<bool Lower, bool Unit, typename T, typename I>
+micron::task<void>
+__tri_solve(const csr<T, I> *M, const usize *diag, const level_schedule *s, const T *b, T *x)
+{
+  const I *outer = M->outer.data();
+  const I *inner = M->inner.data();
+  const T *vals = M->values.data();
+  co_await __level_for(s, [=](usize i) {
+    T acc = b[i];
+    if constexpr ( Lower ) {
+      for ( usize k = static_cast<usize>(outer[i]); k < diag[i]; ++k ) acc = math::fma<T>(-vals[k], x[inner[k]], acc);
+    } else {
+      for ( usize k = diag[i] + 1, e = static_cast<usize>(outer[i + 1]); k < e; ++k ) acc = math::fma<T>(-vals[k], x[inner[k]], acc);
+    }
+    x[i] = Unit ? acc : acc / vals[diag[i]];
+  });
+}
+
+// copy of the rows of A with columns <= i (lower_only) or all of them, each row sorted by column
+template<typename T, typename I>
+inline csr<T, I>
+__sorted_pattern(const csr<T, I> &A, bool lower_only)
+{
+  const usize n = A.rows;
+  csr<T, I> M(n, A.cols);
+  usize nnz = 0;
+  for ( usize i = 0; i < n; ++i ) {
+    for ( usize k = A.outer.data()[i]; k < static_cast<usize>(A.outer.data()[i + 1]); ++k )
+      if ( !lower_only or static_cast<usize>(A.inner.data()[k]) <= i ) ++nnz;
+    M.outer.data()[i + 1] = static_cast<I>(nnz);
+  }
+  M.inner = typename csr<T, I>::vec_i(nnz, I(0));
+  M.values = typename csr<T, I>::vec_v(nnz, T(0));
+  I *inner = M.inner.data();
+  T *vals = M.values.data();
+  usize p = 0;
+  for ( usize i = 0; i < n; ++i ) {
+    const usize r0 = p;
+    for ( usize k = A.outer.data()[i]; k < static_cast<usize>(A.outer.data()[i + 1]); ++k ) {
+      const I j = A.inner.data()[k];
+      if ( lower_only and static_cast<usize>(j) > i ) continue;
+      const T v = A.values.data()[k];
+      // insertion sort, rows are short
+      usize q = p++;
+      while ( q > r0 and inner[q - 1] > j ) {
+        inner[q] = inner[q - 1];
+        vals[q] = vals[q - 1];
+        --q;
+      }
+      inner[q] = j;
+      vals[q] = v;
+    }
+  }
+  return M;
+}
+
+// position of the diagonal in each sorted row; false if one is missing
+template<typename T, typename I>
+inline bool
+__find_diag(const csr<T, I> &M, __vec_u &diag)
+{
+  const usize n = M.rows;
+  diag = __vec_u(n, usize(0));
+  bool all = true;
+  for ( usize i = 0; i < n; ++i ) {
+    usize d = static_cast<usize>(M.outer.data()[i + 1]);
+    for ( usize k = M.outer.data()[i]; k < static_cast<usize>(M.outer.data()[i + 1]); ++k )
+      if ( static_cast<usize>(M.inner.data()[k]) == i ) {
+        d = k;
+        break;
+      }
+    if ( d == static_cast<usize>(M.outer.data()[i + 1]) ) all = false;
+    diag.data()[i] = d;
+  }
+  return all;
+}
+
+// ILU(0) row i, IKJ order; rows it reads belong to earlier levels and are final
+template<typename T, typename I>
+inline void
+__ilu0_row(const I *outer, const I *inner, T *vals, const usize *diag, usize i) noexcept
+{
+  const usize e = static_cast<usize>(outer[i + 1]);
+  for ( usize p = static_cast<usize>(outer[i]); p < diag[i]; ++p ) {
+    const usize k = static_cast<usize>(inner[p]);
+    const T lik = vals[p] / vals[diag[k]];
+    vals[p] = lik;
+    usize q = p + 1;
+    usize t = diag[k] + 1;
+    const usize ek = static_cast<usize>(outer[k + 1]);
+    while ( q < e and t < ek ) {
+      if ( inner[q] == inner[t] ) {
+        vals[q] = math::fma<T>(-lik, vals[t], vals[q]);
+        ++q;
+        ++t;
+      } else if ( inner[q] < inner[t] )
+        ++q;
+      else
+        ++t;
+    }
+  }
+}
+
+// IC(0) row i on the lower pattern, the diagonal is the last entry of every row
+template<typename T, typename I>
+inline void
+__ic0_row(const I *outer, const I *inner, T *vals, usize i) noexcept
+{
+  const usize a = static_cast<usize>(outer[i]);
+  const usize d = static_cast<usize>(outer[i + 1]) - 1;
+  for ( usize p = a; p < d; ++p ) {
+    const usize k = static_cast<usize>(inner[p]);
+    const usize ek = static_cast<usize>(outer[k + 1]) - 1;
+    T s = vals[p];
+    usize q = a;
+    usize t = static_cast<usize>(outer[k]);
+    while ( q < p and t < ek ) {
+      if ( inner[q] == inner[t] ) {
+        s = math::fma<T>(-vals[q], vals[t], s);
+        ++q;
+        ++t;
+      } else if ( inner[q] < inner[t] )
+        ++q;
+      else
+        ++t;
+    }
+    vals[p] = s / vals[ek];
+  }
+  T s = vals[d];
+  for ( usize p = a; p < d; ++p ) s = math::fma<T>(-vals[p], vals[p], s);
+  // a non-positive pivot poisons the row, make_ic0 checks the diagonal afterwards
+  vals[d] = (s > T(0)) ? math::fsqrt(s) : T(0);
+}
+
+template<typename T>
+inline bool
+__usable_pivot(T v) noexcept
+{
+  return (v < T(0) ? -v : v) > T(0) and v == v and (v - v) == T(0);
+}
+
+};      // namespace __impl_precond
+
+template<ieee754_floating T> struct identity_pre {
+  bool ok{ true };
+  usize n{ 0 };
+
+  micron::task<void>
+  apply_task(const T *r, T *z) const
+  {
+    if ( r == z ) co_return;
+    co_await __impl_sparse_mt::__pchunks(n, [=](usize lo, usize hi) {
+      for ( usize i = lo; i < hi; ++i ) z[i] = r[i];
+    });
+  }
+
+  inline void
+  apply(const dynvec<T> &r, dynvec<T> &z) const
+  {
+    micron::coro::sync_wait(apply_task(r.data(), z.data()));
+  }
+};
+
+template<ieee754_floating T, micron::integral I = u32> struct jacobi {
+  micron::vector<T, micron::allocator_serial<>, false> inv_diag;
+  bool ok{ true };
+
+  micron::task<void>
+  apply_task(const T *r, T *z) const
+  {
+    const T *d = inv_diag.data();
+    co_await __impl_sparse_mt::__pchunks(inv_diag.size(), [=](usize lo, usize hi) {
+      for ( usize i = lo; i < hi; ++i ) z[i] = d[i] * r[i];
+    });
+  }
+
+  inline void
+  apply(const dynvec<T> &r, dynvec<T> &z) const
+  {
+    micron::coro::sync_wait(apply_task(r.data(), z.data()));
+  }
+};
+
+template<ieee754_floating T, micron::integral I = u32> struct ilu0 {
+  csr<T, I> LU;      // unit L strictly below the diagonal, U on and above it; A's pattern, rows sorted
+  micron::vector<usize, micron::allocator_serial<>, false> diag;
+  level_schedule lower;
+  level_schedule upper;
+  bool ok{ false };
+
+  micron::task<void>
+  apply_task(const T *r, T *z) const
+  {
+    co_await __impl_precond::__tri_solve<true, true, T, I>(&LU, diag.data(), &lower, r, z);
+    co_await __impl_precond::__tri_solve<false, false, T, I>(&LU, diag.data(), &upper, z, z);
+  }
+
+  inline void
+  apply(const dynvec<T> &r, dynvec<T> &z) const
+  {
+    micron::coro::sync_wait(apply_task(r.data(), z.data()));
+  }
+};
+
+template<ieee754_floating T, micron::integral I = u32> struct ic0 {
+  csr<T, I> L;      // lower pattern of A, rows sorted, diagonal last
+  csr<T, I> U;      // L^T, diagonal first
+  micron::vector<usize, micron::allocator_serial<>, false> diag_l;
+  micron::vector<usize, micron::allocator_serial<>, false> diag_u;
+  level_schedule lower;
+  level_schedule upper;
+  bool ok{ false };
+
+  micron::task<void>
+  apply_task(const T *r, T *z) const
+  {
+    co_await __impl_precond::__tri_solve<true, false, T, I>(&L, diag_l.data(), &lower, r, z);
+    co_await __impl_precond::__tri_solve<false, false, T, I>(&U, diag_u.data(), &upper, z, z);
+  }
+
+  inline void
+  apply(const dynvec<T> &r, dynvec<T> &z) const
+  {
+    micron::coro::sync_wait(apply_task(r.data(), z.data()));
+  }
+};
+
+template<ieee754_floating T, micron::integral I>
+[[nodiscard]] inline identity_pre<T>
+make_identity(const csr<T, I> &A) noexcept
+{
+  return identity_pre<T>{ true, A.rows };
+}
+
+// a missing or zero diagonal entry leaves that row unscaled and clears ok
+template<ieee754_floating T, micron::integral I>
+[[nodiscard]] inline jacobi<T, I>
+make_jacobi(const csr<T, I> &A)
+{
+  jacobi<T, I> P;
+  P.inv_diag = micron::vector<T, micron::allocator_serial<>, false>(A.rows, T(1));
+  for ( usize i = 0; i < A.rows; ++i ) {
+    T d = T(0);
+    for ( usize k = A.outer.data()[i]; k < static_cast<usize>(A.outer.data()[i + 1]); ++k )
+      if ( static_cast<usize>(A.inner.data()[k]) == i ) d += A.values.data()[k];
+    if ( __impl_precond::__usable_pivot(d) )
+      P.inv_diag.data()[i] = T(1) / d;
+    else
+      P.ok = false;
+  }
+  return P;
+}
+
+template<ieee754_floating T, micron::integral I>
+[[nodiscard]] inline ilu0<T, I>
+make_ilu0(const csr<T, I> &A)
+{
+  ilu0<T, I> P;
+  P.LU = __impl_precond::__sorted_pattern(A, false);
+  if ( !__impl_precond::__find_diag(P.LU, P.diag) ) return P;
+  P.lower = __impl_precond::__build_schedule(P.LU, P.diag.data(), true);
+  P.upper = __impl_precond::__build_schedule(P.LU, P.diag.data(), false);
+  const I *outer = P.LU.outer.data();
+  const I *inner = P.LU.inner.data();
+  T *vals = P.LU.values.data();
+  const usize *diag = P.diag.data();
+  micron::coro::sync_wait(
+      __impl_precond::__level_for(&P.lower, [=](usize i) { __impl_precond::__ilu0_row<T, I>(outer, inner, vals, diag, i); }));
+  P.ok = true;
+  for ( usize i = 0; i < A.rows; ++i )
+    if ( !__impl_precond::__usable_pivot(vals[diag[i]]) ) P.ok = false;
+  return P;
+}
+
+// A must be symmetric, only its lower triangle is read
+template<ieee754_floating T, micron::integral I>
+[[nodiscard]] inline ic0<T, I>
+make_ic0(const csr<T, I> &A)
+{
+  ic0<T, I> P;
+  P.L = __impl_precond::__sorted_pattern(A, true);
+  const usize n = A.rows;
+  P.diag_l = micron::vector<usize, micron::allocator_serial<>, false>(n, usize(0));
+  for ( usize i = 0; i < n; ++i ) {
+    const usize a = static_cast<usize>(P.L.outer.data()[i]);
+    const usize e = static_cast<usize>(P.L.outer.data()[i + 1]);
+    if ( e == a or static_cast<usize>(P.L.inner.data()[e - 1]) != i ) return P;
+    P.diag_l.data()[i] = e - 1;
+  }
+  P.lower = __impl_precond::__build_schedule(P.L, P.diag_l.data(), true);
+  const I *outer = P.L.outer.data();
+  const I *inner = P.L.inner.data();
+  T *vals = P.L.values.data();
+  micron::coro::sync_wait(__impl_precond::__level_for(&P.lower, [=](usize i) { __impl_precond::__ic0_row<T, I>(outer, inner, vals, i); }));
+  P.ok = true;
+  for ( usize i = 0; i < n; ++i )
+    if ( !(vals[P.diag_l.data()[i]] > T(0)) or !__impl_precond::__usable_pivot(vals[P.diag_l.data()[i]]) ) P.ok = false;
+  // csc of L is csr of L^T: row j of U is column j of L, rows ascending so the diagonal comes first
+  csc<T, I> t = to_csc(P.L);
+  P.U.rows = n;
+  P.U.cols = n;
+  P.U.outer = micron::move(t.outer);
+  P.U.inner = micron::move(t.inner);
+  P.U.values = micron::move(t.values);
+  P.diag_u = micron::vector<usize, micron::allocator_serial<>, false>(n, usize(0));
+  for ( usize i = 0; i < n; ++i ) P.diag_u.data()[i] = static_cast<usize>(P.U.outer.data()[i]);
+  P.upper = __impl_precond::__build_schedule(P.U, P.diag_u.data(), false);
+  return P;
+}
+
+};      // namespace sparse
+};      // namespace math
+};      // namespace micron
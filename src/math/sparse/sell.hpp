@@ -0,0 +1,391 @@
+//  Copyright (c) 2024- David Lucius Severus
+//
+//  Distributed under the Boost Software License, Version 1.0.
+//  See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt
+#pragma once
+
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+// SELL-C-sigma (sliced ELLPACK) matrix
+//
+//   rows are sorted by length, longest first, inside windows of sigma rows, then cut into slices of C rows. a slice is
+//   padded to its longest row and stored column-major, so lane r of a C wide vector walks row r of the slice: one slice
+//   step is a contiguous load of C values, a contiguous load of C column indices, and a gather from x
+//
+//   perm      = length nslices*C; perm[s*C + r] = original row of lane r of slice s (>= rows for padding lanes)
+//   slice_ptr = length nslices+1; slice s is inner/values[slice_ptr[s], slice_ptr[s+1]), C * width(s) entries
+//   inner     = column indices; padding repeats the row's last column (0 for an empty row) so gathers stay in bounds
+//   values    = padding is 0
+//
+// sigma = C is ELLPACK per slice, sigma >= rows sorts globally; larger sigma pads less but scatters y more. sigma is
+// rounded up to a multiple of C
+//
+// the gather kernels need 32-bit indices (I = u32 / i32, cols < 2^31); other index types take the scalar slice loop
+
+#include "../../concepts.hpp"
+#include "../../types.hpp"
+#include "../../vector/vector.hpp"
+
+#include "../../sort/sort.hpp"
+#include "../ieee.hpp"
+#include "../quants/dynvec.hpp"
+#include "csr.hpp"
+
+#if defined(__micron_x86_avx2) || defined(__micron_arm_neon)
+#include "../../simd/intrin.hpp"
+#endif
+
+namespace micron
+{
+namespace math
+{
+namespace sparse
+{
+
+// slice height matching the widest gather the build has: one zmm of f32, else one ymm of f32 / two of f64
+template<typename T>
+inline constexpr usize sell_default_c =
+#if defined(__micron_x86_avx512f)
+    sizeof(T) == 4 ? 16 : 8;
+#else
+    8;
+#endif
+
+template<arith_scalar T, micron::integral I = u32, usize C = sell_default_c<T>>
+  requires(C > 0)
+struct sell {
+  using value_type = T;
+  using index_type = I;
+  using vec_i = micron::vector<I, micron::allocator_serial<>, false>;
+  using vec_v = micron::vector<T, micron::allocator_serial<>, false>;
+  using vec_u = micron::vector<usize, micron::allocator_serial<>, false>;
+
+  static constexpr usize chunk = C;
+
+  usize rows{ 0 };
+  usize cols{ 0 };
+  usize sigma{ 0 };
+  usize nslices{ 0 };
+  usize nnz_real{ 0 };
+  vec_i perm;
+  vec_u slice_ptr;
+  vec_i inner;
+  vec_v values;
+
+  sell() noexcept = default;
+  sell(const sell &) = default;
+  sell(sell &&) noexcept = default;
+  sell &operator=(const sell &) = default;
+  sell &operator=(sell &&) noexcept = default;
+
+  // nonzeros of the source matrix
+  [[nodiscard, gnu::always_inline]] usize
+  nnz() const noexcept
+  {
+    return nnz_real;
+  }
+
+  // nonzeros plus padding
+  [[nodiscard, gnu::always_inline]] usize
+  stored() const noexcept
+  {
+    return values.size();
+  }
+
+  [[nodiscard, gnu::always_inline]] usize
+  slice_width(usize s) const noexcept
+  {
+    return (slice_ptr.data()[s + 1] - slice_ptr.data()[s]) / C;
+  }
+};
+
+template<usize C, arith_scalar T, micron::integral I>
+[[nodiscard]] inline sell<T, I, C>
+to_sell(const csr<T, I> &A, usize sigma = 32 * C)
+{
+  sell<T, I, C> out;
+  const usize n = A.rows;
+  const I *outer = A.outer.data();
+  if ( sigma < C ) sigma = C;
+  sigma = ((sigma + C - 1) / C) * C;
+  out.rows = n;
+  out.cols = A.cols;
+  out.sigma = sigma;
+  out.nnz_real = A.nnz();
+  out.nslices = (n + C - 1) / C;
+  out.perm = typename sell<T, I, C>::vec_i(out.nslices * C, static_cast<I>(n));
+
+  // (~len, row) keys, ascending = longest first, ties by row
+  micron::vector<u64, micron::allocator_serial<>, false> keys(sigma, u64(0));
+  for ( usize w0 = 0; w0 < n; w0 += sigma ) {
+    const usize w1 = (w0 + sigma < n) ? w0 + sigma : n;
+    u64 *k = keys.data();
+    for ( usize i = w0; i < w1; ++i ) {
+      const u64 len = static_cast<u64>(outer[i + 1] - outer[i]);
+      k[i - w0] = ((~len & 0xffffffffull) << 32) | static_cast<u64>(i - w0);
+    }
+    if ( w1 - w0 > 1 ) micron::sort::__heap_range(k, 0, static_cast<max_t>(w1 - w0 - 1), [](u64 a, u64 b) { return a < b; });
+    for ( usize i = w0; i < w1; ++i ) out.perm.data()[i] = static_cast<I>(w0 + (k[i - w0] & 0xffffffffull));
+  }
+
+  out.slice_ptr = typename sell<T, I, C>::vec_u(out.nslices + 1, usize(0));
+  for ( usize s = 0; s < out.nslices; ++s ) {
+    usize w = 0;
+    for ( usize r = 0; r < C; ++r ) {
+      const usize row = static_cast<usize>(out.perm.data()[s * C + r]);
+      if ( row >= n ) continue;
+      const usize len = static_cast<usize>(outer[row + 1] - outer[row]);
+      if ( len > w ) w = len;
+    }
+    out.slice_ptr.data()[s + 1] = out.slice_ptr.data()[s] + w * C;
+  }
+  const usize total = out.slice_ptr.data()[out.nslices];
+  out.inner = typename sell<T, I, C>::vec_i(total, I(0));
+  out.values = typename sell<T, I, C>::vec_v(total, T(0));
+  for ( usize s = 0; s < out.nslices; ++s ) {
+    const usize base = out.slice_ptr.data()[s];
+    const usize w = out.slice_width(s);
+    for ( usize r = 0; r < C; ++r ) {
+      const usize row = static_cast<usize>(out.perm.data()[s * C + r]);
+      usize a = 0, len = 0;
+      if ( row < n ) {
+        a = static_cast<usize>(outer[row]);
+        len = static_cast<usize>(outer[row + 1]) - a;
+      }
+      I last = I(0);
+      for ( usize k = 0; k < w; ++k ) {
+        if ( k < len ) {
+          last = A.inner.data()[a + k];
+          out.values.data()[base + k * C + r] = A.values.data()[a + k];
+        }
+        out.inner.data()[base + k * C + r] = last;
+      }
+    }
+  }
+  return out;
+}
+
+template<arith_scalar T, micron::integral I>
+[[nodiscard]] inline sell<T, I>
+to_sell(const csr<T, I> &A, usize sigma = 32 * sell_default_c<T>)
+{
+  return to_sell<sell_default_c<T>, T, I>(A, sigma);
+}
+
+namespace __impl_sell
+{
+
+// lane results of one slice back to their rows
+template<typename T, typename I, usize C>
+[[gnu::always_inline]] inline void
+__scatter(const T *acc, const I *perm, usize n, T alpha, T beta, T *y) noexcept
+{
+  for ( usize r = 0; r < C; ++r ) {
+    const usize row = static_cast<usize>(perm[r]);
+    if ( row >= n ) continue;
+    y[row] = (beta == T(0)) ? alpha * acc[r] : math::fma<T>(alpha, acc[r], beta * y[row]);
+  }
+}
+
+template<typename T, typename I, usize C>
+[[gnu::always_inline]] inline void
+__slice_scalar(const I *inner, const T *vals, usize w, const T *x, T *acc) noexcept
+{
+  for ( usize r = 0; r < C; ++r ) acc[r] = T(0);
+  for ( usize k = 0; k < w; ++k ) {
+    const I *ik = inner + k * C;
+    const T *vk = vals + k * C;
+    for ( usize r = 0; r < C; ++r ) acc[r] = math::fma<T>(vk[r], x[ik[r]], acc[r]);
+  }
+}
+
+#if defined(__micron_x86_avx2)
+
+// a*b + c, fused where the ISA provides it; avx2 does not imply fma
+[[gnu::always_inline]] inline __m256d
+__madd_pd(__m256d a, __m256d b, __m256d c) noexcept
+{
+#if defined(__micron_x86_fma)
+  return _mm256_fmadd_pd(a, b, c);
+#else
+  return _mm256_add_pd(_mm256_mul_pd(a, b), c);
+#endif
+}
+
+[[gnu::always_inline]] inline __m256
+__madd_ps(__m256 a, __m256 b, __m256 c) noexcept
+{
+#if defined(__micron_x86_fma)
+  return _mm256_fmadd_ps(a, b, c);
+#else
+  return _mm256_add_ps(_mm256_mul_ps(a, b), c);
+#endif
+}
+
+template<usize C>
+[[gnu::always_inline]] inline void
+__slice_avx2_f64(const u32 *inner, const f64 *vals, usize w, const f64 *x, f64 *acc) noexcept
+{
+  constexpr usize G = C / 4;
+  __m256d a[G];
+  for ( usize g = 0; g < G; ++g ) a[g] = _mm256_setzero_pd();
+  for ( usize k = 0; k < w; ++k ) {
+    const u32 *ik = inner + k * C;
+    const f64 *vk = vals + k * C;
+    for ( usize g = 0; g < G; ++g ) {
+      const __m128i idx = _mm_loadu_si128(reinterpret_cast<const __m128i_u *>(ik + 4 * g));
+      const __m256d xv = _mm256_i32gather_pd(reinterpret_cast<const double *>(x), idx, 8);
+      a[g] = __madd_pd(_mm256_loadu_pd(reinterpret_cast<const double *>(vk + 4 * g)), xv, a[g]);
+    }
+  }
+  for ( usize g = 0; g < G; ++g ) _mm256_storeu_pd(reinterpret_cast<double *>(acc + 4 * g), a[g]);
+}
+
+template<usize C>
+[[gnu::always_inline]] inline void
+__slice_avx2_f32(const u32 *inner, const f32 *vals, usize w, const f32 *x, f32 *acc) noexcept
+{
+  constexpr usize G = C / 8;
+  __m256 a[G];
+  for ( usize g = 0; g < G; ++g ) a[g] = _mm256_setzero_ps();
+  for ( usize k = 0; k < w; ++k ) {
+    const u32 *ik = inner + k * C;
+    const f32 *vk = vals + k * C;
+    for ( usize g = 0; g < G; ++g ) {
+      const __m256i idx = _mm256_loadu_si256(reinterpret_cast<const __m256i_u *>(ik + 8 * g));
+      const __m256 xv = _mm256_i32gather_ps(reinterpret_cast<const float *>(x), idx, 4);
+      a[g] = __madd_ps(_mm256_loadu_ps(reinterpret_cast<const float *>(vk + 8 * g)), xv, a[g]);
+    }
+  }
+  for ( usize g = 0; g < G; ++g ) _mm256_storeu_ps(reinterpret_cast<float *>(acc + 8 * g), a[g]);
+}
+
+#endif
+
+#if defined(__micron_x86_avx512f)
+
+template<usize C>
+[[gnu::always_inline]] inline void
+__slice_avx512_f32(const u32 *inner, const f32 *vals, usize w, const f32 *x, f32 *acc) noexcept
+{
+  constexpr usize G = C / 16;
+  __m512 a[G];
+  for ( usize g = 0; g < G; ++g ) a[g] = _mm512_setzero_ps();
+  for ( usize k = 0; k < w; ++k ) {
+    const u32 *ik = inner + k * C;
+    const f32 *vk = vals + k * C;
+    for ( usize g = 0; g < G; ++g ) {
+      const __m512i idx = _mm512_loadu_si512(ik + 16 * g);
+      const __m512 xv = _mm512_i32gather_ps(idx, reinterpret_cast<const float *>(x), 4);
+      a[g] = _mm512_fmadd_ps(_mm512_loadu_ps(vk + 16 * g), xv, a[g]);
+    }
+  }
+  for ( usize g = 0; g < G; ++g ) _mm512_storeu_ps(acc + 16 * g, a[g]);
+}
+
+#endif
+
+#if defined(__micron_arch_arm64) && defined(__micron_arm_neon)
+
+// no gather on NEON: lanes are filled from x one by one, the multiply-adds still run C wide
+template<usize C>
+[[gnu::always_inline]] inline void
+__slice_neon_f64(const u32 *inner, const f64 *vals, usize w, const f64 *x, f64 *acc) noexcept
+{
+  constexpr usize G = C / 2;
+  float64x2_t a[G];
+  for ( usize g = 0; g < G; ++g ) a[g] = vdupq_n_f64(0.0);
+  for ( usize k = 0; k < w; ++k ) {
+    const u32 *ik = inner + k * C;
+    const f64 *vk = vals + k * C;
+    for ( usize g = 0; g < G; ++g ) {
+      const float64x2_t xv = { x[ik[2 * g]], x[ik[2 * g + 1]] };
+      a[g] = vfmaq_f64(a[g], vld1q_f64(vk + 2 * g), xv);
+    }
+  }
+  for ( usize g = 0; g < G; ++g ) vst1q_f64(acc + 2 * g, a[g]);
+}
+
+template<usize C>
+[[gnu::always_inline]] inline void
+__slice_neon_f32(const u32 *inner, const f32 *vals, usize w, const f32 *x, f32 *acc) noexcept
+{
+  constexpr usize G = C / 4;
+  float32x4_t a[G];
+  for ( usize g = 0; g < G; ++g ) a[g] = vdupq_n_f32(0.0f);
+  for ( usize k = 0; k < w; ++k ) {
+    const u32 *ik = inner + k * C;
+    const f32 *vk = vals + k * C;
+    for ( usize g = 0; g < G; ++g ) {
+      const float32x4_t xv = { x[ik[4 * g]], x[ik[4 * g + 1]], x[ik[4 * g + 2]], x[ik[4 * g + 3]] };
+      a[g] = vfmaq_f32(a[g], vld1q_f32(vk + 4 * g), xv);
+    }
+  }
+  for ( usize g = 0; g < G; ++g ) vst1q_f32(acc + 4 * g, a[g]);
+}
+
+#endif
+
+// acc[0, C) = slice s times x, widest kernel the build and the index type allow
+template<typename T, typename I, usize C>
+[[gnu::always_inline]] inline void
+__slice(const I *inner, const T *vals, usize w, const T *x, T *acc) noexcept
+{
+  constexpr bool i32 = sizeof(I) == 4;
+  [[maybe_unused]] const u32 *iu = reinterpret_cast<const u32 *>(inner);
+#if defined(__micron_x86_avx512f)
+  if constexpr ( i32 and micron::is_same_v<T, f32> and C % 16 == 0 ) {
+    __slice_avx512_f32<C>(iu, vals, w, x, acc);
+    return;
+  }
+#endif
+#if defined(__micron_x86_avx2)
+  if constexpr ( i32 and micron::is_same_v<T, f64> and C % 4 == 0 ) {
+    __slice_avx2_f64<C>(iu, vals, w, x, acc);
+    return;
+  } else if constexpr ( i32 and micron::is_same_v<T, f32> and C % 8 == 0 ) {
+    __slice_avx2_f32<C>(iu, vals, w, x, acc);
+    return;
+  }
+#endif
+#if defined(__micron_arch_arm64) && defined(__micron_arm_neon)
+  if constexpr ( i32 and micron::is_same_v<T, f64> and C % 2 == 0 ) {
+    __slice_neon_f64<C>(iu, vals, w, x, acc);
+    return;
+  } else if constexpr ( i32 and micron::is_same_v<T, f32> and C % 4 == 0 ) {
+    __slice_neon_f32<C>(iu, vals, w, x, acc);
+    return;
+  }
+#endif
+  __slice_scalar<T, I, C>(inner, vals, w, x, acc);
+}
+
+// slices [s0, s1) of y := alpha * A * x + beta * y
+template<typename T, typename I, usize C>
+inline void
+__spmv_slices(T alpha, const sell<T, I, C> &A, const T *x, T beta, T *y, usize s0, usize s1) noexcept
+{
+  alignas(64) T acc[C];
+  const usize *sp = A.slice_ptr.data();
+  const I *inner = A.inner.data();
+  const T *vals = A.values.data();
+  const I *perm = A.perm.data();
+  for ( usize s = s0; s < s1; ++s ) {
+    __slice<T, I, C>(inner + sp[s], vals + sp[s], (sp[s + 1] - sp[s]) / C, x, acc);
+    __scatter<T, I, C>(acc, perm + s * C, A.rows, alpha, beta, y);
+  }
+}
+
+};      // namespace __impl_sell
+
+// y := alpha * A * x + beta * y
+template<ieee754_floating T, micron::integral I, usize C>
+inline void
+spmv(T alpha, const sell<T, I, C> &A, const dynvec<T> &x, T beta, dynvec<T> &y) noexcept
+{
+  __impl_sell::__spmv_slices<T, I, C>(alpha, A, x.data(), beta, y.data(), 0, A.nslices);
+}
+
+};      // namespace sparse
+};      // namespace math
+};      // namespace micron
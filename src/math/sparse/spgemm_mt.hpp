@@ -0,0 +1,361 @@
+//  Copyright (c) 2024- David Lucius Severus
+//
+//  Distributed under the Boost Software License, Version 1.0.
+//  See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt
+#pragma once
+
+#include "../../bits/__abc_mt.hpp"      // autofires MICRON_ABC_MT; must precede abcmalloc
+
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+// two-phase sparse * sparse on the coroutine engine
+//   spgemm_task / spgemm_mt = C := A * B, csc * csc or csr * csr
+//
+//   flops     = per output column, the products it takes (sum of nnz(A(:, k)) over the nonzeros B(k, j))
+//   symbolic  = columns in parallel, count the distinct rows of each; a prefix sum gives C.outer and C is allocated once,
+//               at its exact size
+//   numeric   = columns in parallel again, each written straight into its slot of C
+//
+// the accumulator is picked per column from its flops:
+//   esc   = flops <= __esc_max: expand (row, a, b) triples, stable sort by row, compress
+//   hash  = 4 * flops < rows: open addressing table of 2 * flops rounded up to a power of two, rows sorted on the way out
+//   dense = otherwise: a rows-sized SPA, as the serial spgemm
+// scratch lives per leaf and is reused across its columns, the dense SPA is only allocated by leaves that need one
+//
+// every accumulator adds a row's products in the order the serial Gustavson loop does (a * b first, fma after), so the
+// result is bitwise the serial spgemm's. columns are split by flops, not count, so a few heavy columns don't serialise
+// the pass
+//
+// *_mt entry points sync_wait on the engine, never call them from inside a task; co_await the *_task versions there
+
+#include "../../concepts.hpp"
+#include "../../types.hpp"
+#include "../../vector/vector.hpp"
+
+#include "../../parallel/engine.hpp"
+#include "../../sort/sort.hpp"
+#include "../ieee.hpp"
+#include "csc.hpp"
+#include "csr.hpp"
+#include "parallel.hpp"
+
+namespace micron
+{
+namespace math
+{
+namespace sparse
+{
+namespace __impl_spgemm
+{
+
+// products per leaf
+inline constexpr usize __flops = 65536;
+// largest column accumulated by expand-sort-compress
+inline constexpr usize __esc_max = 64;
+
+// one compressed operand, outer = columns of a csc or rows of a csr
+template<typename T, typename I> struct __view {
+  const I *outer;
+  const I *inner;
+  const T *vals;
+  usize n_outer;
+  usize n_inner;
+};
+
+template<typename T, typename I> struct __triple {
+  I row;
+  T a;
+  T b;
+};
+
+template<typename T, typename I> struct __ws {
+  micron::vector<__triple<T, I>, micron::allocator_serial<>, false> esc;
+  micron::vector<I, micron::allocator_serial<>, false> keys;
+  micron::vector<T, micron::allocator_serial<>, false> vals;
+  micron::vector<T, micron::allocator_serial<>, false> acc;
+  micron::vector<u8, micron::allocator_serial<>, false> marker;
+  micron::vector<I, micron::allocator_serial<>, false> active;
+};
+
+template<typename I>
+inline void
+__sort_idx(I *a, usize n) noexcept
+{
+  if ( n < 2 ) return;
+  if ( n > 32 ) {
+    max_t depth = 0;
+    for ( usize t = n; t > 1; t >>= 1 ) depth += 2;
+    micron::sort::__introsort(a, 0, static_cast<max_t>(n - 1), depth, [](I x, I y) { return x < y; });
+  }
+  for ( usize i = 1; i < n; ++i ) {
+    const I cur = a[i];
+    usize j = i;
+    while ( j > 0 and a[j - 1] > cur ) {
+      a[j] = a[j - 1];
+      --j;
+    }
+    a[j] = cur;
+  }
+}
+
+template<typename T, typename I>
+inline u64
+__col_flops(const __view<T, I> &S, const __view<T, I> &D, usize j) noexcept
+{
+  u64 f = 0;
+  for ( usize p = static_cast<usize>(D.outer[j]), e = static_cast<usize>(D.outer[j + 1]); p < e; ++p ) {
+    const usize k = static_cast<usize>(D.inner[p]);
+    if ( k >= S.n_outer or D.vals[p] == T(0) ) continue;
+    const I s = S.outer[k], t = S.outer[k + 1];
+    if ( t > s ) f += static_cast<u64>(t - s);
+  }
+  return f;
+}
+
+// walks the products of column j in serial order: fn(row, a, b)
+template<typename T, typename I, class Fn>
+[[gnu::always_inline]] inline void
+__products(const __view<T, I> &S, const __view<T, I> &D, usize j, Fn &&fn) noexcept
+{
+  for ( usize p = static_cast<usize>(D.outer[j]), e = static_cast<usize>(D.outer[j + 1]); p < e; ++p ) {
+    const usize k = static_cast<usize>(D.inner[p]);
+    if ( k >= S.n_outer ) continue;
+    const T b = D.vals[p];
+    if ( b == T(0) ) continue;
+    for ( usize q = static_cast<usize>(S.outer[k]), f = static_cast<usize>(S.outer[k + 1]); q < f; ++q ) {
+      const usize i = static_cast<usize>(S.inner[q]);
+      if ( i >= S.n_inner ) continue;
+      fn(S.inner[q], S.vals[q], b);
+    }
+  }
+}
+
+template<typename T, typename I>
+usize
+__esc(const __view<T, I> &S, const __view<T, I> &D, usize j, __ws<T, I> &ws, I *ri, T *rv) noexcept
+{
+  if ( ws.esc.size() < __esc_max ) ws.esc = decltype(ws.esc)(__esc_max, __triple<T, I>{});
+  __triple<T, I> *e = ws.esc.data();
+  usize n = 0;
+  __products(S, D, j, [&](I i, T a, T b) {
+    // stable insertion keeps each row's products in arrival order
+    usize p = n++;
+    while ( p > 0 and e[p - 1].row > i ) {
+      e[p] = e[p - 1];
+      --p;
+    }
+    e[p] = __triple<T, I>{ i, a, b };
+  });
+  usize c = 0;
+  for ( usize p = 0; p < n; ) {
+    T s = e[p].a * e[p].b;
+    usize q = p + 1;
+    for ( ; q < n and e[q].row == e[p].row; ++q ) s = math::fma<T>(e[q].a, e[q].b, s);
+    if ( ri ) {
+      ri[c] = e[p].row;
+      rv[c] = s;
+    }
+    ++c;
+    p = q;
+  }
+  return c;
+}
+
+template<typename T, typename I>
+usize
+__hash(const __view<T, I> &S, const __view<T, I> &D, usize j, u64 fl, __ws<T, I> &ws, I *ri, T *rv) noexcept
+{
+  constexpr I empty = static_cast<I>(~I(0));
+  u32 bits = 1;
+  while ( (u64(1) << bits) < 2 * fl ) ++bits;
+  const usize cap = usize(1) << bits;
+  const usize mask = cap - 1;
+  if ( ws.keys.size() < cap ) {
+    ws.keys = decltype(ws.keys)(cap, empty);
+    ws.vals = decltype(ws.vals)(cap, T(0));
+  } else {
+    for ( usize h = 0; h < cap; ++h ) ws.keys.data()[h] = empty;
+  }
+  I *keys = ws.keys.data();
+  T *vals = ws.vals.data();
+  auto slot = [=](I i) {
+    usize h = static_cast<usize>((static_cast<u64>(i) * 0x9E3779B97F4A7C15ull) >> (64 - bits));
+    while ( keys[h] != empty and keys[h] != i ) h = (h + 1) & mask;
+    return h;
+  };
+  usize c = 0;
+  __products(S, D, j, [&](I i, T a, T b) {
+    const usize h = slot(i);
+    if ( keys[h] == empty ) {
+      keys[h] = i;
+      vals[h] = a * b;
+      if ( ri ) ri[c] = i;
+      ++c;
+    } else {
+      vals[h] = math::fma<T>(a, b, vals[h]);
+    }
+  });
+  if ( ri ) {
+    __sort_idx(ri, c);
+    for ( usize p = 0; p < c; ++p ) rv[p] = vals[slot(ri[p])];
+  }
+  return c;
+}
+
+template<typename T, typename I>
+usize
+__dense(const __view<T, I> &S, const __view<T, I> &D, usize j, __ws<T, I> &ws, I *ri, T *rv) noexcept
+{
+  const usize n = S.n_inner;
+  if ( ws.marker.size() < n ) {
+    ws.acc = decltype(ws.acc)(n, T(0));
+    ws.marker = decltype(ws.marker)(n, u8(0));
+    ws.active = decltype(ws.active)(n, I(0));
+  }
+  T *acc = ws.acc.data();
+  u8 *marker = ws.marker.data();
+  I *active = ws.active.data();
+  usize c = 0;
+  __products(S, D, j, [&](I i, T a, T b) {
+    const usize r = static_cast<usize>(i);
+    if ( marker[r] == 0 ) {
+      marker[r] = 1;
+      active[c++] = i;
+      acc[r] = a * b;
+    } else {
+      acc[r] = math::fma<T>(a, b, acc[r]);
+    }
+  });
+  if ( ri ) __sort_idx(active, c);
+  for ( usize p = 0; p < c; ++p ) {
+    const usize r = static_cast<usize>(active[p]);
+    if ( ri ) {
+      ri[p] = active[p];
+      rv[p] = acc[r];
+    }
+    marker[r] = 0;
+  }
+  return c;
+}
+
+// distinct rows of column j; with ri / rv set also writes them, ascending
+template<typename T, typename I>
+inline usize
+__column(const __view<T, I> &S, const __view<T, I> &D, usize j, u64 fl, __ws<T, I> &ws, I *ri, T *rv) noexcept
+{
+  if ( fl == 0 ) return 0;
+  if ( fl <= __esc_max ) return __esc(S, D, j, ws, ri, rv);
+  if ( 4 * fl < S.n_inner ) return __hash(S, D, j, fl, ws, ri, rv);
+  return __dense(S, D, j, ws, ri, rv);
+}
+
+// out := S * D in the compressed format of D (n_inner = S.n_inner, n_outer = D.n_outer)
+template<typename T, typename I, class M>
+micron::task<void>
+__run(__view<T, I> S, __view<T, I> D, M *out)
+{
+  const usize n = D.n_outer;
+  micron::vector<u64, micron::allocator_serial<>, false> pref(n + 1, u64(0));
+  micron::vector<usize, micron::allocator_serial<>, false> cnt(n + 1, usize(0));
+  u64 *pf = pref.data();
+  usize *ct = cnt.data();
+
+  // flops, balanced by nonzeros of D
+  {
+    auto w = [=](usize j) -> u64 { return static_cast<u64>(D.outer[j]) + j; };
+    auto leaf = [=](usize j0, usize j1) {
+      for ( usize j = j0; j < j1; ++j ) pf[j + 1] = __col_flops(S, D, j);
+    };
+    const usize nb = __impl_sparse_mt::__nleaves(static_cast<u64>(D.outer[n]) + n, __impl_sparse_mt::__spmv_nnz);
+    co_await __impl_sparse_mt::__pbalanced(n, nb, w, leaf);
+  }
+  for ( usize j = 0; j < n; ++j ) pf[j + 1] += pf[j] + 1;      // + 1 charges each column for its own overhead
+
+  const u64 *cpf = pf;
+  auto w = [=](usize j) -> u64 { return cpf[j]; };
+  const usize nb = __impl_sparse_mt::__nleaves(pf[n], __flops);
+
+  // symbolic
+  {
+    auto leaf = [=](usize j0, usize j1) {
+      __ws<T, I> ws;
+      for ( usize j = j0; j < j1; ++j ) ct[j] = __column(S, D, j, cpf[j + 1] - cpf[j] - 1, ws, static_cast<I *>(nullptr), static_cast<T *>(nullptr));
+    };
+    co_await __impl_sparse_mt::__pbalanced(n, nb, w, leaf);
+  }
+
+  usize nnz = 0;
+  I *outer = out->outer.data();
+  outer[0] = I(0);
+  for ( usize j = 0; j < n; ++j ) {
+    nnz += ct[j];
+    outer[j + 1] = static_cast<I>(nnz);
+  }
+  out->inner = typename M::vec_i(nnz, I(0));
+  out->values = typename M::vec_v(nnz, T(0));
+
+  // numeric
+  {
+    const I *co = outer;
+    I *ri = out->inner.data();
+    T *rv = out->values.data();
+    auto leaf = [=](usize j0, usize j1) {
+      __ws<T, I> ws;
+      for ( usize j = j0; j < j1; ++j ) {
+        const usize o = static_cast<usize>(co[j]);
+        __column(S, D, j, cpf[j + 1] - cpf[j] - 1, ws, ri + o, rv + o);
+      }
+    };
+    co_await __impl_sparse_mt::__pbalanced(n, nb, w, leaf);
+  }
+}
+
+};      // namespace __impl_spgemm
+
+// C := A * B (csc), C sized by a symbolic pass; co_await it from inside a task. B.rows != A.cols leaves C empty
+template<ieee754_floating T, micron::integral I>
+micron::task<void>
+spgemm_task(const csc<T, I> &A, const csc<T, I> &B, csc<T, I> &C)
+{
+  C = csc<T, I>(A.rows, B.cols);
+  if ( B.rows != A.cols ) co_return;
+  __impl_spgemm::__view<T, I> S{ A.outer.data(), A.inner.data(), A.values.data(), A.cols, A.rows };
+  __impl_spgemm::__view<T, I> D{ B.outer.data(), B.inner.data(), B.values.data(), B.cols, B.rows };
+  co_await __impl_spgemm::__run<T, I, csc<T, I>>(S, D, &C);
+}
+
+// C := A * B (csr): row i of C gathers rows of B, the csc kernel with the operands' roles swapped
+template<ieee754_floating T, micron::integral I>
+micron::task<void>
+spgemm_task(const csr<T, I> &A, const csr<T, I> &B, csr<T, I> &C)
+{
+  C = csr<T, I>(A.rows, B.cols);
+  if ( B.rows != A.cols ) co_return;
+  __impl_spgemm::__view<T, I> S{ B.outer.data(), B.inner.data(), B.values.data(), B.rows, B.cols };
+  __impl_spgemm::__view<T, I> D{ A.outer.data(), A.inner.data(), A.values.data(), A.rows, A.cols };
+  co_await __impl_spgemm::__run<T, I, csr<T, I>>(S, D, &C);
+}
+
+// multithreaded spgemm (csc); blocks until done, call from outside the engine
+template<ieee754_floating T, micron::integral I>
+[[nodiscard]] inline csc<T, I>
+spgemm_mt(const csc<T, I> &A, const csc<T, I> &B)
+{
+  csc<T, I> C;
+  micron::coro::sync_wait(spgemm_task<T, I>(A, B, C));
+  return C;
+}
+
+// multithreaded spgemm (csr)
+template<ieee754_floating T, micron::integral I>
+[[nodiscard]] inline csr<T, I>
+spgemm_mt(const csr<T, I> &A, const csr<T, I> &B)
+{
+  csr<T, I> C;
+  micron::coro::sync_wait(spgemm_task<T, I>(A, B, C));
+  return C;
+}
+
+};      // namespace sparse
+};      // namespace math
+};      // namespace micron
@@ -22,5 +22,7 @@ concept is_policy = requires {
 #include "allocator_types/bits.hpp"
 
 #include "allocator_types/map_allocator.hpp"
+#include "allocator_types/monotonic_allocator.hpp"
+#include "allocator_types/pool_allocator.hpp"
 #include "allocator_types/serial_allocator.hpp"
 #include "allocator_types/small_allocator.hpp"
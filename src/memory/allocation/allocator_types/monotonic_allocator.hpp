@@ -0,0 +1,144 @@
+//  Copyright (c) 2024- David Lucius Severus
+//
+//  Distributed under the Boost Software License, Version 1.0.
+//  See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt
+#pragma once
+
+namespace micron
+{
+
+// monotonic (bump) arena over a chain of blocks pulled from abcmalloc
+// create() is a pointer bump, destroy() is a no-op unless it hands back the most recent allocation, and release() returns every
+// block at once. Tag selects the arena: every container instantiated with the same monotonic_allocator<Tag> on one thread shares one
+// chain, so a whole request (parse, build maps, discard) is torn down with monotonic_allocator<Tag>::release()
+//
+// NOTE: the arena is thread_local, one per Tag per thread, so the default Tag is safe to use from any number of threads without a
+// lock. memory must be grown, destroyed and released on the thread that created it; a thread that exits without release() leaks its
+// blocks (there is no exit hook, a container outliving the thread may still point into them)
+// WARNING: release() invalidates every container still holding arena memory, let them go out of scope (or free()) first
+template<class Tag = void, usize Block = 64 * 1024> class monotonic_allocator: private abc_allocator<byte>
+{
+  static constexpr usize __align = 16;
+
+  struct __block {
+    __block *prev;
+    usize size;
+  };
+
+  static_assert(sizeof(__block) % __align == 0);
+  static_assert(Block > sizeof(__block));
+
+  static inline thread_local __block *__head = nullptr;
+  static inline thread_local byte *__top = nullptr;
+  static inline thread_local byte *__end = nullptr;
+
+  [[gnu::always_inline]] static inline usize
+  __round(usize n) noexcept
+  {
+    return to_granularity<__align>(n);
+  }
+
+  // chains a fresh (zeroed) block large enough for n payload bytes
+  static void
+  __refill(usize n)
+  {
+    usize sz = sizeof(__block) + n;
+    sz = to_page(sz < Block ? Block : sz);
+    chunk<byte> mem = allocate(sz);
+    __block *b = reinterpret_cast<__block *>(mem.ptr);
+    b->prev = __head;
+    b->size = mem.len;
+    __head = b;
+    __top = mem.ptr + sizeof(__block);
+    __end = mem.ptr + mem.len;
+  }
+
+public:
+  ~monotonic_allocator() = default;
+  monotonic_allocator() = default;
+  monotonic_allocator(const monotonic_allocator &o) = default;
+  monotonic_allocator(monotonic_allocator &&o) = default;
+  monotonic_allocator &operator=(const monotonic_allocator &o) = default;
+  monotonic_allocator &operator=(monotonic_allocator &&o) = default;
+
+  inline __attribute__((always_inline)) static constexpr usize
+  auto_size()
+  {
+    return 256;
+  }
+
+  // memory handed out is zeroed, same as the abcmalloc backed allocators
+  static chunk<byte>
+  create(usize n)
+  {
+    n = __round(n);
+    if ( static_cast<usize>(__end - __top) < n ) __refill(n);
+    byte *p = __top;
+    __top += n;
+    return { p, n };
+  }
+
+  static chunk<byte>
+  grow(chunk<byte> memory, usize n)
+  {
+    if ( memory.len == 0 and memory.ptr == nullptr ) return create(n);
+    n = __round(n);
+    const usize held = __round(memory.len);
+    if ( n < (held << 1) ) n = held << 1;
+    // the top allocation grows in place, the bytes past __top were never handed out
+    if ( memory.ptr + held == __top and static_cast<usize>(__end - memory.ptr) >= n ) {
+      __top = memory.ptr + n;
+      return { memory.ptr, n };
+    }
+    chunk<byte> mem = create(n);
+    micron::memcpy(mem.ptr, memory.ptr, memory.len);
+    destroy(memory);
+    return mem;
+  }
+
+  // only the most recent allocation is reclaimed, everything else waits for release()
+  static void
+  destroy(const chunk<byte> mem)
+  {
+    if ( mem.ptr == nullptr ) [[unlikely]]
+      return;
+    const usize n = __round(mem.len);
+    if ( mem.ptr + n == __top ) {
+      micron::memset(mem.ptr, 0x0, n);
+      __top = mem.ptr;
+    }
+  }
+
+  // returns every block of this thread's arena to abcmalloc
+  static void
+  release(void)
+  {
+    while ( __head != nullptr ) {
+      __block *prev = __head->prev;
+      deallocate(reinterpret_cast<byte *>(__head), __head->size);
+      __head = prev;
+    }
+    __top = nullptr;
+    __end = nullptr;
+  }
+
+  // bytes currently held from abcmalloc, headers included
+  static usize
+  footprint(void)
+  {
+    usize n = 0;
+    for ( const __block *b = __head; b != nullptr; b = b->prev ) n += b->size;
+    return n;
+  }
+
+  byte *share(void) = delete;
+
+  static i16
+  get_grow()
+  {
+    return 2;
+  }
+};
+
+};      // namespace micron
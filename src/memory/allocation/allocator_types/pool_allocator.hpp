@@ -0,0 +1,214 @@
+//  Copyright (c) 2024- David Lucius Severus
+//
+//  Distributed under the Boost Software License, Version 1.0.
+//  See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt
+#pragma once
+
+namespace micron
+{
+
+// size segregated pool for small fixed size objects (list/tree nodes)
+// requests are rounded to a power of two class between 16 and Max bytes, each class keeps an intrusive free list carved out of
+// Slab sized blocks. destroy() pushes onto the free list, create() pops from it, neither touches abcmalloc in the steady state.
+// anything larger than Max goes straight through to abcmalloc. Tag selects the pool, like monotonic_allocator
+//
+// NOTE: the pool is thread_local, one per Tag per thread, no lock. slabs are mapped Slab aligned, so destroy() finds a block's slab
+// header from its address; a block destroyed on the thread that carved it goes back on that thread's free list, one destroyed
+// anywhere else is pushed onto its slab's remote list (one CAS) and the owner picks it up when its own free list for that class
+// runs dry. a thread therefore only ever hands out blocks from its own slabs, and release() frees nothing another thread can reach
+// through a free list. slabs are only released by (and leak with) the thread that carved them
+// WARNING: release() invalidates every block of every class, on every thread; blocks still held elsewhere must be destroyed first.
+// oversized (> Max) blocks aren't tracked and must be destroyed normally
+template<class Tag = void, usize Max = 1024, usize Slab = 64 * 1024>
+  requires(Max >= 16 and (Max & (Max - 1)) == 0 and (Slab & (Slab - 1)) == 0)
+class pool_allocator: private abc_allocator<byte>
+{
+  static constexpr usize __min_shift = 4;
+  static constexpr usize __classes = static_cast<usize>(__builtin_ctzll(Max)) - __min_shift + 1;
+
+  struct __free_node {
+    __free_node *next;
+  };
+
+  // first bytes of every slab; remote is the only field other threads touch
+  struct __slab {
+    __slab *prev;
+    __free_node *remote;
+    const void *owner;
+    usize cls;
+  };
+
+  static_assert(sizeof(__slab) == 32);
+  static_assert(Slab >= page_size and Slab >= Max + sizeof(__slab));
+
+  static inline thread_local __free_node *__free[__classes] = {};
+  static inline thread_local __slab *__slabs = nullptr;
+
+  // any address unique to the calling thread will do
+  [[gnu::always_inline]] static inline const void *
+  __self(void) noexcept
+  {
+    return &__slabs;
+  }
+
+  [[gnu::always_inline]] static inline __slab *
+  __slab_of(const byte *p) noexcept
+  {
+    return reinterpret_cast<__slab *>(reinterpret_cast<uintptr_t>(p) & ~(uintptr_t{ Slab } - 1));
+  }
+
+  [[gnu::always_inline]] static inline usize
+  __class_of(usize n) noexcept
+  {
+    if ( n <= (usize{ 1 } << __min_shift) ) return 0;
+    return static_cast<usize>(64 - __builtin_clzll(n - 1)) - __min_shift;
+  }
+
+  [[gnu::always_inline]] static inline usize
+  __class_size(usize c) noexcept
+  {
+    return usize{ 1 } << (c + __min_shift);
+  }
+
+  // maps 2 * Slab and trims it down to the one Slab aligned slab inside
+  static byte *
+  __map_slab(void)
+  {
+    byte *raw = unmanaged_allocate(2 * Slab);
+    byte *s = reinterpret_cast<byte *>(to_granularity<Slab>(reinterpret_cast<uintptr_t>(raw)));
+    if ( s != raw ) unmanaged_deallocate(raw, static_cast<usize>(s - raw));
+    if ( s + Slab != raw + 2 * Slab ) unmanaged_deallocate(s + Slab, static_cast<usize>((raw + 2 * Slab) - (s + Slab)));
+    return s;
+  }
+
+  // carves one slab into class c blocks, pushed in address order
+  static void
+  __refill(usize c)
+  {
+    byte *mem = __map_slab();
+    __slab *s = reinterpret_cast<__slab *>(mem);
+    s->prev = __slabs;
+    s->remote = nullptr;
+    s->owner = __self();
+    s->cls = c;
+    __slabs = s;
+    const usize sz = __class_size(c);
+    byte *first = mem + sizeof(__slab);
+    const usize cnt = (Slab - sizeof(__slab)) / sz;
+    for ( usize i = cnt; i > 0; --i ) {
+      __free_node *f = reinterpret_cast<__free_node *>(first + (i - 1) * sz);
+      f->next = __free[c];
+      __free[c] = f;
+    }
+  }
+
+  // takes back whatever other threads destroyed into this thread's class c slabs
+  static void
+  __reclaim(usize c)
+  {
+    for ( __slab *s = __slabs; s != nullptr; s = s->prev ) {
+      if ( s->cls != c or __atomic_load_n(&s->remote, __ATOMIC_RELAXED) == nullptr ) continue;
+      __free_node *f = __atomic_exchange_n(&s->remote, static_cast<__free_node *>(nullptr), __ATOMIC_ACQUIRE);
+      while ( f != nullptr ) {
+        __free_node *next = f->next;
+        f->next = __free[c];
+        __free[c] = f;
+        f = next;
+      }
+    }
+  }
+
+public:
+  ~pool_allocator() = default;
+  pool_allocator() = default;
+  pool_allocator(const pool_allocator &o) = default;
+  pool_allocator(pool_allocator &&o) = default;
+  pool_allocator &operator=(const pool_allocator &o) = default;
+  pool_allocator &operator=(pool_allocator &&o) = default;
+
+  inline __attribute__((always_inline)) static constexpr usize
+  auto_size()
+  {
+    return Max;
+  }
+
+  // memory handed out is zeroed, same as the abcmalloc backed allocators
+  static chunk<byte>
+  create(usize n)
+  {
+    if ( n > Max ) return allocate(n);
+    const usize c = __class_of(n);
+    if ( __free[c] == nullptr ) [[unlikely]] {
+      __reclaim(c);
+      if ( __free[c] == nullptr ) __refill(c);
+    }
+    __free_node *f = __free[c];
+    __free[c] = f->next;
+    const usize sz = __class_size(c);
+    micron::memset(reinterpret_cast<byte *>(f), 0x0, sz);
+    return { reinterpret_cast<byte *>(f), sz };
+  }
+
+  static chunk<byte>
+  grow(chunk<byte> memory, usize n)
+  {
+    if ( memory.len == 0 and memory.ptr == nullptr ) return create(n);
+    if ( n < (memory.len << 1) ) n = memory.len << 1;
+    chunk<byte> mem = create(n);
+    micron::memcpy(mem.ptr, memory.ptr, memory.len);
+    destroy(memory);
+    return mem;
+  }
+
+  static void
+  destroy(const chunk<byte> mem)
+  {
+    if ( mem.ptr == nullptr ) [[unlikely]]
+      return;
+    if ( mem.len > Max ) return deallocate(mem.ptr, mem.len);
+    __free_node *f = reinterpret_cast<__free_node *>(mem.ptr);
+    __slab *s = __slab_of(mem.ptr);
+    if ( s->owner == __self() ) [[likely]] {
+      const usize c = __class_of(mem.len);
+      f->next = __free[c];
+      __free[c] = f;
+      return;
+    }
+    __free_node *h = __atomic_load_n(&s->remote, __ATOMIC_RELAXED);
+    do {
+      f->next = h;
+    } while ( !__atomic_compare_exchange_n(&s->remote, &h, f, true, __ATOMIC_RELEASE, __ATOMIC_RELAXED) );
+  }
+
+  // unmaps every slab this thread carved and empties its free lists
+  static void
+  release(void)
+  {
+    while ( __slabs != nullptr ) {
+      __slab *prev = __slabs->prev;
+      unmanaged_deallocate(reinterpret_cast<byte *>(__slabs), Slab);
+      __slabs = prev;
+    }
+    for ( usize c = 0; c < __classes; ++c ) __free[c] = nullptr;
+  }
+
+  // bytes currently held in slabs, free or not
+  static usize
+  footprint(void)
+  {
+    usize n = 0;
+    for ( const __slab *s = __slabs; s != nullptr; s = s->prev ) n += Slab;
+    return n;
+  }
+
+  byte *share(void) = delete;
+
+  static i16
+  get_grow()
+  {
+    return 2;
+  }
+};
+
+};      // namespace micron
@@ -0,0 +1,229 @@
+//  Copyright (c) 2024- David Lucius Severus
+//
+//  Distributed under the Boost Software License, Version 1.0.
+//  See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt
+#pragma once
+
+#include "../core_resource.hpp"
+
+#include "../__allocators.hpp"
+
+#include "../../memory.hpp"
+
+namespace micron
+{
+// mutable memory object with a short buffer optimization, for scalar T only (strings)
+// the inline buffer overlays the whole heap triple {ptr, length, cap}, libc++ style: inline, the last byte holds the length,
+// so a 24 byte resource keeps 23 chars inline (22 plus the terminator hstring writes); short contents never touch Alloc
+//
+// NOTE: the last byte of the rep is never handed out, it's the length and the mode flag at once. inline it's the length, always
+// under 0x80; in heap mode it aliases the top byte of __heap.cap, whose top bit is set (little endian only, like the rest of
+// micron). since nothing points into the object itself, the resource is byte relocatable like __mutable_memory_resource,
+// containers are free to memcpy it around. the length is only reachable through __size() / __set_size()
+template<typename T, typename Alloc = allocator_serial<>>
+  requires(micron::is_scalar_v<T> and sizeof(T) <= sizeof(usize))
+struct __sso_memory_resource {
+  using value_type = T;
+  using size_type = usize;
+
+  struct __heap_t {
+    T *ptr;
+    usize length;
+    usize cap;      // | __heap_bit
+  };
+
+  // usable inline elements, the length byte excluded
+  static constexpr usize sso_size = (sizeof(__heap_t) - 1) / sizeof(T);
+  static constexpr usize __heap_bit = usize{ 1 } << (sizeof(usize) * 8 - 1);
+  static constexpr byte __heap_flag = byte{ 0x80 };
+
+  union {
+    __heap_t __heap;
+    T __sso[sso_size];
+  };
+
+  // byte access, legal whichever member is active
+  [[gnu::always_inline]] inline byte &
+  __tag(void) noexcept
+  {
+    return reinterpret_cast<byte *>(&__heap)[sizeof(__heap_t) - 1];
+  }
+
+  [[gnu::always_inline]] inline byte
+  __tag(void) const noexcept
+  {
+    return reinterpret_cast<const byte *>(&__heap)[sizeof(__heap_t) - 1];
+  }
+
+  [[gnu::always_inline]] inline bool
+  __is_heap(void) const noexcept
+  {
+    return (__tag() & __heap_flag) != 0;
+  }
+
+  [[gnu::always_inline]] inline T *
+  __ptr(void) noexcept
+  {
+    return __is_heap() ? __heap.ptr : __sso;
+  }
+
+  [[gnu::always_inline]] inline const T *
+  __ptr(void) const noexcept
+  {
+    return __is_heap() ? __heap.ptr : __sso;
+  }
+
+  [[gnu::always_inline]] inline usize
+  __cap(void) const noexcept
+  {
+    return __is_heap() ? __heap.cap & ~__heap_bit : sso_size;
+  }
+
+  [[gnu::always_inline]] inline usize
+  __size(void) const noexcept
+  {
+    return __is_heap() ? __heap.length : static_cast<usize>(__tag());
+  }
+
+  // inline, n must stay within sso_size; the owner only ever sets lengths under __cap()
+  [[gnu::always_inline]] inline void
+  __set_size(usize n) noexcept
+  {
+    if ( __is_heap() )
+      __heap.length = n;
+    else
+      __tag() = static_cast<byte>(n);
+  }
+
+  [[gnu::always_inline]] inline void
+  __to_inline(void) noexcept
+  {
+    micron::cbyteset<sizeof(__heap_t)>(reinterpret_cast<byte *>(&__heap), 0x0);
+  }
+
+  [[gnu::always_inline]] static inline void
+  __copy_rep(__heap_t *dst, const __heap_t *src) noexcept
+  {
+    micron::cmemcpy<sizeof(__heap_t)>(reinterpret_cast<byte *>(dst), reinterpret_cast<const byte *>(src));
+  }
+
+  inline void
+  __accept(const chunk<byte> &o, usize len)
+  {
+    __heap.ptr = reinterpret_cast<T *>(o.ptr);
+    __heap.length = len;
+    __heap.cap = (o.len / sizeof(T)) | __heap_bit;
+  }
+
+  ~__sso_memory_resource()
+  {
+    if ( __is_heap() ) Alloc::destroy(operator*());
+    __to_inline();
+  }
+
+  __sso_memory_resource(void) { __to_inline(); }
+
+  __sso_memory_resource(usize n_elements) : __sso_memory_resource()
+  {
+    if ( n_elements > sso_size ) __accept(Alloc::create(n_elements * sizeof(T)), 0);
+  }
+
+  // copies are deep and sized by the owner (see hstring), never through the resource
+  __sso_memory_resource(const __sso_memory_resource &) = delete;
+  __sso_memory_resource &operator=(const __sso_memory_resource &) = delete;
+
+  // stealing a heap block and copying an inline buffer are the same three word copy
+  __sso_memory_resource(__sso_memory_resource &&o) noexcept
+  {
+    __copy_rep(&__heap, &o.__heap);
+    o.__to_inline();
+  }
+
+  __sso_memory_resource &
+  operator=(__sso_memory_resource &&o) noexcept
+  {
+    if ( __is_heap() ) Alloc::destroy(operator*());
+    __copy_rep(&__heap, &o.__heap);
+    o.__to_inline();
+    return *this;
+  }
+
+  __sso_memory_resource &
+  swap(__sso_memory_resource &o) noexcept
+  {
+    __heap_t tmp;
+    __copy_rep(&tmp, &__heap);
+    __copy_rep(&__heap, &o.__heap);
+    __copy_rep(&o.__heap, &tmp);
+    return *this;
+  }
+
+  inline bool
+  is_zero() const
+  {
+    return __tag() == byte{ 0 };
+  }
+
+  inline bool
+  is_inline() const
+  {
+    return !__is_heap();
+  }
+
+  inline bool
+  has_space(const usize n_el) const
+  {
+    return (n_el + __size()) <= __cap();
+  }
+
+  inline chunk<byte>
+  operator*() const
+  {
+    return { reinterpret_cast<byte *>(const_cast<T *>(__ptr())), __cap() * sizeof(T) };
+  }
+
+  inline chunk<byte>
+  data() const
+  {
+    return operator*();
+  }
+
+  // drops the heap block, if any, and returns to an empty inline buffer
+  void
+  free(void)
+  {
+    if ( __is_heap() ) Alloc::destroy(operator*());
+    __to_inline();
+  }
+
+  // deletes and reallocs, number of elements; contents are not preserved
+  void
+  realloc(usize len)
+  {
+    if ( len == 0 ) [[unlikely]]
+      return;
+    free();
+    if ( len > sso_size ) __accept(Alloc::create(len * sizeof(T)), 0);
+  }
+
+  // expands memory, usize is number of elements; always leaves the inline buffer, contents and length are preserved
+  void
+  expand(usize len)
+  {
+    if ( len == 0 ) [[unlikely]]
+      return;
+    if ( __is_heap() ) {
+      // NOTE: grow destroys memory
+      __accept(Alloc::grow(operator*(), len * sizeof(T)), __heap.length);
+      return;
+    }
+    // copy out before __accept overwrites the buffer it overlays, length byte included
+    const usize n = __size();
+    chunk<byte> mem = Alloc::create((len > sso_size ? len : sso_size + 1) * sizeof(T));
+    micron::cmemcpy<sso_size * sizeof(T)>(mem.ptr, reinterpret_cast<const byte *>(__sso));
+    __accept(mem, n);
+  }
+};
+
+};      // namespace micron
@@ -7,3 +7,4 @@
 
 #include "resource_types/immutable_resource.hpp"
 #include "resource_types/mutable_resource.hpp"
+#include "resource_types/sso_resource.hpp"
@@ -0,0 +1,186 @@
+//  Copyright (c) 2024- David Lucius Severus
+//
+//  Distributed under the Boost Software License, Version 1.0.
+//  See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt
+#pragma once
+
+#include "../atomic/atomic.hpp"
+#include "../bits/__pause.hpp"
+#include "../memory/new.hpp"
+#include "../types.hpp"
+
+#include "locks/guard_lock.hpp"
+#include "locks/spin_lock.hpp"
+
+namespace micron
+{
+
+namespace __impl
+{
+// one byte per thread, its address is the thread's identity when picking an epoch slot
+inline thread_local u8 __epoch_anchor = 0;
+};      // namespace __impl
+
+// epoch_domain
+//
+// epoch based reclamation for structures with optimistic readers
+// a thread pins the domain for the duration of one operation; memory unlinked while it's pinned is retired, and freed only once every
+// pinned thread has been seen at the current epoch twice over (retired at e, freed when the global epoch reaches e + 2)
+//
+// pinning claims a slot by hashing the thread's TLS address, there is no registration and nothing to clean up on thread exit
+// Slots bounds the number of simultaneously pinned threads, a pin spins while every slot is taken. nested pins take a second slot
+// NOTE: retire() must only be called after the memory is unreachable from the structure's roots
+template<usize Slots = 128>
+  requires(Slots >= 1 and (Slots & (Slots - 1)) == 0)
+class epoch_domain
+{
+  static constexpr usize __mask = Slots - 1u;
+  static constexpr usize __advance_every = 64;      // retires between reclamation attempts
+
+  struct alignas(64) __slot {
+    u64 state;      // 0 idle, else (epoch << 1) | 1
+  };
+
+  struct __limbo {
+    __limbo *next;
+    void *ptr;
+    void (*fn)(void *);
+    u64 epoch;
+  };
+
+  alignas(64) u64 __global = 0;
+  __slot __slots[Slots] = {};
+  spin_lock __lock;
+  __limbo *__head = nullptr;      // newest first, so epochs are non-increasing along the list
+  usize __pending = 0;
+
+  static usize
+  __home() noexcept
+  {
+    u64 x = reinterpret_cast<uintptr_t>(&__impl::__epoch_anchor);
+    x ^= x >> 33;
+    x *= 0xff51afd7ed558ccdULL;
+    x ^= x >> 33;
+    return static_cast<usize>(x) & __mask;
+  }
+
+  // every pinned slot has caught up with the global epoch, bump it
+  bool
+  __try_advance() noexcept
+  {
+    u64 e = atom::load(&__global, __ATOMIC_SEQ_CST);
+    for ( usize i = 0; i < Slots; ++i ) {
+      const u64 s = atom::load(&__slots[i].state, __ATOMIC_SEQ_CST);
+      if ( (s & 1) and (s >> 1) != e ) return false;
+    }
+    return atom::compare_exchange(&__global, &e, e + 1, false, __ATOMIC_SEQ_CST, __ATOMIC_RELAXED);
+  }
+
+  // detaches everything retired at or before safe, caller frees outside the lock
+  __limbo *
+  __cut(u64 safe) noexcept
+  {
+    __limbo **link = &__head;
+    while ( *link != nullptr and (*link)->epoch > safe ) link = &(*link)->next;
+    __limbo *dead = *link;
+    *link = nullptr;
+    return dead;
+  }
+
+  static void
+  __free(__limbo *n)
+  {
+    while ( n != nullptr ) {
+      __limbo *next = n->next;
+      n->fn(n->ptr);
+      delete n;
+      n = next;
+    }
+  }
+
+public:
+  class guard
+  {
+    epoch_domain *__d;
+    usize __s;
+
+  public:
+    explicit guard(epoch_domain &d) noexcept : __d(&d), __s(d.pin()) { }
+
+    ~guard() { __d->unpin(__s); }
+
+    guard(const guard &) = delete;
+    guard &operator=(const guard &) = delete;
+  };
+
+  ~epoch_domain() { __free(__head); }
+
+  epoch_domain() = default;
+  epoch_domain(const epoch_domain &) = delete;
+  epoch_domain &operator=(const epoch_domain &) = delete;
+
+  // returns the slot to hand back to unpin()
+  usize
+  pin() noexcept
+  {
+    const usize h = __home();
+    for ( ;; ) {
+      for ( usize i = 0; i < Slots; ++i ) {
+        const usize s = (h + i) & __mask;
+        u64 idle = 0;
+        // a stale epoch here is harmless: it only holds the global epoch back until unpin
+        const u64 e = atom::load(&__global, __ATOMIC_ACQUIRE);
+        if ( atom::compare_exchange(&__slots[s].state, &idle, (e << 1) | 1u, false, __ATOMIC_SEQ_CST, __ATOMIC_RELAXED) ) return s;
+      }
+      __cpu_pause();
+    }
+  }
+
+  void
+  unpin(usize s) noexcept
+  {
+    atom::store(&__slots[s].state, u64{ 0 }, __ATOMIC_RELEASE);
+  }
+
+  void
+  retire(void *p, void (*fn)(void *))
+  {
+    __limbo *n = new __limbo{ nullptr, p, fn, 0 };
+    __limbo *dead = nullptr;
+    {
+      lock_guard<spin_lock> __g(__lock);
+      n->epoch = atom::load(&__global, __ATOMIC_SEQ_CST);
+      n->next = __head;
+      __head = n;
+      if ( ++__pending % __advance_every == 0 ) {
+        __try_advance();
+        const u64 g = atom::load(&__global, __ATOMIC_SEQ_CST);
+        if ( g >= 2 ) dead = __cut(g - 2);
+      }
+    }
+    __free(dead);
+  }
+
+  // advance if possible and free whatever is already safe; retire() does this on its own every __advance_every calls
+  void
+  collect()
+  {
+    __limbo *dead = nullptr;
+    {
+      lock_guard<spin_lock> __g(__lock);
+      __try_advance();
+      const u64 g = atom::load(&__global, __ATOMIC_SEQ_CST);
+      if ( g >= 2 ) dead = __cut(g - 2);
+    }
+    __free(dead);
+  }
+
+  u64
+  epoch() const noexcept
+  {
+    return atom::load(&__global, __ATOMIC_ACQUIRE);
+  }
+};
+
+};      // namespace micron
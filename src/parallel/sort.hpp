@@ -205,5 +205,17 @@ radix(It __first, It __last, KeyFn __key)
 }
 
 };      // namespace sort
+
+// sort phase policy for the trees' bulk loaders (b_tree / btree_map / rtree): sort(first, last, cmp) runs sort::sort on the engine and
+// waits for it. call it from outside the engine, never from a task
+struct bulk_sort {
+  template<class T, class Cmp>
+  void
+  operator()(T *__first, T *__last, Cmp __comp) const
+  {
+    micron::coro::sync_wait(sort::sort(__first, __last, __comp));
+  }
+};
+
 };      // namespace parallel
 };      // namespace micron
@@ -0,0 +1,506 @@
+//  Copyright (c) 2024- David Lucius Severus
+//
+//  Distributed under the Boost Software License, Version 1.0.
+//  See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt
+#pragma once
+
+#include "../type_traits.hpp"
+
+#include "../allocator.hpp"
+#include "../atomic/atomic.hpp"
+#include "../atomic/intrin.hpp"
+#include "../bits/__backoff.hpp"
+#include "../bits/__container.hpp"
+#include "../bits/__pause.hpp"
+#include "../concepts.hpp"
+#include "../except.hpp"
+#include "../memory/allocation/resources.hpp"
+#include "../new.hpp"
+#include "../types.hpp"
+
+#include "../memory/cache.hpp"
+#include "../sync/futex.hpp"
+
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+// mp_disruptor
+//
+// multi-producer LMAX ring with staged consumers
+// producers claim sequence runs with one fetch_add and mark them published in an availability bitmap, consumers are stages that each
+// own a cursor and read behind a barrier: the producers for a root stage, the min of its upstream stages' cursors otherwise. stages
+// mutate slots in place, so decode -> enrich -> persist hands the same entry down the graph with no queue between steps. producers are
+// gated by the slowest terminal stage (one nobody depends on), a ring with no stages at all is not gated
+
+namespace micron
+{
+
+// wait strategies
+// wait(ready) returns once ready() holds, signal() follows every cursor move (publish, stage release, halt)
+
+struct spin_wait_strategy {
+  template<class Ready>
+  void
+  wait(Ready &&ready) noexcept
+  {
+    while ( !ready() ) __cpu_pause();
+  }
+
+  void
+  signal() noexcept
+  {
+  }
+};
+
+// pause bursts, then sched_yield
+struct backoff_wait_strategy {
+  template<class Ready>
+  void
+  wait(Ready &&ready) noexcept
+  {
+    default_backoff b;
+    while ( !ready() ) b.relax();
+  }
+
+  void
+  signal() noexcept
+  {
+  }
+};
+
+// spins briefly, then parks on a futex; signal() costs a fence and a load unless somebody is parked
+class futex_wait_strategy
+{
+  micron::atomic_token<u32> __epoch{ 0 };
+  micron::atomic_token<u32> __parked{ 0 };
+
+public:
+  futex_wait_strategy() noexcept = default;
+  futex_wait_strategy(const futex_wait_strategy &) = delete;
+  futex_wait_strategy &operator=(const futex_wait_strategy &) = delete;
+
+  template<class Ready>
+  void
+  wait(Ready &&ready)
+  {
+    park_backoff b;
+    while ( !ready() ) {
+      if ( b.next() != spin_step::park ) continue;
+      const u32 key = __epoch.get(memory_order_acquire);
+      __parked.fetch_add(1, memory_order_seq_cst);
+      // pairs with the fence in signal(): either it sees us parked or we see its cursor
+      atom::thread_fence(__ATOMIC_SEQ_CST);
+      if ( !ready() ) micron::wait_futex(__epoch.ptr(), key);
+      __parked.fetch_sub(1, memory_order_relaxed);
+    }
+  }
+
+  void
+  signal() noexcept
+  {
+    atom::thread_fence(__ATOMIC_SEQ_CST);
+    if ( __parked.get(memory_order_relaxed) == 0 ) return;
+    __epoch.fetch_add(1, memory_order_release);
+    micron::wake_futex(__epoch.ptr(), 0x7fffffff);
+  }
+};
+
+template<is_movable_object T, usize N, class Wait = backoff_wait_strategy, class Alloc = micron::allocator_serial<>>
+  requires(micron::is_default_constructible_v<T>)
+class mp_disruptor: public __mutable_memory_resource_move_only<T, Alloc>
+{
+  constexpr static usize
+  __next_pow2(usize n)
+  {
+    n--;
+    n |= n >> 1;
+    n |= n >> 2;
+    n |= n >> 4;
+    n |= n >> 8;
+    n |= n >> 16;
+    if constexpr ( sizeof(usize) * 8 > 32 ) n |= n >> 32;
+    return n + 1;
+  }
+
+  using __mem = __mutable_memory_resource_move_only<T, Alloc>;
+
+  static constexpr u64 __cache_line = cache_line_size();
+  // at least one bitmap word, so a word never spans two laps
+  static constexpr usize __capacity = __next_pow2(N) < 64 ? 64 : __next_pow2(N);
+  static constexpr usize __mask = __capacity - 1u;
+  static constexpr usize __shift = static_cast<usize>(__builtin_ctzll(__capacity));
+  static constexpr usize __words = __capacity / 64;
+  static constexpr u32 __max_stages = 32;
+
+  struct alignas(__cache_line) __stage_rec {
+    micron::atomic_token<usize> done;      // every sequence below this is released
+    u32 deps;                              // upstream stages, bit per id; 0 reads straight behind the producers
+  };
+
+  alignas(__cache_line) micron::atomic_token<usize> __claim;      // next sequence a producer gets
+  alignas(__cache_line) micron::atomic_token<usize> __gate;       // cached min over terminal stages, only ever stale low
+  alignas(__cache_line) u64 *__avail;                             // bit per slot, flipped once per lap when that slot is published
+  __stage_rec __stages[__max_stages];
+  u32 __n_stages;
+  u32 __terminal;
+  micron::atomic_token<u32> __halted;
+  Wait __wait;
+
+  // slot s of lap L is published when its bit differs from what lap L - 1 left, i.e. equals !(L & 1)
+  [[gnu::always_inline]] static inline u64
+  __want(usize seq) noexcept
+  {
+    return ((seq >> __shift) & 1u) ? u64{ 0 } : ~u64{ 0 };
+  }
+
+  // first sequence at or after from that is not yet published
+  usize
+  __published_end(usize from) const noexcept
+  {
+    const usize hi = __claim.get(memory_order_acquire);
+    usize s = from;
+    while ( s < hi ) {
+      const usize b = s & 63u;
+      const u64 word = atom::load(&__avail[(s & __mask) >> 6], __ATOMIC_ACQUIRE);
+      const u64 miss = (word ^ __want(s)) >> b;
+      if ( miss != 0 ) {
+        s += static_cast<usize>(__builtin_ctzll(miss));
+        break;
+      }
+      s += 64u - b;
+    }
+    return s < hi ? s : hi;
+  }
+
+  usize
+  __upstream(u32 id, usize from) const noexcept
+  {
+    const u32 deps = __stages[id].deps;
+    if ( deps == 0 ) return __published_end(from);
+    usize m = ~usize{ 0 };
+    for ( u32 d = deps; d != 0; d &= d - 1 ) {
+      const usize c = __stages[__builtin_ctz(d)].done.get(memory_order_acquire);
+      if ( c < m ) m = c;
+    }
+    return m;
+  }
+
+  usize
+  __refresh_gate() noexcept
+  {
+    usize m = ~usize{ 0 };
+    for ( u32 t = __terminal; t != 0; t &= t - 1 ) {
+      const usize c = __stages[__builtin_ctz(t)].done.get(memory_order_acquire);
+      if ( c < m ) m = c;
+    }
+    __gate.store(m, memory_order_release);      // pairs with the acquire loads in __await_space and try_claim
+    return m;
+  }
+
+  // [first, first + n) may be written once every terminal stage is past first + n - capacity
+  void
+  __await_space(usize first, usize n)
+  {
+    if ( first + n <= __capacity ) return;
+    const usize need = first + n - __capacity;
+    if ( __gate.get(memory_order_acquire) >= need ) return;
+    __wait.wait([this, need]() { return __refresh_gate() >= need; });
+  }
+
+public:
+  using category_type = buffer_tag;
+  using mutability_type = mutable_tag;
+  using memory_type = heap_tag;
+  typedef T value_type;
+  typedef T &reference;
+  typedef const T &const_reference;
+  typedef T *pointer;
+  typedef const T *const_pointer;
+
+  // consumer handle, cheap to copy; one thread (or coroutine) drives a given stage at a time
+  class stage
+  {
+    friend class mp_disruptor;
+
+    mp_disruptor *__d;
+    u32 __id;
+
+    stage(mp_disruptor *d, u32 id) noexcept : __d(d), __id(id) { }
+
+  public:
+    stage() noexcept : __d(nullptr), __id(0) { }
+
+    inline u32
+    id() const noexcept
+    {
+      return __id;
+    }
+
+    // first sequence this stage has not released
+    inline usize
+    cursor() const noexcept
+    {
+      return __d->__stages[__id].done.get(memory_order_relaxed);
+    }
+
+    // end of the run behind this stage's barrier, [cursor(), available()) may be read and written
+    inline usize
+    available() const noexcept
+    {
+      return __d->__upstream(__id, cursor());
+    }
+
+    // blocks on the wait strategy until something is available or the ring is halted, returns available()
+    usize
+    wait()
+    {
+      const usize c = cursor();
+      usize hi = available();
+      if ( hi > c ) return hi;
+      __d->__wait.wait([this, c, &hi]() {
+        hi = available();
+        return hi > c or __d->halted();
+      });
+      return hi;
+    }
+
+    // coroutine form of wait(), only with a strategy that can suspend (await_wait_strategy)
+    // NOTE: a resume can come from any cursor move, loop on available() == cursor()
+    auto
+    async_wait() const
+      requires requires(Wait &w) { w.until([]() { return true; }); }
+    {
+      const usize c = cursor();
+      return __d->__wait.until([s = *this, c]() { return s.available() > c or s.__d->halted(); });
+    }
+
+    inline T &
+    operator[](usize seq) const noexcept
+    {
+      return __d->__mem::memory[seq & __mask];
+    }
+
+    // hands [cursor(), end) to the downstream stages (and back to the producers, if terminal)
+    inline void
+    release(usize end) noexcept
+    {
+      __d->__stages[__id].done.store(end, memory_order_release);
+      __d->__wait.signal();
+    }
+
+    // runs fn(T &, seq, end_of_batch) over whatever is available now, up to max entries, then releases them; returns the count
+    template<typename Fn>
+    usize
+    try_process(Fn &&fn, usize max = __capacity)
+    {
+      const usize c = cursor();
+      usize hi = available();
+      if ( hi == c ) return 0;
+      if ( hi - c > max ) hi = c + max;
+      for ( usize s = c; s != hi; ++s ) fn((*this)[s], s, s + 1u == hi);
+      release(hi);
+      return hi - c;
+    }
+
+    // as try_process, blocking until there is a batch; returns 0 only once halted
+    template<typename Fn>
+    usize
+    process(Fn &&fn, usize max = __capacity)
+    {
+      const usize c = cursor();
+      usize hi = wait();
+      if ( hi == c ) return 0;
+      if ( hi - c > max ) hi = c + max;
+      for ( usize s = c; s != hi; ++s ) fn((*this)[s], s, s + 1u == hi);
+      release(hi);
+      return hi - c;
+    }
+  };
+
+  ~mp_disruptor()
+  {
+    if constexpr ( micron::is_class_v<T> ) {
+      for ( usize i = 0; i < __capacity; ++i ) (__mem::memory)[i].~T();
+    }
+    delete[] __avail;
+  }
+
+  mp_disruptor()
+      : __mem(__capacity), __claim(0), __gate(0), __avail(new u64[__words]), __stages{}, __n_stages(0), __terminal(0), __halted(0), __wait()
+  {
+    for ( usize i = 0; i < __words; ++i ) __avail[i] = 0;
+    for ( usize i = 0; i < __capacity; ++i ) new (micron::addr(__mem::memory[i])) T{};
+  }
+
+  mp_disruptor(const mp_disruptor &) = delete;
+  mp_disruptor(mp_disruptor &&) = delete;
+  mp_disruptor &operator=(const mp_disruptor &) = delete;
+  mp_disruptor &operator=(mp_disruptor &&) = delete;
+
+  // adds a stage reading behind every stage in deps (behind the producers if none); ids are handed out in order, so the graph is a
+  // DAG by construction
+  // NOTE: build the whole graph before any producer or stage runs
+  template<typename... S>
+    requires(micron::is_same_v<S, stage> and ...)
+  stage
+  add_stage(S... deps)
+  {
+    if ( __n_stages == __max_stages ) exc<except::library_error>("micron::mp_disruptor add_stage(): too many stages");
+    const u32 id = __n_stages++;
+    u32 mask = 0;
+    bool foreign = false;
+    ((deps.__d == this ? (void)(mask |= 1u << deps.__id) : (void)(foreign = true)), ...);
+    if ( foreign ) {
+      --__n_stages;
+      exc<except::library_error>("micron::mp_disruptor add_stage(): dependency from another ring");
+    }
+    __stages[id].done.store(0, memory_order_relaxed);
+    __stages[id].deps = mask;
+    __terminal = (__terminal & ~mask) | (1u << id);
+    return stage(this, id);
+  }
+
+  inline usize
+  stages() const noexcept
+  {
+    return __n_stages;
+  }
+
+  inline usize
+  capacity() const noexcept
+  {
+    return __capacity;
+  }
+
+  inline usize
+  max_size() const noexcept
+  {
+    return __capacity;
+  }
+
+  // sequences handed out so far
+  inline usize
+  cursor() const noexcept
+  {
+    return __claim.get(memory_order_acquire);
+  }
+
+  // WARNING: temporal approximation, claimed but not yet through every terminal stage
+  inline usize
+  size() noexcept
+  {
+    const usize g = __refresh_gate();
+    const usize c = __claim.get(memory_order_acquire);
+    return g == ~usize{ 0 } ? 0 : c - g;
+  }
+
+  // claims [first, first + n), blocking on the wait strategy while the ring is full; returns first
+  usize
+  claim(usize n = 1)
+  {
+    if ( n == 0 or n > __capacity ) exc<except::library_error>("micron::mp_disruptor claim(): batch larger than the ring");
+    const usize first = __claim.fetch_add(n, memory_order_acq_rel);
+    __await_space(first, n);
+    return first;
+  }
+
+  // non-blocking claim, false when the ring has no room for n
+  bool
+  try_claim(usize n, usize &first) noexcept
+  {
+    if ( n == 0 or n > __capacity ) return false;
+    usize c = __claim.get(memory_order_relaxed);
+    for ( ;; ) {
+      if ( c + n > __capacity ) {
+        const usize need = c + n - __capacity;
+        if ( __gate.get(memory_order_acquire) < need and __refresh_gate() < need ) return false;
+      }
+      if ( __claim.compare_exchange_weak(c, c + n, memory_order_acq_rel, memory_order_relaxed) ) {
+        first = c;
+        return true;
+      }
+    }
+  }
+
+  inline T &
+  operator[](usize seq) noexcept
+  {
+    return __mem::memory[seq & __mask];
+  }
+
+  inline const T &
+  operator[](usize seq) const noexcept
+  {
+    return __mem::memory[seq & __mask];
+  }
+
+  // marks [first, first + n) readable; runs published out of order become visible once the gap before them closes
+  void
+  publish(usize first, usize n = 1) noexcept
+  {
+    usize s = first;
+    const usize end = first + n;
+    while ( s != end ) {
+      const usize b = s & 63u;
+      const usize run = (64u - b) < (end - s) ? (64u - b) : (end - s);
+      const u64 bits = (run == 64u ? ~u64{ 0 } : ((u64{ 1 } << run) - 1u)) << b;
+      atom::fetch_xor(&__avail[(s & __mask) >> 6], bits, __ATOMIC_RELEASE);
+      s += run;
+    }
+    __wait.signal();
+  }
+
+  // claim, construct and publish one entry
+  usize
+  push(const T &val)
+  {
+    const usize s = claim(1);
+    __mem::memory[s & __mask] = val;
+    publish(s, 1);
+    return s;
+  }
+
+  usize
+  push(T &&val)
+  {
+    const usize s = claim(1);
+    __mem::memory[s & __mask] = micron::move(val);
+    publish(s, 1);
+    return s;
+  }
+
+  bool
+  try_push(const T &val) noexcept
+  {
+    usize s;
+    if ( !try_claim(1, s) ) return false;
+    __mem::memory[s & __mask] = val;
+    publish(s, 1);
+    return true;
+  }
+
+  // claims count slots and publishes them as one run
+  usize
+  push_batch(const T *items, usize count)
+  {
+    const usize s = claim(count);
+    for ( usize i = 0; i < count; ++i ) __mem::memory[(s + i) & __mask] = items[i];
+    publish(s, count);
+    return s;
+  }
+
+  // wakes every blocked stage; wait() and process() return what is already available, then 0
+  void
+  halt() noexcept
+  {
+    __halted.store(1, memory_order_release);
+    __wait.signal();
+  }
+
+  inline bool
+  halted() const noexcept
+  {
+    return __halted.get(memory_order_acquire) != 0;
+  }
+};
+
+};      // namespace micron
@@ -0,0 +1,100 @@
+//  Copyright (c) 2024- David Lucius Severus
+//
+//  Distributed under the Boost Software License, Version 1.0.
+//  See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt
+#pragma once
+
+#include "../bits/__abc_mt.hpp"      // autofires MICRON_ABC_MT; must precede abcmalloc
+
+#include "../__special/coroutine"
+
+#include "../atomic/atomic.hpp"
+#include "../atomic/intrin.hpp"
+#include "../bits/__backoff.hpp"
+#include "../type_traits.hpp"
+#include "../types.hpp"
+
+#include "../tasks/waiter_list.hpp"
+
+#include "mp_disruptor.hpp"
+
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+// coroutine wait strategy for mp_disruptor
+//
+// stages driven from coroutines co_await stage.async_wait() and get resumed (on the engine, if one is running) by the next cursor move;
+// plain wait() callers, producers included, back off like backoff_wait_strategy. kept apart from mp_disruptor.hpp since it pulls in the
+// coroutine runtime
+
+namespace micron
+{
+
+class await_wait_strategy
+{
+  coro::waiter_list __waiters;
+  micron::atomic_token<u32> __parked{ 0 };
+
+public:
+  await_wait_strategy() noexcept = default;
+  await_wait_strategy(const await_wait_strategy &) = delete;
+  await_wait_strategy &operator=(const await_wait_strategy &) = delete;
+
+  template<class Ready>
+  void
+  wait(Ready &&ready) noexcept
+  {
+    default_backoff b;
+    while ( !ready() ) b.relax();
+  }
+
+  template<class Ready> struct [[nodiscard]] __until_awaiter {
+    await_wait_strategy *__w;
+    Ready __ready;
+    coro::waiter_node __node{};
+
+    bool
+    await_ready() const noexcept
+    {
+      return __ready();
+    }
+
+    template<class P>
+    bool
+    await_suspend(std::coroutine_handle<P> __h) noexcept
+    {
+      __node.__frame = &__h.promise();
+      __w->__parked.fetch_add(1, memory_order_seq_cst);
+      // pairs with the fence in signal(): either it sees us parked or push_unless sees its cursor
+      atom::thread_fence(__ATOMIC_SEQ_CST);
+      if ( __w->__waiters.push_unless(&__node, __ready) ) return true;
+      __w->__parked.fetch_sub(1, memory_order_relaxed);
+      return false;
+    }
+
+    void
+    await_resume() const noexcept
+    {
+    }
+  };
+
+  template<class Ready>
+  __until_awaiter<micron::decay_t<Ready>>
+  until(Ready &&ready) noexcept
+  {
+    return __until_awaiter<micron::decay_t<Ready>>{ this, micron::forward<Ready>(ready) };
+  }
+
+  void
+  signal() noexcept
+  {
+    atom::thread_fence(__ATOMIC_SEQ_CST);
+    if ( __parked.get(memory_order_relaxed) == 0 ) return;
+    coro::waiter_node *__h = __waiters.swap_all();
+    u32 __n = 0;
+    for ( coro::waiter_node *__p = __h; __p != nullptr; __p = __p->__next ) ++__n;
+    if ( __n != 0 ) __parked.fetch_sub(__n, memory_order_acq_rel);
+    coro::__wake_all(__h);
+  }
+};
+
+};      // namespace micron
@@ -0,0 +1,425 @@
+//  Copyright (c) 2024- David Lucius Severus
+//
+//  Distributed under the Boost Software License, Version 1.0.
+//  See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt
+#pragma once
+
+#include "../type_traits.hpp"
+
+#include "../atomic/atomic.hpp"
+#include "../atomic/intrin.hpp"
+#include "../bits/__backoff.hpp"
+#include "../bits/__pause.hpp"
+#include "../concepts.hpp"
+#include "../memory/actions.hpp"
+#include "../new.hpp"
+#include "../types.hpp"
+
+#include "../memory/cache.hpp"
+#include "../mutex/epoch.hpp"
+#include "../mutex/locks/guard_lock.hpp"
+#include "../mutex/locks/spin_lock.hpp"
+#include "../sync/event_count.hpp"
+
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+// seg_mpmc
+//
+// unbounded multi-producer multi-consumer queue, a linked list of fixed segments (FAA array queue)
+// producers and consumers each fetch_add an index into the current segment and meet in that one slot; a consumer that gets there first
+// poisons it and the producer retries at a later index, so neither side ever waits on the other. a producer that runs off the end of a
+// segment links a new one with its item already in slot 0. drained segments are retired through an epoch_domain and recycled
+// pop_wait parks on an event_count; producers pay one fence and one load for it, nothing more unless a consumer is actually parked
+
+namespace micron
+{
+
+template<is_movable_object T, usize S = 1024>
+  requires(S >= 2)
+class seg_mpmc
+{
+  static constexpr u64 __cache_line = cache_line_size();
+  static constexpr usize __keep = 4;             // drained segments held for reuse
+  static constexpr u32 __spin_slot = 64;         // pauses a consumer grants a producer mid-write before poisoning its slot
+
+  enum : u32 { __empty = 0, __full = 1, __poison = 2 };
+
+  struct __slot {
+    u32 state;
+    alignas(T) byte raw[sizeof(T)];
+
+    T *
+    get() noexcept
+    {
+      return reinterpret_cast<T *>(raw);
+    }
+  };
+
+  struct __seg {
+    alignas(__cache_line) usize enq;
+    alignas(__cache_line) usize deq;
+    alignas(__cache_line) __seg *next;
+    seg_mpmc *owner;
+    __slot slots[S];
+  };
+
+  alignas(__cache_line) __seg *__head;      // consumers
+  alignas(__cache_line) __seg *__tail;      // producers
+  alignas(__cache_line) u32 __closed;
+  event_count __ec;
+  spin_lock __pool_lock;
+  __seg *__pool;      // drained segments, linked through next
+  usize __pooled;
+  mutable epoch_domain<> __epoch;
+
+  __seg *
+  __fresh(seg_mpmc *owner)
+  {
+    __seg *s = nullptr;
+    {
+      lock_guard<spin_lock> __g(__pool_lock);
+      if ( __pool != nullptr ) {
+        s = __pool;
+        __pool = s->next;
+        --__pooled;
+      }
+    }
+    if ( s == nullptr ) s = new __seg;
+    s->enq = 0;
+    s->deq = 0;
+    s->next = nullptr;
+    s->owner = owner;
+    for ( usize i = 0; i < S; ++i ) s->slots[i].state = __empty;
+    return s;
+  }
+
+  void
+  __recycle(__seg *s)
+  {
+    {
+      lock_guard<spin_lock> __g(__pool_lock);
+      if ( __pooled < __keep ) {
+        s->next = __pool;
+        __pool = s;
+        ++__pooled;
+        return;
+      }
+    }
+    delete s;
+  }
+
+  static void
+  __recycle_retired(void *p)
+  {
+    __seg *s = static_cast<__seg *>(p);
+    s->owner->__recycle(s);
+  }
+
+  // producers that outran the tail help it forward
+  void
+  __advance(__seg *&at, __seg *from, __seg *to) noexcept
+  {
+    atom::compare_exchange(&at, &from, to, false, __ATOMIC_ACQ_REL, __ATOMIC_RELAXED);
+  }
+
+  // WARNING: caller is pinned
+  template<typename... Args>
+  void
+  __enqueue(Args &&...args)
+  {
+    for ( ;; ) {
+      __seg *t = atom::load(&__tail, __ATOMIC_ACQUIRE);
+      const usize i = atom::fetch_add(&t->enq, usize{ 1 }, __ATOMIC_ACQ_REL);
+      if ( i < S ) {
+        __slot &sl = t->slots[i];
+        new (sl.get()) T{ micron::forward<Args>(args)... };
+        u32 e = __empty;
+        if ( atom::compare_exchange(&sl.state, &e, u32{ __full }, false, __ATOMIC_RELEASE, __ATOMIC_RELAXED) ) return;
+        // a consumer gave up on this slot, the value never left our hands
+        sl.get()->~T();
+        continue;
+      }
+      __seg *nx = atom::load(&t->next, __ATOMIC_ACQUIRE);
+      if ( nx != nullptr ) {
+        __advance(__tail, t, nx);
+        continue;
+      }
+      __seg *n = __fresh(this);
+      new (n->slots[0].get()) T{ micron::forward<Args>(args)... };
+      n->slots[0].state = __full;
+      n->enq = 1;
+      __seg *none = nullptr;
+      if ( atom::compare_exchange(&t->next, &none, n, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE) ) {
+        __advance(__tail, t, n);
+        return;
+      }
+      // lost the link race, n was never visible
+      n->slots[0].get()->~T();
+      __recycle(n);
+      __advance(__tail, t, none);
+    }
+  }
+
+  // moves out of slot i of s, or poisons it if its producer is still writing; true when a value was taken
+  bool
+  __take(__seg *s, usize i, T &out)
+  {
+    __slot &sl = s->slots[i];
+    u32 st = atom::load(&sl.state, __ATOMIC_ACQUIRE);
+    for ( u32 k = 0; st == __empty and k < __spin_slot; ++k ) {
+      __cpu_pause();
+      st = atom::load(&sl.state, __ATOMIC_ACQUIRE);
+    }
+    if ( st == __empty ) {
+      if ( atom::compare_exchange(&sl.state, &st, u32{ __poison }, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE) ) return false;
+    }
+    // push_n poisons the unfilled rest of a broken claim itself, those slots never held a value
+    if ( st == __poison ) return false;
+    out = micron::move(*sl.get());
+    sl.get()->~T();
+    return true;
+  }
+
+  // head is drained: step to the next segment and retire the old one once the tail is past it too
+  bool
+  __step(__seg *h)
+  {
+    __seg *nx = atom::load(&h->next, __ATOMIC_ACQUIRE);
+    if ( nx == nullptr ) return false;
+    if ( atom::compare_exchange(&__head, &h, nx, false, __ATOMIC_ACQ_REL, __ATOMIC_RELAXED) ) {
+      __advance(__tail, h, nx);
+      __epoch.retire(h, &__recycle_retired);
+    }
+    return true;
+  }
+
+  // WARNING: caller is pinned
+  bool
+  __dequeue(T &out)
+  {
+    for ( ;; ) {
+      __seg *h = atom::load(&__head, __ATOMIC_ACQUIRE);
+      const usize d = atom::load(&h->deq, __ATOMIC_ACQUIRE);
+      if ( d >= S ) {
+        if ( !__step(h) ) return false;
+        continue;
+      }
+      // enq below S means no producer has gone past this segment yet, so there is nothing further on either
+      if ( d >= atom::load(&h->enq, __ATOMIC_ACQUIRE) ) return false;
+      const usize i = atom::fetch_add(&h->deq, usize{ 1 }, __ATOMIC_ACQ_REL);
+      if ( i >= S ) continue;
+      if ( __take(h, i, out) ) return true;
+    }
+  }
+
+  void
+  __notify(bool all) noexcept
+  {
+    // pairs with the fence in pop_wait(): either we see the waiter or it sees our slot
+    atom::thread_fence(__ATOMIC_SEQ_CST);
+    if ( !__ec.has_waiters() ) return;
+    if ( all )
+      __ec.notify_all();
+    else
+      __ec.notify_one();
+  }
+
+public:
+  typedef T value_type;
+  typedef T &reference;
+  typedef const T &const_reference;
+
+  seg_mpmc() : __head(nullptr), __tail(nullptr), __closed(0), __ec(), __pool_lock(), __pool(nullptr), __pooled(0), __epoch()
+  {
+    __head = __tail = __fresh(this);
+  }
+
+  // WARNING: no concurrent producers or consumers may be running
+  ~seg_mpmc()
+  {
+    __seg *s = __head;
+    while ( s != nullptr ) {
+      const usize lo = s->deq < S ? s->deq : S;
+      for ( usize i = lo; i < S; ++i )
+        if ( s->slots[i].state == __full ) s->slots[i].get()->~T();
+      __seg *nx = s->next;
+      delete s;
+      s = nx;
+    }
+    // nothing is pinned: two advances free everything retired so far
+    __epoch.collect();
+    __epoch.collect();
+    while ( __pool != nullptr ) {
+      __seg *nx = __pool->next;
+      delete __pool;
+      __pool = nx;
+    }
+  }
+
+  seg_mpmc(const seg_mpmc &) = delete;
+  seg_mpmc(seg_mpmc &&) = delete;
+  seg_mpmc &operator=(const seg_mpmc &) = delete;
+  seg_mpmc &operator=(seg_mpmc &&) = delete;
+
+  static constexpr usize
+  segment_size() noexcept
+  {
+    return S;
+  }
+
+  // WARNING: temporal approximation only
+  bool
+  empty() const noexcept
+  {
+    epoch_domain<>::guard __g(__epoch);
+    __seg *h = atom::load(&__head, __ATOMIC_ACQUIRE);
+    const usize d = atom::load(&h->deq, __ATOMIC_ACQUIRE);
+    return (d >= atom::load(&h->enq, __ATOMIC_ACQUIRE) or d >= S) and atom::load(&h->next, __ATOMIC_ACQUIRE) == nullptr;
+  }
+
+  void
+  push(const T &val)
+  {
+    {
+      epoch_domain<>::guard __g(__epoch);
+      __enqueue(val);
+    }
+    __notify(false);
+  }
+
+  void
+  push(T &&val)
+  {
+    {
+      epoch_domain<>::guard __g(__epoch);
+      __enqueue(micron::move(val));
+    }
+    __notify(false);
+  }
+
+  template<typename... Args>
+  void
+  emplace(Args &&...args)
+  {
+    {
+      epoch_domain<>::guard __g(__epoch);
+      __enqueue(micron::forward<Args>(args)...);
+    }
+    __notify(false);
+  }
+
+  // claims up to count consecutive slots with one fetch_add per segment touched; per-producer order is kept
+  void
+  push_n(const T *items, usize count)
+  {
+    if ( count == 0 ) return;
+    {
+      epoch_domain<>::guard __g(__epoch);
+      usize k = 0;
+      while ( k < count ) {
+        __seg *t = atom::load(&__tail, __ATOMIC_ACQUIRE);
+        const usize cur = atom::load(&t->enq, __ATOMIC_RELAXED);
+        if ( cur >= S ) {
+          // segment is spent, the single-item path links the next one
+          __enqueue(items[k++]);
+          continue;
+        }
+        usize want = count - k;
+        if ( want > S - cur ) want = S - cur;
+        const usize i = atom::fetch_add(&t->enq, want, __ATOMIC_ACQ_REL);
+        const usize end = (i + want) < S ? (i + want) : S;
+        usize j = i;
+        // publish in order until a slot turns out poisoned, then poison the rest of the claim ourselves and retry from there
+        for ( ; j < end; ++j ) {
+          __slot &sl = t->slots[j];
+          new (sl.get()) T{ items[k] };
+          u32 e = __empty;
+          if ( !atom::compare_exchange(&sl.state, &e, u32{ __full }, false, __ATOMIC_RELEASE, __ATOMIC_RELAXED) ) {
+            sl.get()->~T();
+            break;
+          }
+          ++k;
+        }
+        for ( ++j; j < end; ++j ) {
+          u32 e = __empty;
+          atom::compare_exchange(&t->slots[j].state, &e, u32{ __poison }, false, __ATOMIC_RELEASE, __ATOMIC_RELAXED);
+        }
+      }
+    }
+    __notify(count > 1);
+  }
+
+  bool
+  pop(T &out)
+  {
+    epoch_domain<>::guard __g(__epoch);
+    return __dequeue(out);
+  }
+
+  // pops up to count items into out with one fetch_add per segment touched, returns how many
+  usize
+  pop_n(T *out, usize count)
+  {
+    epoch_domain<>::guard __g(__epoch);
+    usize k = 0;
+    while ( k < count ) {
+      __seg *h = atom::load(&__head, __ATOMIC_ACQUIRE);
+      const usize d = atom::load(&h->deq, __ATOMIC_ACQUIRE);
+      if ( d >= S ) {
+        if ( !__step(h) ) break;
+        continue;
+      }
+      const usize e = atom::load(&h->enq, __ATOMIC_ACQUIRE);
+      const usize top = e < S ? e : S;
+      if ( d >= top ) break;
+      // take only what producers have already claimed, so the batch poisons as little as possible
+      usize want = count - k;
+      if ( want > top - d ) want = top - d;
+      const usize i = atom::fetch_add(&h->deq, want, __ATOMIC_ACQ_REL);
+      const usize end = (i + want) < S ? (i + want) : S;
+      for ( usize j = i; j < end; ++j )
+        if ( __take(h, j, out[k]) ) ++k;
+    }
+    return k;
+  }
+
+  // blocks until an item arrives; false only once the queue is closed and drained
+  bool
+  pop_wait(T &out)
+  {
+    __pause_backoff b;
+    for ( u32 r = 0; r < 6; ++r ) {
+      if ( pop(out) ) return true;
+      b.relax();
+    }
+    for ( ;; ) {
+      const u32 key = __ec.prepare_wait();
+      atom::thread_fence(__ATOMIC_SEQ_CST);
+      if ( pop(out) ) {
+        __ec.cancel_wait();
+        return true;
+      }
+      if ( atom::load(&__closed, __ATOMIC_ACQUIRE) ) {
+        __ec.cancel_wait();
+        return pop(out);
+      }
+      __ec.commit_wait(key);
+    }
+  }
+
+  // wakes every pop_wait; they drain what is left and then return false. pushing after close is still allowed
+  void
+  close() noexcept
+  {
+    atom::store(&__closed, u32{ 1 }, __ATOMIC_RELEASE);
+    __ec.notify_all();
+  }
+
+  bool
+  closed() const noexcept
+  {
+    return atom::load(&__closed, __ATOMIC_ACQUIRE) != 0;
+  }
+};
+
+};      // namespace micron
@@ -13,10 +13,10 @@ namespace micron
 
 // heap_swiss_set
 //
-// thin set adapter over heap_swiss_map<K, __set_empty_v, Alloc>
-template<typename K, class Alloc = micron::allocator_serial<>> class heap_swiss_set
+// thin set adapter over heap_swiss_map<K, __set_empty_v, Alloc, false, Group>
+template<typename K, class Alloc = micron::allocator_serial<>, usize Group = 16> class heap_swiss_set
 {
-  using __map_t = heap_swiss_map<K, __set_empty_v, Alloc>;
+  using __map_t = heap_swiss_map<K, __set_empty_v, Alloc, false, Group>;
   __map_t __m;
 
 public:
@@ -154,5 +154,6 @@ public:
 };
 
 template<typename K, class Alloc = micron::allocator_serial<>> using hswiss_set = heap_swiss_set<K, Alloc>;
+template<typename K, class Alloc = micron::allocator_serial<>> using hswiss_set_wide = heap_swiss_set<K, Alloc, __swiss_native_group>;
 
 };      // namespace micron
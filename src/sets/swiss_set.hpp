@@ -13,10 +13,10 @@ namespace micron
 
 // swiss_set
 //
-// thin set adapter over stack_swiss_map<K, __set_empty_v, N, NH>; fixed capacity N, stack-allocated
-template<typename K, usize N, usize NH = 16> class swiss_set
+// thin set adapter over stack_swiss_map<K, __set_empty_v, N, NH, G>; fixed capacity N, stack-allocated
+template<typename K, usize N, usize NH = 16, usize G = 16> class swiss_set
 {
-  using __map_t = stack_swiss_map<K, __set_empty_v, N, NH>;
+  using __map_t = stack_swiss_map<K, __set_empty_v, N, NH, G>;
   __map_t __m;
 
 public:
@@ -35,6 +35,37 @@ _mm_cmpgt_epi64(__m128i a, __m128i b) noexcept
 
 #undef __inline_g
 
+#define __inline_g [[gnu::always_inline, gnu::artificial, gnu::target("sse4.2")]] static inline
+
+// crc32c (castagnoli) step, reflected, no inversion
+__inline_g unsigned int
+_mm_crc32_u8(unsigned int c, unsigned char v) noexcept
+{
+  return __builtin_ia32_crc32qi(c, v);
+}
+
+__inline_g unsigned int
+_mm_crc32_u16(unsigned int c, unsigned short v) noexcept
+{
+  return __builtin_ia32_crc32hi(c, v);
+}
+
+__inline_g unsigned int
+_mm_crc32_u32(unsigned int c, unsigned int v) noexcept
+{
+  return __builtin_ia32_crc32si(c, v);
+}
+
+#if defined(__micron_arch_width_64)
+__inline_g unsigned long long
+_mm_crc32_u64(unsigned long long c, unsigned long long v) noexcept
+{
+  return __builtin_ia32_crc32di(c, v);
+}
+#endif
+
+#undef __inline_g
+
 #pragma GCC diagnostic pop
 
 };      // namespace __bits
@@ -44,5 +75,11 @@ _mm_cmpgt_epi64(__m128i a, __m128i b) noexcept
 #if defined(MICRON_SIMD_INJECT_INTRIN_SYMS)
 #define __inject_i(name) using ::micron::simd::__bits::name
 __inject_i(_mm_cmpgt_epi64);
+__inject_i(_mm_crc32_u8);
+__inject_i(_mm_crc32_u16);
+__inject_i(_mm_crc32_u32);
+#if defined(__micron_arch_width_64)
+__inject_i(_mm_crc32_u64);
+#endif
 #undef __inject_i
 #endif
@@ -34,9 +34,9 @@ constexpr const unicode32 _null_u32str[1] = U"";
 // string on the heap, mutable, standard replacement of std::string, internally SIMD dispatched
 // accepts only char simple types
 template<is_scalar_literal T = schar, bool Sf = true, class Alloc = micron::allocator_small<>>
-class hstring: private Alloc, public __mutable_memory_resource<T, Alloc>
+class hstring: private Alloc, public __sso_memory_resource<T, Alloc>
 {
-  using __mem = __mutable_memory_resource<T, Alloc>;
+  using __mem = __sso_memory_resource<T, Alloc>;
 
   // all safety functions return true IF condition failed
   inline constexpr __attribute__((always_inline)) bool
@@ -45,34 +45,35 @@ class hstring: private Alloc, public __mutable_memory_resource<T, Alloc>
     return (cnt > micron::numeric_limits<ssize_t>::max());
   }
 
+  // anything that fits the inline buffer stays there, see __sso_memory_resource
   static inline constexpr __attribute__((always_inline)) usize
   __alloc_size(usize n) noexcept
   {
-    return n == 0 ? Alloc::auto_size() : n;
+    return n;
   }
 
   inline constexpr __attribute__((always_inline)) bool
   __size_check(usize cnt) const
   {
-    return (__mem::length >= __mem::capacity or (__mem::length + cnt) >= __mem::capacity);
+    return (__mem::__size() >= __mem::__cap() or (__mem::__size() + cnt) >= __mem::__cap());
   }
 
   inline __attribute__((always_inline)) bool
   __iterator_check(T *itr) const
   {
-    return (itr < __mem::memory or itr > __mem::memory + __mem::length);
+    return (itr < __mem::__ptr() or itr > __mem::__ptr() + __mem::__size());
   }
 
   inline __attribute__((always_inline)) bool
   __iterator_check(const T *itr) const
   {
-    return (itr < __mem::memory or itr > __mem::memory + __mem::length);
+    return (itr < __mem::__ptr() or itr > __mem::__ptr() + __mem::__size());
   }
 
   inline __attribute__((always_inline)) bool
   __iterator_bounds_check(const T *start, const T *end) const
   {
-    return (start < __mem::memory or end > __mem::memory + __mem::length or start > end);
+    return (start < __mem::__ptr() or end > __mem::__ptr() + __mem::__size() or start > end);
   }
 
   inline __attribute__((always_inline)) bool
@@ -84,50 +85,50 @@ class hstring: private Alloc, public __mutable_memory_resource<T, Alloc>
   inline __attribute__((always_inline)) bool
   __index_check(usize n) const
   {
-    return (n >= __mem::length);
+    return (n >= __mem::__size());
   }
 
   inline __attribute__((always_inline)) bool
   __index_check_le(usize n) const
   {
-    return (n > __mem::length);
+    return (n > __mem::__size());
   }
 
   inline __attribute__((always_inline)) bool
   __range_pos_cnt(usize pos, usize cnt) const
   {
-    return (pos > __mem::length or cnt > __mem::length - pos);
+    return (pos > __mem::__size() or cnt > __mem::__size() - pos);
   }
 
   inline __attribute__((always_inline)) bool
   __capacity_exceed(usize n) const
   {
-    return (n > __mem::capacity);
+    return (n > __mem::__cap());
   }
 
   inline __attribute__((always_inline)) bool
   __erase_iter_check(const T *itr, usize cnt) const
   {
-    return (itr < __mem::memory or itr > __mem::memory + __mem::length
-            or static_cast<ssize_t>(cnt) > ((__mem::memory + __mem::length) - itr));
+    return (itr < __mem::__ptr() or itr > __mem::__ptr() + __mem::__size()
+            or static_cast<ssize_t>(cnt) > ((__mem::__ptr() + __mem::__size()) - itr));
   }
 
   inline __attribute__((always_inline)) bool
   __erase_ind_check(usize ind, usize cnt) const
   {
-    return (ind > __mem::length or cnt > __mem::length - ind);
+    return (ind > __mem::__size() or cnt > __mem::__size() - ind);
   }
 
   inline __attribute__((always_inline)) bool
   __iter_substr_check(const T *start, const T *end_) const
   {
-    return (start < __mem::memory or end_ > __mem::memory + __mem::length or start > end_);
+    return (start < __mem::__ptr() or end_ > __mem::__ptr() + __mem::__size() or start > end_);
   }
 
   inline __attribute__((always_inline)) bool
   __at_iter_check(const T *itr) const
   {
-    auto diff = itr - &__mem::memory[0];
+    auto diff = itr - &__mem::__ptr()[0];
     return (diff > 256 or diff < 0);
   }
 
@@ -221,23 +222,24 @@ public:
   }
 
   // contiguous_memory<T> memory;
-  constexpr hstring() : __mem(Alloc::auto_size()) { __mem::memory[0] = T{ 0 }; };      // empty c_str()
+  constexpr hstring() : __mem() { };      // empty c_str(), inline and zeroed
 
-  constexpr hstring(const usize n) : __mem(__alloc_size(n)) { __mem::memory[0] = T{ 0 }; };
+  constexpr hstring(const usize n) : __mem(__alloc_size(n)) { __mem::__ptr()[0] = T{ 0 }; };
 
-  hstring(usize cnt, T ch) : __mem(__alloc_size(cnt))
+  hstring(usize cnt, T ch) : __mem(__alloc_size(cnt + 1))
   {
-    micron::typeset<T>(&__mem::memory[0], ch, cnt);
-    __mem::length = cnt;
+    micron::typeset<T>(&__mem::__ptr()[0], ch, cnt);
+    __mem::__ptr()[cnt] = T{ 0 };
+    __mem::__set_size(cnt);
   }
 
   // IMPORTANT, RECONSTRUCT NULL POST FACTO, EDGE CASES CAUSED CORRUPTION (ZERO SIZE, NONULL ET AL)
   constexpr hstring(const char *str) : __mem(__alloc_size(micron::strlen(str) + 1))
   {
     usize end = micron::strlen(str);
-    micron::memcpy(&(__mem::memory)[0], &str[0], end);
-    __mem::memory[end] = T{ 0 };
-    __mem::length = end;
+    micron::memcpy(&(__mem::__ptr())[0], &str[0], end);
+    __mem::__ptr()[end] = T{ 0 };
+    __mem::__set_size(end);
   };
 
   template<usize M, typename F> constexpr hstring(const F (&str)[M]) : __mem(__alloc_size(M))
@@ -247,18 +249,18 @@ public:
     // BUFFER rather than a tight string literal
     usize end = 0;
     while ( end < M - 1 && !(str[end] == F{ 0 }) ) ++end;
-    micron::bytecpy(&(__mem::memory)[0], &str[0], end * sizeof(F));
-    __mem::memory[end] = T{ 0 };
-    __mem::length = end;
+    micron::bytecpy(&(__mem::__ptr())[0], &str[0], end * sizeof(F));
+    __mem::__ptr()[end] = T{ 0 };
+    __mem::__set_size(end);
   };
 
-  constexpr hstring(const hstring &o) : __mem(__alloc_size(o.length + 1))
+  constexpr hstring(const hstring &o) : __mem(__alloc_size(o.size() + 1))
   {
     // WARNING: copy by length not capacity; the old system meant under abcmalloc we would baloon exponentially
     // this also means that you can no longer use strings as shadow buffers
-    micron::memcpy(__mem::memory, o.memory, o.length);
-    __mem::memory[o.length] = T{ 0 };
-    __mem::length = o.length;
+    micron::memcpy(__mem::__ptr(), o.data(), o.size());
+    __mem::__ptr()[o.size()] = T{ 0 };
+    __mem::__set_size(o.size());
   };
 
   // we're guarding now against cross width construction, too ub otherwise
@@ -272,20 +274,20 @@ public:
 
   template<typename F>
     requires(sizeof(F) == sizeof(T))
-  constexpr hstring(const hstring<F> &o) : __mem(__alloc_size(o.length + 1))
+  constexpr hstring(const hstring<F> &o) : __mem(__alloc_size(o.size() + 1))
   {
-    micron::memcpy(__mem::memory, o.memory, o.length);
-    __mem::memory[o.length] = T{ 0 };
-    __mem::length = o.length;
+    micron::memcpy(__mem::__ptr(), o.data(), o.size());
+    __mem::__ptr()[o.size()] = T{ 0 };
+    __mem::__set_size(o.size());
   };
 
   template<usize N, typename F>
     requires(sizeof(F) == sizeof(T))
   constexpr hstring(const sstring<N, F> &o) : __mem(__alloc_size(o.length + 1))
   {
-    micron::memcpy(&(__mem::memory)[0], &o.memory[0], o.length);
-    __mem::memory[o.length] = T{ 0 };
-    __mem::length = o.length;
+    micron::memcpy(&(__mem::__ptr())[0], &o.data()[0], o.length);
+    __mem::__ptr()[o.length] = T{ 0 };
+    __mem::__set_size(o.length);
   };
 
   template<is_iterable_container F>
@@ -293,9 +295,9 @@ public:
   constexpr hstring(const F &o) : __mem(__alloc_size(micron::string_len(o) + 1))
   {
     const usize __n = micron::string_len(o);
-    micron::memcpy(&(__mem::memory)[0], o.data(), __n);
-    __mem::memory[__n] = T{ 0 };
-    __mem::length = __n;
+    micron::memcpy(&(__mem::__ptr())[0], o.data(), __n);
+    __mem::__ptr()[__n] = T{ 0 };
+    __mem::__set_size(__n);
   };
 
   template<is_iterable_container F>
@@ -303,42 +305,39 @@ public:
   constexpr hstring(F &&o) : __mem(__alloc_size(micron::string_len(o) + 1))
   {
     const usize __n = micron::string_len(o);
-    micron::memcpy(&(__mem::memory)[0], o.data(), __n);
-    __mem::memory[__n] = T{ 0 };
-    __mem::length = __n;
+    micron::memcpy(&(__mem::__ptr())[0], o.data(), __n);
+    __mem::__ptr()[__n] = T{ 0 };
+    __mem::__set_size(__n);
   };
 
   // allow construction from - to iterator (be careful!)
   constexpr hstring(iterator __start, iterator __end)
-      : __mem((__start < __end
-                   ? ((max_t)Alloc::auto_size() < static_cast<usize>(__end - __start) + 1 ? static_cast<usize>(__end - __start) + 1
-                                                                                          : Alloc::auto_size())
-                   : (exc<except::library_error>("micron::hstring hstring() wrong iterators"), 0)))
+      : __mem((__start < __end ? static_cast<usize>(__end - __start) + 1
+                               : (exc<except::library_error>("micron::hstring hstring() wrong iterators"), 0)))
   {
-    micron::memcpy(__mem::memory, __start, __end - __start);
-    __mem::length = __end - __start;
-    __mem::memory[__mem::length] = T{ 0 };
+    micron::memcpy(__mem::__ptr(), __start, __end - __start);
+    __mem::__set_size(__end - __start);
+    __mem::__ptr()[__mem::__size()] = T{ 0 };
   }
 
   constexpr hstring(const_iterator __start, const_iterator __end)
-      : __mem((__start < __end ? (Alloc::auto_size() < static_cast<usize>(__end - __start) + 1 ? static_cast<usize>(__end - __start) + 1
-                                                                                               : Alloc::auto_size())
+      : __mem((__start < __end ? static_cast<usize>(__end - __start) + 1
                                : (exc<except::library_error>("micron::hstring hstring() wrong iterators"), 0)))
   {
-    micron::memcpy(__mem::memory, __start, __end - __start);
-    __mem::length = __end - __start;
-    __mem::memory[__mem::length] = T{ 0 };
+    micron::memcpy(__mem::__ptr(), __start, __end - __start);
+    __mem::__set_size(__end - __start);
+    __mem::__ptr()[__mem::__size()] = T{ 0 };
   }
 
   hstring &
   operator=(const hstring &o)
   {
     if ( this == micron::addressof(o) ) return *this;
-    if ( __mem::capacity < o.length + 1 ) reserve(o.length + 1);
-    if ( __mem::length > o.length ) micron::zero(&__mem::memory[o.length], __mem::length - o.length);
-    micron::memcpy(__mem::memory, o.memory, o.length);
-    __mem::memory[o.length] = T{ 0 };
-    __mem::length = o.length;
+    if ( __mem::__cap() < o.size() + 1 ) reserve(o.size() + 1);
+    if ( __mem::__size() > o.size() ) micron::zero(&__mem::__ptr()[o.size()], __mem::__size() - o.size());
+    micron::memcpy(__mem::__ptr(), o.data(), o.size());
+    __mem::__ptr()[o.size()] = T{ 0 };
+    __mem::__set_size(o.size());
     return *this;
   }
 
@@ -346,15 +345,7 @@ public:
   operator=(hstring &&o)
   {
     if ( this == micron::addressof(o) ) return *this;
-    if ( __mem::memory ) {
-      __mem::free();
-    }
-    __mem::memory = o.memory;
-    __mem::length = o.length;
-    __mem::capacity = o.capacity;
-    o.memory = nullptr;
-    o.length = 0;
-    o.capacity = 0;
+    __mem::operator=(micron::move(o));
     return *this;
   }
 
@@ -363,11 +354,11 @@ public:
   hstring &
   operator=(const S<F> &o)
   {
-    if ( __mem::capacity < o.length + 1 ) reserve(o.length + 1);
-    if ( __mem::length > o.length ) micron::zero(&__mem::memory[o.length], __mem::length - o.length);
-    micron::memcpy(__mem::memory, o.memory, o.length);
-    __mem::memory[o.length] = T{ 0 };
-    __mem::length = o.length;
+    if ( __mem::__cap() < o.size() + 1 ) reserve(o.size() + 1);
+    if ( __mem::__size() > o.size() ) micron::zero(&__mem::__ptr()[o.size()], __mem::__size() - o.size());
+    micron::memcpy(__mem::__ptr(), o.data(), o.size());
+    __mem::__ptr()[o.size()] = T{ 0 };
+    __mem::__set_size(o.size());
     return *this;
   }
 
@@ -376,15 +367,7 @@ public:
   hstring &
   operator=(hstring<F> &&o)
   {
-    if ( __mem::memory ) {
-      __mem::free();
-    }
-    __mem::memory = o.memory;
-    __mem::length = o.length;
-    __mem::capacity = o.capacity;
-    o.memory = nullptr;
-    o.length = 0;
-    o.capacity = 0;
+    __mem::operator=(micron::move(o));
     return *this;
   }
 
@@ -392,11 +375,11 @@ public:
   hstring &
   operator=(const S<N, F> &o)
   {
-    if ( __mem::capacity < o.length + 1 ) reserve(o.length + 1);
-    if ( __mem::length > o.length ) micron::zero(&__mem::memory[o.length], __mem::length - o.length);
-    micron::memcpy(__mem::memory, &o.memory[0], o.length);
-    __mem::memory[o.length] = T{ 0 };
-    __mem::length = o.length;
+    if ( __mem::__cap() < o.length + 1 ) reserve(o.length + 1);
+    if ( __mem::__size() > o.length ) micron::zero(&__mem::__ptr()[o.length], __mem::__size() - o.length);
+    micron::memcpy(__mem::__ptr(), &o.data()[0], o.length);
+    __mem::__ptr()[o.length] = T{ 0 };
+    __mem::__set_size(o.length);
     return *this;
   }
 
@@ -406,18 +389,18 @@ public:
   {
     usize end = 0;
     while ( end < M - 1 && !(str[end] == F{ 0 }) ) ++end;
-    if ( __mem::capacity < end + 1 ) reserve(end + 1);
-    if ( __mem::length > end ) micron::zero(&__mem::memory[end], __mem::length - end);
-    micron::bytecpy(&(__mem::memory)[0], &str[0], end * sizeof(F));
-    __mem::memory[end] = T{ 0 };
-    __mem::length = end;
+    if ( __mem::__cap() < end + 1 ) reserve(end + 1);
+    if ( __mem::__size() > end ) micron::zero(&__mem::__ptr()[end], __mem::__size() - end);
+    micron::bytecpy(&(__mem::__ptr())[0], &str[0], end * sizeof(F));
+    __mem::__ptr()[end] = T{ 0 };
+    __mem::__set_size(end);
     return *this;
   }
 
   chunk<byte>
   operator*()
   {
-    return { reinterpret_cast<byte *>(__mem::memory), __mem::capacity };
+    return { reinterpret_cast<byte *>(__mem::__ptr()), __mem::__cap() };
   }
 
   inline bool
@@ -429,110 +412,107 @@ public:
   byte *
   operator&()
   {
-    return reinterpret_cast<byte *>(__mem::memory);
+    return reinterpret_cast<byte *>(__mem::__ptr());
   }
 
   const byte *
   operator&(void) const
   {
-    return reinterpret_cast<const byte *>(__mem::memory);
+    return reinterpret_cast<const byte *>(__mem::__ptr());
   }
 
   bool
   empty(void) const
   {
-    return (__mem::length == 0 or __mem::memory == nullptr);
+    return __mem::__size() == 0;
   };
 
   usize
   size(void) const
   {
-    return __mem::length;
+    return __mem::__size();
   }
 
   usize
   len(void) const
   {
-    return __mem::length;
+    return __mem::__size();
   }
 
   void
   set_size(size_type n)
   {
-    __mem::length = n;
+    __mem::__set_size(n);
     // WARNING: must set last char to null, otherwise c_str() breaks
-    if ( __mem::memory && n < __mem::capacity ) __mem::memory[n] = T{ 0 };
+    if ( n < __mem::__cap() ) __mem::__ptr()[n] = T{ 0 };
   }
 
   void
   adjust_size()
   {
-    auto ln = micron::strlen(__mem::memory);
-    __mem::length = ln;
+    auto ln = micron::strlen(__mem::__ptr());
+    __mem::__set_size(ln);
   }
 
   usize
   max_size(void) const
   {
-    return __mem::capacity;
+    return __mem::__cap();
   }
 
   iterator
   data()
   {
-    return __mem::memory;
+    return __mem::__ptr();
   };
 
   const_iterator
   data(void) const
   {
-    return __mem::memory;
+    return __mem::__ptr();
   };
 
   const_iterator
   cdata(void) const
   {
-    return __mem::memory;
+    return __mem::__ptr();
   };
 
   inline sstring<256, T>
   stack(void) const
   {
-    if ( __mem::length >= 255 ) exc<except::library_error>("micron::hstring stack() out of memory");
+    if ( __mem::__size() >= 255 ) exc<except::library_error>("micron::hstring stack() out of memory");
     return sstring<256, T>(c_str());
   };
 
   inline const char *
   c_str(void) const
   {
-    if ( __mem::memory == nullptr ) return _null_str;
-    return reinterpret_cast<const char *>(&(__mem::memory)[0]);
+    return reinterpret_cast<const char *>(&(__mem::__ptr())[0]);
   };
 
   inline const wide *
   w_str(void) const
   {
-    if ( __mem::memory == nullptr ) return _null_wstr;
-    return reinterpret_cast<const wide *>(&(__mem::memory)[0]);
+    return reinterpret_cast<const wide *>(&(__mem::__ptr())[0]);
   };
 
   inline const unicode32 *
   uni_str(void) const
   {
-    if ( __mem::memory == nullptr ) return _null_u32str;
-    return reinterpret_cast<const unicode32 *>(&(__mem::memory)[0]);
+    return reinterpret_cast<const unicode32 *>(&(__mem::__ptr())[0]);
   };
 
   inline slice<T>
   into_chars(void) const
   {
-    return slice<T>(&__mem::memory[0], &__mem::memory[__mem::length]);
+    return slice<T>(&__mem::__ptr()[0], &__mem::__ptr()[__mem::__size()]);
   }
 
   inline slice<byte>
   into_bytes()
   {
-    return slice<byte>(reinterpret_cast<byte *>(&__mem::memory[0]), reinterpret_cast<byte *>(&__mem::memory[__mem::length]));
+    return slice<byte>(reinterpret_cast<byte *>(&__mem::__ptr()[0]), reinterpret_cast<byte *>(&__mem::__ptr()[__mem::__size()]));
   }
 
   inline auto
@@ -551,41 +531,41 @@ public:
   inline T &
   front()
   {
-    return __mem::memory[0];
+    return __mem::__ptr()[0];
   }
 
   inline const T &
   front(void) const
   {
-    return __mem::memory[0];
+    return __mem::__ptr()[0];
   }
 
   inline T &
   back()
   {
-    return __mem::memory[__mem::length - 1];
+    return __mem::__ptr()[__mem::__size() - 1];
   }
 
   inline const T &
   back(void) const
   {
-    return __mem::memory[__mem::length - 1];
+    return __mem::__ptr()[__mem::__size() - 1];
   }
 
   inline void
   _buf_set_length(const usize s)
   {
-    __mem::length = s;
+    __mem::__set_size(s);
     // WARNING: maintain the NUL invariant, otherwise c_str() over-reads past the logical end
-    if ( __mem::memory && s < __mem::capacity ) __mem::memory[s] = T{ 0 };
+    if ( s < __mem::__cap() ) __mem::__ptr()[s] = T{ 0 };
   }
 
   template<typename F>
   usize
   find(F ch, usize pos = 0) const
   {
-    if ( pos >= __mem::length ) return npos;
-    usize r = __simd_find_byte(__mem::memory + pos, __mem::length - pos, static_cast<T>(ch));
+    if ( pos >= __mem::__size() ) return npos;
+    usize r = __simd_find_byte(__mem::__ptr() + pos, __mem::__size() - pos, static_cast<T>(ch));
     return r == npos ? npos : pos + r;
   }
 
@@ -599,71 +579,71 @@ public:
   inline iterator
   begin()
   {
-    return const_cast<iterator>(&(__mem::memory)[0]);
+    return const_cast<iterator>(&(__mem::__ptr())[0]);
   }
 
   inline iterator
   end()
   {
-    return const_cast<iterator>(&(__mem::memory)[__mem::length]);
+    return const_cast<iterator>(&(__mem::__ptr())[__mem::__size()]);
   }
 
   inline iterator
   begin(void) const
   {
-    return const_cast<iterator>(&(__mem::memory)[0]);
+    return const_cast<iterator>(&(__mem::__ptr())[0]);
   }
 
   inline iterator
   end(void) const
   {
-    return const_cast<iterator>(&(__mem::memory)[__mem::length]);
+    return const_cast<iterator>(&(__mem::__ptr())[__mem::__size()]);
   }
 
   inline iterator
   last()
   {
-    return const_cast<iterator>(&(__mem::memory)[__mem::length - 1]);
+    return const_cast<iterator>(&(__mem::__ptr())[__mem::__size() - 1]);
   }
 
   inline iterator
   last(void) const
   {
-    return const_cast<iterator>(&(__mem::memory)[__mem::length - 1]);
+    return const_cast<iterator>(&(__mem::__ptr())[__mem::__size() - 1]);
   }
 
   inline const_iterator
   cbegin(void) const
   {
-    return &(__mem::memory)[0];
+    return &(__mem::__ptr())[0];
   }
 
   inline const_iterator
   cend(void) const
   {
-    return &(__mem::memory)[__mem::length];
+    return &(__mem::__ptr())[__mem::__size()];
   }
 
   inline void
   clear()
   {
-    zero(__mem::memory, __mem::capacity);
-    __mem::length = 0;
+    zero(__mem::__ptr(), __mem::__cap());
+    __mem::__set_size(0);
   }
 
   inline void
   fast_clear()
   {
-    __mem::length = 0;
+    __mem::__set_size(0);
   }
 
   inline hstring &
   append(const buffer &f, usize n)
   {
-    if ( (__mem::length + n + 1) >= __mem::capacity ) reserve(__mem::length + n + 1);
-    micron::memcpy(&(__mem::memory)[__mem::length], &f[0], n);
-    __mem::length += n;
-    __mem::memory[__mem::length] = T{ 0 };
+    if ( (__mem::__size() + n + 1) >= __mem::__cap() ) reserve(__mem::__size() + n + 1);
+    micron::memcpy(&(__mem::__ptr())[__mem::__size()], &f[0], n);
+    __mem::__set_size(__mem::__size() + n);
+    __mem::__ptr()[__mem::__size()] = T{ 0 };
     return *this;
   }
 
@@ -671,10 +651,10 @@ public:
   inline hstring &
   append(const slice<F> &f, usize n)
   {
-    if ( (__mem::length + n + 1) >= __mem::capacity ) reserve(__mem::length + n + 1);
-    micron::memcpy(&(__mem::memory)[__mem::length], &f[0], n);
-    __mem::length += n;
-    __mem::memory[__mem::length] = T{ 0 };
+    if ( (__mem::__size() + n + 1) >= __mem::__cap() ) reserve(__mem::__size() + n + 1);
+    micron::memcpy(&(__mem::__ptr())[__mem::__size()], &f[0], n);
+    __mem::__set_size(__mem::__size() + n);
+    __mem::__ptr()[__mem::__size()] = T{ 0 };
     return *this;
   }
 
@@ -682,10 +662,10 @@ public:
   inline hstring &
   append(const F *f, usize n)
   {
-    if ( (__mem::length + n + 1) >= __mem::capacity ) reserve(__mem::length + n + 1);
-    micron::memcpy(&(__mem::memory)[__mem::length], f, n);
-    __mem::length += n;
-    __mem::memory[__mem::length] = T{ 0 };
+    if ( (__mem::__size() + n + 1) >= __mem::__cap() ) reserve(__mem::__size() + n + 1);
+    micron::memcpy(&(__mem::__ptr())[__mem::__size()], f, n);
+    __mem::__set_size(__mem::__size() + n);
+    __mem::__ptr()[__mem::__size()] = T{ 0 };
     return *this;
   }
 
@@ -693,10 +673,10 @@ public:
   inline hstring &
   append(const F (&str)[M])
   {
-    if ( (__mem::length + M) >= __mem::capacity ) reserve(__mem::length + M + 1);
-    micron::memcpy(&(__mem::memory)[__mem::length], &str[0], M - 1);
-    __mem::length += M - 1;
-    __mem::memory[__mem::length] = T{ 0 };
+    if ( (__mem::__size() + M) >= __mem::__cap() ) reserve(__mem::__size() + M + 1);
+    micron::memcpy(&(__mem::__ptr())[__mem::__size()], &str[0], M - 1);
+    __mem::__set_size(__mem::__size() + M - 1);
+    __mem::__ptr()[__mem::__size()] = T{ 0 };
     return *this;
   }
 
@@ -704,10 +684,10 @@ public:
   inline hstring &
   append(const hstring<F> &o)
   {
-    if ( (__mem::length + o.length + 1) >= __mem::capacity ) reserve(__mem::length + o.length + 1);
-    micron::memcpy(&(__mem::memory)[__mem::length], &(o.memory)[0], o.length);
-    __mem::length += o.length;
-    __mem::memory[__mem::length] = T{ 0 };
+    if ( (__mem::__size() + o.size() + 1) >= __mem::__cap() ) reserve(__mem::__size() + o.size() + 1);
+    micron::memcpy(&(__mem::__ptr())[__mem::__size()], &(o.data())[0], o.size());
+    __mem::__set_size(__mem::__size() + o.size());
+    __mem::__ptr()[__mem::__size()] = T{ 0 };
     return *this;
   }
 
@@ -715,19 +695,19 @@ public:
   inline hstring &
   append(const sstring<M, F> &o)
   {
-    if ( (__mem::length + o.length + 1) >= __mem::capacity ) reserve(__mem::length + o.length + 1);
-    micron::memcpy(&(__mem::memory)[__mem::length], &(o.memory)[0], o.length);
-    __mem::length += o.length;
-    __mem::memory[__mem::length] = T{ 0 };
+    if ( (__mem::__size() + o.length + 1) >= __mem::__cap() ) reserve(__mem::__size() + o.length + 1);
+    micron::memcpy(&(__mem::__ptr())[__mem::__size()], &(o.data())[0], o.length);
+    __mem::__set_size(__mem::__size() + o.length);
+    __mem::__ptr()[__mem::__size()] = T{ 0 };
     return *this;
   }
 
   inline hstring &
   pop_back(void)
   {
-    if ( __mem::length > 0 ) {
-      --__mem::length;
-      (__mem::memory)[__mem::length] = T{ 0 };
+    if ( __mem::__size() > 0 ) {
+      __mem::__set_size(__mem::__size() - 1);
+      (__mem::__ptr())[__mem::__size()] = T{ 0 };
     }
     return *this;
   }
@@ -737,9 +717,11 @@ public:
   push_back(F ch)
   {
 
-    if ( __mem::length + 1 >= __mem::capacity ) reserve(__mem::length + 2);
-    (__mem::memory)[__mem::length++] = static_cast<T>(ch);
-    __mem::memory[__mem::length] = T{ 0 };
+    if ( __mem::__size() + 1 >= __mem::__cap() ) reserve(__mem::__size() + 2);
+    const usize n = __mem::__size();
+    (__mem::__ptr())[n] = static_cast<T>(ch);
+    __mem::__ptr()[n + 1] = T{ 0 };
+    __mem::__set_size(n + 1);
     return *this;
   }
 
@@ -747,10 +729,10 @@ public:
   inline hstring &
   push_back(const F (&str)[M])
   {
-    if ( (__mem::length + M) >= __mem::capacity ) reserve(__mem::length + M + 1);
-    micron::memcpy(&(__mem::memory)[__mem::length], &str[0], M - 1);
-    __mem::length += M - 1;
-    __mem::memory[__mem::length] = T{ 0 };
+    if ( (__mem::__size() + M) >= __mem::__cap() ) reserve(__mem::__size() + M + 1);
+    micron::memcpy(&(__mem::__ptr())[__mem::__size()], &str[0], M - 1);
+    __mem::__set_size(__mem::__size() + M - 1);
+    __mem::__ptr()[__mem::__size()] = T{ 0 };
     return *this;
   }
 
@@ -758,10 +740,10 @@ public:
   inline hstring &
   push_back(const hstring<F> &o)
   {
-    if ( (__mem::length + o.length + 1) >= __mem::capacity ) reserve(__mem::length + o.length + 1);
-    micron::memcpy(&(__mem::memory)[__mem::length], &(o.memory)[0], o.length);
-    __mem::length += o.length;
-    __mem::memory[__mem::length] = T{ 0 };
+    if ( (__mem::__size() + o.size() + 1) >= __mem::__cap() ) reserve(__mem::__size() + o.size() + 1);
+    micron::memcpy(&(__mem::__ptr())[__mem::__size()], &(o.data())[0], o.size());
+    __mem::__set_size(__mem::__size() + o.size());
+    __mem::__ptr()[__mem::__size()] = T{ 0 };
     return *this;
   }
 
@@ -769,10 +751,10 @@ public:
   inline hstring &
   push_back(const sstring<M, F> &o)
   {
-    if ( (__mem::length + o.length + 1) >= __mem::capacity ) reserve(__mem::length + o.length + 1);
-    micron::memcpy(&(__mem::memory)[__mem::length], &(o.memory)[0], o.length);
-    __mem::length += o.length;
-    __mem::memory[__mem::length] = T{ 0 };
+    if ( (__mem::__size() + o.length + 1) >= __mem::__cap() ) reserve(__mem::__size() + o.length + 1);
+    micron::memcpy(&(__mem::__ptr())[__mem::__size()], &(o.data())[0], o.length);
+    __mem::__set_size(__mem::__size() + o.length);
+    __mem::__ptr()[__mem::__size()] = T{ 0 };
     return *this;
   }
 
@@ -782,11 +764,11 @@ public:
   {
     __safety_check<&hstring::__valid_cnt, except::library_error>("micron::hstring insert() invalid count", cnt);
     __safety_check<&hstring::__index_check_le, except::library_error>("micron::hstring insert() index out of range", ind);
-    if ( __mem::length + cnt + 1 >= __mem::capacity ) reserve(__mem::length + cnt + 1);
-    micron::memmove(&__mem::memory[ind + cnt], &__mem::memory[ind], __mem::length - ind);
-    micron::typeset<T>(&__mem::memory[ind], ch, cnt);
-    __mem::length += cnt;
-    __mem::memory[__mem::length] = T{ 0 };
+    if ( __mem::__size() + cnt + 1 >= __mem::__cap() ) reserve(__mem::__size() + cnt + 1);
+    micron::memmove(&__mem::__ptr()[ind + cnt], &__mem::__ptr()[ind], __mem::__size() - ind);
+    micron::typeset<T>(&__mem::__ptr()[ind], ch, cnt);
+    __mem::__set_size(__mem::__size() + cnt);
+    __mem::__ptr()[__mem::__size()] = T{ 0 };
     return *this;
   }
 
@@ -800,12 +782,12 @@ public:
     if ( str_len && cnt > (micron::numeric_limits<ssize_t>::max() / str_len) )
       exc<except::library_error>("micron::hstring insert() count overflow");
     const usize total = cnt * str_len;
-    if ( __mem::length + total + 1 >= __mem::capacity ) reserve(__mem::length + total + 1);
+    if ( __mem::__size() + total + 1 >= __mem::__cap() ) reserve(__mem::__size() + total + 1);
 
-    micron::memmove(&__mem::memory[ind + total], &__mem::memory[ind], __mem::length - ind);
-    for ( usize i = 0; i < cnt; ++i ) micron::memcpy(&__mem::memory[ind + i * str_len], str, str_len);
-    __mem::length += total;
-    __mem::memory[__mem::length] = T{ 0 };
+    micron::memmove(&__mem::__ptr()[ind + total], &__mem::__ptr()[ind], __mem::__size() - ind);
+    for ( usize i = 0; i < cnt; ++i ) micron::memcpy(&__mem::__ptr()[ind + i * str_len], str, str_len);
+    __mem::__set_size(__mem::__size() + total);
+    __mem::__ptr()[__mem::__size()] = T{ 0 };
     return *this;
   }
 
@@ -815,13 +797,13 @@ public:
   {
     __safety_check<&hstring::__index_check_le, except::library_error>("micron::hstring insert() index out of range", ind);
     usize end = micron::strlen(o.c_str());
-    if ( __mem::length + end + 1 >= __mem::capacity ) {
-      reserve(__mem::length + end + 1);
+    if ( __mem::__size() + end + 1 >= __mem::__cap() ) {
+      reserve(__mem::__size() + end + 1);
     }
-    micron::memmove(&(__mem::memory)[ind + (end)], &(__mem::memory)[ind], __mem::length - ind);
-    micron::memcpy(&(__mem::memory)[ind], &o.memory[0], end);
-    __mem::length += end;
-    __mem::memory[__mem::length] = T{ 0 };
+    micron::memmove(&(__mem::__ptr())[ind + (end)], &(__mem::__ptr())[ind], __mem::__size() - ind);
+    micron::memcpy(&(__mem::__ptr())[ind], &o.data()[0], end);
+    __mem::__set_size(__mem::__size() + end);
+    __mem::__ptr()[__mem::__size()] = T{ 0 };
     return *this;
   }
 
@@ -833,16 +815,16 @@ public:
     __safety_check<static_cast<bool (hstring::*)(T *) const>(&hstring::__iterator_check), except::library_error>(
         "micron::hstring insert() iterator out of range", itr);
 
-    if ( (__mem::length + cnt + 1) >= __mem::capacity ) {
-      usize dif = itr - __mem::memory;
-      reserve(__mem::length + cnt + 1);
-      itr = __mem::memory + dif;
+    if ( (__mem::__size() + cnt + 1) >= __mem::__cap() ) {
+      usize dif = itr - __mem::__ptr();
+      reserve(__mem::__size() + cnt + 1);
+      itr = __mem::__ptr() + dif;
     }
 
-    micron::memmove(itr + cnt, itr, __mem::length - (itr - __mem::memory));
+    micron::memmove(itr + cnt, itr, __mem::__size() - (itr - __mem::__ptr()));
     micron::typeset<T>(itr, ch, cnt);
-    __mem::length += cnt;
-    __mem::memory[__mem::length] = T{ 0 };
+    __mem::__set_size(__mem::__size() + cnt);
+    __mem::__ptr()[__mem::__size()] = T{ 0 };
     return *this;
   }
 
@@ -859,17 +841,17 @@ public:
       exc<except::library_error>("micron::hstring insert() count overflow");
     const usize total = cnt * str_len;
 
-    if ( (__mem::length + total + 1) >= __mem::capacity ) {
-      usize dif = itr - __mem::memory;
-      reserve(__mem::length + total + 1);
-      itr = __mem::memory + dif;
+    if ( (__mem::__size() + total + 1) >= __mem::__cap() ) {
+      usize dif = itr - __mem::__ptr();
+      reserve(__mem::__size() + total + 1);
+      itr = __mem::__ptr() + dif;
     }
 
-    usize tail_len = __mem::length - (itr - __mem::memory);
+    usize tail_len = __mem::__size() - (itr - __mem::__ptr());
     micron::memmove(itr + total, itr, tail_len);
     for ( usize i = 0; i < cnt; ++i ) micron::memcpy(itr + i * str_len, str, str_len);
-    __mem::length += total;
-    __mem::memory[__mem::length] = T{ 0 };
+    __mem::__set_size(__mem::__size() + total);
+    __mem::__ptr()[__mem::__size()] = T{ 0 };
     return *this;
   }
 
@@ -879,15 +861,15 @@ public:
   {
     __safety_check<static_cast<bool (hstring::*)(T *) const>(&hstring::__iterator_check), except::library_error>(
         "micron::hstring insert() iterator out of range", itr);
-    if ( __mem::length + o.length + 1 >= __mem::capacity ) {
-      usize dif = itr - __mem::memory;
-      reserve(__mem::length + o.length + 1);
-      itr = __mem::memory + dif;
+    if ( __mem::__size() + o.size() + 1 >= __mem::__cap() ) {
+      usize dif = itr - __mem::__ptr();
+      reserve(__mem::__size() + o.size() + 1);
+      itr = __mem::__ptr() + dif;
     }
-    micron::memmove(itr + o.length, itr, __mem::length - (itr - &(__mem::memory)[0]));
-    micron::memcpy(itr, &(o.memory)[0], o.length);
-    __mem::length += o.length;
-    __mem::memory[__mem::length] = T{ 0 };
+    micron::memmove(itr + o.size(), itr, __mem::__size() - (itr - &(__mem::__ptr())[0]));
+    micron::memcpy(itr, &(o.data())[0], o.size());
+    __mem::__set_size(__mem::__size() + o.size());
+    __mem::__ptr()[__mem::__size()] = T{ 0 };
     return *this;
   }
 
@@ -899,15 +881,15 @@ public:
         "micron::hstring insert() iterator out of range", itr);
     usize end = micron::strlen(o.c_str());
     if ( end == 0 ) return *this;
-    if ( __mem::length + end + 1 >= __mem::capacity ) {
-      usize dif = itr - __mem::memory;
-      reserve(__mem::length + end + 1);
-      itr = __mem::memory + dif;
+    if ( __mem::__size() + end + 1 >= __mem::__cap() ) {
+      usize dif = itr - __mem::__ptr();
+      reserve(__mem::__size() + end + 1);
+      itr = __mem::__ptr() + dif;
     }
-    micron::memmove(itr + end, itr, __mem::length - (itr - &(__mem::memory)[0]));
-    micron::memcpy(itr, &o.memory[0], end);
-    __mem::length += end;
-    __mem::memory[__mem::length] = T{ 0 };
+    micron::memmove(itr + end, itr, __mem::__size() - (itr - &(__mem::__ptr())[0]));
+    micron::memcpy(itr, &o.data()[0], end);
+    __mem::__set_size(__mem::__size() + end);
+    __mem::__ptr()[__mem::__size()] = T{ 0 };
     return *this;
   }
 
@@ -918,16 +900,16 @@ public:
     __safety_check<static_cast<bool (hstring::*)(T *) const>(&hstring::__iterator_check), except::library_error>(
         "micron::hstring insert() iterator out of range", itr);
     if ( o.length == 0 ) return *this;
-    if ( __mem::length + o.length + 1 >= __mem::capacity ) {
-      usize dif = itr - __mem::memory;
-      reserve(__mem::length + o.length + 1);
-      itr = __mem::memory + dif;
+    if ( __mem::__size() + o.length + 1 >= __mem::__cap() ) {
+      usize dif = itr - __mem::__ptr();
+      reserve(__mem::__size() + o.length + 1);
+      itr = __mem::__ptr() + dif;
     }
-    micron::memmove(itr + o.length, itr, __mem::length - (itr - &(__mem::memory)[0]));
-    micron::memcpy(itr, &o.memory[0], o.length);
-    __mem::length += o.length;
-    __mem::memory[__mem::length] = T{ 0 };
-    micron::zero(o.memory, o.length);
+    micron::memmove(itr + o.length, itr, __mem::__size() - (itr - &(__mem::__ptr())[0]));
+    micron::memcpy(itr, &o.data()[0], o.length);
+    __mem::__set_size(__mem::__size() + o.length);
+    __mem::__ptr()[__mem::__size()] = T{ 0 };
+    micron::zero(o.data(), o.length);
     o.length = 0;
     return *this;
   }
@@ -936,14 +918,14 @@ public:
   at(const usize n)
   {
     __safety_check<&hstring::__index_check, except::library_error>("micron::hstring at() out of range", n);
-    return (__mem::memory)[n];
+    return (__mem::__ptr())[n];
   };
 
   inline const T &
   at(const usize n) const
   {
     __safety_check<&hstring::__index_check, except::library_error>("micron::hstring at() out of range", n);
-    return (__mem::memory)[n];
+    return (__mem::__ptr())[n];
   };
 
   template<typename Itr>
@@ -953,7 +935,7 @@ public:
   {
     __safety_check<&hstring::__at_iter_check, except::library_error>("micron::hstring at() iterator out of range",
                                                                      static_cast<const T *>(n));
-    return n - &__mem::memory[0];
+    return n - &__mem::__ptr()[0];
   };
 
   template<typename Itr>
@@ -963,7 +945,7 @@ public:
   {
     __safety_check<&hstring::__at_iter_check, except::library_error>("micron::hstring at() iterator out of range",
                                                                      static_cast<const T *>(n));
-    return n - &__mem::memory[0];
+    return n - &__mem::__ptr()[0];
   };
 
   template<typename Itr>
@@ -973,7 +955,7 @@ public:
   {
     __safety_check<&hstring::__at_iter_check, except::library_error>("micron::hstring at() iterator out of range",
                                                                      static_cast<const T *>(n));
-    return n - &__mem::memory[0];
+    return n - &__mem::__ptr()[0];
   };
 
   template<typename Itr>
@@ -983,28 +965,28 @@ public:
   {
     __safety_check<&hstring::__at_iter_check, except::library_error>("micron::hstring at() iterator out of range",
                                                                      static_cast<const T *>(n));
-    return n - &__mem::memory[0];
+    return n - &__mem::__ptr()[0];
   };
 
   inline T &
   operator[](const usize n)
   {
-    return (__mem::memory)[n];
+    return (__mem::__ptr())[n];
   };
 
   inline const T &
   operator[](const usize n) const
   {
-    return (__mem::memory)[n];
+    return (__mem::__ptr())[n];
   };
 
   inline hstring &
   operator+=(const buffer &data)
   {
-    if ( (__mem::length + data.size() + 1) >= __mem::capacity ) reserve(__mem::length + data.size() + 1);
-    micron::memcpy(&(__mem::memory)[__mem::length], &data[0], data.size());
-    __mem::length += data.size();
-    __mem::memory[__mem::length] = T{ 0 };
+    if ( (__mem::__size() + data.size() + 1) >= __mem::__cap() ) reserve(__mem::__size() + data.size() + 1);
+    micron::memcpy(&(__mem::__ptr())[__mem::__size()], &data[0], data.size());
+    __mem::__set_size(__mem::__size() + data.size());
+    __mem::__ptr()[__mem::__size()] = T{ 0 };
     return *this;
   };
 
@@ -1013,10 +995,10 @@ public:
   operator+=(const F *data)
   {
     usize end = micron::strlen(data);
-    if ( (__mem::length + end + 1) >= __mem::capacity ) reserve(__mem::length + end + 1);
-    micron::memcpy(&(__mem::memory)[__mem::length], &(data)[0], end);
-    __mem::length += end;
-    __mem::memory[__mem::length] = T{ 0 };
+    if ( (__mem::__size() + end + 1) >= __mem::__cap() ) reserve(__mem::__size() + end + 1);
+    micron::memcpy(&(__mem::__ptr())[__mem::__size()], &(data)[0], end);
+    __mem::__set_size(__mem::__size() + end);
+    __mem::__ptr()[__mem::__size()] = T{ 0 };
     return *this;
   };
 
@@ -1024,11 +1006,11 @@ public:
   inline hstring &
   operator+=(const sstring<M, F> &data)
   {
-    if ( (data.length + __mem::length + 1) >= __mem::capacity ) [[unlikely]]
-      reserve(__mem::length + data.length + 1);
-    micron::memcpy(&(__mem::memory)[__mem::length], &(data.memory)[0], data.length);
-    __mem::length += data.length;
-    __mem::memory[__mem::length] = T{ 0 };
+    if ( (data.length + __mem::__size() + 1) >= __mem::__cap() ) [[unlikely]]
+      reserve(__mem::__size() + data.length + 1);
+    micron::memcpy(&(__mem::__ptr())[__mem::__size()], &(data.data())[0], data.length);
+    __mem::__set_size(__mem::__size() + data.length);
+    __mem::__ptr()[__mem::__size()] = T{ 0 };
     return *this;
   };
 
@@ -1036,21 +1018,21 @@ public:
   inline hstring &
   operator+=(const hstring<F> &data)
   {
-    if ( (data.length + __mem::length + 1) >= __mem::capacity ) reserve(__mem::length + data.length + 1);
-    micron::memcpy(&(__mem::memory)[__mem::length], &(data.memory)[0], data.length);
-    __mem::length += data.length;
-    __mem::memory[__mem::length] = T{ 0 };
+    if ( (data.size() + __mem::__size() + 1) >= __mem::__cap() ) reserve(__mem::__size() + data.size() + 1);
+    micron::memcpy(&(__mem::__ptr())[__mem::__size()], &(data.data())[0], data.size());
+    __mem::__set_size(__mem::__size() + data.size());
+    __mem::__ptr()[__mem::__size()] = T{ 0 };
     return *this;
   };
 
   inline hstring &
   operator+=(const T d)
   {
-    if ( (__mem::length + 1 + 1) >= __mem::capacity ) reserve(__mem::length + 2);
-    usize ln = __mem::length == 0 ? 0 : __mem::length;
-    __mem::memory[ln] = d;
-    __mem::length++;
-    __mem::memory[__mem::length] = T{ 0 };
+    if ( (__mem::__size() + 1 + 1) >= __mem::__cap() ) reserve(__mem::__size() + 2);
+    usize ln = __mem::__size() == 0 ? 0 : __mem::__size();
+    __mem::__ptr()[ln] = d;
+    __mem::__set_size(__mem::__size() + 1);
+    __mem::__ptr()[__mem::__size()] = T{ 0 };
     return *this;
   };
 
@@ -1059,10 +1041,10 @@ public:
   operator+=(const slice<F> &data)
   {
     if ( data.size() == 0 ) return *this;
-    if ( (data.size() + __mem::length + 1) >= __mem::capacity ) reserve(__mem::length + data.size() + 1);
-    micron::memcpy(&(__mem::memory)[__mem::length], &data[0], data.size());
-    __mem::length += data.size();
-    __mem::memory[__mem::length] = T{ 0 };
+    if ( (data.size() + __mem::__size() + 1) >= __mem::__cap() ) reserve(__mem::__size() + data.size() + 1);
+    micron::memcpy(&(__mem::__ptr())[__mem::__size()], &data[0], data.size());
+    __mem::__set_size(__mem::__size() + data.size());
+    __mem::__ptr()[__mem::__size()] = T{ 0 };
     return *this;
   };
 
@@ -1089,8 +1071,8 @@ public:
   {
     hstring out;
     if ( n >= 1 ) {
-      out.reserve(__mem::length * static_cast<usize>(n) + 1);
-      for ( I k = 0; k < n; ++k ) out.append(__mem::memory, __mem::length);
+      out.reserve(__mem::__size() * static_cast<usize>(n) + 1);
+      for ( I k = 0; k < n; ++k ) out.append(__mem::__ptr(), __mem::__size());
     }
     return out;
   };
@@ -1106,8 +1088,8 @@ public:
     }
     if ( n == 1 ) return *this;
     hstring snap(*this);
-    reserve(__mem::length * static_cast<usize>(n) + 1);
-    for ( I k = 1; k < n; ++k ) append(snap.memory, snap.length);
+    reserve(__mem::__size() * static_cast<usize>(n) + 1);
+    for ( I k = 1; k < n; ++k ) append(snap.data(), snap.size());
     return *this;
   };
 
@@ -1134,8 +1116,8 @@ public:
   {
     hstring out(*this);
     const __bspan k = __as_key(rhs);
-    micron::simd::xor_bytes_cycle(reinterpret_cast<byte *>(out.memory), reinterpret_cast<const byte *>(__mem::memory),
-                                  __mem::length * sizeof(T), k.p, k.n);
+    micron::simd::xor_bytes_cycle(reinterpret_cast<byte *>(out.data()), reinterpret_cast<const byte *>(__mem::__ptr()),
+                                  __mem::__size() * sizeof(T), k.p, k.n);
     return out;
   };
 
@@ -1145,8 +1127,8 @@ public:
   operator^=(const R &rhs)
   {
     const __bspan k = __as_key(rhs);
-    micron::simd::xor_bytes_cycle(reinterpret_cast<byte *>(__mem::memory), reinterpret_cast<const byte *>(__mem::memory),
-                                  __mem::length * sizeof(T), k.p, k.n);
+    micron::simd::xor_bytes_cycle(reinterpret_cast<byte *>(__mem::__ptr()), reinterpret_cast<const byte *>(__mem::__ptr()),
+                                  __mem::__size() * sizeof(T), k.p, k.n);
     return *this;
   };
 
@@ -1157,8 +1139,8 @@ public:
   {
     hstring out(*this);
     const __bspan k = __as_key(rhs);
-    micron::simd::and_bytes_cycle(reinterpret_cast<byte *>(out.memory), reinterpret_cast<const byte *>(__mem::memory),
-                                  __mem::length * sizeof(T), k.p, k.n);
+    micron::simd::and_bytes_cycle(reinterpret_cast<byte *>(out.data()), reinterpret_cast<const byte *>(__mem::__ptr()),
+                                  __mem::__size() * sizeof(T), k.p, k.n);
     return out;
   };
 
@@ -1168,8 +1150,8 @@ public:
   operator&=(const R &rhs)
   {
     const __bspan k = __as_key(rhs);
-    micron::simd::and_bytes_cycle(reinterpret_cast<byte *>(__mem::memory), reinterpret_cast<const byte *>(__mem::memory),
-                                  __mem::length * sizeof(T), k.p, k.n);
+    micron::simd::and_bytes_cycle(reinterpret_cast<byte *>(__mem::__ptr()), reinterpret_cast<const byte *>(__mem::__ptr()),
+                                  __mem::__size() * sizeof(T), k.p, k.n);
     return *this;
   };
 
@@ -1180,8 +1162,8 @@ public:
   {
     hstring out(*this);
     const __bspan k = __as_key(rhs);
-    micron::simd::or_bytes_cycle(reinterpret_cast<byte *>(out.memory), reinterpret_cast<const byte *>(__mem::memory),
-                                 __mem::length * sizeof(T), k.p, k.n);
+    micron::simd::or_bytes_cycle(reinterpret_cast<byte *>(out.data()), reinterpret_cast<const byte *>(__mem::__ptr()),
+                                 __mem::__size() * sizeof(T), k.p, k.n);
     return out;
   };
 
@@ -1191,8 +1173,8 @@ public:
   operator|=(const R &rhs)
   {
     const __bspan k = __as_key(rhs);
-    micron::simd::or_bytes_cycle(reinterpret_cast<byte *>(__mem::memory), reinterpret_cast<const byte *>(__mem::memory),
-                                 __mem::length * sizeof(T), k.p, k.n);
+    micron::simd::or_bytes_cycle(reinterpret_cast<byte *>(__mem::__ptr()), reinterpret_cast<const byte *>(__mem::__ptr()),
+                                 __mem::__size() * sizeof(T), k.p, k.n);
     return *this;
   };
 
@@ -1201,11 +1183,11 @@ public:
   inline hstring<F>
   substr(usize pos = 0, usize cnt = npos) const
   {
-    if ( cnt == npos ) cnt = (pos <= __mem::length) ? __mem::length - pos : 0;
+    if ( cnt == npos ) cnt = (pos <= __mem::__size()) ? __mem::__size() - pos : 0;
     __safety_check<&hstring::__range_pos_cnt, except::library_error>("micron::hstring substr() invalid range", pos, cnt);
 
     hstring<F> buf(cnt + 1);
-    micron::memcpy(buf.data(), &__mem::memory[pos], cnt);
+    micron::memcpy(buf.data(), &__mem::__ptr()[pos], cnt);
     buf._buf_set_length(cnt);
     return buf;
   };
@@ -1248,13 +1230,13 @@ public:
   inline hstring<F> &
   truncate(I n)
   {
-    if ( n >= __mem::length ) return *this;
+    if ( n >= __mem::__size() ) return *this;
 
     __safety_check<&hstring::__capacity_exceed, except::library_error>("micron::hstring truncate() index out of range",
                                                                        static_cast<usize>(n));
 
-    micron::typeset<T>(&__mem::memory[n], 0x0, __mem::length - n);
-    __mem::length = n;
+    micron::typeset<T>(&__mem::__ptr()[n], 0x0, __mem::__size() - n);
+    __mem::__set_size(n);
     return *this;
   }
 
@@ -1270,8 +1252,8 @@ public:
     if ( itr >= end() ) return *this;
 
     usize n = static_cast<usize>(itr - begin());
-    micron::typeset<T>(&__mem::memory[n], 0x0, __mem::length - n);
-    __mem::length = n;
+    micron::typeset<T>(&__mem::__ptr()[n], 0x0, __mem::__size() - n);
+    __mem::__set_size(n);
     return *this;
   }
 
@@ -1287,19 +1269,15 @@ public:
     if ( itr >= cend() ) return *this;
 
     usize n = static_cast<usize>(itr - cbegin());
-    micron::typeset<T>(&__mem::memory[n], 0x0, __mem::length - n);
-    __mem::length = n;
+    micron::typeset<T>(&__mem::__ptr()[n], 0x0, __mem::__size() - n);
+    __mem::__set_size(n);
     return *this;
   }
 
   void
   reserve(usize n)
   {
-    if ( (n < __mem::capacity) ) {
-      return;
-    }
-    if ( __mem::memory == nullptr ) [[unlikely]] {
-      __mem::realloc(n ? n : Alloc::auto_size());
+    if ( (n < __mem::__cap()) ) {
       return;
     }
     __mem::expand(n);
@@ -1308,31 +1286,27 @@ public:
   void
   try_reserve(usize n)
   {
-    if ( (n < __mem::capacity) ) {
+    if ( (n < __mem::__cap()) ) {
       exc<except::memory_error>("micron::hstring try_reserve() was unable to allocate memory");
     }
-    if ( __mem::memory == nullptr ) [[unlikely]] {
-      __mem::realloc(n ? n : Alloc::auto_size());
-      return;
-    }
     __mem::expand(n);
   }
 
   void
   resize(usize n, const T ch)
   {
-    if ( n == __mem::length ) return;
-    if ( n < __mem::length ) {
+    if ( n == __mem::__size() ) return;
+    if ( n < __mem::__size() ) {
 
-      micron::typeset<T>(&__mem::memory[n], 0x0, __mem::length - n);
-      __mem::length = n;
+      micron::typeset<T>(&__mem::__ptr()[n], 0x0, __mem::__size() - n);
+      __mem::__set_size(n);
       return;
     }
-    if ( n + 1 >= __mem::capacity ) reserve(n + 1);
+    if ( n + 1 >= __mem::__cap() ) reserve(n + 1);
 
-    micron::typeset<T>(&__mem::memory[__mem::length], ch, n - __mem::length);
-    __mem::memory[n] = T{ 0 };
-    __mem::length = n;
+    micron::typeset<T>(&__mem::__ptr()[__mem::__size()], ch, n - __mem::__size());
+    __mem::__ptr()[n] = T{ 0 };
+    __mem::__set_size(n);
   }
 
   template<typename F = T, typename I = usize>
@@ -1347,9 +1321,9 @@ public:
 
     if ( !cnt ) return *this;
 
-    micron::memmove(&__mem::memory[ind], &__mem::memory[ind + (1 + (cnt - 1))], __mem::length - (ind + 1 + (cnt - 1)));
-    micron::typeset<T>(&__mem::memory[__mem::length - (cnt)], 0x0, cnt);
-    __mem::length -= cnt;
+    micron::memmove(&__mem::__ptr()[ind], &__mem::__ptr()[ind + (1 + (cnt - 1))], __mem::__size() - (ind + 1 + (cnt - 1)));
+    micron::typeset<T>(&__mem::__ptr()[__mem::__size() - (cnt)], 0x0, cnt);
+    __mem::__set_size(__mem::__size() - cnt);
     return *this;
   }
 
@@ -1363,9 +1337,9 @@ public:
 
     if ( !cnt ) return *this;
 
-    micron::memmove(itr, itr + (1 + (cnt - 1)), __mem::length - ((itr - &__mem::memory[0]) + 1 + (cnt - 1)));
-    micron::typeset<T>(&__mem::memory[__mem::length - cnt], 0x0, cnt);
-    __mem::length -= cnt;
+    micron::memmove(itr, itr + (1 + (cnt - 1)), __mem::__size() - ((itr - &__mem::__ptr()[0]) + 1 + (cnt - 1)));
+    micron::typeset<T>(&__mem::__ptr()[__mem::__size() - cnt], 0x0, cnt);
+    __mem::__set_size(__mem::__size() - cnt);
     return *this;
   }
 
@@ -1378,24 +1352,24 @@ public:
 
     if ( !cnt ) return *this;
 
-    micron::memmove(itr, itr + (1 + (cnt - 1)), __mem::length - ((itr - &__mem::memory[0]) + 1 + (cnt - 1)));
-    micron::typeset<T>(&__mem::memory[__mem::length - cnt], 0x0, cnt);
-    __mem::length -= cnt;
+    micron::memmove(itr, itr + (1 + (cnt - 1)), __mem::__size() - ((itr - &__mem::__ptr()[0]) + 1 + (cnt - 1)));
+    micron::typeset<T>(&__mem::__ptr()[__mem::__size() - cnt], 0x0, cnt);
+    __mem::__set_size(__mem::__size() - cnt);
     return *this;
   }
 
   inline usize
   find_substr(const T *needle, usize needle_len, usize pos = 0) const
   {
-    if ( needle_len == 0 || needle_len > __mem::length ) return npos;
-    if ( pos > __mem::length - needle_len ) return npos;
+    if ( needle_len == 0 || needle_len > __mem::__size() ) return npos;
+    if ( pos > __mem::__size() - needle_len ) return npos;
     if constexpr ( sizeof(T) != 1 ) {
-      const usize r = micron::simd::find_substr_elem<T>(__mem::memory + pos, __mem::length - pos, needle, needle_len);
-      return r == (__mem::length - pos) ? npos : pos + r;
+      const usize r = micron::simd::find_substr_elem<T>(__mem::__ptr() + pos, __mem::__size() - pos, needle, needle_len);
+      return r == (__mem::__size() - pos) ? npos : pos + r;
     }
-    auto *r = micron::memmem<byte>(reinterpret_cast<const byte *>(__mem::memory + pos), __mem::length - pos,
+    auto *r = micron::memmem<byte>(reinterpret_cast<const byte *>(__mem::__ptr() + pos), __mem::__size() - pos,
                                    reinterpret_cast<const byte *>(needle), needle_len);
-    return r == nullptr ? npos : static_cast<usize>(reinterpret_cast<const T *>(r) - __mem::memory);
+    return r == nullptr ? npos : static_cast<usize>(reinterpret_cast<const T *>(r) - __mem::__ptr());
   }
 
   template<typename F = T>
@@ -1411,9 +1385,9 @@ public:
     usize pos = find_substr(reinterpret_cast<const T *>(needle), needle_len);
     if ( pos == npos ) return *this;
 
-    micron::memmove(&__mem::memory[pos], &__mem::memory[pos + needle_len], __mem::length - (pos + needle_len));
-    micron::typeset<T>(&__mem::memory[__mem::length - needle_len], 0x0, needle_len);
-    __mem::length -= needle_len;
+    micron::memmove(&__mem::__ptr()[pos], &__mem::__ptr()[pos + needle_len], __mem::__size() - (pos + needle_len));
+    micron::typeset<T>(&__mem::__ptr()[__mem::__size() - needle_len], 0x0, needle_len);
+    __mem::__set_size(__mem::__size() - needle_len);
     return *this;
   }
 
@@ -1426,9 +1400,9 @@ public:
     usize pos = find_substr(needle.data(), needle.size());
     if ( pos == npos ) return *this;
 
-    micron::memmove(&__mem::memory[pos], &__mem::memory[pos + needle.size()], __mem::length - (pos + needle.size()));
-    micron::typeset<T>(&__mem::memory[__mem::length - needle.size()], 0x0, needle.size());
-    __mem::length -= needle.size();
+    micron::memmove(&__mem::__ptr()[pos], &__mem::__ptr()[pos + needle.size()], __mem::__size() - (pos + needle.size()));
+    micron::typeset<T>(&__mem::__ptr()[__mem::__size() - needle.size()], 0x0, needle.size());
+    __mem::__set_size(__mem::__size() - needle.size());
     return *this;
   }
 
@@ -1441,9 +1415,9 @@ public:
     usize pos = find_substr(needle.data(), needle.size());
     if ( pos == npos ) return *this;
 
-    micron::memmove(&__mem::memory[pos], &__mem::memory[pos + needle.size()], __mem::length - (pos + needle.size()));
-    micron::typeset<T>(&__mem::memory[__mem::length - needle.size()], 0x0, needle.size());
-    __mem::length -= needle.size();
+    micron::memmove(&__mem::__ptr()[pos], &__mem::__ptr()[pos + needle.size()], __mem::__size() - (pos + needle.size()));
+    micron::typeset<T>(&__mem::__ptr()[__mem::__size() - needle.size()], 0x0, needle.size());
+    __mem::__set_size(__mem::__size() - needle.size());
     return *this;
   }
 
@@ -1459,9 +1433,9 @@ public:
 
     usize pos = 0;
     while ( (pos = find_substr(reinterpret_cast<const T *>(needle), needle_len, pos)) != npos ) {
-      micron::memmove(&__mem::memory[pos], &__mem::memory[pos + needle_len], __mem::length - (pos + needle_len));
-      micron::typeset<T>(&__mem::memory[__mem::length - needle_len], 0x0, needle_len);
-      __mem::length -= needle_len;
+      micron::memmove(&__mem::__ptr()[pos], &__mem::__ptr()[pos + needle_len], __mem::__size() - (pos + needle_len));
+      micron::typeset<T>(&__mem::__ptr()[__mem::__size() - needle_len], 0x0, needle_len);
+      __mem::__set_size(__mem::__size() - needle_len);
     }
     return *this;
   }
@@ -1474,9 +1448,9 @@ public:
 
     usize pos = 0;
     while ( (pos = find_substr(needle.data(), needle.size(), pos)) != npos ) {
-      micron::memmove(&__mem::memory[pos], &__mem::memory[pos + needle.size()], __mem::length - (pos + needle.size()));
-      micron::typeset<T>(&__mem::memory[__mem::length - needle.size()], 0x0, needle.size());
-      __mem::length -= needle.size();
+      micron::memmove(&__mem::__ptr()[pos], &__mem::__ptr()[pos + needle.size()], __mem::__size() - (pos + needle.size()));
+      micron::typeset<T>(&__mem::__ptr()[__mem::__size() - needle.size()], 0x0, needle.size());
+      __mem::__set_size(__mem::__size() - needle.size());
     }
     return *this;
   }
@@ -1489,9 +1463,9 @@ public:
 
     usize pos = 0;
     while ( (pos = find_substr(needle.data(), needle.size(), pos)) != npos ) {
-      micron::memmove(&__mem::memory[pos], &__mem::memory[pos + needle.size()], __mem::length - (pos + needle.size()));
-      micron::typeset<T>(&__mem::memory[__mem::length - needle.size()], 0x0, needle.size());
-      __mem::length -= needle.size();
+      micron::memmove(&__mem::__ptr()[pos], &__mem::__ptr()[pos + needle.size()], __mem::__size() - (pos + needle.size()));
+      micron::typeset<T>(&__mem::__ptr()[__mem::__size() - needle.size()], 0x0, needle.size());
+      __mem::__set_size(__mem::__size() - needle.size());
     }
     return *this;
   }
@@ -1507,7 +1481,7 @@ public:
   inline bool
   operator==(const S &str) const
   {
-    return __lexcmp(__mem::memory, __mem::length, str.c_str(), str.size()) == 0;
+    return __lexcmp(__mem::__ptr(), __mem::__size(), str.c_str(), str.size()) == 0;
   }
 
   template<is_string S>
@@ -1515,7 +1489,7 @@ public:
   inline bool
   operator!=(const S &str) const
   {
-    return __lexcmp(__mem::memory, __mem::length, str.c_str(), str.size()) != 0;
+    return __lexcmp(__mem::__ptr(), __mem::__size(), str.c_str(), str.size()) != 0;
   }
 
   inline bool
@@ -1523,7 +1497,7 @@ public:
   {
     __safety_check<&hstring::__null_check, except::library_error>("micron::hstring operator==() null pointer",
                                                                   static_cast<const void *>(data));
-    return __lexcmp(__mem::memory, __mem::length, data, micron::strlen(data)) == 0;
+    return __lexcmp(__mem::__ptr(), __mem::__size(), data, micron::strlen(data)) == 0;
   }
 
   template<usize M>
@@ -1532,7 +1506,7 @@ public:
   {
     __safety_check<&hstring::__null_check, except::library_error>("micron::hstring operator!=() null pointer",
                                                                   static_cast<const void *>(data));
-    return __lexcmp(__mem::memory, __mem::length, data, micron::strlen(data)) != 0;
+    return __lexcmp(__mem::__ptr(), __mem::__size(), data, micron::strlen(data)) != 0;
   }
 
   template<typename S>
@@ -1542,7 +1516,7 @@ public:
   {
     __safety_check<&hstring::__null_check, except::library_error>("micron::hstring operator!=() null pointer",
                                                                   static_cast<const void *>(data));
-    return __lexcmp(__mem::memory, __mem::length, data, micron::strlen(data)) != 0;
+    return __lexcmp(__mem::__ptr(), __mem::__size(), data, micron::strlen(data)) != 0;
   }
 
   inline bool
@@ -1550,7 +1524,7 @@ public:
   {
     __safety_check<&hstring::__null_check, except::library_error>("micron::hstring operator!=() null pointer",
                                                                   static_cast<const void *>(data));
-    return __lexcmp(__mem::memory, __mem::length, data, micron::strlen(data)) != 0;
+    return __lexcmp(__mem::__ptr(), __mem::__size(), data, micron::strlen(data)) != 0;
   }
 
   inline bool
@@ -1558,7 +1532,7 @@ public:
   {
     __safety_check<&hstring::__null_check, except::library_error>("micron::hstring operator<() null pointer",
                                                                   static_cast<const void *>(data));
-    return __lexcmp(__mem::memory, __mem::length, data, micron::strlen(data)) < 0;
+    return __lexcmp(__mem::__ptr(), __mem::__size(), data, micron::strlen(data)) < 0;
   }
 
   inline bool
@@ -1566,7 +1540,7 @@ public:
   {
     __safety_check<&hstring::__null_check, except::library_error>("micron::hstring operator>() null pointer",
                                                                   static_cast<const void *>(data));
-    return __lexcmp(__mem::memory, __mem::length, data, micron::strlen(data)) > 0;
+    return __lexcmp(__mem::__ptr(), __mem::__size(), data, micron::strlen(data)) > 0;
   }
 
   inline bool
@@ -1574,7 +1548,7 @@ public:
   {
     __safety_check<&hstring::__null_check, except::library_error>("micron::hstring operator<=() null pointer",
                                                                   static_cast<const void *>(data));
-    return __lexcmp(__mem::memory, __mem::length, data, micron::strlen(data)) <= 0;
+    return __lexcmp(__mem::__ptr(), __mem::__size(), data, micron::strlen(data)) <= 0;
   }
 
   inline bool
@@ -1582,7 +1556,7 @@ public:
   {
     __safety_check<&hstring::__null_check, except::library_error>("micron::hstring operator>=() null pointer",
                                                                   static_cast<const void *>(data));
-    return __lexcmp(__mem::memory, __mem::length, data, micron::strlen(data)) >= 0;
+    return __lexcmp(__mem::__ptr(), __mem::__size(), data, micron::strlen(data)) >= 0;
   }
 
   template<typename F = T, usize M>
@@ -1590,7 +1564,7 @@ public:
   inline bool
   operator==(const F (&data)[M]) const
   {
-    return __lexcmp(__mem::memory, __mem::length, reinterpret_cast<const T *>(&data[0]), M - 1) == 0;
+    return __lexcmp(__mem::__ptr(), __mem::__size(), reinterpret_cast<const T *>(&data[0]), M - 1) == 0;
   }
 
   template<typename F = T, usize M>
@@ -1598,7 +1572,7 @@ public:
   inline bool
   operator!=(const F (&data)[M]) const
   {
-    return __lexcmp(__mem::memory, __mem::length, reinterpret_cast<const T *>(&data[0]), M - 1) != 0;
+    return __lexcmp(__mem::__ptr(), __mem::__size(), reinterpret_cast<const T *>(&data[0]), M - 1) != 0;
   }
 
   template<typename F = T, usize M>
@@ -1606,7 +1580,7 @@ public:
   inline bool
   operator<(const F (&data)[M]) const
   {
-    return __lexcmp(__mem::memory, __mem::length, reinterpret_cast<const T *>(&data[0]), M - 1) < 0;
+    return __lexcmp(__mem::__ptr(), __mem::__size(), reinterpret_cast<const T *>(&data[0]), M - 1) < 0;
   }
 
   template<typename F = T, usize M>
@@ -1614,7 +1588,7 @@ public:
   inline bool
   operator>(const F (&data)[M]) const
   {
-    return __lexcmp(__mem::memory, __mem::length, reinterpret_cast<const T *>(&data[0]), M - 1) > 0;
+    return __lexcmp(__mem::__ptr(), __mem::__size(), reinterpret_cast<const T *>(&data[0]), M - 1) > 0;
   }
 
   template<typename F = T, usize M>
@@ -1622,7 +1596,7 @@ public:
   inline bool
   operator<=(const F (&data)[M]) const
   {
-    return __lexcmp(__mem::memory, __mem::length, reinterpret_cast<const T *>(&data[0]), M - 1) <= 0;
+    return __lexcmp(__mem::__ptr(), __mem::__size(), reinterpret_cast<const T *>(&data[0]), M - 1) <= 0;
   }
 
   template<typename F = T, usize M>
@@ -1630,7 +1604,7 @@ public:
   inline bool
   operator>=(const F (&data)[M]) const
   {
-    return __lexcmp(__mem::memory, __mem::length, reinterpret_cast<const T *>(&data[0]), M - 1) >= 0;
+    return __lexcmp(__mem::__ptr(), __mem::__size(), reinterpret_cast<const T *>(&data[0]), M - 1) >= 0;
   }
 
   template<typename F = T>
@@ -1638,7 +1612,7 @@ public:
   inline bool
   operator==(const hstring<F> &data) const
   {
-    return __lexcmp(__mem::memory, __mem::length, reinterpret_cast<const T *>(data.memory), data.length) == 0;
+    return __lexcmp(__mem::__ptr(), __mem::__size(), reinterpret_cast<const T *>(data.data()), data.size()) == 0;
   }
 
   template<typename F = T>
@@ -1646,7 +1620,7 @@ public:
   inline bool
   operator!=(const hstring<F> &data) const
   {
-    return __lexcmp(__mem::memory, __mem::length, reinterpret_cast<const T *>(data.memory), data.length) != 0;
+    return __lexcmp(__mem::__ptr(), __mem::__size(), reinterpret_cast<const T *>(data.data()), data.size()) != 0;
   }
 
   template<typename F = T>
@@ -1654,7 +1628,7 @@ public:
   inline bool
   operator<(const hstring<F> &data) const
   {
-    return __lexcmp(__mem::memory, __mem::length, reinterpret_cast<const T *>(data.memory), data.length) < 0;
+    return __lexcmp(__mem::__ptr(), __mem::__size(), reinterpret_cast<const T *>(data.data()), data.size()) < 0;
   }
 
   template<typename F = T>
@@ -1662,7 +1636,7 @@ public:
   inline bool
   operator>(const hstring<F> &data) const
   {
-    return __lexcmp(__mem::memory, __mem::length, reinterpret_cast<const T *>(data.memory), data.length) > 0;
+    return __lexcmp(__mem::__ptr(), __mem::__size(), reinterpret_cast<const T *>(data.data()), data.size()) > 0;
   }
 
   template<typename F = T>
@@ -1670,7 +1644,7 @@ public:
   inline bool
   operator<=(const hstring<F> &data) const
   {
-    return __lexcmp(__mem::memory, __mem::length, reinterpret_cast<const T *>(data.memory), data.length) <= 0;
+    return __lexcmp(__mem::__ptr(), __mem::__size(), reinterpret_cast<const T *>(data.data()), data.size()) <= 0;
   }
 
   template<typename F = T>
@@ -1678,7 +1652,7 @@ public:
   inline bool
   operator>=(const hstring<F> &data) const
   {
-    return __lexcmp(__mem::memory, __mem::length, reinterpret_cast<const T *>(data.memory), data.length) >= 0;
+    return __lexcmp(__mem::__ptr(), __mem::__size(), reinterpret_cast<const T *>(data.data()), data.size()) >= 0;
   }
 
   template<usize N, typename F = T>
@@ -1686,7 +1660,7 @@ public:
   inline bool
   operator==(const sstring<N, F> &data) const
   {
-    return __lexcmp(__mem::memory, __mem::length, reinterpret_cast<const T *>(data.memory), data.length) == 0;
+    return __lexcmp(__mem::__ptr(), __mem::__size(), reinterpret_cast<const T *>(data.data()), data.length) == 0;
   }
 
   template<usize N, typename F = T>
@@ -1694,7 +1668,7 @@ public:
   inline bool
   operator!=(const sstring<N, F> &data) const
   {
-    return __lexcmp(__mem::memory, __mem::length, reinterpret_cast<const T *>(data.memory), data.length) != 0;
+    return __lexcmp(__mem::__ptr(), __mem::__size(), reinterpret_cast<const T *>(data.data()), data.length) != 0;
   }
 
   template<usize N, typename F = T>
@@ -1702,7 +1676,7 @@ public:
   inline bool
   operator<(const sstring<N, F> &data) const
   {
-    return __lexcmp(__mem::memory, __mem::length, reinterpret_cast<const T *>(data.memory), data.length) < 0;
+    return __lexcmp(__mem::__ptr(), __mem::__size(), reinterpret_cast<const T *>(data.data()), data.length) < 0;
   }
 
   template<usize N, typename F = T>
@@ -1710,7 +1684,7 @@ public:
   inline bool
   operator>(const sstring<N, F> &data) const
   {
-    return __lexcmp(__mem::memory, __mem::length, reinterpret_cast<const T *>(data.memory), data.length) > 0;
+    return __lexcmp(__mem::__ptr(), __mem::__size(), reinterpret_cast<const T *>(data.data()), data.length) > 0;
   }
 
   template<usize N, typename F = T>
@@ -1718,7 +1692,7 @@ public:
   inline bool
   operator<=(const sstring<N, F> &data) const
   {
-    return __lexcmp(__mem::memory, __mem::length, reinterpret_cast<const T *>(data.memory), data.length) <= 0;
+    return __lexcmp(__mem::__ptr(), __mem::__size(), reinterpret_cast<const T *>(data.data()), data.length) <= 0;
   }
 
   template<usize N, typename F = T>
@@ -1726,7 +1700,7 @@ public:
   inline bool
   operator>=(const sstring<N, F> &data) const
   {
-    return __lexcmp(__mem::memory, __mem::length, reinterpret_cast<const T *>(data.memory), data.length) >= 0;
+    return __lexcmp(__mem::__ptr(), __mem::__size(), reinterpret_cast<const T *>(data.data()), data.length) >= 0;
   }
 };
 
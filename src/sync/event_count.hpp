@@ -52,6 +52,14 @@ public:
     __waiters.sub_fetch(1, memory_order::acq_rel);
   }
 
+  // somebody is between prepare_wait and commit/cancel; with a seq_cst fence after the waiter's prepare_wait and before this load,
+  // a notifier that sees false can skip notify entirely
+  [[nodiscard]] bool
+  has_waiters() const noexcept
+  {
+    return __waiters.get(memory_order::relaxed) != 0;
+  }
+
   // wake one parked waiter (if any)
   void
   notify_one() noexcept
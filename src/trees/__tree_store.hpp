@@ -8,6 +8,7 @@
 #include "../memory/actions.hpp"
 #include "../memory/addr.hpp"
 #include "../memory/allocation/resources.hpp"
+#include "../sort/merge.hpp"
 #include "../type_traits.hpp"
 #include "../types.hpp"
 
@@ -182,5 +183,51 @@ public:
   }
 };
 
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+// bottom-up bulk loading
+
+// default sort phase of the bulk loaders; any callable sort(first, last, cmp) over T* can stand in (parallel::bulk_sort)
+struct serial_sort {
+  template<typename T, typename Cmp>
+  void
+  operator()(T *first, T *last, Cmp cmp) const
+  {
+    if ( last - first > 1 ) micron::sort::__merge_sort(first, 0, static_cast<max_t>(last - first) - 1, cmp);
+  }
+};
+
+// per-node occupancy for a fill factor in (0, 1], clamped to [lo, cap]
+inline usize
+bulk_target(f32 fill, usize cap, usize lo) noexcept
+{
+  usize t = (fill > 0.0f) ? static_cast<usize>(fill * static_cast<f32>(cap) + 0.5f) : cap;
+  if ( t > cap ) t = cap;
+  if ( t < lo ) t = lo;
+  if ( t < 1 ) t = 1;
+  return t;
+}
+
+// n items cut into nodes of about target each, spread evenly so no node (bar a lone root) drops under lo
+struct bulk_plan {
+  usize nodes;
+  usize base;
+  usize extra;
+
+  bulk_plan(usize n, usize target, usize lo) noexcept
+  {
+    nodes = (n + target - 1) / target;
+    if ( nodes > 1 and lo > 0 and nodes > n / lo ) nodes = n / lo;
+    if ( nodes < 1 ) nodes = 1;
+    base = n / nodes;
+    extra = n % nodes;
+  }
+
+  [[gnu::always_inline]] usize
+  size(usize j) const noexcept
+  {
+    return base + (j < extra ? 1u : 0u);
+  }
+};
+
 };      // namespace __tree_store
 };      // namespace micron
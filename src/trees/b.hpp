@@ -22,6 +22,8 @@ namespace micron
 // micron::b_tree
 // ordered, arena-backed B+-tree map, values live only in leaves; internal nodes hold separator keys + child
 // leaves are doubly linked; insert/erase is top-down
+// nodes are slots of one index addressed arena (__tree_store::node_arena), so Alloc backs the arena as a whole rather than each
+// node; monotonic_allocator suits it, pool_allocator only sees blocks past its Max and passes them through
 
 // default ordering policy
 template<typename T> struct b_default_less {
@@ -32,7 +34,7 @@ template<typename T> struct b_default_less {
   }
 };
 
-template<typename K, typename V, typename Compare = b_default_less<K>, usize DegreeOverride = 0>
+template<typename K, typename V, typename Compare = b_default_less<K>, usize DegreeOverride = 0, class Alloc = allocator_serial<>>
   requires micron::is_copy_constructible_v<K> && micron::is_move_constructible_v<V>
 class b_tree
 {
@@ -124,7 +126,7 @@ class b_tree
 
   static constexpr usize __slot_bytes = (sizeof(internal_node) > sizeof(leaf_node)) ? sizeof(internal_node) : sizeof(leaf_node);
 
-  __tree_store::node_arena<__slot_bytes, 64> __arena;
+  __tree_store::node_arena<__slot_bytes, 64, Alloc> __arena;
   node_idx __root;
   usize __size;
 
@@ -440,6 +442,63 @@ class b_tree
     return i;
   }
 
+  // bottom-up build over the n distinct entries of an ascending run, equal neighbours keep the last one
+  // only valid on an empty tree: the arena hands out fresh slots in order, so every level is one contiguous run of indices
+  template<typename It>
+  void
+  bulk_build(It first, usize n, f32 fill)
+  {
+    usize m = 0;
+    for ( usize i = 0; i < n; ++i )
+      if ( i + 1 == n or !eq(first[i].a, first[i + 1].a) ) ++m;
+    if ( m == 0 ) return;
+
+    const __tree_store::bulk_plan lp(m, __tree_store::bulk_target(fill, MAXK, MINK), MINK);
+    __arena.reserve(lp.nodes + lp.nodes / (T - 1) + 2);
+
+    node_idx lo = nil;
+    node_idx prev = nil;
+    usize i = 0;
+    for ( usize j = 0; j < lp.nodes; ++j ) {
+      const node_idx li = alloc_leaf();
+      if ( j == 0 ) lo = li;
+      const usize c = lp.size(j);
+      leaf_node &L = lnode(li);
+      while ( L.count < c ) {
+        while ( i + 1 < n and eq(first[i].a, first[i + 1].a) ) ++i;
+        new (micron::addr(L.keys()[L.count])) K(first[i].a);
+        new (micron::addr(L.vals()[L.count])) V(first[i].b);
+        ++L.count;
+        ++i;
+      }
+      L.prev = prev;
+      if ( prev != nil ) lnode(prev).next = li;
+      prev = li;
+    }
+    __root = lo;
+    __size = m;
+
+    usize count = lp.nodes;
+    while ( count > 1 ) {
+      const __tree_store::bulk_plan ip(count, __tree_store::bulk_target(fill, MAXC, T), T);
+      node_idx kid = lo;
+      for ( usize j = 0; j < ip.nodes; ++j ) {
+        const node_idx ni = alloc_internal();
+        if ( j == 0 ) lo = ni;
+        const usize c = ip.size(j);
+        inode(ni).kids[0] = kid++;
+        for ( usize k = 1; k < c; ++k, ++kid ) {
+          internal_node &I = inode(ni);
+          new (micron::addr(I.keys()[I.nkeys])) K(lnode(leftmost_leaf(kid)).keys()[0]);      // separator: first key right of it
+          I.kids[k] = kid;
+          ++I.nkeys;
+        }
+      }
+      count = ip.nodes;
+      __root = lo;
+    }
+  }
+
 public:
   using category_type = tree_tag;
   using mutability_type = mutable_tag;
@@ -462,6 +521,30 @@ public:
     build(*this);
   }
 
+  // bulk load from entries in ascending key order, anything exposing .a (key) and .b (value) such as micron::pair<K, V>
+  // builds bottom-up in O(n) with no splits and no per-key descent; fill in (0, 1] sets leaf and inner occupancy (1 packs them full,
+  // lower leaves room for later inserts without immediate splits). entries are copied, equal neighbouring keys keep the last
+  // NOTE: ordering is the caller's contract and is not checked, sort first (parallel::sort::sort / sort::sort) if in doubt
+  template<typename It>
+  static b_tree
+  from_sorted(It first, It last, f32 fill = 1.0f)
+  {
+    b_tree t;
+    t.bulk_build(first, static_cast<usize>(last - first), fill);
+    return t;
+  }
+
+  template<typename R>
+    requires requires(const R &r) {
+      r.begin();
+      r.end();
+    }
+  static b_tree
+  from_sorted(const R &r, f32 fill = 1.0f)
+  {
+    return from_sorted(r.begin(), r.end(), fill);
+  }
+
   b_tree(const b_tree &) = delete;
   b_tree &operator=(const b_tree &) = delete;
 
@@ -751,12 +834,12 @@ public:
   {
     if constexpr ( micron::is_invocable_v<Fn, const K &, const V &> ) {
       using V2 = micron::remove_cvref_t<micron::invoke_result_t<Fn, const K &, const V &>>;
-      b_tree<K, V2, Compare, DegreeOverride> out;
+      b_tree<K, V2, Compare, DegreeOverride, Alloc> out;
       for_each([&](const K &k, const V &v) { out.insert(k, fn(k, v)); });
       return out;
     } else {
       using V2 = micron::remove_cvref_t<micron::invoke_result_t<Fn, const V &>>;
-      b_tree<K, V2, Compare, DegreeOverride> out;
+      b_tree<K, V2, Compare, DegreeOverride, Alloc> out;
       for_each([&](const K &k, const V &v) { out.insert(k, fn(v)); });
       return out;
     }
@@ -0,0 +1,799 @@
+//  Copyright (c) 2024- David Lucius Severus
+//
+//  Distributed under the Boost Software License, Version 1.0.
+//  See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt
+#pragma once
+
+#include "../atomic/atomic.hpp"
+#include "../bits/__pause.hpp"
+#include "../except.hpp"
+#include "../memory/new.hpp"
+#include "../mutex/epoch.hpp"
+#include "../tags.hpp"
+#include "../type_traits.hpp"
+#include "../types.hpp"
+
+#include "b.hpp"
+
+namespace micron
+{
+
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+// micron::olc_b_tree
+// concurrent B+-tree with optimistic lock coupling, the thread-safe sibling of b_tree
+//
+// every node carries a version word: bit 0 obsolete, bit 1 write-locked, the counter above. readers never write shared memory, they
+// read a node's version, read the node, and re-check the version before trusting what they saw (restarting from the root on a
+// mismatch). writers lock only the nodes they modify by CAS-upgrading the version they read, full nodes are split eagerly on the way
+// down so a split never has to climb back up
+//
+// range scans walk the leaf chain, validating each leaf before emitting it; on a conflict they restart from the last key emitted
+// erase removes the entry and unlinks a leaf it empties, relinking the leaf before it in the chain; a parent's first child instead
+// takes over its right sibling's entries when that is a leaf, and drops the sibling. an inner node left with a single child is spliced
+// out of its parent (the root collapses the same way), so a sliding window of keys doesn't leave a trail of empty nodes behind it.
+// unlinked nodes go to an epoch_domain and are freed once no pinned reader can still hold them. all of it is best effort, contention
+// just leaves the node in place; inner nodes are never merged with their siblings, and leaves can sit at uneven depths
+//
+// NOTE: K and V must be trivially copyable, readers copy them optimistically and a torn copy is simply discarded
+// THREAD SAFETY: every public op is thread-safe except move and destruction
+template<typename K, typename V, typename Compare = b_default_less<K>, usize NodeBytes = 512>
+  requires(micron::is_trivially_copyable_v<K> and micron::is_trivially_copyable_v<V> and NodeBytes >= 128)
+class olc_b_tree
+{
+  static constexpr u64 __obsolete = 1;
+  static constexpr u64 __locked = 2;
+
+  struct __node {
+    u64 version;
+    u16 count;
+    u8 leaf;
+  };
+
+  // inner: count separator keys, count + 1 children; child i holds keys <= keys[i]
+  static constexpr usize __ik_auto = (NodeBytes - sizeof(__node) - sizeof(void *)) / (sizeof(K) + sizeof(void *));
+  static constexpr u16 __ik = static_cast<u16>(__ik_auto < 3 ? 3 : __ik_auto);
+  static constexpr usize __lk_auto = (NodeBytes - sizeof(__node) - sizeof(void *)) / (sizeof(K) + sizeof(V));
+  static constexpr u16 __lk = static_cast<u16>(__lk_auto < 4 ? 4 : __lk_auto);
+
+  struct __inner : __node {
+    alignas(K) byte keys_raw[sizeof(K) * __ik];
+    __node *kids[__ik + 1];
+
+    K *
+    keys() noexcept
+    {
+      return reinterpret_cast<K *>(keys_raw);
+    }
+  };
+
+  struct __leaf : __node {
+    __leaf *next;
+    alignas(K) byte keys_raw[sizeof(K) * __lk];
+    alignas(V) byte vals_raw[sizeof(V) * __lk];
+
+    K *
+    keys() noexcept
+    {
+      return reinterpret_cast<K *>(keys_raw);
+    }
+
+    V *
+    vals() noexcept
+    {
+      return reinterpret_cast<V *>(vals_raw);
+    }
+  };
+
+  __node *__root;
+  u64 __size;
+  mutable epoch_domain<> __epoch;
+
+  static __leaf *
+  __new_leaf()
+  {
+    __leaf *l = new __leaf();
+    l->leaf = 1;
+    l->next = nullptr;
+    return l;
+  }
+
+  static __inner *
+  __new_inner()
+  {
+    __inner *i = new __inner();
+    i->leaf = 0;
+    return i;
+  }
+
+  static void
+  __free_leaf(void *p)
+  {
+    delete static_cast<__leaf *>(p);
+  }
+
+  static void
+  __free_inner(void *p)
+  {
+    delete static_cast<__inner *>(p);
+  }
+
+  static void
+  __free_subtree(__node *n) noexcept
+  {
+    if ( n->leaf ) {
+      delete static_cast<__leaf *>(n);
+      return;
+    }
+    __inner *in = static_cast<__inner *>(n);
+    for ( u16 i = 0; i <= in->count; ++i ) __free_subtree(in->kids[i]);
+    delete in;
+  }
+
+  static usize
+  __nodes(const __node *n) noexcept
+  {
+    if ( n->leaf ) return 1;
+    const __inner *in = static_cast<const __inner *>(n);
+    usize c = 1;
+    for ( u16 i = 0; i <= in->count; ++i ) c += __nodes(in->kids[i]);
+    return c;
+  }
+
+  static bool
+  __eq(const K &a, const K &b)
+  {
+    return !Compare::lt(a, b) && !Compare::lt(b, a);
+  }
+
+  // first index whose key is not less than k
+  static u16
+  __lower(const K *keys, u16 n, const K &k)
+  {
+    u16 lo = 0, hi = n;
+    while ( lo < hi ) {
+      const u16 m = static_cast<u16>((lo + hi) >> 1);
+      if ( Compare::lt(keys[m], k) )
+        lo = static_cast<u16>(m + 1);
+      else
+        hi = m;
+    }
+    return lo;
+  }
+
+  // optimistic count, clamped so a torn read can't index past the arrays
+  [[gnu::always_inline]] static u16
+  __count(const __node *n, u16 cap) noexcept
+  {
+    const u16 c = atom::load(&n->count, __ATOMIC_RELAXED);
+    return c > cap ? cap : c;
+  }
+
+  // ── version protocol ─────────────────────────────────────────────────────
+
+  static u64
+  __read_lock(const __node *n, bool &restart) noexcept
+  {
+    u64 v = atom::load(&n->version, __ATOMIC_ACQUIRE);
+    while ( v & __locked ) {
+      __cpu_pause();
+      v = atom::load(&n->version, __ATOMIC_ACQUIRE);
+    }
+    if ( v & __obsolete ) restart = true;
+    return v;
+  }
+
+  static void
+  __check(const __node *n, u64 v, bool &restart) noexcept
+  {
+    atom::thread_fence(__ATOMIC_ACQUIRE);
+    if ( atom::load(&n->version, __ATOMIC_RELAXED) != v ) restart = true;
+  }
+
+  static void
+  __upgrade(__node *n, u64 v, bool &restart) noexcept
+  {
+    u64 expect = v;
+    if ( !atom::compare_exchange(&n->version, &expect, v + __locked, false, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED) ) {
+      restart = true;
+      return;
+    }
+    atom::thread_fence(__ATOMIC_RELEASE);
+  }
+
+  // write lock without waiting, false if n is locked, obsolete or changes under us
+  static bool
+  __try_lock(__node *n) noexcept
+  {
+    const u64 v = atom::load(&n->version, __ATOMIC_ACQUIRE);
+    if ( v & (__locked | __obsolete) ) return false;
+    bool rs = false;
+    __upgrade(n, v, rs);
+    return !rs;
+  }
+
+  static void
+  __unlock(__node *n) noexcept
+  {
+    atom::fetch_add(&n->version, __locked, __ATOMIC_RELEASE);
+  }
+
+  static void
+  __unlock_obsolete(__node *n) noexcept
+  {
+    atom::fetch_add(&n->version, __locked + __obsolete, __ATOMIC_RELEASE);
+  }
+
+  // ── structural edits, callers hold the write locks ──────────────────────
+
+  static __inner *
+  __split_inner(__inner *in, K &sep)
+  {
+    __inner *r = __new_inner();
+    const u16 n = in->count;
+    const u16 rc = static_cast<u16>(n - n / 2);
+    const u16 lc = static_cast<u16>(n - rc - 1);
+    for ( u16 i = 0; i < rc; ++i ) r->keys()[i] = in->keys()[lc + 1 + i];
+    for ( u16 i = 0; i <= rc; ++i ) r->kids[i] = in->kids[lc + 1 + i];
+    r->count = rc;
+    sep = in->keys()[lc];
+    atom::store(&in->count, lc, __ATOMIC_RELAXED);
+    return r;
+  }
+
+  static __leaf *
+  __split_leaf(__leaf *l, K &sep)
+  {
+    __leaf *r = __new_leaf();
+    const u16 n = l->count;
+    const u16 rc = static_cast<u16>(n - n / 2);
+    const u16 lc = static_cast<u16>(n - rc);
+    for ( u16 i = 0; i < rc; ++i ) {
+      r->keys()[i] = l->keys()[lc + i];
+      r->vals()[i] = l->vals()[lc + i];
+    }
+    r->count = rc;
+    r->next = l->next;
+    atom::store(&l->next, r, __ATOMIC_RELAXED);
+    atom::store(&l->count, lc, __ATOMIC_RELAXED);
+    sep = l->keys()[lc - 1];
+    return r;
+  }
+
+  // right lands just after the child that was split
+  static void
+  __inner_insert(__inner *p, const K &sep, __node *right)
+  {
+    const u16 n = p->count;
+    const u16 pos = __lower(p->keys(), n, sep);
+    for ( u16 i = n; i > pos; --i ) p->keys()[i] = p->keys()[i - 1];
+    for ( u16 i = static_cast<u16>(n + 1); i > pos + 1; --i ) p->kids[i] = p->kids[i - 1];
+    p->keys()[pos] = sep;
+    p->kids[pos + 1] = right;
+    atom::store(&p->count, static_cast<u16>(n + 1), __ATOMIC_RELAXED);
+  }
+
+  // drops child ci and the separator to its left (the first child takes its right one along), count > 0
+  static void
+  __inner_remove(__inner *p, u16 ci)
+  {
+    const u16 n = p->count;
+    for ( u16 i = ci ? static_cast<u16>(ci - 1) : u16{ 0 }; i + 1 < n; ++i ) p->keys()[i] = p->keys()[i + 1];
+    for ( u16 i = ci; i < n; ++i ) p->kids[i] = p->kids[i + 1];
+    atom::store(&p->count, static_cast<u16>(n - 1), __ATOMIC_RELAXED);
+  }
+
+  void
+  __make_root(const K &sep, __node *left, __node *right)
+  {
+    __inner *r = __new_inner();
+    r->count = 1;
+    r->keys()[0] = sep;
+    r->kids[0] = left;
+    r->kids[1] = right;
+    atom::store(&__root, static_cast<__node *>(r), __ATOMIC_RELEASE);
+  }
+
+  // ── traversal ────────────────────────────────────────────────────────────
+
+  struct __path {
+    __leaf *leaf;
+    u64 vl;
+    __inner *parent;
+    u64 vp;
+    u16 ci;      // leaf's index in parent
+    __inner *gp;
+    u64 vgp;
+    u16 pci;         // parent's index in gp
+    bool first;      // every index on the way down was 0, leaf is the head of the chain
+  };
+
+  // optimistic descent to the leaf covering *key (leftmost leaf when key is null); false means restart
+  bool
+  __descend(const K *key, __path &p) const noexcept
+  {
+    bool rs = false;
+    __node *node = atom::load(&__root, __ATOMIC_ACQUIRE);
+    u64 vn = __read_lock(node, rs);
+    if ( rs or node != atom::load(&__root, __ATOMIC_ACQUIRE) ) return false;
+    __inner *parent = nullptr, *gp = nullptr;
+    u64 vp = 0, vgp = 0;
+    u16 ci = 0, pci = 0;
+    bool first = true;
+    while ( !node->leaf ) {
+      __inner *in = static_cast<__inner *>(node);
+      if ( parent ) {
+        __check(parent, vp, rs);
+        if ( rs ) return false;
+      }
+      gp = parent;
+      vgp = vp;
+      pci = ci;
+      parent = in;
+      vp = vn;
+      ci = key ? __lower(in->keys(), __count(in, __ik), *key) : 0;
+      first = first and ci == 0;
+      node = in->kids[ci];
+      __check(in, vn, rs);
+      if ( rs ) return false;
+      vn = __read_lock(node, rs);
+      if ( rs ) return false;
+    }
+    p = __path{ static_cast<__leaf *>(node), vn, parent, vp, ci, gp, vgp, pci, first };
+    return true;
+  }
+
+  // rightmost leaf under n, optimistically and without waiting; null on a conflict. the caller locks it and checks where it links
+  static __leaf *
+  __last_leaf(__node *n) noexcept
+  {
+    bool rs = false;
+    while ( !n->leaf ) {
+      __inner *in = static_cast<__inner *>(n);
+      const u64 v = atom::load(&in->version, __ATOMIC_ACQUIRE);
+      if ( v & (__locked | __obsolete) ) return nullptr;
+      n = in->kids[__count(in, __ik)];
+      __check(in, v, rs);
+      if ( rs ) return nullptr;
+    }
+    return static_cast<__leaf *>(n);
+  }
+
+  // par is write locked and down to one child: points its parent (or the root) straight at that child and retires it. unlocks par
+  void
+  __splice_inner(__inner *par, __inner *gp, u64 vgp, u16 pci)
+  {
+    __node *only = par->kids[0];
+    if ( gp ) {
+      bool rs = false;
+      __upgrade(gp, vgp, rs);
+      if ( rs ) {
+        __unlock(par);
+        return;
+      }
+      gp->kids[pci] = only;
+      __unlock(gp);
+    } else {
+      // the root only changes under its own write lock, which is ours
+      if ( atom::load(&__root, __ATOMIC_ACQUIRE) != par ) {
+        __unlock(par);
+        return;
+      }
+      atom::store(&__root, only, __ATOMIC_RELEASE);
+    }
+    __unlock_obsolete(par);
+    __epoch.retire(par, &__free_inner);
+  }
+
+  // the leaf before p.leaf in the chain, found without waiting; null on a conflict or when it isn't under p's parent or grandparent
+  static __leaf *
+  __before(const __path &p) noexcept
+  {
+    if ( p.ci > 0 ) return __last_leaf(p.parent->kids[p.ci - 1]);
+    if ( p.gp == nullptr or p.pci == 0 ) return nullptr;
+    __node *n = p.gp->kids[p.pci - 1];
+    if ( atom::load(&p.gp->version, __ATOMIC_ACQUIRE) != p.vgp ) return nullptr;
+    return __last_leaf(n);
+  }
+
+  // p.leaf is write locked and empty. a first child whose right sibling is a leaf takes over that sibling's entries and drops it
+  // instead, which needs nothing outside the parent. otherwise the leaf itself is dropped and the leaf before it in the chain
+  // relinked past it; that one is only ever looked for under the parent and grandparent (the head of the chain has none), anywhere
+  // else the leaf stays. a leaf can only gain a new predecessor by that predecessor splitting, so holding both locked and seeing it
+  // still link here is enough. unlocks p.leaf
+  void
+  __unlink_leaf(const __path &p)
+  {
+    __leaf *lf = p.leaf;
+    __inner *par = p.parent;
+    bool rs = false;
+    __upgrade(par, p.vp, rs);
+    if ( rs ) {
+      __unlock(lf);
+      return;
+    }
+    if ( par->count == 0 ) {
+      __unlock(par);
+      __unlock(lf);
+      return;
+    }
+    if ( p.ci == 0 and par->kids[1]->leaf ) {
+      __leaf *right = static_cast<__leaf *>(par->kids[1]);
+      if ( !__try_lock(right) ) {
+        __unlock(par);
+        __unlock(lf);
+        return;
+      }
+      const u16 rc = right->count;
+      for ( u16 i = 0; i < rc; ++i ) {
+        lf->keys()[i] = right->keys()[i];
+        lf->vals()[i] = right->vals()[i];
+      }
+      atom::store(&lf->next, right->next, __ATOMIC_RELAXED);
+      atom::store(&lf->count, rc, __ATOMIC_RELAXED);
+      __inner_remove(par, 1);
+      __unlock(lf);
+      __unlock_obsolete(right);
+      __epoch.retire(right, &__free_leaf);
+    } else {
+      __leaf *prev = p.first ? nullptr : __before(p);
+      if ( !p.first and (prev == nullptr or !__try_lock(prev)) ) {
+        __unlock(par);
+        __unlock(lf);
+        return;
+      }
+      if ( prev ) {
+        if ( atom::load(&prev->next, __ATOMIC_RELAXED) != lf ) {
+          __unlock(prev);
+          __unlock(par);
+          __unlock(lf);
+          return;
+        }
+        atom::store(&prev->next, lf->next, __ATOMIC_RELAXED);
+      }
+      __inner_remove(par, p.ci);
+      if ( prev ) __unlock(prev);
+      __unlock_obsolete(lf);
+      __epoch.retire(lf, &__free_leaf);
+    }
+    if ( par->count == 0 )
+      __splice_inner(par, p.gp, p.vgp, p.pci);
+    else
+      __unlock(par);
+  }
+
+  // 1 inserted, 0 key already present (assigned when overwrite)
+  int
+  __put(const K &k, const V &v, bool overwrite)
+  {
+    epoch_domain<>::guard __g(__epoch);
+    for ( ;; ) {
+      bool rs = false;
+      __node *node = atom::load(&__root, __ATOMIC_ACQUIRE);
+      u64 vn = __read_lock(node, rs);
+      if ( rs or node != atom::load(&__root, __ATOMIC_ACQUIRE) ) continue;
+      __inner *parent = nullptr;
+      u64 vp = 0;
+
+      while ( !node->leaf ) {
+        __inner *in = static_cast<__inner *>(node);
+        if ( __count(in, __ik) == __ik ) {
+          // full inner node: split now, while the parent is known to have room, then retry from the root
+          if ( parent ) {
+            __upgrade(parent, vp, rs);
+            if ( rs ) break;
+          }
+          __upgrade(node, vn, rs);
+          if ( rs ) {
+            if ( parent ) __unlock(parent);
+            break;
+          }
+          if ( !parent and node != atom::load(&__root, __ATOMIC_ACQUIRE) ) {
+            __unlock(node);
+            rs = true;
+            break;
+          }
+          K sep;
+          __inner *right = __split_inner(in, sep);
+          if ( parent )
+            __inner_insert(parent, sep, right);
+          else
+            __make_root(sep, node, right);
+          __unlock(node);
+          if ( parent ) __unlock(parent);
+          rs = true;
+          break;
+        }
+        if ( parent ) {
+          __check(parent, vp, rs);
+          if ( rs ) break;
+        }
+        parent = in;
+        vp = vn;
+        node = in->kids[__lower(in->keys(), __count(in, __ik), k)];
+        __check(in, vn, rs);
+        if ( rs ) break;
+        vn = __read_lock(node, rs);
+        if ( rs ) break;
+      }
+      if ( rs ) continue;
+
+      __leaf *lf = static_cast<__leaf *>(node);
+      if ( __count(lf, __lk) == __lk ) {
+        if ( parent ) {
+          __upgrade(parent, vp, rs);
+          if ( rs ) continue;
+        }
+        __upgrade(node, vn, rs);
+        if ( rs ) {
+          if ( parent ) __unlock(parent);
+          continue;
+        }
+        if ( !parent and node != atom::load(&__root, __ATOMIC_ACQUIRE) ) {
+          __unlock(node);
+          continue;
+        }
+        K sep;
+        __leaf *right = __split_leaf(lf, sep);
+        if ( parent )
+          __inner_insert(parent, sep, right);
+        else
+          __make_root(sep, node, right);
+        __unlock(node);
+        if ( parent ) __unlock(parent);
+        continue;
+      }
+
+      __upgrade(node, vn, rs);
+      if ( rs ) continue;
+      if ( parent ) {
+        // the leaf may have split between reading the child pointer and reading its version
+        __check(parent, vp, rs);
+        if ( rs ) {
+          __unlock(node);
+          continue;
+        }
+      }
+      const u16 n = lf->count;
+      const u16 pos = __lower(lf->keys(), n, k);
+      int r = 0;
+      if ( pos < n and __eq(lf->keys()[pos], k) ) {
+        if ( overwrite ) lf->vals()[pos] = v;
+      } else {
+        for ( u16 i = n; i > pos; --i ) {
+          lf->keys()[i] = lf->keys()[i - 1];
+          lf->vals()[i] = lf->vals()[i - 1];
+        }
+        lf->keys()[pos] = k;
+        lf->vals()[pos] = v;
+        atom::store(&lf->count, static_cast<u16>(n + 1), __ATOMIC_RELAXED);
+        r = 1;
+      }
+      __unlock(node);
+      if ( r ) atom::fetch_add(&__size, u64{ 1 }, __ATOMIC_RELAXED);
+      return r;
+    }
+  }
+
+  // walks leaves from the one covering *lo (or the leftmost), fn(k, v) gets validated copies of keys in [lo, hi), at most max of them
+  template<typename Fn>
+  usize
+  __scan(const K *lo, const K *hi, usize max, Fn &fn) const
+  {
+    epoch_domain<>::guard __g(__epoch);
+    alignas(K) byte kb[sizeof(K) * __lk];
+    alignas(V) byte vb[sizeof(V) * __lk];
+    K *ks = reinterpret_cast<K *>(kb);
+    V *vs = reinterpret_cast<V *>(vb);
+    alignas(K) byte lastb[sizeof(K)];
+    K *last = reinterpret_cast<K *>(lastb);
+    bool have_last = false;
+    usize emitted = 0;
+    if ( max == 0 ) return 0;
+
+    for ( ;; ) {
+      __path p;
+      const K *from = have_last ? last : lo;
+      if ( !__descend(from, p) ) continue;
+      __leaf *lf = p.leaf;
+      u64 vl = p.vl;
+      bool first = true;
+      bool rs = false;
+      for ( ;; ) {
+        const u16 n = __count(lf, __lk);
+        u16 pos = from ? __lower(lf->keys(), n, *from) : 0;
+        while ( have_last and pos < n and !Compare::lt(*last, lf->keys()[pos]) ) ++pos;
+        u16 m = 0;
+        for ( u16 i = pos; i < n; ++i, ++m ) {
+          ks[m] = lf->keys()[i];
+          vs[m] = lf->vals()[i];
+        }
+        __leaf *nxt = atom::load(&lf->next, __ATOMIC_RELAXED);
+        __check(lf, vl, rs);
+        if ( first and !rs and p.parent ) __check(p.parent, p.vp, rs);      // a split may have moved *from to the right
+        if ( rs ) break;
+        first = false;
+        for ( u16 i = 0; i < m; ++i ) {
+          if ( hi and !Compare::lt(ks[i], *hi) ) return emitted;
+          fn(static_cast<const K &>(ks[i]), static_cast<const V &>(vs[i]));
+          *last = ks[i];
+          have_last = true;
+          if ( ++emitted == max ) return emitted;
+        }
+        if ( !nxt ) return emitted;
+        vl = __read_lock(nxt, rs);
+        if ( rs ) break;
+        lf = nxt;
+        from = have_last ? last : lo;
+      }
+    }
+  }
+
+public:
+  using category_type = tree_tag;
+  using mutability_type = mutable_tag;
+  using memory_type = heap_tag;
+  using key_type = K;
+  using mapped_type = V;
+  using size_type = usize;
+
+  ~olc_b_tree()
+  {
+    if ( __root ) __free_subtree(__root);
+  }
+
+  olc_b_tree() : __root(__new_leaf()), __size(0) { }
+
+  olc_b_tree(const olc_b_tree &) = delete;
+  olc_b_tree &operator=(const olc_b_tree &) = delete;
+  olc_b_tree(olc_b_tree &&) = delete;
+  olc_b_tree &operator=(olc_b_tree &&) = delete;
+
+  usize
+  size() const noexcept
+  {
+    return static_cast<usize>(atom::load(&__size, __ATOMIC_RELAXED));
+  }
+
+  bool
+  empty() const noexcept
+  {
+    return size() == 0;
+  }
+
+  bool
+  find(const K &k, V &out) const
+  {
+    epoch_domain<>::guard __g(__epoch);
+    for ( ;; ) {
+      __path p;
+      if ( !__descend(&k, p) ) continue;
+      bool rs = false;
+      const u16 n = __count(p.leaf, __lk);
+      const u16 pos = __lower(p.leaf->keys(), n, k);
+      const bool hit = pos < n and __eq(p.leaf->keys()[pos], k);
+      V tmp;
+      if ( hit ) tmp = p.leaf->vals()[pos];
+      if ( p.parent ) __check(p.parent, p.vp, rs);
+      __check(p.leaf, p.vl, rs);
+      if ( rs ) continue;
+      if ( hit ) out = tmp;
+      return hit;
+    }
+  }
+
+  bool
+  contains(const K &k) const
+  {
+    V tmp;
+    return find(k, tmp);
+  }
+
+  usize
+  count(const K &k) const
+  {
+    return contains(k) ? 1 : 0;
+  }
+
+  V
+  at(const K &k) const
+  {
+    V out;
+    if ( !find(k, out) ) [[unlikely]]
+      exc<except::library_error>("micron olc_b_tree::at(): key not found");
+    return out;
+  }
+
+  // true when inserted, false when the key was already present (value untouched)
+  bool
+  insert(const K &k, const V &v)
+  {
+    return __put(k, v, false) == 1;
+  }
+
+  // true when inserted, false when an existing value was overwritten
+  bool
+  insert_or_assign(const K &k, const V &v)
+  {
+    return __put(k, v, true) == 1;
+  }
+
+  bool
+  erase(const K &k)
+  {
+    epoch_domain<>::guard __g(__epoch);
+    for ( ;; ) {
+      __path p;
+      if ( !__descend(&k, p) ) continue;
+      bool rs = false;
+      __leaf *lf = p.leaf;
+      __upgrade(lf, p.vl, rs);
+      if ( rs ) continue;
+      if ( p.parent ) {
+        __check(p.parent, p.vp, rs);
+        if ( rs ) {
+          __unlock(lf);
+          continue;
+        }
+      }
+      const u16 n = lf->count;
+      const u16 pos = __lower(lf->keys(), n, k);
+      if ( pos >= n or !__eq(lf->keys()[pos], k) ) {
+        __unlock(lf);
+        return false;
+      }
+      for ( u16 i = pos; i + 1 < n; ++i ) {
+        lf->keys()[i] = lf->keys()[i + 1];
+        lf->vals()[i] = lf->vals()[i + 1];
+      }
+      atom::store(&lf->count, static_cast<u16>(n - 1), __ATOMIC_RELAXED);
+      atom::fetch_sub(&__size, u64{ 1 }, __ATOMIC_RELAXED);
+
+      // best effort unlink of a now empty leaf; any contention just leaves it in place
+      if ( n == 1 and p.parent )
+        __unlink_leaf(p);
+      else
+        __unlock(lf);
+      return true;
+    }
+  }
+
+  // fn(k, v) over keys in [lo, hi) in order; returns how many were visited
+  template<typename Fn>
+  usize
+  range(const K &lo, const K &hi, Fn &&fn) const
+  {
+    return __scan(&lo, &hi, static_cast<usize>(-1), fn);
+  }
+
+  // fn(k, v) over at most max keys starting at the first key >= lo
+  template<typename Fn>
+  usize
+  scan(const K &lo, usize max, Fn &&fn) const
+  {
+    return __scan(&lo, nullptr, max, fn);
+  }
+
+  template<typename Fn>
+  usize
+  for_each(Fn &&fn) const
+  {
+    return __scan(nullptr, nullptr, static_cast<usize>(-1), fn);
+  }
+
+  // leaves plus inner nodes reachable from the root; walks the whole tree unsynchronised, call it while no writer runs
+  usize
+  nodes() const noexcept
+  {
+    return __nodes(atom::load(&__root, __ATOMIC_ACQUIRE));
+  }
+
+  // frees retired nodes that no reader can reach any more; erase does this on its own periodically
+  void
+  reclaim()
+  {
+    __epoch.collect();
+  }
+};
+
+};      // namespace micron
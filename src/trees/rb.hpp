@@ -5,6 +5,7 @@
 //  http://www.boost.org/LICENSE_1_0.txt
 #pragma once
 
+#include "../allocator.hpp"
 #include "../except.hpp"
 #include "../memory/addr.hpp"
 #include "../memory/new.hpp"
@@ -175,7 +176,8 @@ template<typename T> struct default_less {
   }
 };
 
-template<typename T, typename Less = default_less<T>>
+// Alloc = void keeps nodes on the global heap, otherwise each node is one Alloc::create (pool_allocator, monotonic_allocator)
+template<typename T, typename Less = default_less<T>, class Alloc = void>
   requires micron::is_copy_constructible_v<T> && micron::is_move_constructible_v<T>
 class rb_tree
 {
@@ -192,13 +194,21 @@ private:
   static node *
   make_node(Args &&...args)
   {
-    return new node(T(micron::forward<Args>(args)...));
+    if constexpr ( micron::is_void_v<Alloc> )
+      return new node(T(micron::forward<Args>(args)...));
+    else
+      return new (Alloc::create(sizeof(node)).ptr) node(T(micron::forward<Args>(args)...));
   }
 
   static void
   destroy_node(node *p)
   {
-    delete p;
+    if constexpr ( micron::is_void_v<Alloc> )
+      delete p;
+    else {
+      p->~node();
+      Alloc::destroy(chunk<byte>{ reinterpret_cast<byte *>(p), sizeof(node) });
+    }
   }
 
   static node *
@@ -399,7 +409,7 @@ private:
   clone_subtree(node *src, node *parent)
   {
     if ( !src ) return nullptr;
-    node *n = new node(src->data);
+    node *n = make_node(src->data);
     n->color = src->color;
     n->parent = parent;
     n->kind = src->kind;
@@ -941,7 +951,7 @@ public:
   map(Fn fn) const
   {
     using U = micron::remove_cvref_t<micron::invoke_result_t<Fn, const T &>>;
-    rb_tree<U> out;
+    rb_tree<U, default_less<U>, Alloc> out;
     for_each([&](const T &e) { out.insert(fn(e)); });
     return out;
   }
@@ -671,6 +671,132 @@ private:
     return false;
   }
 
+  // ── bulk loading ─────────────────────────────────────────────────────────
+
+  // a packed node as seen by the level above it
+  struct bulk_node {
+    box_type box;
+    node_idx idx;
+  };
+
+  struct hilbert_ref {
+    u64 key;
+    usize pos;
+  };
+
+  template<typename E>
+  static F
+  center(const E &e, usize d) noexcept
+  {
+    return (e.box.min_corner.data[d] + e.box.max_corner.data[d]) * F(0.5);
+  }
+
+  // smallest s with s^k >= p
+  static usize
+  iroot(usize p, usize k) noexcept
+  {
+    for ( usize s = 1;; ++s ) {
+      usize v = 1;
+      for ( usize i = 0; i < k and v < p; ++i ) v *= s;
+      if ( v >= p ) return s;
+    }
+  }
+
+  // Sort-Tile-Recursive: order by centre along d, cut into slabs of whole nodes, recurse into every slab on the next axis
+  template<typename E, typename Sort>
+  static void
+  str_tile(E *items, usize n, usize d, usize per, Sort &sort)
+  {
+    sort(items, items + n, [d](const E &a, const E &b) { return center(a, d) < center(b, d); });
+    if ( d + 1 == Dim ) return;
+    const usize pages = (n + per - 1) / per;
+    const usize slabs = iroot(pages, Dim - d);
+    const usize slab = ((pages + slabs - 1) / slabs) * per;
+    for ( usize s = 0; s < n; s += slab ) str_tile(items + s, (n - s < slab) ? n - s : slab, d + 1, per, sort);
+  }
+
+  // Skilling's transform: grid coordinates to the transposed Hilbert index, interleaved into one key, most significant plane first
+  static u64
+  hilbert_key(u32 *x, u32 bits) noexcept
+  {
+    const u32 m = 1u << (bits - 1);
+    for ( u32 q = m; q > 1; q >>= 1 ) {
+      const u32 p = q - 1;
+      for ( usize i = 0; i < Dim; ++i ) {
+        if ( x[i] & q ) {
+          x[0] ^= p;
+        } else {
+          const u32 t = (x[0] ^ x[i]) & p;
+          x[0] ^= t;
+          x[i] ^= t;
+        }
+      }
+    }
+    for ( usize i = 1; i < Dim; ++i ) x[i] ^= x[i - 1];
+    u32 t = 0;
+    for ( u32 q = m; q > 1; q >>= 1 )
+      if ( x[Dim - 1] & q ) t ^= q - 1;
+    for ( usize i = 0; i < Dim; ++i ) x[i] ^= t;
+    u64 key = 0;
+    for ( u32 b = bits; b-- > 0; )
+      for ( usize i = 0; i < Dim; ++i ) key = (key << 1) | ((x[i] >> b) & 1u);
+    return key;
+  }
+
+  // leaves over consecutive runs of at(i), values are moved out of the input
+  template<typename At>
+  void
+  pack_leaves(usize n, usize per, At at, fvector<bulk_node> &out)
+  {
+    const __tree_store::bulk_plan lp(n, per, __minf);
+    usize i = 0;
+    for ( usize j = 0; j < lp.nodes; ++j ) {
+      const node_idx li = alloc_leaf();
+      const usize c = lp.size(j);
+      leaf_node &L = lnode(li);
+      for ( usize k = 0; k < c; ++k, ++i ) {
+        auto &e = at(i);
+        L.mbr[k] = e.box;
+        new (micron::addr(L.vals()[k])) Value(micron::move(e.value));
+        ++L.count;
+      }
+      out.push_back(bulk_node{ subtree_mbr(li), li });
+    }
+  }
+
+  void
+  pack_inner(const bulk_node *kids, usize n, usize per, fvector<bulk_node> &out)
+  {
+    const __tree_store::bulk_plan ip(n, per, __minf);
+    usize i = 0;
+    for ( usize j = 0; j < ip.nodes; ++j ) {
+      const node_idx ni = alloc_internal();
+      const usize c = ip.size(j);
+      internal_node &I = inode(ni);
+      for ( usize k = 0; k < c; ++k, ++i ) {
+        I.mbr[k] = kids[i].box;
+        I.kids[k] = kids[i].idx;
+        ++I.count;
+      }
+      out.push_back(bulk_node{ subtree_mbr(ni), ni });
+    }
+  }
+
+  // levels above the leaves; retile(nodes, n, per) reorders each level before it is packed
+  template<typename Retile>
+  void
+  pack_upper(fvector<bulk_node> *lv, usize per, Retile retile)
+  {
+    u32 c = 0;
+    while ( lv[c].size() > 1 ) {
+      retile(&lv[c][0], lv[c].size(), per);
+      lv[c ^ 1u].clear();
+      pack_inner(&lv[c][0], lv[c].size(), per, lv[c ^ 1u]);
+      c ^= 1u;
+    }
+    __root = lv[c][0].idx;
+  }
+
 public:
   using category_type = tree_tag;
   using mutability_type = mutable_tag;
@@ -758,6 +884,99 @@ public:
     insert(b, v);
   }
 
+  // bulk loading input
+  struct entry {
+    box_type box;
+    Value value;
+  };
+
+  // Sort-Tile-Recursive packing: replaces the contents with the n items, built bottom-up level by level with no R* split or reinsert
+  // work; every level is retiled so sibling nodes cover compact, barely overlapping regions. items are reordered in place and their
+  // values moved from. fill in (0, 1] sets node occupancy, 1 packs full nodes
+  // sort is any callable sort(first, last, cmp) over a pointer range, parallel::bulk_sort runs the sort phase on the coroutine engine
+  template<typename Sort = __tree_store::serial_sort>
+  void
+  pack_str(entry *items, usize n, f32 fill = 1.0f, Sort sort = Sort{})
+  {
+    clear();
+    if ( n == 0 ) return;
+    const usize per = __tree_store::bulk_target(fill, M, __minf);
+    __arena.reserve(n / per + n / (per * per) + 4);
+    auto retile = [&sort](auto *p, usize m, usize pp) { str_tile(p, m, 0, pp, sort); };
+    retile(items, n, per);
+    fvector<bulk_node> lv[2];
+    pack_leaves(n, per, [items](usize i) -> entry & { return items[i]; }, lv[0]);
+    pack_upper(lv, per, retile);
+    __size = n;
+  }
+
+  // Hilbert packing: leaves are consecutive runs along a Hilbert curve through the box centres (one sort of 64-bit keys, cheaper than
+  // STR's per-axis passes), upper levels group neighbouring nodes in curve order. items keep their order, their values are moved from
+  template<typename Sort = __tree_store::serial_sort>
+  void
+  pack_hilbert(entry *items, usize n, f32 fill = 1.0f, Sort sort = Sort{})
+  {
+    clear();
+    if ( n == 0 ) return;
+    const usize per = __tree_store::bulk_target(fill, M, __minf);
+    __arena.reserve(n / per + n / (per * per) + 4);
+
+    F lo[Dim], hi[Dim];
+    for ( usize d = 0; d < Dim; ++d ) lo[d] = hi[d] = center(items[0], d);
+    for ( usize i = 1; i < n; ++i )
+      for ( usize d = 0; d < Dim; ++d ) {
+        const F c = center(items[i], d);
+        if ( c < lo[d] ) lo[d] = c;
+        if ( c > hi[d] ) hi[d] = c;
+      }
+    constexpr u32 bits = (64 / Dim) > 31 ? 31 : static_cast<u32>(64 / Dim);
+    constexpr u32 top = (1u << bits) - 1u;
+    const F cells = static_cast<F>(top);
+    fvector<hilbert_ref> refs;
+    refs.reserve(n);
+    for ( usize i = 0; i < n; ++i ) {
+      u32 x[Dim];
+      for ( usize d = 0; d < Dim; ++d ) {
+        const F span = hi[d] - lo[d];
+        const F t = span > F(0) ? (center(items[i], d) - lo[d]) / span : F(0);
+        F g = t * cells;
+        if ( g > cells ) g = cells;
+        x[d] = g > F(0) ? static_cast<u32>(g) : 0u;
+        if ( x[d] > top ) x[d] = top;      // cells rounds up in F
+      }
+      refs.push_back(hilbert_ref{ hilbert_key(x, bits), i });
+    }
+    sort(&refs[0], &refs[0] + n, [](const hilbert_ref &a, const hilbert_ref &b) { return a.key < b.key or (a.key == b.key and a.pos < b.pos); });
+
+    fvector<bulk_node> lv[2];
+    const hilbert_ref *r = &refs[0];
+    pack_leaves(n, per, [items, r](usize i) -> entry & { return items[r[i].pos]; }, lv[0]);
+    pack_upper(lv, per, [](bulk_node *, usize, usize) { });
+    __size = n;
+  }
+
+  template<typename R, typename Sort = __tree_store::serial_sort>
+    requires requires(R &r) {
+      r.data();
+      r.size();
+    }
+  void
+  pack_str(R &r, f32 fill = 1.0f, Sort sort = Sort{})
+  {
+    pack_str(r.data(), r.size(), fill, sort);
+  }
+
+  template<typename R, typename Sort = __tree_store::serial_sort>
+    requires requires(R &r) {
+      r.data();
+      r.size();
+    }
+  void
+  pack_hilbert(R &r, f32 fill = 1.0f, Sort sort = Sort{})
+  {
+    pack_hilbert(r.data(), r.size(), fill, sort);
+  }
+
   bool
   erase(const box_type &b, const Value &v)
   {
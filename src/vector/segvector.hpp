@@ -0,0 +1,411 @@
+//  Copyright (c) 2024- David Lucius Severus
+//
+//  Distributed under the Boost Software License, Version 1.0.
+//  See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt
+#pragma once
+
+#include "../type_traits.hpp"
+
+#include "../bits/__container.hpp"
+
+#include "../atomic/atomic.hpp"
+#include "../concepts.hpp"
+#include "../except.hpp"
+#include "../memory/allocation/resources.hpp"
+#include "../memory/cache.hpp"
+#include "../memory/memory.hpp"
+#include "../memory/new.hpp"
+#include "../tags.hpp"
+#include "../types.hpp"
+
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+//  segvector
+//  lock-free, append-only concurrent vector
+//
+//  storage is a table of geometrically sized segments: segment k holds B << k elements and covers [B * (2^k - 1), B * (2^(k+1) - 1)).
+//  segments are never moved or freed while the vector lives, so references and pointers into it stay valid across growth. appends
+//  install whichever segments their slots fall into with a CAS (losers hand their block straight back) and reserve the slots on the
+//  length; indexed reads are one acquire load of the segment pointer, wait-free.
+//
+//  with Sf the reservation is a CAS loop that checks capacity and installs the segments first, so a throw there (out of range or out
+//  of memory) leaves the length untouched. without Sf it is a single unchecked fetch_add with the segments installed after it, and an
+//  allocation failure there is not recovered
+//
+//  a T constructor that throws leaves its slot (and the rest of its batch) reserved but unbuilt; the slots can't be handed back, so
+//  they are marked in a per-segment hole bitmap, skipped by for_each, clear() and the destructor, and at() throws on them
+//
+//  NOTE: size() counts reserved slots, holes included. a slot is readable once the append that returned its index happened-before
+//  the read (the index was handed over, or the appending thread was joined); reading a slot another thread is still constructing is
+//  a race, as with any container. there is no erase/insert, and clear()/destruction must not overlap appends
+
+namespace micron
+{
+
+template<is_movable_object T, usize B = 32, class Alloc = micron::allocator_serial<>, bool Sf = true>
+  requires(B > 0 and (B & (B - 1)) == 0)
+class segvector
+{
+  static constexpr usize __cache_line = cache_line_size();
+  static constexpr usize __log_b = static_cast<usize>(__builtin_ctzll(B));
+  static constexpr usize __segments = 64 - __log_b;
+
+  static constexpr usize __max_length = usize{ 0 } - B;      // __seg_base(__segments), wrapped
+
+  alignas(__cache_line) micron::atomic_token<usize> __length;      // reservation counter, the only contended word
+  alignas(__cache_line) micron::atomic_token<T *> __segs[__segments];
+  usize __seg_bytes[__segments];      // written once by the CAS winner, read only by the (non-concurrent) destructor
+  micron::atomic_token<bool> __holed;      // some append failed; until then nobody looks at the hole bitmaps
+
+  [[gnu::always_inline]] static inline constexpr usize
+  __seg_of(usize i) noexcept
+  {
+    return static_cast<usize>(63 - __builtin_clzll((i >> __log_b) + 1));
+  }
+
+  [[gnu::always_inline]] static inline constexpr usize
+  __seg_base(usize k) noexcept
+  {
+    return B * ((usize{ 1 } << k) - 1);
+  }
+
+  [[gnu::always_inline]] static inline constexpr usize
+  __seg_size(usize k) noexcept
+  {
+    return B << k;
+  }
+
+  // a segment is its elements, then one hole bit per slot
+  [[gnu::always_inline]] static inline constexpr usize
+  __hole_off(usize k) noexcept
+  {
+    return (__seg_size(k) * sizeof(T) + 7) & ~usize{ 7 };
+  }
+
+  [[gnu::always_inline]] static inline constexpr usize
+  __hole_words(usize k) noexcept
+  {
+    return (__seg_size(k) + 63) >> 6;
+  }
+
+  [[gnu::always_inline]] static inline u64 *
+  __holes(const T *seg, usize k) noexcept
+  {
+    return reinterpret_cast<u64 *>(const_cast<byte *>(reinterpret_cast<const byte *>(seg)) + __hole_off(k));
+  }
+
+  [[gnu::always_inline]] static inline bool
+  __is_hole(const T *seg, usize k, usize j) noexcept
+  {
+    return (atom::load(__holes(seg, k) + (j >> 6), __ATOMIC_ACQUIRE) >> (j & 63)) & 1u;
+  }
+
+  [[gnu::always_inline]] inline T *
+  __slot(usize i) const noexcept
+  {
+    const usize k = __seg_of(i);
+    return __segs[k].get(memory_order_acquire) + (i - __seg_base(k));
+  }
+
+  // allocate-if-absent; any number of threads may race here, exactly one block is installed
+  [[gnu::noinline]] T *
+  __install(usize k)
+  {
+    chunk<byte> mem = Alloc::create(__hole_off(k) + __hole_words(k) * sizeof(u64));
+    T *fresh = reinterpret_cast<T *>(mem.ptr);
+    micron::memset(reinterpret_cast<byte *>(__holes(fresh, k)), 0x0, __hole_words(k) * sizeof(u64));
+    T *expected = nullptr;
+    if ( __segs[k].compare_exchange_strong(expected, fresh, memory_order_acq_rel, memory_order_acquire) ) {
+      __seg_bytes[k] = mem.len;
+      return fresh;
+    }
+    Alloc::destroy(mem);
+    return expected;
+  }
+
+  [[gnu::always_inline]] inline T *
+  __ensure(usize k)
+  {
+    T *p = __segs[k].get(memory_order_acquire);
+    if ( p != nullptr ) [[likely]]
+      return p;
+    return __install(k);
+  }
+
+  [[gnu::always_inline]] inline void
+  __ensure_range(usize first, usize last)
+  {
+    for ( usize k = __seg_of(first), e = __seg_of(last - 1); k <= e; ++k ) __ensure(k);
+  }
+
+  // slots [i, last) of a failed append: reserved for good, never built
+  [[gnu::noinline]] void
+  __mark_holes(usize i, usize last) noexcept
+  {
+    for ( ; i < last; ++i ) {
+      const usize k = __seg_of(i);
+      const usize j = i - __seg_base(k);
+      atom::fetch_or(__holes(__segs[k].get(memory_order_acquire), k) + (j >> 6), u64{ 1 } << (j & 63), __ATOMIC_RELEASE);
+    }
+    __holed.store(true, memory_order_release);
+  }
+
+  template<typename Fn>
+  inline void
+  __build(usize i, usize last, Fn &fn) noexcept(noexcept(fn(static_cast<T *>(nullptr))))
+  {
+    while ( i < last ) {
+      const usize k = __seg_of(i);
+      T *seg = __segs[k].get(memory_order_acquire);
+      const usize seg_end = __seg_base(k) + __seg_size(k);
+      const usize stop = last < seg_end ? last : seg_end;
+      if constexpr ( noexcept(fn(seg)) ) {
+        for ( ; i < stop; ++i ) fn(seg + (i - __seg_base(k)));
+      } else {
+#if !defined(__micron_freestanding) || defined(__micron_eh)
+        try {
+          for ( ; i < stop; ++i ) fn(seg + (i - __seg_base(k)));
+        } catch ( ... ) {
+          __mark_holes(i, last);
+          throw;
+        }
+#else
+        for ( ; i < stop; ++i ) fn(seg + (i - __seg_base(k)));
+#endif
+      }
+    }
+  }
+
+  // reserve n slots, make sure every segment they touch exists, then build them segment by segment
+  template<typename Fn>
+  inline usize
+  __append(usize n, Fn &&fn)
+  {
+    usize first;
+    if constexpr ( Sf == true ) {
+      first = __length.get(memory_order_relaxed);
+      do {
+        if ( n > __max_length - first ) [[unlikely]]
+          exc<except::library_error>("micron::segvector append exceeds addressable capacity");
+        __ensure_range(first, first + n);
+      } while ( !__length.compare_exchange_weak(first, first + n, memory_order_relaxed, memory_order_relaxed) );
+    } else {
+      first = __length.fetch_add(n, memory_order_relaxed);
+      __ensure_range(first, first + n);
+    }
+    __build(first, first + n, fn);
+    return first;
+  }
+
+  [[gnu::noinline]] void
+  __check_hole(usize i) const
+  {
+    const usize k = __seg_of(i);
+    if ( __is_hole(__segs[k].get(memory_order_acquire), k, i - __seg_base(k)) )
+      exc<except::library_error>("micron::segvector at() on a slot whose append threw");
+  }
+
+  inline void
+  __destroy_all(void)
+  {
+    const usize n = __length.get(memory_order_acquire);
+    if constexpr ( !micron::is_trivially_destructible_v<T> ) {
+      const bool holed = __holed.get(memory_order_acquire);
+      for ( usize k = 0; k < __segments and __seg_base(k) < n; ++k ) {
+        T *seg = __segs[k].get(memory_order_acquire);
+        const usize cnt = (n - __seg_base(k)) < __seg_size(k) ? (n - __seg_base(k)) : __seg_size(k);
+        for ( usize j = 0; j < cnt; ++j )
+          if ( !holed or !__is_hole(seg, k, j) ) seg[j].~T();
+      }
+    }
+  }
+
+public:
+  using category_type = vector_tag;
+  using mutability_type = mutable_tag;
+  using memory_type = heap_tag;
+  typedef usize size_type;
+  typedef T value_type;
+  typedef T &reference;
+  typedef T &ref;
+  typedef const T &const_reference;
+  typedef const T &const_ref;
+  typedef T *pointer;
+  typedef const T *const_pointer;
+
+  ~segvector(void)
+  {
+    __destroy_all();
+    for ( usize k = 0; k < __segments; ++k ) {
+      T *seg = __segs[k].get(memory_order_relaxed);
+      if ( seg ) Alloc::destroy(chunk<byte>{ reinterpret_cast<byte *>(seg), __seg_bytes[k] });
+    }
+  }
+
+  segvector(void) noexcept : __length(0), __holed(false)
+  {
+    for ( usize k = 0; k < __segments; ++k ) {
+      __segs[k].store(nullptr, memory_order_relaxed);
+      __seg_bytes[k] = 0;
+    }
+  }
+
+  segvector(const segvector &) = delete;
+  segvector(segvector &&) = delete;
+  segvector &operator=(const segvector &) = delete;
+  segvector &operator=(segvector &&) = delete;
+
+  // appends return the index of the (first) slot they filled
+  inline usize
+  push_back(const T &v)
+  {
+    return __append(1, [&](T *p) noexcept(micron::is_nothrow_copy_constructible_v<T>) { new (p) T(v); });
+  }
+
+  inline usize
+  push_back(T &&v)
+  {
+    return __append(1, [&](T *p) noexcept(micron::is_nothrow_move_constructible_v<T>) { new (p) T(micron::move(v)); });
+  }
+
+  template<typename... Args>
+  inline usize
+  emplace_back(Args &&...args)
+  {
+    return __append(1, [&](T *p) noexcept(micron::is_nothrow_constructible_v<T, Args...>) { new (p) T(micron::forward<Args>(args)...); });
+  }
+
+  // one reservation for n slots; the batch is contiguous in index space, not necessarily in memory
+  inline usize
+  grow_by(usize n)
+  {
+    if ( n == 0 ) return __length.get(memory_order_relaxed);
+    return __append(n, [](T *p) noexcept(micron::is_nothrow_default_constructible_v<T>) { new (p) T{}; });
+  }
+
+  inline usize
+  grow_by(usize n, const T &v)
+  {
+    if ( n == 0 ) return __length.get(memory_order_relaxed);
+    return __append(n, [&](T *p) noexcept(micron::is_nothrow_copy_constructible_v<T>) { new (p) T(v); });
+  }
+
+  // pre-installs the segments covering [0, n), so appends below n never allocate; safe to call concurrently
+  inline void
+  reserve(usize n)
+  {
+    for ( usize k = 0; k < __segments and __seg_base(k) < n; ++k ) __ensure(k);
+  }
+
+  [[gnu::always_inline]] inline T &
+  operator[](usize i) noexcept
+  {
+    return *__slot(i);
+  }
+
+  [[gnu::always_inline]] inline const T &
+  operator[](usize i) const noexcept
+  {
+    return *__slot(i);
+  }
+
+  inline T &
+  at(usize i)
+  {
+    if ( i >= __length.get(memory_order_acquire) ) [[unlikely]]
+      exc<except::library_error>("micron::segvector at() out of range");
+    if ( __holed.get(memory_order_acquire) ) [[unlikely]]
+      __check_hole(i);
+    return *__slot(i);
+  }
+
+  inline const T &
+  at(usize i) const
+  {
+    if ( i >= __length.get(memory_order_acquire) ) [[unlikely]]
+      exc<except::library_error>("micron::segvector at() out of range");
+    if ( __holed.get(memory_order_acquire) ) [[unlikely]]
+      __check_hole(i);
+    return *__slot(i);
+  }
+
+  inline T &
+  front(void)
+  {
+    return at(0);
+  }
+
+  inline const T &
+  front(void) const
+  {
+    return at(0);
+  }
+
+  // WARNING: temporal approximation only while appends run
+  inline usize
+  size(void) const noexcept
+  {
+    return __length.get(memory_order_acquire);
+  }
+
+  inline bool
+  empty(void) const noexcept
+  {
+    return size() == 0;
+  }
+
+  // elements addressable without allocating
+  inline usize
+  capacity(void) const noexcept
+  {
+    usize k = 0;
+    while ( k < __segments and __segs[k].get(memory_order_acquire) != nullptr ) ++k;
+    return __seg_base(k);
+  }
+
+  // walks the first size() elements segment by segment, contiguous runs at a time, holes skipped
+  template<typename Fn>
+  inline void
+  for_each(Fn &&fn)
+  {
+    const usize n = size();
+    const bool holed = __holed.get(memory_order_acquire);
+    for ( usize k = 0; k < __segments and __seg_base(k) < n; ++k ) {
+      T *seg = __segs[k].get(memory_order_acquire);
+      const usize cnt = (n - __seg_base(k)) < __seg_size(k) ? (n - __seg_base(k)) : __seg_size(k);
+      for ( usize j = 0; j < cnt; ++j )
+        if ( !holed or !__is_hole(seg, k, j) ) fn(seg[j]);
+    }
+  }
+
+  template<typename Fn>
+  inline void
+  for_each(Fn &&fn) const
+  {
+    const usize n = size();
+    const bool holed = __holed.get(memory_order_acquire);
+    for ( usize k = 0; k < __segments and __seg_base(k) < n; ++k ) {
+      const T *seg = __segs[k].get(memory_order_acquire);
+      const usize cnt = (n - __seg_base(k)) < __seg_size(k) ? (n - __seg_base(k)) : __seg_size(k);
+      for ( usize j = 0; j < cnt; ++j )
+        if ( !holed or !__is_hole(seg, k, j) ) fn(seg[j]);
+    }
+  }
+
+  // keeps the segments; must not overlap appends
+  inline void
+  clear(void)
+  {
+    __destroy_all();
+    if ( __holed.get(memory_order_relaxed) ) {
+      for ( usize k = 0; k < __segments; ++k ) {
+        T *seg = __segs[k].get(memory_order_relaxed);
+        if ( seg ) micron::memset(reinterpret_cast<byte *>(__holes(seg, k)), 0x0, __hole_words(k) * sizeof(u64));
+      }
+      __holed.store(false, memory_order_relaxed);
+    }
+    __length.store(0, memory_order_release);
+  }
+};
+
+};      // namespace micron
@@ -0,0 +1,497 @@
+//  Copyright (c) 2024- David Lucius Severus
+//
+//  Distributed under the Boost Software License, Version 1.0.
+//  See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt
+#pragma once
+
+#include "../__special/initializer_list"
+#include "../type_traits.hpp"
+
+#include "../bits/__container.hpp"
+
+#include "../algorithm/algorithm.hpp"
+#include "../algorithm/memory.hpp"
+#include "../allocator.hpp"
+#include "../concepts.hpp"
+#include "../container_safety.hpp"
+#include "../except.hpp"
+#include "../memory/actions.hpp"
+#include "../memory/allocation/resources.hpp"
+#include "../memory/memory.hpp"
+#include "../memory/new.hpp"
+#include "../pointer.hpp"
+#include "../tags.hpp"
+#include "../types.hpp"
+
+namespace micron
+{
+
+// small_vector: growable vector holding up to N elements inline, spills to Alloc once it outgrows them. mutable, not thread safe, can be
+// copied. memory always points at the live storage (either __buf or the heap block), so the hot path is identical to micron::vector
+template<is_regular_object T, usize N = 8, class Alloc = micron::allocator_serial<>, bool Sf = true>
+  requires(N > 0)
+class small_vector: private __container_checks<small_vector<T, N, Alloc, Sf>, T, Sf>,
+                    public __vector_core<small_vector<T, N, Alloc, Sf>, T>
+{
+  using __chk = __container_checks<small_vector<T, N, Alloc, Sf>, T, Sf>;
+  using __core = __vector_core<small_vector<T, N, Alloc, Sf>, T>;
+  friend __chk;
+  friend __core;
+
+  // WARNING: memory/length/capacity must stay first and together; __vector_core touches all three on every push
+  T *memory;
+  usize length;
+  usize capacity;
+
+  // NOTE: T[N] inside an anonymous union so non-trivial T is __NOT__ default constructed with the small_vector
+  union {
+    alignas(T) T __buf[N];
+  };
+
+  [[gnu::always_inline]] inline const T *
+  __c_data(void) const noexcept
+  {
+    return memory;
+  }
+
+  [[gnu::always_inline]] inline usize
+  __c_len(void) const noexcept
+  {
+    return length;
+  }
+
+  [[gnu::always_inline]] inline usize
+  __c_cap(void) const noexcept
+  {
+    return capacity;
+  }
+
+  [[gnu::always_inline]] inline void
+  __core_reserve(usize n)
+  {
+    reserve(n);
+  }
+
+  using __chk::__empty_check;
+  using __chk::__index_check;
+  using __chk::__range_check;
+
+  template<auto Fn, typename E, typename... Args>
+  inline __attribute__((always_inline)) void
+  __safety_check(const char *msg, Args &&...args) const
+  {
+    if constexpr ( Sf == true ) {
+      if ( (this->*Fn)(micron::forward<Args>(args)...) ) [[unlikely]]
+        __chk::template __fail<E>(msg);
+    }
+  }
+
+  [[gnu::always_inline]] inline bool
+  __on_heap(void) const noexcept
+  {
+    return memory != __buf;
+  }
+
+  [[gnu::always_inline]] inline void
+  __to_inline(void) noexcept
+  {
+    memory = __buf;
+    length = 0;
+    capacity = N;
+  }
+
+  [[gnu::always_inline]] inline void
+  __free(void)
+  {
+    if ( __on_heap() ) Alloc::destroy(chunk<byte>{ reinterpret_cast<byte *>(memory), capacity * sizeof(T) });
+  }
+
+  // leaves __buf, never comes back on its own; only shrink_to_fit() returns to inline storage
+  [[gnu::noinline]] void
+  __spill(usize n)
+  {
+    chunk<byte> mem = Alloc::create(n * sizeof(T));
+    T *dst = reinterpret_cast<T *>(mem.ptr);
+    __impl_container::move(dst, __buf, length);      // relocates and destroys the inline elements
+    memory = dst;
+    capacity = mem.len / sizeof(T);
+  }
+
+  // steal o's heap block, or relocate its inline elements; *this must be empty and inline, o is left empty and inline
+  inline void
+  __take(small_vector &o)
+  {
+    if ( o.__on_heap() ) {
+      memory = o.memory;
+      length = o.length;
+      capacity = o.capacity;
+    } else {
+      __impl_container::move(__buf, o.__buf, o.length);
+      length = o.length;
+    }
+    o.__to_inline();
+  }
+
+  inline void
+  __copy_from(const small_vector &o)
+  {
+    if ( o.length > capacity ) reserve(o.length);
+    __impl_container::copy(memory, o.memory, o.length);
+    length = o.length;
+  }
+
+public:
+  using category_type = vector_tag;
+  using contiguous_tag = void;
+  using mutability_type = mutable_tag;
+  using memory_type = heap_tag;
+  typedef usize size_type;
+  typedef T value_type;
+  typedef T &reference;
+  typedef T &ref;
+  typedef const T &const_reference;
+  typedef const T &const_ref;
+  typedef T *pointer;
+  typedef const T *const_pointer;
+  typedef T *iterator;
+  typedef const T *const_iterator;
+  static constexpr size_type inline_size = N;
+
+  ~small_vector(void)
+  {
+    clear();
+    __free();
+  }
+
+  small_vector(void) : memory(__buf), length(0), capacity(N) { }
+
+  small_vector(const size_type n) : small_vector()
+  {
+    resize(n);
+  }
+
+  small_vector(const size_type n, const T &v) : small_vector()
+  {
+    resize(n, v);
+  }
+
+  small_vector(const std::initializer_list<T> &lst) : small_vector()
+  {
+    if ( lst.size() > capacity ) reserve(lst.size());
+    __impl_container::copy(memory, lst.begin(), lst.size());
+    length = lst.size();
+  }
+
+  small_vector(const small_vector &o) : small_vector() { __copy_from(o); }
+
+  small_vector(small_vector &&o) : small_vector() { __take(o); }
+
+  small_vector &
+  operator=(const small_vector &o)
+  {
+    if ( this == micron::addressof(o) ) return *this;
+    clear();
+    __copy_from(o);
+    return *this;
+  }
+
+  small_vector &
+  operator=(small_vector &&o)
+  {
+    if ( this == micron::addressof(o) ) return *this;
+    clear();
+    __free();
+    __to_inline();
+    __take(o);
+    return *this;
+  }
+
+  void
+  swap(small_vector &o)
+  {
+    if ( this == micron::addressof(o) ) return;
+    if ( __on_heap() and o.__on_heap() ) {
+      micron::swap(memory, o.memory);
+      micron::swap(length, o.length);
+      micron::swap(capacity, o.capacity);
+      return;
+    }
+    small_vector tmp(micron::move(o));
+    o = micron::move(*this);
+    *this = micron::move(tmp);
+  }
+
+  [[gnu::always_inline]] inline bool
+  is_inline(void) const noexcept
+  {
+    return !__on_heap();
+  }
+
+  const_pointer
+  data(void) const
+  {
+    return memory;
+  }
+
+  pointer
+  data(void)
+  {
+    return memory;
+  }
+
+  inline __attribute__((always_inline)) const T &
+  operator[](size_type n) const
+  {
+    __safety_check<&small_vector::__index_check, except::library_error>("micron::small_vector operator[] out of range.", n);
+    return memory[n];
+  }
+
+  inline __attribute__((always_inline)) T &
+  operator[](size_type n)
+  {
+    __safety_check<&small_vector::__index_check, except::library_error>("micron::small_vector operator[] out of range.", n);
+    return memory[n];
+  }
+
+  inline __attribute__((always_inline)) T &
+  at(size_type n)
+  {
+    __safety_check<&small_vector::__index_check, except::library_error>("micron::small_vector at() out of bounds", n);
+    return memory[n];
+  }
+
+  inline __attribute__((always_inline)) const T &
+  at(size_type n) const
+  {
+    __safety_check<&small_vector::__index_check, except::library_error>("micron::small_vector at() out of bounds", n);
+    return memory[n];
+  }
+
+  size_type
+  max_size(void) const
+  {
+    return capacity;
+  }
+
+  [[gnu::always_inline]] inline size_type
+  size(void) const
+  {
+    if ( length > capacity ) __builtin_unreachable();
+    return length;
+  }
+
+  bool
+  empty(void) const
+  {
+    return length == 0;
+  }
+
+  inline void
+  reserve(const size_type n)
+  {
+    if ( n <= capacity ) return;
+    if ( !__on_heap() ) {
+      __spill(n);
+      return;
+    }
+    chunk<byte> mem = Alloc::grow(chunk<byte>{ reinterpret_cast<byte *>(memory), capacity * sizeof(T) }, n * sizeof(T));
+    memory = reinterpret_cast<T *>(mem.ptr);
+    capacity = mem.len / sizeof(T);
+  }
+
+  // returns to inline storage when the elements fit, otherwise a no-op; the heap block is never shrunk in place
+  void
+  shrink_to_fit(void)
+  {
+    if ( !__on_heap() or length > N ) return;
+    T *old = memory;
+    const size_type cap = capacity;
+    __impl_container::move(__buf, old, length);
+    memory = __buf;
+    capacity = N;
+    Alloc::destroy(chunk<byte>{ reinterpret_cast<byte *>(old), cap * sizeof(T) });
+  }
+
+  void
+  resize(size_type n)
+  {
+    if ( n == length ) return;
+    if ( n < length ) {
+      __impl_container::destroy_fast(memory + n, length - n);
+      length = n;
+      return;
+    }
+    if ( n > capacity ) reserve(n);
+    if constexpr ( micron::is_trivially_default_constructible<T>::value and micron::is_trivially_copyable<T>::value ) {
+      micron::byteset(memory + length, 0x0, (n - length) * sizeof(T));
+    } else {
+      for ( size_type i = length; i < n; i++ ) new (micron::addr(memory[i])) T{};
+    }
+    length = n;
+  }
+
+  void
+  resize(size_type n, const T &v)
+  {
+    if ( n == length ) return;
+    if ( n < length ) {
+      __impl_container::destroy_fast(memory + n, length - n);
+      length = n;
+      return;
+    }
+    if ( n > capacity ) reserve(n);
+    __impl_container::construct(micron::addr(memory[length]), v, n - length);
+    length = n;
+  }
+
+  using __core::emplace_back;
+  using __core::push_back;
+
+  inline void
+  pop_back(void)
+  {
+    __safety_check<&small_vector::__empty_check, except::library_error>("micron::small_vector pop_back() called on empty vector");
+    if constexpr ( !micron::is_trivially_destructible_v<T> ) memory[length - 1].~T();
+    --length;
+  }
+
+  inline iterator
+  insert(size_type n, const T &val)
+  {
+    if ( n == length ) {
+      push_back(val);
+      return micron::addr(memory[n]);
+    }
+    __safety_check<&small_vector::__index_check, except::library_error>("micron::small_vector insert(): out of range.", n);
+    if ( length + 1 > capacity ) reserve(__impl::grow(capacity));
+    __impl_container::open_gap(memory, length, n, 1);
+    __impl_container::fill_gap_copy(memory, length, n, 1, val);      // rollback-safe gap fill
+    ++length;
+    return micron::addr(memory[n]);
+  }
+
+  inline iterator
+  insert(size_type n, T &&val)
+  {
+    if ( n == length ) {
+      emplace_back(micron::move(val));
+      return micron::addr(memory[n]);
+    }
+    __safety_check<&small_vector::__index_check, except::library_error>("micron::small_vector insert(): out of range.", n);
+    if ( length + 1 > capacity ) reserve(__impl::grow(capacity));
+    __impl_container::open_gap(memory, length, n, 1);
+    __impl_container::fill_gap(memory, length, n, 1, [&](size_type i) { new (micron::addr(memory[i])) T(micron::move(val)); });
+    ++length;
+    return micron::addr(memory[n]);
+  }
+
+  inline void
+  erase(const size_type n)
+  {
+    __safety_check<&small_vector::__index_check, except::library_error>("micron::small_vector erase(): out of range.", n);
+    __impl_container::close_gap(memory, length, n, 1);
+    --length;
+  }
+
+  inline void
+  erase(size_type from, size_type to)
+  {
+    __safety_check<&small_vector::__range_check, except::library_error>("micron::small_vector erase(): invalid range", from, to);
+    __impl_container::close_gap(memory, length, from, to - from);
+    length -= to - from;
+  }
+
+  inline void
+  erase(iterator it)
+  {
+    erase(static_cast<size_type>(it - memory));
+  }
+
+  // keeps the heap block, if any; call shrink_to_fit() to hand it back
+  inline void
+  clear(void)
+  {
+    if ( !length ) return;
+    __impl_container::destroy_fast(memory, length);
+    length = 0;
+  }
+
+  inline iterator
+  find(const T &o)
+  {
+    return memory + __impl_container::find_index(memory, length, o);
+  }
+
+  inline const_iterator
+  find(const T &o) const
+  {
+    return memory + __impl_container::find_index(memory, length, o);
+  }
+
+  iterator
+  begin(void)
+  {
+    return memory;
+  }
+
+  const_iterator
+  begin(void) const
+  {
+    return memory;
+  }
+
+  const_iterator
+  cbegin(void) const
+  {
+    return memory;
+  }
+
+  iterator
+  end(void)
+  {
+    return memory + length;
+  }
+
+  const_iterator
+  end(void) const
+  {
+    return memory + length;
+  }
+
+  const_iterator
+  cend(void) const
+  {
+    return memory + length;
+  }
+
+  inline const T &
+  front(void) const
+  {
+    __safety_check<&small_vector::__empty_check, except::library_error>("micron::small_vector front() called on empty vector");
+    return memory[0];
+  }
+
+  inline const T &
+  back(void) const
+  {
+    __safety_check<&small_vector::__empty_check, except::library_error>("micron::small_vector back() called on empty vector");
+    return memory[length - 1];
+  }
+
+  inline T &
+  front(void)
+  {
+    __safety_check<&small_vector::__empty_check, except::library_error>("micron::small_vector front() called on empty vector");
+    return memory[0];
+  }
+
+  inline T &
+  back(void)
+  {
+    __safety_check<&small_vector::__empty_check, except::library_error>("micron::small_vector back() called on empty vector");
+    return memory[length - 1];
+  }
+};
+
+};      // namespace micron
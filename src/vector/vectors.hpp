@@ -7,5 +7,6 @@
 
 #include "fvector.hpp"
 #include "ivector.hpp"
+#include "small_vector.hpp"
 #include "svector.hpp"
 #include "vector.hpp"
@@ -0,0 +1,110 @@
+#include "../../src/algorithm/lazy/par.hpp"
+#include "../../src/lz.hpp"
+#include "../../src/vector.hpp"
+#include "../snowball/snowball.hpp"
+
+namespace coro = micron::coro;
+namespace lz = micron::lz;
+
+using vec_ll = micron::vector<long long>;
+
+static int FAILS = 0;
+
+static auto plus = [](long long a, long long b) { return a + b; };
+static auto sq = [](long long x) { return x * x; };
+static auto odd = [](long long x) { return (x & 1) != 0; };
+
+static bool
+same(const vec_ll &a, const vec_ll &b)
+{
+  if ( a.size() != b.size() ) return false;
+  for ( usize i = 0; i < a.size(); ++i )
+    if ( a[i] != b[i] ) return false;
+  return true;
+}
+
+int
+main()
+{
+  sb::check_callback([]() { ++FAILS; });
+  coro::start_coroutine_runtime();
+
+  sb::test_case("par_collect preserves order: fmap, then fmap | filter");
+  for ( int N : { 0, 1, 1023, 1024, 1025, 100000, 200003 } ) {
+    vec_ll v;
+    for ( int i = 0; i < N; ++i ) v.push_back((i * 37) % 1001);
+
+    vec_ll a = coro::sync_wait(v | lz::par(lz::fmap(sq)) | lz::par_collect<vec_ll>());
+    vec_ll b = v | lz::fmap(sq) | lz::collect<vec_ll>();
+    if ( !same(a, b) ) sb::print("par fmap collect mismatch at N=", N);
+    sb::check(same(a, b));
+
+    vec_ll c = coro::sync_wait(v | lz::par(lz::fmap(sq), lz::filter(odd)) | lz::par_collect<vec_ll>());
+    vec_ll d = v | lz::fmap(sq) | lz::filter(odd) | lz::collect<vec_ll>();
+    if ( !same(c, d) ) sb::print("par fmap|filter collect mismatch at N=", N);
+    sb::check(same(c, d));
+  }
+  sb::end_test_case();
+
+  sb::test_case("par_reduce agrees with fold");
+  for ( int N : { 0, 1, 1025, 100000, 200003 } ) {
+    vec_ll v;
+    for ( int i = 0; i < N; ++i ) v.push_back(i % 97);
+    const long long s = coro::sync_wait(v | lz::par(lz::filter(odd), lz::fmap(sq)) | lz::par_reduce(0LL, plus));
+    const long long e = v | lz::filter(odd) | lz::fmap(sq) | lz::fold(0LL, plus);
+    sb::check(s == e);
+  }
+  sb::end_test_case();
+
+  sb::test_case("par_scan matches scanl, including empty blocks");
+  for ( int N : { 0, 1, 1024, 1025, 100000, 200003 } ) {
+    vec_ll v;
+    for ( int i = 0; i < N; ++i ) v.push_back(i < N / 2 ? 2 : (i % 5));      // the first half filters to nothing
+    vec_ll a = coro::sync_wait(v | lz::par(lz::filter(odd)) | lz::par_scan(7LL, plus));
+    vec_ll b = v | lz::filter(odd) | lz::scanl(7LL, plus) | lz::collect<vec_ll>();
+    if ( !same(a, b) ) sb::print("par_scan mismatch at N=", N);
+    sb::check(same(a, b));
+  }
+  sb::end_test_case();
+
+  sb::test_case("zip slices its other side at the source offsets");
+  {
+    const int N = 150001;
+    vec_ll v, w;
+    for ( int i = 0; i < N; ++i ) {
+      v.push_back(i);
+      w.push_back(3 * i + 1);
+    }
+    auto mul = [](long long a, long long b) { return a * b; };
+    vec_ll a = coro::sync_wait(v | lz::par(lz::zip_with(w, mul), lz::filter(odd)) | lz::par_collect<vec_ll>());
+    vec_ll b = v | lz::zip_with(w, mul) | lz::filter(odd) | lz::collect<vec_ll>();
+    sb::check(same(a, b));
+  }
+  sb::end_test_case();
+
+  sb::test_case("sliding reads past its block, chunk aligns blocks");
+  for ( int N : { 3, 1024, 100000, 100003 } ) {
+    vec_ll v;
+    for ( int i = 0; i < N; ++i ) v.push_back(i % 13);
+    auto wsum = [](lz::ptr_view<long long> w) {
+      long long s = 0;
+      for ( long long x : w ) s += x;
+      return s;
+    };
+    vec_ll a = coro::sync_wait(v | lz::par(lz::sliding(4), lz::fmap(wsum)) | lz::par_collect<vec_ll>());
+    vec_ll b = v | lz::sliding(4) | lz::fmap(wsum) | lz::collect<vec_ll>();
+    if ( !same(a, b) ) sb::print("par sliding mismatch at N=", N);
+    sb::check(same(a, b));
+
+    vec_ll c = coro::sync_wait(v | lz::par(lz::chunk(7), lz::fmap(wsum)) | lz::par_collect<vec_ll>());
+    vec_ll d = v | lz::chunk(7) | lz::fmap(wsum) | lz::collect<vec_ll>();
+    if ( !same(c, d) ) sb::print("par chunk mismatch at N=", N);
+    sb::check(same(c, d));
+  }
+  sb::end_test_case();
+
+  coro::stop_coroutine_runtime();
+  sb::require(FAILS == 0);
+  sb::print("=== ALL LZ PAR TESTS PASSED ===");
+  return 1;
+}
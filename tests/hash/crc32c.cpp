@@ -0,0 +1,143 @@
+//  Copyright (c) 2024- David Lucius Severus
+//
+//  Distributed under the Boost Software License, Version 1.0.
+//  See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt
+
+#include "../../src/hash/crc.hpp"
+
+#include "../snowball/snowball.hpp"
+
+using ::sb::print;
+using ::sb::require_true;
+
+namespace
+{
+
+u64 rng_state = 0x9E3779B97F4A7C15ull;
+
+u8
+next_byte()
+{
+  rng_state ^= rng_state << 13;
+  rng_state ^= rng_state >> 7;
+  rng_state ^= rng_state << 17;
+  return (u8)rng_state;
+}
+
+constexpr usize k_big = 70016;
+u8 g_buf[k_big];
+
+u32
+ref_crc32c(u32 init, const u8 *p, usize len) noexcept
+{
+  return micron::crc::__crc32c_bytewise(p, len, init ^ 0xFFFFFFFFu) ^ 0xFFFFFFFFu;
+}
+
+// every split of len bytes, from init 0 and from a nonzero init
+template<micron::crc_types K, typename F>
+bool
+combines(F &&f, usize len)
+{
+  const auto whole = f(0, g_buf, len);
+  const auto whole_i = f(0x1234, g_buf, len);
+  for ( usize cut = 0; cut <= len; cut += len / 9 + 1 ) {
+    const auto b = f(0, g_buf + cut, len - cut);
+    if ( micron::crc_combine<K>(f(0, g_buf, cut), b, len - cut) != whole ) return false;
+    if ( micron::crc_combine<K>(f(0x1234, g_buf, cut), b, len - cut) != whole_i ) return false;
+  }
+  return true;
+}
+
+};      // namespace
+
+static constexpr u8 k_ascii_digits[9] = { '1', '2', '3', '4', '5', '6', '7', '8', '9' };
+
+static_assert(micron::crc32_iscsi(0u, k_ascii_digits, 9) == 0xE3069283u);
+static_assert(micron::crc_combine<micron::crc_types::crc32_iscsi>(micron::crc32_iscsi(0u, k_ascii_digits, 4),
+                                                                 micron::crc32_iscsi(0u, k_ascii_digits + 4, 5), 5)
+              == 0xE3069283u);
+static_assert(micron::crc_combine<micron::crc_types::crc32_gzip_refl>(micron::crc32_gzip_refl(0u, k_ascii_digits, 2),
+                                                                     micron::crc32_gzip_refl(0u, k_ascii_digits + 2, 7), 7)
+              == 0xCBF43926u);
+
+int
+main()
+{
+  print("=== MICRON CRC32C / CRC COMBINE ===");
+
+#if defined(__micron_crc32c_hw_rt)
+  if ( micron::crc::__hw::__have() )
+    print("crc32c  tier: crc32 instruction, selected at runtime, 3-way interleave");
+  else
+    print("crc32c  tier: slice-by-8 ONLY -- no sse4.2 on this cpu (hardware path NOT covered by this run)");
+#elif defined(__micron_crc32c_hw)
+  print("crc32c  tier: crc32 instruction, 3-way interleave");
+#else
+  print("crc32c  tier: slice-by-8 ONLY -- no crc32 instruction on this build (hardware path NOT covered by this run)");
+#endif
+
+  for ( usize i = 0; i < k_big; ++i ) g_buf[i] = next_byte();
+
+  sb::test_case("crc32_iscsi == bytewise oracle, lengths 0..9000 x offsets {0,3}");
+  {
+    const usize offs[] = { 0, 3 };
+    for ( usize len = 0; len <= 9000; len += (len < 1500 ? 1 : 37) )
+      for ( usize off : offs ) {
+        require_true(micron::crc32_iscsi(0u, g_buf + off, len) == ref_crc32c(0u, g_buf + off, len));
+        require_true(micron::crc32_iscsi(0x55u, g_buf + off, len) == ref_crc32c(0x55u, g_buf + off, len));
+      }
+    require_true(micron::crc32_iscsi(0u, g_buf, k_big) == ref_crc32c(0u, g_buf, k_big));
+  }
+  sb::end_test_case();
+
+  sb::test_case("crc_combine(crc(A), crc(B), |B|) == crc(A || B), every polynomial");
+  {
+    using micron::crc_types;
+    const usize lens[] = { 0, 1, 7, 64, 100, 4096, 5003 };
+    for ( usize len : lens ) {
+      require_true(combines<crc_types::crc16_t10dif>([](u16 i, const u8 *p, usize n) { return micron::crc16_t10dif(i, p, n); }, len));
+      require_true(combines<crc_types::crc32_ieee>([](u32 i, const u8 *p, usize n) { return micron::crc32_ieee(i, p, n); }, len));
+      require_true(
+          combines<crc_types::crc32_gzip_refl>([](u32 i, const u8 *p, usize n) { return micron::crc32_gzip_refl(i, p, n); }, len));
+      require_true(combines<crc_types::crc32_iscsi>([](u32 i, const u8 *p, usize n) { return micron::crc32_iscsi(i, p, n); }, len));
+      require_true(
+          combines<crc_types::crc64_ecma_norm>([](u64 i, const u8 *p, usize n) { return micron::crc64_ecma_norm(i, p, n); }, len));
+      require_true(
+          combines<crc_types::crc64_ecma_refl>([](u64 i, const u8 *p, usize n) { return micron::crc64_ecma_refl(i, p, n); }, len));
+      require_true(combines<crc_types::crc64_iso_norm>([](u64 i, const u8 *p, usize n) { return micron::crc64_iso_norm(i, p, n); }, len));
+      require_true(combines<crc_types::crc64_iso_refl>([](u64 i, const u8 *p, usize n) { return micron::crc64_iso_refl(i, p, n); }, len));
+      require_true(
+          combines<crc_types::crc64_jones_norm>([](u64 i, const u8 *p, usize n) { return micron::crc64_jones_norm(i, p, n); }, len));
+      require_true(
+          combines<crc_types::crc64_jones_refl>([](u64 i, const u8 *p, usize n) { return micron::crc64_jones_refl(i, p, n); }, len));
+      require_true(combines<crc_types::crc64_rocksoft_norm>(
+          [](u64 i, const u8 *p, usize n) { return micron::crc64_rocksoft_norm(i, p, n); }, len));
+      require_true(combines<crc_types::crc64_rocksoft_refl>(
+          [](u64 i, const u8 *p, usize n) { return micron::crc64_rocksoft_refl(i, p, n); }, len));
+    }
+  }
+  sb::end_test_case();
+
+  sb::test_case("crc32_iscsi_blocks / crc32_iscsi_multi == one buffer at a time");
+  {
+    u32 out[8];
+    const usize blocks[] = { 0, 1, 9, 512, 4096 };
+    for ( usize block : blocks )
+      for ( usize n = 0; n <= 8; ++n ) {
+        micron::crc32_iscsi_blocks(g_buf, block, n, out);
+        for ( usize i = 0; i < n; ++i ) require_true(out[i] == ref_crc32c(0u, g_buf + i * block, block));
+      }
+
+    // uneven lengths, the common prefix of every three runs in lockstep
+    const u8 *bufs[7];
+    const usize lens[7] = { 5, 4096, 33, 0, 1000, 17, 9000 };
+    for ( usize i = 0; i < 7; ++i ) bufs[i] = g_buf + i * 97;
+    micron::crc32_iscsi_multi(bufs, lens, 7, out);
+    for ( usize i = 0; i < 7; ++i ) require_true(out[i] == ref_crc32c(0u, bufs[i], lens[i]));
+  }
+  sb::end_test_case();
+
+  print("[CRC32C / CRC COMBINE OK]");
+  return 1;
+}
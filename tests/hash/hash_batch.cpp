@@ -0,0 +1,128 @@
+//  Copyright (c) 2024- David Lucius Severus
+//
+//  Distributed under the Boost Software License, Version 1.0.
+//  See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt
+
+#include "../../src/hash/batch.hpp"
+#include "../../src/hash/hash.hpp"
+#include "../../src/string/strings.hpp"
+
+#include "../snowball/snowball.hpp"
+
+using ::sb::print;
+using ::sb::require_true;
+
+static void
+fill(byte *b, usize n)
+{
+  for ( usize i = 0; i < n; ++i ) b[i] = (byte)(i * 37 + 11 + (i >> 5) * 3);
+}
+
+template<typename K>
+static bool
+same_as_hash(const K *keys, usize n)
+{
+  hash64_t out[64];
+  micron::hash_batch(keys, n, out);
+  for ( usize i = 0; i < n; ++i )
+    if ( out[i] != micron::hash<hash64_t>(keys[i]) ) return false;
+  return true;
+}
+
+struct pair_key {
+  u64 a;
+  u32 b;
+};
+
+int
+main()
+{
+  print("=== MICRON BATCH HASHING ===");
+  alignas(64) static byte buf[64 * 40 + 64];
+  fill(buf, sizeof(buf));
+
+  sb::test_case("hash_batch == hash64 for every width up to 40, every tail length");
+  {
+    const u64 seeds[] = { 0, micron::default_seed, ~u64{ 0 } };
+    hash64_t out[64];
+    for ( u64 seed : seeds )
+      for ( usize w = 0; w <= 40; ++w )
+        for ( usize n = 0; n <= 64; n += (n < 20 ? 1 : 11) ) {
+          micron::hash_batch(buf + 1, w, n, out, seed);
+          for ( usize i = 0; i < n; ++i ) require_true(out[i] == micron::hash64(buf + 1 + i * w, w, seed));
+        }
+  }
+  sb::end_test_case();
+
+  sb::test_case("typed keys match hash<hash64_t>, one key at a time");
+  {
+    u16 k2[37];
+    u32 k4[37];
+    u64 k8[37];
+    i64 s8[37];
+    f64 d8[37];
+    for ( usize i = 0; i < 37; ++i ) {
+      k2[i] = static_cast<u16>(i * 40503u);
+      k4[i] = static_cast<u32>(i * 2654435761u);
+      k8[i] = i * 0x9e3779b97f4a7c15ull;
+      s8[i] = -static_cast<i64>(i * 1000003);
+      d8[i] = static_cast<f64>(i) * 0.37;
+    }
+    for ( usize n = 0; n <= 37; ++n ) {
+      require_true(same_as_hash(k2, n));
+      require_true(same_as_hash(k4, n));
+      require_true(same_as_hash(k8, n));
+      require_true(same_as_hash(s8, n));
+      require_true(same_as_hash(d8, n));
+    }
+    static_assert(micron::hash_batch_step == 2 * micron::hash_batch_lanes);
+  }
+  sb::end_test_case();
+
+  sb::test_case("seeded typed keys and strided keys");
+  {
+    pair_key pk[29];
+    for ( usize i = 0; i < 29; ++i ) pk[i] = pair_key{ i * 7919u, static_cast<u32>(i) };
+    hash64_t out[29];
+    micron::hash_batch(pk, 29, out, 0x1234u);
+    for ( usize i = 0; i < 29; ++i ) require_true(out[i] == micron::hash64(&pk[i], sizeof(pair_key), 0x1234u));
+
+    usize seen = 0;
+    micron::hash_each<u64>(
+        29, [&](usize i) -> const u64 & { return pk[i].a; },
+        [&](usize i, hash64_t h) {
+          require_true(i == seen++);
+          require_true(h == micron::hash<hash64_t>(pk[i].a));
+        });
+    require_true(seen == 29);
+  }
+  sb::end_test_case();
+
+  sb::test_case("string keys, bucketed by length, match hash<hash64_t>");
+  {
+    // a third share one length, a few are past the 32 byte kernel, the rest spread over 0 .. 32
+    static micron::string ks[150];
+    for ( usize i = 0; i < 150; ++i ) {
+      const usize l = i % 7 == 0 ? 40 + i % 9 : (i % 3 == 0 ? 8 : (i * 13) % 33);
+      for ( usize c = 0; c < l; ++c ) ks[i].push_back(static_cast<char>('!' + (i * 31 + c * 7) % 90));
+    }
+    hash64_t out[150];
+    for ( usize n = 0; n <= 150; n += (n < 70 ? 1 : 20) ) {
+      micron::hash_batch(ks, n, out);
+      for ( usize i = 0; i < n; ++i ) require_true(out[i] == micron::hash<hash64_t>(ks[i]));
+    }
+    usize seen = 0;
+    micron::hash_each<micron::string>(
+        150, [&](usize i) -> const micron::string & { return ks[i]; },
+        [&](usize i, hash64_t h) {
+          require_true(i == seen++);
+          require_true(h == micron::hash<hash64_t>(ks[i]));
+        });
+    require_true(seen == 150);
+  }
+  sb::end_test_case();
+
+  print("[BATCH HASHING OK]");
+  return 1;
+}
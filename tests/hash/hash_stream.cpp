@@ -0,0 +1,159 @@
+//  Copyright (c) 2024- David Lucius Severus
+//
+//  Distributed under the Boost Software License, Version 1.0.
+//  See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt
+
+#define MICRON_ABC_MT 1      // spawns threads/coroutines; abcmalloc's -k gate must be MT (bits/__abc_mt.hpp)
+
+#include "../../src/hash/hash.hpp"
+#include "../../src/hash/tree.hpp"
+#include "../../src/hash/tree_mt.hpp"
+
+#include "../snowball/snowball.hpp"
+
+using ::sb::print;
+using ::sb::require_true;
+
+static void
+fill(byte *b, usize n)
+{
+  for ( usize i = 0; i < n; ++i ) b[i] = (byte)(i * 37 + 11);
+}
+
+constexpr usize k_big = (3u << 20) + 4097u;
+alignas(64) static byte g_big[k_big];
+
+// piece length for the k-th update of split pattern pat
+static usize
+piece(u32 pat, usize k, usize len)
+{
+  switch ( pat ) {
+  case 0:
+    return 1;
+  case 1:
+    return len;
+  case 2:
+    return 7;
+  case 3:
+    return 31 + (k % 3);      // straddles a 32-byte stripe / block
+  case 4:
+    return 112;
+  case 5:
+    return 113;
+  default:
+    return 1 + (k * 41 + 17) % 150;
+  }
+}
+
+int
+main()
+{
+  print("=== MICRON STREAMING / TREE HASH ===");
+  alignas(64) byte buf[1024];
+  fill(buf, 1024);
+  fill(g_big, k_big);
+  const u64 seeds[] = { 0, micron::default_seed, ~u64{ 0 } };
+
+  sb::test_case("xxhash64 / rapidhash streaming == one-shot, every split");
+  {
+    for ( u64 seed : seeds )
+      for ( usize len = 0; len <= 700; ++len )
+        for ( u32 pat = 0; pat < 7; ++pat ) {
+          auto xs = micron::hashes::xxhash64_init(seed);
+          auto rs = micron::hashes::rapidhash_init(seed);
+          for ( usize off = 0, k = 0; off < len; ++k ) {
+            usize n = piece(pat, k, len);
+            if ( n > len - off ) n = len - off;
+            micron::hashes::xxhash64_update(xs, buf + off, n);
+            micron::hashes::rapidhash_update(rs, buf + off, n);
+            if ( k % 4 == 1 ) micron::hashes::rapidhash_update(rs, buf, 0);
+            off += n;
+          }
+          require_true(micron::hashes::xxhash64_digest(xs) == micron::hashes::xxhash64_rtseed(buf, seed, len));
+          require_true(micron::hashes::rapidhash_digest(rs) == micron::hashes::rapidhash(buf, seed, len));
+        }
+
+    // against the upstream vectors, and digest leaves the state usable
+    auto xs = micron::hashes::xxhash64_init(0);
+    micron::hashes::xxhash64_update(xs, buf, 100);
+    (void)micron::hashes::xxhash64_digest(xs);
+    micron::hashes::xxhash64_update(xs, buf + 100, 156);
+    require_true(micron::hashes::xxhash64_digest(xs) == 0x43c92f09cb3e28cfull);
+    auto rs = micron::hashes::rapidhash_init(0);
+    micron::hashes::rapidhash_update(rs, buf, 200);
+    (void)micron::hashes::rapidhash_digest(rs);
+    micron::hashes::rapidhash_update(rs, buf + 200, 56);
+    require_true(micron::hashes::rapidhash_digest(rs) == 0x0ad2e0219a3bfdb6ull);
+    require_true(micron::hashes::xxhash64_digest(micron::hashes::init_seed<0>()) == micron::hashes::xxhash64<0>(buf, 0));
+  }
+  sb::end_test_case();
+
+#if defined(__micron_hash_zzz)
+  sb::test_case("zzz streaming == one-shot, every split");
+  {
+    require_true(static_cast<u64>(micron::hashes::iv64_0) == micron::hashes::__zzzs::__iv[0]);
+    require_true(static_cast<u64>(micron::hashes::iv64_3) == micron::hashes::__zzzs::__iv[3]);
+    for ( u64 seed : seeds )
+      for ( usize len = 0; len <= 300; ++len )
+        for ( u32 pat = 0; pat < 7; ++pat ) {
+          auto zs = micron::hashes::zzz_init(static_cast<i64>(seed));
+          for ( usize off = 0, k = 0; off < len; ++k ) {
+            usize n = piece(pat, k, len);
+            if ( n > len - off ) n = len - off;
+            micron::hashes::zzz_update(zs, buf + off, n);
+            off += n;
+          }
+          alignas(32) u64 a[4], b[4];
+          micron::hashes::zzz(buf, static_cast<i64>(seed), len, a);
+          micron::hashes::zzz_digest(zs, b);
+          require_true(a[0] == b[0] && a[1] == b[1] && a[2] == b[2] && a[3] == b[3]);
+          require_true(micron::hashes::zzz64_digest(zs) == micron::hashes::zzz64(buf, static_cast<i64>(seed), len));
+          require_true(micron::hashes::zzz128_digest(zs).a == micron::hashes::zzz128(buf, static_cast<i64>(seed), len).a);
+        }
+  }
+  sb::end_test_case();
+#endif
+
+  sb::test_case("large buffers streamed in uneven pieces");
+  {
+    auto xs = micron::hashes::xxhash64_init(micron::default_seed);
+    auto rs = micron::hashes::rapidhash_init(micron::default_seed);
+    for ( usize off = 0, k = 0; off < k_big; ++k ) {
+      usize n = 1 + (k * 7919) % 65537;
+      if ( n > k_big - off ) n = k_big - off;
+      micron::hashes::xxhash64_update(xs, g_big + off, n);
+      micron::hashes::rapidhash_update(rs, g_big + off, n);
+      off += n;
+    }
+    require_true(micron::hashes::xxhash64_digest(xs) == micron::hashes::xxhash64_rtseed(g_big, micron::default_seed, k_big));
+    require_true(micron::hashes::rapidhash_digest(rs) == micron::hashes::rapidhash(g_big, micron::default_seed, k_big));
+  }
+  sb::end_test_case();
+
+  sb::test_case("tree_hash: flat up to a chunk, tree_hash_mt == tree_hash");
+  {
+    using micron::hash_types;
+    require_true(micron::tree_hash_leaves(micron::hash_tree_chunk) == 0);
+    require_true(micron::tree_hash_leaves(micron::hash_tree_chunk + 1) == 2);
+    require_true(micron::tree_hash<hash_types::xxhash64>(buf, 1000, 7, 1000) == micron::hashes::xxhash64_rtseed(buf, 7, 1000));
+    require_true(micron::tree_hash<hash_types::rapidhash>(buf, 1000, 7, 1000) == micron::hashes::rapidhash(buf, 7, 1000));
+    require_true(micron::tree_hash<hash_types::xxhash64>(buf, 1001, 7, 1000) != micron::hashes::xxhash64_rtseed(buf, 7, 1001));
+
+    const usize lens[] = { 4096, 4097, 40000, k_big };
+    for ( usize len : lens ) {
+      require_true(micron::tree_hash_mt<hash_types::xxhash64>(g_big, len, 3, 4096)
+                   == micron::tree_hash<hash_types::xxhash64>(g_big, len, 3, 4096));
+      require_true(micron::tree_hash_mt<hash_types::rapidhash>(g_big, len, 3, 4096)
+                   == micron::tree_hash<hash_types::rapidhash>(g_big, len, 3, 4096));
+      require_true(micron::tree_hash_mt(g_big, len) == micron::tree_hash(g_big, len));
+    }
+    // the chunk is part of the function
+    require_true(micron::tree_hash<hash_types::rapidhash>(g_big, 40000, 3, 4096)
+                 != micron::tree_hash<hash_types::rapidhash>(g_big, 40000, 3, 8192));
+  }
+  sb::end_test_case();
+
+  print("[STREAMING / TREE HASH OK]");
+  return 1;
+}
@@ -0,0 +1,272 @@
+//  Copyright (c) 2024- David Lucius Severus
+//
+//  Distributed under the Boost Software License, Version 1.0.
+//  See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt
+
+#define MICRON_ABC_MT 1      // spawns threads/coroutines; abcmalloc's -k gate must be MT (bits/__abc_mt.hpp)
+
+#include "../../src/io/console.hpp"
+#include "../../src/list.hpp"
+#include "../../src/maps/rb_map.hpp"
+#include "../../src/string/strings.hpp"
+#include "../../src/trees/b.hpp"
+#include "../../src/trees/rb.hpp"
+#include "../../src/vector/vector.hpp"
+
+#include "../snowball/snowball.hpp"
+
+#include "../support/mt.hpp"      // mtest::parallel + micron atomic_token (NOT <thread>/<atomic>)
+
+using namespace snowball;
+
+struct req_tag {
+};
+
+struct node_tag {
+};
+
+using mono = micron::monotonic_allocator<req_tag>;
+using pool = micron::pool_allocator<node_tag>;
+
+static bool
+zeroed(const byte *p, usize n)
+{
+  for ( usize i = 0; i < n; ++i )
+    if ( p[i] != 0 ) return false;
+  return true;
+}
+
+static void
+test_monotonic()
+{
+  sb::print("=== monotonic_allocator ===");
+
+  sb::test_case("bumps are aligned, zeroed and disjoint");
+  {
+    micron::chunk<byte> a = mono::create(3);
+    micron::chunk<byte> b = mono::create(40);
+    sb::require_true(a.len == 16 and b.len == 48);
+    sb::require_true(reinterpret_cast<uintptr_t>(a.ptr) % 16 == 0 and reinterpret_cast<uintptr_t>(b.ptr) % 16 == 0);
+    sb::require_true(b.ptr == a.ptr + a.len);
+    sb::require_true(zeroed(b.ptr, b.len));
+    mono::release();
+    sb::require(mono::footprint(), usize{ 0 });
+  }
+  sb::end_test_case();
+
+  sb::test_case("top allocation grows in place and rolls back");
+  {
+    micron::chunk<byte> a = mono::create(64);
+    a.ptr[0] = 0x7f;
+    micron::chunk<byte> g = mono::grow(a, 100);
+    sb::require_true(g.ptr == a.ptr and g.len >= 128 and g.ptr[0] == 0x7f);
+    mono::destroy(g);
+    micron::chunk<byte> c = mono::create(32);
+    sb::require_true(c.ptr == a.ptr and zeroed(c.ptr, c.len));
+    mono::release();
+  }
+  sb::end_test_case();
+
+  sb::test_case("request scoped containers, one release");
+  {
+    {
+      micron::vector<u64, mono> v;
+      micron::hstring<char, true, mono> s;
+      for ( u64 i = 0; i < 20000; ++i ) {
+        v.push_back(i * 3);
+        s.push_back(static_cast<char>('a' + i % 26));
+      }
+      for ( u64 i = 0; i < 20000; ++i ) sb::require(v[i], i * 3);
+      sb::require(s.size(), usize{ 20000 });
+      sb::require_true(mono::footprint() > 20000 * sizeof(u64));
+    }
+    mono::release();
+    sb::require(mono::footprint(), usize{ 0 });
+  }
+  sb::end_test_case();
+}
+
+static void
+test_pool()
+{
+  sb::print("=== pool_allocator ===");
+
+  sb::test_case("freed blocks are recycled per size class, zeroed");
+  {
+    micron::chunk<byte> a = pool::create(24);
+    sb::require(a.len, usize{ 32 });
+    a.ptr[5] = 0x11;
+    pool::destroy(a);
+    micron::chunk<byte> b = pool::create(20);
+    sb::require_true(b.ptr == a.ptr and zeroed(b.ptr, b.len));
+    micron::chunk<byte> c = pool::create(200);
+    sb::require(c.len, usize{ 256 });
+    sb::require_true(c.ptr != b.ptr);
+    pool::destroy(b);
+    pool::destroy(c);
+  }
+  sb::end_test_case();
+
+  sb::test_case("list nodes churn without growing the pool");
+  {
+    {
+      micron::list<int, pool> l;
+      for ( int i = 0; i < 5000; ++i ) l.push_front(i);
+      const usize held = pool::footprint();
+      for ( int r = 0; r < 10; ++r ) {
+        for ( int i = 0; i < 5000; ++i ) l.erase(l.ibegin());
+        sb::require_true(l.empty());
+        for ( int i = 0; i < 5000; ++i ) l.push_front(i);
+      }
+      sb::require(pool::footprint(), held);
+      int expect = 4999;
+      bool ok = true;
+      l.for_each([&](int x) { ok = ok and x == expect--; });
+      sb::require_true(ok);
+    }
+    pool::release();
+    sb::require(pool::footprint(), usize{ 0 });
+  }
+  sb::end_test_case();
+
+  sb::test_case("blocks destroyed on another thread go back to the carving thread");
+  {
+    static micron::chunk<byte> held[512];
+    for ( usize i = 0; i < 512; ++i ) held[i] = pool::create(64);
+    const usize held_bytes = pool::footprint();
+    micron::atomic_token<u64> bad(0);
+    mtest::parallel(2, [&bad](int t) {
+      for ( usize i = static_cast<usize>(t); i < 512; i += 2 ) pool::destroy(held[i]);
+      // nothing was carved here and nothing landed on this thread's lists
+      if ( pool::footprint() != 0 ) bad.fetch_add(1, micron::memory_order_relaxed);
+      micron::chunk<byte> own = pool::create(64);
+      for ( usize i = 0; i < 512; ++i )
+        if ( own.ptr == held[i].ptr ) bad.fetch_add(1, micron::memory_order_relaxed);
+      pool::destroy(own);
+      pool::release();
+    });
+    sb::require(bad.get(micron::memory_order_relaxed), u64{ 0 });
+    // the carving thread gets every block back before it maps another slab
+    for ( usize i = 0; i < 512; ++i ) {
+      micron::chunk<byte> c = pool::create(64);
+      sb::require_true(zeroed(c.ptr, c.len));
+      held[i] = c;
+    }
+    sb::require(pool::footprint(), held_bytes);
+    for ( usize i = 0; i < 512; ++i ) pool::destroy(held[i]);
+    pool::release();
+    sb::require(pool::footprint(), usize{ 0 });
+  }
+  sb::end_test_case();
+}
+
+static void
+test_tree_nodes()
+{
+  sb::print("=== tree nodes ===");
+
+  sb::test_case("rb_tree nodes come from the pool and are recycled");
+  {
+    {
+      micron::rb_tree<int, micron::default_less<int>, pool> t;
+      for ( int i = 0; i < 4000; ++i ) t.insert(i * 7 % 4000);
+      const usize held = pool::footprint();
+      sb::require_true(held >= 4000 * sizeof(micron::rb_node<int>));
+      for ( int r = 0; r < 5; ++r ) {
+        for ( int i = 0; i < 4000; i += 2 ) sb::require_true(t.erase(i));
+        for ( int i = 0; i < 4000; i += 2 ) t.insert(i);
+      }
+      sb::require(pool::footprint(), held);
+      sb::require(t.size(), usize{ 4000 });
+      micron::rb_tree<int, micron::default_less<int>, pool> c(t);
+      for ( int i = 0; i < 4000; ++i ) sb::require_true(c.contains(i));
+    }
+    pool::release();
+    sb::require(pool::footprint(), usize{ 0 });
+  }
+  sb::end_test_case();
+
+  sb::test_case("rb_map with a NodeAlloc behaves like the default");
+  {
+    {
+      micron::rb_map<u64, u64, micron::allocator_serial<>, pool> m;
+      for ( u64 i = 0; i < 3000; ++i ) m.insert(i, i + 1);
+      for ( u64 i = 0; i < 3000; i += 3 ) sb::require_true(m.erase(i));
+      for ( u64 i = 0; i < 3000; ++i ) {
+        u64 *p = m.find(i);
+        if ( i % 3 == 0 )
+          sb::require_true(p == nullptr);
+        else
+          sb::require_true(p != nullptr and *p == i + 1);
+      }
+    }
+    pool::release();
+  }
+  sb::end_test_case();
+
+  sb::test_case("b_tree node arena on a monotonic arena, one release");
+  {
+    {
+      micron::b_tree<int, int, micron::b_default_less<int>, 0, mono> t;
+      for ( int i = 0; i < 20000; ++i ) t.insert(i * 13 % 20000, i);
+      sb::require(t.size(), usize{ 20000 });
+      for ( int i = 0; i < 20000; i += 2 ) t.erase(i);
+      for ( int i = 0; i < 20000; ++i ) sb::require(t.contains(i), (i & 1) != 0);
+      sb::require_true(mono::footprint() > 0);
+    }
+    mono::release();
+    sb::require(mono::footprint(), usize{ 0 });
+  }
+  sb::end_test_case();
+}
+
+// default Tag from several threads at once: every thread gets its own arena and pool
+static void
+test_default_tag_threads()
+{
+  sb::print("=== default Tag, thread_local arenas ===");
+
+  sb::test_case("concurrent create / destroy / release never hand one block to two threads");
+  {
+    using dmono = micron::monotonic_allocator<>;
+    using dpool = micron::pool_allocator<>;
+    micron::atomic_token<u64> bad(0);
+    mtest::parallel(4, [&bad](int t) {
+      const byte mark = static_cast<byte>(0x40 + t);
+      micron::chunk<byte> held[64];
+      for ( int r = 0; r < 200; ++r ) {
+        for ( usize i = 0; i < 64; ++i ) {
+          held[i] = (i & 1) ? dpool::create(16 + i * 8) : dmono::create(16 + i * 8);
+          if ( !zeroed(held[i].ptr, held[i].len) ) bad.fetch_add(1, micron::memory_order_relaxed);
+          micron::memset(held[i].ptr, mark, held[i].len);
+        }
+        for ( usize i = 0; i < 64; ++i ) {
+          for ( usize j = 0; j < held[i].len; ++j )
+            if ( held[i].ptr[j] != mark ) {
+              bad.fetch_add(1, micron::memory_order_relaxed);
+              break;
+            }
+          if ( i & 1 ) dpool::destroy(held[i]);
+        }
+        dmono::release();
+      }
+      dpool::release();
+      if ( dmono::footprint() != 0 or dpool::footprint() != 0 ) bad.fetch_add(1, micron::memory_order_relaxed);
+    });
+    sb::require(bad.get(micron::memory_order_relaxed), u64{ 0 });
+  }
+  sb::end_test_case();
+}
+
+int
+main()
+{
+  sb::print("=== ARENA ALLOCATORS ===");
+  test_monotonic();
+  test_pool();
+  test_tree_nodes();
+  test_default_tag_threads();
+  sb::print("=== ARENA ALLOCATORS PASSED ===");
+  return 1;
+}
@@ -449,6 +449,34 @@ main(void)
   }
   sb::end_test_case();
 
+  sb::test_case("from_range - unordered input, later duplicates win, map keeps working");
+  {
+    std::vector<micron::pair<int, int>> in;
+    constexpr int N = 20000;
+    for ( int i = 0; i < N; ++i ) in.push_back(micron::pair<int, int>{ static_cast<int>((static_cast<u64>(i) * 7919) % N), i });
+    for ( int i = 0; i < 500; ++i ) in.push_back(micron::pair<int, int>{ i, -i });
+    for ( float fill : { 1.0f, 0.6f } ) {
+      auto m = micron::btree_map<int, int>::from_range(in, fill);
+      sb::require(m.size() == static_cast<usize>(N));
+      int bad = 0;
+      for ( int i = 0; i < N; ++i ) {
+        const int *p = m.find(static_cast<int>((static_cast<u64>(i) * 7919) % N));
+        if ( !p ) ++bad;
+        else if ( static_cast<int>((static_cast<u64>(i) * 7919) % N) >= 500 && *p != i ) ++bad;
+      }
+      for ( int i = 0; i < 500; ++i )
+        if ( *m.find(i) != -i ) ++bad;
+      sb::require(bad == 0);
+      sb::require(m.find(N) == nullptr);
+
+      for ( int i = 0; i < N; i += 2 ) sb::require(m.erase(i));
+      for ( int i = N; i < N + 5000; ++i ) m.insert(i, i);
+      sb::require(m.size() == static_cast<usize>(N / 2 + 5000));
+      sb::require(m.find(1) != nullptr && m.find(2) == nullptr && *m.find(N + 4999) == N + 4999);
+    }
+  }
+  sb::end_test_case();
+
   sb::print("=== ALL BTREE MAP TESTS PASSED ===");
   return 1;
 }
@@ -9,6 +9,7 @@
 #include "../src/std.hpp"
 #include "../src/string/string.hpp"
 #include "../src/trees/b.hpp"
+#include "../src/tuple.hpp"
 
 #include "../snowball/snowball.hpp"
 
@@ -308,6 +309,54 @@ main(void)
   }
   sb::end_test_case();
 
+  sb::test_case("from_sorted - bulk load matches oracle, full and half fill");
+  {
+    for ( float fill : { 1.0f, 0.5f } ) {
+      std::vector<micron::pair<int, int>> in;
+      std::map<int, int> oracle;
+      for ( int i = 0; i < 5000; ++i ) {
+        in.push_back(micron::pair<int, int>{ i * 3, i });
+        oracle[i * 3] = i;
+      }
+      bt t = bt::from_sorted(in, fill);
+      sb::require(matches(t, oracle));
+      sb::require(*t.find(2997) == 999);
+      sb::require(t.find(1) == nullptr);
+
+      // the packed tree keeps working as an ordinary one
+      for ( int i = 0; i < 5000; i += 2 ) {
+        sb::require(t.erase(i * 3));
+        oracle.erase(i * 3);
+      }
+      for ( int i = 0; i < 3000; ++i ) {
+        t.insert_or_assign(i * 3 + 1, -i);
+        oracle[i * 3 + 1] = -i;
+      }
+      sb::require(matches(t, oracle));
+    }
+  }
+  sb::end_test_case();
+
+  sb::test_case("from_sorted - duplicates keep the last, small nodes, empty input");
+  {
+    std::vector<micron::pair<int, int>> in;
+    std::map<int, int> oracle;
+    for ( int i = 0; i < 700; ++i ) {
+      in.push_back(micron::pair<int, int>{ i / 3, i });
+      oracle[i / 3] = i;
+    }
+    bt2 t = bt2::from_sorted(in);
+    sb::require(matches(t, oracle));
+    for ( int i = 0; i < 234; ++i ) sb::require(t.erase(i));
+    sb::require(t.empty());
+
+    std::vector<micron::pair<int, int>> none;
+    bt e = bt::from_sorted(none);
+    sb::require(e.empty());
+    sb::require(e.insert(1, 1));
+  }
+  sb::end_test_case();
+
   sb::print("=== ALL TESTS PASSED ===");
   return 1;
 }
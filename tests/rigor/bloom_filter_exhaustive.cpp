@@ -97,6 +97,29 @@ main()
   }
   end_test_case();
 
+  test_case("insert_batch / contains_batch agree with the single-key forms");
+  {
+    micron::bloom_filter<int, (1u << 14)> one, many;
+    static int keys[1000];
+    static int probe[3001];
+    static bool got[3001];
+    for ( int i = 0; i < 1000; i++ ) keys[i] = i * 7 - 300;
+    for ( int i = 0; i < 3001; i++ ) probe[i] = i * 3 - 1500;
+    for ( int i = 0; i < 1000; i++ ) one.insert(keys[i]);
+    many.insert_batch(keys, 1000);
+
+    usize hits = many.contains_batch(probe, 3001, got);
+    usize expect = 0;
+    for ( int i = 0; i < 3001; i++ ) {
+      require_true(got[i] == one.contains(probe[i]));
+      require_true(many.contains(probe[i]) == one.contains(probe[i]));
+      expect += got[i];
+    }
+    require(hits, expect);
+    for ( int i = 0; i < 1000; i++ ) require_true(many.contains(keys[i]));
+  }
+  end_test_case();
+
   test_case("default L is well-sized (load-factor driven), not collapsed to ~2");
   {
 
@@ -345,6 +345,93 @@ main(void)
   }
   sb::end_test_case();
 
+  // ── group width ──────────────────────────────────────────────────────────
+
+  sb::test_case("group width - 32/64 slot groups grow, find and erase like 16");
+  {
+    micron::heap_swiss_map<int, int, micron::allocator_serial<>, false, 32> m32;
+    micron::heap_swiss_map<int, int, micron::allocator_serial<>, false, 64> m64;
+    sb::require(m32.capacity() == 32ULL);
+    sb::require(m64.capacity() == 64ULL);
+    for ( int i = 0; i < 20000; ++i ) {
+      m32.insert(i, -i);
+      m64.insert(i, -i);
+    }
+    for ( int i = 0; i < 20000; i += 2 ) {
+      sb::require(m32.erase(i));
+      sb::require(m64.erase(i));
+    }
+    for ( int i = 0; i < 20000; ++i ) {
+      sb::require(m32.contains(i) == ((i & 1) == 1));
+      sb::require(m64.contains(i) == ((i & 1) == 1));
+    }
+    sb::require(*m64.find(19999) == -19999);
+    sb::require(m32.size() == 10000ULL && m64.size() == 10000ULL);
+  }
+  sb::end_test_case();
+
+  // ── incremental growth ──────────────────────────────────────────────────
+
+  sb::test_case("incremental - the default map carries no migration state");
+  {
+    // ctrl, entries, n_slots, cap_mask, size, growth_left; the old table's four words only with Incremental
+    sb::require(sizeof(micron::heap_swiss_map<int, int>) == 6 * sizeof(usize));
+    sb::require(sizeof(micron::heap_swiss_map<int, int, micron::allocator_serial<>, true>) == 10 * sizeof(usize));
+    micron::heap_swiss_map<int, int> m;
+    for ( int i = 0; i < 5000; ++i ) m.insert(i, i);
+    sb::require(!m.migrating());
+  }
+  sb::end_test_case();
+
+  sb::test_case("incremental - lookups, erase and iteration span both tables mid-migration");
+  {
+    micron::heap_swiss_map<int, int, micron::allocator_serial<>, true> m;
+    bool saw_migration = false;
+    usize checked = 0;
+    for ( int i = 0; i < 50000; ++i ) {
+      sb::require(m.insert(i, i * 3).a);
+      if ( m.migrating() ) {
+        saw_migration = true;
+        if ( checked++ < 64 ) {
+          for ( int j = 0; j <= i; j += 97 ) sb::require(*m.find(j) == j * 3);
+          usize seen = 0;
+          for ( auto it = m.begin(); it != m.end(); ++it ) ++seen;
+          sb::require(seen == m.size());
+        }
+      }
+    }
+    sb::require(saw_migration);
+    sb::require(m.size() == 50000ULL);
+    for ( int i = 0; i < 50000; i += 2 ) sb::require(m.erase(i));
+    sb::require(m.size() == 25000ULL);
+    for ( int i = 0; i < 50000; ++i ) sb::require(m.contains(i) == ((i & 1) == 1));
+    sb::require(!m.insert(1, 0).a);      // duplicate still detected while the key sits in the old table
+  }
+  sb::end_test_case();
+
+  sb::test_case("incremental - copy, move and clear while a migration is pending");
+  {
+    micron::heap_swiss_map<int, int, micron::allocator_serial<>, true> m;
+    int n = 0;
+    while ( !m.migrating() ) {
+      m.insert(n, n);
+      ++n;
+    }
+    micron::heap_swiss_map<int, int, micron::allocator_serial<>, true> c(m);
+    sb::require(!c.migrating());
+    sb::require(c.size() == m.size());
+    for ( int i = 0; i < n; ++i ) sb::require(*c.find(i) == i);
+    micron::heap_swiss_map<int, int, micron::allocator_serial<>, true> mv(micron::move(m));
+    sb::require(mv.migrating());
+    sb::require(mv.size() == static_cast<usize>(n));
+    mv.clear();
+    sb::require(!mv.migrating());
+    sb::require(mv.empty());
+    mv.insert(7, 7);
+    sb::require(*mv.find(7) == 7);
+  }
+  sb::end_test_case();
+
   sb::print("=== ALL TESTS PASSED ===");
   return 1;
 }
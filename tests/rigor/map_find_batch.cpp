@@ -0,0 +1,92 @@
+//  Copyright (c) 2024- David Lucius Severus
+//
+//  Distributed under the Boost Software License, Version 1.0.
+//  See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt
+//
+// find_batch / contains_batch against single-key find for robin_map, heap_swiss_map and hopscotch_map.
+// batches are mixed hits and misses, with lengths on both sides of the prefetch group size.
+
+#include "../../src/io/console.hpp"
+#include "../../src/maps/heap_swiss.hpp"
+#include "../../src/maps/hopscotch.hpp"
+#include "../../src/maps/robin.hpp"
+
+#include "../snowball/snowball.hpp"
+
+static constexpr usize N = 20000;
+static constexpr usize Q = 4099;      // not a multiple of the group
+
+template<typename M>
+static void
+check_batch(M &m, const char *name)
+{
+  sb::print("--- ", name, " ---");
+  static u64 keys[Q];
+  static u32 *got[Q];
+  static const u32 *cgot[Q];
+  static bool has[Q];
+
+  sb::test_case("find_batch matches find, hits and misses");
+  {
+    for ( usize i = 0; i < Q; ++i ) keys[i] = (i * 7919u) % (2 * N) + 1;      // ~half present
+    const usize lens[] = { 0, 1, 15, 16, 17, Q };
+    for ( usize n : lens ) {
+      usize hits = m.find_batch(keys, n, got);
+      usize expect = 0;
+      for ( usize i = 0; i < n; ++i ) {
+        u32 *one = m.find(keys[i]);
+        sb::require_true(got[i] == one);
+        if ( one ) {
+          ++expect;
+          sb::require(*one, static_cast<u32>(keys[i] * 3));
+        }
+      }
+      sb::require(hits, expect);
+    }
+  }
+  sb::end_test_case();
+
+  sb::test_case("const find_batch and contains_batch agree");
+  {
+    const M &cm = m;
+    usize a = cm.find_batch(keys, Q, cgot);
+    usize b = cm.contains_batch(keys, Q, has);
+    sb::require(a, b);
+    for ( usize i = 0; i < Q; ++i ) {
+      sb::require_true(has[i] == cm.contains(keys[i]));
+      sb::require_true((cgot[i] != nullptr) == has[i]);
+    }
+  }
+  sb::end_test_case();
+}
+
+int
+main()
+{
+  sb::print("=== MAP FIND_BATCH ===");
+  {
+    micron::robin_map<u64, u32> m(4 * N);
+    for ( u64 k = 1; k <= N; ++k ) m.insert(k, static_cast<u32>(k * 3));
+    check_batch(m, "robin_map");
+  }
+  {
+    micron::heap_swiss_map<u64, u32> m;
+    for ( u64 k = 1; k <= N; ++k ) m.insert(k, static_cast<u32>(k * 3));
+    check_batch(m, "heap_swiss_map");
+  }
+  {
+    micron::hopscotch_map<u64, u32> m;
+    for ( u64 k = 1; k <= N; ++k ) m.insert(k, static_cast<u32>(k * 3));
+    check_batch(m, "hopscotch_map");
+  }
+  {
+    micron::robin_map<u64, u32> empty(16);
+    u64 k = 5;
+    u32 *out = reinterpret_cast<u32 *>(1);
+    sb::require(empty.find_batch(&k, 1, &out), usize{ 0 });
+    sb::require_true(out == nullptr);
+  }
+  sb::print("=== MAP FIND_BATCH PASSED ===");
+  return 1;
+}
@@ -148,6 +148,11 @@ main()
           mpn::mul_with<mpn::algo::toom4>(g_t4, g_a, an, g_b, bn, g_sc);
           require_true(same(g_ref, g_t4, an + bn));
 
+#if defined(__micron_arch_width_64)
+          mpn::mul_with<mpn::algo::nussbaumer>(g_t4, g_a, an, g_b, bn, g_sc);
+          require_true(same(g_ref, g_t4, an + bn));
+#endif
+
           mpn::mul(g_bc, g_a, an, g_b, bn, g_sc);
           require_true(same(g_ref, g_bc, an + bn));
         }
@@ -178,6 +183,11 @@ main()
         require_true(same(g_ref, g_tm, 2u * n));
         require_true(same(g_ref, g_t4, 2u * n));
 
+#if defined(__micron_arch_width_64)
+        mpn::sqr_with<mpn::algo::nussbaumer>(g_t4, g_a, n, g_sc);
+        require_true(same(g_ref, g_t4, 2u * n));
+#endif
+
         mpn::sqr(g_bc, g_a, n, g_sc);
         require_true(same(g_ref, g_bc, 2u * n));
       }
@@ -0,0 +1,153 @@
+// math_arbint_ntt.cpp
+// The FFT tier at the sizes it is built for.
+//
+// math_arbint_mul.cpp already pins the NTT against a schoolbook on small operands; here it runs
+// where the ladder actually selects it — at the mul / sqr thresholds and +/- 1, unbalanced, and
+// far past them — and must agree bit for bit with toom-4, the tier below. The parallel variant
+// must reproduce the serial NTT exactly, including across its recombine block seams.
+
+#define MICRON_ABC_MT 1      // spawns threads/coroutines; abcmalloc's -k gate must be MT (bits/__abc_mt.hpp)
+
+#include "../../src/math/arbint.hpp"
+#include "../../src/math/arbint/mul_ntt_mt.hpp"
+#include "../../src/std.hpp"
+
+#include "../snowball/snowball.hpp"
+#include "../support/oracles.hpp"
+
+using sb::end_test_case;
+using sb::print;
+using sb::require;
+using sb::require_true;
+using sb::test_case;
+
+using mtest::prng;
+namespace mpn = micron::math::mpn;
+
+using buf = micron::vector<mpn::limb_t>;
+
+static bool
+same(const mpn::limb_t *x, const mpn::limb_t *y, usize n) noexcept
+{
+  for ( usize i = 0; i < n; ++i )
+    if ( x[i] != y[i] ) return false;
+  return true;
+}
+
+static void
+fill(prng &rng, mpn::limb_t *p, usize n, u32 pattern) noexcept
+{
+  for ( usize i = 0; i < n; ++i ) p[i] = (pattern == 1u) ? mpn::limb_max : static_cast<mpn::limb_t>(rng.next());
+  if ( n > 0 && p[n - 1u] == 0 ) p[n - 1u] = 1;
+}
+
+// toom-4 where it applies, karatsuba otherwise; the reference for everything above it
+static void
+below(mpn::limb_t *rp, const mpn::limb_t *ap, usize an, const mpn::limb_t *bp, usize bn)
+{
+  buf sc(mpn::mul_itch_with<mpn::algo::toom4>(an, bn) + 1u, mpn::limb_t{ 0 });
+  mpn::mul_with<mpn::algo::toom4>(rp, ap, an, bp, bn, sc.data());
+}
+
+int
+main()
+{
+  print("=== ARBINT NTT ===");
+
+#if defined(__micron_arch_width_64)
+  static_assert(mpn::tiers_built == mpn::algo::nussbaumer);
+
+  test_case("mul: the automatic ladder at the FFT threshold agrees with toom-4");
+  {
+    prng rng(0xA5A5F00DULL);
+    const usize t = mpn::threshold::mul_nussbaumer;
+    const usize sizes[] = { t - 1u, t, t + 1u, 3u * t + 7u };
+    for ( usize n : sizes )
+      for ( u32 p = 0; p < 2u; ++p ) {
+        buf a(n, 0), b(n, 0), r0(2u * n, 0), r1(2u * n, 0), sc(mpn::mul_itch(n, n) + 1u, 0);
+        fill(rng, a.data(), n, p);
+        fill(rng, b.data(), n, p);
+        below(r0.data(), a.data(), n, b.data(), n);
+        mpn::mul(r1.data(), a.data(), n, b.data(), n, sc.data());
+        require_true(same(r0.data(), r1.data(), 2u * n));
+      }
+  }
+  end_test_case();
+
+  test_case("mul: unbalanced operands go through the NTT whole");
+  {
+    prng rng(0x5151ULL);
+    const usize an = 5u * mpn::threshold::mul_nussbaumer + 3u, bn = mpn::threshold::mul_nussbaumer + 11u;
+    buf a(an, 0), b(bn, 0), r0(an + bn, 0), r1(an + bn, 0), sc(mpn::mul_ntt_itch(an, bn), 0);
+    fill(rng, a.data(), an, 0);
+    fill(rng, b.data(), bn, 0);
+    buf ks(mpn::mul_itch_forced(an, bn) + 1u, 0);
+    mpn::mul_with<mpn::algo::karatsuba>(r0.data(), a.data(), an, b.data(), bn, ks.data());
+    mpn::mul_ntt(r1.data(), a.data(), an, b.data(), bn, sc.data());
+    require_true(same(r0.data(), r1.data(), an + bn));
+  }
+  end_test_case();
+
+  test_case("sqr: the NTT square agrees with the general product");
+  {
+    prng rng(0x0DDBA11ULL);
+    const usize t = mpn::threshold::sqr_nussbaumer;
+    const usize sizes[] = { t - 1u, t, t + 1u, 2u * t + 5u };
+    for ( usize n : sizes )
+      for ( u32 p = 0; p < 2u; ++p ) {
+        buf a(n, 0), r0(2u * n, 0), r1(2u * n, 0), sc(mpn::sqr_itch(n) + 1u, 0);
+        fill(rng, a.data(), n, p);
+        below(r0.data(), a.data(), n, a.data(), n);
+        mpn::sqr(r1.data(), a.data(), n, sc.data());
+        require_true(same(r0.data(), r1.data(), 2u * n));
+      }
+  }
+  end_test_case();
+
+  test_case("mul_ntt_mt / sqr_ntt_mt reproduce the serial NTT");
+  {
+    prng rng(0xC0C0A5ULL);
+    // an + bn spans several recombine blocks, all-ones operands carry across every seam
+    const usize an = 3u * mpn::ntt_mt_chunk / 2u + 17u, bn = mpn::ntt_mt_chunk / 3u;
+    for ( u32 p = 0; p < 2u; ++p ) {
+      buf a(an, 0), b(bn, 0), r0(an + bn, 0), r1(an + bn, 0);
+      fill(rng, a.data(), an, p);
+      fill(rng, b.data(), bn, p);
+      buf s0(mpn::mul_ntt_itch(an, bn), 0), s1(mpn::mul_ntt_mt_itch(an, bn), 0);
+      mpn::mul_ntt(r0.data(), a.data(), an, b.data(), bn, s0.data());
+      mpn::mul_ntt_mt(r1.data(), a.data(), an, b.data(), bn, s1.data());
+      require_true(same(r0.data(), r1.data(), an + bn));
+
+      buf q0(2u * an, 0), q1(2u * an, 0);
+      buf t0(mpn::sqr_ntt_itch(an), 0), t1(mpn::sqr_ntt_mt_itch(an), 0);
+      mpn::sqr_ntt(q0.data(), a.data(), an, t0.data());
+      mpn::sqr_ntt_mt(q1.data(), a.data(), an, t1.data());
+      require_true(same(q0.data(), q1.data(), 2u * an));
+    }
+  }
+  end_test_case();
+
+  test_case("arbuint products above the threshold round-trip through division");
+  {
+    using U = micron::math::arbuint<>;
+    prng rng(0xB16B00B5ULL);
+    const usize n = mpn::threshold::mul_nussbaumer + 100u;
+    U a, b;
+    for ( usize i = 0; i < n; ++i ) {
+      a <<= 64;
+      a += U(rng.next() | 1u);
+      b <<= 64;
+      b += U(rng.next() | 1u);
+    }
+    const U c = a * b;
+    require_true(c / a == b);
+    require_true((c % b).is_zero());
+  }
+  end_test_case();
+#else
+  print("    32-bit limbs: no FFT tier, nothing to run");
+#endif
+
+  print("=== ARBINT NTT PASSED ===");
+  return 1;
+}
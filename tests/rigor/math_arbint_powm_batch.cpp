@@ -0,0 +1,259 @@
+// math_arbint_powm_batch.cpp
+// Batched and fixed-base modular exponentiation.
+//
+// Every lane family the machine has is pinned in turn and each job of a batch must agree with mpn::powm run on its
+// own: odd and even moduli mixed, zero exponents and bases, bases wider than the modulus, a last group of one. The
+// fixed-base context must reproduce powm for exponents of every length it covers, one at a time or batched, and the
+// engine front-ends must reproduce the serial batch.
+
+#define MICRON_ABC_MT 1      // spawns threads/coroutines; abcmalloc's -k gate must be MT (bits/__abc_mt.hpp)
+
+#include "../../src/math/arbint.hpp"
+#include "../../src/math/arbint/powm_batch_mt.hpp"
+#include "../../src/std.hpp"
+
+#include "../snowball/snowball.hpp"
+#include "../support/oracles.hpp"
+
+using sb::end_test_case;
+using sb::print;
+using sb::require;
+using sb::require_true;
+using sb::test_case;
+
+using mtest::prng;
+namespace mpn = micron::math::mpn;
+
+using buf = micron::vector<mpn::limb_t>;
+
+constexpr static const mpn::limb_t CANARY = static_cast<mpn::limb_t>(0x5A5A5A5A5A5A5A5Aull);
+
+static bool
+same(const mpn::limb_t *x, const mpn::limb_t *y, usize n) noexcept
+{
+  for ( usize i = 0; i < n; ++i )
+    if ( x[i] != y[i] ) return false;
+  return true;
+}
+
+static void
+fill(prng &rng, mpn::limb_t *p, usize n) noexcept
+{
+  for ( usize i = 0; i < n; ++i ) p[i] = static_cast<mpn::limb_t>(rng.next());
+}
+
+// count jobs over n-limb moduli, every limb of operands and results in one buffer
+struct batch {
+  usize n, count;
+  buf b, e, m, r;
+  micron::vector<mpn::powm_job> jobs;
+
+  batch(prng &rng, usize n_, usize count_) : n(n_), count(count_), b(count_ * 2u * n_, 0), e(count_ * n_, 0), m(count_ * n_, 0),
+                                             r(count_ * n_, 0), jobs(count_, mpn::powm_job{})
+  {
+    for ( usize i = 0; i < count; ++i ) {
+      mpn::limb_t *bp = b.data() + i * 2u * n, *ep = e.data() + i * n, *mp = m.data() + i * n;
+      fill(rng, bp, 2u * n);
+      fill(rng, ep, n);
+      fill(rng, mp, n);
+      mp[0] |= 1u;
+      mp[n - 1u] |= 1u;
+      usize bn = 1u + static_cast<usize>(rng.next() % (2u * n));
+      usize en = static_cast<usize>(rng.next() % (n + 1u));
+      if ( i % 5u == 3u ) mp[0] &= ~mpn::limb_t{ 1 };      // even: the scalar path, mid batch
+      if ( i % 7u == 2u ) en = 0;
+      if ( i % 7u == 4u ) bn = 0;
+      if ( i % 11u == 6u ) mp[n - 1u] = mpn::limb_max;
+      if ( n == 1u && i == 8u ) mp[0] = 1u;
+      jobs.data()[i] = mpn::powm_job{ r.data() + i * n, bp, bn, ep, en, mp };
+    }
+  }
+
+  // every job against mpn::powm alone
+  bool
+  check() const
+  {
+    buf want(n, 0), sc(mpn::powm_itch(n, 2u * n, 64u * n), 0);
+    for ( usize i = 0; i < count; ++i ) {
+      const mpn::powm_job &j = jobs.data()[i];
+      mpn::powm(want.data(), j.bp, j.bn, j.ep, j.en, j.mp, n, sc.data());
+      if ( !same(want.data(), j.rp, n) ) return false;
+    }
+    return true;
+  }
+};
+
+int
+main()
+{
+  print("=== ARBINT POWM BATCH ===");
+
+  const mpn::powm_isa host = mpn::active_powm_isa();
+  print("    host lanes: ", static_cast<u64>(mpn::powm_batch_lanes(host)));
+
+  test_case("powm_batch agrees with powm on every lane family");
+  {
+    prng rng(0xBA7C4ED5ULL);
+    for ( u32 k = 0; k <= static_cast<u32>(host); ++k ) {
+      mpn::set_powm_isa(static_cast<mpn::powm_isa>(k));
+      require_true(mpn::active_powm_isa() == static_cast<mpn::powm_isa>(k));
+      const usize sizes[] = { 1u, 2u, 3u, 8u, 17u, 32u };
+      for ( usize n : sizes ) {
+        // 8 lanes twice, a third group of one
+        batch t(rng, n, 17u);
+        const usize itch = mpn::powm_batch_itch(n, 2u * n, 64u * n);
+        buf sc(itch + 1u, 0);
+        sc.data()[itch] = CANARY;
+        mpn::powm_batch(t.jobs.data(), t.count, n, sc.data());
+        require_true(sc.data()[itch] == CANARY);
+        require_true(t.check());
+      }
+    }
+  }
+  end_test_case();
+
+  test_case("powm_batch at 2048 bits, full groups");
+  {
+    prng rng(0x2048ULL);
+    batch t(rng, 32u, 16u);
+    for ( usize i = 0; i < t.count; ++i ) {
+      t.jobs.data()[i].bn = 32u;
+      t.jobs.data()[i].en = 32u;
+      t.m.data()[i * 32u] |= 1u;
+    }
+    buf sc(mpn::powm_batch_itch(32u, 32u, 2048u), 0);
+    mpn::powm_batch(t.jobs.data(), t.count, 32u, sc.data());
+    require_true(t.check());
+  }
+  end_test_case();
+
+  test_case("fixed base: every exponent length the table covers, one at a time and batched");
+  {
+    prng rng(0xF1BA5EULL);
+    for ( u32 k = 0; k <= static_cast<u32>(host); ++k ) {
+      mpn::set_powm_isa(static_cast<mpn::powm_isa>(k));
+      const usize sizes[] = { 1u, 4u, 16u };
+      for ( usize n : sizes ) {
+        const usize ebits = 64u * n, bn = n + 1u, w = 2u + n % 4u;
+        buf b(bn, 0), m(n, 0);
+        fill(rng, b.data(), bn);
+        fill(rng, m.data(), n);
+        m.data()[0] |= 1u;
+        m.data()[n - 1u] |= mpn::limb_msb;
+
+        const usize tl = mpn::powm_fb_table_limbs(n, ebits, w);
+        buf tbl(tl + 1u, 0), ms(mpn::powm_fb_make_itch(n, bn), 0);
+        tbl.data()[tl] = CANARY;
+        const mpn::powm_fb_ctx c = mpn::powm_fb_make(tbl.data(), b.data(), bn, m.data(), n, ebits, w, ms.data());
+        require_true(tbl.data()[tl] == CANARY);
+
+        const usize count = 11u;
+        buf e(count * n, 0), r(count * n, 0), one(n, 0), want(n, 0);
+        buf ps(mpn::powm_itch(n, bn, ebits), 0);
+        micron::vector<mpn::powm_fb_job> jobs(count, mpn::powm_fb_job{});
+        for ( usize i = 0; i < count; ++i ) {
+          mpn::limb_t *ep = e.data() + i * n;
+          fill(rng, ep, n);
+          // 0, 1 .. ebits bits long
+          const usize bits = i * ebits / (count - 1u);
+          for ( usize q = 0; q < n; ++q ) {
+            const usize lo = q * mpn::limb_bits;
+            if ( bits <= lo )
+              ep[q] = 0;
+            else if ( bits - lo < mpn::limb_bits )
+              ep[q] &= (mpn::limb_t{ 1 } << (bits - lo)) - 1u;
+          }
+          jobs.data()[i] = mpn::powm_fb_job{ r.data() + i * n, ep, n };
+        }
+
+        const usize fi = mpn::powm_fb_itch(n);
+        buf fs(fi + 1u, 0);
+        fs.data()[fi] = CANARY;
+        mpn::powm_fb_batch(c, jobs.data(), count, fs.data());
+        require_true(fs.data()[fi] == CANARY);
+        for ( usize i = 0; i < count; ++i ) {
+          mpn::powm(want.data(), b.data(), bn, e.data() + i * n, n, m.data(), n, ps.data());
+          require_true(same(want.data(), r.data() + i * n, n));
+          mpn::powm_fb(c, one.data(), e.data() + i * n, n, fs.data());
+          require_true(same(want.data(), one.data(), n));
+        }
+      }
+    }
+  }
+  end_test_case();
+
+  test_case("fixed base: exponents past the table fall back to powm, mixed into lane groups");
+  {
+    prng rng(0x70106ULL);
+    for ( u32 k = 0; k <= static_cast<u32>(host); ++k ) {
+      mpn::set_powm_isa(static_cast<mpn::powm_isa>(k));
+      const usize sizes[] = { 1u, 4u, 16u };
+      for ( usize n : sizes ) {
+        // the table covers half the limbs, every third exponent is twice that long
+        const usize ebits = 32u * n, w = 3u;
+        buf b(n, 0), m(n, 0);
+        fill(rng, b.data(), n);
+        fill(rng, m.data(), n);
+        m.data()[0] |= 1u;
+        m.data()[n - 1u] |= mpn::limb_msb;
+        buf tbl(mpn::powm_fb_table_limbs(n, ebits, w), 0), ms(mpn::powm_fb_make_itch(n, n), 0);
+        const mpn::powm_fb_ctx c = mpn::powm_fb_make(tbl.data(), b.data(), n, m.data(), n, ebits, w, ms.data());
+
+        const usize count = 13u;
+        buf e(count * 2u * n, 0), r(count * n, 0), one(n, 0), want(n, 0), ps(mpn::powm_itch(n, n, 128u * n), 0);
+        fill(rng, e.data(), count * 2u * n);
+        micron::vector<mpn::powm_fb_job> jobs(count, mpn::powm_fb_job{});
+        for ( usize i = 0; i < count; ++i ) {
+          const usize en = i % 3u == 0u ? n / 2u : (i % 3u == 1u ? n : 2u * n);
+          jobs.data()[i] = mpn::powm_fb_job{ r.data() + i * n, e.data() + i * 2u * n, en };
+        }
+        buf fs(mpn::powm_fb_itch(n), 0);
+        mpn::powm_fb_batch(c, jobs.data(), count, fs.data());
+        for ( usize i = 0; i < count; ++i ) {
+          const mpn::powm_fb_job &j = jobs.data()[i];
+          mpn::powm(want.data(), b.data(), n, j.ep, j.en, m.data(), n, ps.data());
+          require_true(same(want.data(), j.rp, n));
+          mpn::powm_fb(c, one.data(), j.ep, j.en, fs.data());
+          require_true(same(want.data(), one.data(), n));
+        }
+      }
+    }
+  }
+  end_test_case();
+
+  mpn::set_powm_isa(host);
+
+  test_case("powm_batch_mt / powm_fb_batch_mt reproduce the serial batch");
+  {
+    prng rng(0x3EEDULL);
+    const usize n = 8u, count = 45u;
+    batch t(rng, n, count);
+    buf sc(mpn::powm_batch_mt_itch(count, n, 2u * n, 64u * n), 0);
+    mpn::powm_batch_mt(t.jobs.data(), count, n, sc.data());
+    require_true(t.check());
+    // sized before the runtime started, the running engine must not change it
+    require_true(mpn::powm_batch_mt_itch(count, n, 2u * n, 64u * n) == sc.size());
+
+    buf b(n, 0), m(n, 0), e(count * n, 0), r0(count * n, 0), r1(count * n, 0);
+    fill(rng, b.data(), n);
+    fill(rng, m.data(), n);
+    fill(rng, e.data(), count * n);
+    m.data()[0] |= 1u;
+    m.data()[n - 1u] |= mpn::limb_msb;
+    buf tbl(mpn::powm_fb_table_limbs(n, 64u * n, 4u), 0), ms(mpn::powm_fb_make_itch(n, n), 0);
+    const mpn::powm_fb_ctx c = mpn::powm_fb_make(tbl.data(), b.data(), n, m.data(), n, 64u * n, 4u, ms.data());
+    micron::vector<mpn::powm_fb_job> j0(count, mpn::powm_fb_job{}), j1(count, mpn::powm_fb_job{});
+    for ( usize i = 0; i < count; ++i ) {
+      j0.data()[i] = mpn::powm_fb_job{ r0.data() + i * n, e.data() + i * n, n };
+      j1.data()[i] = mpn::powm_fb_job{ r1.data() + i * n, e.data() + i * n, n };
+    }
+    buf s0(mpn::powm_fb_itch(n), 0), s1(mpn::powm_fb_batch_mt_itch(c, count), 0);
+    mpn::powm_fb_batch(c, j0.data(), count, s0.data());
+    mpn::powm_fb_batch_mt(c, j1.data(), count, s1.data());
+    require_true(same(r0.data(), r1.data(), count * n));
+  }
+  end_test_case();
+
+  print("=== ARBINT POWM BATCH PASSED ===");
+  return 1;
+}
@@ -0,0 +1,191 @@
+// math_arbint_tuning.cpp
+// The runtime crossover tables.
+//
+// Every table is pinned in turn and the ladders must follow it, at its own seams, on scratch sized
+// by the *_itch functions to the limb — a canary past the end catches a table that picks a tier the
+// promise did not cover. Products are checked against an inline schoolbook, quotients by q d + r.
+
+#include "../../src/math/arbint.hpp"
+#include "../../src/std.hpp"
+
+#include "../snowball/snowball.hpp"
+#include "../support/oracles.hpp"
+
+using sb::end_test_case;
+using sb::print;
+using sb::require;
+using sb::require_true;
+using sb::test_case;
+
+using mtest::prng;
+namespace mpn = micron::math::mpn;
+
+using buf = micron::vector<mpn::limb_t>;
+
+constexpr static const mpn::limb_t CANARY = static_cast<mpn::limb_t>(0x5A5A5A5A5A5A5A5Aull);
+constexpr static const usize MAX_SEAM = 2048;
+
+static void
+ref_mul(mpn::limb_t *r, const mpn::limb_t *a, usize an, const mpn::limb_t *b, usize bn) noexcept
+{
+  for ( usize i = 0; i < an + bn; ++i ) r[i] = 0;
+  for ( usize i = 0; i < an; ++i ) {
+    mpn::limb_t cy = 0;
+    for ( usize j = 0; j < bn; ++j ) {
+      const mpn::dlimb_t t = static_cast<mpn::dlimb_t>(a[i]) * b[j] + r[i + j] + cy;
+      r[i + j] = mpn::lo_half(t);
+      cy = mpn::hi_half(t);
+    }
+    r[i + bn] = static_cast<mpn::limb_t>(r[i + bn] + cy);
+  }
+}
+
+static bool
+same(const mpn::limb_t *x, const mpn::limb_t *y, usize n) noexcept
+{
+  for ( usize i = 0; i < n; ++i )
+    if ( x[i] != y[i] ) return false;
+  return true;
+}
+
+static void
+fill(prng &rng, mpn::limb_t *p, usize n) noexcept
+{
+  for ( usize i = 0; i < n; ++i ) p[i] = static_cast<mpn::limb_t>(rng.next());
+  if ( n > 0 && p[n - 1u] == 0 ) p[n - 1u] = 1;
+}
+
+static bool
+below(const mpn::tuning &lo, const mpn::tuning &t) noexcept
+{
+  return lo.mul_comba <= t.mul_comba && lo.mul_karatsuba <= t.mul_karatsuba && lo.mul_toom3 <= t.mul_toom3 && lo.mul_toom4 <= t.mul_toom4
+         && lo.mul_nussbaumer <= t.mul_nussbaumer && lo.sqr_comba <= t.sqr_comba && lo.sqr_karatsuba <= t.sqr_karatsuba
+         && lo.sqr_toom3 <= t.sqr_toom3 && lo.sqr_toom4 <= t.sqr_toom4 && lo.sqr_nussbaumer <= t.sqr_nussbaumer && lo.div_dc <= t.div_dc
+         && lo.div_mu <= t.div_mu;
+}
+
+// a * b through the ladder on exactly mul_itch limbs; false on a wrong product or a trampled canary
+static bool
+mul_seam(prng &rng, usize an, usize bn)
+{
+  buf a(an, 0), b(bn, 0), r0(an + bn, 0), r1(an + bn, 0);
+  const usize itch = mpn::mul_itch(an, bn);
+  buf sc(itch + 1u, 0);
+  sc.data()[itch] = CANARY;
+  fill(rng, a.data(), an);
+  fill(rng, b.data(), bn);
+  ref_mul(r0.data(), a.data(), an, b.data(), bn);
+  mpn::mul(r1.data(), a.data(), an, b.data(), bn, sc.data());
+  return same(r0.data(), r1.data(), an + bn) && sc.data()[itch] == CANARY;
+}
+
+static bool
+sqr_seam(prng &rng, usize n)
+{
+  buf a(n, 0), r0(2u * n, 0), r1(2u * n, 0);
+  const usize itch = mpn::sqr_itch(n);
+  buf sc(itch + 1u, 0);
+  sc.data()[itch] = CANARY;
+  fill(rng, a.data(), n);
+  ref_mul(r0.data(), a.data(), n, a.data(), n);
+  mpn::sqr(r1.data(), a.data(), n, sc.data());
+  return same(r0.data(), r1.data(), 2u * n) && sc.data()[itch] == CANARY;
+}
+
+// {np, nn} = q d + r with r < d, on exactly divrem_itch limbs
+static bool
+div_seam(prng &rng, usize nn, usize dn)
+{
+  buf n(nn, 0), d(dn, 0), q(nn - dn + 1u, 0), r(dn, 0), back(nn + 1u, 0);
+  fill(rng, n.data(), nn);
+  fill(rng, d.data(), dn);
+  const usize itch = mpn::divrem_itch(nn, dn);
+  buf sc(itch + 1u, 0);
+  sc.data()[itch] = CANARY;
+  mpn::divrem(q.data(), r.data(), n.data(), nn, d.data(), dn, sc.data());
+  if ( sc.data()[itch] != CANARY || mpn::cmp(r.data(), d.data(), dn) >= 0 ) return false;
+  ref_mul(back.data(), q.data(), nn - dn + 1u, d.data(), dn);
+  (void)mpn::add(back.data(), back.data(), nn + 1u, r.data(), dn);
+  return same(back.data(), n.data(), nn) && back.data()[nn] == 0;
+}
+
+int
+main()
+{
+  print("=== ARBINT TUNING ===");
+
+  const mpn::tuning_arch host = mpn::active_tuning_arch();
+  print("    host table: ", mpn::tuning_arch_name(host));
+
+  test_case("constant evaluation runs the compiled table");
+  {
+    static_assert(mpn::pick_mul(mpn::threshold::mul_karatsuba, mpn::threshold::mul_karatsuba) == mpn::algo::karatsuba
+                  || mpn::threshold::mul_karatsuba == mpn::threshold::mul_toom3);
+    static_assert(mpn::pick_sqr(1) == mpn::algo::basecase);
+    static_assert(mpn::tuning_ascends(mpn::threshold::compiled));
+    require_true(mpn::tuning_ascends(mpn::threshold::lowest));
+  }
+  end_test_case();
+
+  test_case("cpu signatures map onto their tables");
+  {
+    using V = mpn::tuning_vendor;
+    using A = mpn::tuning_arch;
+    require_true(mpn::tuning_arch_of({ V::amd, 0x17u, 0x08u }) == A::zen);
+    require_true(mpn::tuning_arch_of({ V::amd, 0x19u, 0x21u }) == A::zen3);
+    require_true(mpn::tuning_arch_of({ V::intel, 6u, 0x3cu }) == A::haswell);
+    require_true(mpn::tuning_arch_of({ V::intel, 6u, 0x55u }) == A::skylake);
+    require_true(mpn::tuning_arch_of({ V::intel, 6u, 0x9eu }) == A::skylake);
+    // atom / xeon phi / newer cores are not skylake-like
+    require_true(mpn::tuning_arch_of({ V::intel, 6u, 0x5cu }) == A::compiled);
+    require_true(mpn::tuning_arch_of({ V::intel, 6u, 0x57u }) == A::compiled);
+    require_true(mpn::tuning_arch_of({ V::intel, 6u, 0x86u }) == A::compiled);
+    require_true(mpn::tuning_arch_of({ V::intel, 6u, 0xbeu }) == A::compiled);
+    require_true(mpn::tuning_arch_of({ V::intel, 6u, 0x8fu }) == A::compiled);
+    require_true(mpn::tuning_arch_of({ V::intel, 6u, 0x1au }) == A::compiled);
+    require_true(mpn::tuning_arch_of({ V::unknown, 0u, 0u }) == A::compiled);
+  }
+  end_test_case();
+
+  test_case("every table keeps lowest as its floor and the ladders follow it");
+  {
+    prng rng(0x7E57AB1EULL);
+    for ( u32 k = 0; k < mpn::tuning_arch_count; ++k ) {
+      const mpn::tuning_arch arch = static_cast<mpn::tuning_arch>(k);
+      mpn::set_tuning_arch(arch);
+      const mpn::tuning &t = mpn::current_tuning();
+      require_true(&t == &mpn::tuning_table(mpn::active_tuning_arch()));
+      require_true(below(mpn::threshold::lowest, t));
+
+      // the runtime table only moves the seams when the build leaves them unpinned
+      if ( mpn::threshold::runtime_tuning ) require_true(mpn::active_tuning_arch() == arch);
+      require_true(mpn::pick_mul(t.mul_karatsuba, t.mul_karatsuba) == mpn::pick_mul(t, t.mul_karatsuba, t.mul_karatsuba));
+      if ( t.mul_comba < t.mul_karatsuba ) require_true(mpn::pick_mul(t.mul_karatsuba - 1u, 200u) == mpn::algo::comba);
+
+      const usize seams[] = { t.mul_karatsuba, t.sqr_karatsuba, t.mul_toom3, t.sqr_toom3, t.mul_toom4, t.sqr_toom4 };
+      for ( usize s : seams ) {
+        if ( s > MAX_SEAM ) continue;
+        for ( usize n = s - 1u; n <= s + 1u; ++n ) {
+          require_true(mul_seam(rng, n, n));
+          require_true(mul_seam(rng, n + n / 2u + 3u, n));
+          require_true(sqr_seam(rng, n));
+        }
+      }
+
+      const usize dseams[] = { t.div_dc, t.div_mu };
+      for ( usize s : dseams ) {
+        if ( s > MAX_SEAM ) continue;
+        for ( usize dn = s - 1u; dn <= s + 1u; ++dn ) {
+          require_true(div_seam(rng, 2u * dn + 1u, dn));
+          require_true(div_seam(rng, 4u * dn, dn));
+        }
+      }
+    }
+  }
+  end_test_case();
+
+  mpn::set_tuning_arch(host);
+
+  print("=== ARBINT TUNING PASSED ===");
+  return 1;
+}
@@ -0,0 +1,214 @@
+// math_blas_gemm_mt.cpp — Snowball tests for the multithreaded packed
+// GEMM at blas/gemm_mt.hpp.
+//
+// Same scheme as math_blas_gemm_blocked: every case runs the product
+// through gemm_mt and through a scalar triple loop and compares the
+// relative residual.  Each case is run once per kernel family the
+// machine has (native, then avx512 / neon when present), so both the
+// runtime-selected microkernel and the build-time one are covered.
+
+#define MICRON_ABC_MT 1      // spawns threads/coroutines; abcmalloc's -k gate must be MT (bits/__abc_mt.hpp)
+
+#include "../../src/math/blas/blas.hpp"
+#include "../../src/math/blas/gemm_mt.hpp"
+#include "../../src/math/matrix/matrices.hpp"
+#include "../../src/std.hpp"
+#include "../../src/vector/vector.hpp"
+
+#include "../snowball/snowball.hpp"
+
+using sb::end_test_case;
+using sb::print;
+using sb::require;
+using sb::require_true;
+using sb::test_case;
+
+using namespace micron;
+using namespace micron::math;
+
+template<typename T>
+static T
+fabs_(T x) noexcept
+{
+  return x < T(0) ? -x : x;
+}
+
+template<typename T>
+static void
+ref_gemm(bool trA, bool trB, usize m, usize n, usize k, T alpha, const T *A, usize lda, const T *B, usize ldb, T beta, T *C,
+         usize ldc) noexcept
+{
+  for ( usize i = 0; i < m; ++i ) {
+    for ( usize j = 0; j < n; ++j ) {
+      T s{};
+      for ( usize p = 0; p < k; ++p ) {
+        const T a = trA ? A[p * lda + i] : A[i * lda + p];
+        const T b = trB ? B[j * ldb + p] : B[p * ldb + j];
+        s = s + a * b;
+      }
+      T &c = C[i * ldc + j];
+      c = alpha * s + beta * c;
+    }
+  }
+}
+
+template<typename T>
+static void
+fill_pattern(T *p, usize len, u64 seed) noexcept
+{
+  u64 x = seed | 1u;
+  for ( usize i = 0; i < len; ++i ) {
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    const u64 m = x & 0xFFFFFFu;
+    p[i] = T(f64(m) / f64(0x1000000) - 0.5);
+  }
+}
+
+template<typename T>
+static T
+max_rel_residual(const T *X, const T *Y, usize n) noexcept
+{
+  T num{};
+  T den{};
+  for ( usize i = 0; i < n; ++i ) {
+    const T d = fabs_(X[i] - Y[i]);
+    if ( d > num ) num = d;
+    const T y = fabs_(Y[i]);
+    if ( y > den ) den = y;
+  }
+  return den > T(0) ? num / den : num;
+}
+
+template<typename T>
+static void
+run_case(usize m, usize n, usize k, bool trA, bool trB, T alpha, T beta, u64 seed, T tol)
+{
+  const usize a_rows = trA ? k : m;
+  const usize a_cols = trA ? m : k;
+  const usize b_rows = trB ? n : k;
+  const usize b_cols = trB ? k : n;
+
+  dynmat<T> A(a_rows, a_cols);
+  dynmat<T> B(b_rows, b_cols);
+  dynmat<T> C0(m, n);
+  fill_pattern(A.data(), a_rows * a_cols, seed);
+  fill_pattern(B.data(), b_rows * b_cols, seed ^ 0xDEADBEEFu);
+  fill_pattern(C0.data(), m * n, seed ^ 0xCAFEBABEu);
+
+  dynmat<T> C_ref = C0;
+  ref_gemm<T>(trA, trB, m, n, k, alpha, A.data(), a_cols, B.data(), b_cols, beta, C_ref.data(), n);
+
+  const blas::gemm_isa hw = blas::active_gemm_isa();
+  const blas::gemm_isa isas[2] = { blas::gemm_isa::native, hw };
+  for ( usize v = 0; v < (hw == blas::gemm_isa::native ? 1u : 2u); ++v ) {
+    blas::set_gemm_isa(isas[v]);
+    dynmat<T> C_mt = C0;
+    auto Av = as_row_view(A);
+    auto Bv = as_row_view(B);
+    auto Cv = as_row_view(C_mt);
+    if ( !trA && !trB )
+      blas::level3::gemm_mt(alpha, Av, Bv, beta, Cv);
+    else if ( !trA && trB )
+      blas::level3::gemm_mt<blas::op::none, blas::op::trans>(alpha, Av, Bv, beta, Cv);
+    else if ( trA && !trB )
+      blas::level3::gemm_mt<blas::op::trans, blas::op::none>(alpha, Av, Bv, beta, Cv);
+    else
+      blas::level3::gemm_mt<blas::op::trans, blas::op::trans>(alpha, Av, Bv, beta, Cv);
+    require_true(max_rel_residual<T>(C_mt.data(), C_ref.data(), m * n) < tol);
+  }
+  blas::set_gemm_isa(hw);
+}
+
+int
+main()
+{
+  print("=== BLAS L3 MULTITHREADED GEMM TESTS ===");
+
+  test_case("small problems take the serial kernel");
+  {
+    run_case<f64>(7, 11, 13, false, false, 1.0, 0.0, 0x10ull, 1e-10);
+    run_case<f64>(64, 64, 64, true, false, 1.0, 0.5, 0x11ull, 1e-10);
+  }
+  end_test_case();
+
+  test_case("square, every transpose, alpha / beta combinations");
+  {
+    run_case<f64>(256, 256, 256, false, false, 1.0, 0.0, 0x200ull, 1e-10);
+    run_case<f64>(256, 256, 256, false, false, 1.0, 1.0, 0x201ull, 1e-10);
+    run_case<f64>(256, 256, 256, true, false, 2.5, -1.5, 0x202ull, 1e-10);
+    run_case<f64>(256, 256, 256, false, true, 1.0, 0.0, 0x203ull, 1e-10);
+    run_case<f64>(256, 256, 256, true, true, 0.5, 2.0, 0x204ull, 1e-10);
+  }
+  end_test_case();
+
+  test_case("ragged dims: partial MR / NR tiles and partial MC / KC blocks");
+  {
+    run_case<f64>(173, 197, 301, false, false, 1.0, 0.0, 0x300ull, 1e-10);
+    run_case<f64>(173, 197, 301, true, true, 1.0, 1.0, 0x301ull, 1e-10);
+    run_case<f64>(97, 389, 513, false, true, -1.0, 0.5, 0x302ull, 1e-10);
+  }
+  end_test_case();
+
+  test_case("skinny M splits the N panel across workers");
+  {
+    run_case<f64>(24, 1031, 200, false, false, 1.0, 0.0, 0x400ull, 1e-10);
+    run_case<f64>(13, 700, 700, true, false, 1.0, 1.0, 0x401ull, 1e-10);
+  }
+  end_test_case();
+
+  test_case("wide N spans more than one NC panel");
+  {
+    run_case<f32>(100, 4500, 120, false, false, 1.0f, 0.0f, 0x500ull, 1e-4f);
+  }
+  end_test_case();
+
+  test_case("f32");
+  {
+    run_case<f32>(256, 256, 256, false, false, 1.0f, 0.0f, 0x600ull, 1e-4f);
+    run_case<f32>(173, 197, 301, true, false, 1.0f, 1.0f, 0x601ull, 1e-4f);
+    run_case<f32>(173, 197, 301, false, true, 0.5f, -1.0f, 0x602ull, 1e-4f);
+  }
+  end_test_case();
+
+  test_case("f32 either side of the zmm cutoff, and n short of one zmm tile");
+  {
+    run_case<f32>(640, 640, 640, false, false, 1.0f, 0.0f, 0x610ull, 1e-4f);
+    run_case<f32>(700, 650, 610, true, true, 1.0f, 1.0f, 0x611ull, 1e-4f);
+    run_case<f32>(2000, 24, 2000, false, false, 1.0f, 0.0f, 0x612ull, 1e-4f);
+  }
+  end_test_case();
+
+  test_case("column-major raw entry point");
+  {
+    const usize m = 150, n = 170, k = 190;
+    dynmat<f64> A(k, m), B(n, k), C(n, m);      // column-major A is m x k with lda = m, stored as k rows of m
+    fill_pattern(A.data(), m * k, 0x700ull);
+    fill_pattern(B.data(), k * n, 0x701ull);
+    fill_pattern(C.data(), m * n, 0x702ull);
+    dynmat<f64> R = C;
+    // column-major C = A * B is row-major C^T = B^T * A^T
+    ref_gemm<f64>(false, false, n, m, k, 1.0, B.data(), k, A.data(), m, 1.0, R.data(), m);
+    blas::level3::gemm_col_mt<f64>(false, false, m, n, k, 1.0, A.data(), m, B.data(), k, 1.0, C.data(), m);
+    require_true(max_rel_residual<f64>(C.data(), R.data(), m * n) < 1e-10);
+  }
+  end_test_case();
+
+  test_case("C aliasing an input routes through the serial staged path");
+  {
+    const usize d = 128;
+    dynmat<f64> A(d, d), B(d, d);
+    fill_pattern(A.data(), d * d, 0x800ull);
+    fill_pattern(B.data(), d * d, 0x801ull);
+    dynmat<f64> R = A;
+    ref_gemm<f64>(false, false, d, d, d, 1.0, A.data(), d, B.data(), d, 0.0, R.data(), d);
+    auto Av = as_row_view(A);
+    blas::level3::gemm_mt(1.0, Av, as_row_view(B), 0.0, Av);
+    require_true(max_rel_residual<f64>(A.data(), R.data(), d * d) < 1e-10);
+  }
+  end_test_case();
+
+  print("=== BLAS L3 MULTITHREADED GEMM TESTS PASSED ===");
+  return 1;
+}
@@ -0,0 +1,280 @@
+// math_linalg_blocked.cpp — Snowball tests for the blocked, multithreaded
+// LU / Cholesky / QR at linalg/blocked.hpp.
+//
+// Every factorization is checked by reconstruction (PA = LU, LL^T = A,
+// QR = A, Q^T Q = I) on sizes that are not multiples of the panel width,
+// with a small panel width so the lookahead path runs many steps, and
+// against the unblocked routines where the result is unique.
+
+#define MICRON_ABC_MT 1      // spawns threads/coroutines; abcmalloc's -k gate must be MT (bits/__abc_mt.hpp)
+
+#include "../../src/math/linalg/blocked.hpp"
+#include "../../src/math/matrix/matrices.hpp"
+#include "../../src/std.hpp"
+#include "../../src/vector/vector.hpp"
+
+#include "../snowball/snowball.hpp"
+
+using sb::end_test_case;
+using sb::print;
+using sb::require;
+using sb::require_true;
+using sb::test_case;
+
+using namespace micron;
+using namespace micron::math;
+
+static f64
+fabs_(f64 x) noexcept
+{
+  return x < 0 ? -x : x;
+}
+
+static u64 g_seed = 0x9e3779b97f4a7c15ull;
+
+static f64
+rnd() noexcept
+{
+  g_seed ^= g_seed << 13;
+  g_seed ^= g_seed >> 7;
+  g_seed ^= g_seed << 17;
+  return static_cast<f64>(g_seed >> 11) * (1.0 / 9007199254740992.0) * 2.0 - 1.0;
+}
+
+static dynmat<f64>
+random_mat(usize r, usize c)
+{
+  dynmat<f64> A(r, c);
+  for ( usize i = 0; i < r; ++i )
+    for ( usize j = 0; j < c; ++j ) A.at(i, j) = rnd();
+  return A;
+}
+
+// A A^T + n I
+static dynmat<f64>
+random_spd(usize n)
+{
+  dynmat<f64> B = random_mat(n, n);
+  dynmat<f64> A(n, n);
+  for ( usize i = 0; i < n; ++i )
+    for ( usize j = 0; j < n; ++j ) {
+      f64 s = (i == j) ? f64(n) : 0.0;
+      for ( usize p = 0; p < n; ++p ) s += B.at(i, p) * B.at(j, p);
+      A.at(i, j) = s;
+    }
+  return A;
+}
+
+static f64
+max_abs(const dynmat<f64> &A)
+{
+  f64 m = 0;
+  for ( usize i = 0; i < A.rows; ++i )
+    for ( usize j = 0; j < A.cols; ++j )
+      if ( fabs_(A.at(i, j)) > m ) m = fabs_(A.at(i, j));
+  return m;
+}
+
+// max |(PA - LU)_ij| / max |A_ij|
+static f64
+lu_residual(const dynmat<f64> &A, const linalg::decomp::lu_pivot_result_dyn<f64> &lu)
+{
+  const usize n = A.rows;
+  f64 e = 0;
+  for ( usize i = 0; i < n; ++i )
+    for ( usize j = 0; j < n; ++j ) {
+      f64 s = 0;
+      for ( usize p = 0; p <= (i < j ? i : j); ++p ) s += (p == i ? 1.0 : lu.LU.at(i, p)) * lu.LU.at(p, j);
+      const f64 d = fabs_(A.at(lu.perm.data()[i], j) - s);
+      if ( d > e ) e = d;
+    }
+  return e / max_abs(A);
+}
+
+static f64
+chol_residual(const dynmat<f64> &A, const dynmat<f64> &L)
+{
+  const usize n = A.rows;
+  f64 e = 0;
+  for ( usize i = 0; i < n; ++i )
+    for ( usize j = 0; j < n; ++j ) {
+      f64 s = 0;
+      for ( usize p = 0; p < n; ++p ) s += L.at(i, p) * L.at(j, p);
+      const f64 d = fabs_(A.at(i, j) - s);
+      if ( d > e ) e = d;
+    }
+  return e / max_abs(A);
+}
+
+static f64
+qr_residual(const dynmat<f64> &A, const dynmat<f64> &Q, const dynmat<f64> &R)
+{
+  f64 e = 0;
+  for ( usize i = 0; i < A.rows; ++i )
+    for ( usize j = 0; j < A.cols; ++j ) {
+      f64 s = 0;
+      for ( usize p = 0; p < A.rows; ++p ) s += Q.at(i, p) * R.at(p, j);
+      const f64 d = fabs_(A.at(i, j) - s);
+      if ( d > e ) e = d;
+    }
+  return e / max_abs(A);
+}
+
+static f64
+orth_residual(const dynmat<f64> &Q)
+{
+  f64 e = 0;
+  for ( usize i = 0; i < Q.cols; ++i )
+    for ( usize j = 0; j < Q.cols; ++j ) {
+      f64 s = 0;
+      for ( usize p = 0; p < Q.rows; ++p ) s += Q.at(p, i) * Q.at(p, j);
+      const f64 d = fabs_(s - (i == j ? 1.0 : 0.0));
+      if ( d > e ) e = d;
+    }
+  return e;
+}
+
+static bool
+upper_triangular(const dynmat<f64> &R)
+{
+  for ( usize i = 0; i < R.rows; ++i )
+    for ( usize j = 0; j < i and j < R.cols; ++j )
+      if ( R.at(i, j) != 0.0 ) return false;
+  return true;
+}
+
+int
+main()
+{
+  print("=== BLOCKED LU / CHOLESKY / QR ===");
+
+  test_case("blocked LU: PA = LU over ragged sizes and panel widths");
+  {
+    const usize sizes[] = { 1, 7, 33, 97, 150, 301 };
+    const usize nbs[] = { 8, 32, 0 };
+    for ( usize n : sizes )
+      for ( usize nb : nbs ) {
+        dynmat<f64> A = random_mat(n, n);
+        auto lu = linalg::decomp::lu_pivot_blocked(A, nb);
+        require_true(!lu.singular);
+        require_true(lu_residual(A, lu) < 1e-12);
+        // partial pivoting keeps every multiplier in [-1, 1]
+        bool bounded = true;
+        for ( usize i = 0; i < n; ++i )
+          for ( usize j = 0; j < i; ++j )
+            if ( fabs_(lu.LU.at(i, j)) > 1.0 ) bounded = false;
+        require_true(bounded);
+      }
+  }
+  end_test_case();
+
+  test_case("blocked LU: sign matches the permutation, lu_solve works on the result");
+  {
+    const usize n = 130;
+    dynmat<f64> A = random_mat(n, n);
+    auto lu = linalg::decomp::lu_pivot_blocked(A, 16);
+    // parity of perm by cycle count
+    micron::vector<u8, micron::allocator_serial<>, false> seen(n, u8{ 0 });
+    usize cycles = 0;
+    for ( usize i = 0; i < n; ++i ) {
+      if ( seen.data()[i] ) continue;
+      ++cycles;
+      for ( usize j = i; !seen.data()[j]; j = lu.perm.data()[j] ) seen.data()[j] = 1;
+    }
+    require(lu.sign, ((n - cycles) & 1) ? -1 : 1);
+
+    dynvec<f64> x(n), b(n);
+    for ( usize i = 0; i < n; ++i ) x[i] = rnd();
+    for ( usize i = 0; i < n; ++i ) {
+      f64 s = 0;
+      for ( usize j = 0; j < n; ++j ) s += A.at(i, j) * x[j];
+      b[i] = s;
+    }
+    linalg::decomp::lu_solve(lu, b);
+    f64 e = 0;
+    for ( usize i = 0; i < n; ++i )
+      if ( fabs_(b[i] - x[i]) > e ) e = fabs_(b[i] - x[i]);
+    require_true(e < 1e-9);
+  }
+  end_test_case();
+
+  test_case("blocked LU: a zero column is reported singular");
+  {
+    dynmat<f64> A = random_mat(100, 100);
+    for ( usize i = 0; i < 100; ++i ) A.at(i, 57) = 0.0;
+    auto lu = linalg::decomp::lu_pivot_blocked(A, 16);
+    require_true(lu.singular);
+  }
+  end_test_case();
+
+  test_case("blocked Cholesky: LL^T = A and matches the unblocked factor");
+  {
+    const usize sizes[] = { 1, 9, 64, 129, 257 };
+    const usize nbs[] = { 8, 48, 0 };
+    for ( usize n : sizes )
+      for ( usize nb : nbs ) {
+        dynmat<f64> A = random_spd(n);
+        auto c = linalg::spd::chol_blocked(A, nb);
+        require_true(c.spd);
+        require_true(chol_residual(A, c.L) < 1e-13);
+        auto u = linalg::spd::chol(A);
+        f64 e = 0;
+        for ( usize i = 0; i < n; ++i )
+          for ( usize j = 0; j < n; ++j )
+            if ( fabs_(c.L.at(i, j) - u.L.at(i, j)) > e ) e = fabs_(c.L.at(i, j) - u.L.at(i, j));
+        require_true(e < 1e-10);
+      }
+  }
+  end_test_case();
+
+  test_case("blocked Cholesky: an indefinite matrix is rejected");
+  {
+    dynmat<f64> A = random_spd(120);
+    A.at(90, 90) = -1.0;
+    auto c = linalg::spd::chol_blocked(A, 16);
+    require_true(!c.spd);
+  }
+  end_test_case();
+
+  test_case("blocked QR: QR = A, Q orthogonal, R upper, tall / square / wide");
+  {
+    const usize shapes[][2] = { { 1, 1 }, { 40, 40 }, { 203, 77 }, { 150, 150 }, { 61, 190 }, { 300, 5 } };
+    const usize nbs[] = { 8, 32, 0 };
+    for ( auto &sh : shapes )
+      for ( usize nb : nbs ) {
+        dynmat<f64> A = random_mat(sh[0], sh[1]);
+        auto qr = linalg::decomp::qr_householder_blocked(A, nb);
+        require_true(upper_triangular(qr.R));
+        require_true(qr_residual(A, qr.Q, qr.R) < 1e-12);
+        require_true(orth_residual(qr.Q) < 1e-12);
+
+        // same reflectors as the unblocked Householder QR
+        auto u = linalg::decomp::qr_householder(A);
+        f64 e = 0;
+        for ( usize i = 0; i < A.rows; ++i )
+          for ( usize j = 0; j < A.cols; ++j )
+            if ( fabs_(qr.R.at(i, j) - u.R.at(i, j)) > e ) e = fabs_(qr.R.at(i, j) - u.R.at(i, j));
+        require_true(e < 1e-10 * (1.0 + max_abs(A)));
+      }
+  }
+  end_test_case();
+
+  test_case("blocked QR, factored form: the householder sequence reproduces A");
+  {
+    dynmat<f64> A = random_mat(180, 110);
+    auto qr = linalg::decomp::qr_blocked(A, 24);
+    require(qr.Q.K, usize{ 110 });
+    require_true(upper_triangular(qr.R));
+    dynmat<f64> QR = qr.R;
+    qr.Q.apply_left(QR);
+    f64 e = 0;
+    for ( usize i = 0; i < A.rows; ++i )
+      for ( usize j = 0; j < A.cols; ++j )
+        if ( fabs_(QR.at(i, j) - A.at(i, j)) > e ) e = fabs_(QR.at(i, j) - A.at(i, j));
+    require_true(e < 1e-12 * max_abs(A) * 10);
+  }
+  end_test_case();
+
+  print("=== BLOCKED LU / CHOLESKY / QR PASSED ===");
+  return 1;
+}
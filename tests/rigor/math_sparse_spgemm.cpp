@@ -0,0 +1,152 @@
+// math_sparse_spgemm.cpp — Snowball tests for the two-phase parallel
+// spgemm at sparse/spgemm_mt.hpp.
+//
+// Operands mix column densities so a single product runs all three
+// accumulators (esc, hash, dense SPA); the parallel result must equal the
+// serial Gustavson spgemm bit for bit, structure and values.
+
+#define MICRON_ABC_MT 1      // spawns threads/coroutines; abcmalloc's -k gate must be MT (bits/__abc_mt.hpp)
+
+#include "../../src/math/sparse.hpp"
+#include "../../src/math/sparse/spgemm_mt.hpp"
+#include "../../src/std.hpp"
+
+#include "../snowball/snowball.hpp"
+
+using sb::end_test_case;
+using sb::require;
+using sb::require_true;
+using sb::test_case;
+
+namespace ms = micron::math::sparse;
+
+using F = f64;
+using I = u32;
+
+// column j has a length from a small cycle with the odd heavy column; entries are deterministic pseudo-random rows
+static ms::csc<F, I>
+mixed(usize rows, usize cols, u64 seed)
+{
+  ms::csc<F, I> A(rows, cols);
+  usize cap = 0;
+  auto len = [&](usize j) -> usize {
+    const usize l = (j % 211 == 0) ? rows / 3 : (j % 17 == 0) ? 40 : 1 + j % 6;
+    return l < rows ? l : rows;
+  };
+  for ( usize j = 0; j < cols; ++j ) cap += len(j);
+  A.inner = ms::csc<F, I>::vec_i(cap, I(0));
+  A.values = ms::csc<F, I>::vec_v(cap, F(0));
+  u64 s = seed;
+  usize p = 0;
+  for ( usize j = 0; j < cols; ++j ) {
+    const usize l = len(j);
+    const usize step = rows / l;
+    for ( usize k = 0; k < l; ++k ) {
+      s = s * 6364136223846793005ull + 1442695040888963407ull;
+      A.inner.data()[p] = static_cast<I>(k * step + (s >> 33) % step);
+      A.values.data()[p] = F(static_cast<i64>((s >> 40) % 19) - 9) * F(0.125);
+      ++p;
+    }
+    A.outer.data()[j + 1] = static_cast<I>(p);
+  }
+  return A;
+}
+
+template<class M>
+static bool
+identical(const M &X, const M &Y)
+{
+  if ( X.rows != Y.rows or X.cols != Y.cols or X.nnz() != Y.nnz() ) return false;
+  for ( usize i = 0; i < X.outer.size(); ++i )
+    if ( X.outer.data()[i] != Y.outer.data()[i] ) return false;
+  for ( usize i = 0; i < X.nnz(); ++i )
+    if ( X.inner.data()[i] != Y.inner.data()[i] or X.values.data()[i] != Y.values.data()[i] ) return false;
+  return true;
+}
+
+int
+main()
+{
+  sb::print("=== SPARSE SPGEMM TESTS ===");
+
+  test_case("spgemm_mt (csc) equals the serial spgemm");
+  {
+    auto A = mixed(3000, 2500, 1);
+    auto B = mixed(2500, 4000, 2);
+    auto C0 = ms::spgemm(A, B);
+    auto C1 = ms::spgemm_mt(A, B);
+    require_true(C1.nnz() > 0);
+    require_true(identical(C0, C1));
+    // exact allocation: nothing past the last column
+    require(C1.inner.size(), static_cast<usize>(C1.outer.data()[C1.cols]));
+  }
+  end_test_case();
+
+  test_case("spgemm_mt (csr) equals the transposed csc product");
+  {
+    auto A = mixed(900, 1200, 3);
+    auto B = mixed(1200, 700, 4);
+    auto Ar = ms::to_csr(A);
+    auto Br = ms::to_csr(B);
+    auto C0 = ms::to_csr(ms::spgemm(A, B));
+    auto C1 = ms::spgemm_mt(Ar, Br);
+    require(C1.rows, usize{ 900 });
+    require(C1.cols, usize{ 700 });
+    require(C1.nnz(), C0.nnz());
+    bool close = true;
+    for ( usize i = 0; i < C0.nnz(); ++i ) {
+      const F d = C0.values.data()[i] - C1.values.data()[i];
+      if ( C0.inner.data()[i] != C1.inner.data()[i] or d > 1e-12 or d < -1e-12 ) close = false;
+    }
+    require_true(close);
+  }
+  end_test_case();
+
+  test_case("triangle count of a ring with chords through A * A");
+  {
+    // undirected: i ~ i+1 and i ~ i+2 (mod n) -> every i closes {i, i+1, i+2}, n triangles
+    const usize n = 5000;
+    ms::csr<F, I> A(n, n);
+    A.inner = ms::csr<F, I>::vec_i(4 * n, I(0));
+    A.values = ms::csr<F, I>::vec_v(4 * n, F(1));
+    for ( usize i = 0; i < n; ++i ) {
+      I nb[4] = { static_cast<I>((i + n - 2) % n), static_cast<I>((i + n - 1) % n), static_cast<I>((i + 1) % n),
+                  static_cast<I>((i + 2) % n) };
+      for ( usize a = 1; a < 4; ++a )
+        for ( usize b = a; b > 0 and nb[b - 1] > nb[b]; --b ) {
+          const I t = nb[b];
+          nb[b] = nb[b - 1];
+          nb[b - 1] = t;
+        }
+      for ( usize a = 0; a < 4; ++a ) A.inner.data()[4 * i + a] = nb[a];
+      A.outer.data()[i + 1] = static_cast<I>(4 * (i + 1));
+    }
+    auto A2 = ms::spgemm_mt(A, A);
+    // trace(A^3) / 6 = sum over edges (i, j) of (A^2)(i, j) / 6
+    F tri = 0;
+    for ( usize i = 0; i < n; ++i )
+      for ( usize p = A2.outer.data()[i]; p < A2.outer.data()[i + 1]; ++p ) {
+        const usize j = A2.inner.data()[p];
+        for ( usize q = A.outer.data()[i]; q < A.outer.data()[i + 1]; ++q )
+          if ( A.inner.data()[q] == j ) tri += A2.values.data()[p];
+      }
+    require(static_cast<usize>(tri / 6), n);
+  }
+  end_test_case();
+
+  test_case("dimension mismatch and empty operands");
+  {
+    auto A = mixed(50, 40, 5);
+    auto B = mixed(30, 20, 6);
+    auto C = ms::spgemm_mt(A, B);
+    require(C.nnz(), usize{ 0 });
+    ms::csc<F, I> Z(40, 10);
+    auto D = ms::spgemm_mt(A, Z);
+    require(D.nnz(), usize{ 0 });
+    require(D.cols, usize{ 10 });
+  }
+  end_test_case();
+
+  sb::print("=== SPARSE SPGEMM TESTS PASSED ===");
+  return 1;
+}
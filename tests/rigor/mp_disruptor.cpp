@@ -0,0 +1,232 @@
+//  Copyright (c) 2024- David Lucius Severus
+//
+//  Distributed under the Boost Software License, Version 1.0.
+//  See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt
+
+#define MICRON_ABC_MT 1      // spawns threads/coroutines; abcmalloc's -k gate must be MT (bits/__abc_mt.hpp)
+
+#include "../../src/io/console.hpp"
+#include "../../src/queue/mp_disruptor.hpp"
+#include "../../src/queue/mp_disruptor_await.hpp"
+#include "../../src/tasks/tasks.hpp"
+
+#include "../snowball/snowball.hpp"
+
+#include "../support/mt.hpp"      // mtest::parallel + micron atomic_token (NOT <thread>/<atomic>)
+
+// one record travels decode -> (enrich, audit) -> persist; every stage checks what its upstreams wrote
+struct rec {
+  u64 raw;
+  u64 decoded;
+  u64 enriched;
+  u64 audited;
+};
+
+template<class Wait>
+static bool
+run_pipeline(int producers, u64 per_producer)
+{
+  micron::mp_disruptor<rec, 256, Wait> d;
+  auto decode = d.add_stage();
+  auto enrich = d.add_stage(decode);
+  auto audit = d.add_stage(decode);
+  auto persist = d.add_stage(enrich, audit);
+  const u64 total = static_cast<u64>(producers) * per_producer;
+
+  micron::atomic_token<u64> bad(0), seen(0), sum(0);
+  mtest::parallel(producers + 4, [&, producers](int w) {
+    if ( w < producers ) {
+      // producer w writes w + k * producers, every value in [0, total) exactly once
+      for ( u64 k = 0; k < per_producer; ) {
+        const usize n = (k % 3 == 0 and k + 4 <= per_producer) ? 4 : 1;
+        const usize s = d.claim(n);
+        for ( usize i = 0; i < n; ++i ) {
+          rec &r = d[s + i];
+          r.raw = static_cast<u64>(w) + (k + i) * static_cast<u64>(producers);
+          r.decoded = r.enriched = r.audited = 0;
+        }
+        d.publish(s, n);
+        k += n;
+      }
+      return;
+    }
+    const int role = w - producers;
+    u64 done = 0;
+    while ( done < total ) {
+      if ( role == 0 )
+        done += decode.process([](rec &r, usize, bool) { r.decoded = r.raw * 2 + 1; });
+      else if ( role == 1 )
+        done += enrich.process([&bad](rec &r, usize, bool) {
+          if ( r.decoded != r.raw * 2 + 1 ) bad.fetch_add(1, micron::memory_order_relaxed);
+          r.enriched = r.decoded + 7;
+        });
+      else if ( role == 2 )
+        done += audit.process([&bad](rec &r, usize, bool) {
+          if ( r.decoded != r.raw * 2 + 1 ) bad.fetch_add(1, micron::memory_order_relaxed);
+          r.audited = r.raw ^ 0x5a5a;
+        });
+      else
+        done += persist.process(
+            [&](rec &r, usize, bool) {
+              if ( r.enriched != r.raw * 2 + 8 or r.audited != (r.raw ^ 0x5a5a) ) bad.fetch_add(1, micron::memory_order_relaxed);
+              sum.fetch_add(r.raw, micron::memory_order_relaxed);
+              seen.fetch_add(1, micron::memory_order_relaxed);
+            },
+            32);
+    }
+  });
+  return bad.get(micron::memory_order_relaxed) == 0 and seen.get(micron::memory_order_relaxed) == total
+         and sum.get(micron::memory_order_relaxed) == total * (total - 1) / 2 and d.size() == 0 and persist.cursor() == total;
+}
+
+static micron::mp_disruptor<u64, 64, micron::await_wait_strategy> *g_ring;
+static micron::mp_disruptor<u64, 64, micron::await_wait_strategy>::stage g_tail;
+
+static micron::task<u64>
+drain(u64 n)
+{
+  u64 s = 0, got = 0;
+  while ( got < n ) {
+    while ( g_tail.available() == g_tail.cursor() ) co_await g_tail.async_wait();
+    got += g_tail.try_process([&s](u64 &v, usize, bool) { s += v; });
+  }
+  co_return s;
+}
+
+int
+main(void)
+{
+  sb::print("=== MP_DISRUPTOR TESTS ===");
+
+  sb::test_case("single thread - claim, publish, stage order and release");
+  {
+    micron::mp_disruptor<int, 10> d;
+    sb::require(d.capacity(), usize{ 64 });
+    auto a = d.add_stage();
+    auto b = d.add_stage(a);
+    sb::require(d.stages(), usize{ 2 });
+
+    usize s0 = d.claim(3);
+    usize s1 = d.claim(2);
+    sb::require(s0, usize{ 0 });
+    sb::require(s1, usize{ 3 });
+    for ( usize i = 0; i < 5; ++i ) d[i] = static_cast<int>(i) * 10;
+    // second run published first, the gap keeps it hidden
+    d.publish(s1, 2);
+    sb::require(a.available(), usize{ 0 });
+    d.publish(s0, 3);
+    sb::require(a.available(), usize{ 5 });
+    sb::require(b.available(), usize{ 0 });
+
+    int expect = 0;
+    bool ordered = true;
+    sb::require(a.try_process(
+                    [&](int &v, usize, bool) {
+                      if ( v != expect ) ordered = false;
+                      expect += 10;
+                      v += 1;
+                    },
+                    4),
+                usize{ 4 });
+    sb::require(b.available(), usize{ 4 });
+    sb::require(a.try_process([&](int &v, usize, bool last) {
+      if ( v != 40 or !last ) ordered = false;
+      v += 1;
+    }),
+                usize{ 1 });
+    sb::require_true(ordered);
+    usize n = 0;
+    b.try_process([&](int &v, usize s, bool) {
+      if ( v != static_cast<int>(s) * 10 + 1 ) ordered = false;
+      ++n;
+    });
+    sb::require(n, usize{ 5 });
+    sb::require_true(ordered);
+    sb::require(d.size(), usize{ 0 });
+  }
+  sb::end_test_case();
+
+  sb::test_case("full ring - try_claim refuses until the terminal stage moves");
+  {
+    micron::mp_disruptor<u64, 64> d;
+    auto a = d.add_stage();
+    for ( u64 i = 0; i < 64; ++i ) sb::require_true(d.try_push(i));
+    usize s = 0;
+    sb::require_true(!d.try_claim(1, s));
+    sb::require(a.try_process([](u64 &, usize, bool) {}, 10), usize{ 10 });
+    sb::require_true(d.try_claim(10, s));
+    sb::require(s, usize{ 64 });
+    sb::require_true(!d.try_claim(1, s));
+    d.publish(s, 10);
+    sb::require(a.available(), usize{ 74 });
+    // the second lap reads with the opposite bit parity
+    sb::require(a.try_process([](u64 &, usize, bool) {}), usize{ 64 });
+    sb::require(a.cursor(), usize{ 74 });
+  }
+  sb::end_test_case();
+
+  sb::test_case("add_stage rejects a dependency from another ring");
+  {
+    micron::mp_disruptor<int, 64> d1, d2;
+    auto a = d1.add_stage();
+    bool threw = false;
+    try {
+      (void)d2.add_stage(a);
+    } catch ( const micron::except::library_error & ) {
+      threw = true;
+    }
+    sb::require_true(threw);
+    sb::require(d2.stages(), usize{ 0 });
+  }
+  sb::end_test_case();
+
+  sb::test_case("halt wakes a blocked stage");
+  {
+    micron::mp_disruptor<int, 64, micron::futex_wait_strategy> d;
+    auto a = d.add_stage();
+    micron::atomic_token<u64> ret(99);
+    mtest::parallel(2, [&](int w) {
+      if ( w == 0 )
+        ret.store(a.process([](int &, usize, bool) {}), micron::memory_order_relaxed);
+      else {
+        for ( int i = 0; i < 2000000 and !d.halted(); ++i ) __cpu_pause();
+        d.halt();
+      }
+    });
+    sb::require(ret.get(micron::memory_order_relaxed), u64{ 0 });
+  }
+  sb::end_test_case();
+
+  sb::test_case("diamond pipeline, 3 producers, spin");
+  sb::require_true(run_pipeline<micron::spin_wait_strategy>(3, 60000));
+  sb::end_test_case();
+
+  sb::test_case("diamond pipeline, 3 producers, backoff");
+  sb::require_true(run_pipeline<micron::backoff_wait_strategy>(3, 60000));
+  sb::end_test_case();
+
+  sb::test_case("diamond pipeline, 2 producers, futex");
+  sb::require_true(run_pipeline<micron::futex_wait_strategy>(2, 60000));
+  sb::end_test_case();
+
+  sb::test_case("coroutine stage drains what a thread produces");
+  {
+    micron::mp_disruptor<u64, 64, micron::await_wait_strategy> d;
+    g_ring = &d;
+    g_tail = d.add_stage();
+    constexpr u64 N = 20000;
+    u64 got = 0;
+    mtest::parallel(2, [&](int w) {
+      if ( w == 0 )
+        for ( u64 i = 0; i < N; ++i ) g_ring->push(i);
+      else
+        got = micron::coro::sync_wait(drain(N));
+    });
+    sb::require(got, N * (N - 1) / 2);
+  }
+  sb::end_test_case();
+
+  sb::print("=== MP_DISRUPTOR TESTS PASSED ===");
+  return 1;
+}
@@ -0,0 +1,214 @@
+//  Copyright (c) 2024- David Lucius Severus
+//
+//  Distributed under the Boost Software License, Version 1.0.
+//  See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt
+
+#define MICRON_ABC_MT 1      // spawns threads/coroutines; abcmalloc's -k gate must be MT (bits/__abc_mt.hpp)
+
+#include "../../src/io/console.hpp"
+#include "../../src/trees/olc_b.hpp"
+
+#include "../snowball/snowball.hpp"
+
+#include "../support/mt.hpp"      // mtest::parallel + micron atomic_token (NOT <thread>/<atomic>)
+
+// both halves are written together, a reader that ever sees b != ~a has observed a torn value
+struct pair_v {
+  u64 a;
+  u64 b;
+};
+
+int
+main(void)
+{
+  sb::print("=== OLC_B_TREE TESTS ===");
+
+  sb::test_case("insert / find across many splits, small nodes");
+  {
+    micron::olc_b_tree<u64, u64, micron::b_default_less<u64>, 128> t;
+    constexpr u64 N = 20000;
+    // interleaved order so splits happen on both sides of existing keys
+    for ( u64 i = 0; i < N; ++i ) sb::require_true(t.insert((i * 7919) % N, i));
+    sb::require(t.size(), static_cast<usize>(N));
+    for ( u64 i = 0; i < N; ++i ) sb::require_true(t.insert((i * 7919) % N, 0) == false);
+    for ( u64 k = 0; k < N; ++k ) {
+      u64 v = ~0ull;
+      sb::require_true(t.find(k, v));
+      sb::require((v * 7919) % N, k);
+    }
+    sb::require_true(!t.contains(N));
+  }
+  sb::end_test_case();
+
+  sb::test_case("insert_or_assign overwrites, insert does not");
+  {
+    micron::olc_b_tree<u64, u64> t;
+    sb::require_true(t.insert(5, 50));
+    sb::require_true(!t.insert(5, 99));
+    sb::require(t.at(5), u64{ 50 });
+    sb::require_true(!t.insert_or_assign(5, 99));
+    sb::require(t.at(5), u64{ 99 });
+    sb::require(t.size(), usize{ 1 });
+  }
+  sb::end_test_case();
+
+  sb::test_case("range / scan / for_each are ordered and bounded");
+  {
+    micron::olc_b_tree<u64, u64, micron::b_default_less<u64>, 128> t;
+    for ( u64 k = 0; k < 4000; ++k ) t.insert(k * 2, k);
+    u64 prev = 0, n = 0;
+    bool ordered = true;
+    t.range(u64{ 101 }, u64{ 3001 }, [&](const u64 &k, const u64 &v) {
+      if ( n and k <= prev ) ordered = false;
+      if ( v * 2 != k ) ordered = false;
+      prev = k;
+      ++n;
+    });
+    sb::require_true(ordered);
+    sb::require(n, u64{ 1450 });      // even keys 102 .. 3000
+
+    u64 first = 0;
+    n = 0;
+    const usize seen = t.scan(u64{ 7 }, 10, [&](const u64 &k, const u64 &) {
+      if ( n++ == 0 ) first = k;
+    });
+    sb::require(seen, usize{ 10 });
+    sb::require(first, u64{ 8 });
+
+    n = 0;
+    sb::require(t.for_each([&](const u64 &, const u64 &) { ++n; }), usize{ 4000 });
+  }
+  sb::end_test_case();
+
+  sb::test_case("erase empties leaves and unlinks them");
+  {
+    micron::olc_b_tree<u64, u64, micron::b_default_less<u64>, 128> t;
+    constexpr u64 N = 10000;
+    for ( u64 k = 0; k < N; ++k ) t.insert(k, k);
+    for ( u64 k = 0; k < N; ++k )
+      if ( (k / 100) % 2 == 0 ) sb::require_true(t.erase(k));
+    sb::require_true(!t.erase(0));
+    sb::require(t.size(), static_cast<usize>(N / 2));
+    u64 n = 0;
+    bool ok = true;
+    t.for_each([&](const u64 &k, const u64 &) {
+      if ( (k / 100) % 2 == 0 ) ok = false;
+      ++n;
+    });
+    sb::require_true(ok);
+    sb::require(n, N / 2);
+    for ( u64 k = 0; k < N; ++k ) t.insert_or_assign(k, k + 1);
+    sb::require(t.size(), static_cast<usize>(N));
+    sb::require(t.at(0), u64{ 1 });
+    t.reclaim();
+  }
+  sb::end_test_case();
+
+  sb::test_case("a sliding window keeps the node count bounded, either direction");
+  {
+    constexpr u64 W = 1000;
+    micron::olc_b_tree<u64, u64, micron::b_default_less<u64>, 128> up;
+    for ( u64 k = 0; k < W; ++k ) up.insert(k, k);
+    const usize base = up.nodes();
+    for ( u64 i = 0; i < 200000; ++i ) {
+      up.insert(i + W, i);
+      sb::require_true(up.erase(i));
+      if ( i % 1000 == 0 ) sb::require_true(up.nodes() <= base + base / 4);
+    }
+    for ( u64 k = 200000; k < 200000 + W; ++k ) sb::require_true(up.erase(k));
+    sb::require(up.size(), usize{ 0 });
+    sb::require(up.nodes(), usize{ 1 });
+    up.reclaim();
+
+    micron::olc_b_tree<u64, u64, micron::b_default_less<u64>, 128> down;
+    for ( u64 k = 0; k < W; ++k ) down.insert(1000000 - k, k);
+    for ( u64 i = 0; i < 200000; ++i ) {
+      down.insert(1000000 - W - i, i);
+      sb::require_true(down.erase(1000000 - i));
+      if ( i % 1000 == 0 ) sb::require_true(down.nodes() <= base + base / 4);
+    }
+    u64 n = 0, last = 0;
+    bool ok = true;
+    down.for_each([&](const u64 &k, const u64 &) {
+      if ( n and k <= last ) ok = false;
+      last = k;
+      ++n;
+    });
+    sb::require_true(ok);
+    sb::require(n, W);
+    down.reclaim();
+  }
+  sb::end_test_case();
+
+  sb::test_case("at() on a missing key throws library_error");
+  {
+    micron::olc_b_tree<u64, u64> t;
+    bool threw = false;
+    try {
+      (void)t.at(1);
+    } catch ( const micron::except::library_error & ) {
+      threw = true;
+    }
+    sb::require_true(threw);
+  }
+  sb::end_test_case();
+
+  sb::test_case("concurrent writers, point readers and range scans");
+  {
+    static constexpr u64 P = 20000;
+    micron::olc_b_tree<u64, pair_v, micron::b_default_less<u64>, 256> t;
+    for ( u64 k = 0; k < 1024; ++k ) t.insert(k, pair_v{ k, ~k });
+    micron::atomic_token<u64> torn(0), misses(0), disorder(0);
+    mtest::parallel(8, [&t, &torn, &misses, &disorder](int w) {
+      if ( w < 3 ) {
+        // writers: fresh keys split leaves and inner nodes, the hot keys are rewritten under the readers
+        const u64 base = 1024 + static_cast<u64>(w) * P;
+        for ( u64 i = 0; i < P; ++i ) {
+          t.insert(base + i, pair_v{ i, ~i });
+          const u64 hot = i & 1023;
+          t.insert_or_assign(hot, pair_v{ hot + i, ~(hot + i) });
+        }
+      } else if ( w == 3 ) {
+        // churn: a private key range inserted and erased, leaves empty out and get retired
+        const u64 base = 1024 + 3 * P;
+        for ( u64 r = 0; r < 8; ++r ) {
+          for ( u64 i = 0; i < 4000; ++i ) t.insert(base + i, pair_v{ i, ~i });
+          for ( u64 i = 0; i < 4000; ++i ) t.erase(base + i);
+        }
+      } else if ( w < 6 ) {
+        for ( u64 r = 0; r < 30; ++r ) {
+          for ( u64 k = 0; k < 1024; ++k ) {
+            pair_v v{ 0, 0 };
+            if ( !t.find(k, v) )
+              misses.fetch_add(1, micron::memory_order_relaxed);
+            else if ( v.b != ~v.a )
+              torn.fetch_add(1, micron::memory_order_relaxed);
+          }
+        }
+      } else {
+        for ( u64 r = 0; r < 20; ++r ) {
+          u64 prev = 0, n = 0;
+          t.range(u64{ 0 }, u64{ 1024 }, [&](const u64 &k, const pair_v &v) {
+            if ( n and k <= prev ) disorder.fetch_add(1, micron::memory_order_relaxed);
+            if ( v.b != ~v.a ) torn.fetch_add(1, micron::memory_order_relaxed);
+            prev = k;
+            ++n;
+          });
+          if ( n != 1024 ) misses.fetch_add(1, micron::memory_order_relaxed);
+        }
+      }
+    });
+    sb::require(torn.get(micron::memory_order_relaxed), u64{ 0 });
+    sb::require(misses.get(micron::memory_order_relaxed), u64{ 0 });
+    sb::require(disorder.get(micron::memory_order_relaxed), u64{ 0 });
+    sb::require(t.size(), static_cast<usize>(1024 + 3 * P));
+    u64 n = 0;
+    t.for_each([&](const u64 &, const pair_v &) { ++n; });
+    sb::require(n, 1024 + 3 * P);
+  }
+  sb::end_test_case();
+
+  sb::print("=== OLC_B_TREE TESTS PASSED ===");
+  return 1;
+}
@@ -0,0 +1,191 @@
+//  Copyright (c) 2024- David Lucius Severus
+//
+//  Distributed under the Boost Software License, Version 1.0.
+//  See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt
+//
+// hardware counters may well be unavailable where this runs (perf_event_paranoid, VMs, containers), so the
+// hardware metrics are only checked when available() says they are live; ticks are always recorded
+
+#define MICRON_ABC_MT 1      // spawns threads/coroutines; abcmalloc's -k gate must be MT (bits/__abc_mt.hpp)
+
+#include "../../src/chrono/profile.hpp"
+#include "../../src/io/console.hpp"
+
+#include "../snowball/snowball.hpp"
+
+#include "../support/mt.hpp"      // mtest::parallel + micron atomic_token (NOT <thread>/<atomic>)
+
+namespace pf = micron::profile;
+
+static pf::region r_outer("outer");
+static pf::region r_inner("inner");
+static pf::region r_mt("mt");
+
+static volatile u64 g_sink = 0;
+
+static void
+work(u64 n)
+{
+  for ( u64 i = 0; i < n; ++i ) g_sink = g_sink + i * 3;
+}
+
+static const pf::region_stats *
+find(const pf::region_stats *rs, usize n, const char *name)
+{
+  for ( usize i = 0; i < n; ++i ) {
+    const char *a = rs[i].name, *b = name;
+    while ( *a and *a == *b ) ++a, ++b;
+    if ( *a == *b ) return &rs[i];
+  }
+  return nullptr;
+}
+
+static pf::region_stats g_rs[pf::max_regions];
+
+int
+main(void)
+{
+  sb::print("=== PROFILE TESTS ===");
+
+  sb::test_case("nested scopes record one sample each, outer covers inner");
+  {
+    for ( int k = 0; k < 100; ++k ) {
+      pf::scope o(r_outer);
+      work(200);
+      {
+        pf::scope i(r_inner);
+        work(2000);
+      }
+    }
+    const usize n = pf::snapshot(g_rs, pf::max_regions);
+    sb::require_true(n >= 3);
+    const pf::region_stats *o = find(g_rs, n, "outer"), *i = find(g_rs, n, "inner");
+    sb::require_true(o != nullptr and i != nullptr);
+    sb::require(o->id, r_outer.id());
+    sb::require((*o)[pf::metric::ticks].count, u64{ 100 });
+    sb::require((*i)[pf::metric::ticks].count, u64{ 100 });
+    sb::require_true((*o)[pf::metric::ticks].sum >= (*i)[pf::metric::ticks].sum);
+    sb::require_true((*i)[pf::metric::ticks].min <= (*i)[pf::metric::ticks].max);
+    sb::require_true((*i)[pf::metric::ticks].min > 0);
+    u64 in_buckets = 0;
+    for ( usize b = 0; b < pf::hist_buckets; ++b ) in_buckets += (*i)[pf::metric::ticks].buckets[b];
+    sb::require(in_buckets, u64{ 100 });
+    const u64 p50 = (*i)[pf::metric::ticks].quantile(0.5);
+    sb::require_true(p50 <= (*i)[pf::metric::ticks].max);
+    sb::require_true(p50 * 2 + 1 >= (*i)[pf::metric::ticks].min);
+  }
+  sb::end_test_case();
+
+  sb::test_case("hardware metrics, when available, count what the region did");
+  {
+    if ( pf::available(pf::metric::instructions) ) {
+      const usize n = pf::snapshot(g_rs, pf::max_regions);
+      const pf::region_stats *i = find(g_rs, n, "inner");
+      sb::require((*i)[pf::metric::instructions].count, u64{ 100 });
+      // 2000 iterations of a load, a multiply-add and a store, at the very least
+      sb::require_true((*i)[pf::metric::instructions].min >= 2000);
+      sb::require_true((*i)[pf::metric::instructions].max < 10000000);
+    } else {
+      sb::print("  (no hardware counters here, ticks only)");
+      const usize n = pf::snapshot(g_rs, pf::max_regions);
+      const pf::region_stats *i = find(g_rs, n, "inner");
+      sb::require((*i)[pf::metric::instructions].count, u64{ 0 });
+    }
+    sb::require_true(pf::available(pf::metric::ticks));
+  }
+  sb::end_test_case();
+
+  sb::test_case("threads record independently, snapshot merges them, exited threads still count");
+  {
+    mtest::parallel(6, [](int w) {
+      for ( int k = 0; k < 1000 + w; ++k ) {
+        pf::scope s(r_mt);
+        work(10);
+      }
+    });
+    const usize n = pf::snapshot(g_rs, pf::max_regions);
+    const pf::region_stats *m = find(g_rs, n, "mt");
+    sb::require_true(m != nullptr);
+    sb::require((*m)[pf::metric::ticks].count, u64{ 6 * 1000 + 15 });
+  }
+  sb::end_test_case();
+
+  sb::test_case("exited threads' states are taken over, not piled up");
+  {
+    auto entries = [] {
+      usize c = 0;
+      for ( const pf::__impl::__thread_state *t = pf::__impl::__threads; t != nullptr; t = t->next ) ++c;
+      return c;
+    };
+    const usize before = entries();
+    const u64 base = [] {
+      const usize n = pf::snapshot(g_rs, pf::max_regions);
+      return (*find(g_rs, n, "mt"))[pf::metric::ticks].count;
+    }();
+    for ( int wave = 0; wave < 40; ++wave )
+      mtest::parallel(4, [](int) {
+        for ( int k = 0; k < 100; ++k ) {
+          pf::scope s(r_mt);
+          work(5);
+        }
+      });
+    sb::require_true(entries() <= before + 4);
+    const usize n = pf::snapshot(g_rs, pf::max_regions);
+    sb::require((*find(g_rs, n, "mt"))[pf::metric::ticks].count, base + u64{ 40 * 4 * 100 });
+  }
+  sb::end_test_case();
+
+  sb::test_case("snapshot while other threads are recording");
+  {
+    micron::atomic_token<u64> bad(0), stop(0);
+    mtest::parallel(3, [&](int w) {
+      if ( w != 0 ) {
+        while ( stop.get(micron::memory_order_relaxed) == 0 ) {
+          pf::scope s(r_mt);
+          work(5);
+        }
+        return;
+      }
+      static pf::region_stats local[pf::max_regions];
+      u64 last = 0;
+      for ( int k = 0; k < 200; ++k ) {
+        const usize n = pf::snapshot(local, pf::max_regions);
+        const pf::region_stats *m = find(local, n, "mt");
+        const u64 c = (*m)[pf::metric::ticks].count;
+        if ( c < last ) bad.fetch_add(1, micron::memory_order_relaxed);
+        last = c;
+      }
+      stop.store(1, micron::memory_order_relaxed);
+    });
+    sb::require(bad.get(micron::memory_order_relaxed), u64{ 0 });
+  }
+  sb::end_test_case();
+
+  sb::test_case("MICRON_PROFILE_SCOPE and export_csv");
+  {
+    for ( int k = 0; k < 3; ++k ) {
+      MICRON_PROFILE_SCOPE("macro");
+      work(50);
+    }
+    const usize n = pf::snapshot(g_rs, pf::max_regions);
+    const pf::region_stats *m = find(g_rs, n, "macro");
+    sb::require_true(m != nullptr);
+    sb::require((*m)[pf::metric::ticks].count, u64{ 3 });
+
+    usize lines = 0, macro_lines = 0;
+    bool terminated = true;
+    pf::export_csv(g_rs, n, [&](const char *s, usize len) {
+      ++lines;
+      if ( len == 0 or s[len - 1] != '\n' ) terminated = false;
+      if ( len > 6 and s[0] == 'm' and s[1] == 'a' and s[2] == 'c' and s[3] == 'r' and s[4] == 'o' and s[5] == ',' ) ++macro_lines;
+    });
+    sb::require_true(terminated);
+    sb::require_true(macro_lines >= 1);
+    sb::require_true(lines >= 1 + macro_lines);
+  }
+  sb::end_test_case();
+
+  sb::print("=== PROFILE TESTS PASSED ===");
+  return 1;
+}
@@ -0,0 +1,235 @@
+// Rigor suite for micron::segvector<T, B, Alloc, Sf>.
+//
+// segvector is a lock-free, append-only concurrent vector over geometrically
+// sized segments. Single-threaded, appends/grow_by are diffed against the
+// ref_vec oracle across many segment boundaries; reference stability is
+// checked by pinning an early element's address through heavy growth, and a
+// throwing element constructor must leave balanced lifetimes behind. The
+// MULTITHREADED section (micron::auto_thread, no <thread>/<atomic>) has several
+// producers push_back / grow_by concurrently, then verifies the produced
+// multiset order-independently and that every returned index holds its value.
+//
+// Build: `duck build tests/rigor/rigor_segvector.cpp`; run `bin/rigor_segvector`.
+
+#define MICRON_ABC_MT 1      // spawns threads/coroutines; abcmalloc's -k gate must be MT (bits/__abc_mt.hpp)
+
+#include "../../src/io/console.hpp"
+
+#include "../../src/vector/segvector.hpp"
+
+#include "../../src/thread/thread.hpp"
+#include "../../src/thread/thread_types/auto_thread.hpp"
+
+#include "../snowball/snowball.hpp"
+#include "../snowball/snowball_ext.hpp"
+#include "../support/tracked_types.hpp"
+#include "../support/vector_rigor.hpp"
+
+using namespace snowball;
+using mtest::prng;
+
+static constexpr usize SCAP = 8192;
+
+static void
+ck(bool ok, const char *what, usize it)
+{
+  if ( !ok ) sb::print("\033[31mMISMATCH\033[0m op=", what, " iter=", (u64)it);
+  require(ok, true);
+}
+
+template<typename V>
+static bool
+seg_eq(const V &v, const mtest::ref_vec<SCAP> &r)
+{
+  if ( v.size() != r.len ) return false;
+  for ( usize i = 0; i < r.len; ++i )
+    if ( static_cast<u64>(v[i]) != r.buf[i] ) return false;
+  return true;
+}
+
+static void
+run_serial(void)
+{
+  test_case("sgv push_back / grow_by vs oracle across segments");
+  {
+    prng rng(0x5E61u);
+    for ( usize it = 0; it < 200; ++it ) {
+      micron::segvector<u64, 4> v;
+      mtest::ref_vec<SCAP> r;
+      while ( r.len < 3000 ) {
+        if ( rng.next() & 1 ) {
+          u64 k = rng.next();
+          ck(v.push_back(k) == r.len, "push-index", it);
+          r.push_back(k);
+        } else {
+          usize n = static_cast<usize>(rng.next_in(97));
+          u64 k = rng.next();
+          ck(v.grow_by(n, k) == r.len, "grow_by-index", it);
+          for ( usize i = 0; i < n; ++i ) r.push_back(k);
+        }
+      }
+      ck(seg_eq(v, r), "contents", it);
+      usize seen = 0;
+      bool ordered = true;
+      v.for_each([&](const u64 &x) { ordered = ordered && x == r.buf[seen++]; });
+      ck(ordered && seen == r.len, "for_each", it);
+      ck(v.capacity() >= v.size(), "cap>=size", it);
+    }
+  }
+  end_test_case();
+
+  test_case("sgv references survive growth");
+  {
+    micron::segvector<u64, 8> v;
+    v.push_back(42u);
+    const u64 *pin = &v[0];
+    for ( u64 i = 0; i < 100000; ++i ) v.push_back(i);
+    ck(pin == &v[0] && *pin == 42u, "pin", 0);
+  }
+  end_test_case();
+
+  test_case("sgv at() OOB throws library_error");
+  {
+    micron::segvector<u64> v;
+    expect_throw_type<micron::except::library_error>([&] { (void)v.at(0); });
+    v.grow_by(5);
+    ck(v.at(4) == 0u, "grow_by-default", 0);
+    expect_throw_type<micron::except::library_error>([&] { (void)v.at(5); });
+  }
+  end_test_case();
+
+  test_case("sgv Tracked lifetime balanced");
+  {
+    using Tr = mtest::Tracked<9>;
+    Tr::reset();
+    {
+      micron::segvector<Tr, 2> v;
+      for ( int i = 0; i < 5000; ++i ) v.emplace_back(i);
+      v.clear();
+      ck(Tr::live() == 0u, "clear-balance", 0);
+      v.grow_by(777, Tr(3));
+    }
+    ck(Tr::live() == 0u, "dtor-balance", 0);
+  }
+  end_test_case();
+
+  test_case("sgv element copy-ctor throw: slots become holes, balanced");
+  {
+    using Th = mtest::Throwing<mtest::throw_on::copy_ctor, 4>;
+    Th::reset();
+    {
+      micron::segvector<Th, 4> v;
+      const Th src(5);
+      for ( int i = 0; i < 10; ++i ) v.emplace_back(i);
+      Th::arm(0);
+      expect_throw_type<micron::runtime>([&] { (void)v.push_back(src); });
+      Th::arm(3);
+      expect_throw_type<micron::runtime>([&] { (void)v.grow_by(20, src); });      // 3 built, 17 holes across two segments
+      Th::disarm();
+      ck(v.size() == 31u, "reserved", 0);
+      usize seen = 0;
+      v.for_each([&](const Th &) { ++seen; });
+      ck(seen == 13u, "for_each-skips-holes", 0);
+      expect_throw_type<micron::except::library_error>([&] { (void)v.at(10); });
+      expect_throw_type<micron::except::library_error>([&] { (void)v.at(30); });
+      ck(v.at(9).v == 9 && v.at(13).v == 5, "built-slots", 0);
+      ck(v.push_back(src) == 31u, "append-after-throw", 0);
+      v.clear();
+      ck(Th::ctor == Th::dtor + 1, "clear-balance", 0);
+      v.grow_by(40, src);
+      seen = 0;
+      v.for_each([&](const Th &) { ++seen; });
+      ck(seen == 40u, "holes-reset-by-clear", 0);
+    }
+    ck(Th::ctor == Th::dtor, "throwing-balance", 0);
+  }
+  end_test_case();
+
+  test_case("sgv out-of-capacity append throws before reserving");
+  {
+    micron::segvector<u64, 1> v;
+    v.push_back(1u);
+    expect_throw_type<micron::except::library_error>([&] { (void)v.grow_by(~usize{ 0 }); });
+    ck(v.size() == 1u, "length-untouched", 0);
+    ck(v.push_back(2u) == 1u && v[1] == 2u, "append-after", 0);
+  }
+  end_test_case();
+}
+
+static constexpr u64 PER = 20000;
+
+static void
+mt_push(micron::segvector<u64, 16> *v, u64 base, volatile bool *ok)
+{
+  for ( u64 i = 0; i < PER; ++i ) {
+    const usize at = v->push_back(base + i);
+    if ( (*v)[at] != base + i ) *ok = false;
+  }
+}
+
+static void
+mt_grow(micron::segvector<u64, 16> *v, u64 base, volatile bool *ok)
+{
+  for ( u64 i = 0; i < PER; i += 100 ) {
+    const usize at = v->grow_by(100, base + i);
+    for ( usize j = 0; j < 100; ++j )
+      if ( (*v)[at + j] != base + i ) *ok = false;
+  }
+}
+
+static void
+run_concurrency(void)
+{
+  static constexpr u64 BASES[4] = { 0ull, 1000000ull, 2000000ull, 3000000ull };
+
+  test_case("sgv concurrent producers: no lost updates (multiset)");
+  {
+    micron::segvector<u64, 16> shared;
+    volatile bool ok = true;
+    {
+      micron::auto_thread<> t0(mt_push, micron::addr(shared), BASES[0], micron::addr(ok));
+      micron::auto_thread<> t1(mt_push, micron::addr(shared), BASES[1], micron::addr(ok));
+      micron::auto_thread<> t2(mt_push, micron::addr(shared), BASES[2], micron::addr(ok));
+      micron::auto_thread<> t3(mt_push, micron::addr(shared), BASES[3], micron::addr(ok));
+    }
+    require(shared.size(), static_cast<usize>(4 * PER));
+    ck(ok, "own-slot", 0);
+
+    // every producer's values appear once, in that producer's order
+    u64 next[4] = { 0, 0, 0, 0 };
+    bool inorder = true;
+    shared.for_each([&](const u64 &x) {
+      const u64 t = x / 1000000ull;
+      inorder = inorder && t < 4 && x == BASES[t] + next[t]++;
+    });
+    ck(inorder, "per-producer-order", 0);
+    for ( u64 t = 0; t < 4; ++t ) ck(next[t] == PER, "per-producer-count", static_cast<usize>(t));
+  }
+  end_test_case();
+
+  test_case("sgv concurrent grow_by batches stay contiguous");
+  {
+    micron::segvector<u64, 16> shared;
+    volatile bool ok = true;
+    {
+      micron::auto_thread<> t0(mt_grow, micron::addr(shared), BASES[0], micron::addr(ok));
+      micron::auto_thread<> t1(mt_grow, micron::addr(shared), BASES[1], micron::addr(ok));
+      micron::auto_thread<> t2(mt_push, micron::addr(shared), BASES[2], micron::addr(ok));
+      micron::auto_thread<> t3(mt_push, micron::addr(shared), BASES[3], micron::addr(ok));
+    }
+    require(shared.size(), static_cast<usize>(4 * PER));
+    ck(ok, "batch-slots", 0);
+  }
+  end_test_case();
+}
+
+int
+main(int, char **)
+{
+  sb::print("=== SEGVECTOR RIGOR ===");
+  run_serial();
+  sb::print("--- concurrency (auto_thread) ---");
+  run_concurrency();
+  sb::print("=== SEGVECTOR RIGOR DONE ===");
+  return 1;
+}
@@ -0,0 +1,326 @@
+// Adversarial rigor suite for micron::small_vector<T, N, Alloc, Sf>.
+//
+// small_vector keeps up to N elements inline and spills to Alloc past that;
+// memory always points at the live storage. The interesting edges are the
+// transitions: inline -> heap on the N+1'th element, heap -> heap on regrowth,
+// heap -> inline through shrink_to_fit(), and move ctor/assign, which steals
+// a heap block but has to relocate inline elements. Each group diffs against
+// the ref_vec oracle (tests/support/vector_rigor.hpp) with lengths drawn on
+// both sides of N, and Tracked ctor/dtor balance covers relocation.
+//
+// Build: `duck build tests/rigor/rigor_small_vector.cpp`; run `bin/rigor_small_vector`.
+
+#include "../../src/io/console.hpp"
+
+#include "../../src/vector/small_vector.hpp"
+
+#include "../snowball/snowball.hpp"
+#include "../snowball/snowball_ext.hpp"
+#include "../support/oracles.hpp"
+#include "../support/tracked_types.hpp"
+#include "../support/vector_rigor.hpp"
+
+using namespace snowball;
+using mtest::band;
+using mtest::prng;
+
+#ifndef RIGOR_ITERS
+#define RIGOR_ITERS 10000
+#endif
+static constexpr usize ITERS = RIGOR_ITERS;
+static constexpr usize SN = 8;            // inline capacity under test
+static constexpr usize SCAP = 512;        // oracle capacity
+static constexpr usize MAXLEN = 40;       // straddles SN by a wide margin
+
+// ───────────────────────────────────────────────────────────────────────────
+// helpers
+// ───────────────────────────────────────────────────────────────────────────
+
+static void
+ck(bool ok, const char *what, usize it)
+{
+  if ( !ok ) sb::print("\033[31mMISMATCH\033[0m op=", what, " iter=", (u64)it);
+  require(ok, true);
+}
+
+static void
+gen_keys(prng &rng, u64 *ks, usize &n, usize maxlen, band b)
+{
+  mtest::gen_count(rng, n, maxlen);
+  for ( usize i = 0; i < n; ++i ) ks[i] = mtest::gen_raw(rng, b);
+}
+
+template<typename E>
+static void
+from_keys(micron::small_vector<E, SN> &sv, mtest::ref_vec<SCAP> &r, const u64 *ks, usize n)
+{
+  for ( usize i = 0; i < n; ++i ) {
+    E e = mtest::elem<E>::make(ks[i]);
+    r.push_back(mtest::elem<E>::key(e));
+    sv.push_back(e);
+  }
+}
+
+// ───────────────────────────────────────────────────────────────────────────
+// property groups, templated on element type
+// ───────────────────────────────────────────────────────────────────────────
+
+template<typename E>
+static void
+run_props(void)
+{
+  using S = micron::small_vector<E, SN>;
+
+  test_case("smv inline until N, spills past it");
+  {
+    prng rng(0x7101u);
+    u64 ks[MAXLEN + 4];
+    for ( usize it = 0; it < ITERS; ++it ) {
+      usize n;
+      gen_keys(rng, ks, n, MAXLEN, band::full);
+      S s;
+      mtest::ref_vec<SCAP> r;
+      ck(s.is_inline() && s.max_size() == SN, "fresh-inline", it);
+      for ( usize i = 0; i < n; ++i ) {
+        E e = mtest::elem<E>::make(ks[i]);
+        r.push_back(mtest::elem<E>::key(e));
+        if ( i & 1 )
+          s.emplace_back(e);
+        else
+          s.push_back(e);
+        ck(s.is_inline() == (i < SN), "inline-boundary", it);
+      }
+      ck(mtest::vec_eq<E>(s, r), "push-family", it);
+      ck(s.size() <= s.max_size(), "len<=cap", it);
+    }
+  }
+  end_test_case();
+
+  test_case("smv ctor(n)/ctor(n,v)/resize vs oracle");
+  {
+    prng rng(0x7102u);
+    for ( usize it = 0; it < ITERS; ++it ) {
+      usize n, m;
+      mtest::gen_count(rng, n, MAXLEN);
+      mtest::gen_count(rng, m, MAXLEN);
+      {
+        S s(n);
+        mtest::ref_vec<SCAP> r;
+        r.resize(n);
+        ck(mtest::vec_eq<E>(s, r), "ctor-n", it);
+        s.resize(m);
+        r.resize(m);
+        ck(mtest::vec_eq<E>(s, r), "resize", it);
+      }
+      {
+        u64 k = mtest::gen_raw(rng, band::small);
+        E v = mtest::elem<E>::make(k);
+        S s(n, v);
+        mtest::ref_vec<SCAP> r;
+        r.assign(n, mtest::elem<E>::key(v));
+        ck(mtest::vec_eq<E>(s, r), "ctor-n-val", it);
+        s.resize(m, v);
+        r.resize(m, mtest::elem<E>::key(v));
+        ck(mtest::vec_eq<E>(s, r), "resize-val", it);
+      }
+    }
+  }
+  end_test_case();
+
+  test_case("smv copy/move ctor+assign, inline and spilled donors");
+  {
+    prng rng(0x7103u);
+    u64 a[MAXLEN + 4], b[MAXLEN + 4];
+    for ( usize it = 0; it < ITERS; ++it ) {
+      usize na, nb;
+      gen_keys(rng, a, na, MAXLEN, band::full);
+      gen_keys(rng, b, nb, MAXLEN, band::full);
+      S sa;
+      mtest::ref_vec<SCAP> ra;
+      from_keys<E>(sa, ra, a, na);
+
+      S c(sa);
+      ck(mtest::vec_eq<E>(c, ra), "copy-ctor", it);
+      if ( na ) {
+        c[0] = mtest::elem<E>::make(~ra.buf[0]);
+        ck(mtest::elem<E>::key(sa[0]) == ra.buf[0], "copy-indep", it);
+      }
+
+      S fresh(sa);
+      const E *heap = fresh.is_inline() ? nullptr : fresh.data();
+      S m(micron::move(fresh));
+      ck(mtest::vec_eq<E>(m, ra), "move-ctor", it);
+      ck(fresh.size() == 0u && fresh.is_inline(), "move-ctor-donor", it);
+      if ( heap ) ck(m.data() == heap, "move-ctor-steals-heap", it);
+
+      S sb;
+      mtest::ref_vec<SCAP> rb;
+      from_keys<E>(sb, rb, b, nb);
+      sb = sa;
+      ck(mtest::vec_eq<E>(sb, ra), "copy-assign", it);
+      S &self = sb;
+      sb = self;
+      ck(mtest::vec_eq<E>(sb, ra), "self-copy-assign", it);
+
+      S src(sa);
+      S dst;
+      from_keys<E>(dst, rb, b, nb);
+      dst = micron::move(src);
+      ck(mtest::vec_eq<E>(dst, ra), "move-assign", it);
+      ck(src.size() == 0u && src.is_inline(), "move-assign-donor", it);
+    }
+  }
+  end_test_case();
+
+  test_case("smv insert/erase vs oracle across the spill boundary");
+  {
+    prng rng(0x7104u);
+    u64 ks[MAXLEN + 4];
+    for ( usize it = 0; it < ITERS; ++it ) {
+      usize n;
+      gen_keys(rng, ks, n, MAXLEN, band::full);
+      S s;
+      mtest::ref_vec<SCAP> r;
+      from_keys<E>(s, r, ks, n);
+      for ( usize k = 0; k < 4; ++k ) {
+        usize idx = static_cast<usize>(rng.next_in(s.size() + 1));
+        u64 raw = mtest::gen_raw(rng, band::small);
+        E e = mtest::elem<E>::make(raw);
+        if ( k & 1 )
+          s.insert(idx, micron::move(e));
+        else
+          s.insert(idx, e);
+        r.insert(idx, mtest::elem<E>::key(mtest::elem<E>::make(raw)));
+        ck(mtest::vec_eq<E>(s, r), "insert", it);
+      }
+      if ( s.size() ) {
+        usize idx = static_cast<usize>(rng.next_in(s.size()));
+        s.erase(idx);
+        r.erase(idx);
+        ck(mtest::vec_eq<E>(s, r), "erase", it);
+      }
+      if ( s.size() > 1 ) {
+        usize from = static_cast<usize>(rng.next_in(s.size() - 1));
+        usize to = from + 1 + static_cast<usize>(rng.next_in(s.size() - from));
+        s.erase(from, to);
+        r.erase_range(from, to);
+        ck(mtest::vec_eq<E>(s, r), "erase-range", it);
+      }
+      if ( s.size() ) {
+        s.pop_back();
+        r.pop_back();
+        ck(mtest::vec_eq<E>(s, r), "pop_back", it);
+      }
+    }
+  }
+  end_test_case();
+
+  test_case("smv shrink_to_fit returns to inline, swap mixes modes");
+  {
+    prng rng(0x7105u);
+    u64 a[MAXLEN + 4], b[MAXLEN + 4];
+    for ( usize it = 0; it < ITERS; ++it ) {
+      usize na, nb;
+      gen_keys(rng, a, na, MAXLEN, band::full);
+      gen_keys(rng, b, nb, MAXLEN, band::full);
+      S sa, sb;
+      mtest::ref_vec<SCAP> ra, rb;
+      from_keys<E>(sa, ra, a, na);
+      from_keys<E>(sb, rb, b, nb);
+
+      sa.swap(sb);
+      ck(mtest::vec_eq<E>(sa, rb) && mtest::vec_eq<E>(sb, ra), "swap", it);
+
+      usize keep = static_cast<usize>(rng.next_in(sa.size() + 1));
+      sa.resize(keep);
+      rb.resize(keep);
+      sa.shrink_to_fit();
+      if ( keep <= SN ) ck(sa.is_inline(), "shrink-to-inline", it);
+      ck(mtest::vec_eq<E>(sa, rb), "shrink-contents", it);
+    }
+  }
+  end_test_case();
+
+  test_case("smv OOB throws library_error");
+  {
+    S s;
+    expect_throw_type<micron::except::library_error>([&] { (void)s.at(0); });
+    expect_throw_type<micron::except::library_error>([&] { s.pop_back(); });
+    for ( usize i = 0; i < SN + 3; ++i ) s.push_back(mtest::elem<E>::make(i));
+    expect_throw_type<micron::except::library_error>([&] { (void)s.at(SN + 3); });
+    expect_throw_type<micron::except::library_error>([&] { s.erase(SN + 3); });
+  }
+  end_test_case();
+}
+
+// ───────────────────────────────────────────────────────────────────────────
+// Tracked lifetime balance through spill / relocation / shrink
+// ───────────────────────────────────────────────────────────────────────────
+
+static void
+run_memory(void)
+{
+  using Tr = mtest::Tracked<8>;
+  using S = micron::small_vector<Tr, SN>;
+
+  test_case("smv Tracked lifetime balanced after churn");
+  {
+    Tr::reset();
+    {
+      prng rng(0x5CA1Fu);
+      S s;
+      for ( usize it = 0; it < 40000; ++it ) {
+        u64 op = rng.next() % 7;
+        if ( op == 0 ) {
+          s.push_back(Tr(static_cast<int>(rng.next() & 0xffff)));
+        } else if ( op == 1 ) {
+          s.emplace_back(static_cast<int>(rng.next() & 0xffff));
+        } else if ( op == 2 ) {
+          if ( !s.empty() ) s.pop_back();
+        } else if ( op == 3 ) {
+          if ( !s.empty() ) s.erase(static_cast<usize>(rng.next() % s.size()));
+        } else if ( op == 4 ) {
+          s.insert(static_cast<usize>(rng.next() % (s.size() + 1)), Tr(static_cast<int>(rng.next() & 0xffff)));
+        } else if ( op == 5 ) {
+          S m(micron::move(s));
+          s = micron::move(m);
+        } else {
+          if ( rng.next() & 1 ) s.clear();
+          s.shrink_to_fit();
+        }
+      }
+    }
+    ck(Tr::live() == 0u, "tracked-balance", 0);
+  }
+  end_test_case();
+}
+
+// ───────────────────────────────────────────────────────────────────────────
+// driver
+// ───────────────────────────────────────────────────────────────────────────
+
+template<typename E>
+static void
+run_all(const char *tyname)
+{
+  sb::print("--- small_vector<", tyname, ", 8> ---");
+  run_props<E>();
+}
+
+int
+main(int, char **)
+{
+  sb::print("=== SMALL_VECTOR RIGOR ===");
+
+  run_all<u8>("u8");
+  run_all<u32>("u32");
+  run_all<u64>("u64");
+  run_all<mtest::big>("big");
+  run_all<mtest::Tracked<0>>("Tracked");
+
+  sb::print("--- memory / lifetime (Tracked) ---");
+  run_memory();
+
+  sb::print("=== SMALL_VECTOR RIGOR DONE ===");
+  return 1;
+}
@@ -305,6 +305,63 @@ main(void)
   }
   sb::end_test_case();
 
+  sb::test_case("pack_str / pack_hilbert - query vs brute-force oracle, erase after pack");
+  {
+    using rt = micron::rtree<int, float, 2, 8>;
+    for ( int mode = 0; mode < 2; ++mode ) {
+      std::vector<rt::entry> items;
+      std::vector<rec> all;
+      u64 rng = 0xB01DULL + static_cast<u64>(mode);
+      const int N = 4000;
+      for ( int i = 0; i < N; ++i ) {
+        float x = static_cast<float>(splitmix64(rng++) % 1000);
+        float y = static_cast<float>(splitmix64(rng++) % 1000);
+        float w = static_cast<float>(1 + splitmix64(rng++) % 20);
+        float h = static_cast<float>(1 + splitmix64(rng++) % 20);
+        box2 b = mkbox(x, y, x + w, y + h);
+        items.push_back(rt::entry{ b, i });
+        all.push_back(rec{ b, i });
+      }
+      rt t;
+      if ( mode == 0 )
+        t.pack_str(items);
+      else
+        t.pack_hilbert(items, 0.75f);
+      sb::require(t.size() == static_cast<usize>(N));
+
+      auto agree = [&](u64 seed) {
+        for ( int q = 0; q < 150; ++q ) {
+          float x = static_cast<float>(splitmix64(seed++) % 1000);
+          float y = static_cast<float>(splitmix64(seed++) % 1000);
+          float w = static_cast<float>(5 + splitmix64(seed++) % 150);
+          float h = static_cast<float>(5 + splitmix64(seed++) % 150);
+          box2 qb = mkbox(x, y, x + w, y + h);
+          std::vector<int> got, want;
+          t.query(qb, [&](const box2 &, const int &v) { got.push_back(v); });
+          for ( auto &r : all )
+            if ( bx_intersect(r.b, qb) ) want.push_back(r.val);
+          std::sort(got.begin(), got.end());
+          std::sort(want.begin(), want.end());
+          if ( got != want ) return false;
+        }
+        return true;
+      };
+      sb::require(agree(rng));
+
+      std::vector<rec> kept;
+      for ( auto &r : all ) {
+        if ( r.val % 3 == 0 )
+          sb::require(t.erase(r.b, r.val));
+        else
+          kept.push_back(r);
+      }
+      all = kept;
+      sb::require(t.size() == all.size());
+      sb::require(agree(rng + 7777));
+    }
+  }
+  sb::end_test_case();
+
   sb::print("=== ALL TESTS PASSED ===");
   return 1;
 }
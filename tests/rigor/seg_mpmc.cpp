@@ -0,0 +1,284 @@
+//  Copyright (c) 2024- David Lucius Severus
+//
+//  Distributed under the Boost Software License, Version 1.0.
+//  See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt
+
+#define MICRON_ABC_MT 1      // spawns threads/coroutines; abcmalloc's -k gate must be MT (bits/__abc_mt.hpp)
+
+#include "../../src/io/console.hpp"
+#include "../../src/queue/seg_mpmc.hpp"
+
+#include "../snowball/snowball.hpp"
+
+#include "../support/mt.hpp"      // mtest::parallel + micron atomic_token (NOT <thread>/<atomic>)
+
+// counts live instances, every value constructed into a slot has to be destroyed exactly once
+static micron::atomic_token<i64> g_live(0);
+
+struct tracked {
+  u64 v;
+
+  tracked() : v(0) { g_live.fetch_add(1, micron::memory_order_relaxed); }
+
+  tracked(u64 x) : v(x) { g_live.fetch_add(1, micron::memory_order_relaxed); }
+
+  tracked(const tracked &o) : v(o.v) { g_live.fetch_add(1, micron::memory_order_relaxed); }
+
+  tracked(tracked &&o) : v(o.v) { g_live.fetch_add(1, micron::memory_order_relaxed); }
+
+  tracked &
+  operator=(const tracked &o)
+  {
+    v = o.v;
+    return *this;
+  }
+
+  tracked &
+  operator=(tracked &&o)
+  {
+    v = o.v;
+    return *this;
+  }
+
+  ~tracked() { g_live.fetch_sub(1, micron::memory_order_relaxed); }
+};
+
+// a copy that takes its time, so consumers catch push_n mid-claim and poison slots under it
+static constexpr u64 k_magic = 0x5EC0DE5EC0DEull;
+static u32 g_slow_copy = 0;
+
+struct slow_copy {
+  u64 v;
+  u64 magic;
+
+  slow_copy() : v(0), magic(k_magic) { g_live.fetch_add(1, micron::memory_order_relaxed); }
+
+  slow_copy(u64 x) : v(x), magic(k_magic) { g_live.fetch_add(1, micron::memory_order_relaxed); }
+
+  slow_copy(const slow_copy &o) : v(o.v), magic(o.magic)
+  {
+    if ( micron::atom::load(&g_slow_copy, __ATOMIC_RELAXED) )
+      for ( int k = 0; k < 400; ++k ) __cpu_pause();
+    g_live.fetch_add(1, micron::memory_order_relaxed);
+  }
+
+  slow_copy(slow_copy &&o) : v(o.v), magic(o.magic) { g_live.fetch_add(1, micron::memory_order_relaxed); }
+
+  slow_copy &
+  operator=(const slow_copy &o)
+  {
+    v = o.v;
+    magic = o.magic;
+    return *this;
+  }
+
+  slow_copy &
+  operator=(slow_copy &&o)
+  {
+    v = o.v;
+    magic = o.magic;
+    return *this;
+  }
+
+  ~slow_copy()
+  {
+    magic = 0;
+    g_live.fetch_sub(1, micron::memory_order_relaxed);
+  }
+};
+
+int
+main(void)
+{
+  sb::print("=== SEG_MPMC TESTS ===");
+
+  sb::test_case("single thread FIFO across many segments");
+  {
+    micron::seg_mpmc<u64, 16> q;
+    sb::require_true(q.empty());
+    u64 v = 0;
+    sb::require_true(!q.pop(v));
+    for ( u64 i = 0; i < 1000; ++i ) q.push(i);
+    sb::require_true(!q.empty());
+    bool ordered = true;
+    for ( u64 i = 0; i < 1000; ++i ) {
+      if ( !q.pop(v) or v != i ) ordered = false;
+    }
+    sb::require_true(ordered);
+    sb::require_true(!q.pop(v));
+    sb::require_true(q.empty());
+    // reuses recycled segments
+    for ( u64 i = 0; i < 100; ++i ) q.push(i + 7);
+    sb::require_true(q.pop(v));
+    sb::require(v, u64{ 7 });
+  }
+  sb::end_test_case();
+
+  sb::test_case("push_n / pop_n keep order and span segment boundaries");
+  {
+    micron::seg_mpmc<u64, 16> q;
+    u64 in[100];
+    for ( u64 i = 0; i < 100; ++i ) in[i] = i;
+    q.push_n(in, 37);
+    q.push_n(in + 37, 63);
+    u64 out[100] = {};
+    usize got = q.pop_n(out, 10);
+    got += q.pop_n(out + got, 100);
+    sb::require(got, usize{ 100 });
+    bool ordered = true;
+    for ( u64 i = 0; i < 100; ++i )
+      if ( out[i] != i ) ordered = false;
+    sb::require_true(ordered);
+    sb::require(q.pop_n(out, 5), usize{ 0 });
+  }
+  sb::end_test_case();
+
+  sb::test_case("values left in the queue are destroyed");
+  {
+    {
+      micron::seg_mpmc<tracked, 8> q;
+      for ( u64 i = 0; i < 50; ++i ) q.emplace(i);
+      tracked t;
+      for ( u64 i = 0; i < 20; ++i ) q.pop(t);
+      sb::require(t.v, u64{ 19 });
+    }
+    sb::require(g_live.get(micron::memory_order_relaxed), i64{ 0 });
+  }
+  sb::end_test_case();
+
+  sb::test_case("4 producers, 4 consumers, small segments, every value exactly once");
+  {
+    static constexpr u64 P = 4, PER = 50000;
+    micron::seg_mpmc<u64, 64> q;
+    static u8 seen[P * PER];
+    for ( u64 i = 0; i < P * PER; ++i ) seen[i] = 0;
+    micron::atomic_token<u64> taken(0), dup(0);
+    mtest::parallel(8, [&](int w) {
+      if ( w < 4 ) {
+        const u64 base = static_cast<u64>(w) * PER;
+        u64 buf[8];
+        for ( u64 i = 0; i < PER; ) {
+          if ( (i & 15) == 0 and i + 8 <= PER ) {
+            for ( u64 k = 0; k < 8; ++k ) buf[k] = base + i + k;
+            q.push_n(buf, 8);
+            i += 8;
+          } else
+            q.push(base + i++);
+        }
+        return;
+      }
+      u64 out[16];
+      while ( taken.get(micron::memory_order_relaxed) < P * PER ) {
+        const usize n = (w & 1) ? q.pop_n(out, 16) : (q.pop(out[0]) ? 1u : 0u);
+        for ( usize k = 0; k < n; ++k ) {
+          if ( micron::atom::fetch_add(&seen[out[k]], u8{ 1 }, __ATOMIC_RELAXED) != 0 ) dup.fetch_add(1, micron::memory_order_relaxed);
+        }
+        if ( n ) taken.fetch_add(n, micron::memory_order_relaxed);
+      }
+    });
+    sb::require(dup.get(micron::memory_order_relaxed), u64{ 0 });
+    sb::require(taken.get(micron::memory_order_relaxed), P * PER);
+    bool all = true;
+    for ( u64 i = 0; i < P * PER; ++i )
+      if ( seen[i] != 1 ) all = false;
+    sb::require_true(all);
+    sb::require_true(q.empty());
+  }
+  sb::end_test_case();
+
+  sb::test_case("per-producer order holds under contention");
+  {
+    static constexpr u64 PER = 40000;
+    micron::seg_mpmc<u64, 32> q;
+    micron::atomic_token<u64> disorder(0);
+    mtest::parallel(3, [&](int w) {
+      if ( w < 2 ) {
+        for ( u64 i = 0; i < PER; ++i ) q.push((static_cast<u64>(w) << 32) | i);
+        return;
+      }
+      u64 next[2] = { 0, 0 };
+      for ( u64 got = 0; got < 2 * PER; ) {
+        u64 v;
+        if ( !q.pop(v) ) continue;
+        const u64 p = v >> 32, i = v & 0xffffffffull;
+        if ( i != next[p] ) disorder.fetch_add(1, micron::memory_order_relaxed);
+        next[p] = i + 1;
+        ++got;
+      }
+    });
+    sb::require(disorder.get(micron::memory_order_relaxed), u64{ 0 });
+  }
+  sb::end_test_case();
+
+  sb::test_case("push_n claims broken by consumers: poisoned slots are skipped, never moved from");
+  {
+    // every consumer spins out on a slot still being copied and poisons it, the producer then poisons the rest of its
+    // claim while consumers are walking through it, and the two race for the same slots
+    static constexpr u64 P = 2, BATCHES = 3000, B = 12;
+    {
+      micron::seg_mpmc<slow_copy, 32> q;
+      static u8 seen[P * BATCHES * B];
+      for ( u64 i = 0; i < P * BATCHES * B; ++i ) seen[i] = 0;
+      micron::atomic_token<u64> taken(0), bad(0), done(0);
+      micron::atom::store(&g_slow_copy, u32{ 1 }, __ATOMIC_RELAXED);
+      mtest::parallel(6, [&](int w) {
+        if ( w < static_cast<int>(P) ) {
+          slow_copy buf[B];
+          for ( u64 b = 0; b < BATCHES; ++b ) {
+            for ( u64 k = 0; k < B; ++k ) buf[k].v = (static_cast<u64>(w) * BATCHES + b) * B + k;
+            q.push_n(buf, B);
+          }
+          done.fetch_add(1, micron::memory_order_relaxed);
+          return;
+        }
+        slow_copy out[4];
+        for ( ;; ) {
+          const usize n = (w & 1) ? q.pop_n(out, 4) : (q.pop(out[0]) ? 1u : 0u);
+          for ( usize k = 0; k < n; ++k ) {
+            if ( out[k].magic != k_magic or out[k].v >= P * BATCHES * B
+                 or micron::atom::fetch_add(&seen[out[k].v], u8{ 1 }, __ATOMIC_RELAXED) != 0 )
+              bad.fetch_add(1, micron::memory_order_relaxed);
+          }
+          if ( n ) taken.fetch_add(n, micron::memory_order_relaxed);
+          if ( n == 0 and done.get(micron::memory_order_relaxed) == P and q.empty() ) break;
+        }
+      });
+      micron::atom::store(&g_slow_copy, u32{ 0 }, __ATOMIC_RELAXED);
+      sb::require(bad.get(micron::memory_order_relaxed), u64{ 0 });
+      sb::require(taken.get(micron::memory_order_relaxed), P * BATCHES * B);
+    }
+    sb::require(g_live.get(micron::memory_order_relaxed), i64{ 0 });
+  }
+  sb::end_test_case();
+
+  sb::test_case("pop_wait parks and is woken by push, close releases waiters");
+  {
+    micron::seg_mpmc<u64, 64> q;
+    static constexpr u64 N = 20000;
+    micron::atomic_token<u64> sum(0), fails(0);
+    mtest::parallel(4, [&](int w) {
+      if ( w == 0 ) {
+        for ( u64 i = 1; i <= N; ++i ) {
+          q.push(i);
+          // bursts with gaps, so the consumers really do park in between
+          if ( (i & 1023) == 0 )
+            for ( int k = 0; k < 20000; ++k ) __cpu_pause();
+        }
+        // wait for the drain, then release the consumers
+        while ( !q.empty() ) __cpu_pause();
+        q.close();
+        return;
+      }
+      u64 v;
+      while ( q.pop_wait(v) ) sum.fetch_add(v, micron::memory_order_relaxed);
+      if ( !q.closed() ) fails.fetch_add(1, micron::memory_order_relaxed);
+    });
+    sb::require(sum.get(micron::memory_order_relaxed), N * (N + 1) / 2);
+    sb::require(fails.get(micron::memory_order_relaxed), u64{ 0 });
+  }
+  sb::end_test_case();
+
+  sb::print("=== SEG_MPMC TESTS PASSED ===");
+  return 1;
+}
@@ -0,0 +1,192 @@
+//  Copyright (c) 2024- David Lucius Severus
+//
+//  Distributed under the Boost Software License, Version 1.0.
+//  See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt
+
+#define MICRON_ABC_MT 1      // spawns threads/coroutines; abcmalloc's -k gate must be MT (bits/__abc_mt.hpp)
+
+#include "../../src/io/console.hpp"
+#include "../../src/maps/seq_conmap.hpp"
+
+#include "../snowball/snowball.hpp"
+
+#include "../support/mt.hpp"      // mtest::parallel + micron atomic_token (NOT <thread>/<atomic>)
+
+// both halves are written together, a reader that ever sees b != ~a has observed a torn value
+struct pair_v {
+  u64 a;
+  u64 b;
+};
+
+// counts what the map hands to its Reclaim policy
+usize g_retired = 0;
+
+struct counting_reclaim : micron::seq_deferred_reclaim {
+  using micron::seq_deferred_reclaim::guard;
+
+  void
+  retire(void *p, void (*fn)(void *))
+  {
+    ++g_retired;
+    micron::seq_deferred_reclaim::retire(p, fn);
+  }
+};
+
+int
+main(void)
+{
+  sb::print("=== SEQ_CONMAP TESTS ===");
+
+  sb::test_case("grows from the minimum table through many migrations");
+  {
+    micron::seq_conmap<u64, u64, 8> m(0);
+    const usize cap0 = m.capacity();
+    for ( u64 k = 0; k < 200000; ++k ) {
+      sb::require_true(m.insert(k, k * 7));
+      if ( (k & 1023) == 0 ) {
+        u64 v = 0;
+        sb::require_true(m.find(k / 2, v) and v == (k / 2) * 7);      // old and new tables both consulted mid-migration
+      }
+    }
+    sb::require(m.size(), usize{ 200000 });
+    sb::require_true(m.capacity() > cap0);
+    for ( u64 k = 0; k < 200000; ++k ) {
+      u64 v = 0;
+      sb::require_true(m.find(k, v));
+      sb::require(v, k * 7);
+    }
+    sb::require_false(m.contains(200000));
+    sb::require_false(m.insert(5, 0));
+    sb::require(m.at(5), u64{ 35 });
+  }
+  sb::end_test_case();
+
+  sb::test_case("erase / reinsert / assign leave no stale copies behind");
+  {
+    micron::seq_conmap<u64, u64, 4> m(0);
+    for ( u64 r = 0; r < 4; ++r ) {
+      for ( u64 k = 0; k < 50000; ++k ) m.insert_or_assign(k, k + r);
+      for ( u64 k = 0; k < 50000; k += 2 ) sb::require_true(m.erase(k));
+      for ( u64 k = 0; k < 50000; ++k ) {
+        u64 v = 0;
+        const bool hit = m.find(k, v);
+        sb::require(hit, (k & 1) == 1);
+        if ( hit ) sb::require(v, k + r);
+      }
+    }
+    sb::require(m.size(), usize{ 25000 });
+    usize seen = 0;
+    m.for_each([&](const u64 &k, const u64 &v) {
+      seen += (k & 1) and v == k + 3;
+    });
+    sb::require(seen, usize{ 25000 });
+    m.clear();
+    sb::require_true(m.empty());
+    sb::require_false(m.contains(1));
+    m.reclaim();
+  }
+  sb::end_test_case();
+
+  sb::test_case("insert / erase churn at a steady size rehashes in place, retires nothing");
+  {
+    micron::seq_conmap<u64, u64, 4, counting_reclaim> m(0);
+    for ( u64 k = 0; k < 256; ++k ) m.insert(k, k);
+    const usize retired = g_retired;
+    for ( u64 k = 0; k < 1000000; ++k ) {
+      sb::require_true(m.erase(k));
+      sb::require_true(m.insert(k + 256, k));
+    }
+    sb::require(m.size(), usize{ 256 });
+    sb::require_true(g_retired - retired <= 8);      // a few late growths at most, never one per tombstone cycle
+    for ( u64 k = 1000000; k < 1000256; ++k ) {
+      u64 v = 0;
+      sb::require_true(m.find(k, v) and v == k - 256);
+    }
+  }
+  sb::end_test_case();
+
+  sb::test_case("at() on a missing key throws library_error");
+  {
+    micron::seq_conmap<u64, u64> m;
+    bool threw = false;
+    try {
+      (void)m.at(1);
+    } catch ( const micron::except::library_error & ) {
+      threw = true;
+    }
+    sb::require_true(threw);
+  }
+  sb::end_test_case();
+
+  sb::test_case("concurrent writers resize while readers validate");
+  {
+    static constexpr u64 P = 40000;
+    micron::seq_conmap<u64, pair_v, 16> m(0);
+    for ( u64 k = 0; k < 1024; ++k ) m.insert(k, pair_v{ k, ~k });
+    micron::atomic_token<u64> torn(0), misses(0);
+    mtest::parallel(6, [&m, &torn, &misses](int t) {
+      if ( t < 3 ) {
+        // writers: fresh keys force migrations, the hot keys are rewritten under the readers
+        const u64 base = 1024 + static_cast<u64>(t) * P;
+        for ( u64 i = 0; i < P; ++i ) {
+          m.insert_or_assign(base + i, pair_v{ i, ~i });
+          const u64 hot = i & 1023;
+          m.insert_or_assign(hot, pair_v{ hot + i, ~(hot + i) });
+        }
+      } else {
+        for ( u64 r = 0; r < 40; ++r ) {
+          for ( u64 k = 0; k < 1024; ++k ) {
+            pair_v v{ 0, 0 };
+            if ( !m.find(k, v) )
+              misses.fetch_add(1, micron::memory_order_relaxed);
+            else if ( v.b != ~v.a )
+              torn.fetch_add(1, micron::memory_order_relaxed);
+          }
+        }
+      }
+    });
+    sb::require(torn.get(micron::memory_order_relaxed), u64{ 0 });
+    sb::require(misses.get(micron::memory_order_relaxed), u64{ 0 });
+    sb::require(m.size(), static_cast<usize>(1024 + 3 * P));
+  }
+  sb::end_test_case();
+
+  sb::test_case("epoch reclaim: tables retired under pinned readers, reclaim() while they run");
+  {
+    static constexpr u64 P = 40000;
+    micron::seq_conmap<u64, pair_v, 16> m(0);
+    for ( u64 k = 0; k < 1024; ++k ) m.insert(k, pair_v{ k, ~k });
+    micron::atomic_token<u64> torn(0), misses(0);
+    mtest::parallel(6, [&m, &torn, &misses](int t) {
+      if ( t < 3 ) {
+        // growth, in place rehashes and clear-free churn all retire or rewrite tables the readers are probing
+        const u64 base = 1024 + static_cast<u64>(t) * P;
+        for ( u64 i = 0; i < P; ++i ) {
+          m.insert_or_assign(base + i, pair_v{ i, ~i });
+          if ( i % 3 != 0 ) m.erase(base + i);
+          const u64 hot = i & 1023;
+          m.insert_or_assign(hot, pair_v{ hot + i, ~(hot + i) });
+        }
+      } else {
+        for ( u64 r = 0; r < 60; ++r ) {
+          for ( u64 k = 0; k < 1024; ++k ) {
+            pair_v v{ 0, 0 };
+            if ( !m.find(k, v) )
+              misses.fetch_add(1, micron::memory_order_relaxed);
+            else if ( v.b != ~v.a )
+              torn.fetch_add(1, micron::memory_order_relaxed);
+          }
+          if ( t == 3 ) m.reclaim();
+        }
+      }
+    });
+    sb::require(torn.get(micron::memory_order_relaxed), u64{ 0 });
+    sb::require(misses.get(micron::memory_order_relaxed), u64{ 0 });
+    sb::require(m.size(), static_cast<usize>(1024 + 3 * ((P + 2) / 3)));
+  }
+  sb::end_test_case();
+
+  sb::print("=== SEQ_CONMAP TESTS PASSED ===");
+  return 1;
+}
@@ -0,0 +1,171 @@
+// Copyright (c) 2024- David Lucius Severus
+//
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt
+
+#include "../../src/io/console.hpp"
+#include "../../src/string/strings.hpp"
+#include "../../src/vector/vector.hpp"
+#include "../snowball/snowball.hpp"
+
+using namespace snowball;
+
+using S = micron::string;
+static constexpr usize SSO = S::sso_size;
+
+static bool
+terminated(const S &s)
+{
+  return s.c_str()[s.size()] == '\0' && micron::strlen(s.c_str()) == s.size();
+}
+
+static bool
+points_inside(const S &s)
+{
+  const byte *p = reinterpret_cast<const byte *>(s.c_str());
+  const byte *o = reinterpret_cast<const byte *>(&s);
+  return p >= o && p < o + sizeof(S);
+}
+
+static void
+test_inline_mode()
+{
+  sb::print("=== short strings stay inline ===");
+
+  sb::test_case("footprint and inline capacity");
+  {
+    sb::require_true(sizeof(S) == 3 * sizeof(usize));
+    sb::require_true(SSO == 3 * sizeof(usize) - 1);      // length folded into the last byte
+    S s;
+    sb::require_true(s.is_inline());
+    sb::require_true(points_inside(s));
+    sb::require(s.max_size(), SSO);
+    sb::require_true(terminated(s));
+  }
+  sb::end_test_case();
+
+  sb::test_case("every length up to sso_size - 1 constructs inline");
+  {
+    char buf[64];
+    for ( usize n = 0; n + 1 <= SSO; ++n ) {
+      for ( usize i = 0; i < n; ++i ) buf[i] = static_cast<char>('a' + (i % 26));
+      buf[n] = '\0';
+      S s(static_cast<const char *>(buf));
+      sb::require_true(s.is_inline());
+      sb::require(s.size(), n);
+      sb::require_true(terminated(s));
+      sb::require_true(micron::strcmp(s.c_str(), buf) == 0);
+    }
+  }
+  sb::end_test_case();
+
+  sb::test_case("push_back spills exactly once at the boundary, content survives");
+  {
+    S s;
+    for ( usize i = 0; i < 300; ++i ) {
+      s.push_back(static_cast<char>('A' + (i % 26)));
+      sb::require(s.size(), i + 1);
+      sb::require_true(terminated(s));
+      if ( i + 2 < SSO ) sb::require_true(s.is_inline());
+    }
+    sb::require_false(s.is_inline());
+    for ( usize i = 0; i < 300; ++i ) sb::require(s[i], static_cast<char>('A' + (i % 26)));
+  }
+  sb::end_test_case();
+
+  sb::test_case("sso_size - 1 chars stay inline, one more spills; the length byte never reads as heap");
+  {
+    S a(SSO - 1, 'z');
+    sb::require_true(a.is_inline());
+    sb::require(a.size(), SSO - 1);
+    sb::require_true(terminated(a));
+    S b(SSO, 'z');
+    sb::require_false(b.is_inline());
+    sb::require(b.size(), SSO);
+    sb::require_true(terminated(b));
+    while ( !a.empty() ) {
+      a.pop_back();
+      sb::require_true(a.is_inline());
+      sb::require_true(terminated(a));
+    }
+    sb::require_true(a.size() == 0);
+  }
+  sb::end_test_case();
+}
+
+static void
+test_moves()
+{
+  sb::print("=== moves and relocation ===");
+
+  sb::test_case("move of an inline string copies the buffer, donor left empty");
+  {
+    S a("tok");
+    S b(micron::move(a));
+    sb::require_true(b == "tok");
+    sb::require_true(b.is_inline());
+    sb::require_true(points_inside(b));
+    sb::require_true(a.empty());
+    sb::require_true(terminated(a));
+  }
+  sb::end_test_case();
+
+  sb::test_case("move of a heap string steals the block");
+  {
+    S a("a string that is comfortably longer than the inline buffer");
+    const char *p = a.c_str();
+    S b(micron::move(a));
+    sb::require_true(b.c_str() == p);
+    sb::require_true(a.empty() && a.is_inline());
+    S c;
+    c = micron::move(b);
+    sb::require_true(c.c_str() == p);
+  }
+  sb::end_test_case();
+
+  sb::test_case("copy and assign across modes");
+  {
+    S small("hdr");
+    S big("x-forwarded-for-and-then-some-more-bytes");
+    S t(small);
+    sb::require_true(t == small && t.is_inline());
+    t = big;
+    sb::require_true(t == big && terminated(t));
+    t = small;
+    sb::require_true(t == small && terminated(t));
+  }
+  sb::end_test_case();
+
+  sb::test_case("vector<string> regrowth relocates inline strings intact");
+  {
+    micron::vector<S> v;
+    for ( int i = 0; i < 2000; ++i ) {
+      S s;
+      s += "k";
+      for ( int d = i; d; d /= 10 ) s.push_back(static_cast<char>('0' + d % 10));
+      if ( i % 7 == 0 ) s += "-padded-out-past-the-inline-buffer";
+      v.push_back(micron::move(s));
+    }
+    for ( int i = 0; i < 2000; ++i ) {
+      S s;
+      s += "k";
+      for ( int d = i; d; d /= 10 ) s.push_back(static_cast<char>('0' + d % 10));
+      if ( i % 7 == 0 ) s += "-padded-out-past-the-inline-buffer";
+      sb::require_true(v[i] == s);
+      sb::require_true(terminated(v[i]));
+      if ( v[i].is_inline() ) sb::require_true(points_inside(v[i]));
+    }
+  }
+  sb::end_test_case();
+}
+
+int
+main()
+{
+  sb::print("=== STRING SSO ===");
+  test_inline_mode();
+  test_moves();
+  sb::print("=== STRING SSO PASSED ===");
+  return 1;
+}
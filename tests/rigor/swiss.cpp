@@ -873,6 +873,44 @@ main(void)
   }
   sb::end_test_case();
 
+  // ── group width ───────────────────────────────────────────────────────────
+
+  sb::test_case("group width - 32 and 64 slot groups agree with 16 near full");
+  {
+    static micron::stack_swiss_map<int, int, 256> g16;
+    static micron::stack_swiss_map<int, int, 256, 256, 32> g32;
+    static micron::stack_swiss_map<int, int, 256, 256, 64> g64;
+    for ( int i = 0; i < 250; ++i ) {
+      sb::require(g16.insert(i, i).a);
+      sb::require(g32.insert(i, i).a);
+      sb::require(g64.insert(i, i).a);
+    }
+    for ( int i = 0; i < 250; i += 3 ) {
+      sb::require(g32.erase(i));
+      sb::require(g64.erase(i));
+    }
+    for ( int i = 0; i < 300; ++i ) {
+      const bool want = i < 250 && i % 3 != 0;
+      sb::require(g32.contains(i) == want);
+      sb::require(g64.contains(i) == want);
+      sb::require(g16.contains(i) == (i < 250));
+    }
+    sb::require(g32.size() == g64.size());
+  }
+  sb::end_test_case();
+
+  sb::test_case("group width - swiss_wide keeps swiss's probe window");
+  {
+    using narrow = micron::swiss<int, int, 256>;
+    using wide = micron::swiss_wide<int, int, 256>;
+    static_assert(micron::same_as<narrow, micron::stack_swiss_map<int, int, 256, 16, 16>>);
+    static_assert(micron::same_as<wide, micron::stack_swiss_map<int, int, 256, 16, micron::__swiss_native_group>>);
+    static wide w;
+    for ( int i = 0; i < 32; ++i ) sb::require(w.insert(i, i).a);
+    for ( int i = 0; i < 32; ++i ) sb::require(w.contains(i));
+  }
+  sb::end_test_case();
+
   sb::print("=== ALL TESTS PASSED ===");
 
   return 1;